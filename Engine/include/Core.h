@@ -33,8 +33,15 @@ THE SOFTWARE.
 #include <core/System.h>
 #include <core/SystemDefines.h>
 #include <core/SystemDriver.h>
+#include <core/SystemScheduler.h>
+#include <core/JobSystem.h>
+#include <core/Handle.h>
+#include <core/SlotMap.h>
+#include <core/ObjectPool.h>
 
 #include <core/Math.h>
+#include <core/Simd.h>
+#include <core/SimdDefines.h>
 #include <core/Utils.h>
 
 #include <glm/glm.hpp>
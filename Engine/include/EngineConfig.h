@@ -297,6 +297,24 @@ THE SOFTWARE.
 // Memory Tracking Section
 //////////////////////////////////////////////////////////////////////////
 
+//////////////////////////////////////////////////////////////////////////
+// Log Section
+// Messages logged through LOG_MESSAGE below this level are compiled out (see core::LogLevel)
+#if !defined(ENGINE_LOG_LEVEL)
+#	define ENGINE_LOG_LEVEL 0
+#endif
+
+// Log Section
+//////////////////////////////////////////////////////////////////////////
+
+//////////////////////////////////////////////////////////////////////////
+// Profiler Section
+// Remove to compile the PROFILE_* macros out
+#define ENGINE_PROFILER
+
+// Profiler Section
+//////////////////////////////////////////////////////////////////////////
+
 #include <wchar.h>
 #include <assert.h>
 
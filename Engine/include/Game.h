@@ -31,9 +31,12 @@ THE SOFTWARE.
 #include <game/Component.h>
 #include <game/ComponentDefines.h>
 #include <game/ComponentFactory.h>
+#include <game/PooledComponentFactory.h>
 #include <game/Transform.h>
 #include <game/TransformDefines.h>
+#include <game/TransformHierarchy.h>
 #include <game/MessageDefines.h>
+#include <game/MessageBus.h>
 #include <game/Scene.h>
 #include <game/SceneFactory.h>
 #include <game/GameManager.h>
@@ -44,8 +44,8 @@ public:
 	aabox3d(const vector3d& init);
 	aabox3d(float minx, float miny, float minz, float maxx, float maxy, float maxz);
 
-	inline bool operator==(const aabox3d& other) const;
-	inline bool operator!=(const aabox3d& other) const;
+	bool operator==(const aabox3d& other) const;
+	bool operator!=(const aabox3d& other) const;
 
 	//! Adds a point to the bounding box, causing it to grow bigger,
 	//! if point is outside of the box.
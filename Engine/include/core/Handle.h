@@ -0,0 +1,79 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _HANDLE_H_
+#define _HANDLE_H_
+
+#include <EngineConfig.h>
+
+namespace core
+{
+
+//! Reference to an element of a SlotMap.
+//! The generation changes every time a slot is reused, so a handle to a removed element
+//! is detected as stale instead of pointing to whatever took its place.
+struct Handle
+{
+	unsigned int index;
+	unsigned int generation;
+
+	Handle()
+	{
+		index = 0xFFFFFFFF;
+		generation = 0;
+	}
+
+	Handle(unsigned int index, unsigned int generation)
+	{
+		this->index = index;
+		this->generation = generation;
+	}
+
+	//! Returns false for a handle that was never assigned, a stale handle can still be valid.
+	bool isValid() const
+	{
+		return generation != 0;
+	}
+
+	bool operator==(const Handle& other) const
+	{
+		return index == other.index && generation == other.generation;
+	}
+
+	bool operator!=(const Handle& other) const
+	{
+		return index != other.index || generation != other.generation;
+	}
+
+	bool operator<(const Handle& other) const
+	{
+		return (index != other.index) ? (index < other.index) : (generation < other.generation);
+	}
+};
+
+} // end namespace core
+
+#endif
\ No newline at end of file
@@ -0,0 +1,140 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _JOB_SYSTEM_H_
+#define _JOB_SYSTEM_H_
+
+#include <EngineConfig.h>
+#include <core/Singleton.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace core
+{
+
+typedef void (*JobFunction)(void* data);
+typedef void (*ParallelForFunction)(unsigned int begin, unsigned int end, void* data);
+
+//! Counts the jobs of a group that are still pending.
+//! A counter can be waited on to fence the group.
+class ENGINE_PUBLIC_EXPORT JobCounter
+{
+public:
+
+	JobCounter();
+
+	void increment(int value = 1);
+	void decrement();
+
+	int getValue() const;
+
+	bool isDone() const;
+
+protected:
+
+	std::atomic<int> mValue;
+};
+
+struct Job
+{
+	JobFunction function;
+	void* data;
+	JobCounter* counter;
+};
+
+class JobQueue;
+
+//! Work-stealing job system.
+//! Every worker thread owns a deque: it pushes and pops its own jobs from the back
+//! while idle workers steal from the front of the other deques.
+//! The thread that started the job system takes part as worker 0 whenever it waits on a counter.
+class ENGINE_PUBLIC_EXPORT JobSystem: public Singleton<JobSystem>
+{
+public:
+
+	JobSystem();
+	~JobSystem();
+
+	//! Starts the worker threads.
+	//! \param workerCount: Number of threads besides the calling one, 0 runs every job on the calling thread.
+	void start(unsigned int workerCount);
+
+	//! Stops and joins the worker threads.
+	void stop();
+
+	//! Restarts the job system with a different number of worker threads.
+	void setWorkerCount(unsigned int workerCount);
+
+	unsigned int getWorkerCount() const;
+
+	//! Returns the index of the calling thread, 0 for the main thread.
+	unsigned int getThreadIndex() const;
+
+	//! Queues a job on the calling thread's deque.
+	//! \param counter: Optional counter incremented now and decremented when the job is finished.
+	void run(JobFunction function, void* data, JobCounter* counter = nullptr);
+
+	//! Queues several jobs that share the same counter.
+	void run(Job* jobs, unsigned int count, JobCounter* counter = nullptr);
+
+	//! Blocks until the counter reaches zero, executing pending jobs in the meantime.
+	void wait(JobCounter* counter);
+
+	//! Executes one pending job if one is available.
+	//! \return: true if a job was executed.
+	bool executeJob();
+
+	//! Splits [0, count) into ranges of at most grainSize elements and processes them in parallel.
+	//! \param grainSize: Elements per job, 0 chooses a size from the worker count.
+	void parallelFor(unsigned int count, ParallelForFunction function, void* data, unsigned int grainSize = 0);
+
+	static JobSystem* getInstance();
+
+protected:
+
+	void workerLoop(unsigned int threadIndex);
+
+	bool popJob(unsigned int threadIndex, Job& job);
+
+	void executeJob(Job& job);
+
+	std::vector<JobQueue*> mQueues;
+	std::vector<std::thread*> mThreads;
+
+	std::atomic<bool> mRunning;
+	std::atomic<int> mPendingJobs;
+
+	std::mutex mWakeMutex;
+	std::condition_variable mWakeCondition;
+};
+
+} // end namespace core
+
+#endif
\ No newline at end of file
@@ -32,18 +32,29 @@ THE SOFTWARE.
 
 #include <string>
 #include <fstream>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+//! Logs a message only if its level passes the compile time (ENGINE_LOG_LEVEL) and the run time filter,
+//! the text is not built at all otherwise.
+#define LOG_MESSAGE(source, text, level) do { if ((level) >= ENGINE_LOG_LEVEL && core::Log::getInstance() != nullptr && core::Log::getInstance()->isLogged(level)) core::Log::getInstance()->logMessage(source, text, level); } while (0)
 
 namespace core
 {
 
-enum LogLevel;
+struct LogRecord;
 
 //! The log handles logging messages.
+//! Messages are copied into a lock-free queue and written to the file in batches by a background thread,
+//! the formatting is done there too. A crash or std::terminate writes the queued messages before the process dies.
 class ENGINE_PUBLIC_EXPORT Log: public Singleton<Log>
 {
 public:
 
-	Log();
+	//! \param queueSize: Number of messages that can wait for the writer thread, rounded up to a power of two.
+	Log(unsigned int queueSize = 4096);
 	~Log();
 
 	//! Log a message a text into the log
@@ -51,13 +62,54 @@ public:
 	//! \param text: Text to print out.
 	//! \param level: Log level of the text.
 	void logMessage(const std::string& source, const std::string& text, LogLevel logLevel = LOG_LEVEL_INFORMATION);
+	void logMessage(const char* source, const char* text, LogLevel logLevel = LOG_LEVEL_INFORMATION);
+
+	//! Messages below this level are dropped before being queued.
+	void setLogLevel(LogLevel logLevel);
+	LogLevel getLogLevel() const;
+
+	bool isLogged(LogLevel logLevel) const;
+
+	//! Writes every queued message, returns once they are in the file.
+	void flush();
+
+	//! Writes the queued messages from a crash handler.
+	//! Gives up if the writer thread does not release the file in time, it may be the one that crashed.
+	void crashFlush();
 
 	static Log* getInstance();
 
 protected:
 
+	void pushMessage(const char* source, unsigned int sourceLength, const char* text, unsigned int textLength, LogLevel logLevel);
+
+	//! Formats and writes the published messages, the caller holds mWriteMutex.
+	void writeMessages();
+
+	void writerLoop();
+
 	//! Default log.
 	std::ofstream mLogStream;
+
+	LogLevel mLogLevel;
+
+	LogRecord* mRecords;
+	unsigned int mRecordMask;
+
+	std::atomic<unsigned int> mEnqueuePosition;
+	unsigned int mDequeuePosition;
+
+	std::string mWriteBuffer;
+#ifdef _DEBUG
+	std::string mErrorBuffer;
+#endif
+
+	std::thread* mWriterThread;
+	std::atomic<bool> mRunning;
+
+	std::mutex mWriteMutex;
+	std::mutex mWakeMutex;
+	std::condition_variable mWakeCondition;
 };
 
 } // end namespace core
@@ -46,51 +46,51 @@ const float RADTODEG				= 57.295779513082320876798154814105f;//180.0f / PI;		//!
 const float ONE_THIRD				= 0.3333333333333333333333333333333f;					//! Constant for 1/3.
 
 //! returns minimum of two values. Own implementation to get rid of the STL (VS6 problems)
-inline float ENGINE_PUBLIC_EXPORT min(const float a, const float b);
+float ENGINE_PUBLIC_EXPORT min(const float a, const float b);
 
 //! returns maximum of two values. Own implementation to get rid of the STL (VS6 problems)
-inline float ENGINE_PUBLIC_EXPORT max(const float a, const float b);
+float ENGINE_PUBLIC_EXPORT max(const float a, const float b);
 
 //! returns minimum of three values.
-inline float ENGINE_PUBLIC_EXPORT min(const float a, const float b, const float c);
+float ENGINE_PUBLIC_EXPORT min(const float a, const float b, const float c);
 
 //! returns maximum of three values.
-inline float ENGINE_PUBLIC_EXPORT max(const float a, const float b, const float c);
+float ENGINE_PUBLIC_EXPORT max(const float a, const float b, const float c);
 
 //! returns if a value equals the other one, taking
 //! rounding errors into account
-inline bool ENGINE_PUBLIC_EXPORT equals(const float a, const float b);
+bool ENGINE_PUBLIC_EXPORT equals(const float a, const float b);
 
 //! returns abs of two values. Own implementation to get rid of STL (VS6 problems)
-inline float ENGINE_PUBLIC_EXPORT abs(float val);
+float ENGINE_PUBLIC_EXPORT abs(float val);
 
-inline float ENGINE_PUBLIC_EXPORT acos(float val);
+float ENGINE_PUBLIC_EXPORT acos(float val);
 
-inline float ENGINE_PUBLIC_EXPORT asin(float val);
+float ENGINE_PUBLIC_EXPORT asin(float val);
 
-inline float ENGINE_PUBLIC_EXPORT atan(float val);
+float ENGINE_PUBLIC_EXPORT atan(float val);
 
-inline float ENGINE_PUBLIC_EXPORT atan2(float valy, float valx);
+float ENGINE_PUBLIC_EXPORT atan2(float valy, float valx);
 
-inline float ENGINE_PUBLIC_EXPORT cos(float val);
+float ENGINE_PUBLIC_EXPORT cos(float val);
 
-inline float ENGINE_PUBLIC_EXPORT sin(float val);
+float ENGINE_PUBLIC_EXPORT sin(float val);
 
-inline float ENGINE_PUBLIC_EXPORT tan(float val);
+float ENGINE_PUBLIC_EXPORT tan(float val);
 
-inline float ENGINE_PUBLIC_EXPORT ceil(float val);
+float ENGINE_PUBLIC_EXPORT ceil(float val);
 
-inline float ENGINE_PUBLIC_EXPORT floor(float val);
+float ENGINE_PUBLIC_EXPORT floor(float val);
 
-inline float ENGINE_PUBLIC_EXPORT clamp(float val, float min, float max);
+float ENGINE_PUBLIC_EXPORT clamp(float val, float min, float max);
 
-inline float ENGINE_PUBLIC_EXPORT exp(float val);
+float ENGINE_PUBLIC_EXPORT exp(float val);
 
-inline float ENGINE_PUBLIC_EXPORT log(float val);
+float ENGINE_PUBLIC_EXPORT log(float val);
 
-inline float ENGINE_PUBLIC_EXPORT sqr(float val);
+float ENGINE_PUBLIC_EXPORT sqr(float val);
 
-inline float ENGINE_PUBLIC_EXPORT sqrt(float val);
+float ENGINE_PUBLIC_EXPORT sqrt(float val);
 
 } // end namespace core
 
@@ -176,6 +176,18 @@ public:
 	//! Transforms input vector by this matrix and stores result in output vector
 	void transformVector(const vector4d& in, vector4d& out) const;
 
+	//! Transforms count vectors by this matrix, in and out may be the same array.
+	void transformVectors(const vector3d* in, vector3d* out, unsigned int count) const;
+
+	//! Transforms count vectors by this matrix, in and out may be the same array.
+	void transformVectors(const vector4d* in, vector4d* out, unsigned int count) const;
+
+	//! Multiplies count matrices by this matrix: out[i] = (*this) * in[i].
+	void multiplyMatrices(const matrix4* in, matrix4* out, unsigned int count) const;
+
+	//! Multiplies count matrices by this matrix: out[i] = in[i] * (*this).
+	void postMultiplyMatrices(const matrix4* in, matrix4* out, unsigned int count) const;
+
 	//! Transforms a plane by this matrix
 	void transformPlane(plane3d &plane) const;
 
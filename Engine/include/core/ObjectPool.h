@@ -0,0 +1,271 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _OBJECT_POOL_H_
+#define _OBJECT_POOL_H_
+
+#include <EngineConfig.h>
+
+#include <new>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+namespace core
+{
+
+//! Chunked storage for objects of one type.
+//! Objects are constructed in place inside fixed size chunks, so objects created together stay
+//! contiguous in memory and are never moved. Freed slots are reused before a new chunk is allocated.
+template <typename T>
+class ObjectPool
+{
+public:
+
+	ObjectPool(unsigned int chunkSize = 256)
+	{
+		mChunkSize = chunkSize > 0 ? chunkSize : 1;
+		mSize = 0;
+	}
+
+	~ObjectPool()
+	{
+		clear();
+	}
+
+	//! Constructs a new object in the pool.
+	T* create()
+	{
+		unsigned int index = acquireSlot();
+		Chunk* pChunk = mChunks[index / mChunkSize];
+		unsigned int slot = index % mChunkSize;
+
+		T* pObject = new (&pChunk->data[slot]) T();
+
+		pChunk->alive[slot] = 1;
+		pChunk->liveCount++;
+		mSize++;
+
+		return pObject;
+	}
+
+	//! Destroys an object created by this pool, returns false if the object does not belong to it.
+	bool destroy(T* object)
+	{
+		if (object == nullptr)
+			return false;
+
+		unsigned int index = 0;
+		if (!findSlot(object, index))
+			return false;
+
+		Chunk* pChunk = mChunks[index / mChunkSize];
+		unsigned int slot = index % mChunkSize;
+		if (pChunk->alive[slot] == 0)
+			return false;
+
+		object->~T();
+
+		pChunk->alive[slot] = 0;
+		pChunk->liveCount--;
+		mSize--;
+
+		mFreeSlots.push_back(index);
+
+		return true;
+	}
+
+	//! Returns true if the object lives in this pool.
+	bool contains(const T* object) const
+	{
+		unsigned int index = 0;
+		if (!findSlot(object, index))
+			return false;
+
+		return mChunks[index / mChunkSize]->alive[index % mChunkSize] != 0;
+	}
+
+	//! Calls function(T*) for every live object, in memory order.
+	template <typename F>
+	void forEach(F function)
+	{
+		forEach(0, mChunks.size(), function);
+	}
+
+	//! Calls function(T*) for every live object of the chunks [beginChunk, endChunk), in memory order.
+	//! Different chunk ranges can be processed by different threads.
+	template <typename F>
+	void forEach(unsigned int beginChunk, unsigned int endChunk, F function)
+	{
+		for (unsigned int i = beginChunk; i < endChunk && i < mChunks.size(); ++i)
+		{
+			Chunk* pChunk = mChunks[i];
+			if (pChunk->liveCount == 0)
+				continue;
+
+			for (unsigned int j = 0; j < pChunk->used; ++j)
+			{
+				if (pChunk->alive[j] != 0)
+					function(reinterpret_cast<T*>(&pChunk->data[j]));
+			}
+		}
+	}
+
+	//! Destroys all objects and releases the chunks.
+	void clear()
+	{
+		for (unsigned int i = 0; i < mChunks.size(); ++i)
+		{
+			Chunk* pChunk = mChunks[i];
+			for (unsigned int j = 0; j < pChunk->used; ++j)
+			{
+				if (pChunk->alive[j] != 0)
+					reinterpret_cast<T*>(&pChunk->data[j])->~T();
+			}
+
+			SAFE_DELETE_ARRAY(pChunk->data);
+			SAFE_DELETE_ARRAY(pChunk->alive);
+			SAFE_DELETE(pChunk);
+		}
+
+		mChunks.clear();
+		mSortedChunks.clear();
+		mFreeSlots.clear();
+		mSize = 0;
+	}
+
+	//! Returns the number of live objects.
+	unsigned int size() const
+	{
+		return mSize;
+	}
+
+	bool empty() const
+	{
+		return mSize == 0;
+	}
+
+	unsigned int getChunkSize() const
+	{
+		return mChunkSize;
+	}
+
+	unsigned int getChunkCount() const
+	{
+		return mChunks.size();
+	}
+
+protected:
+
+	typedef typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type Storage;
+
+	struct Chunk
+	{
+		Storage* data;
+		unsigned char* alive;
+		//! Number of slots handed out at least once, slots past it were never constructed.
+		unsigned int used;
+		unsigned int liveCount;
+		//! Position of the chunk in mChunks.
+		unsigned int number;
+	};
+
+	static bool compareChunks(const Chunk* a, const Chunk* b)
+	{
+		return a->data < b->data;
+	}
+
+	unsigned int acquireSlot()
+	{
+		if (!mFreeSlots.empty())
+		{
+			unsigned int index = mFreeSlots.back();
+			mFreeSlots.pop_back();
+			return index;
+		}
+
+		if (mChunks.empty() || mChunks.back()->used == mChunkSize)
+		{
+			Chunk* pChunk = new Chunk();
+			pChunk->data = new Storage[mChunkSize];
+			pChunk->alive = new unsigned char[mChunkSize];
+			pChunk->used = 0;
+			pChunk->liveCount = 0;
+			pChunk->number = mChunks.size();
+
+			std::fill(pChunk->alive, pChunk->alive + mChunkSize, 0);
+
+			mChunks.push_back(pChunk);
+			mSortedChunks.insert(std::upper_bound(mSortedChunks.begin(), mSortedChunks.end(), pChunk, compareChunks), pChunk);
+		}
+
+		Chunk* pChunk = mChunks.back();
+		return pChunk->number * mChunkSize + pChunk->used++;
+	}
+
+	bool findSlot(const T* object, unsigned int& index) const
+	{
+		const Storage* pStorage = reinterpret_cast<const Storage*>(object);
+
+		// last chunk whose data starts at or before the object
+		unsigned int first = 0;
+		unsigned int count = mSortedChunks.size();
+		while (count > 0)
+		{
+			unsigned int step = count / 2;
+			if (mSortedChunks[first + step]->data <= pStorage)
+			{
+				first += step + 1;
+				count -= step + 1;
+			}
+			else
+			{
+				count = step;
+			}
+		}
+
+		if (first == 0)
+			return false;
+
+		const Chunk* pChunk = mSortedChunks[first - 1];
+		if (pStorage >= pChunk->data + pChunk->used)
+			return false;
+
+		index = pChunk->number * mChunkSize + (unsigned int)(pStorage - pChunk->data);
+		return true;
+	}
+
+	std::vector<Chunk*> mChunks;
+	std::vector<Chunk*> mSortedChunks;
+	std::vector<unsigned int> mFreeSlots;
+
+	unsigned int mChunkSize;
+	unsigned int mSize;
+};
+
+} // end namespace core
+
+#endif
\ No newline at end of file
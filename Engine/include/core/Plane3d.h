@@ -43,8 +43,8 @@ public:
 	plane3d(const vector3d& MPoint, const vector3d& Normal);
 	plane3d(const plane3d& other);
 
-	inline bool operator==(const plane3d& other) const;
-	inline bool operator!=(const plane3d& other) const;
+	bool operator==(const plane3d& other) const;
+	bool operator!=(const plane3d& other) const;
 
 	void setPlane(const vector3d& point, const vector3d& nvector);
 
@@ -41,16 +41,16 @@ public:
 	position2d(int x, int y);
 	position2d(const position2d& other);
 
-	inline position2d& operator=(const position2d& other);
+	position2d& operator=(const position2d& other);
 
-	inline position2d operator-(const position2d& other) const;
-	inline position2d& operator+=(const position2d& other);
+	position2d operator-(const position2d& other) const;
+	position2d& operator+=(const position2d& other);
 
-	inline position2d operator+(const position2d& other) const;
-	inline position2d& operator-=(const position2d& other);
+	position2d operator+(const position2d& other) const;
+	position2d& operator-=(const position2d& other);
 
-	inline bool operator == (const position2d& other) const;
-	inline bool operator != (const position2d& other) const;
+	bool operator == (const position2d& other) const;
+	bool operator != (const position2d& other) const;
 
 	//! Returns distance from an other point.
 	float getDistanceFrom(const position2d& other) const;
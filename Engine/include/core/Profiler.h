@@ -0,0 +1,251 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include <EngineConfig.h>
+#include <core/Singleton.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+#if defined(ENGINE_PROFILER)
+//! Profiles the rest of the enclosing scope, name has to be a string literal.
+#	define PROFILE_SCOPE(name) static core::ProfileZone PROFILE_CONCAT(profileZone, __LINE__) = {name, {-1}, {0}}; core::ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(PROFILE_CONCAT(profileZone, __LINE__))
+//! Profiles the rest of the enclosing scope with a zone owned by the caller.
+#	define PROFILE_ZONE(zone) core::ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(zone)
+#	define PROFILE_FRAME() if (core::Profiler::getInstance() != nullptr) core::Profiler::getInstance()->endFrame()
+#	define PROFILE_THREAD_NAME(name) if (core::Profiler::getInstance() != nullptr) core::Profiler::getInstance()->setThreadName(name)
+#else
+#	define PROFILE_SCOPE(name)
+#	define PROFILE_ZONE(zone)
+#	define PROFILE_FRAME()
+#	define PROFILE_THREAD_NAME(name)
+#endif
+
+namespace core
+{
+
+//! Static description of a profiled zone.
+//! The id is filled the first time the zone is entered, registering the same name twice returns the same id
+//! so threads racing on the first entry end up storing the same value.
+//! The zones outlive the profiler, the generation tells the ids registered with a previous one.
+struct ProfileZone
+{
+	const char* name;
+	std::atomic<int> id;
+	std::atomic<unsigned int> generation;
+};
+
+//! Rolling statistics of a zone, times are in milliseconds per frame.
+struct ProfileZoneStats
+{
+	std::string name;
+
+	//! Zone the last call was nested in, -1 for a top level zone.
+	int parent;
+	unsigned int depth;
+
+	//! Calls during the last frame.
+	unsigned int calls;
+
+	//! Time spent in the zone, nested zones included.
+	float lastTime;
+	float averageTime;
+	float bestTime;
+	float worstTime;
+
+	//! Time spent in the zone itself, nested zones excluded.
+	float lastSelfTime;
+	float averageSelfTime;
+};
+
+struct ProfileThreadBuffer;
+
+//! Hierarchical frame profiler.
+//! Every thread records the zones it leaves into its own ring buffer without locking,
+//! endFrame collects the buffers on the main thread into per zone statistics and,
+//! while a capture is running, into a trace that can be exported to the Chrome trace format.
+class ENGINE_PUBLIC_EXPORT Profiler: public Singleton<Profiler>
+{
+public:
+
+	Profiler();
+	~Profiler();
+
+	//! Turns recording on and off at run time, zones entered while disabled cost a single call.
+	void setEnabled(bool enabled);
+	bool isEnabled() const;
+
+	//! Sets the number of zones a thread can record between two endFrame calls, rounded up to a power of two.
+	//! Only affects threads that did not record anything yet.
+	void setThreadBufferSize(unsigned int size);
+	unsigned int getThreadBufferSize() const;
+
+	//! Sets the number of frames the statistics are averaged over.
+	void setStatsFrameCount(unsigned int frames);
+	unsigned int getStatsFrameCount() const;
+
+	//! Names the calling thread in the exported trace.
+	void setThreadName(const std::string& name);
+
+	//! Returns the id of the zone with the given name, registering it if needed.
+	unsigned int registerZone(const char* name);
+
+	//! Collects the zones recorded by every thread since the last call and closes the frame statistics.
+	//! Call it once per frame from the main thread, outside of any zone.
+	void endFrame();
+
+	unsigned int getFrameCount() const;
+
+	//! Zones that did not fit in a thread buffer or were nested too deep.
+	unsigned int getDroppedZoneCount() const;
+
+	unsigned int getZoneCount() const;
+	bool getZoneStats(unsigned int zone, ProfileZoneStats& stats) const;
+	bool getZoneStats(const std::string& name, ProfileZoneStats& stats) const;
+
+	//! Starts recording every collected zone for export.
+	void startCapture();
+	void stopCapture();
+	bool isCapturing() const;
+
+	//! Clears the captured zones.
+	void clearCapture();
+	unsigned int getCapturedZoneCount() const;
+
+	//! Writes the captured zones in the Chrome trace event format (chrome://tracing).
+	bool exportChromeTrace(const std::string& filename);
+
+	//! Returns the calling thread's buffer with the zone pushed on its stack, nullptr if not recording.
+	static ProfileThreadBuffer* beginZone(ProfileZone& zone);
+
+	static void endZone(ProfileThreadBuffer* buffer);
+
+	//! Returns the raw counter the zones are timed with, the time stamp counter where available.
+	static unsigned long long getTicks();
+
+	static Profiler* getInstance();
+
+protected:
+
+	struct ZoneData
+	{
+		std::string name;
+		int parent;
+		unsigned int depth;
+
+		unsigned int frameCalls;
+		unsigned long long frameTicks;
+		unsigned long long frameSelfTicks;
+
+		unsigned int calls;
+		unsigned int frames;
+		std::vector<float> times;
+		std::vector<float> selfTimes;
+	};
+
+	struct CapturedZone
+	{
+		unsigned int zone;
+		unsigned int thread;
+		unsigned long long begin;
+		unsigned long long end;
+	};
+
+	ProfileThreadBuffer* getThreadBuffer();
+
+	void collect(ProfileThreadBuffer* buffer, unsigned int thread);
+
+	double getTicksPerSecond();
+
+	ZoneData* createZone(const std::string& name);
+
+	static double getSeconds();
+
+	bool mEnabled;
+
+	unsigned int mThreadBufferSize;
+	unsigned int mStatsFrameCount;
+
+	unsigned int mFrameCount;
+	unsigned int mHistoryIndex;
+
+	unsigned long long mStartTicks;
+	double mStartSeconds;
+	double mTicksPerSecond;
+
+	std::vector<ProfileThreadBuffer*> mThreadBuffers;
+	mutable std::mutex mThreadMutex;
+
+	std::vector<ZoneData*> mZones;
+	hashmap<std::string, unsigned int> mZoneIndices;
+	mutable std::mutex mZoneMutex;
+
+	bool mCapturing;
+	std::vector<CapturedZone> mCapturedZones;
+	std::vector<unsigned long long> mCapturedFrames;
+
+	unsigned int mDroppedZones;
+
+	unsigned int mGeneration;
+};
+
+//! Records a zone from construction to destruction.
+class ProfileScope
+{
+public:
+
+	ProfileScope(ProfileZone& zone)
+	{
+		mBuffer = Profiler::beginZone(zone);
+	}
+
+	~ProfileScope()
+	{
+		if (mBuffer != nullptr)
+			Profiler::endZone(mBuffer);
+	}
+
+protected:
+
+	ProfileThreadBuffer* mBuffer;
+
+private:
+
+	ProfileScope(const ProfileScope&);
+	ProfileScope& operator=(const ProfileScope&);
+};
+
+} // end namespace core
+
+#endif
\ No newline at end of file
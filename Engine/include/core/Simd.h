@@ -0,0 +1,115 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _SIMD_H_
+#define _SIMD_H_
+
+#include <EngineConfig.h>
+#include <core/SimdDefines.h>
+
+namespace core
+{
+
+//! Bounding volumes stored as structure of arrays for the culling kernels.
+struct CullingVolumes
+{
+	const float* centerX;
+	const float* centerY;
+	const float* centerZ;
+
+	//! Radius of the spheres, used by cullSpheres.
+	const float* radius;
+
+	//! Half sizes of the axis aligned boxes, used by cullBoxes.
+	const float* extentX;
+	const float* extentY;
+	const float* extentZ;
+};
+
+//! Triangle set up for the depth rasterizer, in pixel coordinates.
+//! A pixel (x, y) is covered if edgeA[i] * x + (edgeB[i] * y + edgeC[i]) > 0 for the 3 edges,
+//! its depth is depthA * x + (depthB * y + depthC).
+struct DepthTriangle
+{
+	float edgeA[3];
+	float edgeB[3];
+	float edgeC[3];
+
+	float depthA;
+	float depthB;
+	float depthC;
+};
+
+//! Math kernels working on row major float[16] matrices and on batches of bounding volumes.
+//! Every implementation adds the products in the same order as the scalar one so that
+//! multiplications, transpositions, vector transforms and culling give bit-exact results.
+struct MathKernels
+{
+	//! out = a * b, out may alias a or b.
+	void (*multiply)(const float* a, const float* b, float* out);
+
+	//! out[i] = a * b[i] (left = true) or out[i] = b[i] * a (left = false), matrices are 16 floats apart.
+	void (*multiplyBatch)(const float* a, const float* b, float* out, unsigned int count, bool left);
+
+	//! Returns false and copies m to out if m has no inverse.
+	bool (*inverse)(const float* m, float* out);
+
+	void (*transpose)(const float* m, float* out);
+
+	//! Transforms count points (implicit w = 1) stored stride floats apart.
+	void (*transformPoints)(const float* m, const float* in, float* out, unsigned int count, unsigned int stride);
+
+	//! Transforms count 4 component vectors stored 4 floats apart.
+	void (*transformVectors)(const float* m, const float* in, float* out, unsigned int count);
+
+	//! Culls count spheres against 6 planes stored as (normal x, normal y, normal z, d) with the normals pointing inside.
+	//! Bit i % 32 of visible[i / 32] is set if sphere i is not fully behind a plane, the words are overwritten.
+	//! lastPlanes is optional, zero initialized it keeps per volume the plane that rejected it, which is tested first on the next call.
+	//! The SIMD kernels test a group of volumes from the plane of its first volume so the planes kept may differ between levels.
+	void (*cullSpheres)(const float* planes, const CullingVolumes& volumes, unsigned int count, unsigned int* visible, unsigned char* lastPlanes);
+
+	//! Culls count axis aligned boxes given by center and extent, see cullSpheres.
+	void (*cullBoxes)(const float* planes, const CullingVolumes& volumes, unsigned int count, unsigned int* visible, unsigned char* lastPlanes);
+
+	//! Keeps the nearest of the stored and the triangle depth in the covered pixels of columns [minX, maxX) and rows [minY, maxY).
+	//! \param pitch: Number of floats between two rows of depth.
+	void (*rasterizeDepth)(const DepthTriangle& triangle, float* depth, unsigned int pitch, unsigned int minX, unsigned int minY, unsigned int maxX, unsigned int maxY);
+};
+
+//! Returns the kernels selected with setSimdLevel.
+ENGINE_PUBLIC_EXPORT const MathKernels& getMathKernels();
+
+//! Returns the kernels for a given level, levels the compiler can not emit fall back to a lower one.
+ENGINE_PUBLIC_EXPORT const MathKernels& getMathKernels(SimdLevel level);
+
+//! Selects the kernels used by the math classes, call it only for levels the CPU supports.
+ENGINE_PUBLIC_EXPORT void setSimdLevel(SimdLevel level);
+
+ENGINE_PUBLIC_EXPORT SimdLevel getSimdLevel();
+
+} // end namespace core
+
+#endif
\ No newline at end of file
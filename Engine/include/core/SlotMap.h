@@ -0,0 +1,204 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _SLOT_MAP_H_
+#define _SLOT_MAP_H_
+
+#include <EngineConfig.h>
+#include <core/Handle.h>
+
+#include <vector>
+
+namespace core
+{
+
+//! Dense storage addressed through generational handles.
+//! The values are kept packed, removing one moves the last value into its place,
+//! so iteration walks a contiguous array. Insertion, removal and lookup are O(1).
+template <typename T>
+class SlotMap
+{
+public:
+
+	SlotMap()
+	{
+		mFreeSlot = 0xFFFFFFFF;
+	}
+
+	//! Adds a value and returns the handle referencing it.
+	Handle insert(const T& value)
+	{
+		unsigned int slot = mFreeSlot;
+		if (slot != 0xFFFFFFFF)
+		{
+			mFreeSlot = mSlots[slot].index;
+		}
+		else
+		{
+			slot = mSlots.size();
+			mSlots.push_back(Slot());
+			mSlots[slot].generation = 1;
+		}
+
+		mSlots[slot].index = mValues.size();
+
+		mValues.push_back(value);
+		mValueSlots.push_back(slot);
+
+		return Handle(slot, mSlots[slot].generation);
+	}
+
+	//! Removes the value, returns false if the handle is stale.
+	bool remove(const Handle& handle)
+	{
+		if (!contains(handle))
+			return false;
+
+		Slot& slot = mSlots[handle.index];
+		unsigned int index = slot.index;
+		unsigned int last = mValues.size() - 1;
+
+		if (index != last)
+		{
+			mValues[index] = mValues[last];
+			mValueSlots[index] = mValueSlots[last];
+			mSlots[mValueSlots[index]].index = index;
+		}
+
+		mValues.pop_back();
+		mValueSlots.pop_back();
+
+		// 0 is kept for handles that were never assigned
+		slot.generation++;
+		if (slot.generation == 0)
+			slot.generation = 1;
+
+		slot.index = mFreeSlot;
+		mFreeSlot = handle.index;
+
+		return true;
+	}
+
+	bool contains(const Handle& handle) const
+	{
+		return handle.index < mSlots.size() && mSlots[handle.index].generation == handle.generation;
+	}
+
+	//! Returns the value the handle references or nullptr if the handle is stale.
+	T* get(const Handle& handle)
+	{
+		if (!contains(handle))
+			return nullptr;
+
+		return &mValues[mSlots[handle.index].index];
+	}
+
+	const T* get(const Handle& handle) const
+	{
+		if (!contains(handle))
+			return nullptr;
+
+		return &mValues[mSlots[handle.index].index];
+	}
+
+	//! Returns the handle of the value stored at the given dense index.
+	Handle getHandle(unsigned int index) const
+	{
+		unsigned int slot = mValueSlots[index];
+		return Handle(slot, mSlots[slot].generation);
+	}
+
+	//! Removes all values, every handle given so far becomes stale.
+	void clear()
+	{
+		for (unsigned int i = 0; i < mValueSlots.size(); ++i)
+		{
+			Slot& slot = mSlots[mValueSlots[i]];
+
+			slot.generation++;
+			if (slot.generation == 0)
+				slot.generation = 1;
+
+			slot.index = mFreeSlot;
+			mFreeSlot = mValueSlots[i];
+		}
+
+		mValues.clear();
+		mValueSlots.clear();
+	}
+
+	void reserve(unsigned int count)
+	{
+		mValues.reserve(count);
+		mValueSlots.reserve(count);
+		mSlots.reserve(count);
+	}
+
+	unsigned int size() const
+	{
+		return mValues.size();
+	}
+
+	bool empty() const
+	{
+		return mValues.empty();
+	}
+
+	//! Dense access for iteration, the order changes when values are removed.
+	T& operator[](unsigned int index)
+	{
+		return mValues[index];
+	}
+
+	const T& operator[](unsigned int index) const
+	{
+		return mValues[index];
+	}
+
+	const std::vector<T>& getValues() const
+	{
+		return mValues;
+	}
+
+protected:
+
+	struct Slot
+	{
+		//! Dense index of the value while used, next free slot otherwise.
+		unsigned int index;
+		unsigned int generation;
+	};
+
+	std::vector<T> mValues;
+	std::vector<unsigned int> mValueSlots;
+	std::vector<Slot> mSlots;
+
+	unsigned int mFreeSlot;
+};
+
+} // end namespace core
+
+#endif
\ No newline at end of file
@@ -53,8 +53,8 @@ public:
 
 	// functions
 
-	inline void set(const vector3d center, const float radius);
-	inline void set(const sphere3d& s);
+	void set(const vector3d center, const float radius);
+	void set(const sphere3d& s);
 
 	vector3d Center;
 	float Radius;
@@ -29,6 +29,10 @@ THE SOFTWARE.
 
 #include <EngineConfig.h>
 #include <core/SystemDefines.h>
+#include <core/Profiler.h>
+
+#include <string>
+#include <list>
 
 namespace core
 {
@@ -69,6 +73,17 @@ public:
 	void registerDefaultFactories();
 	void removeDefaultFactories();
 
+	//! Declares that this system has to be updated after the given system.
+	void addDependency(System* system);
+	void removeDependency(System* system);
+	const std::list<System*>& getDependencies() const;
+
+	//! Sets if the system has to be updated on the main thread (window, graphics context, ...).
+	void setMainThreadUpdate(bool mainThread);
+	bool getMainThreadUpdate() const;
+
+	const std::string& getName() const;
+
 protected:
 
 	virtual void initializeImpl();
@@ -86,6 +101,11 @@ protected:
 	SystemState mState;
 
 	SystemDriver* mSystemDriver;
+
+	std::list<System*> mDependencies;
+	bool mMainThreadUpdate;
+
+	ProfileZone mProfileZone;
 };
 
 } // end namespace core
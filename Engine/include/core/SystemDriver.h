@@ -28,6 +28,7 @@ THE SOFTWARE.
 #define _SYSTEM_DRIVER_H_
 
 #include <EngineConfig.h>
+#include <core/Profiler.h>
 
 namespace core
 {
@@ -64,6 +65,8 @@ protected:
 	virtual void updateImpl(float elapsedTime);
 
 	std::string mName;
+
+	ProfileZone mProfileZone;
 };
 
 } // end namespace core
@@ -0,0 +1,102 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _SYSTEM_SCHEDULER_H_
+#define _SYSTEM_SCHEDULER_H_
+
+#include <EngineConfig.h>
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace core
+{
+
+class System;
+class JobCounter;
+
+//! Updates a group of systems following the dependencies they declare.
+//! A system is updated as soon as all of its dependencies are updated, systems that
+//! are not bound to the main thread are handed to the job system and run concurrently.
+class ENGINE_PUBLIC_EXPORT SystemScheduler
+{
+public:
+
+	SystemScheduler();
+	~SystemScheduler();
+
+	void addSystem(System* system);
+	void removeSystem(System* system);
+
+	//! Rebuilds the update graph after the dependencies of the systems changed.
+	void invalidate();
+
+	//! Updates all systems, returns once every one of them was updated.
+	void update(float elapsedTime);
+
+protected:
+
+	struct Node
+	{
+		System* system;
+		std::vector<unsigned int> dependents;
+		unsigned int dependencyCount;
+		std::atomic<int> remainingDependencies;
+	};
+
+	struct NodeJob
+	{
+		SystemScheduler* scheduler;
+		unsigned int node;
+	};
+
+	void build();
+	void clearNodes();
+
+	void dispatch(unsigned int node);
+	void updateNode(unsigned int node);
+
+	static void updateNodeJob(void* data);
+
+	std::vector<System*> mSystems;
+
+	std::vector<Node*> mNodes;
+	std::vector<NodeJob> mNodeJobs;
+	bool mNeedsRebuild;
+
+	float mElapsedTime;
+	JobCounter* mCounter;
+
+	std::mutex mMainThreadMutex;
+	std::deque<unsigned int> mMainThreadNodes;
+	std::atomic<int> mRemainingNodes;
+};
+
+} // end namespace core
+
+#endif
\ No newline at end of file
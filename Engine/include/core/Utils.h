@@ -35,33 +35,33 @@ THE SOFTWARE.
 namespace core
 {
 
-inline ENGINE_PUBLIC_EXPORT void stringTrim(std::string& str, const std::string& whitespace = " \t\n", bool left = true, bool right = true);
-inline ENGINE_PUBLIC_EXPORT void stringToLower(std::string& str);
-inline ENGINE_PUBLIC_EXPORT void stringToUpper(std::string& str);
+ENGINE_PUBLIC_EXPORT void stringTrim(std::string& str, const std::string& whitespace = " \t\n", bool left = true, bool right = true);
+ENGINE_PUBLIC_EXPORT void stringToLower(std::string& str);
+ENGINE_PUBLIC_EXPORT void stringToUpper(std::string& str);
 
-inline ENGINE_PUBLIC_EXPORT int stringToInt(std::string& str);
-inline ENGINE_PUBLIC_EXPORT float stringToFloat(std::string& str);
+ENGINE_PUBLIC_EXPORT int stringToInt(std::string& str);
+ENGINE_PUBLIC_EXPORT float stringToFloat(std::string& str);
 
-inline ENGINE_PUBLIC_EXPORT std::string intToString(unsigned int i);
-inline ENGINE_PUBLIC_EXPORT std::string intToString(int i);
-inline ENGINE_PUBLIC_EXPORT std::string floatToString(float f);
+ENGINE_PUBLIC_EXPORT std::string intToString(unsigned int i);
+ENGINE_PUBLIC_EXPORT std::string intToString(int i);
+ENGINE_PUBLIC_EXPORT std::string floatToString(float f);
 
-inline ENGINE_PUBLIC_EXPORT void stringReplaceChar(std::string& str, const char src, const char dest);
+ENGINE_PUBLIC_EXPORT void stringReplaceChar(std::string& str, const char src, const char dest);
 
-inline ENGINE_PUBLIC_EXPORT std::vector<std::string> splitString(const std::string& str, const std::string& delims = "\t\n ", unsigned int maxSplits = 0);
+ENGINE_PUBLIC_EXPORT std::vector<std::string> splitString(const std::string& str, const std::string& delims = "\t\n ", unsigned int maxSplits = 0);
 
-inline ENGINE_PUBLIC_EXPORT bool powerOfTwo(unsigned int num);
+ENGINE_PUBLIC_EXPORT bool powerOfTwo(unsigned int num);
 
 //! Convert N bit color channel value to P bits. It fills P bits with the bit pattern repeated.
-inline ENGINE_PUBLIC_EXPORT unsigned int fixedToFixed(unsigned int value, unsigned int n, unsigned int p);
+ENGINE_PUBLIC_EXPORT unsigned int fixedToFixed(unsigned int value, unsigned int n, unsigned int p);
 //! Convert floating point color channel value between 0.0 and 1.0 (otherwise clamped) to integer of a certain number of bits. Works for any value of bits between 0 and 31.
-inline ENGINE_PUBLIC_EXPORT unsigned int floatToFixed(const float value, const unsigned int bits);
+ENGINE_PUBLIC_EXPORT unsigned int floatToFixed(const float value, const unsigned int bits);
 //! Fixed point to float.
-inline ENGINE_PUBLIC_EXPORT float fixedToFloat(unsigned int value, unsigned int bits);
+ENGINE_PUBLIC_EXPORT float fixedToFloat(unsigned int value, unsigned int bits);
 //! Convert a float32 to a float16 (NV_half_float).Courtesy of OpenEXR.
-inline ENGINE_PUBLIC_EXPORT unsigned short int floatToHalf(float i);
+ENGINE_PUBLIC_EXPORT unsigned short int floatToHalf(float i);
 //! Convert a float16 (NV_half_float) to a float32.Courtesy of OpenEXR.
-inline ENGINE_PUBLIC_EXPORT float halfToFloat(unsigned short int y);
+ENGINE_PUBLIC_EXPORT float halfToFloat(unsigned short int y);
 
 } // end namespace core
 
@@ -37,11 +37,16 @@ THE SOFTWARE.
 
 #if ENGINE_PLATFORM == PLATFORM_WINDOWS
 #include <windows.h>
+#elif ENGINE_PLATFORM == PLATFORM_LINUX
+#include <sys/time.h>
 #endif
 
 namespace core
 {
 class Log;
+class Profiler;
+class JobSystem;
+class SystemScheduler;
 }
 
 namespace platform
@@ -125,7 +130,10 @@ protected:
 	unsigned long mLastUpdateStartTime;
 	unsigned long mLastUpdateEndTime;
 
+	core::Profiler*				mProfiler;
 	core::Log*					mLog;
+	core::JobSystem*			mJobSystem;
+	core::SystemScheduler*		mSystemScheduler;
 	EngineSettings*				mSettings;
 
 	PluginManager*				mPluginManager;
@@ -137,6 +145,9 @@ protected:
 	physics::PhysicsManager*	mPhysicsManager;
 	game::GameManager*			mGameManager;
 
+	//! Declares which managers have to be updated before which.
+	void setupUpdateDependencies();
+
 	void resetTimer();
 
 	unsigned long getMilliseconds();
@@ -166,6 +177,8 @@ protected:
 	LARGE_INTEGER	mFrequency;
 
 	DWORD_PTR		mTimerMask;
+#elif ENGINE_PLATFORM == PLATFORM_LINUX
+	timeval			mStartTime;
 #endif
 };
 
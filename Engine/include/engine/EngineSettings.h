@@ -50,6 +50,8 @@ public:
 	const std::string& getDataPath();
 	const std::string& getWorkPath();
 	void* getMainWindowId();
+	//! Returns the number of job system worker threads, a negative value means one per extra processor.
+	const int getWorkerThreads();
 
 	void setWidth(unsigned int width);
 	void setHeight(unsigned int height);
@@ -58,6 +60,7 @@ public:
 	void setVSync(bool vsync);
 	void setDataPath(const std::string& dataPath);
 	void setMainWindowID(void* windowId);
+	void setWorkerThreads(int workerThreads);
 
 	//! Method reads a game configuration file and instantiates all options.
 	//! \param optionsfile: The file that contains game information.
@@ -81,6 +84,7 @@ protected:
 	bool mVSync;
 	std::string mDataPath;
 	std::string mWorkPath;
+	int mWorkerThreads;
 
 	void* mMainWindowId;
 };
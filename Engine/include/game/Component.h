@@ -29,6 +29,7 @@ THE SOFTWARE.
 
 #include <EngineConfig.h>
 #include <game/ComponentDefines.h>
+#include <core/Handle.h>
 
 #include <string>
 
@@ -47,6 +48,14 @@ public:
 	//! Returns the id of the game object.
 	const unsigned int& getID() const;
 
+	//! Returns the handle of the component in the GameManager.
+	const core::Handle& getHandle() const;
+	void setHandle(const core::Handle& handle);
+
+	//! Returns the handle of the component in the manager that processes it (render, physics, sound).
+	const core::Handle& getSystemHandle() const;
+	void setSystemHandle(const core::Handle& handle);
+
 	const std::string& getName() const;
 
 	//! Gets object type.
@@ -58,8 +67,19 @@ public:
 	//! Uninitialize object.
 	void uninitialize();
 
+	//! Updates the component, for thread-safe component types this runs on the job system workers
+	//! (see ComponentFactory::isThreadSafe), updateImpl may then only change the component itself and read
+	//! the other components, everything else has to be left to commitImpl.
 	void update(float elapsedTime);
 
+	//! Asks for commitImpl to be called in the serial phase that follows the update, safe to call from updateImpl.
+	void requestCommit();
+
+	bool isCommitRequested() const;
+
+	//! Applies the changes recorded during the update, called serially by the GameManager.
+	void commit();
+
 	//! Returns true if the Component has been initialized.
 	bool isInitialized() const;
 
@@ -69,28 +89,58 @@ public:
 
 	void onMessage(unsigned int messageID);
 
+	//! Returns the mask of the message types the component handles (see MESSAGE_MASK).
+	inline unsigned int getMessageMask() const;
+
+	//! Returns true if the component handles the message type.
+	inline bool isSubscribed(unsigned int messageID) const;
+
 	GameObject* getGameObject();
 
 protected:
 
 	unsigned int mID;
 
+	core::Handle mHandle;
+	core::Handle mSystemHandle;
+
 	std::string mName;
 
 	static unsigned int mIndexCounter;
 
 	unsigned int mType;
 
+	//! Message types delivered to onMessageImpl, set by the derived constructors, everything by default.
+	unsigned int mMessageMask;
+
 	virtual void initializeImpl();
 	virtual void uninitializeImpl();
 	virtual void updateImpl(float elapsedTime);
+	virtual void commitImpl();
+	virtual void onAttachImpl();
+	virtual void onDetachImpl();
 	virtual void onMessageImpl(unsigned int messageID);
 
 	bool mInitialized;
 
+	bool mCommitRequested;
+
 	GameObject* mGameObject;
 };
 
+inline unsigned int Component::getMessageMask() const
+{
+	return mMessageMask;
+}
+
+inline bool Component::isSubscribed(unsigned int messageID) const
+{
+	if (messageID >= 32)
+		return true;
+
+	return (mMessageMask & (1 << messageID)) != 0;
+}
+
 } // end namespace game
 
 #endif
\ No newline at end of file
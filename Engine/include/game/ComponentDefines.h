@@ -30,6 +30,8 @@ THE SOFTWARE.
 namespace game
 {
 
+//! Built-in component types, GameObject keeps one slot and one mask bit for each so there must be at most 32.
+//! User-registered component types start at COMPONENT_TYPE_COUNT.
 enum ComponentType
 {
 	COMPONENT_TYPE_UNDEFINED,
@@ -29,6 +29,8 @@ THE SOFTWARE.
 
 #include <EngineConfig.h>
 
+#include <string>
+
 namespace game
 {
 
@@ -39,6 +41,7 @@ class ENGINE_PUBLIC_EXPORT ComponentFactory
 public:
 
 	ComponentFactory();
+	virtual ~ComponentFactory();
 
 	//! Creates a new component.
 	virtual Component* createComponent() = 0;
@@ -46,12 +49,24 @@ public:
 	//! Destroys a component which was created by this factory.
 	virtual void destroyComponent(Component* component) = 0;
 
+	//! Updates every live component created by this factory that is attached to a game object.
+	//! Returns false if the factory does not keep track of the components it creates.
+	virtual bool updateComponents(float elapsedTime);
+
+	//! Commits, in a deterministic order, the components that requested it during updateComponents.
+	virtual void commitComponents();
+
+	//! Returns true if the components of this type can be updated concurrently (see Component::update).
+	bool isThreadSafe() const;
+
 	//! Return the name of the type of component this factory creates.
 	const std::string& getName();
 
 protected:
 
 	std::string mName;
+
+	bool mThreadSafe;
 };
 
 } // end namespace game
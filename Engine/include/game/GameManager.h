@@ -30,10 +30,12 @@ THE SOFTWARE.
 #include <EngineConfig.h>
 #include <core/Singleton.h>
 #include <core/System.h>
+#include <core/SlotMap.h>
 #include <resource/ResourceEventReceiver.h>
 
 #include <string>
 #include <map>
+#include <vector>
 
 namespace game
 {
@@ -43,6 +45,8 @@ class GameObject;
 class Component;
 class ComponentFactory;
 class TransformFactory;
+class TransformHierarchy;
+class MessageBus;
 class SceneFactory;
 
 class ENGINE_PUBLIC_EXPORT GameManager: public core::System, public core::Singleton<GameManager>
@@ -73,26 +77,38 @@ public:
 	GameObject* createGameObject(GameObject* parent = nullptr);
 	GameObject* createGameObject(const std::string& name, GameObject* parent = nullptr);
 
+	//! Returns the game object the handle references or nullptr if it was removed.
+	GameObject* getGameObject(const core::Handle& handle);
+
 	//! Remove a game object from the managed list.
 	void removeGameObject(GameObject* gameObject);
-	void removeGameObject(const unsigned int& id);
+	void removeGameObject(const core::Handle& handle);
 
 	void removeAllGameObjects();
 
-	const std::map<unsigned int, GameObject*>& getGameObjects();
+	const core::SlotMap<GameObject*>& getGameObjects();
 
 	//! Creates a component.
 	Component* createComponent(unsigned int type);
 
+	//! Returns the component the handle references or nullptr if it was removed.
+	Component* getComponent(const core::Handle& handle);
+
 	//! Remove a Compoent from the managed list.
 	void removeComponent(Component* component);
-	void removeComponent(const unsigned int& id);
+	void removeComponent(const core::Handle& handle);
 
 	void removeAllComponents();
 
 	void registerComponentFactory(unsigned int type, ComponentFactory* factory);
 	void removeComponentFactory(unsigned int type);
 
+	//! Gets the storage of all transforms.
+	TransformHierarchy* getTransformHierarchy();
+
+	//! Gets the queue of the deferred game object messages.
+	MessageBus* getMessageBus();
+
 	static GameManager* getInstance();
 
 protected:
@@ -108,13 +124,23 @@ protected:
 	std::string mNewSceneName;
 	Scene* mCurrentScene;
 
-	std::map<unsigned int, GameObject*> mGameObjects;
-	std::map<unsigned int, Component*> mComponents;
+	core::SlotMap<GameObject*> mGameObjects;
+	core::SlotMap<Component*> mComponents;
 	std::map<unsigned int, ComponentFactory*> mComponentFactories;
 
+	//! Types whose factory does not keep track of its components, refilled on each update.
+	std::vector<unsigned int> mUntrackedComponentTypes;
+
+	//! Components of untracked types that requested a commit during the update phase.
+	std::vector<Component*> mUntrackedCommits;
+
 	SceneFactory* mDefaultSceneFactory;
 
 	TransformFactory* mDefaultTransformFactory;
+
+	TransformHierarchy* mTransformHierarchy;
+
+	MessageBus* mMessageBus;
 };
 
 } // end namespace engine
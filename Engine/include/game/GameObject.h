@@ -28,14 +28,18 @@ THE SOFTWARE.
 #define _GAME_OBJECT_H_
 
 #include <EngineConfig.h>
+#include <core/Handle.h>
+#include <core/SlotMap.h>
+#include <game/ComponentDefines.h>
 
 #include <string>
-#include <map>
+#include <vector>
 
 namespace game
 {
 
 class Component;
+class Transform;
 
 class ENGINE_PUBLIC_EXPORT GameObject
 {
@@ -49,6 +53,10 @@ public:
 	//! Returns the id of the game object.
 	const unsigned int& getID() const;
 
+	//! Returns the handle of the game object in the GameManager.
+	const core::Handle& getHandle() const;
+	void setHandle(const core::Handle& handle);
+
 	const std::string& getName() const;
 	void setName(const std::string& name);
 
@@ -66,25 +74,52 @@ public:
 
 	void removeAllChildren();
 
-	const std::map<unsigned int, GameObject*>& getChildren();
+	//! Returns the children, the order changes when children are removed.
+	const std::vector<GameObject*>& getChildren() const;
 
+	//! Attaches a component, only one component of each type can be attached.
 	void attachComponent(Component* component);
 
 	void detachComponent(Component* component);
 
-	Component* getComponent(unsigned int type);
+	//! Returns the attached component of the given type or nullptr.
+	inline Component* getComponent(unsigned int type) const;
+
+	//! Returns true if a component of the given type is attached.
+	inline bool hasComponent(unsigned int type) const;
+
+	//! Returns the bitmask of the attached built-in component types (bit n is ComponentType n).
+	inline unsigned int getComponentMask() const;
+
+	//! Returns the attached Transform component (cached) or nullptr.
+	inline Transform* getTransform() const;
 
-	const std::map<unsigned int, Component*>& getComponents();
+	//! Returns the attached components ordered by type.
+	const std::vector<Component*>& getComponents() const;
 
+	//! Delivers the message right away to the subscribed components of this game object and its children.
 	void sendMessage(Component* source, unsigned int messageID);
 	void sendMessage(GameObject* source, unsigned int messageID);
 
+	//! Queues the message on the MessageBus, it is delivered at the next sync point of the GameManager update.
+	//! Without children a message type already queued for this game object is not queued again,
+	//! and nothing is queued when no attached component subscribes to it.
+	void postMessage(Component* source, unsigned int messageID, bool includeChildren = false);
+
+	//! Delivers the message right away to the subscribed components of this game object only, except the source.
+	void deliverMessage(Component* source, unsigned int messageID);
+
+	//! Returns the union of the message masks of the attached components.
+	unsigned int getMessageMask() const;
+
 	void update(float elapsedTime);
 
 protected:
 
 	unsigned int mID;
 
+	core::Handle mHandle;
+
 	std::string mName;
 
 	static unsigned int mIndexCounter;
@@ -93,12 +128,67 @@ protected:
 
 	GameObject* mParent;
 
-	//! Central list of children.
-	std::map<unsigned int, GameObject*> mChildren;
+	//! Handle of this game object in the children of its parent.
+	core::Handle mChildHandle;
+
+	//! Central list of children, packed so that messages walk them in a contiguous array.
+	core::SlotMap<GameObject*> mChildren;
+
+	//! Attached built-in components indexed by type.
+	Component* mComponentSlots[COMPONENT_TYPE_COUNT];
+	unsigned int mComponentMask;
+
+	Transform* mTransform;
+
+	//! All attached components ordered by type, user-registered types (>= COMPONENT_TYPE_COUNT) are only found here.
+	std::vector<Component*> mComponents;
+
+	//! Message masks of the built-in components, kept next to the slots so that delivering a message
+	//! does not touch the components that do not handle it.
+	unsigned int mComponentMessageMasks[COMPONENT_TYPE_COUNT];
+
+	//! Number of attached user-registered components.
+	unsigned int mUserComponentCount;
 
-	std::map<unsigned int, Component*> mComponents;
+	//! Union of the message masks of the attached components.
+	unsigned int mMessageMask;
+
+	//! Message types queued on the MessageBus for this game object only.
+	unsigned int mPostedMessages;
+
+	Component* findUserComponent(unsigned int type) const;
+
+	void updateMessageMask();
+
+	friend class MessageBus;
 };
 
+inline Component* GameObject::getComponent(unsigned int type) const
+{
+	if (type < COMPONENT_TYPE_COUNT)
+		return mComponentSlots[type];
+
+	return findUserComponent(type);
+}
+
+inline bool GameObject::hasComponent(unsigned int type) const
+{
+	if (type < COMPONENT_TYPE_COUNT)
+		return (mComponentMask & (1 << type)) != 0;
+
+	return findUserComponent(type) != nullptr;
+}
+
+inline unsigned int GameObject::getComponentMask() const
+{
+	return mComponentMask;
+}
+
+inline Transform* GameObject::getTransform() const
+{
+	return mTransform;
+}
+
 } // end namespace game
 
 #endif
\ No newline at end of file
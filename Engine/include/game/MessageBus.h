@@ -0,0 +1,90 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _MESSAGE_BUS_H_
+#define _MESSAGE_BUS_H_
+
+#include <EngineConfig.h>
+#include <core/Singleton.h>
+#include <core/Handle.h>
+
+#include <vector>
+
+namespace game
+{
+
+class GameObject;
+class Component;
+
+//! Deferred delivery of game object messages.
+//! Messages posted while the game is updated are recorded in one queue per message type and delivered
+//! in batches at the sync points of the GameManager update, lowest message type first.
+//! Only the components whose message mask contains the type receive it.
+//! The queued game objects are referenced by handle, messages for game objects removed in between are dropped.
+//! Messages have to be posted from the thread running the GameManager update.
+class ENGINE_PUBLIC_EXPORT MessageBus: public core::Singleton<MessageBus>
+{
+public:
+
+	MessageBus();
+	~MessageBus();
+
+	//! Queues a message for the components of the target game object, and its children if includeChildren is true.
+	//! The source component does not receive the message.
+	void postMessage(GameObject* target, Component* source, unsigned int messageID, bool includeChildren);
+
+	//! Delivers the queued messages, messages posted by the handlers are delivered in the same call.
+	void dispatchMessages();
+
+	//! Drops all the queued messages.
+	void clear();
+
+	//! Returns the number of queued messages.
+	unsigned int getPendingMessageCount() const;
+
+	static MessageBus* getInstance();
+
+protected:
+
+	struct MessageRecord
+	{
+		core::Handle target;
+		Component* source;
+		bool includeChildren;
+	};
+
+	//! Queued messages indexed by message type.
+	std::vector<std::vector<MessageRecord> > mQueues;
+
+	//! Batch being delivered, kept to reuse its memory.
+	std::vector<MessageRecord> mDispatchQueue;
+
+	unsigned int mPendingMessageCount;
+};
+
+} // end namespace game
+
+#endif
\ No newline at end of file
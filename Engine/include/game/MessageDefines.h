@@ -38,6 +38,11 @@ enum Message
 	MESSAGE_COUNT
 };
 
+//! Bit of a message type in a component subscription mask, message types above 31 have no bit and are always delivered.
+#define MESSAGE_MASK(message)	(1 << (message))
+#define MESSAGE_MASK_NONE		0
+#define MESSAGE_MASK_ALL		0xFFFFFFFF
+
 } // end namespace game
 
 #endif
\ No newline at end of file
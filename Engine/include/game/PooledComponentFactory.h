@@ -0,0 +1,150 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _POOLED_COMPONENT_FACTORY_H_
+#define _POOLED_COMPONENT_FACTORY_H_
+
+#include <EngineConfig.h>
+#include <game/ComponentFactory.h>
+#include <core/ObjectPool.h>
+#include <core/JobSystem.h>
+
+#include <vector>
+
+namespace game
+{
+
+//! Component factory that allocates its components from a chunked pool,
+//! so all the components of one type are contiguous in memory and can be iterated without walking the game objects.
+//! Thread-safe types are updated in parallel, every pool chunk being one job, the commits requested during
+//! the update are recorded per chunk and applied in chunk order so the result does not depend on the thread count.
+//! Base is the factory class to derive from, it has to derive from ComponentFactory.
+template <typename T, typename Base = ComponentFactory>
+class PooledComponentFactory: public Base
+{
+public:
+
+	PooledComponentFactory(unsigned int chunkSize = 256): Base(), mPool(chunkSize) {}
+
+	//! Creates a new component from the pool.
+	Component* createComponent()
+	{
+		return mPool.create();
+	}
+
+	//! Returns a component which was created by this factory to the pool.
+	void destroyComponent(Component* component)
+	{
+		mPool.destroy(static_cast<T*>(component));
+	}
+
+	//! Updates the live components that are attached to a game object.
+	bool updateComponents(float elapsedTime)
+	{
+		unsigned int chunkCount = mPool.getChunkCount();
+		if (mChunkCommits.size() < chunkCount)
+			mChunkCommits.resize(chunkCount);
+
+		ChunkUpdate chunkUpdate;
+		chunkUpdate.factory = this;
+		chunkUpdate.elapsedTime = elapsedTime;
+
+		core::JobSystem* pJobSystem = core::JobSystem::getInstance();
+		if (this->mThreadSafe && pJobSystem != nullptr && pJobSystem->getWorkerCount() > 0 && chunkCount > 1)
+			pJobSystem->parallelFor(chunkCount, &PooledComponentFactory::updateChunks, &chunkUpdate, 1);
+		else
+			updateChunks(0, chunkCount, &chunkUpdate);
+
+		return true;
+	}
+
+	//! Commits the components that requested it, in pool order. commitImpl must not destroy components of this type.
+	void commitComponents()
+	{
+		for (unsigned int i = 0; i < mChunkCommits.size(); ++i)
+		{
+			std::vector<T*>& commits = mChunkCommits[i];
+			for (unsigned int j = 0; j < commits.size(); ++j)
+				commits[j]->commit();
+
+			commits.clear();
+		}
+	}
+
+	//! Calls function(T*) for every live component created by this factory, in memory order.
+	template <typename F>
+	void forEach(F function)
+	{
+		mPool.forEach(function);
+	}
+
+	//! Returns the number of live components created by this factory.
+	unsigned int getComponentCount() const
+	{
+		return mPool.size();
+	}
+
+protected:
+
+	struct ChunkUpdate
+	{
+		PooledComponentFactory* factory;
+		float elapsedTime;
+	};
+
+	static void updateChunks(unsigned int begin, unsigned int end, void* data)
+	{
+		ChunkUpdate* pChunkUpdate = static_cast<ChunkUpdate*>(data);
+		PooledComponentFactory* pFactory = pChunkUpdate->factory;
+		float elapsedTime = pChunkUpdate->elapsedTime;
+
+		for (unsigned int i = begin; i < end; ++i)
+		{
+			// every chunk is processed by a single job, so its commit list needs no locking
+			std::vector<T*>& commits = pFactory->mChunkCommits[i];
+
+			pFactory->mPool.forEach(i, i + 1, [elapsedTime, &commits](T* component)
+			{
+				if (component->getGameObject() == nullptr)
+					return;
+
+				component->update(elapsedTime);
+
+				if (component->isCommitRequested())
+					commits.push_back(component);
+			});
+		}
+	}
+
+	core::ObjectPool<T> mPool;
+
+	//! Components that requested a commit, per pool chunk.
+	std::vector<std::vector<T*> > mChunkCommits;
+};
+
+} // end namespace game
+
+#endif
\ No newline at end of file
@@ -105,39 +105,19 @@ public:
 	virtual void rotateY(float degrees, TransformSpace relativeTo = TRANSFORM_SPACE_LOCAL);
 	virtual void rotateZ(float degrees, TransformSpace relativeTo = TRANSFORM_SPACE_LOCAL);
 
+	//! Gets the handle of the transform data in the transform hierarchy.
+	unsigned int getHandle() const;
+
 protected:
 
-	void updateImpl(float elapsedTime);
+	void onAttachImpl();
+	void onDetachImpl();
 	void onMessageImpl(unsigned int messageID);
 
 	bool mVisibleAxis;
 
-	//! Stores the position/translation relative to its parent.
-	core::vector3d mPosition;
-
-	//! Stores the orientation relative to it's parent.
-	core::quaternion mOrientation;
-
-	//! Stores the scaling factor.
-	core::vector3d mScale;
-
-	//! Cached combined position.
-	core::vector3d mAbsolutePosition;
-
-	//! Cached combined orientation.
-	core::quaternion mAbsoluteOrientation;
-
-	//! Cached combined scale.
-	core::vector3d mAbsoluteScale;
-
-	//! Flag indicating transform needs an update.
-	bool mTransformNeedsUpdate;
-
-	//! Stores whether inherits orientation from it's parent
-	bool mInheritOrientation;
-
-	//! Stores whether inherits scale from it's parent
-	bool mInheritScale;
+	//! Handle of the local and absolute data stored in the transform hierarchy.
+	unsigned int mHandle;
 };
 
 } // end namespace game
@@ -28,14 +28,15 @@ THE SOFTWARE.
 #define _TRANSFORM_FACTORY_H_
 
 #include <EngineConfig.h>
-#include <game/ComponentFactory.h>
+#include <game/PooledComponentFactory.h>
+#include <game/Transform.h>
 
 namespace game
 {
 
 class Component;
 
-class ENGINE_PUBLIC_EXPORT TransformFactory: public ComponentFactory
+class ENGINE_PUBLIC_EXPORT TransformFactory: public PooledComponentFactory<Transform>
 {
 public:
 
@@ -0,0 +1,143 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef _TRANSFORM_HIERARCHY_H_
+#define _TRANSFORM_HIERARCHY_H_
+
+#include <EngineConfig.h>
+#include <core/Singleton.h>
+#include <core/Vector3d.h>
+#include <core/Quaternion.h>
+
+#include <vector>
+
+namespace game
+{
+
+class Transform;
+
+//! Storage for the local and absolute data of all transforms.
+//! The data is kept in parallel arrays sorted by hierarchy depth so that parents always come before
+//! their children and every depth level is a contiguous range.
+//! Within a level the nodes are sorted by parent, so the children of a range of parents are a range too.
+//! The update walks the levels top-down over the range of the dirty nodes of each level joined with the
+//! children of the nodes that changed on the level above, and splits it between the job system workers,
+//! since nodes of the same level never depend on each other.
+//! Transforms reference their data through a handle that stays valid while the arrays are reordered.
+class ENGINE_PUBLIC_EXPORT TransformHierarchy: public core::Singleton<TransformHierarchy>
+{
+public:
+
+	TransformHierarchy();
+	~TransformHierarchy();
+
+	//! Adds a transform and returns its handle.
+	unsigned int addTransform(Transform* transform);
+
+	//! Removes the transform with the given handle.
+	void removeTransform(unsigned int handle);
+
+	//! Tells the parent links have to be resolved again before the next update.
+	void invalidateHierarchy();
+
+	//! Marks the transform as needing an update.
+	void setDirty(unsigned int handle);
+
+	core::vector3d& getPosition(unsigned int handle);
+	core::quaternion& getOrientation(unsigned int handle);
+	core::vector3d& getScale(unsigned int handle);
+
+	const core::vector3d& getAbsolutePosition(unsigned int handle);
+	const core::quaternion& getAbsoluteOrientation(unsigned int handle);
+	const core::vector3d& getAbsoluteScale(unsigned int handle);
+
+	bool getInheritOrientation(unsigned int handle);
+	void setInheritOrientation(unsigned int handle, bool inherit);
+
+	bool getInheritScale(unsigned int handle);
+	void setInheritScale(unsigned int handle, bool inherit);
+
+	//! Returns the number of hierarchy levels.
+	unsigned int getLevelCount() const;
+
+	//! Returns the number of transforms.
+	unsigned int getTransformCount() const;
+
+	//! Updates the absolute data of all dirty subtrees and notifies the subscribed components of the moved game objects.
+	void update();
+
+	static TransformHierarchy* getInstance();
+
+protected:
+
+	enum TransformFlag
+	{
+		TRANSFORM_FLAG_DIRTY				= 1 << 0,
+		TRANSFORM_FLAG_CHANGED				= 1 << 1,
+		TRANSFORM_FLAG_INHERIT_ORIENTATION	= 1 << 2,
+		TRANSFORM_FLAG_INHERIT_SCALE		= 1 << 3
+	};
+
+	//! Resolves the parent links from the game objects and sorts the data by depth.
+	void rebuild();
+
+	//! Updates the nodes [begin, end) of the level being processed.
+	static void updateRange(unsigned int begin, unsigned int end, void* data);
+
+	void notifyChanged(unsigned int begin, unsigned int end);
+
+	std::vector<core::vector3d> mPositions;
+	std::vector<core::quaternion> mOrientations;
+	std::vector<core::vector3d> mScales;
+
+	std::vector<core::vector3d> mAbsolutePositions;
+	std::vector<core::quaternion> mAbsoluteOrientations;
+	std::vector<core::vector3d> mAbsoluteScales;
+
+	std::vector<unsigned int> mParents;
+	std::vector<unsigned char> mFlags;
+	std::vector<Transform*> mTransforms;
+
+	//! Maps handles to array indices and back.
+	std::vector<unsigned int> mHandleIndices;
+	std::vector<unsigned int> mIndexHandles;
+	std::vector<unsigned int> mFreeHandles;
+
+	//! Start index of every level, followed by the total node count.
+	std::vector<unsigned int> mLevelOffsets;
+
+	//! Per level range of the dirty nodes, empty while the begin is not below the end.
+	std::vector<unsigned int> mDirtyBegins;
+	std::vector<unsigned int> mDirtyEnds;
+
+	//! Depth of every node, used to find its level when it gets dirty.
+	std::vector<unsigned int> mDepths;
+
+	bool mHierarchyNeedsUpdate;
+};
+
+} // end namespace game
+
+#endif
\ No newline at end of file
@@ -30,13 +30,13 @@ THE SOFTWARE.
 #include <EngineConfig.h>
 #include <core/SystemDriver.h>
 #include <core/Position2d.h>
+#include <input/InputDeviceDefines.h>
 
 namespace input
 {
 
 class Cursor;
 class InputDevice;
-enum InputType;
 
 //! Defines the functionality of a input API
 //! Author: Kat'Oun
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include <core/System.h>
 #include <core/Singleton.h>
 #include <core/Position2d.h>
+#include <input/InputDeviceDefines.h>
 
 #include <map>
 
@@ -40,7 +41,6 @@ namespace input
 class Cursor;
 class InputDriver;
 class InputDevice;
-enum InputType;
 
 class ENGINE_PUBLIC_EXPORT InputManager: public core::System, public core::Singleton<InputManager>
 {
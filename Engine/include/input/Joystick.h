@@ -29,6 +29,7 @@ THE SOFTWARE.
 
 #include <EngineConfig.h>
 #include <input/InputDevice.h>
+#include <input/KeyboardDefines.h>
 
 #include <list>
 
@@ -37,8 +38,6 @@ namespace input
 
 class JoystickEventReceiver;
 class JoystickEvent;
-enum KeyCode;
-enum KeyModifier;
 
 //! A common base class for joystick device.
 class ENGINE_PUBLIC_EXPORT Joystick: public InputDevice
@@ -29,6 +29,7 @@ THE SOFTWARE.
 
 #include <EngineConfig.h>
 #include <input/InputDevice.h>
+#include <input/KeyboardDefines.h>
 
 #include <list>
 
@@ -37,8 +38,6 @@ namespace input
 
 class KeyEventReceiver;
 class KeyEvent;
-enum KeyCode;
-enum KeyModifier;
 
 //! A common base class for keyboard device.
 class ENGINE_PUBLIC_EXPORT Keyboard: public InputDevice
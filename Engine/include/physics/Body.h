@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include <core/Vector3d.h>
 #include <game/Component.h>
 #include <resource/ResourceEventReceiver.h>
+#include <physics/BodyData.h>
 
 #include <string>
 
@@ -40,7 +41,6 @@ namespace physics
 class Material;
 class BodyData;
 class Joint;
-enum BodyType;
 
 //! Defines an actor in the physics world.
 //! Author: Kat'Oun
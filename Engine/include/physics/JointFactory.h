@@ -28,12 +28,12 @@ THE SOFTWARE.
 #define _JOINT_FACTORY_H_
 
 #include <EngineConfig.h>
+#include <physics/JointDefines.h>
 
 namespace physics
 {
 
 class Joint;
-enum JointType;
 
 class ENGINE_PUBLIC_EXPORT JointFactory
 {
@@ -29,6 +29,8 @@ THE SOFTWARE.
 
 #include <EngineConfig.h>
 #include <core/SystemDriver.h>
+#include <physics/ShapeDefines.h>
+#include <physics/JointDefines.h>
 
 namespace core
 {
@@ -45,8 +47,6 @@ class Shape;
 class Material;
 class Joint;
 struct CollisionPoint;
-enum ShapeType;
-enum JointType;
 
 //! Defines the functionality of a 3D Physics API
 //!
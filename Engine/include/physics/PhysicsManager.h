@@ -35,6 +35,9 @@ THE SOFTWARE.
 #include <resource/Resource.h>
 #include <resource/ResourceManager.h>
 #include <physics/CollisionEventReceiver.h>
+#include <physics/BodyData.h>
+#include <physics/ShapeDefines.h>
+#include <physics/JointDefines.h>
 
 #include <string>
 #include <map>
@@ -59,9 +62,6 @@ class Material;
 class PhysicsDriver;
 struct CollisionPoint;
 struct CollisionEvent;
-enum BodyType;
-enum ShapeType;
-enum JointType;
 
 //! Physics Manager.
 //! 
@@ -120,6 +120,11 @@ public:
 	void addCollisionEventReceiver(CollisionEventReceiver* newEventReceiver);
 	void removeCollisionEventReceiver(CollisionEventReceiver* oldEventReceiver);
 
+	//! Fires the collision events queued by the last update.
+	//! The physics step runs on a worker next to the other systems, its receivers move nodes and play sounds
+	//! so the events are only fired from the main thread once the systems are updated.
+	void fireCollisionEvents();
+
 	void setBodyFactory(BodyFactory* factory);
 	void removeBodyFactory();
 
@@ -159,8 +164,25 @@ protected:
 	
 	PhysicsDriver* mPhysicsDriver;
 
+	enum CollisionEventType
+	{
+		COLLISION_EVENT_STARTED,
+		COLLISION_EVENT_UPDATE,
+		COLLISION_EVENT_ENDED
+	};
+
+	//! The points are owned by the driver until its next update.
+	struct QueuedCollisionEvent
+	{
+		CollisionEventType type;
+		Body* body1;
+		Body* body2;
+		std::vector<CollisionPoint*> points;
+	};
+
 	static CollisionEvent* mCollisionEvent;
 	static std::list<CollisionEventReceiver*> mCollisionEventReceivers;
+	static std::vector<QueuedCollisionEvent> mQueuedCollisionEvents;
 
 	//! Central list of bodies - for easy memory management and lookup.
 	std::map<unsigned int, Body*> mBodies;
@@ -28,12 +28,12 @@ THE SOFTWARE.
 #define _SHAPE_FACTORY_H_
 
 #include <EngineConfig.h>
+#include <physics/ShapeDefines.h>
 
 namespace physics
 {
 
 class Shape;
-enum ShapeType;
 
 class ENGINE_PUBLIC_EXPORT ShapeFactory
 {
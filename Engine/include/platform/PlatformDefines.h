@@ -80,6 +80,11 @@ enum CpuFeature
 	CPU_FEATURE_SSEMMX,		//"SSE MMX"
 	CPU_FEATURE_MMXPLUS,	//"MMX+"
 	CPU_FEATURE_SUPPORTSMP,	//"Supports Multiprocessing"
+
+	// Extended state features
+	CPU_FEATURE_AVX,		//"AVX Extensions"
+	CPU_FEATURE_AVX2,		//"AVX2 Extensions"
+	CPU_FEATURE_FMA,		//"Fused Multiply Add"
 };
 
 enum CacheLevel
@@ -42,8 +42,6 @@ struct CPUInfo;
 namespace platform
 {
 
-enum CpuFeature;
-
 //! Class which manages the platform settings the Game runs on.
 //! Because the Game is designed to be platform-independent, it
 //! dynamically loads a library containing all the platform-specific
@@ -86,6 +84,11 @@ public:
 
 protected:
 
+	void initializeImpl();
+
+	//! Reads the AVX family flags, they are not reported by CPUInfo.
+	void checkExtendedStateFeatures();
+
 	std::string mCPUVendor;
 	std::string mCPUName;
 	std::string mCPUType;
@@ -94,6 +97,10 @@ protected:
 	CPUInfo* mCPUInfos;
 	CPUInfo* mCPUInfo;
 	int mProcessorCount;
+
+	bool mAVX;
+	bool mAVX2;
+	bool mFMA;
 };
 
 } // end namespace platform
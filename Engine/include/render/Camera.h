@@ -31,13 +31,12 @@ THE SOFTWARE.
 #include <core/Matrix4.h>
 #include <core/Vector3d.h>
 #include <game/Component.h>
+#include <render/CameraDefines.h>
 
 namespace render
 {
 
 class Frustum;
-enum ProjectionType;
-enum SceneDetailLevel;
 
 //!	A viewpoint from which the scene will be rendered.
 
@@ -28,7 +28,8 @@ THE SOFTWARE.
 #define _CAMERA_FACTORY_H_
 
 #include <EngineConfig.h>
-#include <game/ComponentFactory.h>
+#include <game/PooledComponentFactory.h>
+#include <render/Camera.h>
 
 namespace game
 {
@@ -38,7 +39,7 @@ class Component;
 namespace render
 {
 
-class ENGINE_PUBLIC_EXPORT CameraFactory: public game::ComponentFactory
+class ENGINE_PUBLIC_EXPORT CameraFactory: public game::PooledComponentFactory<Camera>
 {
 public:
 
@@ -50,25 +50,25 @@ public:
 	Color(float red, float green, float blue, float alpha);
 	Color(const Color& other);
 
-	inline Color& operator=(const Color& other);
+	Color& operator=(const Color& other);
 
 	// arithmetic operations
-	inline Color operator+(const Color& other) const;
-	inline Color& operator+=(const Color& other);
+	Color operator+(const Color& other) const;
+	Color& operator+=(const Color& other);
 
-	inline Color operator-(const Color& other) const;
-	inline Color& operator-=(const Color& other);
+	Color operator-(const Color& other) const;
+	Color& operator-=(const Color& other);
 
-	inline Color operator*(const Color& other) const;
-	inline Color operator*(const float v) const;
-	inline Color& operator*=(const float v);
+	Color operator*(const Color& other) const;
+	Color operator*(const float v) const;
+	Color& operator*=(const float v);
 
-	inline Color operator/(const Color& other) const;
-	inline Color operator/(const float v) const;
-	inline Color& operator/=(const float v);
+	Color operator/(const Color& other) const;
+	Color operator/(const float v) const;
+	Color& operator/=(const float v);
 
-	inline bool operator==(const Color& other) const;
-	inline bool operator!=(const Color& other) const;
+	bool operator==(const Color& other) const;
+	bool operator!=(const Color& other) const;
 
 	float* get();
 	const float* get() const;
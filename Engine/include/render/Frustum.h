@@ -30,19 +30,19 @@ THE SOFTWARE.
 #include <EngineConfig.h>
 #include <core/Plane3d.h>
 #include <core/Vector3d.h>
+#include <render/CameraDefines.h>
 
 namespace core
 {
 class matrix4;
 class sphere3d;
 class aabox3d;
+struct CullingVolumes;
 }
 
 namespace render
 {
 
-enum ProjectionType;
-
 //! A frustum represents a pyramid, capped at the near and far end which is
 //! used to represent either a visible area or a projection area. Can be used
 //! for a number of applications.
@@ -63,6 +63,9 @@ public:
 
 	const core::vector3d* getCorners();
 
+	//! Returns one of the clipping planes (see FrustumPlane), their normals point inside the frustum.
+	const core::plane3d& getPlane(unsigned int index) const;
+
 	//! Tests whether the given point is visible in the Frustum.
 	bool isVisible(const core::vector3d& point);
 
@@ -72,6 +75,13 @@ public:
 	//! Tests whether the given aabox is visible in the Frustum.
 	bool isVisible(const core::aabox3d& box);
 
+	//! Tests count spheres at once with the selected SIMD kernels, bit i % 32 of visible[i / 32] is set if sphere i is visible.
+	//! \param lastPlanes: Optional per sphere plane that rejected it last time (see core::MathKernels::cullSpheres).
+	void cullSpheres(const core::CullingVolumes& spheres, unsigned int count, unsigned int* visible, unsigned char* lastPlanes = nullptr) const;
+
+	//! Tests count aaboxes given by center and half size at once, see cullSpheres.
+	void cullBoxes(const core::CullingVolumes& boxes, unsigned int count, unsigned int* visible, unsigned char* lastPlanes = nullptr) const;
+
 protected:
 
 	core::plane3d mPlanes[6];
@@ -0,0 +1,244 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _LIGHT_CULLER_H_
+#define _LIGHT_CULLER_H_
+
+#include <EngineConfig.h>
+#include <core/Vector3d.h>
+#include <core/Vector4d.h>
+#include <core/Matrix4.h>
+
+#include <vector>
+
+namespace render
+{
+
+class Camera;
+class Light;
+
+//! Float4 values of every light in the light data.
+static const unsigned int LIGHT_CULLER_LIGHT_TEXELS = 4;
+
+//! Counters and timings of the light assignment of one frame, the times are in milliseconds.
+struct LightCullerStats
+{
+	unsigned int lightCount;
+
+	//! Lights whose range overlaps the cluster grid.
+	unsigned int visibleLightCount;
+
+	//! Entries of all the per cluster light lists.
+	unsigned int indexCount;
+
+	//! Longest list of a cluster.
+	unsigned int maxClusterLightCount;
+
+	//! Time spent rebuilding the cluster bounds after the projection changed.
+	float boundsTime;
+
+	//! Time spent binning the lights and compacting the lists.
+	float assignTime;
+};
+
+//! Clustered light culling.
+//!
+//! The view frustum is split in a grid of clusters: the x and y tiles are regular in normalized device
+//! coordinates and the z slices grow exponentially with the view depth. Every frame the lights are
+//! assigned to the clusters their range reaches, spotlights are also tested against their cone, and the
+//! result is kept as compact lists a fragment shader can walk:
+//! - the cluster grid holds the offset and count of every cluster in the light index list,
+//! - the light index list holds the indices of the lights of every cluster, ascending,
+//! - the light data holds LIGHT_CULLER_LIGHT_TEXELS float4 per light, see getLightData.
+//! A shader finds its cluster from the normalized device coordinates and the view depth of the fragment,
+//! see getGridParameters and getDepthParameters.
+class ENGINE_PUBLIC_EXPORT LightCuller
+{
+public:
+
+	LightCuller();
+	~LightCuller();
+
+	void setEnabled(bool enabled);
+	bool isEnabled() const;
+
+	//! Sets the number of clusters along the screen width, the screen height and the view depth.
+	void setGridSize(unsigned int countX, unsigned int countY, unsigned int countZ);
+
+	unsigned int getGridSizeX() const;
+	unsigned int getGridSizeY() const;
+	unsigned int getGridSizeZ() const;
+
+	//! Sets the farthest view depth the clusters reach when the camera has no far clip distance
+	//! or a farther one, the lights beyond it are not assigned.
+	void setMaxDistance(float distance);
+	float getMaxDistance() const;
+
+	//! Assigns the visible lights to the clusters of the camera frustum.
+	//! The binning runs in parallel when the job system has workers.
+	void assignLights(Camera* camera, const std::vector<Light*>& lights);
+
+	//! Clears the light lists.
+	void clear();
+
+	unsigned int getClusterCount() const;
+
+	//! Gets the index of a cluster in the grid, x varies fastest.
+	unsigned int getClusterIndex(unsigned int x, unsigned int y, unsigned int z) const;
+
+	//! Gets the cluster containing a view space position, -1 if it is outside the clusters.
+	int findCluster(const core::vector3d& viewPosition) const;
+
+	//! Gets the lights of a cluster.
+	//! \param count: Receives the number of lights.
+	//! \return: Indices into the light data, nullptr if the cluster has no lights.
+	const unsigned int* getClusterLights(unsigned int cluster, unsigned int& count) const;
+
+	//! Gets the grid, two values per cluster: the offset of its lights in the light index list and their count.
+	const std::vector<unsigned int>& getClusterGrid() const;
+
+	const std::vector<unsigned int>& getLightIndices() const;
+
+	//! Gets the light data, LIGHT_CULLER_LIGHT_TEXELS float4 per light in world space:
+	//! - position, range (0 for directional lights, they reach every cluster),
+	//! - diffuse color multiplied by the power scale, cosine of the inner cone half angle,
+	//! - direction, cosine of the outer cone half angle (-1 for lights without a cone),
+	//! - constant, linear and quadratic attenuation, spotlight falloff.
+	const std::vector<float>& getLightData() const;
+
+	//! Gets the light a light data entry was built from, valid until the next assignment.
+	Light* getLight(unsigned int index) const;
+
+	unsigned int getLightCount() const;
+
+	//! Gets the grid size and the light count: Vector4(x, y, z, lights).
+	core::vector4d getGridParameters() const;
+
+	//! Gets the values that turn a view depth into a slice: Vector4(near, far, scale, bias),
+	//! slice = floor(log(depth) * scale + bias).
+	core::vector4d getDepthParameters() const;
+
+	//! Gets a number that changes every time the lists are rebuilt, render drivers upload them once per version.
+	unsigned int getVersion() const;
+
+	const LightCullerStats& getStats() const;
+
+protected:
+
+	//! A light in view space with the clusters its bounding sphere overlaps, the maximums are inclusive.
+	struct CulledLight
+	{
+		core::vector3d position;
+		core::vector3d direction;
+		float range;
+		float cosOuter;
+		float sinOuter;
+		bool directional;
+		bool cone;
+
+		unsigned int minX;
+		unsigned int maxX;
+		unsigned int minY;
+		unsigned int maxY;
+		unsigned int minZ;
+		unsigned int maxZ;
+	};
+
+	//! The view space bounds of a cluster, with its bounding sphere for the cone tests.
+	struct ClusterBounds
+	{
+		core::vector3d minimum;
+		core::vector3d maximum;
+		core::vector3d center;
+		float radius;
+	};
+
+	//! The lists of the clusters of one depth slice, before they are joined.
+	struct SliceLists
+	{
+		//! Lights whose slice range contains the slice.
+		std::vector<unsigned int> lights;
+
+		std::vector<unsigned int> counts;
+		std::vector<unsigned int> offsets;
+		std::vector<unsigned int> indices;
+
+		//! Scratch storage of the (cluster, light) pairs.
+		std::vector<unsigned int> pairs;
+	};
+
+	//! Rebuilds the cluster bounds if the projection or the depth range changed.
+	void updateBounds(const core::matrix4& projection, float nearDistance, float farDistance);
+
+	//! Finds the slice of a view depth, clamped to the grid.
+	unsigned int getSlice(float depth) const;
+
+	void cullLight(unsigned int index);
+	static void cullLights(unsigned int begin, unsigned int end, void* data);
+
+	void binSlice(unsigned int slice);
+	static void binSlices(unsigned int begin, unsigned int end, void* data);
+
+	bool isLightInCluster(const CulledLight& light, const ClusterBounds& bounds) const;
+
+	bool mEnabled;
+
+	unsigned int mGridSizeX;
+	unsigned int mGridSizeY;
+	unsigned int mGridSizeZ;
+
+	float mMaxDistance;
+
+	float mNearDistance;
+	float mFarDistance;
+	float mDepthScale;
+	float mDepthBias;
+
+	core::matrix4 mProjection;
+	core::matrix4 mView;
+
+	//! Set when the bounds do not match the grid and projection anymore.
+	bool mBoundsDirty;
+
+	std::vector<ClusterBounds> mBounds;
+
+	std::vector<Light*> mLights;
+	std::vector<CulledLight> mCulledLights;
+
+	std::vector<SliceLists> mSlices;
+
+	std::vector<unsigned int> mClusterGrid;
+	std::vector<unsigned int> mLightIndices;
+	std::vector<float> mLightData;
+
+	unsigned int mVersion;
+
+	LightCullerStats mStats;
+};
+
+} // end namespace render
+
+#endif
\ No newline at end of file
@@ -28,7 +28,8 @@ THE SOFTWARE.
 #define _LIGHT_FACTORY_H_
 
 #include <EngineConfig.h>
-#include <game/ComponentFactory.h>
+#include <game/PooledComponentFactory.h>
+#include <render/Light.h>
 
 namespace game
 {
@@ -38,7 +39,7 @@ class Component;
 namespace render
 {
 
-class ENGINE_PUBLIC_EXPORT LightFactory: public game::ComponentFactory
+class ENGINE_PUBLIC_EXPORT LightFactory: public game::PooledComponentFactory<Light>
 {
 public:
 
@@ -0,0 +1,141 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _LOD_SELECTOR_H_
+#define _LOD_SELECTOR_H_
+
+#include <EngineConfig.h>
+#include <render/MeshData.h>
+
+#include <vector>
+
+namespace render
+{
+
+class Camera;
+class Model;
+
+//! Counters of the detail level selection of one frame, all the views included.
+struct LodStats
+{
+	unsigned int testedCount;
+
+	//! Models dropped for being smaller on screen than the small object threshold.
+	unsigned int smallCulledCount;
+
+	//! Models that changed their detail level.
+	unsigned int switchCount;
+
+	//! Models drawn with every detail level.
+	unsigned int levelCounts[MESH_LOD_MAX_LEVELS];
+
+	//! Triangles of the selected detail levels of the models kept.
+	unsigned int triangleCount;
+
+	//! Triangles the models kept would have with their full meshes.
+	unsigned int fullTriangleCount;
+};
+
+//! Selects the detail level every visible model is drawn with from its size on screen.
+//!
+//! The error of a level, see MeshData::getLodError, is projected at the view depth of the model's bounding sphere
+//! and the coarsest level whose error stays under the pixel threshold is taken. To keep models near a switching
+//! distance from popping back and forth a model only goes coarser once the error is below the threshold reduced
+//! by the hysteresis and only goes finer once the error of its current level is above the threshold increased by it.
+//! Models whose bounding sphere covers fewer pixels than the small object threshold are not drawn at all.
+//! The level a model had is kept per camera, so views of a model at different distances don't make it switch every frame.
+class ENGINE_PUBLIC_EXPORT LodSelector
+{
+public:
+
+	LodSelector();
+	~LodSelector();
+
+	//! Sets if the coarser levels are used, the small objects are culled either way.
+	void setEnabled(bool enabled);
+	bool isEnabled() const;
+
+	//! Sets the largest error a level may show on screen, in pixels.
+	void setErrorThreshold(float pixels);
+	float getErrorThreshold() const;
+
+	//! Sets the fraction of the error threshold the levels switch around.
+	void setHysteresis(float hysteresis);
+	float getHysteresis() const;
+
+	//! Sets the bounding sphere diameter, in pixels, below which the models are culled, 0 to keep them all.
+	void setSmallObjectThreshold(float pixels);
+	float getSmallObjectThreshold() const;
+
+	//! Sets up the projection of the camera a view is rendered with and the levels the models had in its last view.
+	void beginView(Camera* camera, unsigned int viewportHeight);
+
+	//! Drops the levels kept for the views of a camera.
+	void removeView(Camera* camera);
+	void removeAllViews();
+
+	//! Selects the detail level of a visible model in the current view, see Model::setLod.
+	//! \param distance: View depth of the center of the model's bounding sphere.
+	//! \return False if the model is too small on screen to be drawn.
+	bool selectLod(Model* model, float distance);
+
+	//! Clears the stats, once per frame.
+	void resetStats();
+
+	const LodStats& getStats() const;
+
+protected:
+
+	bool mEnabled;
+
+	float mErrorThreshold;
+	float mHysteresis;
+	float mSmallObjectThreshold;
+
+	//! Pixels per world unit at a view depth of 1 for perspective views, at any depth for orthographic ones.
+	float mPixelScale;
+	bool mPerspective;
+	float mNearDistance;
+
+	LodStats mStats;
+
+	//! Levels of the models by id in the views of a camera.
+	struct LodView
+	{
+		Camera* camera;
+
+		//! Levels selected in the current view and in the last one.
+		hashmap<unsigned int, unsigned int> lods;
+		hashmap<unsigned int, unsigned int> lastLods;
+	};
+
+	std::vector<LodView*> mViews;
+	LodView* mCurrentView;
+};
+
+} // end namespace render
+
+#endif
\ No newline at end of file
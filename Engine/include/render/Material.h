@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include <resource/Resource.h>
 #include <resource/ResourceEventReceiver.h>
 #include <render/ShaderParameterDefines.h>
+#include <render/ShaderParameter.h>
 #include <render/RenderStateData.h>
 #include <render/TextureDefines.h>
 #include <render/VertexBufferDefines.h>
@@ -100,10 +101,39 @@ public:
 	void setGeometryShader(Shader* shader);
 	Shader* getGeometryShader();
 
+	//! Sets if the material is blended over the scene, transparent materials are rendered back to front after the opaque ones.
+	void setTransparent(bool transparent);
+	bool isTransparent() const;
+
+	//! Returns true if the material reads the world matrices from an instance_world_matrix attribute,
+	//! the models sharing it and their mesh data are then rendered with one instanced draw.
+	bool isInstanced() const;
+
 	std::vector<ShaderVertexParameter*>& getVertexParameters();
 	std::vector<ShaderTextureParameter*>& getTextureParameters();
 	std::list<ShaderAutoParameter*>& getAutoParameters();
 
+	//! Returns the auto parameters compiled to a flat list ordered by frequency, it is compiled again after the parameters changed.
+	const std::vector<ShaderParameterInstruction>& getParameterProgram();
+	//! Gets the range of the parameter program instructions of a frequency.
+	void getParameterProgramRange(ShaderParameterFrequency frequency, unsigned int& first, unsigned int& last);
+
+	//! Version of the render state data values the parameters of a frequency were last set from.
+	//! The drivers skip the instructions of a frequency while the version did not change, the program keeps its values.
+	unsigned int getParameterVersion(ShaderParameterFrequency frequency) const;
+	void setParameterVersion(ShaderParameterFrequency frequency, unsigned int version);
+
+	//! Size in bytes of the std140 uniform block of a frequency, its members are the block parameters in program order.
+	unsigned int getParameterBlockSize(ShaderParameterFrequency frequency);
+
+	//! Set by the driver when the program reads its auto parameters from uniform blocks instead of single uniforms.
+	void setParameterBlocks(bool parameterBlocks);
+	bool hasParameterBlocks() const;
+
+	//! Offset in the uniform ring buffer of the block last written for a frequency.
+	unsigned int getParameterBlockOffset(ShaderParameterFrequency frequency) const;
+	void setParameterBlockOffset(ShaderParameterFrequency frequency, unsigned int offset);
+
 	void addVertexParameter(const std::string& name, VertexBufferType type);
 	void addTextureParameter(const std::string& name, ShaderParameterType type);
 	void addAutoParameter(const std::string& name, ShaderAutoParameterType type);
@@ -132,6 +162,9 @@ protected:
 	Shader* mFragmentShader;
 	Shader* mGeometryShader;
 
+	bool mTransparent;
+	bool mInstanced;
+
 	ShaderParameter* createParameter(const std::string& name, ShaderParameterType type);
 
 	virtual ShaderVertexParameter* createVertexParameterImpl();
@@ -143,6 +176,13 @@ protected:
 
 	void removeAllParameters();
 
+	//! Has to be called when the parameter locations change, the program is compiled again and all its values set.
+	void invalidateParameterProgram();
+	void compileParameterProgram();
+
+	//! Location the driver sets the parameter at.
+	virtual unsigned int getParameterLocationImpl(ShaderParameter* parameter);
+
 	virtual void setParameterImpl(ShaderParameter* parameter, const Color& col);
 	virtual void setParameterImpl(ShaderParameter* parameter, const core::vector2d& vec);
 	virtual void setParameterImpl(ShaderParameter* parameter, const core::vector3d& vec);
@@ -151,11 +191,21 @@ protected:
 
 	static ShaderParameterType getType(ShaderAutoParameterType type);
 	static ShaderParameterType getType(TextureType type);
+	static ShaderParameterFrequency getFrequency(ShaderAutoParameterType type);
 
 	hashmap<std::string, ShaderParameter*> mParameters;
 	std::vector<ShaderVertexParameter*> mVertexParameters;
 	std::vector<ShaderTextureParameter*> mTextureParameters;
 	std::list<ShaderAutoParameter*> mAutoParameters;
+
+	std::vector<ShaderParameterInstruction> mParameterProgram;
+	unsigned int mParameterProgramOffsets[SHADER_PARAMETER_FREQUENCY_COUNT + 1];
+	unsigned int mParameterVersions[SHADER_PARAMETER_FREQUENCY_COUNT];
+	bool mParameterProgramDirty;
+
+	unsigned int mParameterBlockSizes[SHADER_PARAMETER_FREQUENCY_COUNT];
+	unsigned int mParameterBlockOffsets[SHADER_PARAMETER_FREQUENCY_COUNT];
+	bool mParameterBlocks;
 };
 
 } //namespace render
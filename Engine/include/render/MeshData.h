@@ -29,18 +29,20 @@ THE SOFTWARE.
 
 #include <EngineConfig.h>
 #include <core/Aabox3d.h>
+#include <core/Vector4d.h>
 #include <resource/Resource.h>
 #include <render/Color.h>
 #include <render/RenderDefines.h>
 #include <render/VertexBufferDefines.h>
+#include <resource/Buffer.h>
 
 #include <string>
 #include <map>
+#include <vector>
 
 namespace resource
 {
 class Serializer;
-enum BufferUsage;
 }
 
 namespace render
@@ -51,6 +53,9 @@ class Material;
 class VertexBuffer;
 class IndexBuffer;
 
+//! Most detail levels of a mesh, the full mesh included.
+const unsigned int MESH_LOD_MAX_LEVELS = 5;
+
 //! Defines a mesh resource.
 class ENGINE_PUBLIC_EXPORT MeshData: public resource::Resource
 {
@@ -74,6 +79,23 @@ public:
 	//! Sets new index buffer for this Mesh.
 	void setIndexBuffer(IndexBuffer* buffer);
 
+	//! Adds a coarser level of detail, the next one in the chain, drawn with the vertex buffers of the mesh.
+	//! \param buffer: Indices of the simplified triangles, see MeshSimplifier.
+	//! \param error: Largest distance, in mesh units, of the simplified surface to the full mesh.
+	void addLod(IndexBuffer* buffer, float error);
+
+	//! Gets the number of detail levels, the full mesh included.
+	unsigned int getLodCount() const;
+
+	//! Gets the index buffer of a detail level, 0 is the full mesh and the levels past the last one get the last one.
+	IndexBuffer* getIndexBuffer(unsigned int lod);
+
+	//! Gets the error of a detail level in mesh units, 0 for the full mesh.
+	float getLodError(unsigned int lod) const;
+
+	//! Removes the coarser levels of detail, their buffers are owned by the RenderManager.
+	void removeLods();
+
 	//! Sets the name of the material which this mesh will use.
 	void setMaterial(const std::string& filename);
 
@@ -92,6 +114,16 @@ public:
 	//! Gets the radius of the bounding sphere surrounding this mesh.
 	float getBoundingSphereRadius();
 
+	//! Keeps a CPU copy of the geometry for the occlusion culling.
+	//! \param positions: First position, stride bytes apart, of 3 floats each.
+	void setOccluderGeometry(const float* positions, unsigned int numVertices, unsigned int stride, const unsigned int* indices, unsigned int numIndexes);
+
+	//! Gets the occluder positions, empty if the mesh is no occluder.
+	const std::vector<core::vector4d>& getOccluderPositions() const;
+
+	//! Gets the occluder triangle list indices.
+	const std::vector<unsigned int>& getOccluderIndices() const;
+
 private:
 
 	void unloadImpl();
@@ -108,11 +140,19 @@ private:
 	//! Face index buffer.
 	IndexBuffer* mIndexBuffer;
 
+	//! Index buffers and errors of the coarser levels of detail, from the finest one.
+	std::vector<IndexBuffer*> mLodIndexBuffers;
+	std::vector<float> mLodErrors;
+
 	//! Local bounding box volume.
 	core::aabox3d mAABB;
 
 	//! Local bounding sphere radius (centered on object).
 	float mBoundRadius;
+
+	//! Occluder geometry with w = 1.
+	std::vector<core::vector4d> mOccluderPositions;
+	std::vector<unsigned int> mOccluderIndices;
 };
 
 } //namespace render
@@ -0,0 +1,151 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _MESH_OPTIMIZER_H_
+#define _MESH_OPTIMIZER_H_
+
+#include <EngineConfig.h>
+
+#include <vector>
+
+namespace render
+{
+
+//! Size of the FIFO post transform cache the index buffers are measured with.
+const unsigned int MESH_VERTEX_CACHE_SIZE = 16;
+
+//! Largest increase of the cache miss ratio the overdraw ordering may cause.
+const float MESH_OVERDRAW_THRESHOLD = 1.05f;
+
+//! Efficiency of a triangle list on a simulated post transform cache.
+struct VertexCacheStats
+{
+	unsigned int vertexCount;
+	unsigned int triangleCount;
+
+	//! Vertices the cache missed, each of them is transformed.
+	unsigned int transformCount;
+
+	//! Average cache miss ratio: transformed vertices per triangle, 3 at worst and about 0.5 for large regular meshes.
+	float acmr;
+
+	//! Average transform to vertex ratio: transformed vertices per vertex, 1 at best.
+	float atvr;
+};
+
+//! Counters of the last mesh optimization.
+struct MeshOptimizerStats
+{
+	unsigned int vertexCount;
+
+	//! Vertices left after the duplicates were merged.
+	unsigned int weldedVertexCount;
+
+	//! Vertices left after the unused ones were dropped.
+	unsigned int finalVertexCount;
+
+	//! Clusters the overdraw ordering moved, 0 if it was not applied.
+	unsigned int clusterCount;
+
+	VertexCacheStats before;
+	VertexCacheStats after;
+};
+
+//! Reorders the vertices and triangles of meshes so the GPU transforms, shades and fetches them less.
+//!
+//! The pipeline run by optimize:
+//! - the vertices whose streams are all equal are merged,
+//! - the triangles are reordered for the post transform cache with Forsyth's linear speed algorithm,
+//! - the clusters the cache order starts from cold are sorted to draw the outward facing ones first,
+//!   so more pixels are hidden by the depth test, as long as the cache miss ratio stays under MESH_OVERDRAW_THRESHOLD,
+//! - the vertices are reordered in the order the triangles first use them, for the pre transform fetches,
+//!   and the unused ones are dropped.
+//! The streams are separate arrays of floats, like the vertex buffers, and are reordered together.
+class ENGINE_PUBLIC_EXPORT MeshOptimizer
+{
+public:
+
+	MeshOptimizer();
+	~MeshOptimizer();
+
+	//! Adds a vertex stream to merge and reorder, numComponents floats per vertex.
+	//! The first stream has to hold the positions, the overdraw ordering reads them.
+	void addStream(std::vector<float>& values, unsigned int numComponents);
+
+	void clearStreams();
+
+	//! Runs the whole pipeline on a triangle list.
+	//! \return The number of vertices left, the streams are resized to it.
+	unsigned int optimize(std::vector<unsigned int>& indices, unsigned int numVertices);
+
+	const MeshOptimizerStats& getStats() const;
+
+	//! Merges the vertices whose streams are all equal and points the indices to the kept ones.
+	//! \return The number of vertices left.
+	unsigned int weldVertices(std::vector<unsigned int>& indices, unsigned int numVertices);
+
+	//! Reorders the triangles for the post transform cache.
+	static void optimizeVertexCache(unsigned int* indices, unsigned int numIndexes, unsigned int numVertices);
+
+	//! Sorts the clusters of a cache optimized triangle list from the outward facing ones to the inward facing ones.
+	//! \param positions: First position, stride bytes apart, of 3 floats each.
+	//! \param threshold: Largest ratio of the cache miss ratios after and before, the order is kept above it.
+	//! \return The number of clusters, 0 if the order was kept.
+	static unsigned int optimizeOverdraw(unsigned int* indices, unsigned int numIndexes, const float* positions, unsigned int stride, unsigned int numVertices, float threshold);
+
+	//! Builds the remap of the vertices to the order the triangles first use them in and rewrites the indices with it.
+	//! \param remap: New index of every vertex, -1 for the unused ones.
+	//! \return The number of used vertices.
+	static unsigned int optimizeVertexFetch(unsigned int* indices, unsigned int numIndexes, unsigned int numVertices, std::vector<unsigned int>& remap);
+
+	//! Moves the vertices of a stream to their remapped place, the stream is resized to vertexCount.
+	static void remapStream(std::vector<float>& values, unsigned int numComponents, const std::vector<unsigned int>& remap, unsigned int vertexCount);
+
+	//! Runs a triangle list through a simulated FIFO post transform cache.
+	static VertexCacheStats analyzeVertexCache(const unsigned int* indices, unsigned int numIndexes, unsigned int numVertices, unsigned int cacheSize = MESH_VERTEX_CACHE_SIZE);
+
+protected:
+
+	struct Stream
+	{
+		std::vector<float>* values;
+		unsigned int numComponents;
+	};
+
+	//! Returns true if the streams of two vertices are ordered.
+	bool isVertexLess(unsigned int a, unsigned int b) const;
+
+	//! Returns true if the streams of two vertices are equal.
+	bool isVertexEqual(unsigned int a, unsigned int b) const;
+
+	std::vector<Stream> mStreams;
+
+	MeshOptimizerStats mStats;
+};
+
+} // end namespace render
+
+#endif
\ No newline at end of file
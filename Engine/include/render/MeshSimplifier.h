@@ -0,0 +1,164 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _MESH_SIMPLIFIER_H_
+#define _MESH_SIMPLIFIER_H_
+
+#include <EngineConfig.h>
+
+#include <vector>
+
+namespace render
+{
+
+//! Lowest number of triangles a detail level is built with, smaller meshes are not simplified.
+const unsigned int MESH_LOD_MIN_TRIANGLES = 32;
+
+//! Simplifies triangle lists by collapsing their edges, ordered by quadric error metrics.
+//!
+//! The vertices of the simplified meshes are a subset of the original ones so the levels of detail
+//! share the vertex buffers of the mesh and only need an index buffer each.
+//! Every vertex sums the area weighted planes of its triangles, the edges of open borders add planes
+//! perpendicular to them so the outline is kept. Vertices sharing a position with different attributes
+//! (seams of the texture coordinates or hard normals) and vertices of non manifold edges are never moved,
+//! border vertices only slide along their border. The differences of the attributes added with addAttribute
+//! are added to the error of a collapse so the attributes are preserved too.
+class ENGINE_PUBLIC_EXPORT MeshSimplifier
+{
+public:
+
+	MeshSimplifier();
+	~MeshSimplifier();
+
+	//! Sets the vertices to simplify, the attributes added before are removed.
+	//! \param positions: First position, stride bytes apart, of 3 floats each. Has to live as long as the simplifier uses it.
+	void setVertices(const float* positions, unsigned int numVertices, unsigned int stride);
+
+	//! Adds an attribute of the vertices to preserve, like the normals or the texture coordinates.
+	//! \param values: First value, stride bytes apart, of numComponents floats each.
+	//! \param weight: Scale of the squared attribute differences against the squared position errors,
+	//! the positions being scaled to fit a unit box.
+	void addAttribute(const float* values, unsigned int numComponents, unsigned int stride, float weight);
+
+	//! Collapses edges of a triangle list until it has at most targetIndexCount indices
+	//! or the next collapse would cost more than maxError.
+	//! \param maxError: Largest error allowed, relative to the size of the mesh.
+	//! \param result: Indices of the simplified triangles.
+	//! \return The error of the simplified mesh relative to the size of the mesh, see getScale.
+	float simplify(const unsigned int* indices, unsigned int numIndexes, unsigned int targetIndexCount, float maxError, std::vector<unsigned int>& result);
+
+	//! Simplifies a triangle list into a chain of detail levels, each one with about half the triangles of the one before.
+	//! The chain stops at maxLevels, at MESH_LOD_MIN_TRIANGLES or when a level can not be reduced by a quarter anymore.
+	//! \param levels: Indices of the levels, the full mesh not included.
+	//! \param errors: Error of every level in mesh units.
+	//! \return The number of levels built.
+	unsigned int buildLodChain(const unsigned int* indices, unsigned int numIndexes, unsigned int maxLevels, std::vector<std::vector<unsigned int> >& levels, std::vector<float>& errors);
+
+	//! Gets the size of the mesh, the largest extent of its bounding box, the relative errors are scaled by.
+	float getScale() const;
+
+protected:
+
+	//! Symmetric 4x4 matrix of the sum of squared distances to planes, with the sum of the plane weights.
+	struct Quadric
+	{
+		double a00, a01, a02, a11, a12, a22;
+		double b0, b1, b2;
+		double c;
+		double weight;
+	};
+
+	struct Attribute
+	{
+		const unsigned char* values;
+		unsigned int numComponents;
+		unsigned int stride;
+		float weight;
+	};
+
+	struct Collapse
+	{
+		unsigned int vertex;
+		unsigned int target;
+		float error;
+
+		bool operator<(const Collapse& other) const
+		{
+			return error < other.error;
+		}
+	};
+
+	enum VertexKind
+	{
+		VERTEX_KIND_MANIFOLD,
+		VERTEX_KIND_BORDER,
+		VERTEX_KIND_LOCKED
+	};
+
+	static void addPlane(Quadric& q, double a, double b, double c, double d, double weight);
+	static void addQuadric(Quadric& q, const Quadric& other);
+	static double getQuadricError(const Quadric& q, const float* p);
+
+	const float* getPosition(unsigned int vertex) const;
+
+	float getAttributeError(unsigned int vertex, unsigned int target) const;
+
+	//! Classifies the vertices and builds their quadrics for the indices.
+	//! \return False if there are no vertices or an index is out of their range.
+	bool prepare(const unsigned int* indices, unsigned int numIndexes);
+
+	//! Collapses edges in passes until the indices are down to targetIndexCount or no collapse is cheap enough.
+	//! \return The largest squared error of the collapses done.
+	double collapseEdges(std::vector<unsigned int>& indices, unsigned int targetIndexCount, double maxErrorSquared);
+
+	//! Returns true if moving the vertex to the target flips none of the triangles around the vertex.
+	bool checkFlip(unsigned int vertex, unsigned int target, const std::vector<unsigned int>& indices) const;
+
+	//! Vertex positions moved and scaled into a unit box, 3 floats each.
+	std::vector<float> mPositions;
+	unsigned int mNumVertices;
+
+	float mScale;
+
+	std::vector<Attribute> mAttributes;
+
+	std::vector<unsigned char> mVertexKinds;
+	std::vector<Quadric> mQuadrics;
+
+	//! First vertex with the same position as every vertex.
+	std::vector<unsigned int> mPositionRemap;
+
+	//! Directed edges of open borders, between position remapped vertices.
+	std::vector<unsigned long long> mBorderEdges;
+
+	//! Triangles around every vertex, mVertexTriangles from mVertexTriangleOffsets[vertex] to mVertexTriangleOffsets[vertex + 1].
+	std::vector<unsigned int> mVertexTriangleOffsets;
+	std::vector<unsigned int> mVertexTriangles;
+};
+
+} // end namespace render
+
+#endif
\ No newline at end of file
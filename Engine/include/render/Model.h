@@ -34,6 +34,8 @@ THE SOFTWARE.
 #include <render/Color.h>
 #include <game/Component.h>
 #include <resource/ResourceEventReceiver.h>
+#include <render/RenderDefines.h>
+#include <render/VertexBufferDefines.h>
 
 #include <string>
 
@@ -50,8 +52,6 @@ class IndexBuffer;
 class Material;
 class MeshData;
 class MeshProperties;
-enum RenderOperationType;
-enum VertexBufferType;
 
 //! Representation of a model in the render world.
 class ENGINE_PUBLIC_EXPORT Model: public game::Component, public resource::ResourceEventReceiver
@@ -80,6 +80,18 @@ public:
 	bool getVisibleBoundingSphere();
 	void setVisibleBoundingSphere(bool visible);
 
+	//! Sets if the mesh data of this model hides the models behind it, see OcclusionCuller.
+	void setOccluder(bool occluder);
+	bool isOccluder() const;
+
+	//! Sets if the model never moves, the static models are merged by the StaticBatcher.
+	void setStatic(bool isStatic);
+	bool isStatic() const;
+
+	//! Sets the detail level of the mesh data the model is drawn with, see MeshData::addLod and LodSelector.
+	void setLod(unsigned int lod);
+	unsigned int getLod() const;
+
 	const core::matrix4& getWorldMatrix();
 
 	const core::aabox3d& getBoundingBox();
@@ -98,6 +110,7 @@ public:
 protected:
 
 	void updateImpl(float elapsedTime);
+	void commitImpl();
 	void onMessageImpl(unsigned int messageID);
 
 	MeshData* mMeshData;
@@ -107,6 +120,12 @@ protected:
 	bool mVisibleBoundingBox;
 	bool mVisibleBoundingSphere;
 
+	bool mOccluder;
+
+	bool mStatic;
+
+	unsigned int mLod;
+
 	// world matrix
 	core::matrix4 mWorldMatrix;
 
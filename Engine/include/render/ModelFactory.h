@@ -28,7 +28,8 @@ THE SOFTWARE.
 #define _MODEL_FACTORY_H_
 
 #include <EngineConfig.h>
-#include <game/ComponentFactory.h>
+#include <game/PooledComponentFactory.h>
+#include <render/Model.h>
 
 namespace game
 {
@@ -38,7 +39,7 @@ class Component;
 namespace render
 {
 
-class ENGINE_PUBLIC_EXPORT ModelFactory: public game::ComponentFactory
+class ENGINE_PUBLIC_EXPORT ModelFactory: public game::PooledComponentFactory<Model>
 {
 public:
 
@@ -0,0 +1,180 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _OCCLUSION_CULLER_H_
+#define _OCCLUSION_CULLER_H_
+
+#include <EngineConfig.h>
+#include <core/Matrix4.h>
+#include <core/Vector4d.h>
+#include <core/Simd.h>
+
+#include <vector>
+
+namespace core
+{
+class aabox3d;
+}
+
+namespace render
+{
+
+class Model;
+
+//! Counters and timings of the occlusion culling of one frame, the times are in milliseconds.
+struct OcclusionStats
+{
+	unsigned int occluderCount;
+
+	//! Occluder triangles left to rasterize after clipping.
+	unsigned int triangleCount;
+
+	unsigned int testedCount;
+	unsigned int culledCount;
+
+	//! Time spent transforming, binning and rasterizing the occluders and building the depth pyramid.
+	float rasterizeTime;
+
+	//! Time spent testing the models against the depth pyramid.
+	float testTime;
+};
+
+//! Software occlusion culling.
+//!
+//! The occluders are rasterized on the CPU into a small depth buffer split in tiles, the triangles are binned
+//! per tile and every tile is rasterized by its own job with the SIMD kernels. Each tile then reduces its pixels
+//! into a pyramid of nearest and farthest depths which the tests walk from coarse to fine: a box is hidden
+//! when its nearest depth is behind the farthest occluder depth of every texel its screen rectangle covers.
+class ENGINE_PUBLIC_EXPORT OcclusionCuller
+{
+public:
+
+	OcclusionCuller();
+	~OcclusionCuller();
+
+	void setEnabled(bool enabled);
+	bool isEnabled() const;
+
+	//! Sets the size of the depth buffer in pixels, rounded up to whole tiles.
+	void setResolution(unsigned int width, unsigned int height);
+
+	unsigned int getWidth() const;
+	unsigned int getHeight() const;
+
+	//! Starts a frame seen through the view projection matrix, the occluders of the last frame are dropped.
+	void beginFrame(const core::matrix4& viewProjection);
+
+	//! Clips and bins the triangles of an occluder.
+	//! \param world: Matrix the positions are transformed by before the view projection.
+	//! \param positions: Model space positions with w = 1.
+	//! \param indices: Triangle list indices.
+	void addOccluder(const core::matrix4& world, const core::vector4d* positions, unsigned int numVertices, const unsigned int* indices, unsigned int numIndexes);
+
+	//! Rasterizes the binned triangles and builds the depth pyramid, the tiles run in parallel when the job system has workers.
+	void rasterizeOccluders();
+
+	//! Tests a world space box against the depth pyramid, false only if the occluders hide it completely.
+	bool isVisible(const core::aabox3d& box) const;
+
+	//! Removes the models hidden by the occluders, keeping the order of the others.
+	//! The occluders themselves are never removed.
+	void cullModels(std::vector<Model*>& models);
+
+	const OcclusionStats& getStats() const;
+
+	//! Percentage of the tested models the occluders hid this frame.
+	float getCulledPercentage() const;
+
+protected:
+
+	//! One level of the depth pyramid, level 0 is the depth buffer and only uses farthest.
+	struct DepthLevel
+	{
+		unsigned int width;
+		unsigned int height;
+
+		std::vector<float> nearest;
+		std::vector<float> farthest;
+	};
+
+	struct ScreenTriangle
+	{
+		core::DepthTriangle setup;
+
+		//! Covered pixels, the maximums are exclusive.
+		unsigned int minX;
+		unsigned int minY;
+		unsigned int maxX;
+		unsigned int maxY;
+	};
+
+	//! Clips a clip space triangle against the near plane and sets up the parts in front of it.
+	void addClipTriangle(const core::vector4d& a, const core::vector4d& b, const core::vector4d& c);
+
+	//! Sets up and bins a triangle given in pixel coordinates and depth.
+	void addScreenTriangle(const float* a, const float* b, const float* c);
+
+	void projectToScreen(const core::vector4d& clip, float* screen) const;
+
+	static void rasterizeTiles(unsigned int begin, unsigned int end, void* data);
+	void rasterizeTile(unsigned int tile);
+
+	//! Builds the pyramid levels coarser than a tile.
+	void buildUpperLevels();
+
+	static void testModels(unsigned int begin, unsigned int end, void* data);
+
+	//! Tests the pixels [minX, maxX] x [minY, maxY] from a pyramid level down.
+	bool isRectVisible(unsigned int level, unsigned int minX, unsigned int minY, unsigned int maxX, unsigned int maxY, float depth) const;
+
+	bool mEnabled;
+
+	unsigned int mWidth;
+	unsigned int mHeight;
+	unsigned int mTileCountX;
+	unsigned int mTileCountY;
+
+	core::matrix4 mViewProjection;
+
+	std::vector<DepthLevel> mLevels;
+
+	std::vector<ScreenTriangle> mTriangles;
+
+	//! Triangles overlapping every tile.
+	std::vector<std::vector<unsigned int> > mTileBins;
+
+	//! Scratch storage of the clip space positions of an occluder.
+	std::vector<core::vector4d> mClipPositions;
+
+	//! Scratch storage of the test results.
+	std::vector<unsigned char> mModelVisible;
+
+	OcclusionStats mStats;
+};
+
+} // end namespace render
+
+#endif
\ No newline at end of file
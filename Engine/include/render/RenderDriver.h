@@ -35,6 +35,13 @@ THE SOFTWARE.
 #include <render/Material.h>
 #include <render/Color.h>
 #include <render/RenderStateData.h>
+#include <render/RenderStateCache.h>
+#include <render/UniformRingBuffer.h>
+#include <resource/Buffer.h>
+#include <resource/PixelFormat.h>
+#include <render/VertexBufferDefines.h>
+#include <render/IndexBufferDefines.h>
+#include <render/ShaderDefines.h>
 
 #include <vector>
 
@@ -43,12 +50,6 @@ namespace core
 class sphere3d;
 }
 
-namespace resource
-{
-enum BufferUsage;
-enum PixelFormat;
-}
-
 namespace render
 {
 
@@ -67,10 +68,8 @@ class VertexBuffer;
 class IndexBuffer;
 class Texture;
 class RenderStateData;
-enum VertexBufferType;
-enum vertexElementType;
-enum IndexType;
-enum ShaderType;
+class RenderQueue;
+struct RenderCommand;
 
 //! Defines the functionality of a 3D Rendering API
 //!
@@ -111,10 +110,51 @@ public:
 	//! Render the current rendere state to the active viewport.
 	virtual void render(RenderStateData& renderStateData) = 0;
 
+	//! Renders the sorted commands of a render queue to the active viewport.
+	//! The default implementation renders the instanced batches with renderInstances, for the other commands
+	//! it sets their material and model and calls render.
+	virtual void renderCommands(RenderStateData& renderStateData, const RenderQueue& renderQueue);
+
+	//! Renders commands sharing their mesh data and instanced material with one instanced draw.
+	//! The default implementation renders the commands one by one.
+	//! \param instanceData: RENDER_INSTANCE_DATA_SIZE floats of every command.
+	virtual void renderInstances(RenderStateData& renderStateData, const RenderCommand* commands, unsigned int count, const float* instanceData);
+
 	//! Ends rendering of a frame to the current viewport.
 	virtual void endFrame() = 0;
 
 	virtual void setViewport(Viewport *vp) = 0;
+
+	//! Retrieves the shadow copy of the api state used to skip redundant state changes.
+	RenderStateCache& getStateCache();
+
+	//! Retrieves the host copy of the buffer the uniform blocks of the draws are written to.
+	UniformRingBuffer& getUniformBuffer();
+
+protected:
+
+	//! Writes the uniform blocks of the commands whose materials read their auto parameters from blocks
+	//! and uploads them with uploadUniformBuffer, before the first command is rendered.
+	//! A block of a frequency is written only when its values changed since the material last had one written.
+	void packParameterBlocks(RenderStateData& renderStateData, const RenderQueue& renderQueue);
+
+	//! Uploads the ranges of the uniform ring buffer written since the last upload.
+	//! The default implementation only takes the ranges, for the drivers without an api buffer.
+	virtual void uploadUniformBuffer();
+
+	//! Sets the material and the model of a command and the offsets of its uniform blocks.
+	void setCurrentCommand(RenderStateData& renderStateData, const RenderCommand* command);
+
+	RenderStateCache mStateCache;
+
+	UniformRingBuffer mUniformBuffer;
+
+	//! Offsets of the uniform blocks of every frequency of the commands packed by packParameterBlocks.
+	std::vector<unsigned int> mCommandBlockOffsets;
+	const RenderCommand* mPackedCommands;
+
+	//! Offsets of the uniform blocks of the current command, UNIFORM_RING_BUFFER_INVALID_OFFSET if it has none.
+	unsigned int mParameterBlockOffsets[SHADER_PARAMETER_FREQUENCY_COUNT];
 };
 
 } // end namespace render
@@ -30,9 +30,21 @@ THE SOFTWARE.
 #include <EngineConfig.h>
 #include <core/System.h>
 #include <core/Singleton.h>
+#include <core/SlotMap.h>
 #include <render/Color.h>
 #include <render/Material.h>
 #include <render/RenderStateData.h>
+#include <render/RenderQueue.h>
+#include <render/VisibilityTree.h>
+#include <render/OcclusionCuller.h>
+#include <render/LightCuller.h>
+#include <render/StaticBatcher.h>
+#include <render/LodSelector.h>
+#include <resource/Buffer.h>
+#include <resource/PixelFormat.h>
+#include <render/VertexBufferDefines.h>
+#include <render/IndexBufferDefines.h>
+#include <render/ShaderDefines.h>
 
 #include <string>
 #include <list>
@@ -48,8 +60,6 @@ namespace resource
 {
 class Resource;
 class Serializer;
-enum BufferUsage;
-enum PixelFormat;
 }
 
 namespace game
@@ -83,10 +93,6 @@ class VertexDeclaration;
 class VertexBufferBinding;
 class FontFactory;
 class MeshDataFactory;
-enum VertexBufferType;
-enum VertexElementType;
-enum IndexType;
-enum ShaderType;
 
 //! Rendering Manager.
 //! 
@@ -134,17 +140,20 @@ public:
 	//! Removes a light from the rendering.
 	void removeLight(Light *light);
 	//! Removes a light from the rendering.
-	void removeLight(const unsigned int& id);
+	void removeLight(const core::Handle& handle);
 	//! Removes (and destroys) all lights from the rendering.
 	void removeAllLights();
 
+	//! Gets the culler that assigns the lights to the clusters of the camera frustum.
+	LightCuller& getLightCuller();
+
 	//!  Adds a camera to be managed by this scene manager.
 	void addCamera(Camera* camera);
 
 	//!  Removes a camera from the rendering.
 	void removeCamera(Camera* camera);
 	//!  Removes a camera from the rendering.
-	void removeCamera(const unsigned int& id);
+	void removeCamera(const core::Handle& handle);
 	//! Removes all cameras from the rendering
 	void removeAllCameras();
 
@@ -154,10 +163,32 @@ public:
 	//! Removes a mesh from the rendering.
 	void removeModel(Model* model);
 	//! Removes a mesh from the rendering.
-	void removeModel(const unsigned int& id);
+	void removeModel(const core::Handle& handle);
 	//! Removes all models from the rendering
 	void removeAllModels();
 
+	//! Notifies that the world bounds of a model changed.
+	void updateModel(Model* model);
+
+	//! Gets the culler that removes the models hidden behind the occluder models.
+	OcclusionCuller& getOcclusionCuller();
+
+	//! Merges the static models into chunks, see StaticBatcher.
+	//! Call once the scene is loaded and updated, the models merged before are kept.
+	//! \return The number of merged models.
+	unsigned int buildStaticBatches();
+
+	//! Removes the static batches and renders their models on their own again, for editing.
+	void clearStaticBatches();
+
+	StaticBatcher& getStaticBatcher();
+
+	//! Gets the selector of the detail levels the visible models are drawn with.
+	LodSelector& getLodSelector();
+
+	//! Gets the values the auto shader parameters are read from, its stats cover the current frame.
+	RenderStateData& getRenderStateData();
+
 	//!  Adds an updated viewport to be managed by this scene manager.
 	void addUpdatedViewport(Viewport* viewport);
 
@@ -231,16 +262,37 @@ protected:
 	RenderWindow* mMainWindow;
 
 	//! Central list of lights - for easy memory management and lookup.
-	std::map<unsigned int, Light*> mLights;
+	core::SlotMap<Light*> mLights;
+
+	//! Per cluster light lists of the current camera.
+	LightCuller mLightCuller;
 
 	//! Central list of models - for easy memory management and lookup.
-	std::map<unsigned int, Model*> mModels;
+	core::SlotMap<Model*> mModels;
+
+	//! Hierarchy over the world bounds of the models.
+	VisibilityTree mVisibilityTree;
+
+	//! Leaf of every model in the visibility tree, indexed by the slot of its handle.
+	std::vector<unsigned int> mModelLeaves;
+
+	//! Models the visibility tree found in the frustum of the current camera.
+	std::vector<Model*> mVisibleModels;
+
+	//! Removes the visible models the occluders hide.
+	OcclusionCuller mOcclusionCuller;
+
+	//! Chunks of the merged static models.
+	StaticBatcher mStaticBatcher;
+
+	//! Detail levels of the visible models.
+	LodSelector mLodSelector;
 
 	//! Central list of fonts - for easy memory management and lookup.
 	std::map<unsigned int, Font*> mFonts;
 
 	//! Central list of cameras - for easy memory management and lookup.
-	std::map<unsigned int, Camera*> mCameras;
+	core::SlotMap<Camera*> mCameras;
 
 	//! Central list of shaders - for easy memory management and lookup.
 	std::map<unsigned int, Shader*> mShaders;
@@ -248,24 +300,8 @@ protected:
 	std::list<VertexBuffer*> mVertexBuffers;
 	std::list<IndexBuffer*> mIndexBuffers;
 
-	struct ModelMaterialPair
-	{
-		ModelMaterialPair()
-		{
-			model = nullptr;
-			materialID = 0;
-		}
-
-		bool operator < (const ModelMaterialPair& other) const
-		{
-			return (materialID < other.materialID);
-		}
-
-		Model* model;
-		unsigned int materialID;//Renderable material ID
-	};
-	
-	std::vector<ModelMaterialPair> mModelMaterialPairs;
+	//! Draws of the current viewport, sorted by state and depth.
+	RenderQueue mRenderQueue;
 
 	//! Shader auto parameter data.
 	RenderStateData mRenderStateData;
@@ -307,9 +343,9 @@ protected:
 
 	void findVisibleModels(Camera* camera);
 
-	void renderVisibleModels();
+	void cullOccludedModels(Camera* camera);
 
-	void renderSingleModel(Model* model);
+	void renderVisibleModels();
 
 	void endFrame();
 };
@@ -0,0 +1,150 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _RENDER_QUEUE_H_
+#define _RENDER_QUEUE_H_
+
+#include <EngineConfig.h>
+
+#include <vector>
+
+namespace render
+{
+
+class Model;
+class Material;
+
+//! States of the sort key that are remapped to dense indices per view, see RenderQueue::getStateIndex.
+enum RenderQueueState
+{
+	RENDER_QUEUE_STATE_PROGRAM = 0,
+	RENDER_QUEUE_STATE_MATERIAL,
+	RENDER_QUEUE_STATE_MESH,
+	RENDER_QUEUE_STATE_COUNT
+};
+
+//! Floats of instance data per instance, the world matrix in column major order as the shaders read a mat4 attribute.
+const unsigned int RENDER_INSTANCE_DATA_SIZE = 16;
+
+//! A single draw of a model with the material it is rendered with.
+struct ENGINE_PUBLIC_EXPORT RenderCommand
+{
+	RenderCommand();
+
+	//! Packed key the commands are sorted by, see RenderQueue::buildSortKey.
+	unsigned long long sortKey;
+
+	Model* model;
+	Material* material;
+};
+
+//! Consecutive sorted commands rendered with one draw call.
+//!
+//! A batch holds a single command, or a run of commands sharing the mesh data and an instanced
+//! material which is rendered with one instanced draw.
+struct ENGINE_PUBLIC_EXPORT RenderBatch
+{
+	RenderBatch();
+
+	unsigned int firstCommand;
+	unsigned int commandCount;
+
+	//! Offset of the data of the first instance in the instance data, only set for instanced batches.
+	unsigned int instanceDataOffset;
+
+	bool instanced;
+};
+
+//! Collects the draws of a viewport and sorts them by their packed key.
+//!
+//! The key is laid out from the most significant bit as:
+//! layer (4) | transparent (1) | program (11) | material (16) | mesh (16) | depth (16) for opaque draws and
+//! layer (4) | transparent (1) | inverted depth (16) | program (11) | material (16) | mesh (16) for transparent ones,
+//! so opaque draws are grouped by state and go front to back inside a material while
+//! transparent draws come after them, back to front.
+//! The program, material and mesh fields hold the dense indices of getStateIndex rather than the ids,
+//! so different states never share a key as long as a view draws fewer of them than a field holds.
+class ENGINE_PUBLIC_EXPORT RenderQueue
+{
+public:
+
+	RenderQueue();
+	~RenderQueue();
+
+	//! Removes all the commands and the state indices, the memory is kept for the next frame.
+	void clear();
+
+	void reserve(unsigned int count);
+
+	void addCommand(unsigned long long sortKey, Model* model, Material* material);
+
+	//! Sorts the commands by key with a radix sort.
+	void sort();
+
+	//! Groups the sorted commands into batches and packs the world matrices of the instanced ones.
+	void buildBatches();
+
+	const RenderCommand* getCommands() const;
+	unsigned int getCommandCount() const;
+
+	const RenderBatch* getBatches() const;
+	unsigned int getBatchCount() const;
+
+	//! Gets the instance data of the instanced batches, RENDER_INSTANCE_DATA_SIZE floats per command.
+	const float* getInstanceData() const;
+
+	//! Gets the index of a state among the states of its kind added since the last clear, in the order they were first seen.
+	//! \param id: Id of the state, unique among the states of its kind.
+	unsigned int getStateIndex(RenderQueueState state, unsigned long long id);
+
+	//! Packs a sort key.
+	//! \param layer: Layer of the draw, the lower layers are rendered first.
+	//! \param transparent: If the draw is blended over the scene.
+	//! \param program: Index of the shader program, below 2^11.
+	//! \param material: Index of the material, below 2^16.
+	//! \param mesh: Index of the mesh data and its detail level, below 2^16.
+	//! \param depth: Distance to the camera, normalized to [0, 1].
+	static unsigned long long buildSortKey(unsigned int layer, bool transparent, unsigned int program, unsigned int material, unsigned int mesh, float depth);
+
+protected:
+
+	std::vector<RenderCommand> mCommands;
+
+	//! Scratch storage for the radix sort passes.
+	std::vector<RenderCommand> mSortBuffer;
+
+	std::vector<RenderBatch> mBatches;
+	std::vector<float> mInstanceData;
+
+	//! Dense indices of the states by id, the consecutive commands often share a state so the last one is kept apart.
+	hashmap<unsigned long long, unsigned int> mStateIndices[RENDER_QUEUE_STATE_COUNT];
+	unsigned long long mLastStateIds[RENDER_QUEUE_STATE_COUNT];
+	unsigned int mLastStateIndices[RENDER_QUEUE_STATE_COUNT];
+};
+
+} // end namespace render
+
+#endif
\ No newline at end of file
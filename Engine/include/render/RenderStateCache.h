@@ -0,0 +1,155 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _RENDER_STATE_CACHE_H_
+#define _RENDER_STATE_CACHE_H_
+
+#include <EngineConfig.h>
+#include <render/RenderStateCacheDefines.h>
+
+#include <vector>
+
+namespace render
+{
+
+//! Shadow copy of the render api state.
+//!
+//! The drivers ask the cache before changing a state; the set methods return true only when
+//! the new value differs from the one the api already has, so the call has to be issued.
+//! Every request is counted as issued or skipped, the counters are reset at the start of each frame.
+//! The values are plain integers so the cache does not depend on any api.
+class ENGINE_PUBLIC_EXPORT RenderStateCache
+{
+public:
+
+	RenderStateCache();
+	~RenderStateCache();
+
+	//! Forgets all the state, the next request of each value is issued.
+	void reset();
+
+	void resetCounters();
+
+	//! Number of issued state changes of a type since the last counters reset.
+	unsigned int getIssuedCount(RenderStateType type) const;
+	//! Number of skipped state changes of a type since the last counters reset.
+	unsigned int getSkippedCount(RenderStateType type) const;
+
+	unsigned int getIssuedCount() const;
+	unsigned int getSkippedCount() const;
+
+	bool setProgram(unsigned int program);
+	unsigned int getProgram() const;
+	//! Forgets a program and its uniform values, has to be called when the program is linked again or deleted.
+	void removeProgram(unsigned int program);
+
+	bool setActiveTextureUnit(unsigned int unit);
+	bool setTexture(unsigned int unit, unsigned int target, unsigned int texture);
+	//! Forgets the bindings of a deleted texture.
+	void removeTexture(unsigned int texture);
+
+	bool setVertexBuffer(unsigned int buffer);
+	bool setIndexBuffer(unsigned int buffer);
+	//! Forgets the bindings and vertex formats of a deleted buffer.
+	void removeBuffer(unsigned int buffer);
+
+	bool setVertexAttributeEnabled(unsigned int index, bool enabled);
+	bool isVertexAttributeEnabled(unsigned int index) const;
+
+	//! Returns true when the attribute does not already read the buffer with this layout.
+	//! \param offset: Offset of the first element in the buffer, in bytes.
+	//! \param divisor: Instances the attribute advances after, 0 for per vertex data.
+	bool setVertexAttributeFormat(unsigned int index, unsigned int buffer, unsigned int size, unsigned int type, unsigned int stride, unsigned int offset = 0, unsigned int divisor = 0);
+
+	//! Uniform values are kept per program, the value is compared with the last one set in the current program.
+	//! \param location: Location of the uniform in the current program.
+	//! \param data: The new value.
+	//! \param size: Size of the value in bytes.
+	bool setUniform(unsigned int location, const void* data, unsigned int size);
+
+	//! Returns true when the binding point does not already read this range of the buffer.
+	//! \param offset: Offset of the block in the buffer, in bytes.
+	//! \param size: Size of the block in bytes.
+	bool setUniformBlock(unsigned int binding, unsigned int buffer, unsigned int offset, unsigned int size);
+
+	bool setBlendEnabled(bool enabled);
+	bool setDepthWriteEnabled(bool enabled);
+
+protected:
+
+	bool countChange(RenderStateType type, bool changed);
+
+	struct VertexAttributeFormat
+	{
+		unsigned int buffer;
+		unsigned int size;
+		unsigned int type;
+		unsigned int stride;
+		unsigned int offset;
+		unsigned int divisor;
+	};
+
+	struct UniformBlockRange
+	{
+		unsigned int buffer;
+		unsigned int offset;
+		unsigned int size;
+	};
+
+	struct UniformValue
+	{
+		unsigned int offset;
+		unsigned int size;
+	};
+
+	unsigned int mProgram;
+
+	unsigned int mActiveTextureUnit;
+	unsigned int mTextureTargets[RENDER_STATE_MAX_TEXTURE_UNITS];
+	unsigned int mTextures[RENDER_STATE_MAX_TEXTURE_UNITS];
+
+	unsigned int mVertexBuffer;
+	unsigned int mIndexBuffer;
+
+	unsigned int mVertexAttributeEnabled[RENDER_STATE_MAX_VERTEX_ATTRIBUTES];
+	VertexAttributeFormat mVertexAttributeFormats[RENDER_STATE_MAX_VERTEX_ATTRIBUTES];
+
+	UniformBlockRange mUniformBlocks[RENDER_STATE_MAX_UNIFORM_BLOCKS];
+
+	unsigned int mBlendEnabled;
+	unsigned int mDepthWriteEnabled;
+
+	//! Uniform values by program (high 32 bits) and location (low 32 bits).
+	hashmap<unsigned long long, UniformValue> mUniforms;
+	std::vector<unsigned char> mUniformData;
+
+	unsigned int mIssuedCounts[RENDER_STATE_TYPE_COUNT];
+	unsigned int mSkippedCounts[RENDER_STATE_TYPE_COUNT];
+};
+
+} // end namespace render
+
+#endif
\ No newline at end of file
@@ -0,0 +1,61 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _RENDER_STATE_CACHE_DEFINES_H_
+#define _RENDER_STATE_CACHE_DEFINES_H_
+
+namespace render
+{
+
+//! Kinds of state changes tracked by the RenderStateCache.
+enum RenderStateType
+{
+	RENDER_STATE_TYPE_PROGRAM,
+	RENDER_STATE_TYPE_TEXTURE,
+	RENDER_STATE_TYPE_BUFFER,
+	RENDER_STATE_TYPE_VERTEX_ATTRIBUTE,
+	RENDER_STATE_TYPE_UNIFORM,
+	RENDER_STATE_TYPE_UNIFORM_BLOCK,
+	RENDER_STATE_TYPE_BLEND,
+	RENDER_STATE_TYPE_DEPTH_WRITE,
+	RENDER_STATE_TYPE_COUNT
+};
+
+//! Number of texture units tracked by the cache.
+const unsigned int RENDER_STATE_MAX_TEXTURE_UNITS = 16;
+
+//! Number of vertex attributes tracked by the cache.
+const unsigned int RENDER_STATE_MAX_VERTEX_ATTRIBUTES = 16;
+
+//! Number of uniform block binding points tracked by the cache.
+const unsigned int RENDER_STATE_MAX_UNIFORM_BLOCKS = 8;
+
+//! Value of a state the cache knows nothing about.
+const unsigned int RENDER_STATE_UNKNOWN = 0xFFFFFFFF;
+
+}// end namespace render
+
+#endif// _RENDER_STATE_CACHE_DEFINES_H_
\ No newline at end of file
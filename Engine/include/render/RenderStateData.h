@@ -29,11 +29,14 @@ THE SOFTWARE.
 
 #include <EngineConfig.h>
 #include <render/Color.h>
+#include <render/ShaderParameterDefines.h>
 #include <core/Vector2d.h>
 #include <core/Vector3d.h>
 #include <core/Vector4d.h>
 #include <core/Matrix4.h>
 
+#include <list>
+
 namespace render
 {
 
@@ -42,6 +45,15 @@ class Camera;
 class Model;
 class Material;
 class Viewport;
+class LightCuller;
+
+//! Render state data work since the start of the frame.
+struct ENGINE_PUBLIC_EXPORT RenderStateDataStats
+{
+	unsigned int matrixInversionCount;
+	//! Auto parameter values read by the drivers.
+	unsigned int parameterCount;
+};
 
 class ENGINE_PUBLIC_EXPORT RenderStateData
 {
@@ -49,6 +61,22 @@ public:
 
 	RenderStateData();
 
+	//! Starts a new frame, the lights may have moved since the last one.
+	void beginFrame();
+
+	//! Version of the values of a frequency, it changes every time they may have changed.
+	unsigned int getVersion(ShaderParameterFrequency frequency) const;
+
+	//! Changes the versions of a frequency and the ones after it.
+	//! Called when the values set from them were lost, like after the uniform ring buffer storage was reallocated.
+	void invalidate(ShaderParameterFrequency frequency);
+
+	//! Writes the value of an auto parameter, at most 16 floats.
+	//! Returns false if the value has no source, the parameter is left as it is then.
+	bool getParameterValue(ShaderAutoParameterType source, float* values);
+
+	const RenderStateDataStats& getStats() const;
+
 	void setWorldMatrix(const core::matrix4& m);
 	void setCurrentMaterial(Material* material);
 	void setCurrentModel(Model* model);
@@ -56,6 +84,10 @@ public:
 	void setCurrentViewport(Viewport* viewport);
 	void setCurrentLight(Light* light);
 
+	//! Sets the light lists the cluster auto parameters are read from.
+	void setLightCuller(LightCuller* lightCuller);
+	LightCuller* getLightCuller() const;
+
 	Material* getCurrentMaterial() const;
 	Model* getCurrentModel() const;
 
@@ -75,6 +107,7 @@ public:
 	const Color& getCurrentLightDiffuseColour() const;
 	const Color& getCurrentLightSpecularColour() const;
 	core::vector4d getCurrentLightAttenuation() const;
+	float getCurrentLightPowerScale() const;
 
 	const core::matrix4& getWorldMatrix();
 	const core::matrix4& getViewMatrix();
@@ -86,11 +119,11 @@ public:
 
 	const core::matrix4& getInverseWorldMatrix();
 	const core::matrix4& getInverseViewMatrix();
-	core::matrix4 getInverseProjectionMatrix();
+	const core::matrix4& getInverseProjectionMatrix();
 
 	const core::matrix4& getInverseWorldViewMatrix();
-	core::matrix4 getInverseViewProjectionMatrix();
-	core::matrix4 getInverseWorldViewProjMatrix();
+	const core::matrix4& getInverseViewProjectionMatrix();
+	const core::matrix4& getInverseWorldViewProjMatrix();
 
 	core::matrix4 getTransposedWorldMatrix();
 	core::matrix4 getTransposedViewMatrix();
@@ -110,6 +143,8 @@ public:
 
 protected:
 
+	core::matrix4 getInverse(const core::matrix4& m);
+
 	core::matrix4 mWorldMatrix;
 	core::matrix4 mViewMatrix;
 	core::matrix4 mProjectionMatrix;
@@ -120,8 +155,11 @@ protected:
 	
 	core::matrix4 mInverseWorldMatrix;
 	core::matrix4 mInverseViewMatrix;
+	core::matrix4 mInverseProjectionMatrix;
 
 	core::matrix4 mInverseWorldViewMatrix;
+	core::matrix4 mInverseViewProjMatrix;
+	core::matrix4 mInverseWorldViewProjMatrix;
 	
 	core::matrix4 mInverseTransposeWorldMatrix;
 	
@@ -151,8 +189,11 @@ protected:
 
 	bool mInverseWorldMatrixDirty;
 	bool mInverseViewMatrixDirty;
+	bool mInverseProjMatrixDirty;
 	
 	bool mInverseWorldViewMatrixDirty;
+	bool mInverseViewProjMatrixDirty;
+	bool mInverseWorldViewProjMatrixDirty;
 
 	bool mInverseTransposeWorldMatrixDirty;
 	bool mInverseTransposeWorldViewMatrixDirty;
@@ -165,8 +206,13 @@ protected:
 	Camera* mCurrentCamera;
 	Light* mCurrentLight;
 	Viewport* mCurrentViewport;
+	LightCuller* mLightCuller;
 	
 	std::list<Light*> mLights;
+
+	unsigned int mVersions[SHADER_PARAMETER_FREQUENCY_COUNT];
+
+	RenderStateDataStats mStats;
 };
 
 } // end namespace render
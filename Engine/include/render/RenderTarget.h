@@ -57,6 +57,8 @@ public:
 		float bestFPS;
 		float worstFPS;
 		int triangleCount;
+		int modelCount;
+		int drawCallCount;
 	};
 
 	RenderTarget();
@@ -105,6 +107,10 @@ public:
 	virtual float getWorstFPS() const;
 	//! Gets the number of triangles rendered in the last update() call.
 	virtual int getTriangleCount() const;
+	//! Gets the number of models rendered in the last update() call.
+	virtual int getModelCount() const;
+	//! Gets the number of draw calls issued in the last update() call.
+	virtual int getDrawCallCount() const;
 
 	//! Resets saved frame-rate statistices.
 	virtual void resetStatistics();
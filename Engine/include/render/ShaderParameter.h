@@ -68,6 +68,23 @@ struct ENGINE_PUBLIC_EXPORT ShaderAutoParameter
 	ShaderAutoParameterType mAutoParameterType;
 };
 
+//! Step of a compiled auto parameter program, sets one value read from the render state data.
+struct ENGINE_PUBLIC_EXPORT ShaderParameterInstruction
+{
+	ShaderParameterInstruction();
+
+	ShaderParameter* mParameter;
+
+	ShaderAutoParameterType mSource;
+	ShaderParameterType mParameterType;
+
+	//! Location of the parameter in the driver program.
+	unsigned int mLocation;
+
+	//! Offset of the parameter in the std140 uniform block of its frequency, -1 for the types a block does not hold.
+	unsigned int mBlockOffset;
+};
+
 } // end namespace render
 
 #endif
\ No newline at end of file
@@ -46,6 +46,7 @@ enum ShaderParameterType
 	SHADER_PARAMETER_TYPE_SAMPLER1D,
 	SHADER_PARAMETER_TYPE_SAMPLER2D,
 	SHADER_PARAMETER_TYPE_SAMPLER3D,
+	SHADER_PARAMETER_TYPE_SAMPLERBUFFER,
 	SHADER_PARAMETER_TYPE_UNKNOWN
 };
 
@@ -93,9 +94,26 @@ enum ShaderAutoParameterType
 	SHADER_AUTO_PARAMETER_TYPE_CAMERA_POSITION,							//! The current camera's position in world space
 	SHADER_AUTO_PARAMETER_TYPE_CAMERA_POSITION_OBJECT_SPACE,			//! The current camera's position in object space 
 
+	SHADER_AUTO_PARAMETER_TYPE_INSTANCE_WORLD_MATRIX,					//! Per instance world matrix attribute, declaring it makes the material instanced
+
+	SHADER_AUTO_PARAMETER_TYPE_CLUSTER_GRID_SIZE,						//! Light cluster grid size and light count, Vector4(x, y, z, lights)
+	SHADER_AUTO_PARAMETER_TYPE_CLUSTER_DEPTH_PARAMETERS,				//! Light cluster slicing of the view depth, Vector4(near, far, scale, bias)
+	SHADER_AUTO_PARAMETER_TYPE_CLUSTER_LIGHT_GRID,						//! Buffer texture of the light list offset and count of every cluster
+	SHADER_AUTO_PARAMETER_TYPE_CLUSTER_LIGHT_INDICES,					//! Buffer texture of the light indices of the cluster lists
+	SHADER_AUTO_PARAMETER_TYPE_CLUSTER_LIGHT_DATA,						//! Buffer texture of the light data, see LightCuller::getLightData
+
 	SHADER_AUTO_PARAMETER_TYPE_NONE
 };
 
+//! How often the value of an auto parameter changes, a class also changes with the ones before it.
+enum ShaderParameterFrequency
+{
+	SHADER_PARAMETER_FREQUENCY_FRAME,									//! Scene values: the ambient color and the current light
+	SHADER_PARAMETER_FREQUENCY_CAMERA,									//! Values of the current camera and light culler
+	SHADER_PARAMETER_FREQUENCY_OBJECT,									//! Values of the current model
+	SHADER_PARAMETER_FREQUENCY_COUNT
+};
+
 } // end namespace render
 
 #endif
\ No newline at end of file
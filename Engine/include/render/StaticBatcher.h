@@ -0,0 +1,155 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _STATIC_BATCHER_H_
+#define _STATIC_BATCHER_H_
+
+#include <EngineConfig.h>
+#include <core/Handle.h>
+
+#include <string>
+#include <vector>
+#include <map>
+
+namespace game
+{
+class GameObject;
+}
+
+namespace render
+{
+
+class Model;
+class MeshData;
+
+//! Counters of the last static batch build, the sizes are in bytes and the time in milliseconds.
+struct StaticBatchStats
+{
+	//! Static models merged into the chunks, each of them was a draw call before.
+	unsigned int modelCount;
+
+	//! Chunks the models were merged into, one draw call each.
+	unsigned int chunkCount;
+
+	unsigned int vertexCount;
+	unsigned int indexCount;
+
+	//! Size of the vertex and index buffers of the distinct meshes the merged models used.
+	unsigned int sourceBufferSize;
+
+	//! Size of the vertex and index buffers of the chunks.
+	unsigned int chunkBufferSize;
+
+	float buildTime;
+};
+
+//! Part of a chunk that came from one source model.
+struct StaticBatchSource
+{
+	core::Handle gameObject;
+	core::Handle model;
+
+	//! Range of the indices of the source in the chunk.
+	unsigned int firstIndex;
+	unsigned int indexCount;
+};
+
+//! Merges the static models sharing a material into large world space meshes.
+//!
+//! The static models are the ones flagged with Model::setStatic and the ones whose game object has a static body.
+//! They are grouped by material, vertex format and the cell of a grid over their world bounds, each group is
+//! merged into a chunk: a game object with a model whose mesh data holds the transformed geometry, relative to
+//! the center of the chunk so it is culled and sorted like any other model.
+//! The source models are only taken out of the rendering, every chunk remembers the game objects it came from
+//! so an editor can map a chunk, or a triangle of it, back to them and clear the batches to edit the scene.
+class ENGINE_PUBLIC_EXPORT StaticBatcher
+{
+public:
+
+	StaticBatcher();
+	~StaticBatcher();
+
+	//! Sets the size of the grid cells the chunks are split by, in world units.
+	void setChunkSize(float size);
+	float getChunkSize() const;
+
+	//! Returns true if the model can be merged: it never moves, renders triangle lists and its mesh data is loaded.
+	static bool isStaticModel(Model* model);
+
+	//! Merges the static models into chunks, the batches built before are cleared first.
+	//! Has to be called once the meshes are loaded and the models were updated, the world matrices are baked in.
+	//! \param models: Models to merge, the ones that are not static are skipped.
+	//! \return The number of merged models.
+	unsigned int build(const std::vector<Model*>& models);
+
+	//! Removes the chunks and gives the source models that still exist back to the rendering.
+	void clear();
+
+	unsigned int getChunkCount() const;
+
+	//! Gets the game object rendering a chunk.
+	game::GameObject* getChunkGameObject(unsigned int chunk) const;
+
+	//! Gets the sources of a chunk in the order their indices were written.
+	const std::vector<StaticBatchSource>& getChunkSources(unsigned int chunk) const;
+
+	//! Finds the chunk a source game object was merged into.
+	//! \return The index of the chunk or -1 if the game object was not merged.
+	int findChunk(game::GameObject* gameObject) const;
+
+	//! Finds the source game object a triangle of a chunk came from, for picking.
+	game::GameObject* findSourceGameObject(unsigned int chunk, unsigned int triangle) const;
+
+	const StaticBatchStats& getStats() const;
+
+protected:
+
+	struct Chunk
+	{
+		core::Handle gameObject;
+
+		//! Owned by the batcher, the mesh data is not a file resource.
+		MeshData* meshData;
+
+		std::vector<StaticBatchSource> sources;
+	};
+
+	//! Merges the geometry of the models into a new chunk.
+	bool buildChunk(const std::vector<Model*>& models, unsigned int index);
+
+	float mChunkSize;
+
+	std::vector<Chunk> mChunks;
+
+	//! Chunk of every merged game object.
+	std::map<core::Handle, unsigned int> mSourceChunks;
+
+	StaticBatchStats mStats;
+};
+
+} // end namespace render
+
+#endif
\ No newline at end of file
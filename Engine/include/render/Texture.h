@@ -30,13 +30,13 @@ THE SOFTWARE.
 #include <EngineConfig.h>
 #include <render/TextureDefines.h>
 #include <resource/Resource.h>
+#include <resource/PixelFormat.h>
 
 #include <string>
 
 namespace resource
 {
 class Serializer;
-enum PixelFormat;
 }
 
 namespace render
@@ -0,0 +1,139 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _UNIFORM_RING_BUFFER_H_
+#define _UNIFORM_RING_BUFFER_H_
+
+#include <EngineConfig.h>
+#include <render/ShaderParameterDefines.h>
+
+#include <vector>
+
+namespace render
+{
+
+class Material;
+class RenderStateData;
+
+//! Offset returned when the ring has no room for an allocation.
+static const unsigned int UNIFORM_RING_BUFFER_INVALID_OFFSET = 0xFFFFFFFF;
+
+//! Counters of the uniform ring buffer since the start of the frame, the sizes are in bytes.
+struct UniformRingBufferStats
+{
+	//! Blocks allocated in the ring.
+	unsigned int allocationCount;
+	unsigned int allocatedSize;
+
+	//! Ranges handed to the driver to upload, one call each.
+	unsigned int uploadCount;
+	unsigned int uploadedSize;
+
+	//! Times the storage was reallocated because the data of a frame did not fit.
+	unsigned int growCount;
+};
+
+//! Host copy of the buffer the uniform blocks of the draws are read from.
+//!
+//! The blocks are allocated one after the other and the ring wraps around when it reaches its end.
+//! The memory written in a frame is kept for the next frames the gpu may still read it in, it is
+//! reused only after that. The driver mirrors the storage in a buffer of the same size, uploads the
+//! pending range once all the blocks of a batch of draws are written and binds each block by offset.
+//! The allocator knows nothing about the api, so it runs headless.
+class ENGINE_PUBLIC_EXPORT UniformRingBuffer
+{
+public:
+
+	UniformRingBuffer();
+	~UniformRingBuffer();
+
+	//! Sets the storage up, all the data is dropped.
+	//! \param size: Size of the ring in bytes, it grows when a frame needs more.
+	//! \param alignment: Alignment of the block offsets, the api requires one for binding by offset (256 is common).
+	//! \param frameCount: Frames the data of a frame is kept for.
+	void initialize(unsigned int size, unsigned int alignment = 256, unsigned int frameCount = 3);
+
+	//! Starts a new frame, the memory of the frame frameCount frames ago is free again.
+	void beginFrame();
+
+	//! Makes sure the next allocations of the given total size fit without wrapping into each other.
+	//! Call it before writing the blocks of a batch of draws, so the pending range stays contiguous.
+	//! \return true if the storage was reallocated, the driver has to create its buffer again and the
+	//! blocks written before are lost.
+	bool reserve(unsigned int size);
+
+	//! Allocates an aligned block.
+	//! \return The offset of the block, UNIFORM_RING_BUFFER_INVALID_OFFSET if it does not fit.
+	unsigned int allocate(unsigned int size);
+
+	//! Gets the range written since the last call and counts it as uploaded.
+	//! \return false if nothing was written.
+	bool takePendingRange(unsigned int& offset, unsigned int& size);
+
+	//! Writes the parameters of a frequency of the material parameter program in a new block.
+	//! \return The offset of the block, UNIFORM_RING_BUFFER_INVALID_OFFSET if it does not fit.
+	unsigned int writeParameterBlock(Material* material, ShaderParameterFrequency frequency, RenderStateData& renderStateData);
+
+	unsigned int getSize() const;
+	unsigned int getAlignment() const;
+
+	//! Bytes used by the frames still kept.
+	unsigned int getUsedSize() const;
+
+	unsigned char* getData();
+	const unsigned char* getData() const;
+
+	//! Rounds a block size up to the offset alignment.
+	unsigned int getAlignedSize(unsigned int size) const;
+
+	const UniformRingBufferStats& getStats() const;
+
+protected:
+
+	std::vector<unsigned char> mData;
+
+	unsigned int mAlignment;
+
+	//! Next free byte and first used byte.
+	unsigned int mHead;
+	unsigned int mTail;
+	unsigned int mUsedSize;
+
+	//! Bytes taken by each kept frame, the ones wasted at the end of the ring when it wrapped included.
+	std::vector<unsigned int> mFrameSizes;
+	unsigned int mFrameIndex;
+
+	//! Start of the range not uploaded yet, UNIFORM_RING_BUFFER_INVALID_OFFSET if there is none.
+	unsigned int mPendingOffset;
+	//! End of the pending range before the ring wrapped, UNIFORM_RING_BUFFER_INVALID_OFFSET if it did not.
+	unsigned int mPendingWrapOffset;
+
+	UniformRingBufferStats mStats;
+};
+
+} // end namespace render
+
+#endif
\ No newline at end of file
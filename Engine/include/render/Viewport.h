@@ -113,6 +113,13 @@ public:
 	//! Gets the number of rendered faces in the last update.
 	unsigned int getNumRenderedFaces() const;
 
+	//! Internal method to notify the viewport of the models and the draw calls they took in the last render.
+	void notifyRenderedModels(unsigned int numModels, unsigned int numDrawCalls);
+	//! Gets the number of rendered models in the last update.
+	unsigned int getNumRenderedModels() const;
+	//! Gets the number of draw calls in the last update, lower than the number of models when they were instanced.
+	unsigned int getNumDrawCalls() const;
+
 	void setShowOverlays(bool enabled);
 	bool getShowOverlays();
 
@@ -140,6 +147,9 @@ protected:
 	// Stored number of visible faces in the last render
 	unsigned int mRenderedFaces;
 
+	unsigned int mRenderedModels;
+	unsigned int mDrawCalls;
+
 	// Background options
 	Color mBackColor;
 	bool mClearEveryFrame;
@@ -0,0 +1,177 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _VISIBILITY_TREE_H_
+#define _VISIBILITY_TREE_H_
+
+#include <EngineConfig.h>
+#include <core/Aabox3d.h>
+
+#include <vector>
+
+namespace render
+{
+
+class Model;
+class Frustum;
+
+//! Dynamic bounding volume hierarchy over the world bounds of the models, used to find the visible ones.
+//!
+//! Every model is a leaf, its index stays the same for as long as the model is in the tree.
+//! Models are inserted next to the sibling that grows the tree the least, moved leaves only mark their
+//! ancestors and are refitted together on the next update. The tree is rebuilt top-down with a binned
+//! surface area heuristic when the surface area of its nodes grew too much relative to the last build.
+//! When a large part of the models moves the tree is not refitted and all the leaves are culled linearly.
+class ENGINE_PUBLIC_EXPORT VisibilityTree
+{
+public:
+
+	VisibilityTree();
+	~VisibilityTree();
+
+	//! Adds a model with its world bounds, returns the leaf that references it.
+	unsigned int insert(Model* model, const core::aabox3d& box);
+
+	//! Removes a leaf returned by insert.
+	void remove(unsigned int leaf);
+
+	//! Changes the bounds of a leaf, the tree is refitted on the next update.
+	void move(unsigned int leaf, const core::aabox3d& box);
+
+	//! Removes all the models, the memory is kept.
+	void clear();
+
+	//! Refits the nodes above the moved leaves and rebuilds the tree if its quality degraded,
+	//! or leaves the tree as it is when too many leaves moved.
+	void update();
+
+	//! Rebuilds the whole tree with the surface area heuristic.
+	void rebuild();
+
+	//! Appends the models whose bounds are inside or intersect the frustum.
+	//! Subtrees fully inside a plane skip that plane, subtrees fully inside the frustum are not tested at all.
+	//! Leaves that still intersect a plane are tested in batches by the SIMD culling kernels.
+	void findVisibleModels(const Frustum& frustum, std::vector<Model*>& models);
+
+	unsigned int getModelCount() const;
+
+	//! Index of no node, returned by insert when the model is nullptr.
+	static const unsigned int NULL_NODE;
+
+protected:
+
+	struct Node
+	{
+		core::aabox3d box;
+
+		//! The model of a leaf, nullptr for the inner nodes.
+		Model* model;
+
+		//! Parent node, the next free node for the nodes in the free list.
+		unsigned int parent;
+
+		unsigned int children[2];
+
+		//! The bounds of a leaf changed or the box of an inner node has to be refitted.
+		bool dirty;
+	};
+
+	//! Copy of the bounds of a leaf the rebuild sorts, kept contiguous and in plain floats
+	//! so the binning passes neither chase the nodes nor call the vector constructors.
+	struct BuildItem
+	{
+		float minEdge[3];
+		float maxEdge[3];
+		float center[3];
+		unsigned int leaf;
+	};
+
+	unsigned int allocateNode();
+	void freeNode(unsigned int node);
+
+	//! Sets the box of an inner node to the union of its children, keeping the total surface area up to date.
+	void refitNode(unsigned int node);
+
+	//! Refits the ancestors of the moved leaves.
+	void refitMovedLeaves();
+
+	//! Refits the boxes from a node up to the root.
+	void refitAncestors(unsigned int node);
+
+	//! Builds the inner nodes over mBuildItems[begin, end), returns the root of the subtree.
+	unsigned int build(unsigned int begin, unsigned int end);
+
+	//! Creates the parent of two nodes of the rebuild.
+	unsigned int createInnerNode(unsigned int left, unsigned int right);
+
+	//! Tests the leaves gathered by the traversal against the frustum, appending the visible models.
+	void cullLeaves(const Frustum& frustum, std::vector<Model*>& models);
+
+	static float getSurfaceArea(const core::aabox3d& box);
+	static float getUnionSurfaceArea(const core::aabox3d& a, const core::aabox3d& b);
+	static void setUnion(core::aabox3d& box, const core::aabox3d& a, const core::aabox3d& b);
+
+	std::vector<Node> mNodes;
+	unsigned int mRoot;
+	unsigned int mFreeNode;
+
+	unsigned int mModelCount;
+
+	//! Leaves moved since the last update.
+	std::vector<unsigned int> mMovedLeaves;
+
+	//! Every inner node is stored before its inner children, the whole tree can be refitted in reverse memory order.
+	bool mParentsFirst;
+
+	//! The inner boxes were not refitted to the moved leaves, findVisibleModels culls all the leaves linearly.
+	bool mStale;
+
+	//! Sum of the surface area of the inner nodes.
+	float mInnerArea;
+
+	//! Surface area per model right after the last rebuild, zero if the tree was never built.
+	float mBuildArea;
+	unsigned int mBuildModelCount;
+
+	//! Scratch storage of the refit and the traversal.
+	std::vector<unsigned int> mStack;
+
+	//! Scratch storage of the rebuild.
+	std::vector<BuildItem> mBuildItems;
+
+	//! Per node plane that rejected the leaf the last time it was culled.
+	std::vector<unsigned char> mLastPlanes;
+
+	//! Scratch storage of the leaf culling, the bounds are stored as structure of arrays.
+	std::vector<unsigned int> mCullLeaves;
+	std::vector<float> mCullBounds;
+	std::vector<unsigned char> mCullPlanes;
+	std::vector<unsigned int> mCullVisible;
+};
+
+} // end namespace render
+
+#endif
\ No newline at end of file
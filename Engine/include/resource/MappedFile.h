@@ -0,0 +1,74 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+
+#include <EngineConfig.h>
+
+#include <string>
+
+namespace resource
+{
+
+//! Read only view of a whole file mapped into memory.
+class ENGINE_PUBLIC_EXPORT MappedFile
+{
+public:
+
+	MappedFile();
+	~MappedFile();
+
+	//! Maps the file specified.
+	//! \return: false if the file could not be opened or mapped.
+	bool open(const std::string& filePath);
+
+	//! Unmaps the file.
+	void close();
+
+	bool isOpen() const;
+
+	//! Gets the start of the mapped file.
+	const unsigned char* getData() const;
+
+	//! Gets the size of the mapped file, in bytes.
+	unsigned int getSize() const;
+
+protected:
+
+#if ENGINE_PLATFORM == PLATFORM_WINDOWS
+	void* mFile;
+	void* mMapping;
+#else
+	int mFile;
+#endif
+
+	const unsigned char* mData;
+	unsigned int mSize;
+};
+
+} // end namespace resource
+
+#endif
\ No newline at end of file
@@ -0,0 +1,107 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef _MESH_FILE_DEFINES_H_
+#define _MESH_FILE_DEFINES_H_
+
+namespace resource
+{
+
+//! Identifies a binary mesh file, reads "KGMB" in file order.
+const unsigned int MESH_FILE_MAGIC = 0x424D474B;
+
+//! Extension used for binary mesh files.
+const char* const MESH_FILE_EXTENSION = ".kgmesh";
+
+//! Current version of the binary mesh format.
+const unsigned int MESH_FILE_VERSION = 3;
+
+//! Alignment of the streams inside the file so they can be copied straight into the buffers.
+const unsigned int MESH_FILE_ALIGNMENT = 16;
+
+//! Maximum number of vertex streams in a file.
+const unsigned int MESH_FILE_MAX_STREAMS = 8;
+
+//! Maximum number of levels of detail stored after the full mesh.
+const unsigned int MESH_FILE_MAX_LODS = 4;
+
+//! Describes one vertex stream of a binary mesh file.
+struct MeshFileStream
+{
+	//! render::VertexBufferType of the stream.
+	unsigned int vertexBufferType;
+	//! render::VertexElementType of the stream.
+	unsigned int vertexElementType;
+	//! Offset from the start of the file, in bytes.
+	unsigned int offset;
+	//! Size of the stream, in bytes.
+	unsigned int size;
+};
+
+//! Describes the index stream of one level of detail of a binary mesh file.
+struct MeshFileLod
+{
+	unsigned int numIndexes;
+	//! Offset from the start of the file, in bytes.
+	unsigned int offset;
+	//! Error of the level in mesh units, see render::MeshData::getLodError.
+	float error;
+
+	unsigned int reserved;
+};
+
+//! Header of a binary mesh file (.kgmesh).
+//! All values are little endian; the header is followed by the vertex streams, the index stream and the index streams
+//! of the levels of detail, each one starting at a multiple of MESH_FILE_ALIGNMENT.
+struct MeshFileHeader
+{
+	unsigned int magic;
+	unsigned int version;
+	unsigned int headerSize;
+
+	unsigned int numVertices;
+	unsigned int numIndexes;
+
+	//! Size of one index, in bytes, 2 if the vertices fit in 16 bit indices and 4 otherwise.
+	//! The index streams of the levels of detail have the same size, all of them are copied into the buffers unchanged.
+	unsigned int indexSize;
+	//! Offset of the index stream from the start of the file, in bytes.
+	unsigned int indexOffset;
+
+	unsigned int numStreams;
+
+	float boundingBoxMin[3];
+	float boundingBoxMax[3];
+	float boundingSphereRadius;
+
+	unsigned int numLods;
+
+	MeshFileStream streams[MESH_FILE_MAX_STREAMS];
+	MeshFileLod lods[MESH_FILE_MAX_LODS];
+};
+
+} // end namespace resource
+
+#endif
\ No newline at end of file
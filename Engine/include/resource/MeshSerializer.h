@@ -29,21 +29,27 @@ THE SOFTWARE.
 
 #include <EngineConfig.h>
 #include <resource/Serializer.h>
+#include <render/VertexBufferDefines.h>
 
 #include <string>
 
+namespace render
+{
+class MeshData;
+}
+
 namespace resource
 {
 
 //! Class for serialising mesh data.
-class ENGINE_PRIVATE_EXPORT MeshSerializer: public Serializer
+class ENGINE_PUBLIC_EXPORT MeshSerializer: public Serializer
 {
 public:
 
 	MeshSerializer();
 	virtual ~MeshSerializer();
 
-	//! Imports a MeshData from an .xml file.
+	//! Imports a MeshData from an .xml or a binary .kgmesh file.
 	bool importResource(Resource* dest, const std::string& filename);
 
 	//! Exports a mesh to the file specified. 
@@ -52,6 +58,29 @@ public:
 	//! \param meshData: Pointer to the MeshData to export
 	//! \param filename: The destination filename.
 	bool exportResource(Resource* source, const std::string& filename);
+
+	bool canParseAsync() const;
+
+	//! Parses the mesh file, the binary files are mapped and used in place.
+	SerializerData* parseResource(Resource* dest, const std::string& filename);
+
+	//! Creates the vertex and index buffers from the parsed data.
+	bool finalizeResource(Resource* dest, SerializerData* data);
+
+	//! Converts an .xml mesh to the binary .kgmesh format, the levels of detail are simplified here and stored with it.
+	//! \param sourcePath: Path of the .xml mesh.
+	//! \param destinationPath: Path of the binary file to write.
+	bool convertMesh(const std::string& sourcePath, const std::string& destinationPath);
+
+protected:
+
+	//! Parses an .xml mesh and computes the tangent space.
+	SerializerData* parseXmlFile(const std::string& filePath);
+
+	//! Maps a binary mesh and points the streams and the levels of detail into the mapping.
+	SerializerData* parseBinaryFile(const std::string& filePath);
+
+	bool createVertexBuffer(render::MeshData* meshData, render::VertexBufferType type, render::VertexElementType elementType, unsigned int numVertices, const float* data, unsigned int count);
 };
 
 }// end namespace resource
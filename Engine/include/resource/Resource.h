@@ -29,14 +29,17 @@ THE SOFTWARE.
 
 #include <EngineConfig.h>
 #include <core/Utils.h>
+#include <core/Handle.h>
 #include <resource/ResourceDefines.h>
 
 #include <string>
+#include <list>
 
 namespace resource
 {
 
 class Serializer;
+class SerializerData;
 class ResourceManager;
 struct ResourceEvent;
 class ResourceEventReceiver;
@@ -60,6 +63,10 @@ public:
 	//! Returns the id of the resource.
 	const unsigned int& getID() const;
 
+	//! Returns the handle of the resource in the ResourceManager.
+	const core::Handle& getHandle() const;
+	void setHandle(const core::Handle& handle);
+
 	//! Gets resource type.
 	const ResourceType& getResourceType() const;
 
@@ -70,6 +77,10 @@ public:
 	//! Retrieves info about the size of the resource.
 	unsigned int getSize();
 
+	//! Runs the parse phase of the serializer, can be called from a loader thread.
+	//! The next load() finishes the resource from the parsed data on the calling thread.
+	bool parse();
+
 	bool load();
 
 	void unload();
@@ -89,6 +100,8 @@ protected:
 
 	unsigned int mID;
 
+	core::Handle mHandle;
+
 	static unsigned int mIndexCounter;
 
 	ResourceType mResourceType;
@@ -99,6 +112,7 @@ protected:
 
 	std::string mFilename;
 	Serializer* mSerializer;
+	SerializerData* mSerializerData;
 	ResourceState mState;
 	unsigned int mSize;
 
@@ -32,11 +32,18 @@ THE SOFTWARE.
 #include <core/System.h>
 #include <core/Singleton.h>
 #include <core/Math.h>
+#include <core/SlotMap.h>
+#include <resource/ResourceDefines.h>
 
 #include <string>
 #include <vector>
 #include <list>
 #include <map>
+#include <set>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
 namespace resource
 {
@@ -46,13 +53,15 @@ class Resource;
 class ResourceFactory;
 class LoadEventReceiver;
 struct LoadEvent;
-enum ResourceType;
 
 //! A resource manager is responsible for managing a pool of
 //! resources of a particular type. It must index them, look
 //! them up, load and destroy them. It may also need to stay within
 //! a defined memory budget, and temporaily unload some resources
 //! if it needs to to stay within this budget.
+//! Resources can also be loaded in the background: the loader threads run the parse phase
+//! of the serializers while the main thread finalizes the parsed resources from update(),
+//! within a time budget, for the work that must touch the drivers.
 //! \todo: Implement priorities.
 class ENGINE_PUBLIC_EXPORT ResourceManager: public core::System, public core::Singleton<ResourceManager>
 {
@@ -64,8 +73,39 @@ public:
 	//! Creates a resource.
 	Resource* createResource(const ResourceType& type, const std::string& filename);
 
+	//! Returns the resource the handle references or nullptr if it was removed.
+	Resource* getResource(const core::Handle& handle);
+
 	//! Load all resource waiting for load.
+	//! The files are parsed on the loader threads while the calling thread finalizes them.
 	void loadResources();
+
+	//! Queues all resources waiting for load on the loader threads and returns immediately.
+	//! Load events are fired from update() as the resources get finalized.
+	void loadResourcesAsync();
+
+	//! Queues a resource on the loader threads.
+	//! The resource is the handle of the request: it fires its loaded event and reaches
+	//! RESOURCE_STATE_LOADED once it has been finalized.
+	bool loadResourceAsync(Resource* resource);
+
+	//! Returns true if the resource is waiting for an asynchronous load to finish.
+	bool isLoadPending(Resource* resource) const;
+
+	//! Returns the number of asynchronous loads not finished yet.
+	unsigned int getPendingLoadCount() const;
+
+	//! Finalizes the pending asynchronous loads on the calling thread until all of them are done.
+	void waitForLoads();
+
+	//! Sets the number of loader threads, 0 parses on the calling thread.
+	//! Takes effect the next time the manager is initialized.
+	void setLoaderThreadCount(unsigned int count);
+	unsigned int getLoaderThreadCount() const;
+
+	//! Sets the time in milliseconds update() may spend finalizing loaded resources.
+	void setFinalizeTimeBudget(float milliseconds);
+	float getFinalizeTimeBudget() const;
 	//! Unload all resources.
 	void unloadResources();
 
@@ -76,7 +116,7 @@ public:
 
 	//! Remove a Resource from the managed resources list, calling it's unload() method.
 	void removeResource(Resource *resource);
-	void removeResource(const unsigned int& id);
+	void removeResource(const core::Handle& handle);
 
 	void removeAllResources();
 
@@ -118,7 +158,7 @@ protected:
 	std::vector<Serializer*> mSerializers;
 
 	//! Central list of resources - for easy memory management and lookup.
-	std::map<unsigned int, Resource*> mResources;
+	core::SlotMap<Resource*> mResources;
 	std::map<std::string, Resource*> mResourcesByFilename;
 	
 	unsigned int mMemoryUsage;		// In bytes
@@ -126,6 +166,34 @@ protected:
 	unsigned int mTotalLoadSize;
 	unsigned int mLoadedSize;
 
+	//! Loader threads.
+	std::vector<std::thread*> mLoaderThreads;
+	unsigned int mLoaderThreadCount;
+
+	//! Guards the queues shared with the loader threads.
+	std::mutex mLoadMutex;
+	std::condition_variable mParseCondition;
+	std::condition_variable mParsedCondition;
+	bool mLoaderRunning;
+
+	std::deque<Resource*> mParseQueue;
+	std::set<Resource*> mParsingResources;
+	std::deque<Resource*> mFinalizeQueue;
+
+	//! Resources requested asynchronously and not finalized yet, only used by the main thread.
+	std::set<Resource*> mPendingResources;
+
+	float mFinalizeTimeBudget;
+
+	void startLoaderThreads();
+	void stopLoaderThreads();
+	void loaderLoop();
+
+	void queueLoads(const std::vector<Resource*>& resources);
+	bool popParsedResource(Resource*& resource, bool wait);
+	void finalizeLoad(Resource* resource);
+	void cancelLoad(Resource* resource);
+
 	void fireLoadStarted();
 
 	void fireLoadUpdate();
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #define _SERIALIZER_H_
 
 #include <EngineConfig.h>
+#include <resource/ResourceDefines.h>
 
 #include <string>
 
@@ -46,12 +47,19 @@ namespace resource
 {
 
 class Resource;
-enum ResourceType;
 
 //! Chunk overhead = ID + size
 const unsigned int CHUNK_OVERHEAD_SIZE = sizeof(unsigned short int) + sizeof(unsigned int);
 const unsigned short int HEADER_CHUNK_ID = 0x1000;
 
+//! Intermediate data produced by the parse phase of a serializer and consumed by its finalize phase.
+class ENGINE_PUBLIC_EXPORT SerializerData
+{
+public:
+
+	virtual ~SerializerData();
+};
+
 //! Generic class for serialising data to / from binary chunk-based files.
 //!
 //! This class provides a number of useful methods for exporting / importing data
@@ -69,6 +77,17 @@ public:
 	//! Exports a resource to the file specified. 
 	virtual bool exportResource(Resource* source, const std::string& filename) = 0;
 
+	//! Returns true if the import is split in a parse and a finalize phase.
+	virtual bool canParseAsync() const;
+
+	//! Reads and decodes the file specified without touching the render driver or other resources.
+	//! This is called from the resource loader threads.
+	//! \return: The parsed data or nullptr on failure.
+	virtual SerializerData* parseResource(Resource* dest, const std::string& filename);
+
+	//! Builds the resource from the parsed data, called from the main thread.
+	virtual bool finalizeResource(Resource* dest, SerializerData* data);
+
 protected:
 
 	ResourceType mResourceType;
@@ -78,9 +97,9 @@ protected:
 	std::string mVersion;
 };
 
-inline core::vector3d ENGINE_PUBLIC_EXPORT parseVector3d(std::string& params);
-inline core::quaternion ENGINE_PUBLIC_EXPORT parseQuaternion(std::string& params);
-inline render::Color ENGINE_PUBLIC_EXPORT parseColor(std::string& params);
+core::vector3d ENGINE_PUBLIC_EXPORT parseVector3d(std::string& params);
+core::quaternion ENGINE_PUBLIC_EXPORT parseQuaternion(std::string& params);
+render::Color ENGINE_PUBLIC_EXPORT parseColor(std::string& params);
 
 }// end namespace resource
 
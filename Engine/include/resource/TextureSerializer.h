@@ -29,6 +29,7 @@ THE SOFTWARE.
 
 #include <EngineConfig.h>
 #include <resource/Serializer.h>
+#include <resource/PixelFormat.h>
 
 #include <string>
 
@@ -41,7 +42,6 @@ class Color;
 namespace resource
 {
 
-enum PixelFormat;
 class DataStream;
 
 //! Class for serialising texture data to/from a texture file.
@@ -57,6 +57,14 @@ public:
 
 	//! Exports a texture to the file specified.
 	bool exportResource(Resource* source, const std::string& filename);
+
+	bool canParseAsync() const;
+
+	//! Decodes the image file into a top-down pixel buffer.
+	SerializerData* parseResource(Resource* dest, const std::string& filename);
+
+	//! Hands the decoded pixels to the texture.
+	bool finalizeResource(Resource* dest, SerializerData* data);
 };
 
 }// end namespace resource
@@ -28,7 +28,8 @@ THE SOFTWARE.
 #define _LISTENER_FACTORY_H_
 
 #include <EngineConfig.h>
-#include <game/ComponentFactory.h>
+#include <game/PooledComponentFactory.h>
+#include <sound/Listener.h>
 
 namespace game
 {
@@ -38,7 +39,7 @@ class Component;
 namespace sound
 {
 
-class ENGINE_PUBLIC_EXPORT ListenerFactory: public game::ComponentFactory
+class ENGINE_PUBLIC_EXPORT ListenerFactory: public game::PooledComponentFactory<Listener>
 {
 public:
 
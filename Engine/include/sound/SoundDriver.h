@@ -51,7 +51,7 @@ class Listener;
 //! methods have implementations, most of this class is
 //! abstract, requiring a subclass based on a specific API
 //! to be constructed to provide the full functionality.
-class ENGINE_PUBLIC_EXPORT SoundDriver : core::SystemDriver
+class ENGINE_PUBLIC_EXPORT SoundDriver : public core::SystemDriver
 {
 public:
 
@@ -38,12 +38,12 @@ aabox3d::aabox3d(const vector3d& init): MinEdge(init), MaxEdge(init) {}
 
 aabox3d::aabox3d(float minx, float miny, float minz, float maxx, float maxy, float maxz): MinEdge(minx, miny, minz), MaxEdge(maxx, maxy, maxz) {}
 
-inline bool aabox3d::operator==(const aabox3d& other) const
+bool aabox3d::operator==(const aabox3d& other) const
 {
 	return (MinEdge == other.MinEdge && other.MaxEdge == MaxEdge);
 }
 
-inline bool aabox3d::operator!=(const aabox3d& other) const
+bool aabox3d::operator!=(const aabox3d& other) const
 {
 	return !(MinEdge == other.MinEdge && other.MaxEdge == MaxEdge);
 }
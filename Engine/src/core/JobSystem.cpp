@@ -0,0 +1,368 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <core/JobSystem.h>
+#include <core/Log.h>
+#include <core/Profiler.h>
+#include <core/Utils.h>
+
+#include <deque>
+
+#if ENGINE_COMPILER == COMPILER_MSVC
+#	define JOB_THREAD_LOCAL __declspec(thread)
+#else
+#	define JOB_THREAD_LOCAL __thread
+#endif
+
+template<> core::JobSystem* core::Singleton<core::JobSystem>::m_Singleton = nullptr;
+
+namespace core
+{
+
+static JOB_THREAD_LOCAL unsigned int gThreadIndex = 0;
+
+JobCounter::JobCounter()
+{
+	mValue = 0;
+}
+
+void JobCounter::increment(int value)
+{
+	mValue.fetch_add(value);
+}
+
+void JobCounter::decrement()
+{
+	mValue.fetch_sub(1);
+}
+
+int JobCounter::getValue() const
+{
+	return mValue.load();
+}
+
+bool JobCounter::isDone() const
+{
+	return mValue.load() == 0;
+}
+
+//! Deque owned by one thread, the owner works at the back and thieves at the front.
+class JobQueue
+{
+public:
+
+	void push(const Job& job)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mJobs.push_back(job);
+	}
+
+	bool pop(Job& job)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mJobs.empty())
+			return false;
+
+		job = mJobs.back();
+		mJobs.pop_back();
+		return true;
+	}
+
+	bool steal(Job& job)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mJobs.empty())
+			return false;
+
+		job = mJobs.front();
+		mJobs.pop_front();
+		return true;
+	}
+
+protected:
+
+	std::mutex mMutex;
+	std::deque<Job> mJobs;
+};
+
+struct ParallelForRange
+{
+	ParallelForFunction function;
+	void* data;
+	unsigned int begin;
+	unsigned int end;
+};
+
+static void parallelForJob(void* data)
+{
+	ParallelForRange* range = static_cast<ParallelForRange*>(data);
+	range->function(range->begin, range->end, range->data);
+}
+
+JobSystem::JobSystem()
+{
+	mRunning = false;
+	mPendingJobs = 0;
+
+	// the calling thread always has a queue
+	mQueues.push_back(new JobQueue());
+}
+
+JobSystem::~JobSystem()
+{
+	stop();
+
+	std::vector<JobQueue*>::iterator i;
+	for (i = mQueues.begin(); i != mQueues.end(); ++i)
+	{
+		SAFE_DELETE(*i);
+	}
+	mQueues.clear();
+}
+
+void JobSystem::start(unsigned int workerCount)
+{
+	if (mRunning)
+		return;
+
+	mRunning = true;
+
+	gThreadIndex = 0;
+
+	for (unsigned int i = 0; i < workerCount; ++i)
+		mQueues.push_back(new JobQueue());
+
+	for (unsigned int i = 1; i <= workerCount; ++i)
+		mThreads.push_back(new std::thread(&JobSystem::workerLoop, this, i));
+
+	if (Log::getInstance() != nullptr) Log::getInstance()->logMessage("JobSystem", "Started with " + intToString(workerCount) + " worker threads");
+}
+
+void JobSystem::stop()
+{
+	if (!mRunning)
+		return;
+
+	// finish what is still queued before the workers leave
+	while (executeJob()) {}
+
+	{
+		std::lock_guard<std::mutex> lock(mWakeMutex);
+		mRunning = false;
+	}
+	mWakeCondition.notify_all();
+
+	std::vector<std::thread*>::iterator i;
+	for (i = mThreads.begin(); i != mThreads.end(); ++i)
+	{
+		(*i)->join();
+		SAFE_DELETE(*i);
+	}
+	mThreads.clear();
+
+	while (mQueues.size() > 1)
+	{
+		SAFE_DELETE(mQueues.back());
+		mQueues.pop_back();
+	}
+
+	if (Log::getInstance() != nullptr) Log::getInstance()->logMessage("JobSystem", "Stopped");
+}
+
+void JobSystem::setWorkerCount(unsigned int workerCount)
+{
+	if (mRunning && workerCount == getWorkerCount())
+		return;
+
+	stop();
+	start(workerCount);
+}
+
+unsigned int JobSystem::getWorkerCount() const
+{
+	return mThreads.size();
+}
+
+unsigned int JobSystem::getThreadIndex() const
+{
+	return gThreadIndex;
+}
+
+void JobSystem::run(JobFunction function, void* data, JobCounter* counter)
+{
+	Job job;
+	job.function = function;
+	job.data = data;
+	job.counter = counter;
+
+	run(&job, 1, counter);
+}
+
+void JobSystem::run(Job* jobs, unsigned int count, JobCounter* counter)
+{
+	if (jobs == nullptr || count == 0)
+		return;
+
+	if (counter != nullptr)
+		counter->increment(count);
+
+	unsigned int threadIndex = gThreadIndex < mQueues.size() ? gThreadIndex : 0;
+	JobQueue* pQueue = mQueues[threadIndex];
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		jobs[i].counter = counter;
+		pQueue->push(jobs[i]);
+	}
+
+	mPendingJobs.fetch_add(count);
+
+	{
+		std::lock_guard<std::mutex> lock(mWakeMutex);
+	}
+	if (count == 1)
+		mWakeCondition.notify_one();
+	else
+		mWakeCondition.notify_all();
+}
+
+void JobSystem::wait(JobCounter* counter)
+{
+	if (counter == nullptr)
+		return;
+
+	while (!counter->isDone())
+	{
+		if (!executeJob())
+			std::this_thread::yield();
+	}
+}
+
+bool JobSystem::executeJob()
+{
+	Job job;
+	if (!popJob(gThreadIndex, job))
+		return false;
+
+	executeJob(job);
+
+	return true;
+}
+
+void JobSystem::parallelFor(unsigned int count, ParallelForFunction function, void* data, unsigned int grainSize)
+{
+	if (count == 0 || function == nullptr)
+		return;
+
+	unsigned int threadCount = getWorkerCount() + 1;
+	if (grainSize == 0)
+	{
+		// a few ranges per thread so that stealing can balance uneven work
+		grainSize = count / (threadCount * 4);
+		if (grainSize == 0)
+			grainSize = 1;
+	}
+
+	if (threadCount == 1 || count <= grainSize)
+	{
+		function(0, count, data);
+		return;
+	}
+
+	unsigned int rangeCount = (count + grainSize - 1) / grainSize;
+
+	std::vector<ParallelForRange> ranges(rangeCount);
+	std::vector<Job> jobs(rangeCount);
+	for (unsigned int i = 0; i < rangeCount; ++i)
+	{
+		ranges[i].function = function;
+		ranges[i].data = data;
+		ranges[i].begin = i * grainSize;
+		ranges[i].end = (ranges[i].begin + grainSize < count) ? ranges[i].begin + grainSize : count;
+
+		jobs[i].function = parallelForJob;
+		jobs[i].data = &ranges[i];
+		jobs[i].counter = nullptr;
+	}
+
+	JobCounter counter;
+	run(&jobs[0], rangeCount, &counter);
+	wait(&counter);
+}
+
+void JobSystem::workerLoop(unsigned int threadIndex)
+{
+	gThreadIndex = threadIndex;
+
+	PROFILE_THREAD_NAME("Worker " + intToString(threadIndex));
+
+	while (mRunning)
+	{
+		if (executeJob())
+			continue;
+
+		std::unique_lock<std::mutex> lock(mWakeMutex);
+		while (mRunning && mPendingJobs.load() == 0)
+			mWakeCondition.wait(lock);
+	}
+}
+
+bool JobSystem::popJob(unsigned int threadIndex, Job& job)
+{
+	if (mPendingJobs.load() == 0)
+		return false;
+
+	unsigned int queueCount = mQueues.size();
+	if (threadIndex >= queueCount)
+		threadIndex = 0;
+
+	bool found = mQueues[threadIndex]->pop(job);
+	for (unsigned int i = 1; i < queueCount && !found; ++i)
+	{
+		found = mQueues[(threadIndex + i) % queueCount]->steal(job);
+	}
+
+	if (found)
+		mPendingJobs.fetch_sub(1);
+
+	return found;
+}
+
+void JobSystem::executeJob(Job& job)
+{
+	if (job.function != nullptr)
+		job.function(job.data);
+
+	if (job.counter != nullptr)
+		job.counter->decrement();
+}
+
+JobSystem* JobSystem::getInstance()
+{
+	return core::Singleton<JobSystem>::getInstance();
+}
+
+} // end namespace core
\ No newline at end of file
@@ -26,69 +26,386 @@ THE SOFTWARE.
 
 #include <core/Log.h>
 
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+
+#if ENGINE_PLATFORM == PLATFORM_WINDOWS
+#	include <windows.h>
+#endif
+
 template<> core::Log* core::Singleton<core::Log>::m_Singleton = nullptr;
 
 namespace core
 {
 
-Log::Log()
+#define LOG_RECORD_DATA_SIZE 232
+#define LOG_WRITE_BATCH_SIZE 65536
+#define LOG_WRITER_WAIT_MILLISECONDS 10
+#define LOG_CRASH_FLUSH_MILLISECONDS 200
+
+//! A queue slot, the source and the text are copied in place unless they are too long.
+struct LogRecord
+{
+	//! Equals the enqueue position when the slot is free and position + 1 once the message is published.
+	std::atomic<unsigned int> sequence;
+
+	LogLevel level;
+	unsigned int sourceLength;
+	unsigned int textLength;
+
+	char* longData;
+	char data[LOG_RECORD_DATA_SIZE];
+};
+
+static std::terminate_handler gPreviousTerminateHandler = nullptr;
+
+#if ENGINE_PLATFORM == PLATFORM_WINDOWS
+static LPTOP_LEVEL_EXCEPTION_FILTER gPreviousExceptionFilter = nullptr;
+
+static LONG WINAPI logExceptionFilter(EXCEPTION_POINTERS* exceptionInfo)
+{
+	if (Log::getInstance() != nullptr)
+		Log::getInstance()->crashFlush();
+
+	if (gPreviousExceptionFilter != nullptr)
+		return gPreviousExceptionFilter(exceptionInfo);
+
+	return EXCEPTION_CONTINUE_SEARCH;
+}
+
+// access violations and the like are reported through the exception filter
+static const int gCrashSignals[] = {SIGABRT};
+#else
+static const int gCrashSignals[] = {SIGSEGV, SIGFPE, SIGILL, SIGABRT};
+#endif
+
+#define LOG_CRASH_SIGNAL_COUNT (sizeof(gCrashSignals) / sizeof(gCrashSignals[0]))
+
+typedef void (*SignalHandler)(int);
+static SignalHandler gPreviousSignalHandlers[LOG_CRASH_SIGNAL_COUNT];
+
+static void logSignalHandler(int signalNumber)
+{
+	if (Log::getInstance() != nullptr)
+		Log::getInstance()->crashFlush();
+
+	// let the previous handler or the default action end the process
+	for (unsigned int i = 0; i < LOG_CRASH_SIGNAL_COUNT; ++i)
+	{
+		if (gCrashSignals[i] == signalNumber)
+		{
+			SignalHandler previous = gPreviousSignalHandlers[i];
+			signal(signalNumber, (previous != SIG_ERR && previous != nullptr) ? previous : SIG_DFL);
+			break;
+		}
+	}
+
+	raise(signalNumber);
+}
+
+static void logTerminateHandler()
+{
+	if (Log::getInstance() != nullptr)
+		Log::getInstance()->crashFlush();
+
+	if (gPreviousTerminateHandler != nullptr)
+		gPreviousTerminateHandler();
+
+	abort();
+}
+
+static void installCrashHandlers()
+{
+	gPreviousTerminateHandler = std::set_terminate(logTerminateHandler);
+
+#if ENGINE_PLATFORM == PLATFORM_WINDOWS
+	gPreviousExceptionFilter = SetUnhandledExceptionFilter(logExceptionFilter);
+#endif
+
+	for (unsigned int i = 0; i < LOG_CRASH_SIGNAL_COUNT; ++i)
+		gPreviousSignalHandlers[i] = signal(gCrashSignals[i], logSignalHandler);
+}
+
+static void removeCrashHandlers()
+{
+	std::set_terminate(gPreviousTerminateHandler);
+	gPreviousTerminateHandler = nullptr;
+
+#if ENGINE_PLATFORM == PLATFORM_WINDOWS
+	SetUnhandledExceptionFilter(gPreviousExceptionFilter);
+	gPreviousExceptionFilter = nullptr;
+#endif
+
+	for (unsigned int i = 0; i < LOG_CRASH_SIGNAL_COUNT; ++i)
+	{
+		if (gPreviousSignalHandlers[i] != SIG_ERR)
+			signal(gCrashSignals[i], gPreviousSignalHandlers[i]);
+	}
+}
+
+Log::Log(unsigned int queueSize)
 {
 	mLogStream.open("engine.log");
+
+	mLogLevel = LOG_LEVEL_INFORMATION;
+
+	unsigned int recordCount = 2;
+	while (recordCount < queueSize)
+		recordCount <<= 1;
+
+	mRecords = new LogRecord[recordCount];
+	mRecordMask = recordCount - 1;
+	for (unsigned int i = 0; i < recordCount; ++i)
+	{
+		mRecords[i].sequence.store(i, std::memory_order_relaxed);
+		mRecords[i].longData = nullptr;
+	}
+
+	mEnqueuePosition = 0;
+	mDequeuePosition = 0;
+
+	mWriteBuffer.reserve(LOG_WRITE_BATCH_SIZE);
+
+	mRunning = true;
+	mWriterThread = new std::thread(&Log::writerLoop, this);
+
+	installCrashHandlers();
 }
 
 Log::~Log()
 {
+	removeCrashHandlers();
+
+	mRunning = false;
+	mWakeCondition.notify_one();
+
+	if (mWriterThread != nullptr)
+	{
+		mWriterThread->join();
+		SAFE_DELETE(mWriterThread);
+	}
+
+	// messages published after the writer thread made its last pass
+	flush();
+
+	for (unsigned int i = 0; i <= mRecordMask; ++i)
+		SAFE_DELETE_ARRAY(mRecords[i].longData);
+	SAFE_DELETE_ARRAY(mRecords);
+
 	mLogStream.close();
 }
 
 void Log::logMessage(const std::string& source, const std::string& text, LogLevel logLevel)
 {
-	mLogStream.fill('-');
-	mLogStream.width(20);
-#ifdef _DEBUG
-	std::cerr.fill('-');
-	std::cerr.width(20);
-#endif
+	if (!isLogged(logLevel))
+		return;
+
+	pushMessage(source.c_str(), source.size(), text.c_str(), text.size(), logLevel);
+}
+
+void Log::logMessage(const char* source, const char* text, LogLevel logLevel)
+{
+	if (!isLogged(logLevel))
+		return;
+
+	pushMessage(source, strlen(source), text, strlen(text), logLevel);
+}
+
+void Log::setLogLevel(LogLevel logLevel)
+{
+	mLogLevel = logLevel;
+}
+
+LogLevel Log::getLogLevel() const
+{
+	return mLogLevel;
+}
+
+bool Log::isLogged(LogLevel logLevel) const
+{
+	return logLevel >= mLogLevel && logLevel != LOG_LEVEL_NONE;
+}
+
+void Log::flush()
+{
+	std::lock_guard<std::mutex> lock(mWriteMutex);
+	writeMessages();
+}
+
+void Log::crashFlush()
+{
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	while (!mWriteMutex.try_lock())
+	{
+		if (std::chrono::steady_clock::now() - startTime > std::chrono::milliseconds(LOG_CRASH_FLUSH_MILLISECONDS))
+			return;
+
+		std::this_thread::yield();
+	}
+
+	writeMessages();
+
+	mWriteMutex.unlock();
+}
+
+Log* Log::getInstance()
+{
+	return core::Singleton<Log>::getInstance();
+}
+
+void Log::pushMessage(const char* source, unsigned int sourceLength, const char* text, unsigned int textLength, LogLevel logLevel)
+{
+	LogRecord* pRecord = nullptr;
+
+	// claim a slot, bounded multi producer queue with a sequence number per slot
+	unsigned int position = mEnqueuePosition.load(std::memory_order_relaxed);
+	while (true)
+	{
+		pRecord = &mRecords[position & mRecordMask];
+		int difference = (int)(pRecord->sequence.load(std::memory_order_acquire) - position);
+
+		if (difference == 0)
+		{
+			if (mEnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (difference < 0)
+		{
+			// the queue is full, wait for the writer thread rather than losing the message
+			mWakeCondition.notify_one();
+			std::this_thread::yield();
+			position = mEnqueuePosition.load(std::memory_order_relaxed);
+		}
+		else
+		{
+			position = mEnqueuePosition.load(std::memory_order_relaxed);
+		}
+	}
+
+	pRecord->level = logLevel;
+	pRecord->sourceLength = sourceLength;
+	pRecord->textLength = textLength;
+
+	char* pData = pRecord->data;
+	if (sourceLength + textLength > LOG_RECORD_DATA_SIZE)
+	{
+		pRecord->longData = new char[sourceLength + textLength];
+		pData = pRecord->longData;
+	}
+
+	memcpy(pData, source, sourceLength);
+	memcpy(pData + sourceLength, text, textLength);
+
+	pRecord->sequence.store(position + 1, std::memory_order_release);
+
+	// errors are written right away in case the process is about to go down
+	if (logLevel == LOG_LEVEL_ERROR)
+		mWakeCondition.notify_one();
+}
+
+void Log::writeMessages()
+{
+	while (true)
+	{
+		LogRecord& record = mRecords[mDequeuePosition & mRecordMask];
+		if (record.sequence.load(std::memory_order_acquire) != mDequeuePosition + 1)
+			break;
+
+		const char* pData = (record.longData != nullptr) ? record.longData : record.data;
+
+		// source padded to 20 characters with '-'
+		mWriteBuffer.append(pData, record.sourceLength);
+		if (record.sourceLength < 20)
+			mWriteBuffer.append(20 - record.sourceLength, '-');
+		mWriteBuffer += ">";
 
-	mLogStream<<std::left<<source;
 #ifdef _DEBUG
-	std::cerr<<std::left<<source;
+		mErrorBuffer.append(pData, record.sourceLength);
+		if (record.sourceLength < 20)
+			mErrorBuffer.append(20 - record.sourceLength, '-');
+		mErrorBuffer += ">";
 #endif
 
-	mLogStream<<">";
+		switch(record.level)
+		{
+		case LOG_LEVEL_INFORMATION:
+			mWriteBuffer += " ";
 #ifdef _DEBUG
-	std::cerr<<">";
+			mErrorBuffer += " ";
 #endif
-
-	switch(logLevel)
-	{
-	case LOG_LEVEL_INFORMATION:
-		mLogStream<<" "<<text<<std::endl;
+			break;
+		case LOG_LEVEL_WARNING:
+			mWriteBuffer += " (w)";
 #ifdef _DEBUG
-		std::cerr<<" "<<text<<std::endl;
+			mErrorBuffer += " (w) ";
 #endif
-		break;
-	case LOG_LEVEL_WARNING:
-		mLogStream<<" (w)"<<text<<std::endl;
+			break;
+		case LOG_LEVEL_ERROR:
+			mWriteBuffer += " (!)";
 #ifdef _DEBUG
-		std::cerr<<" (w) "<<text<<std::endl;
+			mErrorBuffer += " (!) ";
 #endif
-		break;
-	case LOG_LEVEL_ERROR:
-		mLogStream<<" (!)"<<text<<std::endl;
+			break;
+		}
+
+		mWriteBuffer.append(pData + record.sourceLength, record.textLength);
+		mWriteBuffer += "\n";
 #ifdef _DEBUG
-		std::cerr<<" (!) "<<text<<std::endl;
+		mErrorBuffer.append(pData + record.sourceLength, record.textLength);
+		mErrorBuffer += "\n";
 #endif
-		break;
+
+		SAFE_DELETE_ARRAY(record.longData);
+
+		// hand the slot back to the producers for the next lap
+		record.sequence.store(mDequeuePosition + mRecordMask + 1, std::memory_order_release);
+		mDequeuePosition++;
+
+		if (mWriteBuffer.size() >= LOG_WRITE_BATCH_SIZE)
+		{
+			mLogStream.write(mWriteBuffer.c_str(), mWriteBuffer.size());
+			mWriteBuffer.clear();
+		}
+	}
+
+	if (!mWriteBuffer.empty())
+	{
+		mLogStream.write(mWriteBuffer.c_str(), mWriteBuffer.size());
+		mWriteBuffer.clear();
 	}
 
-	// Flush stcmdream to ensure it is written (incase of a crash, we need log to be up to date)
 	mLogStream.flush();
+
+#ifdef _DEBUG
+	if (!mErrorBuffer.empty())
+	{
+		std::cerr<<mErrorBuffer;
+		mErrorBuffer.clear();
+	}
+#endif
 }
 
-Log* Log::getInstance()
+void Log::writerLoop()
 {
-	return core::Singleton<Log>::getInstance();
+	while (true)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mWriteMutex);
+			writeMessages();
+		}
+
+		if (!mRunning)
+			return;
+
+		std::unique_lock<std::mutex> lock(mWakeMutex);
+		if (mRunning)
+			mWakeCondition.wait_for(lock, std::chrono::milliseconds(LOG_WRITER_WAIT_MILLISECONDS));
+	}
 }
 
 } // end namespace core
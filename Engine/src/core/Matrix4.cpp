@@ -31,18 +31,19 @@ THE SOFTWARE.
 #include <core/Quaternion.h>
 #include <core/Plane3d.h>
 #include <core/Aabox3d.h>
+#include <core/Simd.h>
 
 namespace core
 {
 
 float matrix4::empty = 0;
 
-inline matrix4::matrix4()
+matrix4::matrix4()
 {
 	makeIdentity();
 }
 
-inline matrix4::matrix4(float m00, float m01, float m02, float m03, float m10, float m11, float m12, float m13,
+matrix4::matrix4(float m00, float m01, float m02, float m03, float m10, float m11, float m12, float m13,
                         float m20, float m21, float m22, float m23, float m30, float m31, float m32, float m33)
 {
 	M[0] = m00;
@@ -63,7 +64,7 @@ inline matrix4::matrix4(float m00, float m01, float m02, float m03, float m10, f
 	M[15] = m33;
 }
 
-inline matrix4& matrix4::operator=(const matrix4 &other)
+matrix4& matrix4::operator=(const matrix4 &other)
 {
 	M[ 0] = other.M[ 0];
 	M[ 1] = other.M[ 1];
@@ -125,7 +126,7 @@ const float& matrix4::operator[](unsigned int index) const
 	return M[index]; 
 }
 
-inline bool matrix4::operator==(const matrix4 &other) const
+bool matrix4::operator==(const matrix4 &other) const
 {
 	if( 
 		M[ 0] != other.M[ 0] || M[ 1] != other.M[ 1] || M[ 2] != other.M[ 2] || M[ 3] != other.M[ 3] ||
@@ -136,7 +137,7 @@ inline bool matrix4::operator==(const matrix4 &other) const
 	return true;
 }
 
-inline bool matrix4::operator!=(const matrix4 &other) const
+bool matrix4::operator!=(const matrix4 &other) const
 {
 	if( 
 		M[ 0] == other.M[ 0] || M[ 1] == other.M[ 1] || M[ 2] == other.M[ 2] || M[ 3] == other.M[ 3] ||
@@ -147,67 +148,22 @@ inline bool matrix4::operator!=(const matrix4 &other) const
 	return true;
 }
 
-inline matrix4& matrix4::operator*=(const matrix4& other)
-{	
-	float newMatrix[16];
-	const float *m1 = M, *m2 = other.M;
-
-	newMatrix[ 0] = m1[ 0] * m2[ 0] + m1[ 1] * m2[ 4] + m1[ 2] * m2[ 8] + m1[ 3] * m2[12];
-	newMatrix[ 1] = m1[ 0] * m2[ 1] + m1[ 1] * m2[ 5] + m1[ 2] * m2[ 9] + m1[ 3] * m2[13];
-	newMatrix[ 2] = m1[ 0] * m2[ 2] + m1[ 1] * m2[ 6] + m1[ 2] * m2[10] + m1[ 3] * m2[14];
-	newMatrix[ 3] = m1[ 0] * m2[ 3] + m1[ 1] * m2[ 7] + m1[ 2] * m2[11] + m1[ 3] * m2[15];
-
-	newMatrix[ 4] = m1[ 4] * m2[ 0] + m1[ 5] * m2[ 4] + m1[ 6] * m2[ 8] + m1[ 7] * m2[12];
-	newMatrix[ 5] = m1[ 4] * m2[ 1] + m1[ 5] * m2[ 5] + m1[ 6] * m2[ 9] + m1[ 7] * m2[13];
-	newMatrix[ 6] = m1[ 4] * m2[ 2] + m1[ 5] * m2[ 6] + m1[ 6] * m2[10] + m1[ 7] * m2[14];
-	newMatrix[ 7] = m1[ 4] * m2[ 3] + m1[ 5] * m2[ 7] + m1[ 6] * m2[11] + m1[ 7] * m2[15];
-
-	newMatrix[ 8] = m1[ 8] * m2[ 0] + m1[ 9] * m2[ 4] + m1[10] * m2[ 8] + m1[11] * m2[12];
-	newMatrix[ 9] = m1[ 8] * m2[ 1] + m1[ 9] * m2[ 5] + m1[10] * m2[ 9] + m1[11] * m2[12];
-	newMatrix[10] = m1[ 8] * m2[ 2] + m1[ 9] * m2[ 6] + m1[10] * m2[10] + m1[11] * m2[14];
-	newMatrix[11] = m1[ 8] * m2[ 3] + m1[ 9] * m2[ 7] + m1[10] * m2[11] + m1[11] * m2[14];
-
-	newMatrix[12] = m1[12] * m2[ 0] + m1[13] * m2[ 4] + m1[14] * m2[ 8] + m1[15] * m2[12];
-	newMatrix[13] = m1[12] * m2[ 1] + m1[13] * m2[ 5] + m1[14] * m2[ 9] + m1[15] * m2[13];
-	newMatrix[14] = m1[12] * m2[ 2] + m1[13] * m2[ 6] + m1[14] * m2[10] + m1[15] * m2[14];
-	newMatrix[15] = m1[12] * m2[ 3] + m1[13] * m2[ 7] + m1[14] * m2[11] + m1[15] * m2[15];
-
-	for (int i = 0; i < 16; ++i)
-		M[i] = newMatrix[i];
+matrix4& matrix4::operator*=(const matrix4& other)
+{
+	getMathKernels().multiply(M, other.M, M);
 
 	return *this;
 }
 
-inline matrix4 matrix4::operator*(const matrix4& other) const
+matrix4 matrix4::operator*(const matrix4& other) const
 {
 	matrix4 tmtrx;
-	const float *m1 = M, *m2 = other.M;
-	float *m3 = tmtrx.M;
-
-	m3[ 0] = m1[ 0] * m2[ 0] + m1[ 1] * m2[ 4] + m1[ 2] * m2[ 8] + m1[3] * m2[12];
-	m3[ 1] = m1[ 0] * m2[ 1] + m1[ 1] * m2[ 5] + m1[ 2] * m2[ 9] + m1[3] * m2[13];
-	m3[ 2] = m1[ 0] * m2[ 2] + m1[ 1] * m2[ 6] + m1[ 2] * m2[10] + m1[3] * m2[14];
-	m3[ 3] = m1[ 0] * m2[ 3] + m1[ 1] * m2[ 7] + m1[ 2] * m2[11] + m1[3] * m2[15];
-
-	m3[ 4] = m1[ 4] * m2[ 0] + m1[ 5] * m2[ 4] + m1[ 6] * m2[8] + m1[7] * m2[12];
-	m3[ 5] = m1[ 4] * m2[ 1] + m1[ 5] * m2[ 5] + m1[ 6] * m2[9] + m1[7] * m2[13];
-	m3[ 6] = m1[ 4] * m2[ 2] + m1[ 5] * m2[ 6] + m1[ 6] * m2[10] + m1[7] * m2[14];
-	m3[ 7] = m1[ 4] * m2[ 3] + m1[ 5] * m2[ 7] + m1[ 6] * m2[11] + m1[7] * m2[15];
-
-	m3[ 8] = m1[ 8] * m2[ 0] + m1[ 9] * m2[ 4] + m1[10] * m2[ 8] + m1[11] * m2[12];
-	m3[ 9] = m1[ 8] * m2[ 1] + m1[ 9] * m2[ 5] + m1[10] * m2[ 9] + m1[11] * m2[13];
-	m3[10] = m1[ 8] * m2[ 2] + m1[ 9] * m2[ 6] + m1[10] * m2[10] + m1[11] * m2[14];
-	m3[11] = m1[ 8] * m2[ 3] + m1[ 9] * m2[ 7] + m1[10] * m2[11] + m1[11] * m2[15];
-
-	m3[12] = m1[12] * m2[ 0] + m1[13] * m2[ 4] + m1[14] * m2[ 8] + m1[15] * m2[12];
-	m3[13] = m1[12] * m2[ 1] + m1[13] * m2[ 5] + m1[14] * m2[ 9] + m1[15] * m2[13];
-	m3[14] = m1[12] * m2[ 2] + m1[13] * m2[ 6] + m1[14] * m2[10] + m1[15] * m2[14];
-	m3[15] = m1[12] * m2[ 3] + m1[13] * m2[ 7] + m1[14] * m2[11] + m1[15] * m2[15];
+	getMathKernels().multiply(M, other.M, tmtrx.M);
 
 	return tmtrx;
 }
 
-inline matrix4& matrix4::operator+=(const matrix4& other)
+matrix4& matrix4::operator+=(const matrix4& other)
 {
 	M[ 0] = M[ 0] + other.M[ 0];
 	M[ 1] = M[ 1] + other.M[ 1];
@@ -232,7 +188,7 @@ inline matrix4& matrix4::operator+=(const matrix4& other)
 	return *this;
 }
 
-inline matrix4 matrix4::operator+(const matrix4& other) const
+matrix4 matrix4::operator+(const matrix4& other) const
 {
 	matrix4 r;
 	
@@ -259,7 +215,7 @@ inline matrix4 matrix4::operator+(const matrix4& other) const
 	return r;
 }
 
-inline matrix4& matrix4::operator-=(const matrix4& other)
+matrix4& matrix4::operator-=(const matrix4& other)
 {
 	M[ 0] = M[ 0] - other.M[ 0];
 	M[ 1] = M[ 1] - other.M[ 1];
@@ -284,7 +240,7 @@ inline matrix4& matrix4::operator-=(const matrix4& other)
 	return *this;
 }
 
-inline matrix4 matrix4::operator-(const matrix4& other) const
+matrix4 matrix4::operator-(const matrix4& other) const
 {
 	matrix4 r;
 	
@@ -311,7 +267,7 @@ inline matrix4 matrix4::operator-(const matrix4& other) const
 	return r;
 }
 
-inline matrix4 matrix4::operator- () const
+matrix4 matrix4::operator- () const
 {
 	matrix4 r;
 	
@@ -389,7 +345,7 @@ const float* matrix4::get() const
 	return &M[0];
 }
 
-inline void matrix4::makeIdentity()
+void matrix4::makeIdentity()
 {
 	M[0] = 1.0f;
 	M[1] = 0.0f;
@@ -409,7 +365,7 @@ inline void matrix4::makeIdentity()
 	M[15] = 1.0f;
 }
 
-inline bool matrix4::isIdentity()
+bool matrix4::isIdentity()
 {
 	for (int i = 0; i < 4; ++i)
 	{
@@ -430,7 +386,7 @@ inline bool matrix4::isIdentity()
 	return true;
 }
 
-inline bool matrix4::hasInverse()
+bool matrix4::hasInverse()
 {
 	const matrix4 &m = *this;
 
@@ -443,90 +399,45 @@ inline bool matrix4::hasInverse()
 	return false;
 }
 
-inline matrix4 matrix4::getInverse() const
+matrix4 matrix4::getInverse() const
 {
 	/// Calculates the inverse of this Matrix
-	/// The inverse is calculated using Cramers rule.
-	/// If no inverse exists then 'false' is returned.
-
-	matrix4 temp = *this;
+	/// If no inverse exists then the matrix itself is returned.
 
-	float d = ((*this)(0, 0) * (*this)(1, 1) - (*this)(1, 0) * (*this)(0, 1)) * ((*this)(2, 2) * (*this)(3, 3) - (*this)(3, 2) * (*this)(2, 3))	- ((*this)(0, 0) * (*this)(2, 1) - (*this)(2, 0) * (*this)(0, 1)) * ((*this)(1, 2) * (*this)(3, 3) - (*this)(3, 2) * (*this)(1, 3))
-			+ ((*this)(0, 0) * (*this)(3, 1) - (*this)(3, 0) * (*this)(0, 1)) * ((*this)(1, 2) * (*this)(2, 3) - (*this)(2, 2) * (*this)(1, 3))	+ ((*this)(1, 0) * (*this)(2, 1) - (*this)(2, 0) * (*this)(1, 1)) * ((*this)(0, 2) * (*this)(3, 3) - (*this)(3, 2) * (*this)(0, 3))
-			- ((*this)(1, 0) * (*this)(3, 1) - (*this)(3, 0) * (*this)(1, 1)) * ((*this)(0, 2) * (*this)(2, 3) - (*this)(2, 2) * (*this)(0, 3))	+ ((*this)(2, 0) * (*this)(3, 1) - (*this)(3, 0) * (*this)(2, 1)) * ((*this)(0, 2) * (*this)(1, 3) - (*this)(1, 2) * (*this)(0, 3));
-
-	if (d != 0.f)
-	{
-		d = 1.f / d;
-
-		temp(0, 0) = d * ((*this)(1, 1) * ((*this)(2, 2) * (*this)(3, 3) - (*this)(3, 2) * (*this)(2, 3)) + (*this)(2, 1) * ((*this)(3, 2) * (*this)(1, 3) - (*this)(1, 2) * (*this)(3, 3)) + (*this)(3, 1) * ((*this)(1, 2) * (*this)(2, 3) - (*this)(2, 2) * (*this)(1, 3)));
-		temp(1, 0) = d * ((*this)(1, 2) * ((*this)(2, 0) * (*this)(3, 3) - (*this)(3, 0) * (*this)(2, 3)) + (*this)(2, 2) * ((*this)(3, 0) * (*this)(1, 3) - (*this)(1, 0) * (*this)(3, 3)) + (*this)(3, 2) * ((*this)(1, 0) * (*this)(2, 3) - (*this)(2, 0) * (*this)(1, 3)));
-		temp(2, 0) = d * ((*this)(1, 3) * ((*this)(2, 0) * (*this)(3, 1) - (*this)(3, 0) * (*this)(2, 1)) + (*this)(2, 3) * ((*this)(3, 0) * (*this)(1, 1) - (*this)(1, 0) * (*this)(3, 1)) + (*this)(3, 3) * ((*this)(1, 0) * (*this)(2, 1) - (*this)(2, 0) * (*this)(1, 1)));
-		temp(3, 0) = d * ((*this)(1, 0) * ((*this)(3, 1) * (*this)(2, 2) - (*this)(2, 1) * (*this)(3, 2)) + (*this)(2, 0) * ((*this)(1, 1) * (*this)(3, 2) - (*this)(3, 1) * (*this)(1, 2)) + (*this)(3, 0) * ((*this)(2, 1) * (*this)(1, 2) - (*this)(1, 1) * (*this)(2, 2)));
-		temp(0, 1) = d * ((*this)(2, 1) * ((*this)(0, 2) * (*this)(3, 3) - (*this)(3, 2) * (*this)(0, 3)) + (*this)(3, 1) * ((*this)(2, 2) * (*this)(0, 3) - (*this)(0, 2) * (*this)(2, 3)) + (*this)(0, 1) * ((*this)(3, 2) * (*this)(2, 3) - (*this)(2, 2) * (*this)(3, 3)));
-		temp(1, 1) = d * ((*this)(2, 2) * ((*this)(0, 0) * (*this)(3, 3) - (*this)(3, 0) * (*this)(0, 3)) + (*this)(3, 2) * ((*this)(2, 0) * (*this)(0, 3) - (*this)(0, 0) * (*this)(2, 3)) + (*this)(0, 2) * ((*this)(3, 0) * (*this)(2, 3) - (*this)(2, 0) * (*this)(3, 3)));
-		temp(2, 1) = d * ((*this)(2, 3) * ((*this)(0, 0) * (*this)(3, 1) - (*this)(3, 0) * (*this)(0, 1)) + (*this)(3, 3) * ((*this)(2, 0) * (*this)(0, 1) - (*this)(0, 0) * (*this)(2, 1)) + (*this)(0, 3) * ((*this)(3, 0) * (*this)(2, 1) - (*this)(2, 0) * (*this)(3, 1)));
-		temp(3, 1) = d * ((*this)(2, 0) * ((*this)(3, 1) * (*this)(0, 2) - (*this)(0, 1) * (*this)(3, 2)) + (*this)(3, 0) * ((*this)(0, 1) * (*this)(2, 2) - (*this)(2, 1) * (*this)(0, 2)) + (*this)(0, 0) * ((*this)(2, 1) * (*this)(3, 2) - (*this)(3, 1) * (*this)(2, 2)));
-		temp(0, 2) = d * ((*this)(3, 1) * ((*this)(0, 2) * (*this)(1, 3) - (*this)(1, 2) * (*this)(0, 3)) + (*this)(0, 1) * ((*this)(1, 2) * (*this)(3, 3) - (*this)(3, 2) * (*this)(1, 3)) + (*this)(1, 1) * ((*this)(3, 2) * (*this)(0, 3) - (*this)(0, 2) * (*this)(3, 3)));
-		temp(1, 2) = d * ((*this)(3, 2) * ((*this)(0, 0) * (*this)(1, 3) - (*this)(1, 0) * (*this)(0, 3)) + (*this)(0, 2) * ((*this)(1, 0) * (*this)(3, 3) - (*this)(3, 0) * (*this)(1, 3)) + (*this)(1, 2) * ((*this)(3, 0) * (*this)(0, 3) - (*this)(0, 0) * (*this)(3, 3)));
-		temp(2, 2) = d * ((*this)(3, 3) * ((*this)(0, 0) * (*this)(1, 1) - (*this)(1, 0) * (*this)(0, 1)) + (*this)(0, 3) * ((*this)(1, 0) * (*this)(3, 1) - (*this)(3, 0) * (*this)(1, 1)) + (*this)(1, 3) * ((*this)(3, 0) * (*this)(0, 1) - (*this)(0, 0) * (*this)(3, 1)));
-		temp(3, 2) = d * ((*this)(3, 0) * ((*this)(1, 1) * (*this)(0, 2) - (*this)(0, 1) * (*this)(1, 2)) + (*this)(0, 0) * ((*this)(3, 1) * (*this)(1, 2) - (*this)(1, 1) * (*this)(3, 2)) + (*this)(1, 0) * ((*this)(0, 1) * (*this)(3, 2) - (*this)(3, 1) * (*this)(0, 2)));
-		temp(0, 3) = d * ((*this)(0, 1) * ((*this)(2, 2) * (*this)(1, 3) - (*this)(1, 2) * (*this)(2, 3)) + (*this)(1, 1) * ((*this)(0, 2) * (*this)(2, 3) - (*this)(2, 2) * (*this)(0, 3)) + (*this)(2, 1) * ((*this)(1, 2) * (*this)(0, 3) - (*this)(0, 2) * (*this)(1, 3)));
-		temp(1, 3) = d * ((*this)(0, 2) * ((*this)(2, 0) * (*this)(1, 3) - (*this)(1, 0) * (*this)(2, 3)) + (*this)(1, 2) * ((*this)(0, 0) * (*this)(2, 3) - (*this)(2, 0) * (*this)(0, 3)) + (*this)(2, 2) * ((*this)(1, 0) * (*this)(0, 3) - (*this)(0, 0) * (*this)(1, 3)));
-		temp(2, 3) = d * ((*this)(0, 3) * ((*this)(2, 0) * (*this)(1, 1) - (*this)(1, 0) * (*this)(2, 1)) + (*this)(1, 3) * ((*this)(0, 0) * (*this)(2, 1) - (*this)(2, 0) * (*this)(0, 1)) + (*this)(2, 3) * ((*this)(1, 0) * (*this)(0, 1) - (*this)(0, 0) * (*this)(1, 1)));
-		temp(3, 3) = d * ((*this)(0, 0) * ((*this)(1, 1) * (*this)(2, 2) - (*this)(2, 1) * (*this)(1, 2)) + (*this)(1, 0) * ((*this)(2, 1) * (*this)(0, 2) - (*this)(0, 1) * (*this)(2, 2)) + (*this)(2, 0) * ((*this)(0, 1) * (*this)(1, 2) - (*this)(1, 1) * (*this)(0, 2)));
-	}
+	matrix4 temp;
+	getMathKernels().inverse(M, temp.M);
 
 	return temp;
 }
 
-inline matrix4 matrix4::getTransposed() const
+matrix4 matrix4::getTransposed() const
 {
 	matrix4 temp;
-	
-	temp[ 0] = M[ 0];
-	temp[ 1] = M[ 4];
-	temp[ 2] = M[ 8];
-	temp[ 3] = M[12];
-
-	temp[ 4] = M[ 1];
-	temp[ 5] = M[ 5];
-	temp[ 6] = M[ 9];
-	temp[ 7] = M[13];
-
-	temp[ 8] = M[ 2];
-	temp[ 9] = M[ 6];
-	temp[10] = M[10];
-	temp[11] = M[14];
-
-	temp[12] = M[ 3];
-	temp[13] = M[ 7];
-	temp[14] = M[11];
-	temp[15] = M[15];
+	getMathKernels().transpose(M, temp.M);
 
 	return temp;
 }
 
-inline void matrix4::setTranslation(const vector3d& translation)
+void matrix4::setTranslation(const vector3d& translation)
 {
 	M[ 3] = translation.x;
 	M[ 7] = translation.y;
 	M[11] = translation.z;
 }
 
-inline vector3d matrix4::getTranslation() const
+vector3d matrix4::getTranslation() const
 {	
 	return vector3d(M[ 3], M[ 7], M[11]);
 }
 
-inline void matrix4::setInverseTranslation(const vector3d& translation)
+void matrix4::setInverseTranslation(const vector3d& translation)
 {
 	M[ 3] = -translation.x;
 	M[ 7] = -translation.y;
 	M[11] = -translation.z;
 }
 
-inline void matrix4::setRotationRadians(const vector3d& rotation)
+void matrix4::setRotationRadians(const vector3d& rotation)
 {
 	// preserve scale
 	vector3d scale = getScale();
@@ -557,12 +468,12 @@ inline void matrix4::setRotationRadians(const vector3d& rotation)
 	setScale(scale);
 }
 
-inline void matrix4::setRotationDegrees(const vector3d& rotation)
+void matrix4::setRotationDegrees(const vector3d& rotation)
 {
 	setRotationRadians(rotation * DEGTORAD);
 }
 
-inline vector3d matrix4::getRotationDegrees() const
+vector3d matrix4::getRotationDegrees() const
 {
 	const matrix4 &mat = *this;
 
@@ -600,7 +511,7 @@ inline vector3d matrix4::getRotationDegrees() const
 	return vector3d((float)X, (float)Y, (float)Z);
 }
 
-inline void matrix4::setInverseRotationRadians(const vector3d& rotation)
+void matrix4::setInverseRotationRadians(const vector3d& rotation)
 {
 	// preserve scale
 	vector3d scale = getScale();
@@ -631,12 +542,12 @@ inline void matrix4::setInverseRotationRadians(const vector3d& rotation)
 	setScale(scale);
 }
 
-inline void matrix4::setInverseRotationDegrees(const vector3d& rotation)
+void matrix4::setInverseRotationDegrees(const vector3d& rotation)
 {
 	setInverseRotationRadians(rotation * DEGTORAD);
 }
 
-inline void matrix4::setScale(const vector3d& scale)
+void matrix4::setScale(const vector3d& scale)
 {
 	M[ 0] *= scale.x;
 	M[ 4] *= scale.x;
@@ -651,7 +562,7 @@ inline void matrix4::setScale(const vector3d& scale)
 	M[10] *= scale.z;
 }
 
-inline vector3d matrix4::getScale() const
+vector3d matrix4::getScale() const
 {
 	vector3d scale;
 
@@ -662,7 +573,7 @@ inline vector3d matrix4::getScale() const
 	return scale;
 }
 
-inline void matrix4::setInverseScale(const vector3d& scale)
+void matrix4::setInverseScale(const vector3d& scale)
 {
 	M[ 0] /= scale.x;
 	M[ 4] /= scale.x;
@@ -677,21 +588,21 @@ inline void matrix4::setInverseScale(const vector3d& scale)
 	M[10] /= scale.z;
 }
 
-inline void matrix4::translateVector(vector3d& vect) const
+void matrix4::translateVector(vector3d& vect) const
 {
 	vect.x = vect.x + M[ 3];
 	vect.y = vect.y + M[ 7];
 	vect.z = vect.z + M[11];
 }
 
-inline void matrix4::inverseTranslateVector(vector3d& vect) const
+void matrix4::inverseTranslateVector(vector3d& vect) const
 {
 	vect.x = vect.x - M[ 3];
 	vect.y = vect.y - M[ 7];
 	vect.z = vect.z - M[11];
 }
 
-inline void matrix4::rotateVector(vector3d& vect) const
+void matrix4::rotateVector(vector3d& vect) const
 {
 	vector3d tmp = vect;
 
@@ -700,7 +611,7 @@ inline void matrix4::rotateVector(vector3d& vect) const
 	vect.z = M[ 8] * tmp.x + M[ 9] * tmp.y + M[10] * tmp.z + M[11];
 }
 
-inline void matrix4::inverseRotateVect(vector3d& vect) const
+void matrix4::inverseRotateVect(vector3d& vect) const
 {
 	vector3d tmp = vect;
 
@@ -709,50 +620,59 @@ inline void matrix4::inverseRotateVect(vector3d& vect) const
 	vect.z = M[ 2] * tmp.x + M[ 6] * tmp.y + M[10] * tmp.z + M[11];
 }
 
-inline void matrix4::transformVector(vector3d& vect) const
+void matrix4::transformVector(vector3d& vect) const
 {
-	float vector[3];
+	getMathKernels().transformPoints(M, &vect.x, &vect.x, 1, 3);
+}
 
-	vector[0] = M[ 0] * vect.x + M[ 1] * vect.y + M[ 2] * vect.z + M[ 3];
-	vector[1] = M[ 4] * vect.x + M[ 5] * vect.y + M[ 6] * vect.z + M[ 7];
-	vector[2] = M[ 8] * vect.x + M[ 9] * vect.y + M[10] * vect.z + M[11];
+void matrix4::transformVector(const vector3d& in, vector3d& out) const
+{	
+	getMathKernels().transformPoints(M, &in.x, &out.x, 1, 3);
+}
 
-	vect.x = vector[0];
-	vect.y = vector[1];
-	vect.z = vector[2];
+void matrix4::transformVector(vector4d& vect) const
+{
+	getMathKernels().transformVectors(M, &vect.x, &vect.x, 1);
 }
 
-inline void matrix4::transformVector(const vector3d& in, vector3d& out) const
+void matrix4::transformVector(const vector4d& in, vector4d& out) const
 {	
-	out.x = M[ 0] * in.x + M[ 1] * in.y + M[ 2] * in.z + M[ 3];
-	out.y = M[ 4] * in.x + M[ 5] * in.y + M[ 6] * in.z + M[ 7];
-	out.z = M[ 8] * in.x + M[ 9] * in.y + M[10] * in.z + M[11];
+	getMathKernels().transformVectors(M, &in.x, &out.x, 1);
 }
 
-inline void matrix4::transformVector(vector4d& vect) const
+void matrix4::transformVectors(const vector3d* in, vector3d* out, unsigned int count) const
 {
-	float vector[4];
+	if (in == nullptr || out == nullptr || count == 0)
+		return;
+
+	getMathKernels().transformPoints(M, &in[0].x, &out[0].x, count, sizeof(vector3d) / sizeof(float));
+}
 
-	vector[0] = M[ 0] * vect.x + M[ 1] * vect.y + M[ 2] * vect.z + M[ 3] * vect.w;
-	vector[1] = M[ 4] * vect.x + M[ 5] * vect.y + M[ 6] * vect.z + M[ 7] * vect.w;
-	vector[2] = M[ 8] * vect.x + M[ 9] * vect.y + M[10] * vect.z + M[11] * vect.w;
-	vector[3] = M[12] * vect.x + M[13] * vect.y + M[14] * vect.z + M[15] * vect.w;
+void matrix4::transformVectors(const vector4d* in, vector4d* out, unsigned int count) const
+{
+	if (in == nullptr || out == nullptr || count == 0)
+		return;
 
-	vect.x = vector[0];
-	vect.y = vector[1];
-	vect.z = vector[2];
-	vect.w = vector[3];
+	getMathKernels().transformVectors(M, &in[0].x, &out[0].x, count);
 }
 
-inline void matrix4::transformVector(const vector4d& in, vector4d& out) const
-{	
-	out.x = M[ 0] * in.x + M[ 1] * in.y + M[ 2] * in.z + M[ 3] * in.w;
-	out.y = M[ 4] * in.x + M[ 5] * in.y + M[ 6] * in.z + M[ 7] * in.w;
-	out.z = M[ 8] * in.x + M[ 9] * in.y + M[10] * in.z + M[11] * in.w;
-	out.w = M[12] * in.x + M[13] * in.y + M[14] * in.z + M[15] * in.w;
+void matrix4::multiplyMatrices(const matrix4* in, matrix4* out, unsigned int count) const
+{
+	if (in == nullptr || out == nullptr || count == 0)
+		return;
+
+	getMathKernels().multiplyBatch(M, in[0].M, out[0].M, count, true);
+}
+
+void matrix4::postMultiplyMatrices(const matrix4* in, matrix4* out, unsigned int count) const
+{
+	if (in == nullptr || out == nullptr || count == 0)
+		return;
+
+	getMathKernels().multiplyBatch(M, in[0].M, out[0].M, count, false);
 }
 
-inline void matrix4::transformPlane(plane3d &plane) const
+void matrix4::transformPlane(plane3d &plane) const
 {
 	vector3d member;
 	transformVector(plane.getMemberPoint(), member);
@@ -765,13 +685,13 @@ inline void matrix4::transformPlane(plane3d &plane) const
 	plane.D = - member.dotProduct(plane.Normal);
 }
 
-inline void matrix4::transformPlane(const plane3d &in, plane3d &out) const
+void matrix4::transformPlane(const plane3d &in, plane3d &out) const
 {
 	out = in;
 	transformPlane(out);
 }
 
-inline void matrix4::transformBox(aabox3d& box) const
+void matrix4::transformBox(aabox3d& box) const
 {
 	core::vector3d edges[8];
 	box.getEdges(edges);
@@ -786,7 +706,7 @@ inline void matrix4::transformBox(aabox3d& box) const
 		box.addInternalPoint(edges[i]);
 }
 
-inline void matrix4::buildProjectionMatrixInfinitePerspectiveFov(float fieldOfViewRadians, float aspectRatio, float zNear)
+void matrix4::buildProjectionMatrixInfinitePerspectiveFov(float fieldOfViewRadians, float aspectRatio, float zNear)
 {
 	float h = (float)tan(fieldOfViewRadians / 2);
 	float w = h * aspectRatio;
@@ -812,7 +732,7 @@ inline void matrix4::buildProjectionMatrixInfinitePerspectiveFov(float fieldOfVi
 	M[15] = 0.0f;
 }
 
-inline void matrix4::buildProjectionMatrixPerspectiveFov(float fieldOfViewRadians, float aspectRatio, float zNear, float zFar)
+void matrix4::buildProjectionMatrixPerspectiveFov(float fieldOfViewRadians, float aspectRatio, float zNear, float zFar)
 {
 	float h = (float)tan(fieldOfViewRadians / 2);
 	float w = h * aspectRatio;
@@ -838,7 +758,7 @@ inline void matrix4::buildProjectionMatrixPerspectiveFov(float fieldOfViewRadian
 	M[15] = 0.0f;
 }
 
-inline void matrix4::buildProjectionMatrixPerspective(float widthOfViewVolume, float heightOfViewVolume, float zNear, float zFar)
+void matrix4::buildProjectionMatrixPerspective(float widthOfViewVolume, float heightOfViewVolume, float zNear, float zFar)
 {	
 	M[ 0] = 2.0f * zNear / widthOfViewVolume;
 	M[ 1] = 0.0f;
@@ -861,7 +781,7 @@ inline void matrix4::buildProjectionMatrixPerspective(float widthOfViewVolume, f
 	M[15] = 0.0f;
 }
 
-inline void matrix4::buildProjectionMatrixOrtho(float widthOfViewVolume, float heightOfViewVolume, float zNear, float zFar)
+void matrix4::buildProjectionMatrixOrtho(float widthOfViewVolume, float heightOfViewVolume, float zNear, float zFar)
 {	
 	M[ 0] = 2.0f / widthOfViewVolume;
 	M[ 1] = 0.0f;
@@ -884,7 +804,7 @@ inline void matrix4::buildProjectionMatrixOrtho(float widthOfViewVolume, float h
 	M[15] = 1.0f;
 }
 
-inline void matrix4::buildProjectionMatrixOrtho(float left, float right, float bottom, float top, float zNear, float zFar)
+void matrix4::buildProjectionMatrixOrtho(float left, float right, float bottom, float top, float zNear, float zFar)
 {	
 	M[ 0] = 2.0f / (right - left);
 	M[ 1] = 0.0f;
@@ -907,7 +827,7 @@ inline void matrix4::buildProjectionMatrixOrtho(float left, float right, float b
 	M[15] = 1.0f;
 }
 
-inline void matrix4::buildViewMatrix(const vector3d& position, const vector3d& target, const vector3d& upVector)
+void matrix4::buildViewMatrix(const vector3d& position, const vector3d& target, const vector3d& upVector)
 {
 	vector3d zaxis = position - target;
 	zaxis.normalize();
@@ -974,7 +894,7 @@ void matrix4::buildWorldMatrix(const vector3d& position, const vector3d& scale,
 	(*this)(3,3) = 1;
 }
 
-inline void matrix4::buildShadowMatrix(vector3d light, plane3d plane, float point)
+void matrix4::buildShadowMatrix(vector3d light, plane3d plane, float point)
 {
 	plane.Normal.normalize();
 	float d = plane.Normal.dotProduct(light);
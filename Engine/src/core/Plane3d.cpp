@@ -52,12 +52,12 @@ plane3d::plane3d(const vector3d& point1, const vector3d& point2, const vector3d&
 	setPlane(point1, point2, point3);
 }
 
-inline bool plane3d::operator==(const plane3d& other) const
+bool plane3d::operator==(const plane3d& other) const
 {
 	return ((other.Normal == Normal) && (other.D + EPSILON > D) && (other.D - EPSILON < D));
 }
 
-inline bool plane3d::operator!=(const plane3d& other) const
+bool plane3d::operator!=(const plane3d& other) const
 {
 	return ((other.Normal != Normal) || (other.D + EPSILON < D) || (other.D - EPSILON > D));
 }
@@ -0,0 +1,671 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <core/Profiler.h>
+#include <core/Log.h>
+#include <core/Utils.h>
+
+#include <atomic>
+#include <stdio.h>
+
+// The engine library is loaded with the executable, its thread locals can use the static model
+// instead of a __tls_get_addr call on every zone
+#if ENGINE_COMPILER == COMPILER_MSVC
+#	define PROFILER_THREAD_LOCAL __declspec(thread)
+#else
+#	define PROFILER_THREAD_LOCAL __thread __attribute__((tls_model("initial-exec")))
+#endif
+
+// The time stamp counter is read in a few cycles, it is converted to seconds against the reference clock
+#if ENGINE_COMPILER == COMPILER_MSVC && (defined(_M_IX86) || defined(_M_X64))
+#	include <intrin.h>
+#	define PROFILER_TIME_STAMP_COUNTER
+#elif ENGINE_COMPILER == COMPILER_GNUC && (defined(__i386__) || defined(__x86_64__))
+#	include <x86intrin.h>
+#	define PROFILER_TIME_STAMP_COUNTER
+#endif
+
+#if ENGINE_PLATFORM == PLATFORM_WINDOWS
+#	include <windows.h>
+#else
+#	include <chrono>
+#endif
+
+template<> core::Profiler* core::Singleton<core::Profiler>::m_Singleton = nullptr;
+
+namespace core
+{
+
+#define PROFILER_MAX_DEPTH 64
+#define PROFILER_NO_PARENT 0x00ffffff
+
+//! Kept small, writing the records is most of the cost of a zone.
+struct ProfileRecord
+{
+	unsigned long long begin;
+	unsigned long long end;
+	unsigned int zone;
+	//! Parent zone in the low 24 bits, depth in the high 8 bits.
+	unsigned int parentDepth;
+};
+
+struct ProfileStackEntry
+{
+	unsigned long long begin;
+	unsigned int zone;
+};
+
+//! Single producer, single consumer ring: the owning thread advances head, endFrame advances tail.
+struct ProfileThreadBuffer
+{
+	std::string name;
+
+	ProfileRecord* records;
+	unsigned int mask;
+
+	std::atomic<unsigned int> head;
+	std::atomic<unsigned int> tail;
+
+	//! Head at which the ring is full for the last tail read, only used by the owning thread.
+	unsigned int limit;
+
+	ProfileStackEntry stack[PROFILER_MAX_DEPTH];
+	unsigned int depth;
+
+	//! Time of the collected zones per depth whose parent was not collected yet, only used by endFrame.
+	unsigned long long childTicks[PROFILER_MAX_DEPTH + 1];
+
+	//! Zones that did not fit, only written by the owning thread.
+	std::atomic<unsigned int> dropped;
+	unsigned int collectedDropped;
+};
+
+static PROFILER_THREAD_LOCAL ProfileThreadBuffer* gThreadBuffer = nullptr;
+static PROFILER_THREAD_LOCAL unsigned int gThreadGeneration = 0;
+
+static std::atomic<unsigned int> gProfilerGeneration(0);
+
+//! Reads the raw counter, kept local so the zone path does not call the exported getTicks.
+static inline unsigned long long readTicks()
+{
+#if defined(PROFILER_TIME_STAMP_COUNTER)
+	return __rdtsc();
+#else
+	return (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+static std::string escapeJson(const std::string& str)
+{
+	std::string result;
+	result.reserve(str.size());
+
+	for (unsigned int i = 0; i < str.size(); ++i)
+	{
+		char c = str[i];
+		if (c == '"' || c == '\\')
+		{
+			result += '\\';
+			result += c;
+		}
+		else if ((unsigned char)c < 0x20)
+		{
+			result += ' ';
+		}
+		else
+		{
+			result += c;
+		}
+	}
+
+	return result;
+}
+
+Profiler::Profiler()
+{
+	mEnabled = true;
+
+	mThreadBufferSize = 16384;
+	mStatsFrameCount = 120;
+
+	mFrameCount = 0;
+	mHistoryIndex = 0;
+
+	mStartTicks = getTicks();
+	mStartSeconds = getSeconds();
+	mTicksPerSecond = 1000000000.0;
+
+	mCapturing = false;
+
+	mDroppedZones = 0;
+
+	// a thread buffer left by a previous profiler is replaced on the next zone
+	mGeneration = ++gProfilerGeneration;
+}
+
+Profiler::~Profiler()
+{
+	std::vector<ProfileThreadBuffer*>::iterator i;
+	for (i = mThreadBuffers.begin(); i != mThreadBuffers.end(); ++i)
+	{
+		SAFE_DELETE_ARRAY((*i)->records);
+		SAFE_DELETE(*i);
+	}
+	mThreadBuffers.clear();
+
+	std::vector<ZoneData*>::iterator j;
+	for (j = mZones.begin(); j != mZones.end(); ++j)
+	{
+		SAFE_DELETE(*j);
+	}
+	mZones.clear();
+	mZoneIndices.clear();
+}
+
+void Profiler::setEnabled(bool enabled)
+{
+	mEnabled = enabled;
+}
+
+bool Profiler::isEnabled() const
+{
+	return mEnabled;
+}
+
+void Profiler::setThreadBufferSize(unsigned int size)
+{
+	unsigned int bufferSize = 1;
+	while (bufferSize < size)
+		bufferSize <<= 1;
+
+	mThreadBufferSize = bufferSize;
+}
+
+unsigned int Profiler::getThreadBufferSize() const
+{
+	return mThreadBufferSize;
+}
+
+void Profiler::setStatsFrameCount(unsigned int frames)
+{
+	if (frames == 0)
+		frames = 1;
+
+	std::lock_guard<std::mutex> lock(mZoneMutex);
+
+	mStatsFrameCount = frames;
+	mHistoryIndex = 0;
+
+	std::vector<ZoneData*>::iterator i;
+	for (i = mZones.begin(); i != mZones.end(); ++i)
+	{
+		(*i)->frames = 0;
+		(*i)->times.assign(mStatsFrameCount, 0.0f);
+		(*i)->selfTimes.assign(mStatsFrameCount, 0.0f);
+	}
+}
+
+unsigned int Profiler::getStatsFrameCount() const
+{
+	return mStatsFrameCount;
+}
+
+void Profiler::setThreadName(const std::string& name)
+{
+	ProfileThreadBuffer* pBuffer = getThreadBuffer();
+
+	std::lock_guard<std::mutex> lock(mThreadMutex);
+	pBuffer->name = name;
+}
+
+unsigned int Profiler::registerZone(const char* name)
+{
+	std::string zoneName = (name != nullptr) ? name : "";
+
+	std::lock_guard<std::mutex> lock(mZoneMutex);
+
+	hashmap<std::string, unsigned int>::const_iterator i = mZoneIndices.find(zoneName);
+	if (i != mZoneIndices.end())
+		return i->second;
+
+	unsigned int zone = mZones.size();
+	mZones.push_back(createZone(zoneName));
+	mZoneIndices[zoneName] = zone;
+
+	return zone;
+}
+
+void Profiler::endFrame()
+{
+	double ticksPerSecond = getTicksPerSecond();
+
+	std::lock_guard<std::mutex> threadLock(mThreadMutex);
+	std::lock_guard<std::mutex> zoneLock(mZoneMutex);
+
+	for (unsigned int i = 0; i < mThreadBuffers.size(); ++i)
+	{
+		collect(mThreadBuffers[i], i);
+	}
+
+	double millisecondsPerTick = 1000.0 / ticksPerSecond;
+
+	std::vector<ZoneData*>::iterator i;
+	for (i = mZones.begin(); i != mZones.end(); ++i)
+	{
+		ZoneData* pZone = (*i);
+
+		pZone->calls = pZone->frameCalls;
+		pZone->times[mHistoryIndex] = (float)(pZone->frameTicks * millisecondsPerTick);
+		pZone->selfTimes[mHistoryIndex] = (float)(pZone->frameSelfTicks * millisecondsPerTick);
+		if (pZone->frames < mStatsFrameCount)
+			pZone->frames++;
+
+		pZone->frameCalls = 0;
+		pZone->frameTicks = 0;
+		pZone->frameSelfTicks = 0;
+	}
+
+	mHistoryIndex = (mHistoryIndex + 1) % mStatsFrameCount;
+
+	if (mCapturing)
+		mCapturedFrames.push_back(getTicks());
+
+	mFrameCount++;
+}
+
+unsigned int Profiler::getFrameCount() const
+{
+	return mFrameCount;
+}
+
+unsigned int Profiler::getDroppedZoneCount() const
+{
+	return mDroppedZones;
+}
+
+unsigned int Profiler::getZoneCount() const
+{
+	std::lock_guard<std::mutex> lock(mZoneMutex);
+	return mZones.size();
+}
+
+bool Profiler::getZoneStats(unsigned int zone, ProfileZoneStats& stats) const
+{
+	std::lock_guard<std::mutex> lock(mZoneMutex);
+
+	if (zone >= mZones.size())
+		return false;
+
+	const ZoneData* pZone = mZones[zone];
+
+	stats.name = pZone->name;
+	stats.parent = pZone->parent;
+	stats.depth = pZone->depth;
+	stats.calls = pZone->calls;
+
+	stats.lastTime = 0.0f;
+	stats.averageTime = 0.0f;
+	stats.bestTime = 0.0f;
+	stats.worstTime = 0.0f;
+	stats.lastSelfTime = 0.0f;
+	stats.averageSelfTime = 0.0f;
+
+	if (pZone->frames == 0)
+		return true;
+
+	// the history is a ring, the last frame is right before mHistoryIndex
+	for (unsigned int i = 0; i < pZone->frames; ++i)
+	{
+		unsigned int index = (mHistoryIndex + mStatsFrameCount - 1 - i) % mStatsFrameCount;
+		float time = pZone->times[index];
+		float selfTime = pZone->selfTimes[index];
+
+		if (i == 0)
+		{
+			stats.lastTime = time;
+			stats.lastSelfTime = selfTime;
+			stats.bestTime = time;
+			stats.worstTime = time;
+		}
+
+		if (time < stats.bestTime) stats.bestTime = time;
+		if (time > stats.worstTime) stats.worstTime = time;
+
+		stats.averageTime += time;
+		stats.averageSelfTime += selfTime;
+	}
+
+	stats.averageTime /= pZone->frames;
+	stats.averageSelfTime /= pZone->frames;
+
+	return true;
+}
+
+bool Profiler::getZoneStats(const std::string& name, ProfileZoneStats& stats) const
+{
+	unsigned int zone = 0;
+	{
+		std::lock_guard<std::mutex> lock(mZoneMutex);
+
+		hashmap<std::string, unsigned int>::const_iterator i = mZoneIndices.find(name);
+		if (i == mZoneIndices.end())
+			return false;
+
+		zone = i->second;
+	}
+
+	return getZoneStats(zone, stats);
+}
+
+void Profiler::startCapture()
+{
+	mCapturing = true;
+}
+
+void Profiler::stopCapture()
+{
+	mCapturing = false;
+}
+
+bool Profiler::isCapturing() const
+{
+	return mCapturing;
+}
+
+void Profiler::clearCapture()
+{
+	mCapturedZones.clear();
+	mCapturedFrames.clear();
+}
+
+unsigned int Profiler::getCapturedZoneCount() const
+{
+	return mCapturedZones.size();
+}
+
+bool Profiler::exportChromeTrace(const std::string& filename)
+{
+	FILE* pFile = fopen(filename.c_str(), "w");
+	if (pFile == nullptr)
+	{
+		if (Log::getInstance() != nullptr) Log::getInstance()->logMessage("Profiler", "Could not open trace file: " + filename, LOG_LEVEL_ERROR);
+		return false;
+	}
+
+	double microsecondsPerTick = 1000000.0 / getTicksPerSecond();
+
+	std::vector<std::string> zoneNames;
+	{
+		std::lock_guard<std::mutex> lock(mZoneMutex);
+
+		zoneNames.resize(mZones.size());
+		for (unsigned int i = 0; i < mZones.size(); ++i)
+			zoneNames[i] = escapeJson(mZones[i]->name);
+	}
+
+	fprintf(pFile, "{\"traceEvents\":[\n");
+
+	bool first = true;
+	{
+		std::lock_guard<std::mutex> lock(mThreadMutex);
+
+		for (unsigned int i = 0; i < mThreadBuffers.size(); ++i)
+		{
+			fprintf(pFile, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", first ? "" : ",\n", i, escapeJson(mThreadBuffers[i]->name).c_str());
+			first = false;
+		}
+	}
+
+	std::vector<unsigned long long>::const_iterator i;
+	for (i = mCapturedFrames.begin(); i != mCapturedFrames.end(); ++i)
+	{
+		double timestamp = (double)((*i) - mStartTicks) * microsecondsPerTick;
+
+		fprintf(pFile, "%s{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":%.3f}", first ? "" : ",\n", timestamp);
+		first = false;
+	}
+
+	std::vector<CapturedZone>::const_iterator j;
+	for (j = mCapturedZones.begin(); j != mCapturedZones.end(); ++j)
+	{
+		double timestamp = (double)(j->begin - mStartTicks) * microsecondsPerTick;
+		double duration = (double)(j->end - j->begin) * microsecondsPerTick;
+
+		fprintf(pFile, "%s{\"name\":\"%s\",\"cat\":\"engine\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", first ? "" : ",\n", zoneNames[j->zone].c_str(), j->thread, timestamp, duration);
+		first = false;
+	}
+
+	fprintf(pFile, "\n]}\n");
+
+	bool result = (ferror(pFile) == 0);
+	fclose(pFile);
+
+	if (!result)
+	{
+		if (Log::getInstance() != nullptr) Log::getInstance()->logMessage("Profiler", "Could not write trace file: " + filename, LOG_LEVEL_ERROR);
+	}
+
+	return result;
+}
+
+ProfileThreadBuffer* Profiler::beginZone(ProfileZone& zone)
+{
+	Profiler* pProfiler = m_Singleton;
+	if (pProfiler == nullptr || !pProfiler->mEnabled)
+		return nullptr;
+
+	// registering is locked and returns the same id for the same name, threads racing here store the same value,
+	// the generation is published after the id so a matching one always comes with an id of this profiler
+	int id = 0;
+	if (zone.generation.load(std::memory_order_acquire) == pProfiler->mGeneration)
+	{
+		id = zone.id.load(std::memory_order_relaxed);
+	}
+	else
+	{
+		id = (int)pProfiler->registerZone(zone.name);
+		zone.id.store(id, std::memory_order_relaxed);
+		zone.generation.store(pProfiler->mGeneration, std::memory_order_release);
+	}
+
+	ProfileThreadBuffer* pBuffer = gThreadBuffer;
+	if (pBuffer == nullptr || gThreadGeneration != pProfiler->mGeneration)
+		pBuffer = pProfiler->getThreadBuffer();
+
+	if (pBuffer->depth < PROFILER_MAX_DEPTH)
+	{
+		ProfileStackEntry& entry = pBuffer->stack[pBuffer->depth];
+		entry.zone = (unsigned int)id;
+		entry.begin = readTicks();
+	}
+
+	pBuffer->depth++;
+
+	return pBuffer;
+}
+
+void Profiler::endZone(ProfileThreadBuffer* buffer)
+{
+	unsigned long long end = readTicks();
+
+	unsigned int depth = --buffer->depth;
+	if (depth >= PROFILER_MAX_DEPTH)
+	{
+		buffer->dropped.store(buffer->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		return;
+	}
+
+	const ProfileStackEntry& entry = buffer->stack[depth];
+
+	// the tail written by endFrame is only read again once the space seen last time is used up
+	unsigned int head = buffer->head.load(std::memory_order_relaxed);
+	if (head == buffer->limit)
+	{
+		buffer->limit = buffer->tail.load(std::memory_order_acquire) + buffer->mask + 1;
+		if (head == buffer->limit)
+		{
+			buffer->dropped.store(buffer->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			return;
+		}
+	}
+
+	ProfileRecord& record = buffer->records[head & buffer->mask];
+	record.begin = entry.begin;
+	record.end = end;
+	record.zone = entry.zone;
+	record.parentDepth = ((depth > 0) ? buffer->stack[depth - 1].zone : PROFILER_NO_PARENT) | (depth << 24);
+
+	buffer->head.store(head + 1, std::memory_order_release);
+}
+
+ProfileThreadBuffer* Profiler::getThreadBuffer()
+{
+	if (gThreadBuffer != nullptr && gThreadGeneration == mGeneration)
+		return gThreadBuffer;
+
+	ProfileThreadBuffer* pBuffer = new ProfileThreadBuffer();
+	pBuffer->records = new ProfileRecord[mThreadBufferSize];
+	pBuffer->mask = mThreadBufferSize - 1;
+	pBuffer->head = 0;
+	pBuffer->tail = 0;
+	pBuffer->limit = mThreadBufferSize;
+	pBuffer->depth = 0;
+	for (unsigned int i = 0; i <= PROFILER_MAX_DEPTH; ++i)
+		pBuffer->childTicks[i] = 0;
+	pBuffer->dropped = 0;
+	pBuffer->collectedDropped = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(mThreadMutex);
+
+		pBuffer->name = "Thread " + intToString((unsigned int)mThreadBuffers.size());
+		mThreadBuffers.push_back(pBuffer);
+	}
+
+	gThreadBuffer = pBuffer;
+	gThreadGeneration = mGeneration;
+
+	return pBuffer;
+}
+
+void Profiler::collect(ProfileThreadBuffer* buffer, unsigned int thread)
+{
+	unsigned int tail = buffer->tail.load(std::memory_order_relaxed);
+	unsigned int head = buffer->head.load(std::memory_order_acquire);
+
+	for (; tail != head; ++tail)
+	{
+		const ProfileRecord& record = buffer->records[tail & buffer->mask];
+
+		unsigned int parent = record.parentDepth & PROFILER_NO_PARENT;
+		unsigned int depth = record.parentDepth >> 24;
+		unsigned long long duration = record.end - record.begin;
+
+		// zones are recorded when they end so the nested ones always come first
+		unsigned long long children = buffer->childTicks[depth + 1];
+		buffer->childTicks[depth + 1] = 0;
+		buffer->childTicks[depth] += duration;
+
+		ZoneData* pZone = mZones[record.zone];
+		pZone->parent = (parent != PROFILER_NO_PARENT) ? (int)parent : -1;
+		pZone->depth = depth;
+		pZone->frameCalls++;
+		pZone->frameTicks += duration;
+		pZone->frameSelfTicks += (duration > children) ? duration - children : 0;
+
+		if (mCapturing)
+		{
+			CapturedZone capturedZone;
+			capturedZone.zone = record.zone;
+			capturedZone.thread = thread;
+			capturedZone.begin = record.begin;
+			capturedZone.end = record.end;
+			mCapturedZones.push_back(capturedZone);
+		}
+	}
+
+	buffer->tail.store(tail, std::memory_order_release);
+
+	// the count may lag behind by the zones dropped while collecting
+	unsigned int dropped = buffer->dropped.load(std::memory_order_relaxed);
+	mDroppedZones += dropped - buffer->collectedDropped;
+	buffer->collectedDropped = dropped;
+}
+
+double Profiler::getTicksPerSecond()
+{
+	// the longer the profiler runs the more precise the rate gets
+	double elapsedSeconds = getSeconds() - mStartSeconds;
+	if (elapsedSeconds > 0.01)
+		mTicksPerSecond = (double)(getTicks() - mStartTicks) / elapsedSeconds;
+
+	return mTicksPerSecond;
+}
+
+Profiler::ZoneData* Profiler::createZone(const std::string& name)
+{
+	ZoneData* pZone = new ZoneData();
+	pZone->name = name;
+	pZone->parent = -1;
+	pZone->depth = 0;
+
+	pZone->frameCalls = 0;
+	pZone->frameTicks = 0;
+	pZone->frameSelfTicks = 0;
+
+	pZone->calls = 0;
+	pZone->frames = 0;
+	pZone->times.assign(mStatsFrameCount, 0.0f);
+	pZone->selfTimes.assign(mStatsFrameCount, 0.0f);
+
+	return pZone;
+}
+
+unsigned long long Profiler::getTicks()
+{
+	return readTicks();
+}
+
+double Profiler::getSeconds()
+{
+#if ENGINE_PLATFORM == PLATFORM_WINDOWS
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+Profiler* Profiler::getInstance()
+{
+	return Singleton<Profiler>::getInstance();
+}
+
+} // end namespace core
\ No newline at end of file
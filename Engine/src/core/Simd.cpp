@@ -0,0 +1,1054 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <core/Simd.h>
+
+#include <math.h>
+#include <string.h>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#	define ENGINE_SIMD_X86
+#	include <emmintrin.h>
+#	include <immintrin.h>
+#endif
+
+#if ENGINE_COMPILER == COMPILER_GNUC
+#	define SIMD_TARGET_AVX __attribute__((target("avx")))
+#else
+#	define SIMD_TARGET_AVX
+#endif
+
+namespace core
+{
+
+//! Number of planes the culling kernels test against.
+static const unsigned int CULL_PLANE_COUNT = 6;
+
+//////////////////////////////////////////////////////////////////////////
+// Scalar kernels
+
+static void multiplyScalar(const float* a, const float* b, float* out)
+{
+	float m[16];
+
+	for (unsigned int i = 0; i < 16; i += 4)
+	{
+		m[i + 0] = a[i] * b[0] + a[i + 1] * b[4] + a[i + 2] * b[ 8] + a[i + 3] * b[12];
+		m[i + 1] = a[i] * b[1] + a[i + 1] * b[5] + a[i + 2] * b[ 9] + a[i + 3] * b[13];
+		m[i + 2] = a[i] * b[2] + a[i + 1] * b[6] + a[i + 2] * b[10] + a[i + 3] * b[14];
+		m[i + 3] = a[i] * b[3] + a[i + 1] * b[7] + a[i + 2] * b[11] + a[i + 3] * b[15];
+	}
+
+	memcpy(out, m, sizeof(m));
+}
+
+static void multiplyBatchScalar(const float* a, const float* b, float* out, unsigned int count, bool left)
+{
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		if (left)
+			multiplyScalar(a, b + i * 16, out + i * 16);
+		else
+			multiplyScalar(b + i * 16, a, out + i * 16);
+	}
+}
+
+static bool inverseScalar(const float* m, float* out)
+{
+	// Cramer's rule
+	#define M(row, col) m[(row) * 4 + (col)]
+
+	float d = (M(0, 0) * M(1, 1) - M(1, 0) * M(0, 1)) * (M(2, 2) * M(3, 3) - M(3, 2) * M(2, 3)) - (M(0, 0) * M(2, 1) - M(2, 0) * M(0, 1)) * (M(1, 2) * M(3, 3) - M(3, 2) * M(1, 3))
+			+ (M(0, 0) * M(3, 1) - M(3, 0) * M(0, 1)) * (M(1, 2) * M(2, 3) - M(2, 2) * M(1, 3)) + (M(1, 0) * M(2, 1) - M(2, 0) * M(1, 1)) * (M(0, 2) * M(3, 3) - M(3, 2) * M(0, 3))
+			- (M(1, 0) * M(3, 1) - M(3, 0) * M(1, 1)) * (M(0, 2) * M(2, 3) - M(2, 2) * M(0, 3)) + (M(2, 0) * M(3, 1) - M(3, 0) * M(2, 1)) * (M(0, 2) * M(1, 3) - M(1, 2) * M(0, 3));
+
+	if (d == 0.0f)
+	{
+		if (out != m)
+			memcpy(out, m, 16 * sizeof(float));
+
+		return false;
+	}
+
+	d = 1.0f / d;
+
+	float r[16];
+	r[ 0] = d * (M(1, 1) * (M(2, 2) * M(3, 3) - M(3, 2) * M(2, 3)) + M(2, 1) * (M(3, 2) * M(1, 3) - M(1, 2) * M(3, 3)) + M(3, 1) * (M(1, 2) * M(2, 3) - M(2, 2) * M(1, 3)));
+	r[ 4] = d * (M(1, 2) * (M(2, 0) * M(3, 3) - M(3, 0) * M(2, 3)) + M(2, 2) * (M(3, 0) * M(1, 3) - M(1, 0) * M(3, 3)) + M(3, 2) * (M(1, 0) * M(2, 3) - M(2, 0) * M(1, 3)));
+	r[ 8] = d * (M(1, 3) * (M(2, 0) * M(3, 1) - M(3, 0) * M(2, 1)) + M(2, 3) * (M(3, 0) * M(1, 1) - M(1, 0) * M(3, 1)) + M(3, 3) * (M(1, 0) * M(2, 1) - M(2, 0) * M(1, 1)));
+	r[12] = d * (M(1, 0) * (M(3, 1) * M(2, 2) - M(2, 1) * M(3, 2)) + M(2, 0) * (M(1, 1) * M(3, 2) - M(3, 1) * M(1, 2)) + M(3, 0) * (M(2, 1) * M(1, 2) - M(1, 1) * M(2, 2)));
+	r[ 1] = d * (M(2, 1) * (M(0, 2) * M(3, 3) - M(3, 2) * M(0, 3)) + M(3, 1) * (M(2, 2) * M(0, 3) - M(0, 2) * M(2, 3)) + M(0, 1) * (M(3, 2) * M(2, 3) - M(2, 2) * M(3, 3)));
+	r[ 5] = d * (M(2, 2) * (M(0, 0) * M(3, 3) - M(3, 0) * M(0, 3)) + M(3, 2) * (M(2, 0) * M(0, 3) - M(0, 0) * M(2, 3)) + M(0, 2) * (M(3, 0) * M(2, 3) - M(2, 0) * M(3, 3)));
+	r[ 9] = d * (M(2, 3) * (M(0, 0) * M(3, 1) - M(3, 0) * M(0, 1)) + M(3, 3) * (M(2, 0) * M(0, 1) - M(0, 0) * M(2, 1)) + M(0, 3) * (M(3, 0) * M(2, 1) - M(2, 0) * M(3, 1)));
+	r[13] = d * (M(2, 0) * (M(3, 1) * M(0, 2) - M(0, 1) * M(3, 2)) + M(3, 0) * (M(0, 1) * M(2, 2) - M(2, 1) * M(0, 2)) + M(0, 0) * (M(2, 1) * M(3, 2) - M(3, 1) * M(2, 2)));
+	r[ 2] = d * (M(3, 1) * (M(0, 2) * M(1, 3) - M(1, 2) * M(0, 3)) + M(0, 1) * (M(1, 2) * M(3, 3) - M(3, 2) * M(1, 3)) + M(1, 1) * (M(3, 2) * M(0, 3) - M(0, 2) * M(3, 3)));
+	r[ 6] = d * (M(3, 2) * (M(0, 0) * M(1, 3) - M(1, 0) * M(0, 3)) + M(0, 2) * (M(1, 0) * M(3, 3) - M(3, 0) * M(1, 3)) + M(1, 2) * (M(3, 0) * M(0, 3) - M(0, 0) * M(3, 3)));
+	r[10] = d * (M(3, 3) * (M(0, 0) * M(1, 1) - M(1, 0) * M(0, 1)) + M(0, 3) * (M(1, 0) * M(3, 1) - M(3, 0) * M(1, 1)) + M(1, 3) * (M(3, 0) * M(0, 1) - M(0, 0) * M(3, 1)));
+	r[14] = d * (M(3, 0) * (M(1, 1) * M(0, 2) - M(0, 1) * M(1, 2)) + M(0, 0) * (M(3, 1) * M(1, 2) - M(1, 1) * M(3, 2)) + M(1, 0) * (M(0, 1) * M(3, 2) - M(3, 1) * M(0, 2)));
+	r[ 3] = d * (M(0, 1) * (M(2, 2) * M(1, 3) - M(1, 2) * M(2, 3)) + M(1, 1) * (M(0, 2) * M(2, 3) - M(2, 2) * M(0, 3)) + M(2, 1) * (M(1, 2) * M(0, 3) - M(0, 2) * M(1, 3)));
+	r[ 7] = d * (M(0, 2) * (M(2, 0) * M(1, 3) - M(1, 0) * M(2, 3)) + M(1, 2) * (M(0, 0) * M(2, 3) - M(2, 0) * M(0, 3)) + M(2, 2) * (M(1, 0) * M(0, 3) - M(0, 0) * M(1, 3)));
+	r[11] = d * (M(0, 3) * (M(2, 0) * M(1, 1) - M(1, 0) * M(2, 1)) + M(1, 3) * (M(0, 0) * M(2, 1) - M(2, 0) * M(0, 1)) + M(2, 3) * (M(1, 0) * M(0, 1) - M(0, 0) * M(1, 1)));
+	r[15] = d * (M(0, 0) * (M(1, 1) * M(2, 2) - M(2, 1) * M(1, 2)) + M(1, 0) * (M(2, 1) * M(0, 2) - M(0, 1) * M(2, 2)) + M(2, 0) * (M(0, 1) * M(1, 2) - M(1, 1) * M(0, 2)));
+
+	#undef M
+
+	memcpy(out, r, sizeof(r));
+
+	return true;
+}
+
+static void transposeScalar(const float* m, float* out)
+{
+	float t[16];
+
+	for (unsigned int i = 0; i < 4; ++i)
+	{
+		for (unsigned int j = 0; j < 4; ++j)
+			t[i * 4 + j] = m[j * 4 + i];
+	}
+
+	memcpy(out, t, sizeof(t));
+}
+
+static void transformPointsScalar(const float* m, const float* in, float* out, unsigned int count, unsigned int stride)
+{
+	for (unsigned int i = 0; i < count; ++i, in += stride, out += stride)
+	{
+		float x = in[0];
+		float y = in[1];
+		float z = in[2];
+
+		out[0] = m[ 0] * x + m[ 1] * y + m[ 2] * z + m[ 3];
+		out[1] = m[ 4] * x + m[ 5] * y + m[ 6] * z + m[ 7];
+		out[2] = m[ 8] * x + m[ 9] * y + m[10] * z + m[11];
+	}
+}
+
+static void transformVectorsScalar(const float* m, const float* in, float* out, unsigned int count)
+{
+	for (unsigned int i = 0; i < count; ++i, in += 4, out += 4)
+	{
+		float x = in[0];
+		float y = in[1];
+		float z = in[2];
+		float w = in[3];
+
+		out[0] = m[ 0] * x + m[ 1] * y + m[ 2] * z + m[ 3] * w;
+		out[1] = m[ 4] * x + m[ 5] * y + m[ 6] * z + m[ 7] * w;
+		out[2] = m[ 8] * x + m[ 9] * y + m[10] * z + m[11] * w;
+		out[3] = m[12] * x + m[13] * y + m[14] * z + m[15] * w;
+	}
+}
+
+static inline unsigned int getCullPlane(unsigned int first, unsigned int k)
+{
+	// the plane that rejected the volume last time goes first, the others keep their order
+	if (k == 0)
+		return first;
+
+	return (k <= first) ? k - 1 : k;
+}
+
+static inline unsigned int getFirstCullPlane(const unsigned char* lastPlanes, unsigned int i)
+{
+	if (lastPlanes == nullptr || lastPlanes[i] >= CULL_PLANE_COUNT)
+		return 0;
+
+	return lastPlanes[i];
+}
+
+static inline void clearVisibility(unsigned int* visible, unsigned int count)
+{
+	memset(visible, 0, ((count + 31) / 32) * sizeof(unsigned int));
+}
+
+static void cullScalar(const float* planes, const CullingVolumes& volumes, unsigned int begin, unsigned int count, unsigned int* visible, unsigned char* lastPlanes, bool boxes)
+{
+	for (unsigned int i = begin; i < count; ++i)
+	{
+		float x = volumes.centerX[i];
+		float y = volumes.centerY[i];
+		float z = volumes.centerZ[i];
+
+		unsigned int first = getFirstCullPlane(lastPlanes, i);
+		bool inside = true;
+
+		for (unsigned int k = 0; k < CULL_PLANE_COUNT && inside; ++k)
+		{
+			unsigned int p = getCullPlane(first, k);
+			const float* plane = planes + p * 4;
+
+			// distance of the farthest point of the volume along the plane normal
+			float r = boxes ? fabsf(plane[0]) * volumes.extentX[i] + fabsf(plane[1]) * volumes.extentY[i] + fabsf(plane[2]) * volumes.extentZ[i] : volumes.radius[i];
+			if (plane[0] * x + plane[1] * y + plane[2] * z + plane[3] + r < 0.0f)
+			{
+				inside = false;
+
+				if (lastPlanes != nullptr)
+					lastPlanes[i] = (unsigned char)p;
+			}
+		}
+
+		if (inside)
+			visible[i >> 5] |= 1u << (i & 31);
+	}
+}
+
+static void cullSpheresScalar(const float* planes, const CullingVolumes& volumes, unsigned int count, unsigned int* visible, unsigned char* lastPlanes)
+{
+	clearVisibility(visible, count);
+	cullScalar(planes, volumes, 0, count, visible, lastPlanes, false);
+}
+
+static void cullBoxesScalar(const float* planes, const CullingVolumes& volumes, unsigned int count, unsigned int* visible, unsigned char* lastPlanes)
+{
+	clearVisibility(visible, count);
+	cullScalar(planes, volumes, 0, count, visible, lastPlanes, true);
+}
+
+static inline void rasterizeDepthSpan(const DepthTriangle& triangle, const float* rowEdges, float rowDepth, float* line, unsigned int begin, unsigned int end)
+{
+	for (unsigned int x = begin; x < end; ++x)
+	{
+		float fx = (float)x;
+
+		if (triangle.edgeA[0] * fx + rowEdges[0] > 0.0f && triangle.edgeA[1] * fx + rowEdges[1] > 0.0f && triangle.edgeA[2] * fx + rowEdges[2] > 0.0f)
+		{
+			float z = triangle.depthA * fx + rowDepth;
+			if (z < line[x])
+				line[x] = z;
+		}
+	}
+}
+
+static void rasterizeDepthScalar(const DepthTriangle& triangle, float* depth, unsigned int pitch, unsigned int minX, unsigned int minY, unsigned int maxX, unsigned int maxY)
+{
+	for (unsigned int y = minY; y < maxY; ++y)
+	{
+		float fy = (float)y;
+
+		float rowEdges[3];
+		for (unsigned int i = 0; i < 3; ++i)
+			rowEdges[i] = triangle.edgeB[i] * fy + triangle.edgeC[i];
+
+		rasterizeDepthSpan(triangle, rowEdges, triangle.depthB * fy + triangle.depthC, depth + y * pitch, minX, maxX);
+	}
+}
+
+#ifdef ENGINE_SIMD_X86
+
+//////////////////////////////////////////////////////////////////////////
+// SSE2 kernels
+
+static void multiplySSE2(const float* a, const float* b, float* out)
+{
+	__m128 b0 = _mm_loadu_ps(b);
+	__m128 b1 = _mm_loadu_ps(b + 4);
+	__m128 b2 = _mm_loadu_ps(b + 8);
+	__m128 b3 = _mm_loadu_ps(b + 12);
+
+	__m128 r[4];
+	for (unsigned int i = 0; i < 4; ++i)
+	{
+		const float* row = a + i * 4;
+		r[i] = _mm_mul_ps(_mm_set1_ps(row[0]), b0);
+		r[i] = _mm_add_ps(r[i], _mm_mul_ps(_mm_set1_ps(row[1]), b1));
+		r[i] = _mm_add_ps(r[i], _mm_mul_ps(_mm_set1_ps(row[2]), b2));
+		r[i] = _mm_add_ps(r[i], _mm_mul_ps(_mm_set1_ps(row[3]), b3));
+	}
+
+	_mm_storeu_ps(out, r[0]);
+	_mm_storeu_ps(out + 4, r[1]);
+	_mm_storeu_ps(out + 8, r[2]);
+	_mm_storeu_ps(out + 12, r[3]);
+}
+
+static void multiplyBatchSSE2(const float* a, const float* b, float* out, unsigned int count, bool left)
+{
+	if (left)
+	{
+		for (unsigned int i = 0; i < count; ++i)
+			multiplySSE2(a, b + i * 16, out + i * 16);
+		return;
+	}
+
+	// the right hand matrix stays in registers
+	__m128 a0 = _mm_loadu_ps(a);
+	__m128 a1 = _mm_loadu_ps(a + 4);
+	__m128 a2 = _mm_loadu_ps(a + 8);
+	__m128 a3 = _mm_loadu_ps(a + 12);
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		const float* m = b + i * 16;
+		float* o = out + i * 16;
+
+		__m128 r[4];
+		for (unsigned int j = 0; j < 4; ++j)
+		{
+			const float* row = m + j * 4;
+			r[j] = _mm_mul_ps(_mm_set1_ps(row[0]), a0);
+			r[j] = _mm_add_ps(r[j], _mm_mul_ps(_mm_set1_ps(row[1]), a1));
+			r[j] = _mm_add_ps(r[j], _mm_mul_ps(_mm_set1_ps(row[2]), a2));
+			r[j] = _mm_add_ps(r[j], _mm_mul_ps(_mm_set1_ps(row[3]), a3));
+		}
+
+		_mm_storeu_ps(o, r[0]);
+		_mm_storeu_ps(o + 4, r[1]);
+		_mm_storeu_ps(o + 8, r[2]);
+		_mm_storeu_ps(o + 12, r[3]);
+	}
+}
+
+static bool inverseSSE2(const float* m, float* out)
+{
+	// Cramer's rule on the transposed matrix (Intel AP-928)
+	__m128 minor0, minor1, minor2, minor3;
+	__m128 row0, row1, row2, row3;
+	__m128 det, tmp1;
+
+	tmp1 = _mm_setzero_ps();
+	row1 = _mm_setzero_ps();
+	row3 = _mm_setzero_ps();
+
+	tmp1 = _mm_loadh_pi(_mm_loadl_pi(tmp1, (const __m64*)(m)), (const __m64*)(m + 4));
+	row1 = _mm_loadh_pi(_mm_loadl_pi(row1, (const __m64*)(m + 8)), (const __m64*)(m + 12));
+	row0 = _mm_shuffle_ps(tmp1, row1, 0x88);
+	row1 = _mm_shuffle_ps(row1, tmp1, 0xDD);
+	tmp1 = _mm_loadh_pi(_mm_loadl_pi(tmp1, (const __m64*)(m + 2)), (const __m64*)(m + 6));
+	row3 = _mm_loadh_pi(_mm_loadl_pi(row3, (const __m64*)(m + 10)), (const __m64*)(m + 14));
+	row2 = _mm_shuffle_ps(tmp1, row3, 0x88);
+	row3 = _mm_shuffle_ps(row3, tmp1, 0xDD);
+
+	tmp1 = _mm_mul_ps(row2, row3);
+	tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0xB1);
+	minor0 = _mm_mul_ps(row1, tmp1);
+	minor1 = _mm_mul_ps(row0, tmp1);
+	tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0x4E);
+	minor0 = _mm_sub_ps(_mm_mul_ps(row1, tmp1), minor0);
+	minor1 = _mm_sub_ps(_mm_mul_ps(row0, tmp1), minor1);
+	minor1 = _mm_shuffle_ps(minor1, minor1, 0x4E);
+
+	tmp1 = _mm_mul_ps(row1, row2);
+	tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0xB1);
+	minor0 = _mm_add_ps(_mm_mul_ps(row3, tmp1), minor0);
+	minor3 = _mm_mul_ps(row0, tmp1);
+	tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0x4E);
+	minor0 = _mm_sub_ps(minor0, _mm_mul_ps(row3, tmp1));
+	minor3 = _mm_sub_ps(_mm_mul_ps(row0, tmp1), minor3);
+	minor3 = _mm_shuffle_ps(minor3, minor3, 0x4E);
+
+	tmp1 = _mm_mul_ps(_mm_shuffle_ps(row1, row1, 0x4E), row3);
+	tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0xB1);
+	row2 = _mm_shuffle_ps(row2, row2, 0x4E);
+	minor0 = _mm_add_ps(_mm_mul_ps(row2, tmp1), minor0);
+	minor2 = _mm_mul_ps(row0, tmp1);
+	tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0x4E);
+	minor0 = _mm_sub_ps(minor0, _mm_mul_ps(row2, tmp1));
+	minor2 = _mm_sub_ps(_mm_mul_ps(row0, tmp1), minor2);
+	minor2 = _mm_shuffle_ps(minor2, minor2, 0x4E);
+
+	tmp1 = _mm_mul_ps(row0, row1);
+	tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0xB1);
+	minor2 = _mm_add_ps(_mm_mul_ps(row3, tmp1), minor2);
+	minor3 = _mm_sub_ps(_mm_mul_ps(row2, tmp1), minor3);
+	tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0x4E);
+	minor2 = _mm_sub_ps(_mm_mul_ps(row3, tmp1), minor2);
+	minor3 = _mm_sub_ps(minor3, _mm_mul_ps(row2, tmp1));
+
+	tmp1 = _mm_mul_ps(row0, row3);
+	tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0xB1);
+	minor1 = _mm_sub_ps(minor1, _mm_mul_ps(row2, tmp1));
+	minor2 = _mm_add_ps(_mm_mul_ps(row1, tmp1), minor2);
+	tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0x4E);
+	minor1 = _mm_add_ps(_mm_mul_ps(row2, tmp1), minor1);
+	minor2 = _mm_sub_ps(minor2, _mm_mul_ps(row1, tmp1));
+
+	tmp1 = _mm_mul_ps(row0, row2);
+	tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0xB1);
+	minor1 = _mm_add_ps(_mm_mul_ps(row3, tmp1), minor1);
+	minor3 = _mm_sub_ps(minor3, _mm_mul_ps(row1, tmp1));
+	tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0x4E);
+	minor1 = _mm_sub_ps(minor1, _mm_mul_ps(row3, tmp1));
+	minor3 = _mm_add_ps(_mm_mul_ps(row1, tmp1), minor3);
+
+	det = _mm_mul_ps(row0, minor0);
+	det = _mm_add_ps(_mm_shuffle_ps(det, det, 0x4E), det);
+	det = _mm_add_ss(_mm_shuffle_ps(det, det, 0xB1), det);
+
+	float d = _mm_cvtss_f32(det);
+	if (d == 0.0f)
+	{
+		if (out != m)
+			memcpy(out, m, 16 * sizeof(float));
+
+		return false;
+	}
+
+	det = _mm_set1_ps(1.0f / d);
+
+	_mm_storeu_ps(out, _mm_mul_ps(det, minor0));
+	_mm_storeu_ps(out + 4, _mm_mul_ps(det, minor1));
+	_mm_storeu_ps(out + 8, _mm_mul_ps(det, minor2));
+	_mm_storeu_ps(out + 12, _mm_mul_ps(det, minor3));
+
+	return true;
+}
+
+static void transposeSSE2(const float* m, float* out)
+{
+	__m128 r0 = _mm_loadu_ps(m);
+	__m128 r1 = _mm_loadu_ps(m + 4);
+	__m128 r2 = _mm_loadu_ps(m + 8);
+	__m128 r3 = _mm_loadu_ps(m + 12);
+
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+	_mm_storeu_ps(out, r0);
+	_mm_storeu_ps(out + 4, r1);
+	_mm_storeu_ps(out + 8, r2);
+	_mm_storeu_ps(out + 12, r3);
+}
+
+static void transformPointsSSE2(const float* m, const float* in, float* out, unsigned int count, unsigned int stride)
+{
+	// columns of the matrix, the result is c0 * x + c1 * y + c2 * z + c3
+	__m128 c0 = _mm_loadu_ps(m);
+	__m128 c1 = _mm_loadu_ps(m + 4);
+	__m128 c2 = _mm_loadu_ps(m + 8);
+	__m128 c3 = _mm_loadu_ps(m + 12);
+	_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+	for (unsigned int i = 0; i < count; ++i, in += stride, out += stride)
+	{
+		__m128 r = _mm_mul_ps(c0, _mm_set1_ps(in[0]));
+		r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_set1_ps(in[1])));
+		r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(in[2])));
+		r = _mm_add_ps(r, c3);
+
+		_mm_storel_pi((__m64*)out, r);
+		_mm_store_ss(out + 2, _mm_movehl_ps(r, r));
+	}
+}
+
+static void transformVectorsSSE2(const float* m, const float* in, float* out, unsigned int count)
+{
+	__m128 c0 = _mm_loadu_ps(m);
+	__m128 c1 = _mm_loadu_ps(m + 4);
+	__m128 c2 = _mm_loadu_ps(m + 8);
+	__m128 c3 = _mm_loadu_ps(m + 12);
+	_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+	for (unsigned int i = 0; i < count; ++i, in += 4, out += 4)
+	{
+		__m128 v = _mm_loadu_ps(in);
+
+		__m128 r = _mm_mul_ps(c0, _mm_shuffle_ps(v, v, 0x00));
+		r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_shuffle_ps(v, v, 0x55)));
+		r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_shuffle_ps(v, v, 0xAA)));
+		r = _mm_add_ps(r, _mm_mul_ps(c3, _mm_shuffle_ps(v, v, 0xFF)));
+
+		_mm_storeu_ps(out, r);
+	}
+}
+
+static void cullSSE2(const float* planes, const CullingVolumes& volumes, unsigned int count, unsigned int* visible, unsigned char* lastPlanes, bool boxes)
+{
+	clearVisibility(visible, count);
+
+	__m128 nx[CULL_PLANE_COUNT], ny[CULL_PLANE_COUNT], nz[CULL_PLANE_COUNT], nd[CULL_PLANE_COUNT];
+	__m128 ax[CULL_PLANE_COUNT], ay[CULL_PLANE_COUNT], az[CULL_PLANE_COUNT];
+	for (unsigned int p = 0; p < CULL_PLANE_COUNT; ++p)
+	{
+		const float* plane = planes + p * 4;
+		nx[p] = _mm_set1_ps(plane[0]);
+		ny[p] = _mm_set1_ps(plane[1]);
+		nz[p] = _mm_set1_ps(plane[2]);
+		nd[p] = _mm_set1_ps(plane[3]);
+		ax[p] = _mm_set1_ps(fabsf(plane[0]));
+		ay[p] = _mm_set1_ps(fabsf(plane[1]));
+		az[p] = _mm_set1_ps(fabsf(plane[2]));
+	}
+
+	const __m128 zero = _mm_setzero_ps();
+
+	// four volumes per iteration, the plane that rejected the first of them last time is tested first
+	// and rejects the whole group on its own, otherwise the other planes are tested without branches
+	unsigned int i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(volumes.centerX + i);
+		__m128 y = _mm_loadu_ps(volumes.centerY + i);
+		__m128 z = _mm_loadu_ps(volumes.centerZ + i);
+
+		__m128 ex, ey, ez, r;
+		if (boxes)
+		{
+			ex = _mm_loadu_ps(volumes.extentX + i);
+			ey = _mm_loadu_ps(volumes.extentY + i);
+			ez = _mm_loadu_ps(volumes.extentZ + i);
+		}
+		else
+		{
+			r = _mm_loadu_ps(volumes.radius + i);
+		}
+
+		unsigned int first = getFirstCullPlane(lastPlanes, i);
+
+		__m128 outside;
+		__m128 rejectingPlane;
+
+		for (unsigned int k = 0; k < CULL_PLANE_COUNT; ++k)
+		{
+			unsigned int p = getCullPlane(first, k);
+
+			__m128 dist = _mm_mul_ps(nx[p], x);
+			dist = _mm_add_ps(dist, _mm_mul_ps(ny[p], y));
+			dist = _mm_add_ps(dist, _mm_mul_ps(nz[p], z));
+			dist = _mm_add_ps(dist, nd[p]);
+
+			if (boxes)
+			{
+				r = _mm_mul_ps(ax[p], ex);
+				r = _mm_add_ps(r, _mm_mul_ps(ay[p], ey));
+				r = _mm_add_ps(r, _mm_mul_ps(az[p], ez));
+			}
+
+			__m128 behind = _mm_cmplt_ps(_mm_add_ps(dist, r), zero);
+
+			if (k == 0)
+			{
+				if (_mm_movemask_ps(behind) == 0xF)
+					break;
+
+				outside = behind;
+
+				if (lastPlanes != nullptr)
+				{
+					int packed;
+					memcpy(&packed, lastPlanes + i, 4);
+
+					__m128i bytes = _mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), _mm_setzero_si128());
+					rejectingPlane = _mm_cvtepi32_ps(_mm_unpacklo_epi16(bytes, _mm_setzero_si128()));
+					rejectingPlane = _mm_or_ps(_mm_and_ps(behind, _mm_set1_ps((float)p)), _mm_andnot_ps(behind, rejectingPlane));
+				}
+			}
+			else
+			{
+				// the plane is kept only for the volumes it is the first to reject
+				__m128 rejected = _mm_andnot_ps(outside, behind);
+				outside = _mm_or_ps(outside, behind);
+
+				if (lastPlanes != nullptr)
+					rejectingPlane = _mm_or_ps(_mm_and_ps(rejected, _mm_set1_ps((float)p)), _mm_andnot_ps(rejected, rejectingPlane));
+			}
+
+			if (k + 1 == CULL_PLANE_COUNT)
+			{
+				visible[i >> 5] |= (unsigned int)(~_mm_movemask_ps(outside) & 0xF) << (i & 31);
+
+				if (lastPlanes != nullptr)
+				{
+					__m128i bytes = _mm_cvttps_epi32(rejectingPlane);
+					bytes = _mm_packs_epi32(bytes, bytes);
+					bytes = _mm_packus_epi16(bytes, bytes);
+
+					int packed = _mm_cvtsi128_si32(bytes);
+					memcpy(lastPlanes + i, &packed, 4);
+				}
+			}
+		}
+	}
+
+	cullScalar(planes, volumes, i, count, visible, lastPlanes, boxes);
+}
+
+static void cullSpheresSSE2(const float* planes, const CullingVolumes& volumes, unsigned int count, unsigned int* visible, unsigned char* lastPlanes)
+{
+	cullSSE2(planes, volumes, count, visible, lastPlanes, false);
+}
+
+static void cullBoxesSSE2(const float* planes, const CullingVolumes& volumes, unsigned int count, unsigned int* visible, unsigned char* lastPlanes)
+{
+	cullSSE2(planes, volumes, count, visible, lastPlanes, true);
+}
+
+static void rasterizeDepthSSE2(const DepthTriangle& triangle, float* depth, unsigned int pitch, unsigned int minX, unsigned int minY, unsigned int maxX, unsigned int maxY)
+{
+	__m128 a0 = _mm_set1_ps(triangle.edgeA[0]);
+	__m128 a1 = _mm_set1_ps(triangle.edgeA[1]);
+	__m128 a2 = _mm_set1_ps(triangle.edgeA[2]);
+	__m128 depthA = _mm_set1_ps(triangle.depthA);
+
+	const __m128 offsets = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+	const __m128 zero = _mm_setzero_ps();
+
+	for (unsigned int y = minY; y < maxY; ++y)
+	{
+		float fy = (float)y;
+
+		float rowEdges[3];
+		for (unsigned int i = 0; i < 3; ++i)
+			rowEdges[i] = triangle.edgeB[i] * fy + triangle.edgeC[i];
+
+		float rowDepth = triangle.depthB * fy + triangle.depthC;
+
+		__m128 row0 = _mm_set1_ps(rowEdges[0]);
+		__m128 row1 = _mm_set1_ps(rowEdges[1]);
+		__m128 row2 = _mm_set1_ps(rowEdges[2]);
+		__m128 rowZ = _mm_set1_ps(rowDepth);
+
+		float* line = depth + y * pitch;
+
+		// four pixels per iteration, the rest of the row is done by the scalar span
+		unsigned int x = minX;
+		for (; x + 4 <= maxX; x += 4)
+		{
+			__m128 fx = _mm_add_ps(_mm_set1_ps((float)x), offsets);
+
+			__m128 inside = _mm_cmpgt_ps(_mm_add_ps(_mm_mul_ps(a0, fx), row0), zero);
+			inside = _mm_and_ps(inside, _mm_cmpgt_ps(_mm_add_ps(_mm_mul_ps(a1, fx), row1), zero));
+			inside = _mm_and_ps(inside, _mm_cmpgt_ps(_mm_add_ps(_mm_mul_ps(a2, fx), row2), zero));
+
+			if (_mm_movemask_ps(inside) == 0)
+				continue;
+
+			__m128 z = _mm_add_ps(_mm_mul_ps(depthA, fx), rowZ);
+			__m128 stored = _mm_loadu_ps(line + x);
+			__m128 nearer = _mm_and_ps(inside, _mm_cmplt_ps(z, stored));
+
+			_mm_storeu_ps(line + x, _mm_or_ps(_mm_and_ps(nearer, z), _mm_andnot_ps(nearer, stored)));
+		}
+
+		rasterizeDepthSpan(triangle, rowEdges, rowDepth, line, x, maxX);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// AVX2 level kernels
+// Only AVX instructions are needed, FMA is not used because it would change the rounding.
+
+SIMD_TARGET_AVX static inline __m256 duplicateRow(const float* row)
+{
+	__m128 r = _mm_loadu_ps(row);
+	return _mm256_insertf128_ps(_mm256_castps128_ps256(r), r, 1);
+}
+
+SIMD_TARGET_AVX static inline void multiplyRowsAVX(const float* a, __m256 b0, __m256 b1, __m256 b2, __m256 b3, float* out)
+{
+	// two rows of a at once, one in each 128 bit lane
+	__m256 a01 = _mm256_loadu_ps(a);
+	__m256 a23 = _mm256_loadu_ps(a + 8);
+
+	__m256 r01 = _mm256_mul_ps(_mm256_permute_ps(a01, 0x00), b0);
+	r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_permute_ps(a01, 0x55), b1));
+	r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_permute_ps(a01, 0xAA), b2));
+	r01 = _mm256_add_ps(r01, _mm256_mul_ps(_mm256_permute_ps(a01, 0xFF), b3));
+
+	__m256 r23 = _mm256_mul_ps(_mm256_permute_ps(a23, 0x00), b0);
+	r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_permute_ps(a23, 0x55), b1));
+	r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_permute_ps(a23, 0xAA), b2));
+	r23 = _mm256_add_ps(r23, _mm256_mul_ps(_mm256_permute_ps(a23, 0xFF), b3));
+
+	_mm256_storeu_ps(out, r01);
+	_mm256_storeu_ps(out + 8, r23);
+}
+
+SIMD_TARGET_AVX static void multiplyAVX(const float* a, const float* b, float* out)
+{
+	__m256 b0 = duplicateRow(b);
+	__m256 b1 = duplicateRow(b + 4);
+	__m256 b2 = duplicateRow(b + 8);
+	__m256 b3 = duplicateRow(b + 12);
+
+	multiplyRowsAVX(a, b0, b1, b2, b3, out);
+
+	_mm256_zeroupper();
+}
+
+SIMD_TARGET_AVX static void multiplyBatchAVX(const float* a, const float* b, float* out, unsigned int count, bool left)
+{
+	if (left)
+	{
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			const float* m = b + i * 16;
+			multiplyRowsAVX(a, duplicateRow(m), duplicateRow(m + 4), duplicateRow(m + 8), duplicateRow(m + 12), out + i * 16);
+		}
+	}
+	else
+	{
+		__m256 a0 = duplicateRow(a);
+		__m256 a1 = duplicateRow(a + 4);
+		__m256 a2 = duplicateRow(a + 8);
+		__m256 a3 = duplicateRow(a + 12);
+
+		for (unsigned int i = 0; i < count; ++i)
+			multiplyRowsAVX(b + i * 16, a0, a1, a2, a3, out + i * 16);
+	}
+
+	_mm256_zeroupper();
+}
+
+SIMD_TARGET_AVX static void transformPointsAVX(const float* m, const float* in, float* out, unsigned int count, unsigned int stride)
+{
+	__m128 c0 = _mm_loadu_ps(m);
+	__m128 c1 = _mm_loadu_ps(m + 4);
+	__m128 c2 = _mm_loadu_ps(m + 8);
+	__m128 c3 = _mm_loadu_ps(m + 12);
+	_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+	__m256 cc0 = _mm256_insertf128_ps(_mm256_castps128_ps256(c0), c0, 1);
+	__m256 cc1 = _mm256_insertf128_ps(_mm256_castps128_ps256(c1), c1, 1);
+	__m256 cc2 = _mm256_insertf128_ps(_mm256_castps128_ps256(c2), c2, 1);
+	__m256 cc3 = _mm256_insertf128_ps(_mm256_castps128_ps256(c3), c3, 1);
+
+	// two points per iteration, one in each 128 bit lane
+	unsigned int i = 0;
+	for (; i + 1 < count; i += 2, in += 2 * stride, out += 2 * stride)
+	{
+		const float* p0 = in;
+		const float* p1 = in + stride;
+
+		__m256 r = _mm256_mul_ps(cc0, _mm256_setr_ps(p0[0], p0[0], p0[0], p0[0], p1[0], p1[0], p1[0], p1[0]));
+		r = _mm256_add_ps(r, _mm256_mul_ps(cc1, _mm256_setr_ps(p0[1], p0[1], p0[1], p0[1], p1[1], p1[1], p1[1], p1[1])));
+		r = _mm256_add_ps(r, _mm256_mul_ps(cc2, _mm256_setr_ps(p0[2], p0[2], p0[2], p0[2], p1[2], p1[2], p1[2], p1[2])));
+		r = _mm256_add_ps(r, cc3);
+
+		__m128 r0 = _mm256_castps256_ps128(r);
+		__m128 r1 = _mm256_extractf128_ps(r, 1);
+
+		_mm_storel_pi((__m64*)out, r0);
+		_mm_store_ss(out + 2, _mm_movehl_ps(r0, r0));
+		_mm_storel_pi((__m64*)(out + stride), r1);
+		_mm_store_ss(out + stride + 2, _mm_movehl_ps(r1, r1));
+	}
+
+	if (i < count)
+	{
+		__m128 r = _mm_mul_ps(c0, _mm_set1_ps(in[0]));
+		r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_set1_ps(in[1])));
+		r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(in[2])));
+		r = _mm_add_ps(r, c3);
+
+		_mm_storel_pi((__m64*)out, r);
+		_mm_store_ss(out + 2, _mm_movehl_ps(r, r));
+	}
+
+	_mm256_zeroupper();
+}
+
+SIMD_TARGET_AVX static void transformVectorsAVX(const float* m, const float* in, float* out, unsigned int count)
+{
+	__m128 c0 = _mm_loadu_ps(m);
+	__m128 c1 = _mm_loadu_ps(m + 4);
+	__m128 c2 = _mm_loadu_ps(m + 8);
+	__m128 c3 = _mm_loadu_ps(m + 12);
+	_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+	__m256 cc0 = _mm256_insertf128_ps(_mm256_castps128_ps256(c0), c0, 1);
+	__m256 cc1 = _mm256_insertf128_ps(_mm256_castps128_ps256(c1), c1, 1);
+	__m256 cc2 = _mm256_insertf128_ps(_mm256_castps128_ps256(c2), c2, 1);
+	__m256 cc3 = _mm256_insertf128_ps(_mm256_castps128_ps256(c3), c3, 1);
+
+	unsigned int i = 0;
+	for (; i + 1 < count; i += 2, in += 8, out += 8)
+	{
+		__m256 v = _mm256_loadu_ps(in);
+
+		__m256 r = _mm256_mul_ps(cc0, _mm256_permute_ps(v, 0x00));
+		r = _mm256_add_ps(r, _mm256_mul_ps(cc1, _mm256_permute_ps(v, 0x55)));
+		r = _mm256_add_ps(r, _mm256_mul_ps(cc2, _mm256_permute_ps(v, 0xAA)));
+		r = _mm256_add_ps(r, _mm256_mul_ps(cc3, _mm256_permute_ps(v, 0xFF)));
+
+		_mm256_storeu_ps(out, r);
+	}
+
+	_mm256_zeroupper();
+
+	if (i < count)
+		transformVectorsSSE2(m, in, out, 1);
+}
+
+SIMD_TARGET_AVX static void cullAVX(const float* planes, const CullingVolumes& volumes, unsigned int count, unsigned int* visible, unsigned char* lastPlanes, bool boxes)
+{
+	clearVisibility(visible, count);
+
+	__m256 nx[CULL_PLANE_COUNT], ny[CULL_PLANE_COUNT], nz[CULL_PLANE_COUNT], nd[CULL_PLANE_COUNT];
+	__m256 ax[CULL_PLANE_COUNT], ay[CULL_PLANE_COUNT], az[CULL_PLANE_COUNT];
+	for (unsigned int p = 0; p < CULL_PLANE_COUNT; ++p)
+	{
+		const float* plane = planes + p * 4;
+		nx[p] = _mm256_set1_ps(plane[0]);
+		ny[p] = _mm256_set1_ps(plane[1]);
+		nz[p] = _mm256_set1_ps(plane[2]);
+		nd[p] = _mm256_set1_ps(plane[3]);
+		ax[p] = _mm256_set1_ps(fabsf(plane[0]));
+		ay[p] = _mm256_set1_ps(fabsf(plane[1]));
+		az[p] = _mm256_set1_ps(fabsf(plane[2]));
+	}
+
+	const __m256 zero = _mm256_setzero_ps();
+
+	// eight volumes per iteration, see cullSSE2
+	unsigned int i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 x = _mm256_loadu_ps(volumes.centerX + i);
+		__m256 y = _mm256_loadu_ps(volumes.centerY + i);
+		__m256 z = _mm256_loadu_ps(volumes.centerZ + i);
+
+		__m256 ex, ey, ez, r;
+		if (boxes)
+		{
+			ex = _mm256_loadu_ps(volumes.extentX + i);
+			ey = _mm256_loadu_ps(volumes.extentY + i);
+			ez = _mm256_loadu_ps(volumes.extentZ + i);
+		}
+		else
+		{
+			r = _mm256_loadu_ps(volumes.radius + i);
+		}
+
+		unsigned int first = getFirstCullPlane(lastPlanes, i);
+
+		__m256 outside;
+		__m256 rejectingPlane;
+
+		for (unsigned int k = 0; k < CULL_PLANE_COUNT; ++k)
+		{
+			unsigned int p = getCullPlane(first, k);
+
+			__m256 dist = _mm256_mul_ps(nx[p], x);
+			dist = _mm256_add_ps(dist, _mm256_mul_ps(ny[p], y));
+			dist = _mm256_add_ps(dist, _mm256_mul_ps(nz[p], z));
+			dist = _mm256_add_ps(dist, nd[p]);
+
+			if (boxes)
+			{
+				r = _mm256_mul_ps(ax[p], ex);
+				r = _mm256_add_ps(r, _mm256_mul_ps(ay[p], ey));
+				r = _mm256_add_ps(r, _mm256_mul_ps(az[p], ez));
+			}
+
+			__m256 behind = _mm256_cmp_ps(_mm256_add_ps(dist, r), zero, _CMP_LT_OQ);
+
+			if (k == 0)
+			{
+				if (_mm256_movemask_ps(behind) == 0xFF)
+					break;
+
+				outside = behind;
+
+				if (lastPlanes != nullptr)
+				{
+					__m128i bytes = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(lastPlanes + i)), _mm_setzero_si128());
+					__m128i low = _mm_unpacklo_epi16(bytes, _mm_setzero_si128());
+					__m128i high = _mm_unpackhi_epi16(bytes, _mm_setzero_si128());
+					rejectingPlane = _mm256_cvtepi32_ps(_mm256_insertf128_si256(_mm256_castsi128_si256(low), high, 1));
+					rejectingPlane = _mm256_or_ps(_mm256_and_ps(behind, _mm256_set1_ps((float)p)), _mm256_andnot_ps(behind, rejectingPlane));
+				}
+			}
+			else
+			{
+				__m256 rejected = _mm256_andnot_ps(outside, behind);
+				outside = _mm256_or_ps(outside, behind);
+
+				if (lastPlanes != nullptr)
+					rejectingPlane = _mm256_or_ps(_mm256_and_ps(rejected, _mm256_set1_ps((float)p)), _mm256_andnot_ps(rejected, rejectingPlane));
+			}
+
+			if (k + 1 == CULL_PLANE_COUNT)
+			{
+				visible[i >> 5] |= (unsigned int)(~_mm256_movemask_ps(outside) & 0xFF) << (i & 31);
+
+				if (lastPlanes != nullptr)
+				{
+					__m256i words = _mm256_cvttps_epi32(rejectingPlane);
+					__m128i bytes = _mm_packs_epi32(_mm256_castsi256_si128(words), _mm256_extractf128_si256(words, 1));
+					bytes = _mm_packus_epi16(bytes, bytes);
+
+					_mm_storel_epi64((__m128i*)(lastPlanes + i), bytes);
+				}
+			}
+		}
+	}
+
+	_mm256_zeroupper();
+
+	cullScalar(planes, volumes, i, count, visible, lastPlanes, boxes);
+}
+
+static void cullSpheresAVX(const float* planes, const CullingVolumes& volumes, unsigned int count, unsigned int* visible, unsigned char* lastPlanes)
+{
+	cullAVX(planes, volumes, count, visible, lastPlanes, false);
+}
+
+static void cullBoxesAVX(const float* planes, const CullingVolumes& volumes, unsigned int count, unsigned int* visible, unsigned char* lastPlanes)
+{
+	cullAVX(planes, volumes, count, visible, lastPlanes, true);
+}
+
+SIMD_TARGET_AVX static void rasterizeDepthAVX(const DepthTriangle& triangle, float* depth, unsigned int pitch, unsigned int minX, unsigned int minY, unsigned int maxX, unsigned int maxY)
+{
+	__m256 a0 = _mm256_set1_ps(triangle.edgeA[0]);
+	__m256 a1 = _mm256_set1_ps(triangle.edgeA[1]);
+	__m256 a2 = _mm256_set1_ps(triangle.edgeA[2]);
+	__m256 depthA = _mm256_set1_ps(triangle.depthA);
+
+	const __m256 offsets = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+	const __m256 zero = _mm256_setzero_ps();
+
+	for (unsigned int y = minY; y < maxY; ++y)
+	{
+		float fy = (float)y;
+
+		float rowEdges[3];
+		for (unsigned int i = 0; i < 3; ++i)
+			rowEdges[i] = triangle.edgeB[i] * fy + triangle.edgeC[i];
+
+		float rowDepth = triangle.depthB * fy + triangle.depthC;
+
+		__m256 row0 = _mm256_set1_ps(rowEdges[0]);
+		__m256 row1 = _mm256_set1_ps(rowEdges[1]);
+		__m256 row2 = _mm256_set1_ps(rowEdges[2]);
+		__m256 rowZ = _mm256_set1_ps(rowDepth);
+
+		float* line = depth + y * pitch;
+
+		// eight pixels per iteration, see rasterizeDepthSSE2
+		unsigned int x = minX;
+		for (; x + 8 <= maxX; x += 8)
+		{
+			__m256 fx = _mm256_add_ps(_mm256_set1_ps((float)x), offsets);
+
+			__m256 inside = _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(a0, fx), row0), zero, _CMP_GT_OQ);
+			inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(a1, fx), row1), zero, _CMP_GT_OQ));
+			inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(a2, fx), row2), zero, _CMP_GT_OQ));
+
+			if (_mm256_movemask_ps(inside) == 0)
+				continue;
+
+			__m256 z = _mm256_add_ps(_mm256_mul_ps(depthA, fx), rowZ);
+			__m256 stored = _mm256_loadu_ps(line + x);
+			__m256 nearer = _mm256_and_ps(inside, _mm256_cmp_ps(z, stored, _CMP_LT_OQ));
+
+			_mm256_storeu_ps(line + x, _mm256_or_ps(_mm256_and_ps(nearer, z), _mm256_andnot_ps(nearer, stored)));
+		}
+
+		rasterizeDepthSpan(triangle, rowEdges, rowDepth, line, x, maxX);
+	}
+
+	_mm256_zeroupper();
+}
+
+#endif // ENGINE_SIMD_X86
+
+static const MathKernels gScalarKernels =
+{
+	multiplyScalar,
+	multiplyBatchScalar,
+	inverseScalar,
+	transposeScalar,
+	transformPointsScalar,
+	transformVectorsScalar,
+	cullSpheresScalar,
+	cullBoxesScalar,
+	rasterizeDepthScalar
+};
+
+#ifdef ENGINE_SIMD_X86
+
+static const MathKernels gSSE2Kernels =
+{
+	multiplySSE2,
+	multiplyBatchSSE2,
+	inverseSSE2,
+	transposeSSE2,
+	transformPointsSSE2,
+	transformVectorsSSE2,
+	cullSpheresSSE2,
+	cullBoxesSSE2,
+	rasterizeDepthSSE2
+};
+
+static const MathKernels gAVX2Kernels =
+{
+	multiplyAVX,
+	multiplyBatchAVX,
+	inverseSSE2,
+	transposeSSE2,
+	transformPointsAVX,
+	transformVectorsAVX,
+	cullSpheresAVX,
+	cullBoxesAVX,
+	rasterizeDepthAVX
+};
+
+#endif // ENGINE_SIMD_X86
+
+static SimdLevel gSimdLevel = SIMD_LEVEL_NONE;
+static const MathKernels* gMathKernels = &gScalarKernels;
+
+const MathKernels& getMathKernels()
+{
+	return *gMathKernels;
+}
+
+const MathKernels& getMathKernels(SimdLevel level)
+{
+#ifdef ENGINE_SIMD_X86
+	switch (level)
+	{
+	case SIMD_LEVEL_SSE2:
+		return gSSE2Kernels;
+	case SIMD_LEVEL_AVX2:
+		return gAVX2Kernels;
+	default:
+		break;
+	}
+#endif
+
+	return gScalarKernels;
+}
+
+void setSimdLevel(SimdLevel level)
+{
+#ifdef ENGINE_SIMD_X86
+	gSimdLevel = (level < SIMD_LEVEL_COUNT) ? level : SIMD_LEVEL_NONE;
+#else
+	gSimdLevel = SIMD_LEVEL_NONE;
+#endif
+
+	gMathKernels = &getMathKernels(gSimdLevel);
+}
+
+SimdLevel getSimdLevel()
+{
+	return gSimdLevel;
+}
+
+} // end namespace core
\ No newline at end of file
@@ -53,13 +53,13 @@ bool sphere3d::operator!=(const sphere3d& other) const
 	return ((other.Center != Center) || (other.Radius + EPSILON < Radius) || (other.Radius - EPSILON > Radius));
 }
 
-inline void sphere3d::set(const vector3d center, const float radius)
+void sphere3d::set(const vector3d center, const float radius)
 {
 	Center = center;
 	Radius = radius;
 }
 
-inline void sphere3d::set(const sphere3d& s)
+void sphere3d::set(const sphere3d& s)
 {
 	Center = s.Center;
 	Radius = s.Radius;
@@ -39,6 +39,12 @@ System::System(const std::string& name)
 
 	mSystemDriver = nullptr;
 
+	mMainThreadUpdate = true;
+
+	mProfileZone.name = mName.c_str();
+	mProfileZone.id = -1;
+	mProfileZone.generation = 0;
+
 	if (Log::getInstance() != nullptr) Log::getInstance()->logMessage(mName, "Create");
 }
 
@@ -141,6 +147,8 @@ void System::update(float elapsedTime)
 
 	mState = SYSTEM_STATE_UPDATING;
 
+	PROFILE_ZONE(mProfileZone);
+
 	if (mSystemDriver != nullptr)
 		mSystemDriver->update(elapsedTime);
 
@@ -200,6 +208,46 @@ void System::removeDefaultFactories()
 	removeDefaultFactoriesImpl();
 }
 
+void System::addDependency(System* system)
+{
+	if (system == nullptr || system == this)
+		return;
+
+	std::list<System*>::iterator i;
+	for (i = mDependencies.begin(); i != mDependencies.end(); ++i)
+	{
+		if ((*i) == system)
+			return;
+	}
+
+	mDependencies.push_back(system);
+}
+
+void System::removeDependency(System* system)
+{
+	mDependencies.remove(system);
+}
+
+const std::list<System*>& System::getDependencies() const
+{
+	return mDependencies;
+}
+
+void System::setMainThreadUpdate(bool mainThread)
+{
+	mMainThreadUpdate = mainThread;
+}
+
+bool System::getMainThreadUpdate() const
+{
+	return mMainThreadUpdate;
+}
+
+const std::string& System::getName() const
+{
+	return mName;
+}
+
 void System::initializeImpl() {}
 
 void System::uninitializeImpl() {}
@@ -34,6 +34,10 @@ SystemDriver::SystemDriver(const std::string& name)
 {
 	mName = name;
 
+	mProfileZone.name = mName.c_str();
+	mProfileZone.id = -1;
+	mProfileZone.generation = 0;
+
 	if (Log::getInstance() != nullptr) Log::getInstance()->logMessage(mName, "Create");
 }
 
@@ -80,6 +84,8 @@ void SystemDriver::stop()
 
 void SystemDriver::update(float elapsedTime)
 {
+	PROFILE_ZONE(mProfileZone);
+
 	updateImpl(elapsedTime);
 }
 
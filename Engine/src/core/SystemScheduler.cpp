@@ -0,0 +1,263 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <core/SystemScheduler.h>
+#include <core/System.h>
+#include <core/JobSystem.h>
+#include <core/Log.h>
+
+#include <map>
+
+namespace core
+{
+
+SystemScheduler::SystemScheduler()
+{
+	mNeedsRebuild = true;
+	mElapsedTime = 0.0f;
+	mCounter = new JobCounter();
+	mRemainingNodes = 0;
+}
+
+SystemScheduler::~SystemScheduler()
+{
+	clearNodes();
+
+	SAFE_DELETE(mCounter);
+}
+
+void SystemScheduler::addSystem(System* system)
+{
+	if (system == nullptr)
+		return;
+
+	mSystems.push_back(system);
+	mNeedsRebuild = true;
+}
+
+void SystemScheduler::removeSystem(System* system)
+{
+	std::vector<System*>::iterator i;
+	for (i = mSystems.begin(); i != mSystems.end(); ++i)
+	{
+		if ((*i) == system)
+		{
+			mSystems.erase(i);
+			mNeedsRebuild = true;
+			return;
+		}
+	}
+}
+
+void SystemScheduler::invalidate()
+{
+	mNeedsRebuild = true;
+}
+
+void SystemScheduler::update(float elapsedTime)
+{
+	if (mNeedsRebuild)
+		build();
+
+	if (mNodes.empty())
+		return;
+
+	mElapsedTime = elapsedTime;
+
+	std::vector<Node*>::iterator i;
+	for (i = mNodes.begin(); i != mNodes.end(); ++i)
+	{
+		(*i)->remainingDependencies = (*i)->dependencyCount;
+	}
+
+	mRemainingNodes = mNodes.size();
+
+	for (unsigned int j = 0; j < mNodes.size(); ++j)
+	{
+		if (mNodes[j]->dependencyCount == 0)
+			dispatch(j);
+	}
+
+	JobSystem* pJobSystem = JobSystem::getInstance();
+
+	// the main thread runs its own systems and helps with the others until the frame is done
+	while (mRemainingNodes.load() > 0)
+	{
+		bool hasNode = false;
+		unsigned int node = 0;
+		{
+			std::lock_guard<std::mutex> lock(mMainThreadMutex);
+			if (!mMainThreadNodes.empty())
+			{
+				node = mMainThreadNodes.front();
+				mMainThreadNodes.pop_front();
+				hasNode = true;
+			}
+		}
+
+		if (hasNode)
+		{
+			updateNode(node);
+		}
+		else if (pJobSystem == nullptr || !pJobSystem->executeJob())
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	if (pJobSystem != nullptr)
+		pJobSystem->wait(mCounter);
+}
+
+void SystemScheduler::build()
+{
+	clearNodes();
+
+	std::map<System*, unsigned int> indices;
+	for (unsigned int i = 0; i < mSystems.size(); ++i)
+	{
+		Node* pNode = new Node();
+		pNode->system = mSystems[i];
+		pNode->dependencyCount = 0;
+		pNode->remainingDependencies = 0;
+		mNodes.push_back(pNode);
+
+		indices[mSystems[i]] = i;
+	}
+
+	for (unsigned int i = 0; i < mNodes.size(); ++i)
+	{
+		const std::list<System*>& dependencies = mNodes[i]->system->getDependencies();
+		std::list<System*>::const_iterator j;
+		for (j = dependencies.begin(); j != dependencies.end(); ++j)
+		{
+			// dependencies on systems that are not scheduled here are ignored
+			std::map<System*, unsigned int>::const_iterator k = indices.find(*j);
+			if (k == indices.end())
+				continue;
+
+			mNodes[k->second]->dependents.push_back(i);
+			mNodes[i]->dependencyCount++;
+		}
+	}
+
+	// check for cycles, a system in a cycle would never be updated
+	std::vector<unsigned int> remaining(mNodes.size());
+	std::vector<unsigned int> ready;
+	for (unsigned int i = 0; i < mNodes.size(); ++i)
+	{
+		remaining[i] = mNodes[i]->dependencyCount;
+		if (remaining[i] == 0)
+			ready.push_back(i);
+	}
+
+	unsigned int visited = 0;
+	while (!ready.empty())
+	{
+		unsigned int node = ready.back();
+		ready.pop_back();
+		++visited;
+
+		for (unsigned int i = 0; i < mNodes[node]->dependents.size(); ++i)
+		{
+			unsigned int dependent = mNodes[node]->dependents[i];
+			if (--remaining[dependent] == 0)
+				ready.push_back(dependent);
+		}
+	}
+
+	if (visited != mNodes.size())
+	{
+		if (Log::getInstance() != nullptr) Log::getInstance()->logMessage("SystemScheduler", "Cyclic system dependencies, falling back to sequential update", LOG_LEVEL_ERROR);
+
+		// chain the systems in the order they were added
+		for (unsigned int i = 0; i < mNodes.size(); ++i)
+		{
+			mNodes[i]->dependents.clear();
+			mNodes[i]->dependencyCount = (i == 0) ? 0 : 1;
+			if (i + 1 < mNodes.size())
+				mNodes[i]->dependents.push_back(i + 1);
+		}
+	}
+
+	mNodeJobs.resize(mNodes.size());
+	for (unsigned int i = 0; i < mNodes.size(); ++i)
+	{
+		mNodeJobs[i].scheduler = this;
+		mNodeJobs[i].node = i;
+	}
+
+	mNeedsRebuild = false;
+}
+
+void SystemScheduler::clearNodes()
+{
+	std::vector<Node*>::iterator i;
+	for (i = mNodes.begin(); i != mNodes.end(); ++i)
+	{
+		SAFE_DELETE(*i);
+	}
+	mNodes.clear();
+	mNodeJobs.clear();
+}
+
+void SystemScheduler::dispatch(unsigned int node)
+{
+	JobSystem* pJobSystem = JobSystem::getInstance();
+	if (mNodes[node]->system->getMainThreadUpdate() || pJobSystem == nullptr || pJobSystem->getWorkerCount() == 0)
+	{
+		std::lock_guard<std::mutex> lock(mMainThreadMutex);
+		mMainThreadNodes.push_back(node);
+	}
+	else
+	{
+		pJobSystem->run(updateNodeJob, &mNodeJobs[node], mCounter);
+	}
+}
+
+void SystemScheduler::updateNode(unsigned int node)
+{
+	Node* pNode = mNodes[node];
+
+	pNode->system->update(mElapsedTime);
+
+	for (unsigned int i = 0; i < pNode->dependents.size(); ++i)
+	{
+		unsigned int dependent = pNode->dependents[i];
+		if (mNodes[dependent]->remainingDependencies.fetch_sub(1) == 1)
+			dispatch(dependent);
+	}
+
+	mRemainingNodes.fetch_sub(1);
+}
+
+void SystemScheduler::updateNodeJob(void* data)
+{
+	NodeJob* pNodeJob = static_cast<NodeJob*>(data);
+	pNodeJob->scheduler->updateNode(pNodeJob->node);
+}
+
+} // end namespace core
\ No newline at end of file
@@ -24,6 +24,9 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include <core/Log.h>
+#include <core/JobSystem.h>
+#include <core/Profiler.h>
+#include <core/SystemScheduler.h>
 #include <engine/EngineManager.h>
 #include <engine/EngineSettings.h>
 #include <engine/EngineEvent.h>
@@ -58,7 +61,10 @@ EngineManager::EngineManager(): core::System("EngineManager")
 	mLastUpdateStartTime	= 0;
 	mLastUpdateEndTime		= 0;
 
+	mProfiler					= new core::Profiler();
 	mLog						= new core::Log();
+	mJobSystem					= new core::JobSystem();
+	mSystemScheduler			= new core::SystemScheduler();
 	mSettings					= new EngineSettings();
 	mPluginManager				= new PluginManager();
 	mPlatformManager			= new platform::PlatformManager();
@@ -69,6 +75,10 @@ EngineManager::EngineManager(): core::System("EngineManager")
 	mPhysicsManager				= new physics::PhysicsManager();
 	mGameManager				= new game::GameManager();
 
+	setupUpdateDependencies();
+
+	PROFILE_THREAD_NAME("Main");
+
 	resetTimer();
 
 	mOptionsFile = "Engine.xml";
@@ -79,6 +89,8 @@ EngineManager::~EngineManager()
 	SAFE_DELETE(mEngineEvent);
 
 	SAFE_DELETE(mLog);
+	SAFE_DELETE(mSystemScheduler);
+	SAFE_DELETE(mJobSystem);
 	SAFE_DELETE(mSettings);
 	SAFE_DELETE(mPlatformManager);
 	SAFE_DELETE(mInputManager);
@@ -87,6 +99,8 @@ EngineManager::~EngineManager()
 	SAFE_DELETE(mSoundManager);
 	SAFE_DELETE(mPhysicsManager);
 	SAFE_DELETE(mGameManager);
+	SAFE_DELETE(mPluginManager);
+	SAFE_DELETE(mProfiler);
 
 #if defined(_DEBUG) && defined(ENGINE_MEMORY_TRACKER)
 	_CrtMemDumpAllObjectsSince(nullptr);
@@ -153,6 +167,28 @@ void EngineManager::initializeImpl()
 
 	// the order is important
 	if (platform::PlatformManager::getInstance()	!= nullptr) platform::PlatformManager::getInstance()->initialize();
+
+	if (core::JobSystem::getInstance() != nullptr)
+	{
+		int workerThreads = -1;
+		if (engine::EngineSettings::getInstance() != nullptr)
+			workerThreads = engine::EngineSettings::getInstance()->getWorkerThreads();
+
+		if (workerThreads < 0)
+		{
+			// one worker for every processor besides the one running the main thread
+			unsigned int processors = 0;
+			if (platform::PlatformManager::getInstance() != nullptr)
+				processors = platform::PlatformManager::getInstance()->getPhysicalProcessorsNum();
+			if (processors == 0)
+				processors = std::thread::hardware_concurrency();
+
+			workerThreads = (processors > 1) ? (int)processors - 1 : 0;
+		}
+
+		core::JobSystem::getInstance()->start((unsigned int)workerThreads);
+	}
+
 	if (resource::ResourceManager::getInstance()	!= nullptr) resource::ResourceManager::getInstance()->initialize();
 	if (input::InputManager::getInstance()			!= nullptr) input::InputManager::getInstance()->initialize();
 
@@ -176,6 +212,9 @@ void EngineManager::uninitializeImpl()
 	
 	if (resource::ResourceManager::getInstance()	!= nullptr) resource::ResourceManager::getInstance()->uninitialize();
 	if (input::InputManager::getInstance()			!= nullptr) input::InputManager::getInstance()->uninitialize();
+
+	if (core::JobSystem::getInstance()				!= nullptr) core::JobSystem::getInstance()->stop();
+
 	if (platform::PlatformManager::getInstance()	!= nullptr) platform::PlatformManager::getInstance()->uninitialize();
 
 	// Unload plugins
@@ -219,21 +258,44 @@ void EngineManager::stopImpl()
 
 void EngineManager::updateImpl(float elapsedTime)
 {
+	// collects the previous frame, the zone of this update is only recorded once it returns
+	PROFILE_FRAME();
+
 	fireEngineUpdateStarted();
 
-	// the order is important
-	if (platform::PlatformManager::getInstance()	!= nullptr) platform::PlatformManager::getInstance()->update(mEngineEvent->timeSinceLastUpdate);
-	if (resource::ResourceManager::getInstance()	!= nullptr) resource::ResourceManager::getInstance()->update(mEngineEvent->timeSinceLastUpdate);
-	if (input::InputManager::getInstance()			!= nullptr) input::InputManager::getInstance()->update(mEngineEvent->timeSinceLastUpdate);
-	
-	if (game::GameManager::getInstance()			!= nullptr) game::GameManager::getInstance()->update(mEngineEvent->timeSinceLastUpdate);
-	if (render::RenderManager::getInstance()		!= nullptr) render::RenderManager::getInstance()->update(mEngineEvent->timeSinceLastUpdate);
-	if (physics::PhysicsManager::getInstance()		!= nullptr) physics::PhysicsManager::getInstance()->update(mEngineEvent->timeSinceLastUpdate);
-	if (sound::SoundManager::getInstance()			!= nullptr) sound::SoundManager::getInstance()->update(mEngineEvent->timeSinceLastUpdate);
+	// the order is given by the dependencies declared in setupUpdateDependencies
+	if (mSystemScheduler != nullptr) mSystemScheduler->update(mEngineEvent->timeSinceLastUpdate);
+
+	// nothing else runs now, the receivers can move nodes and play sounds
+	if (mPhysicsManager != nullptr) mPhysicsManager->fireCollisionEvents();
 
 	fireEngineUpdateEnded();
 }
 
+void EngineManager::setupUpdateDependencies()
+{
+	// platform -> resource -> input -> game -> (render, physics, sound)
+	mResourceManager->addDependency(mPlatformManager);
+	mInputManager->addDependency(mResourceManager);
+	mGameManager->addDependency(mInputManager);
+	mRenderManager->addDependency(mGameManager);
+	mPhysicsManager->addDependency(mGameManager);
+	mSoundManager->addDependency(mGameManager);
+
+	// render keeps the graphics context on the main thread while physics and sound run on workers,
+	// they only read the nodes the game update left and the collision events are fired after them
+	mPhysicsManager->setMainThreadUpdate(false);
+	mSoundManager->setMainThreadUpdate(false);
+
+	mSystemScheduler->addSystem(mPlatformManager);
+	mSystemScheduler->addSystem(mResourceManager);
+	mSystemScheduler->addSystem(mInputManager);
+	mSystemScheduler->addSystem(mGameManager);
+	mSystemScheduler->addSystem(mRenderManager);
+	mSystemScheduler->addSystem(mPhysicsManager);
+	mSystemScheduler->addSystem(mSoundManager);
+}
+
 void EngineManager::resetTimer()
 {
 #if ENGINE_PLATFORM == PLATFORM_WINDOWS
@@ -273,6 +335,8 @@ void EngineManager::resetTimer()
 	SetThreadAffinityMask(thread, oldMask);
 
 	mLastTime = 0;
+#elif ENGINE_PLATFORM == PLATFORM_LINUX
+	gettimeofday(&mStartTime, nullptr);
 #endif
 }
 
@@ -316,6 +380,13 @@ unsigned long EngineManager::getMilliseconds()
     mLastTime = newTime;
 
     return newTicks;
+#elif ENGINE_PLATFORM == PLATFORM_LINUX
+	timeval curTime;
+	gettimeofday(&curTime, nullptr);
+
+	return (unsigned long)((curTime.tv_sec - mStartTime.tv_sec) * 1000 + (curTime.tv_usec - mStartTime.tv_usec) / 1000);
+#else
+	return 0;
 #endif
 }
 
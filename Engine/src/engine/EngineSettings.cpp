@@ -31,6 +31,8 @@ THE SOFTWARE.
 
 #if ENGINE_PLATFORM == PLATFORM_WINDOWS
 #include <windows.h>
+#elif ENGINE_PLATFORM == PLATFORM_LINUX
+#include <unistd.h>
 #endif
 
 template<> engine::EngineSettings* core::Singleton<engine::EngineSettings>::m_Singleton = nullptr;
@@ -51,6 +53,7 @@ EngineSettings::EngineSettings()
 	mDataPath = "";
 	mWorkPath = "";
 	mMainWindowId = nullptr;
+	mWorkerThreads = -1;
 
 #if ENGINE_PLATFORM == PLATFORM_WINDOWS
 	char fullPath[MAX_PATH_SIZE]; 
@@ -65,6 +68,20 @@ EngineSettings::EngineSettings()
 	}
 
 	core::stringReplaceChar(mWorkPath, '\\', '/');
+#elif ENGINE_PLATFORM == PLATFORM_LINUX
+	char fullPath[MAX_PATH_SIZE + 1];
+	ssize_t length = readlink("/proc/self/exe", fullPath, MAX_PATH_SIZE);
+	if (length > 0)
+	{
+		fullPath[length] = '\0';
+		mWorkPath = fullPath;
+
+		size_t pos = mWorkPath.find_last_of('/');
+		if (pos != std::string::npos)
+		{
+			mWorkPath = mWorkPath.substr(0, pos);
+		}
+	}
 #endif
 }
 
@@ -110,6 +127,11 @@ void* EngineSettings::getMainWindowId()
 	return mMainWindowId;
 }
 
+const int EngineSettings::getWorkerThreads()
+{
+	return mWorkerThreads;
+}
+
 void EngineSettings::setWidth(unsigned int width)
 {
 	mWidth = width;
@@ -151,6 +173,12 @@ void EngineSettings::setMainWindowID(void* windowId)
 	mMainWindowId = windowId;
 }
 
+void EngineSettings::setWorkerThreads(int workerThreads)
+{
+	mWorkerThreads = workerThreads;
+	mOptionsModified = true;
+}
+
 void EngineSettings::loadOptions(const std::string& optionsfile)
 {
 	tinyxml2::XMLDocument doc;
@@ -227,6 +255,15 @@ void EngineSettings::loadOptions(const std::string& optionsfile)
 				mDataPath = svalue;
 			}
 		}
+
+		pElement = pRoot->FirstChildElement("WorkerThreads");
+		if (pElement != nullptr)
+		{
+			if (pElement->QueryIntAttribute("value", &ivalue) == tinyxml2::XML_SUCCESS)
+			{
+				mWorkerThreads = ivalue;
+			}
+		}
 	}
 }
 
@@ -298,6 +335,14 @@ void EngineSettings::saveOptions(const std::string& optionsfile)
 
 			pElement->SetAttribute("value", mDataPath.c_str());
 		}
+
+		pElement = doc.NewElement("WorkerThreads");
+		if (pElement != nullptr)
+		{
+			pRoot->InsertEndChild(pElement);
+
+			pElement->SetAttribute("value", mWorkerThreads);
+		}
 	}
 
 	if (doc.SaveFile(optionsfile.c_str()) != tinyxml2::XML_SUCCESS)
@@ -33,7 +33,9 @@ THE SOFTWARE.
 #if ENGINE_PLATFORM == PLATFORM_WINDOWS
 #	define WIN32_LEAN_AND_MEAN
 #	include <windows.h>
-#elif GAME_PLATFORM == PLATFORM_APPLE
+#elif ENGINE_PLATFORM == PLATFORM_LINUX
+#	include <dlfcn.h>
+#elif ENGINE_PLATFORM == PLATFORM_APPLE
 #	include "macPlugins.h"
 #endif
 
@@ -88,10 +90,9 @@ bool Plugin::load()
 
 	if (!m_hInst)
 	{
-		DWORD err = GetLastError();
-
 		std::string message = mName;
-		message += " could not load.";
+		message += " could not load: ";
+		message += dynlibError();
 
 		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("Plugin", message, core::LOG_LEVEL_ERROR);
 
@@ -108,6 +109,10 @@ bool Plugin::load()
 
 void Plugin::unload()
 {
+	// The library could not be loaded
+	if (!m_hInst)
+		return;
+
 	// Call shutdown
 	DLL_UNLOAD_PLUGIN pUnloadFunc = (DLL_UNLOAD_PLUGIN)getSymbol("unloadPlugin");
 
@@ -122,6 +127,8 @@ void Plugin::unload()
 
 		return;
 	}
+
+	m_hInst = nullptr;
 }
 
 bool Plugin::reload()
@@ -142,7 +149,7 @@ void* Plugin::getSymbol(const std::string& strName) const throw()
 
 std::string Plugin::dynlibError()
 {
-#if GAME_PLATFORM == PLATFORM_WINDOWS
+#if ENGINE_PLATFORM == PLATFORM_WINDOWS
 	LPVOID lpMsgBuf;
 	FormatMessage(
 		FORMAT_MESSAGE_ALLOCATE_BUFFER |
@@ -155,13 +162,13 @@ std::string Plugin::dynlibError()
 		0,
 		NULL
 	);
-	std::string ret = (c8*)lpMsgBuf;
+	std::string ret = (char*)lpMsgBuf;
 	// Free the buffer.
 	LocalFree(lpMsgBuf);
 	return ret;
-#elif GAME_PLATFORM == PLATFORM_LINUX
+#elif ENGINE_PLATFORM == PLATFORM_LINUX
 	return std::string(dlerror());
-#elif GAME_PLATFORM == PLATFORM_APPLE
+#elif ENGINE_PLATFORM == PLATFORM_APPLE
 	return std::string(mac_errorBundle());
 #else
 	return std::string("");
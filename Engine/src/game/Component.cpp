@@ -26,6 +26,7 @@ THE SOFTWARE.
 
 #include <game/Component.h>
 #include <game/GameObject.h>
+#include <game/MessageDefines.h>
 #include <core/Utils.h>
 
 namespace game
@@ -41,8 +42,12 @@ Component::Component()
 
 	mType = COMPONENT_TYPE_UNDEFINED;
 
+	mMessageMask = MESSAGE_MASK_ALL;
+
 	mInitialized = false;
 
+	mCommitRequested = false;
+
 	mGameObject = nullptr;
 }
 
@@ -59,6 +64,26 @@ const unsigned int& Component::getID() const
 	return mID;
 }
 
+const core::Handle& Component::getHandle() const
+{
+	return mHandle;
+}
+
+void Component::setHandle(const core::Handle& handle)
+{
+	mHandle = handle;
+}
+
+const core::Handle& Component::getSystemHandle() const
+{
+	return mSystemHandle;
+}
+
+void Component::setSystemHandle(const core::Handle& handle)
+{
+	mSystemHandle = handle;
+}
+
 const std::string& Component::getName() const
 {
 	return mName;
@@ -88,6 +113,23 @@ void Component::update(float elapsedTime)
 	updateImpl(elapsedTime);
 }
 
+void Component::requestCommit()
+{
+	mCommitRequested = true;
+}
+
+bool Component::isCommitRequested() const
+{
+	return mCommitRequested;
+}
+
+void Component::commit()
+{
+	mCommitRequested = false;
+
+	commitImpl();
+}
+
 bool Component::isInitialized() const
 {
 	return mInitialized;
@@ -99,10 +141,17 @@ void Component::onAttach(GameObject* gameObject)
 		return;
 
 	mGameObject = gameObject;
+
+	onAttachImpl();
 }
 
 void Component::onDetach()
 {
+	if (mGameObject == nullptr)
+		return;
+
+	onDetachImpl();
+
 	mGameObject = nullptr;
 }
 
@@ -122,6 +171,12 @@ void Component::uninitializeImpl() {}
 
 void Component::updateImpl(float elapsedTime) {}
 
+void Component::commitImpl() {}
+
+void Component::onAttachImpl() {}
+
+void Component::onDetachImpl() {}
+
 void Component::onMessageImpl(unsigned int messageID) {}
 
 } // end namespace game
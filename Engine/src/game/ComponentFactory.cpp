@@ -32,12 +32,27 @@ namespace game
 ComponentFactory::ComponentFactory()
 {
 	mName = "Undefined";
+
+	mThreadSafe = false;
 }
 
+ComponentFactory::~ComponentFactory() {}
+
 const std::string& ComponentFactory::getName()
 {
 	return mName;
 }
 
+bool ComponentFactory::updateComponents(float elapsedTime)
+{
+	return false;
+}
+
+void ComponentFactory::commitComponents() {}
+
+bool ComponentFactory::isThreadSafe() const
+{
+	return mThreadSafe;
+}
 
 } // end namespace game
\ No newline at end of file
@@ -29,10 +29,14 @@ THE SOFTWARE.
 #include <game/Component.h>
 #include <game/ComponentFactory.h>
 #include <game/TransformFactory.h>
+#include <game/TransformHierarchy.h>
+#include <game/MessageBus.h>
 #include <game/SceneFactory.h>
 #include <resource/Resource.h>
 #include <resource/ResourceManager.h>
 
+#include <algorithm>
+
 template<> game::GameManager* core::Singleton<game::GameManager>::m_Singleton = nullptr;
 
 namespace game
@@ -46,12 +50,18 @@ GameManager::GameManager(): core::System("GameManager")
 	mDefaultSceneFactory		= new SceneFactory();
 
 	mDefaultTransformFactory	= new TransformFactory();
+
+	mTransformHierarchy			= new TransformHierarchy();
+
+	mMessageBus					= new MessageBus();
 }
 
 GameManager::~GameManager()
 {
 	SAFE_DELETE(mDefaultSceneFactory);
 	SAFE_DELETE(mDefaultTransformFactory);
+	SAFE_DELETE(mTransformHierarchy);
+	SAFE_DELETE(mMessageBus);
 }
 
 Scene* GameManager::getCurrentScene()
@@ -95,7 +105,7 @@ void GameManager::removeScene()
 {
 	if (mCurrentScene != nullptr && resource::ResourceManager::getInstance() != nullptr)
 	{
-		resource::ResourceManager::getInstance()->removeResource(mCurrentScene->getID());
+		resource::ResourceManager::getInstance()->removeResource(mCurrentScene);
 	}
 }
 
@@ -105,7 +115,7 @@ GameObject* GameManager::createGameObject(GameObject* parent)
 	if (pGameObject == nullptr)
 		return nullptr;
 
-	mGameObjects[pGameObject->getID()] = pGameObject;
+	pGameObject->setHandle(mGameObjects.insert(pGameObject));
 
 	if (parent != nullptr)
 	{
@@ -126,7 +136,7 @@ GameObject* GameManager::createGameObject(const std::string& name, GameObject* p
 	if (pGameObject == nullptr)
 		return nullptr;
 
-	mGameObjects[pGameObject->getID()] = pGameObject;
+	pGameObject->setHandle(mGameObjects.insert(pGameObject));
 
 	if (parent != nullptr)
 	{
@@ -141,42 +151,51 @@ GameObject* GameManager::createGameObject(const std::string& name, GameObject* p
 	return pGameObject;
 }
 
+GameObject* GameManager::getGameObject(const core::Handle& handle)
+{
+	GameObject** ppGameObject = mGameObjects.get(handle);
+	if (ppGameObject == nullptr)
+		return nullptr;
+
+	return *ppGameObject;
+}
+
 void GameManager::removeGameObject(GameObject* gameObject)
 {
 	if (gameObject == nullptr)
 		return;
 
-	removeGameObject(gameObject->getID());
+	removeGameObject(gameObject->getHandle());
 }
 
-void GameManager::removeGameObject(const unsigned int& id)
+void GameManager::removeGameObject(const core::Handle& handle)
 {
-	std::map<unsigned int, GameObject*>::iterator i = mGameObjects.find(id);
-	if (i != mGameObjects.end())
+	GameObject* pGameObject = getGameObject(handle);
+	if (pGameObject == nullptr)
+		return;
+
+	mGameObjects.remove(handle);
+
+	/*if (mCurrentScene != nullptr)
 	{
-		GameObject* pGameObject = i->second;
-		if (pGameObject != nullptr)
-		{
-			/*if (mCurrentScene != nullptr)
-			{
-				mCurrentScene->removeGameObject(pGameObject);
-			}
-			else*/
-			{
-				SAFE_DELETE(pGameObject);
-			}
-			i->second = nullptr;
-		}
-		mGameObjects.erase(i);
+		mCurrentScene->removeGameObject(pGameObject);
+	}
+	else*/
+	{
+		SAFE_DELETE(pGameObject);
 	}
 }
 
 void GameManager::removeAllGameObjects()
 {
-	std::map<unsigned int, GameObject*>::iterator i;
-	for (i = mGameObjects.begin(); i != mGameObjects.end(); ++i)
+	// the storage is emptied first since destroying a game object can remove others
+	std::vector<GameObject*> gameObjects = mGameObjects.getValues();
+	mGameObjects.clear();
+
+	std::vector<GameObject*>::iterator i;
+	for (i = gameObjects.begin(); i != gameObjects.end(); ++i)
 	{
-		GameObject* pGameObject = i->second;
+		GameObject* pGameObject = (*i);
 		if (pGameObject != nullptr)
 		{
 			/*if (mCurrentScene != nullptr)
@@ -187,14 +206,11 @@ void GameManager::removeAllGameObjects()
 			{
 				SAFE_DELETE(pGameObject);
 			}
-			i->second = nullptr;
 		}
 	}
-
-	mGameObjects.clear();
 }
 
-const std::map<unsigned int, GameObject*>& GameManager::getGameObjects()
+const core::SlotMap<GameObject*>& GameManager::getGameObjects()
 {
 	return mGameObjects;
 }
@@ -210,7 +226,7 @@ Component* GameManager::createComponent(unsigned int type)
 			Component* pComponent = pComponentFactory->createComponent();
 			if (pComponent != nullptr)
 			{
-				mComponents[pComponent->getID()] = pComponent;
+				pComponent->setHandle(mComponents.insert(pComponent));
 
 				return pComponent;
 			}
@@ -220,50 +236,57 @@ Component* GameManager::createComponent(unsigned int type)
 	return nullptr;
 }
 
+Component* GameManager::getComponent(const core::Handle& handle)
+{
+	Component** ppComponent = mComponents.get(handle);
+	if (ppComponent == nullptr)
+		return nullptr;
+
+	return *ppComponent;
+}
+
 void GameManager::removeComponent(Component* component)
 {
 	if (component == nullptr)
 		return;
 
-	removeComponent(component->getID());
+	removeComponent(component->getHandle());
 }
 
-void GameManager::removeComponent(const unsigned int& id)
+void GameManager::removeComponent(const core::Handle& handle)
 {
-	std::map<unsigned int, Component*>::iterator i = mComponents.find(id);
-	if (i != mComponents.end())
+	Component* pComponent = getComponent(handle);
+	if (pComponent == nullptr)
+		return;
+
+	mComponents.remove(handle);
+
+	pComponent->onDetach();
+
+	std::map<unsigned int, ComponentFactory*>::iterator j = mComponentFactories.find(pComponent->getType());
+	if (j != mComponentFactories.end())
 	{
-		Component* pComponent = i->second;
-		if (pComponent != nullptr)
+		ComponentFactory* pComponentFactory = j->second;
+		if (pComponentFactory != nullptr)
 		{
-			pComponent->onDetach();
-			
-			std::map<unsigned int, ComponentFactory*>::iterator j = mComponentFactories.find(pComponent->getType());
-			if (j != mComponentFactories.end())
-			{
-				ComponentFactory* pComponentFactory = j->second;
-				if (pComponentFactory != nullptr)
-				{
-					pComponentFactory->destroyComponent(pComponent);
-				}
-			}
-			else
-			{
-				SAFE_DELETE(pComponent);
-			}
-			i->second = nullptr;
-
-			mComponents.erase(i);
+			pComponentFactory->destroyComponent(pComponent);
 		}
 	}
+	else
+	{
+		SAFE_DELETE(pComponent);
+	}
 }
 
 void GameManager::removeAllComponents()
 {
-	std::map<unsigned int, Component*>::iterator i;
-	for (i = mComponents.begin(); i != mComponents.end(); ++i)
+	std::vector<Component*> components = mComponents.getValues();
+	mComponents.clear();
+
+	std::vector<Component*>::iterator i;
+	for (i = components.begin(); i != components.end(); ++i)
 	{
-		Component* pComponent = i->second;
+		Component* pComponent = (*i);
 		if (pComponent != nullptr)
 		{
 			std::map<unsigned int, ComponentFactory*>::iterator j = mComponentFactories.find(pComponent->getType());
@@ -279,11 +302,8 @@ void GameManager::removeAllComponents()
 			{
 				SAFE_DELETE(pComponent);
 			}
-			i->second = nullptr;
 		}
 	}
-
-	mComponents.clear();
 }
 
 void GameManager::registerComponentFactory(unsigned int type, ComponentFactory* factory)
@@ -304,6 +324,16 @@ void GameManager::removeComponentFactory(unsigned int type)
 	}
 }
 
+TransformHierarchy* GameManager::getTransformHierarchy()
+{
+	return mTransformHierarchy;
+}
+
+MessageBus* GameManager::getMessageBus()
+{
+	return mMessageBus;
+}
+
 void GameManager::initializeImpl()
 {
 	if (resource::ResourceManager::getInstance() != nullptr)
@@ -318,6 +348,8 @@ void GameManager::initializeImpl()
 
 void GameManager::uninitializeImpl()
 {
+	mMessageBus->clear();
+
 	// Remove all Components
 	removeAllComponents();
 
@@ -331,17 +363,57 @@ void GameManager::stopImpl() {}
 
 void GameManager::updateImpl(float elapsedTime)
 {
-	// update game objects
-	std::map<unsigned int, GameObject*>::iterator i;
-	for (i = mGameObjects.begin(); i != mGameObjects.end(); ++i)
+	// deliver the messages posted since the last update, parent changes reach the transforms before the hierarchy update
+	mMessageBus->dispatchMessages();
+
+	// update the absolute transforms before the components that depend on them
+	mTransformHierarchy->update();
+
+	// deliver what the transform change handlers posted before the components are updated
+	mMessageBus->dispatchMessages();
+
+	// update phase: the components type by type, pooled factories walk their contiguous storage
+	// and split thread-safe types between the job system workers
+	mUntrackedComponentTypes.clear();
+
+	std::map<unsigned int, ComponentFactory*>::iterator i;
+	for (i = mComponentFactories.begin(); i != mComponentFactories.end(); ++i)
 	{
-		GameObject* pGameObject = i->second;
+		ComponentFactory* pComponentFactory = i->second;
+		if (pComponentFactory != nullptr && !pComponentFactory->updateComponents(elapsedTime))
+			mUntrackedComponentTypes.push_back(i->first);
+	}
 
-		if (pGameObject != nullptr)
+	// factories that do not keep track of their components
+	mUntrackedCommits.clear();
+	if (!mUntrackedComponentTypes.empty())
+	{
+		for (unsigned int j = 0; j < mComponents.size(); ++j)
 		{
-			pGameObject->update(elapsedTime);
+			Component* pComponent = mComponents[j];
+			if (pComponent == nullptr || pComponent->getGameObject() == nullptr)
+				continue;
+
+			if (std::find(mUntrackedComponentTypes.begin(), mUntrackedComponentTypes.end(), pComponent->getType()) != mUntrackedComponentTypes.end())
+			{
+				pComponent->update(elapsedTime);
+
+				if (pComponent->isCommitRequested())
+					mUntrackedCommits.push_back(pComponent);
+			}
 		}
 	}
+
+	// commit phase: serially apply what the components deferred during the update
+	for (i = mComponentFactories.begin(); i != mComponentFactories.end(); ++i)
+	{
+		ComponentFactory* pComponentFactory = i->second;
+		if (pComponentFactory != nullptr)
+			pComponentFactory->commitComponents();
+	}
+
+	for (unsigned int j = 0; j < mUntrackedCommits.size(); ++j)
+		mUntrackedCommits[j]->commit();
 }
 
 void GameManager::registerDefaultFactoriesImpl()
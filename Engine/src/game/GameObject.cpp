@@ -26,10 +26,14 @@ THE SOFTWARE.
 
 #include <game/GameObject.h>
 #include <game/Component.h>
+#include <game/Transform.h>
 #include <game/MessageDefines.h>
+#include <game/MessageBus.h>
 #include <game/GameManager.h>
 #include <core/Utils.h>
 
+#include <algorithm>
+
 namespace game
 {
 
@@ -42,6 +46,19 @@ GameObject::GameObject()
 	mName = "GameObject_" + core::intToString(mID);
 
 	mParent = nullptr;
+
+	for (unsigned int i = 0; i < COMPONENT_TYPE_COUNT; ++i)
+	{
+		mComponentSlots[i] = nullptr;
+		mComponentMessageMasks[i] = MESSAGE_MASK_NONE;
+	}
+	mComponentMask = 0;
+	mUserComponentCount = 0;
+
+	mTransform = nullptr;
+
+	mMessageMask = MESSAGE_MASK_NONE;
+	mPostedMessages = 0;
 }
 
 GameObject::GameObject(const std::string& name)
@@ -51,6 +68,19 @@ GameObject::GameObject(const std::string& name)
 	mName = name;
 
 	mParent = nullptr;
+
+	for (unsigned int i = 0; i < COMPONENT_TYPE_COUNT; ++i)
+	{
+		mComponentSlots[i] = nullptr;
+		mComponentMessageMasks[i] = MESSAGE_MASK_NONE;
+	}
+	mComponentMask = 0;
+	mUserComponentCount = 0;
+
+	mTransform = nullptr;
+
+	mMessageMask = MESSAGE_MASK_NONE;
+	mPostedMessages = 0;
 }
 
 GameObject::~GameObject()
@@ -60,22 +90,33 @@ GameObject::~GameObject()
 	if (mParent != nullptr)
 		mParent->removeChild(this);
 
-	std::map<unsigned int, Component*>::iterator i;
-	for (i = mComponents.begin(); i != mComponents.end(); ++i)
+	std::vector<Component*> components;
+	components.swap(mComponents);
+
+	for (unsigned int i = 0; i < COMPONENT_TYPE_COUNT; ++i)
+	{
+		mComponentSlots[i] = nullptr;
+		mComponentMessageMasks[i] = MESSAGE_MASK_NONE;
+	}
+	mComponentMask = 0;
+	mUserComponentCount = 0;
+
+	mTransform = nullptr;
+
+	mMessageMask = MESSAGE_MASK_NONE;
+
+	for (unsigned int i = 0; i < components.size(); ++i)
 	{
-		Component* pComponent = i->second;
+		Component* pComponent = components[i];
 
 		if (pComponent != nullptr)
 		{
-			i->second = nullptr;
 			pComponent->onDetach();
 
 			if (game::GameManager::getInstance() != nullptr)
 				game::GameManager::getInstance()->removeComponent(pComponent);
 		}
 	}
-
-	mComponents.clear();
 }
 
 const unsigned int& GameObject::getID() const
@@ -83,6 +124,16 @@ const unsigned int& GameObject::getID() const
 	return mID;
 }
 
+const core::Handle& GameObject::getHandle() const
+{
+	return mHandle;
+}
+
+void GameObject::setHandle(const core::Handle& handle)
+{
+	mHandle = handle;
+}
+
 const std::string& GameObject::getName() const
 {
 	return mName;
@@ -107,10 +158,10 @@ void GameObject::setParent(GameObject* parent)
 		mParent->removeChild(this);
 
 	mParent = parent;
-	mParent->mChildren[mID] = this;
+	mChildHandle = mParent->mChildren.insert(this);
 
 	//notify components that parent game object has changed!!!
-	sendMessage(this, MESSAGE_PARENT_CHANGED);
+	postMessage(nullptr, MESSAGE_PARENT_CHANGED, true);
 }
 
 void GameObject::addChild(GameObject* child)
@@ -121,31 +172,36 @@ void GameObject::addChild(GameObject* child)
 	if (child->mParent != nullptr)
 		child->mParent->removeChild(child);
 
-	mChildren[child->getID()] = child;
+	child->mChildHandle = mChildren.insert(child);
 	child->mParent = this;
 	
 	//notify child components that parent game object has changed!!!
-	sendMessage(this, MESSAGE_PARENT_CHANGED);
+	postMessage(nullptr, MESSAGE_PARENT_CHANGED, true);
 }
 
 void GameObject::removeChild(GameObject* child)
 {
-	if (child == nullptr)
+	if (child == nullptr || child->mParent != this)
 		return;
 
-	removeChild(child->getID());
+	if (!mChildren.remove(child->mChildHandle))
+		return;
+
+	child->mParent = nullptr;
+	child->mChildHandle = core::Handle();
+
+	//notify child components that parent game object has changed!!!
+	child->postMessage(nullptr, MESSAGE_PARENT_CHANGED, true);
 }
 
 GameObject* GameObject::removeChild(const unsigned int& id)
 {
-	std::map<unsigned int, GameObject*>::iterator i = mChildren.find(id);
-	if (i != mChildren.end())
+	for (unsigned int i = 0; i < mChildren.size(); ++i)
 	{
-		GameObject* pGameObject = i->second;
-		if (pGameObject != nullptr)
+		GameObject* pGameObject = mChildren[i];
+		if (pGameObject->getID() == id)
 		{
-			pGameObject->mParent = nullptr;
-			mChildren.erase(i);
+			removeChild(pGameObject);
 
 			return pGameObject;
 		}
@@ -156,30 +212,56 @@ GameObject* GameObject::removeChild(const unsigned int& id)
 
 void GameObject::removeAllChildren()
 {
-	std::map<unsigned int, GameObject*>::iterator i;
-	for (i = mChildren.begin(); i != mChildren.end(); ++i)
+	for (unsigned int i = 0; i < mChildren.size(); ++i)
 	{
-		GameObject* pGameObject = i->second;
-		if (pGameObject != nullptr)
-		{
-			pGameObject->mParent = nullptr;
-		}
+		GameObject* pGameObject = mChildren[i];
+		pGameObject->mParent = nullptr;
+		pGameObject->mChildHandle = core::Handle();
+
+		//notify child components that parent game object has changed!!!
+		pGameObject->postMessage(nullptr, MESSAGE_PARENT_CHANGED, true);
 	}
 	
 	mChildren.clear();
 }
 
+const std::vector<GameObject*>& GameObject::getChildren() const
+{
+	return mChildren.getValues();
+}
+
 void GameObject::attachComponent(Component* component)
 {
 	if (component == nullptr)
 		return;
 
-	std::map<unsigned int, Component*>::iterator i = mComponents.find(component->getType());
-	if (i == mComponents.end())
+	unsigned int type = component->getType();
+	if (getComponent(type) != nullptr)
+		return;
+
+	if (type < COMPONENT_TYPE_COUNT)
 	{
-		mComponents[component->getType()] = component;
-		component->onAttach(this);
+		mComponentSlots[type] = component;
+		mComponentMessageMasks[type] = component->getMessageMask();
+		mComponentMask |= (1 << type);
+
+		if (type == COMPONENT_TYPE_TRANSFORM)
+			mTransform = static_cast<Transform*>(component);
 	}
+	else
+	{
+		mUserComponentCount++;
+	}
+
+	// keep the list ordered by type so components are updated and notified in the same order
+	std::vector<Component*>::iterator i = mComponents.begin();
+	while (i != mComponents.end() && (*i)->getType() < type)
+		++i;
+	mComponents.insert(i, component);
+
+	mMessageMask |= component->getMessageMask();
+
+	component->onAttach(this);
 }
 
 void GameObject::detachComponent(Component* component)
@@ -187,78 +269,142 @@ void GameObject::detachComponent(Component* component)
 	if (component == nullptr)
 		return;
 
-	std::map<unsigned int, Component*>::iterator i = mComponents.find(component->getType());
-	if (i != mComponents.end())
+	std::vector<Component*>::iterator i = std::find(mComponents.begin(), mComponents.end(), component);
+	if (i == mComponents.end())
+		return;
+
+	mComponents.erase(i);
+
+	updateMessageMask();
+
+	unsigned int type = component->getType();
+	if (type < COMPONENT_TYPE_COUNT)
 	{
-		mComponents.erase(i);
-		component->onDetach();
-	}
-}
+		mComponentSlots[type] = nullptr;
+		mComponentMessageMasks[type] = MESSAGE_MASK_NONE;
+		mComponentMask &= ~(1 << type);
 
-Component* GameObject::getComponent(unsigned int type)
-{
-	std::map<unsigned int, Component*>::iterator i = mComponents.find(type);
-	if (i != mComponents.end())
+		if (type == COMPONENT_TYPE_TRANSFORM)
+			mTransform = nullptr;
+	}
+	else
 	{
-		return i->second;
+		mUserComponentCount--;
 	}
 
-	return nullptr;
+	component->onDetach();
 }
 
-const std::map<unsigned int, Component*>& GameObject::getComponents()
+const std::vector<Component*>& GameObject::getComponents() const
 {
 	return mComponents;
 }
 
+Component* GameObject::findUserComponent(unsigned int type) const
+{
+	for (unsigned int i = 0; i < mComponents.size(); ++i)
+	{
+		if (mComponents[i]->getType() == type)
+			return mComponents[i];
+	}
+
+	return nullptr;
+}
+
 void GameObject::sendMessage(Component* source, unsigned int messageID)
 {
 	//Send to components first
-	std::map<unsigned int, Component*>::iterator i;
-	for (i = mComponents.begin(); i != mComponents.end(); ++i)
-	{
-		Component* pComponent = i->second;
+	deliverMessage(source, messageID);
 
-		if (pComponent != nullptr && pComponent != source)
-		{
-			pComponent->onMessage(messageID);
-		}
+	//Sent to childer second
+	for (unsigned int i = 0; i < mChildren.size(); ++i)
+	{
+		mChildren[i]->sendMessage(source, messageID);
 	}
+}
+
+void GameObject::sendMessage(GameObject* source, unsigned int messageID)
+{
+	//Send to components first
+	deliverMessage(nullptr, messageID);
 
 	//Sent to childer second
-	std::map<unsigned int, GameObject*>::iterator j;
-	for (j = mChildren.begin(); j != mChildren.end(); ++j)
+	for (unsigned int i = 0; i < mChildren.size(); ++i)
 	{
-		GameObject* pGameObject = j->second;
-		if (pGameObject != nullptr)
+		GameObject* pGameObject = mChildren[i];
+		if (pGameObject != source)
 		{
 			pGameObject->sendMessage(source, messageID);
 		}
 	}
 }
 
-void GameObject::sendMessage(GameObject* source, unsigned int messageID)
+void GameObject::postMessage(Component* source, unsigned int messageID, bool includeChildren)
 {
-	//Send to components first
-	std::map<unsigned int, Component*>::iterator i;
-	for (i = mComponents.begin(); i != mComponents.end(); ++i)
+	unsigned int mask = messageID < 32 ? MESSAGE_MASK(messageID) : 0;
+
+	if (!includeChildren && mask != 0)
+	{
+		if ((mMessageMask & mask) == 0 || (mPostedMessages & mask) != 0)
+			return;
+	}
+
+	MessageBus* pMessageBus = MessageBus::getInstance();
+	if (pMessageBus == nullptr || !mHandle.isValid())
 	{
-		Component* pComponent = i->second;
+		// not managed by the GameManager, deliver right away
+		if (includeChildren)
+			sendMessage(source, messageID);
+		else
+			deliverMessage(source, messageID);
 
-		if (pComponent != nullptr)
+		return;
+	}
+
+	if (!includeChildren)
+		mPostedMessages |= mask;
+
+	pMessageBus->postMessage(this, source, messageID, includeChildren);
+}
+
+unsigned int GameObject::getMessageMask() const
+{
+	return mMessageMask;
+}
+
+void GameObject::updateMessageMask()
+{
+	mMessageMask = MESSAGE_MASK_NONE;
+	for (unsigned int i = 0; i < mComponents.size(); ++i)
+		mMessageMask |= mComponents[i]->getMessageMask();
+}
+
+void GameObject::deliverMessage(Component* source, unsigned int messageID)
+{
+	unsigned int mask = messageID < 32 ? MESSAGE_MASK(messageID) : MESSAGE_MASK_ALL;
+
+	// built-in components in type order, only the subscribed ones are touched
+	for (unsigned int type = 0; type < COMPONENT_TYPE_COUNT; ++type)
+	{
+		Component* pComponent = mComponentSlots[type];
+
+		if (pComponent != nullptr && pComponent != source && (mComponentMessageMasks[type] & mask) != 0)
 		{
 			pComponent->onMessage(messageID);
 		}
 	}
 
-	//Sent to childer second
-	std::map<unsigned int, GameObject*>::iterator j;
-	for (j = mChildren.begin(); j != mChildren.end(); ++j)
+	if (mUserComponentCount == 0)
+		return;
+
+	// user-registered components come after the built-in ones
+	for (unsigned int i = 0; i < mComponents.size(); ++i)
 	{
-		GameObject* pGameObject = j->second;
-		if (pGameObject != nullptr && pGameObject != source)
+		Component* pComponent = mComponents[i];
+
+		if (pComponent->getType() >= COMPONENT_TYPE_COUNT && pComponent != source && pComponent->isSubscribed(messageID))
 		{
-			pGameObject->sendMessage(source, messageID);
+			pComponent->onMessage(messageID);
 		}
 	}
 }
@@ -270,10 +416,9 @@ void GameObject::update(float elapsedTime)
 
 void GameObject::updateImpl(float elapsedTime)
 {
-	std::map<unsigned int, Component*>::iterator i;
-	for (i = mComponents.begin(); i != mComponents.end(); ++i)
+	for (unsigned int i = 0; i < mComponents.size(); ++i)
 	{
-		Component* pComponent = i->second;
+		Component* pComponent = mComponents[i];
 
 		if (pComponent != nullptr)
 		{
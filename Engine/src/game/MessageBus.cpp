@@ -0,0 +1,144 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <game/MessageBus.h>
+#include <game/MessageDefines.h>
+#include <game/GameObject.h>
+#include <game/GameManager.h>
+
+template<> game::MessageBus* core::Singleton<game::MessageBus>::m_Singleton = nullptr;
+
+namespace game
+{
+
+//! Number of times the queues are drained in one dispatch, messages posted by the last pass wait for the next sync point.
+static const unsigned int MESSAGE_DISPATCH_MAX_PASSES = 4;
+
+MessageBus::MessageBus()
+{
+	mQueues.resize(MESSAGE_COUNT);
+
+	mPendingMessageCount = 0;
+}
+
+MessageBus::~MessageBus() {}
+
+void MessageBus::postMessage(GameObject* target, Component* source, unsigned int messageID, bool includeChildren)
+{
+	if (target == nullptr)
+		return;
+
+	if (messageID >= mQueues.size())
+		mQueues.resize(messageID + 1);
+
+	MessageRecord record;
+	record.target = target->getHandle();
+	record.source = source;
+	record.includeChildren = includeChildren;
+
+	mQueues[messageID].push_back(record);
+	mPendingMessageCount++;
+}
+
+void MessageBus::dispatchMessages()
+{
+	if (mPendingMessageCount == 0 || GameManager::getInstance() == nullptr)
+		return;
+
+	const core::SlotMap<GameObject*>& gameObjects = GameManager::getInstance()->getGameObjects();
+
+	for (unsigned int pass = 0; pass < MESSAGE_DISPATCH_MAX_PASSES && mPendingMessageCount > 0; ++pass)
+	{
+		for (unsigned int messageID = 0; messageID < mQueues.size(); ++messageID)
+		{
+			if (mQueues[messageID].empty())
+				continue;
+
+			// handlers may post to the queue being delivered
+			mDispatchQueue.swap(mQueues[messageID]);
+			mPendingMessageCount -= mDispatchQueue.size();
+
+			unsigned int mask = messageID < 32 ? MESSAGE_MASK(messageID) : 0;
+
+			for (unsigned int i = 0; i < mDispatchQueue.size(); ++i)
+			{
+				const MessageRecord& record = mDispatchQueue[i];
+
+				GameObject* const* ppGameObject = gameObjects.get(record.target);
+				if (ppGameObject == nullptr || *ppGameObject == nullptr)
+					continue;
+
+				GameObject* pGameObject = *ppGameObject;
+
+				if (record.includeChildren)
+				{
+					pGameObject->sendMessage(record.source, messageID);
+				}
+				else
+				{
+					pGameObject->mPostedMessages &= ~mask;
+					pGameObject->deliverMessage(record.source, messageID);
+				}
+			}
+
+			mDispatchQueue.clear();
+		}
+	}
+}
+
+void MessageBus::clear()
+{
+	GameManager* pGameManager = GameManager::getInstance();
+
+	for (unsigned int messageID = 0; messageID < mQueues.size(); ++messageID)
+	{
+		std::vector<MessageRecord>& queue = mQueues[messageID];
+		unsigned int mask = messageID < 32 ? MESSAGE_MASK(messageID) : 0;
+
+		for (unsigned int i = 0; i < queue.size(); ++i)
+		{
+			GameObject* pGameObject = pGameManager != nullptr ? pGameManager->getGameObject(queue[i].target) : nullptr;
+			if (pGameObject != nullptr && !queue[i].includeChildren)
+				pGameObject->mPostedMessages &= ~mask;
+		}
+
+		queue.clear();
+	}
+
+	mPendingMessageCount = 0;
+}
+
+unsigned int MessageBus::getPendingMessageCount() const
+{
+	return mPendingMessageCount;
+}
+
+MessageBus* MessageBus::getInstance()
+{
+	return core::Singleton<MessageBus>::getInstance();
+}
+
+} // end namespace game
\ No newline at end of file
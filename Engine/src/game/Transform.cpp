@@ -26,6 +26,7 @@ THE SOFTWARE.
 
 #include <game/Transform.h>
 #include <game/GameObject.h>
+#include <game/TransformHierarchy.h>
 #include <game/MessageDefines.h>
 #include <core/Matrix4.h>
 
@@ -35,19 +36,19 @@ namespace game
 Transform::Transform(): Component()
 {
 	mType = COMPONENT_TYPE_TRANSFORM;
+	mMessageMask = MESSAGE_MASK(MESSAGE_PARENT_CHANGED) | MESSAGE_MASK(MESSAGE_TRANSFORM_NEEDS_UPDATE);
 
 	mVisibleAxis = false;
 
-	mPosition = mAbsolutePosition = core::vector3d::ORIGIN_3D;
-	mOrientation = mAbsoluteOrientation = core::quaternion::IDENTITY;
-	mScale = mAbsoluteScale = core::vector3d::UNIT_SCALE;
-
-	mInheritOrientation = true;
-	mInheritScale = true;
-	mTransformNeedsUpdate = true;
+	assert(TransformHierarchy::getInstance() != nullptr);
+	mHandle = TransformHierarchy::getInstance()->addTransform(this);
 }
 
-Transform::~Transform() {}
+Transform::~Transform()
+{
+	if (TransformHierarchy::getInstance() != nullptr)
+		TransformHierarchy::getInstance()->removeTransform(mHandle);
+}
 
 bool Transform::getVisibleAxis()
 {
@@ -61,148 +62,149 @@ void Transform::setVisibleAxis(bool visible)
 
 const core::vector3d& Transform::getPosition()
 {
-	return mPosition;
+	return TransformHierarchy::getInstance()->getPosition(mHandle);
 }
 
 void Transform::setPosition(float x, float y, float z)
 {
-	mPosition.x = x;
-	mPosition.y = y;
-	mPosition.z = z;
-	mTransformNeedsUpdate = true;
+	setPosition(core::vector3d(x, y, z));
 }
 
 void Transform::setPosition(const core::vector3d& pos)
 {
-	mPosition = pos;
-	mTransformNeedsUpdate = true;
+	TransformHierarchy::getInstance()->getPosition(mHandle) = pos;
+	TransformHierarchy::getInstance()->setDirty(mHandle);
 }
 
 const core::quaternion& Transform::getOrientation()
 {
-	return mOrientation;
+	return TransformHierarchy::getInstance()->getOrientation(mHandle);
 }
 
 void Transform::setOrientation(float x, float y, float z, float w)
 {
-	mOrientation.x = x;
-	mOrientation.y = y;
-	mOrientation.z = z;
-	mOrientation.w = w;
-	mTransformNeedsUpdate = true;
+	core::quaternion& orientation = TransformHierarchy::getInstance()->getOrientation(mHandle);
+	orientation.x = x;
+	orientation.y = y;
+	orientation.z = z;
+	orientation.w = w;
+	TransformHierarchy::getInstance()->setDirty(mHandle);
 }
 
 void Transform::setOrientation(const core::quaternion& q)
 {
-	mOrientation = q;
-	mTransformNeedsUpdate = true;
+	TransformHierarchy::getInstance()->getOrientation(mHandle) = q;
+	TransformHierarchy::getInstance()->setDirty(mHandle);
 }
 
 const core::vector3d& Transform::getScale()
 {
-	return mScale;
+	return TransformHierarchy::getInstance()->getScale(mHandle);
 }
 
 void Transform::setScale(float x, float y, float z)
 {
-	mScale.x = x;
-	mScale.y = y;
-	mScale.z = z;
-	mTransformNeedsUpdate = true;
+	setScale(core::vector3d(x, y, z));
 }
 
 void Transform::setScale(const core::vector3d& scale)
 {
-	mScale = scale;
-	mTransformNeedsUpdate = true;
+	TransformHierarchy::getInstance()->getScale(mHandle) = scale;
+	TransformHierarchy::getInstance()->setDirty(mHandle);
 }
 
 bool Transform::getInheritOrientation()
 {
-	return mInheritOrientation;
+	return TransformHierarchy::getInstance()->getInheritOrientation(mHandle);
 }
 
 void Transform::setInheritOrientation(bool inherit)
 {
-	mInheritOrientation = inherit;
+	TransformHierarchy::getInstance()->setInheritOrientation(mHandle, inherit);
 }
 
 bool Transform::getInheritScale()
 {
-	return mInheritScale;
+	return TransformHierarchy::getInstance()->getInheritScale(mHandle);
 }
 
 void Transform::setInheritScale(bool inherit)
 {
-	mInheritScale = inherit;
+	TransformHierarchy::getInstance()->setInheritScale(mHandle, inherit);
 }
 
 const core::vector3d& Transform::getAbsolutePosition()
 {
-	return mAbsolutePosition;
+	return TransformHierarchy::getInstance()->getAbsolutePosition(mHandle);
 }
 
 const core::quaternion& Transform::getAbsoluteOrientation()
 {
-	return mAbsoluteOrientation;
+	return TransformHierarchy::getInstance()->getAbsoluteOrientation(mHandle);
 }
 
 const core::vector3d& Transform::getAbsoluteScale()
 {
-	return mAbsoluteScale;
+	return TransformHierarchy::getInstance()->getAbsoluteScale(mHandle);
 }
 
 void Transform::scale(const core::vector3d &scale)
 {
-	core::matrix4 m;
-	m.setScale(scale);
-	m.transformVector(mScale);
+	core::vector3d& localScale = TransformHierarchy::getInstance()->getScale(mHandle);
+	localScale.x *= scale.x;
+	localScale.y *= scale.y;
+	localScale.z *= scale.z;
 
-	mTransformNeedsUpdate = true;
+	TransformHierarchy::getInstance()->setDirty(mHandle);
 }
 
 void Transform::translate(const core::vector3d &d,  TransformSpace relativeTo)
 {
+	core::vector3d& position = TransformHierarchy::getInstance()->getPosition(mHandle);
+	const core::quaternion& orientation = TransformHierarchy::getInstance()->getOrientation(mHandle);
+
 	switch (relativeTo)
 	{
 	case TRANSFORM_SPACE_LOCAL:
 		// position is relative to parent so transform downwards
-		mPosition += mOrientation * d;
+		position += orientation * d;
 		break;
 	case TRANSFORM_SPACE_PARENT:
-		mPosition += d;
+		position += d;
 		break;
 	case TRANSFORM_SPACE_WORLD:
 		// position is relative to parent so transform upwards
 		GameObject* pParent = mGameObject->getParent();
 		if (pParent != nullptr)
 		{
-			Transform* pParentTransform = static_cast<Transform*>(pParent->getComponent(COMPONENT_TYPE_TRANSFORM));
+			Transform* pParentTransform = pParent->getTransform();
 			if (pParentTransform != nullptr)
 			{
 				core::vector3d offset = pParentTransform->getAbsoluteOrientation().getInverse() * d;
 				core::matrix4 m;
 				m.setInverseScale(pParentTransform->getAbsoluteScale());
 				m.transformVector(offset);
-				mPosition += offset;
+				position += offset;
 			}
 			else
 			{
-				mPosition += d;
+				position += d;
 			}
 		}
 		else
 		{
-			mPosition += d;
+			position += d;
 		}
 		break;		
 	}
 
-	mTransformNeedsUpdate = true;
+	TransformHierarchy::getInstance()->setDirty(mHandle);
 }
 
 void Transform::rotate(const core::quaternion &q, TransformSpace relativeTo)
 {
+	core::quaternion& orientation = TransformHierarchy::getInstance()->getOrientation(mHandle);
+
 	// Normalise quaternion to avoid drift
 	core::quaternion qnorm = q;
 	qnorm.normalize();
@@ -211,19 +213,19 @@ void Transform::rotate(const core::quaternion &q, TransformSpace relativeTo)
 	{
 	case TRANSFORM_SPACE_LOCAL:
 		// Note the order of the mult, i.e. q comes after
-		mOrientation = mOrientation * qnorm;
+		orientation = orientation * qnorm;
 		break;
 	case TRANSFORM_SPACE_PARENT:
 		// Rotations are normally relative to local axes, transform up
-		mOrientation = qnorm * mOrientation;
+		orientation = qnorm * orientation;
 		break;
 	case TRANSFORM_SPACE_WORLD:
 		// Rotations are normally relative to local axes, transform up
-		mOrientation = mOrientation * getAbsoluteOrientation().getInverse()	* qnorm * getAbsoluteOrientation();
+		orientation = orientation * getAbsoluteOrientation().getInverse()	* qnorm * getAbsoluteOrientation();
 		break;		
 	}
 
-	mTransformNeedsUpdate = true;
+	TransformHierarchy::getInstance()->setDirty(mHandle);
 }
 
 void Transform::rotate(const float& degrees, const core::vector3d &axis, TransformSpace relativeTo)
@@ -248,92 +250,30 @@ void Transform::rotateZ(float degrees, TransformSpace relativeTo)
 	rotate(degrees, core::vector3d::UNIT_Z, relativeTo);
 }
 
-void Transform::updateImpl(float elapsedTime)
+unsigned int Transform::getHandle() const
 {
-	if (mTransformNeedsUpdate)
-	{
-		if (mGameObject != nullptr)
-		{
-			mGameObject->sendMessage(this, MESSAGE_TRANSFORM_NEEDS_UPDATE);
+	return mHandle;
+}
 
-			GameObject* pParent = mGameObject->getParent();
-			if (pParent != nullptr)
-			{
-				Transform* pParentTransform = static_cast<Transform*>(pParent->getComponent(COMPONENT_TYPE_TRANSFORM));
-				if (pParentTransform != nullptr)
-				{
-					// Combine orientation with that of parent
-					const core::quaternion& parentOrientation = pParentTransform->getAbsoluteOrientation();
-					if (mInheritOrientation)
-					{
-						// Combine orientation with that of parent
-						mAbsoluteOrientation = parentOrientation * mOrientation;
-					}
-					else
-					{
-						// No inheritance
-						mAbsoluteOrientation = mOrientation;
-					}
-
-					const core::vector3d& parentScale = pParentTransform->getAbsoluteScale();
-					// Update scale
-					if (mInheritScale)
-					{
-						// Set own scale, NB just combine as equivalent axes, no shearing
-						mAbsoluteScale = mScale;
-
-						core::matrix4 m;
-						m.setScale(parentScale);
-						m.transformVector(mAbsoluteScale);
-					}
-					else
-					{
-						// No inheritance
-						mAbsoluteScale = mScale;
-					}
-
-					const core::vector3d& parentPosition = pParentTransform->getAbsolutePosition();
-			
-					// Change position vector based on parent's orientation & scale
-					mAbsolutePosition = mPosition;
-					core::matrix4 m;
-					m.setScale(parentScale);
-					m.transformVector(mAbsoluteScale);
-
-					mAbsolutePosition = parentOrientation * mAbsolutePosition;
-					// Add altered position vector to parents
-					mAbsolutePosition += parentPosition;
-				}
-				else
-				{
-					// Parent has no transform
-					mAbsoluteOrientation = mOrientation;
-					mAbsolutePosition = mPosition;
-					mAbsoluteScale = mScale;
-				}
-			}
-			else
-			{
-				// Root node, no parent
-				mAbsoluteOrientation = mOrientation;
-				mAbsolutePosition = mPosition;
-				mAbsoluteScale = mScale;
-			}
-		}
+void Transform::onAttachImpl()
+{
+	TransformHierarchy::getInstance()->invalidateHierarchy();
+}
 
-		mTransformNeedsUpdate = false;
-	}
+void Transform::onDetachImpl()
+{
+	TransformHierarchy::getInstance()->invalidateHierarchy();
 }
 
 void Transform::onMessageImpl(unsigned int messageID)
 {
 	if (messageID == MESSAGE_PARENT_CHANGED)
 	{
-		mTransformNeedsUpdate = true;
+		TransformHierarchy::getInstance()->invalidateHierarchy();
 	}
 	else if (messageID == MESSAGE_TRANSFORM_NEEDS_UPDATE)
 	{
-		mTransformNeedsUpdate = true;
+		TransformHierarchy::getInstance()->setDirty(mHandle);
 	}
 }
 
@@ -30,14 +30,15 @@ THE SOFTWARE.
 namespace game
 {
 
-TransformFactory::TransformFactory(): ComponentFactory()
+TransformFactory::TransformFactory(): PooledComponentFactory<Transform>()
 {
 	mName = "Transform";
+	mThreadSafe = true;
 }
 
 Component* TransformFactory::createComponent()
 {
-	return new Transform();
+	return mPool.create();
 }
 
 void TransformFactory::destroyComponent(Component* component)
@@ -45,7 +46,7 @@ void TransformFactory::destroyComponent(Component* component)
 	Transform* pTransform = static_cast<Transform*>(component);
 
 	assert(pTransform != nullptr);
-	SAFE_DELETE(pTransform);
+	mPool.destroy(pTransform);
 }
 
 } // end namespace game
\ No newline at end of file
@@ -0,0 +1,562 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <game/TransformHierarchy.h>
+#include <game/Transform.h>
+#include <game/GameObject.h>
+#include <game/Component.h>
+#include <game/ComponentDefines.h>
+#include <game/MessageDefines.h>
+#include <core/JobSystem.h>
+
+#include <algorithm>
+#include <atomic>
+
+template<> game::TransformHierarchy* core::Singleton<game::TransformHierarchy>::m_Singleton = nullptr;
+
+namespace game
+{
+
+//! Number of nodes a job processes at once, small levels are updated on the calling thread.
+static const unsigned int TRANSFORM_UPDATE_GRAIN_SIZE = 512;
+
+static const unsigned int INVALID_INDEX = 0xFFFFFFFF;
+
+struct LevelUpdate
+{
+	TransformHierarchy* hierarchy;
+	unsigned int offset;
+
+	//! Range of the nodes that changed, empty while begin >= end.
+	std::atomic<unsigned int> changedBegin;
+	std::atomic<unsigned int> changedEnd;
+};
+
+static void atomicMin(std::atomic<unsigned int>& value, unsigned int other)
+{
+	unsigned int current = value.load();
+	while (other < current && !value.compare_exchange_weak(current, other)) {}
+}
+
+static void atomicMax(std::atomic<unsigned int>& value, unsigned int other)
+{
+	unsigned int current = value.load();
+	while (other > current && !value.compare_exchange_weak(current, other)) {}
+}
+
+TransformHierarchy::TransformHierarchy()
+{
+	mHierarchyNeedsUpdate = false;
+}
+
+TransformHierarchy::~TransformHierarchy() {}
+
+unsigned int TransformHierarchy::addTransform(Transform* transform)
+{
+	unsigned int handle = 0;
+	if (!mFreeHandles.empty())
+	{
+		handle = mFreeHandles.back();
+		mFreeHandles.pop_back();
+	}
+	else
+	{
+		handle = (unsigned int)mHandleIndices.size();
+		mHandleIndices.push_back(INVALID_INDEX);
+	}
+
+	// new transforms are appended and moved to their level by the next rebuild
+	unsigned int index = (unsigned int)mTransforms.size();
+	mHandleIndices[handle] = index;
+	mIndexHandles.push_back(handle);
+
+	mPositions.push_back(core::vector3d::ORIGIN_3D);
+	mOrientations.push_back(core::quaternion::IDENTITY);
+	mScales.push_back(core::vector3d::UNIT_SCALE);
+
+	mAbsolutePositions.push_back(core::vector3d::ORIGIN_3D);
+	mAbsoluteOrientations.push_back(core::quaternion::IDENTITY);
+	mAbsoluteScales.push_back(core::vector3d::UNIT_SCALE);
+
+	mParents.push_back(INVALID_INDEX);
+	mFlags.push_back(TRANSFORM_FLAG_DIRTY | TRANSFORM_FLAG_INHERIT_ORIENTATION | TRANSFORM_FLAG_INHERIT_SCALE);
+	mDepths.push_back(0);
+	mTransforms.push_back(transform);
+
+	mHierarchyNeedsUpdate = true;
+
+	return handle;
+}
+
+void TransformHierarchy::removeTransform(unsigned int handle)
+{
+	if (handle >= mHandleIndices.size() || mHandleIndices[handle] == INVALID_INDEX)
+		return;
+
+	// the slot is only released by the next rebuild so that the other indices stay valid
+	unsigned int index = mHandleIndices[handle];
+	mTransforms[index] = nullptr;
+	mIndexHandles[index] = INVALID_INDEX;
+
+	mHandleIndices[handle] = INVALID_INDEX;
+	mFreeHandles.push_back(handle);
+
+	mHierarchyNeedsUpdate = true;
+}
+
+void TransformHierarchy::invalidateHierarchy()
+{
+	mHierarchyNeedsUpdate = true;
+}
+
+void TransformHierarchy::setDirty(unsigned int handle)
+{
+	unsigned int index = mHandleIndices[handle];
+	mFlags[index] |= TRANSFORM_FLAG_DIRTY;
+
+	unsigned int depth = mDepths[index];
+	if (depth < mDirtyBegins.size())
+	{
+		if (index < mDirtyBegins[depth])
+			mDirtyBegins[depth] = index;
+		if (index + 1 > mDirtyEnds[depth])
+			mDirtyEnds[depth] = index + 1;
+	}
+}
+
+core::vector3d& TransformHierarchy::getPosition(unsigned int handle)
+{
+	return mPositions[mHandleIndices[handle]];
+}
+
+core::quaternion& TransformHierarchy::getOrientation(unsigned int handle)
+{
+	return mOrientations[mHandleIndices[handle]];
+}
+
+core::vector3d& TransformHierarchy::getScale(unsigned int handle)
+{
+	return mScales[mHandleIndices[handle]];
+}
+
+const core::vector3d& TransformHierarchy::getAbsolutePosition(unsigned int handle)
+{
+	return mAbsolutePositions[mHandleIndices[handle]];
+}
+
+const core::quaternion& TransformHierarchy::getAbsoluteOrientation(unsigned int handle)
+{
+	return mAbsoluteOrientations[mHandleIndices[handle]];
+}
+
+const core::vector3d& TransformHierarchy::getAbsoluteScale(unsigned int handle)
+{
+	return mAbsoluteScales[mHandleIndices[handle]];
+}
+
+bool TransformHierarchy::getInheritOrientation(unsigned int handle)
+{
+	return (mFlags[mHandleIndices[handle]] & TRANSFORM_FLAG_INHERIT_ORIENTATION) != 0;
+}
+
+void TransformHierarchy::setInheritOrientation(unsigned int handle, bool inherit)
+{
+	unsigned int index = mHandleIndices[handle];
+	if (inherit)
+		mFlags[index] |= TRANSFORM_FLAG_INHERIT_ORIENTATION;
+	else
+		mFlags[index] &= ~TRANSFORM_FLAG_INHERIT_ORIENTATION;
+
+	setDirty(handle);
+}
+
+bool TransformHierarchy::getInheritScale(unsigned int handle)
+{
+	return (mFlags[mHandleIndices[handle]] & TRANSFORM_FLAG_INHERIT_SCALE) != 0;
+}
+
+void TransformHierarchy::setInheritScale(unsigned int handle, bool inherit)
+{
+	unsigned int index = mHandleIndices[handle];
+	if (inherit)
+		mFlags[index] |= TRANSFORM_FLAG_INHERIT_SCALE;
+	else
+		mFlags[index] &= ~TRANSFORM_FLAG_INHERIT_SCALE;
+
+	setDirty(handle);
+}
+
+unsigned int TransformHierarchy::getLevelCount() const
+{
+	if (mLevelOffsets.empty())
+		return 0;
+
+	return (unsigned int)mLevelOffsets.size() - 1;
+}
+
+unsigned int TransformHierarchy::getTransformCount() const
+{
+	return (unsigned int)(mHandleIndices.size() - mFreeHandles.size());
+}
+
+void TransformHierarchy::update()
+{
+	if (mHierarchyNeedsUpdate)
+		rebuild();
+
+	core::JobSystem* pJobSystem = core::JobSystem::getInstance();
+
+	// the changed range of every level, its children are the range of the next level to update
+	std::vector<unsigned int> changedRanges;
+	unsigned int changedBegin = 0;
+	unsigned int changedEnd = 0;
+
+	unsigned int levelCount = getLevelCount();
+	for (unsigned int level = 0; level < levelCount; ++level)
+	{
+		unsigned int begin = mDirtyBegins[level];
+		unsigned int end = mDirtyEnds[level];
+
+		if (changedBegin < changedEnd)
+		{
+			// the nodes of a level are sorted by parent, the children of a range of parents are a range too
+			std::vector<unsigned int>::const_iterator levelBegin = mParents.begin() + mLevelOffsets[level];
+			std::vector<unsigned int>::const_iterator levelEnd = mParents.begin() + mLevelOffsets[level + 1];
+
+			unsigned int childBegin = (unsigned int)(std::lower_bound(levelBegin, levelEnd, changedBegin) - mParents.begin());
+			unsigned int childEnd = (unsigned int)(std::lower_bound(levelBegin, levelEnd, changedEnd) - mParents.begin());
+
+			if (childBegin < childEnd)
+			{
+				begin = std::min(begin, childBegin);
+				end = std::max(end, childEnd);
+			}
+		}
+
+		mDirtyBegins[level] = INVALID_INDEX;
+		mDirtyEnds[level] = 0;
+
+		changedBegin = 0;
+		changedEnd = 0;
+
+		// a level is clean unless one of its nodes was touched or one of their parents moved
+		if (begin >= end)
+			continue;
+
+		LevelUpdate levelUpdate;
+		levelUpdate.hierarchy = this;
+		levelUpdate.offset = begin;
+		levelUpdate.changedBegin = INVALID_INDEX;
+		levelUpdate.changedEnd = 0;
+
+		if (pJobSystem != nullptr)
+			pJobSystem->parallelFor(end - begin, &TransformHierarchy::updateRange, &levelUpdate, TRANSFORM_UPDATE_GRAIN_SIZE);
+		else
+			updateRange(0, end - begin, &levelUpdate);
+
+		changedBegin = levelUpdate.changedBegin;
+		changedEnd = levelUpdate.changedEnd;
+		if (changedBegin < changedEnd)
+		{
+			changedRanges.push_back(changedBegin);
+			changedRanges.push_back(changedEnd);
+		}
+	}
+
+	// notifications are sent on the calling thread as the components are not thread safe
+	for (unsigned int i = 0; i < changedRanges.size(); i += 2)
+	{
+		notifyChanged(changedRanges[i], changedRanges[i + 1]);
+	}
+}
+
+TransformHierarchy* TransformHierarchy::getInstance()
+{
+	return core::Singleton<TransformHierarchy>::getInstance();
+}
+
+void TransformHierarchy::rebuild()
+{
+	unsigned int count = (unsigned int)mTransforms.size();
+
+	// resolve the parent of every live node from the game objects
+	std::vector<unsigned int> parents(count, INVALID_INDEX);
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		Transform* pTransform = mTransforms[i];
+		if (pTransform == nullptr || pTransform->getGameObject() == nullptr)
+			continue;
+
+		GameObject* pParent = pTransform->getGameObject()->getParent();
+		if (pParent == nullptr)
+			continue;
+
+		Transform* pParentTransform = pParent->getTransform();
+		if (pParentTransform != nullptr && pParentTransform != pTransform)
+			parents[i] = mHandleIndices[pParentTransform->getHandle()];
+	}
+
+	// compute the depths walking up the parent chains, a chain longer than the node count is a cycle
+	std::vector<unsigned int> depths(count, INVALID_INDEX);
+	std::vector<unsigned int> chain;
+	unsigned int maxDepth = 0;
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		if (mTransforms[i] == nullptr || depths[i] != INVALID_INDEX)
+			continue;
+
+		chain.clear();
+		unsigned int node = i;
+		while (node != INVALID_INDEX && depths[node] == INVALID_INDEX && chain.size() <= count)
+		{
+			chain.push_back(node);
+			node = parents[node];
+		}
+
+		if (chain.size() > count)
+		{
+			// break the cycle at the first node
+			parents[i] = INVALID_INDEX;
+			node = INVALID_INDEX;
+			chain.resize(1);
+		}
+
+		unsigned int depth = (node == INVALID_INDEX) ? 0 : depths[node] + 1;
+		std::vector<unsigned int>::reverse_iterator j;
+		for (j = chain.rbegin(); j != chain.rend(); ++j)
+		{
+			depths[*j] = depth++;
+		}
+
+		if (depth - 1 > maxDepth)
+			maxDepth = depth - 1;
+	}
+
+	// counting sort of the live nodes by depth
+	unsigned int levelCount = (count > 0) ? maxDepth + 1 : 0;
+	std::vector<unsigned int> offsets(levelCount + 1, 0);
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		if (mTransforms[i] != nullptr)
+			offsets[depths[i] + 1]++;
+	}
+	for (unsigned int level = 0; level < levelCount; ++level)
+	{
+		offsets[level + 1] += offsets[level];
+	}
+
+	// breadth first from the roots, so the nodes of a level are sorted by the index of their parent
+	// and the children of a range of parents are a range of the next level
+	std::vector<unsigned int> childOffsets(count + 1, 0);
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		if (mTransforms[i] != nullptr && parents[i] != INVALID_INDEX)
+			childOffsets[parents[i] + 1]++;
+	}
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		childOffsets[i + 1] += childOffsets[i];
+	}
+
+	std::vector<unsigned int> children(childOffsets[count]);
+	std::vector<unsigned int> childCursors(childOffsets.begin(), childOffsets.end() - 1);
+	std::vector<unsigned int> order;
+	order.reserve(count);
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		if (mTransforms[i] == nullptr)
+			continue;
+
+		if (parents[i] != INVALID_INDEX)
+			children[childCursors[parents[i]]++] = i;
+		else
+			order.push_back(i);
+	}
+
+	for (unsigned int i = 0; i < order.size(); ++i)
+	{
+		unsigned int node = order[i];
+		order.insert(order.end(), children.begin() + childOffsets[node], children.begin() + childOffsets[node + 1]);
+	}
+
+	std::vector<unsigned int> newIndices(count, INVALID_INDEX);
+	for (unsigned int i = 0; i < order.size(); ++i)
+	{
+		newIndices[order[i]] = i;
+	}
+
+	unsigned int liveCount = (levelCount > 0) ? offsets[levelCount] : 0;
+
+	std::vector<core::vector3d> positions(liveCount);
+	std::vector<core::quaternion> orientations(liveCount);
+	std::vector<core::vector3d> scales(liveCount);
+	std::vector<core::vector3d> absolutePositions(liveCount);
+	std::vector<core::quaternion> absoluteOrientations(liveCount);
+	std::vector<core::vector3d> absoluteScales(liveCount);
+	std::vector<unsigned int> newParents(liveCount);
+	std::vector<unsigned char> flags(liveCount);
+	std::vector<unsigned int> newDepths(liveCount);
+	std::vector<Transform*> transforms(liveCount);
+	std::vector<unsigned int> indexHandles(liveCount);
+
+	mDirtyBegins.assign(levelCount, INVALID_INDEX);
+	mDirtyEnds.assign(levelCount, 0);
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		unsigned int index = newIndices[i];
+		if (index == INVALID_INDEX)
+			continue;
+
+		positions[index] = mPositions[i];
+		orientations[index] = mOrientations[i];
+		scales[index] = mScales[i];
+		absolutePositions[index] = mAbsolutePositions[i];
+		absoluteOrientations[index] = mAbsoluteOrientations[i];
+		absoluteScales[index] = mAbsoluteScales[i];
+		newParents[index] = (parents[i] != INVALID_INDEX) ? newIndices[parents[i]] : INVALID_INDEX;
+		newDepths[index] = depths[i];
+		transforms[index] = mTransforms[i];
+		indexHandles[index] = mIndexHandles[i];
+
+		// only the nodes that got a new parent have to be recomputed
+		unsigned char flag = mFlags[i];
+		if (parents[i] != mParents[i])
+			flag |= TRANSFORM_FLAG_DIRTY;
+		flags[index] = flag;
+
+		if ((flag & TRANSFORM_FLAG_DIRTY) != 0)
+		{
+			mDirtyBegins[depths[i]] = std::min(mDirtyBegins[depths[i]], index);
+			mDirtyEnds[depths[i]] = std::max(mDirtyEnds[depths[i]], index + 1);
+		}
+
+		mHandleIndices[mIndexHandles[i]] = index;
+	}
+
+	mPositions.swap(positions);
+	mOrientations.swap(orientations);
+	mScales.swap(scales);
+	mAbsolutePositions.swap(absolutePositions);
+	mAbsoluteOrientations.swap(absoluteOrientations);
+	mAbsoluteScales.swap(absoluteScales);
+	mParents.swap(newParents);
+	mFlags.swap(flags);
+	mDepths.swap(newDepths);
+	mTransforms.swap(transforms);
+	mIndexHandles.swap(indexHandles);
+
+	offsets.resize(levelCount + 1);
+	mLevelOffsets.swap(offsets);
+	if (levelCount == 0)
+		mLevelOffsets.clear();
+
+	mHierarchyNeedsUpdate = false;
+}
+
+void TransformHierarchy::updateRange(unsigned int begin, unsigned int end, void* data)
+{
+	LevelUpdate* pLevelUpdate = static_cast<LevelUpdate*>(data);
+	TransformHierarchy* pHierarchy = pLevelUpdate->hierarchy;
+
+	unsigned int changedBegin = INVALID_INDEX;
+	unsigned int changedEnd = 0;
+
+	for (unsigned int i = pLevelUpdate->offset + begin; i < pLevelUpdate->offset + end; ++i)
+	{
+		unsigned char flag = pHierarchy->mFlags[i];
+		unsigned int parent = pHierarchy->mParents[i];
+
+		bool parentChanged = (parent != INVALID_INDEX && (pHierarchy->mFlags[parent] & TRANSFORM_FLAG_CHANGED) != 0);
+		if ((flag & TRANSFORM_FLAG_DIRTY) == 0 && !parentChanged)
+			continue;
+
+		const core::vector3d& position = pHierarchy->mPositions[i];
+		const core::quaternion& orientation = pHierarchy->mOrientations[i];
+		const core::vector3d& scale = pHierarchy->mScales[i];
+
+		if (parent != INVALID_INDEX)
+		{
+			const core::vector3d& parentPosition = pHierarchy->mAbsolutePositions[parent];
+			const core::quaternion& parentOrientation = pHierarchy->mAbsoluteOrientations[parent];
+			const core::vector3d& parentScale = pHierarchy->mAbsoluteScales[parent];
+
+			if ((flag & TRANSFORM_FLAG_INHERIT_ORIENTATION) != 0)
+				pHierarchy->mAbsoluteOrientations[i] = parentOrientation * orientation;
+			else
+				pHierarchy->mAbsoluteOrientations[i] = orientation;
+
+			// combine as equivalent axes, no shearing
+			if ((flag & TRANSFORM_FLAG_INHERIT_SCALE) != 0)
+				pHierarchy->mAbsoluteScales[i] = core::vector3d(parentScale.x * scale.x, parentScale.y * scale.y, parentScale.z * scale.z);
+			else
+				pHierarchy->mAbsoluteScales[i] = scale;
+
+			// change position vector based on parent's orientation & scale
+			core::vector3d scaledPosition(parentScale.x * position.x, parentScale.y * position.y, parentScale.z * position.z);
+			pHierarchy->mAbsolutePositions[i] = parentOrientation * scaledPosition + parentPosition;
+		}
+		else
+		{
+			pHierarchy->mAbsolutePositions[i] = position;
+			pHierarchy->mAbsoluteOrientations[i] = orientation;
+			pHierarchy->mAbsoluteScales[i] = scale;
+		}
+
+		pHierarchy->mFlags[i] = (flag & ~TRANSFORM_FLAG_DIRTY) | TRANSFORM_FLAG_CHANGED;
+
+		if (changedBegin == INVALID_INDEX)
+			changedBegin = i;
+		changedEnd = i + 1;
+	}
+
+	if (changedBegin < changedEnd)
+	{
+		atomicMin(pLevelUpdate->changedBegin, changedBegin);
+		atomicMax(pLevelUpdate->changedEnd, changedEnd);
+	}
+}
+
+void TransformHierarchy::notifyChanged(unsigned int begin, unsigned int end)
+{
+	for (unsigned int i = begin; i < end; ++i)
+	{
+		if ((mFlags[i] & TRANSFORM_FLAG_CHANGED) == 0)
+			continue;
+
+		mFlags[i] &= ~TRANSFORM_FLAG_CHANGED;
+
+		Transform* pTransform = mTransforms[i];
+		GameObject* pGameObject = pTransform->getGameObject();
+		if (pGameObject == nullptr)
+			continue;
+
+		// the hierarchy update is the sync point of this message and the changed flag already merges the moves of a frame,
+		// so it is delivered here rather than queued; children are handled by the hierarchy, only the other components are told
+		pGameObject->deliverMessage(pTransform, MESSAGE_TRANSFORM_NEEDS_UPDATE);
+	}
+}
+
+} // end namespace game
\ No newline at end of file
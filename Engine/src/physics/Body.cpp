@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include <game/GameObject.h>
 #include <game/Transform.h>
 #include <game/ComponentDefines.h>
+#include <game/MessageDefines.h>
 #include <resource/ResourceEvent.h>
 #include <resource/ResourceManager.h>
 #include <core/Utils.h>
@@ -42,6 +43,7 @@ namespace physics
 Body::Body(): game::Component()
 {
 	mType = game::COMPONENT_TYPE_BODY;
+	mMessageMask = MESSAGE_MASK_NONE;
 
 	mBodyType = BT_STATIC;
 
@@ -270,7 +272,7 @@ void Body::applyForce(const core::vector3d& force)
 {
 	if (mGameObject != nullptr)
 	{
-		game::Transform* pTransform = static_cast<game::Transform*>(mGameObject->getComponent(game::COMPONENT_TYPE_TRANSFORM));
+		game::Transform* pTransform = mGameObject->getTransform();
 		if (pTransform != nullptr)
 		{
 			mForce = pTransform->getOrientation() * force;
@@ -287,7 +289,7 @@ void Body::applyLinearImpulse(const core::vector3d& linearImpulse)
 {
 	if (mGameObject != nullptr)
 	{
-		game::Transform* pTransform = static_cast<game::Transform*>(mGameObject->getComponent(game::COMPONENT_TYPE_TRANSFORM));
+		game::Transform* pTransform = mGameObject->getTransform();
 		if (pTransform != nullptr)
 		{
 			mLinearImpulse = pTransform->getOrientation() * linearImpulse;
@@ -299,7 +301,7 @@ void Body::applyAngularImpulse(const core::vector3d& angularImpulse)
 {
 	if (mGameObject != nullptr)
 	{
-		game::Transform* pTransform = static_cast<game::Transform*>(mGameObject->getComponent(game::COMPONENT_TYPE_TRANSFORM));
+		game::Transform* pTransform = mGameObject->getTransform();
 		if (pTransform != nullptr)
 		{
 			mAngularImpulse = pTransform->getOrientation() * angularImpulse;
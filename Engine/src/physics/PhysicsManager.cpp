@@ -48,6 +48,7 @@ namespace physics
 
 CollisionEvent* PhysicsManager::mCollisionEvent = nullptr;
 std::list<CollisionEventReceiver*> PhysicsManager::mCollisionEventReceivers;
+std::vector<PhysicsManager::QueuedCollisionEvent> PhysicsManager::mQueuedCollisionEvents;
 
 PhysicsManager::PhysicsManager(): core::System("PhysicsManager")
 {
@@ -284,45 +285,67 @@ void PhysicsManager::removeJointFactory()
 	mJointFactory = nullptr;
 }
 
-void PhysicsManager::fireCollisionStarted(Body* body1, Body* body2, const std::vector<CollisionPoint*>& points)
+void PhysicsManager::fireCollisionEvents()
 {
-	mCollisionEvent->mBody1 = body1;
-	mCollisionEvent->mBody2 = body2;
-	mCollisionEvent->mCollisionPoints = points;
+	// a receiver may cause new events, they wait for the next call
+	std::vector<QueuedCollisionEvent> events;
+	events.swap(mQueuedCollisionEvents);
 
-	// Do collision started event
-	std::list<CollisionEventReceiver*>::iterator i;
-	for (i = mCollisionEventReceivers.begin();i != mCollisionEventReceivers.end(); ++i)
+	std::vector<QueuedCollisionEvent>::const_iterator i;
+	for (i = events.begin(); i != events.end(); ++i)
 	{
-		(*i)->collisionStarted(*mCollisionEvent);
+		mCollisionEvent->mBody1 = i->body1;
+		mCollisionEvent->mBody2 = i->body2;
+		mCollisionEvent->mCollisionPoints = i->points;
+
+		std::list<CollisionEventReceiver*>::iterator j;
+		for (j = mCollisionEventReceivers.begin(); j != mCollisionEventReceivers.end(); ++j)
+		{
+			switch (i->type)
+			{
+			case COLLISION_EVENT_STARTED:
+				(*j)->collisionStarted(*mCollisionEvent);
+				break;
+			case COLLISION_EVENT_UPDATE:
+				(*j)->collisionUpdate(*mCollisionEvent);
+				break;
+			case COLLISION_EVENT_ENDED:
+				(*j)->collisionEnded(*mCollisionEvent);
+				break;
+			}
+		}
 	}
+
+	mCollisionEvent->mCollisionPoints.clear();
 }
 
-void PhysicsManager::fireCollisionUpdate(Body* body1, Body* body2, const std::vector<CollisionPoint*>& points)
+void PhysicsManager::fireCollisionStarted(Body* body1, Body* body2, const std::vector<CollisionPoint*>& points)
 {
-	mCollisionEvent->mBody1 = body1;
-	mCollisionEvent->mBody2 = body2;
-	mCollisionEvent->mCollisionPoints = points;
+	QueuedCollisionEvent event;
+	event.type = COLLISION_EVENT_STARTED;
+	event.body1 = body1;
+	event.body2 = body2;
+	event.points = points;
+	mQueuedCollisionEvents.push_back(event);
+}
 
-	// Do collision updated event
-	std::list<CollisionEventReceiver*>::iterator i;
-	for (i = mCollisionEventReceivers.begin();i != mCollisionEventReceivers.end(); ++i)
-	{
-		(*i)->collisionUpdate(*mCollisionEvent);
-	}
+void PhysicsManager::fireCollisionUpdate(Body* body1, Body* body2, const std::vector<CollisionPoint*>& points)
+{
+	QueuedCollisionEvent event;
+	event.type = COLLISION_EVENT_UPDATE;
+	event.body1 = body1;
+	event.body2 = body2;
+	event.points = points;
+	mQueuedCollisionEvents.push_back(event);
 }
 
 void PhysicsManager::fireCollisionEnded(Body* body1, Body* body2)
 {
-	mCollisionEvent->mBody1 = body1;
-	mCollisionEvent->mBody2 = body2;
-
-	// Do collision ended event
-	std::list<CollisionEventReceiver*>::iterator i;
-	for (i = mCollisionEventReceivers.begin();i != mCollisionEventReceivers.end(); ++i)
-	{
-		(*i)->collisionEnded(*mCollisionEvent);
-	}
+	QueuedCollisionEvent event;
+	event.type = COLLISION_EVENT_ENDED;
+	event.body1 = body1;
+	event.body2 = body2;
+	mQueuedCollisionEvents.push_back(event);
 }
 
 void PhysicsManager::initializeImpl()
@@ -338,6 +361,9 @@ void PhysicsManager::initializeImpl()
 
 void PhysicsManager::uninitializeImpl()
 {
+	// the queued events point to the bodies removed below
+	mQueuedCollisionEvents.clear();
+
 	// Remove all Bodies
 	removeAllBodies();
 
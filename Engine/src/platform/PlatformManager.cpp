@@ -25,8 +25,17 @@ THE SOFTWARE.
 */
 
 #include <platform/PlatformManager.h>
+#include <core/Simd.h>
+#include <core/Log.h>
 #include <CPUInfo.h>
 
+#if ENGINE_COMPILER == COMPILER_MSVC
+#	include <intrin.h>
+#	include <immintrin.h>
+#elif ENGINE_COMPILER == COMPILER_GNUC && (defined(__i386__) || defined(__x86_64__))
+#	include <cpuid.h>
+#endif
+
 template<> platform::PlatformManager* core::Singleton<platform::PlatformManager>::m_Singleton = nullptr;
 
 namespace platform
@@ -41,6 +50,10 @@ PlatformManager::PlatformManager(): core::System("PlatformManager")
 
 	mCPUInfo = nullptr;
 
+	mAVX	= false;
+	mAVX2	= false;
+	mFMA	= false;
+
 	mProcessorCount = getCPUCount();
 	mCPUInfos = new CPUInfo[mProcessorCount];
 	mProcessorCount = getMultipleCPUInfo(mCPUInfos);
@@ -56,6 +69,8 @@ PlatformManager::PlatformManager(): core::System("PlatformManager")
 		mCPUType	= mCPUInfo->getProcessorTypeName();
 		mCPUBrand	= mCPUInfo->getProcessorBrandName();
 	}
+
+	checkExtendedStateFeatures();
 }
 
 PlatformManager::~PlatformManager() {}
@@ -352,6 +367,24 @@ bool PlatformManager::checkCPUFeature(CpuFeature feature)
 				return true;
 		}
 		break;
+	case CPU_FEATURE_AVX:
+		{
+			if (mAVX)
+				return true;
+		}
+		break;
+	case CPU_FEATURE_AVX2:
+		{
+			if (mAVX2)
+				return true;
+		}
+		break;
+	case CPU_FEATURE_FMA:
+		{
+			if (mFMA)
+				return true;
+		}
+		break;
 	}
 
 	return false;
@@ -405,6 +438,82 @@ unsigned int PlatformManager::getCPUCacheSize(CacheLevel level)
 	return 0;
 }
 
+void PlatformManager::initializeImpl()
+{
+	// select the math kernels for this CPU
+	core::SimdLevel level = core::SIMD_LEVEL_NONE;
+	if (checkCPUFeature(CPU_FEATURE_AVX2))
+		level = core::SIMD_LEVEL_AVX2;
+	else if (checkCPUFeature(CPU_FEATURE_SSE2))
+		level = core::SIMD_LEVEL_SSE2;
+
+	core::setSimdLevel(level);
+
+	const char* levelNames[core::SIMD_LEVEL_COUNT] = {"scalar", "SSE2", "AVX2"};
+	if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage(mName, std::string("Math kernels: ") + levelNames[core::getSimdLevel()]);
+}
+
+void PlatformManager::checkExtendedStateFeatures()
+{
+	mAVX	= false;
+	mAVX2	= false;
+	mFMA	= false;
+
+	unsigned int regs[4] = {0, 0, 0, 0};
+	unsigned int maxLevel = 0;
+
+#if ENGINE_COMPILER == COMPILER_MSVC
+	__cpuid((int*)regs, 0);
+	maxLevel = regs[0];
+	if (maxLevel < 1)
+		return;
+
+	__cpuid((int*)regs, 1);
+#elif ENGINE_COMPILER == COMPILER_GNUC && (defined(__i386__) || defined(__x86_64__))
+	maxLevel = __get_cpuid_max(0, nullptr);
+	if (maxLevel < 1)
+		return;
+
+	__cpuid(1, regs[0], regs[1], regs[2], regs[3]);
+#else
+	return;
+#endif
+
+	bool osxsave	= (regs[2] & (1 << 27)) != 0;
+	bool avx		= (regs[2] & (1 << 28)) != 0;
+	bool fma		= (regs[2] & (1 << 12)) != 0;
+
+	if (!osxsave || !avx)
+		return;
+
+	// the OS has to save the XMM and YMM registers on context switches
+	unsigned long long xcr0 = 0;
+#if ENGINE_COMPILER == COMPILER_MSVC
+	xcr0 = _xgetbv(0);
+#elif ENGINE_COMPILER == COMPILER_GNUC && (defined(__i386__) || defined(__x86_64__))
+	unsigned int xcr0Low = 0;
+	unsigned int xcr0High = 0;
+	__asm__ __volatile__ ("xgetbv" : "=a" (xcr0Low), "=d" (xcr0High) : "c" (0));
+	xcr0 = ((unsigned long long)xcr0High << 32) | xcr0Low;
+#endif
+
+	if ((xcr0 & 0x6) != 0x6)
+		return;
+
+	mAVX = true;
+	mFMA = fma;
+
+	if (maxLevel >= 7)
+	{
+#if ENGINE_COMPILER == COMPILER_MSVC
+		__cpuidex((int*)regs, 7, 0);
+#elif ENGINE_COMPILER == COMPILER_GNUC && (defined(__i386__) || defined(__x86_64__))
+		__cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+		mAVX2 = (regs[1] & (1 << 5)) != 0;
+	}
+}
+
 PlatformManager* PlatformManager::getInstance()
 {
 	return core::Singleton<PlatformManager>::getInstance();
@@ -41,6 +41,7 @@ namespace render
 Camera::Camera(): game::Component()
 {
 	mType = game::COMPONENT_TYPE_CAMERA;
+	mMessageMask = MESSAGE_MASK(game::MESSAGE_TRANSFORM_NEEDS_UPDATE);
 	
 	mFixedUp = true;
 	mFixedUpAxis = core::vector3d::UNIT_Y;
@@ -244,7 +245,7 @@ void Camera::updateView()
 
 		if (mGameObject != nullptr)
 		{
-			game::Transform* pTransform = static_cast<game::Transform*>(mGameObject->getComponent(game::COMPONENT_TYPE_TRANSFORM));
+			game::Transform* pTransform = mGameObject->getTransform();
 			if (pTransform != nullptr)
 			{
 				core::vector3d pos = pTransform->getAbsolutePosition();
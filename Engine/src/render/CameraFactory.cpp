@@ -31,14 +31,15 @@ THE SOFTWARE.
 namespace render
 {
 
-CameraFactory::CameraFactory(): game::ComponentFactory()
+CameraFactory::CameraFactory(): game::PooledComponentFactory<Camera>()
 {
 	mName = "Camera";
+	mThreadSafe = true;
 }
 
 game::Component* CameraFactory::createComponent()
 {
-	Camera* pCamera = new Camera();
+	Camera* pCamera = mPool.create();
 
 	if (RenderManager::getInstance() != nullptr)
 		RenderManager::getInstance()->addCamera(pCamera);
@@ -54,7 +55,7 @@ void CameraFactory::destroyComponent(game::Component* component)
 		RenderManager::getInstance()->removeCamera(pCamera);
 
 	assert(pCamera != nullptr);
-	SAFE_DELETE(pCamera);
+	mPool.destroy(pCamera);
 }
 
 } // end namespace game
\ No newline at end of file
@@ -37,7 +37,7 @@ Color::Color(float red, float green, float blue, float alpha): r(red), g(green),
 
 Color::Color(const Color& other): r(other.r), g(other.g), b(other.b), a(other.a) {}
 
-inline Color& Color::operator=(const Color& other)
+Color& Color::operator=(const Color& other)
 {
 	r = other.r;
 	g = other.g;
@@ -46,12 +46,12 @@ inline Color& Color::operator=(const Color& other)
 	return *this;
 }
 
-inline Color Color::operator+(const Color& other) const
+Color Color::operator+(const Color& other) const
 {
 	return Color(r + other.r, g + other.g, b + other.b, a + other.a);
 }
 
-inline Color& Color::operator+=(const Color& other)
+Color& Color::operator+=(const Color& other)
 {
 	r += other.r;
 	g += other.g;
@@ -61,12 +61,12 @@ inline Color& Color::operator+=(const Color& other)
 	return *this;
 }
 
-inline Color Color::operator-(const Color& other) const
+Color Color::operator-(const Color& other) const
 {	
 	return Color(r - other.r, g - other.g, b - other.b, a - other.a);
 }
 
-inline Color& Color::operator-=(const Color& other)
+Color& Color::operator-=(const Color& other)
 {
 	r -= other.r;
 	g -= other.g;
@@ -76,17 +76,17 @@ inline Color& Color::operator-=(const Color& other)
 	return *this;
 }
 
-inline Color Color::operator*(const Color& other) const
+Color Color::operator*(const Color& other) const
 {
 	return Color(other.r * r, other.g * g, other.b * b, other.a * a);
 }
 
-inline Color Color::operator*(const float v) const
+Color Color::operator*(const float v) const
 {
 	return Color(v * r, v * g, v * b, v * a);
 }
 
-inline Color& Color::operator*=(const float v )
+Color& Color::operator*=(const float v )
 {
 	r *= v;
 	g *= v;
@@ -95,12 +95,12 @@ inline Color& Color::operator*=(const float v )
 	return *this;
 }
 
-inline Color Color::operator/(const Color& other) const
+Color Color::operator/(const Color& other) const
 {	
 	return Color(other.r / r, other.g / g, other.b / b, other.a / a);
 }
 
-inline Color Color::operator/(const float v) const
+Color Color::operator/(const float v) const
 {
 	assert(v != 0.0f);
 
@@ -108,7 +108,7 @@ inline Color Color::operator/(const float v) const
 	return Color(r * i, g * i, b * i, a * i);
 }
 
-inline Color& Color::operator/=(const float v)
+Color& Color::operator/=(const float v)
 {
 	assert(v != 0.0f);
 
@@ -120,12 +120,12 @@ inline Color& Color::operator/=(const float v)
 	return *this;
 }
 
-inline bool Color::operator==(const Color& other) const
+bool Color::operator==(const Color& other) const
 {
 	return (r == other.r && g == other.g && b == other.b && a == other.a);
 }
 
-inline bool Color::operator!=(const Color& other) const
+bool Color::operator!=(const Color& other) const
 {
 	return !(*this == other);
 }
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include <core/Matrix4.h>
 #include <core/Sphere3d.h>
 #include <core/Aabox3d.h>
+#include <core/Simd.h>
 
 namespace render
 {
@@ -39,7 +40,7 @@ Frustum::Frustum() {}
 
 Frustum::~Frustum() {}
 
-inline void Frustum::buildViewFrustum(const core::matrix4& projMat, const core::matrix4& viewMat, ProjectionType projType, float fov, float aspect, float near, float far)
+void Frustum::buildViewFrustum(const core::matrix4& projMat, const core::matrix4& viewMat, ProjectionType projType, float fov, float aspect, float near, float far)
 {
 	core::matrix4 mat = projMat * viewMat;
 
@@ -93,7 +94,7 @@ inline void Frustum::buildViewFrustum(const core::matrix4& projMat, const core::
 	mPlanes[FRUSTUM_PLANE_FAR].getIntersectionWithPlanes(mPlanes[FRUSTUM_PLANE_TOP], mPlanes[FRUSTUM_PLANE_RIGHT], mCorners[7]);
 }
 
-inline void Frustum::transform(const core::matrix4& mat)
+void Frustum::transform(const core::matrix4& mat)
 {
 	for (unsigned int i=0; i < 6; ++i)
 		mat.transformPlane(mPlanes[i]);
@@ -104,19 +105,21 @@ const core::vector3d* Frustum::getCorners()
 	return mCorners;
 }
 
+const core::plane3d& Frustum::getPlane(unsigned int index) const
+{
+	return mPlanes[index];
+}
+
 bool Frustum::isVisible(const core::vector3d& point)
 {
-	// Go through all the sides of the frustum
+	// The point has to be in front of all the sides of the frustum
 	for (unsigned char i = 0; i < 6; ++i)
 	{
-		// Calculate the plane equation and check if the point is behind a side of the frustum
-		if (mPlanes[i].getDistanceTo(point) > 0)
-		{
-			return true;
-		}
+		if (mPlanes[i].getDistanceTo(point) < 0)
+			return false;
 	}
 
-	return false;
+	return true;
 }
 
 bool Frustum::isVisible(const core::sphere3d& sphere)
@@ -124,37 +127,57 @@ bool Frustum::isVisible(const core::sphere3d& sphere)
 	// Go through all the sides of the frustum
 	for (unsigned char i = 0; i < 6; ++i)
 	{
-		if (mPlanes[i].getDistanceTo(sphere.Center) > sphere.Radius)
-			return true;
+		if (mPlanes[i].getDistanceTo(sphere.Center) < -sphere.Radius)
+			return false;
 	}
 
-	return false;
+	return true;
 }
 
 bool Frustum::isVisible(const core::aabox3d& box)
 {
-	// Get corners of the box
-	core::vector3d edges[8];
-	box.getEdges(edges);
-	
+	core::vector3d center = box.getCenter();
+	core::vector3d extent = box.getExtent() * 0.5f;
+
 	// Go through all the sides of the frustum
 	for (unsigned char i = 0; i < 6; ++i)
-	{		
-		// Calculate the plane equation and check if the box is behind a side of the frustum
-		if ((mPlanes[i].getDistanceTo(edges[0]) > 0) &&
-			(mPlanes[i].getDistanceTo(edges[1]) > 0) &&
-			(mPlanes[i].getDistanceTo(edges[2]) > 0) &&
-			(mPlanes[i].getDistanceTo(edges[3]) > 0) &&
-			(mPlanes[i].getDistanceTo(edges[4]) > 0) &&
-			(mPlanes[i].getDistanceTo(edges[5]) > 0) &&
-			(mPlanes[i].getDistanceTo(edges[6]) > 0) &&
-			(mPlanes[i].getDistanceTo(edges[7]) > 0))
-		{
-			return true;
-		}
+	{
+		// The box is behind a side of the frustum if its corner farthest along the normal is
+		const core::vector3d& normal = mPlanes[i].Normal;
+		float radius = core::abs(normal.x) * extent.x + core::abs(normal.y) * extent.y + core::abs(normal.z) * extent.z;
+
+		if (mPlanes[i].getDistanceTo(center) + radius < 0)
+			return false;
 	}
-	
-	return false;
+
+	return true;
+}
+
+static void packPlanes(const core::plane3d* planes, float* out)
+{
+	for (unsigned int i = 0; i < 6; ++i)
+	{
+		out[i * 4 + 0] = planes[i].Normal.x;
+		out[i * 4 + 1] = planes[i].Normal.y;
+		out[i * 4 + 2] = planes[i].Normal.z;
+		out[i * 4 + 3] = planes[i].D;
+	}
+}
+
+void Frustum::cullSpheres(const core::CullingVolumes& spheres, unsigned int count, unsigned int* visible, unsigned char* lastPlanes) const
+{
+	float planes[24];
+	packPlanes(mPlanes, planes);
+
+	core::getMathKernels().cullSpheres(planes, spheres, count, visible, lastPlanes);
+}
+
+void Frustum::cullBoxes(const core::CullingVolumes& boxes, unsigned int count, unsigned int* visible, unsigned char* lastPlanes) const
+{
+	float planes[24];
+	packPlanes(mPlanes, planes);
+
+	core::getMathKernels().cullBoxes(planes, boxes, count, visible, lastPlanes);
 }
 
-} //namespace render
+} //namespace render
\ No newline at end of file
@@ -26,6 +26,7 @@ THE SOFTWARE.
 
 #include <render/Light.h>
 #include <game/ComponentDefines.h>
+#include <game/MessageDefines.h>
 #include <core/Utils.h>
 
 namespace render
@@ -34,6 +35,7 @@ namespace render
 Light::Light(): game::Component()
 {
 	mType = game::COMPONENT_TYPE_LIGHT;
+	mMessageMask = MESSAGE_MASK_NONE;
 
 	mLightType = LIGHT_TYPE_POINT;
 	mVisible = true;
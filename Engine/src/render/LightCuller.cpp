@@ -0,0 +1,678 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <render/LightCuller.h>
+#include <render/Light.h>
+#include <render/Camera.h>
+#include <game/GameObject.h>
+#include <game/Transform.h>
+#include <core/Math.h>
+#include <core/Quaternion.h>
+#include <core/JobSystem.h>
+#include <core/Profiler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <string.h>
+
+namespace render
+{
+
+//! Default number of clusters along the screen width, the screen height and the view depth.
+static const unsigned int LIGHT_CULLER_DEFAULT_GRID_X = 16;
+static const unsigned int LIGHT_CULLER_DEFAULT_GRID_Y = 9;
+static const unsigned int LIGHT_CULLER_DEFAULT_GRID_Z = 24;
+
+//! Default farthest view depth of the clusters, used with infinite far clip distances.
+static const float LIGHT_CULLER_DEFAULT_MAX_DISTANCE = 1000.0f;
+
+//! Lights transformed per job.
+static const unsigned int LIGHT_CULLER_LIGHT_GRAIN_SIZE = 128;
+
+LightCuller::LightCuller()
+{
+	mEnabled = true;
+
+	mGridSizeX = LIGHT_CULLER_DEFAULT_GRID_X;
+	mGridSizeY = LIGHT_CULLER_DEFAULT_GRID_Y;
+	mGridSizeZ = LIGHT_CULLER_DEFAULT_GRID_Z;
+
+	mMaxDistance = LIGHT_CULLER_DEFAULT_MAX_DISTANCE;
+
+	mNearDistance = 0.0f;
+	mFarDistance = 0.0f;
+	mDepthScale = 0.0f;
+	mDepthBias = 0.0f;
+
+	mBoundsDirty = true;
+
+	mVersion = 0;
+
+	memset(&mStats, 0, sizeof(LightCullerStats));
+}
+
+LightCuller::~LightCuller() {}
+
+void LightCuller::setEnabled(bool enabled)
+{
+	mEnabled = enabled;
+
+	if (!mEnabled)
+		clear();
+}
+
+bool LightCuller::isEnabled() const
+{
+	return mEnabled;
+}
+
+void LightCuller::setGridSize(unsigned int countX, unsigned int countY, unsigned int countZ)
+{
+	mGridSizeX = std::max(countX, 1u);
+	mGridSizeY = std::max(countY, 1u);
+	mGridSizeZ = std::max(countZ, 1u);
+
+	mBoundsDirty = true;
+
+	clear();
+}
+
+unsigned int LightCuller::getGridSizeX() const
+{
+	return mGridSizeX;
+}
+
+unsigned int LightCuller::getGridSizeY() const
+{
+	return mGridSizeY;
+}
+
+unsigned int LightCuller::getGridSizeZ() const
+{
+	return mGridSizeZ;
+}
+
+void LightCuller::setMaxDistance(float distance)
+{
+	mMaxDistance = distance;
+	mBoundsDirty = true;
+}
+
+float LightCuller::getMaxDistance() const
+{
+	return mMaxDistance;
+}
+
+void LightCuller::assignLights(Camera* camera, const std::vector<Light*>& lights)
+{
+	if (!mEnabled || camera == nullptr)
+		return;
+
+	PROFILE_SCOPE("LightCuller::assignLights");
+
+	memset(&mStats, 0, sizeof(LightCullerStats));
+
+	float nearDistance = camera->getNearClipDistance();
+	float farDistance = camera->getFarClipDistance();
+	if (farDistance <= 0.0f || farDistance > mMaxDistance)
+		farDistance = mMaxDistance;
+
+	if (nearDistance <= 0.0f || farDistance <= nearDistance)
+	{
+		clear();
+		return;
+	}
+
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	updateBounds(camera->getProjectionMatrix(), nearDistance, farDistance);
+
+	std::chrono::steady_clock::time_point assignTime = std::chrono::steady_clock::now();
+	mStats.boundsTime = std::chrono::duration<float, std::milli>(assignTime - startTime).count();
+
+	mView = camera->getViewMatrix();
+
+	// The transforms are read here, their absolute values may still be updated on first access
+	mLights.clear();
+	mLightData.clear();
+	for (unsigned int i = 0; i < lights.size(); ++i)
+	{
+		Light* pLight = lights[i];
+		if (pLight == nullptr || !pLight->isVisible() || pLight->getGameObject() == nullptr)
+			continue;
+
+		game::Transform* pTransform = pLight->getGameObject()->getTransform();
+		if (pTransform == nullptr)
+			continue;
+
+		LightType type = pLight->getLightType();
+
+		core::vector3d position = pTransform->getAbsolutePosition();
+		core::vector3d direction = pTransform->getAbsoluteOrientation() * core::vector3d::NEGATIVE_UNIT_Z;
+		direction.normalize();
+
+		float range = type == LIGHT_TYPE_DIRECTIONAL ? 0.0f : pLight->getAttenuationRange();
+		if (type != LIGHT_TYPE_DIRECTIONAL && range <= 0.0f)
+			continue;
+
+		float cosInner = -1.0f;
+		float cosOuter = -1.0f;
+		if (type == LIGHT_TYPE_SPOTLIGHT)
+		{
+			// the angles cover the whole cone
+			cosInner = cosf(std::min(pLight->getSpotlightInnerAngle(), 180.0f) * 0.5f * core::DEGTORAD);
+			cosOuter = cosf(std::min(pLight->getSpotlightOuterAngle(), 180.0f) * 0.5f * core::DEGTORAD);
+		}
+
+		const Color& diffuse = pLight->getDiffuseColor();
+		float power = pLight->getPowerScale();
+
+		float data[LIGHT_CULLER_LIGHT_TEXELS * 4] =
+		{
+			position.x, position.y, position.z, range,
+			diffuse.r * power, diffuse.g * power, diffuse.b * power, cosInner,
+			direction.x, direction.y, direction.z, cosOuter,
+			pLight->getAttenuationConstant(), pLight->getAttenuationLinear(), pLight->getAttenuationQuadric(), pLight->getSpotlightFalloff()
+		};
+
+		mLights.push_back(pLight);
+		mLightData.insert(mLightData.end(), data, data + LIGHT_CULLER_LIGHT_TEXELS * 4);
+	}
+
+	unsigned int lightCount = (unsigned int)mLights.size();
+	mCulledLights.resize(lightCount);
+
+	core::JobSystem* pJobSystem = core::JobSystem::getInstance();
+	bool parallel = pJobSystem != nullptr && pJobSystem->getWorkerCount() > 0;
+
+	if (parallel && lightCount > LIGHT_CULLER_LIGHT_GRAIN_SIZE)
+		pJobSystem->parallelFor(lightCount, &LightCuller::cullLights, this, LIGHT_CULLER_LIGHT_GRAIN_SIZE);
+	else
+		cullLights(0, lightCount, this);
+
+	// bucket the lights by slice so that the slices only visit the lights reaching them
+	mSlices.resize(mGridSizeZ);
+	for (unsigned int z = 0; z < mGridSizeZ; ++z)
+		mSlices[z].lights.clear();
+
+	for (unsigned int i = 0; i < lightCount; ++i)
+	{
+		const CulledLight& light = mCulledLights[i];
+		for (unsigned int z = light.minZ; z <= light.maxZ; ++z)
+			mSlices[z].lights.push_back(i);
+	}
+
+	// every slice bins its own clusters, the lists stay ordered by light
+	if (parallel && mGridSizeZ > 1 && lightCount > 0)
+		pJobSystem->parallelFor(mGridSizeZ, &LightCuller::binSlices, this, 1);
+	else
+		binSlices(0, mGridSizeZ, this);
+
+	unsigned int sliceClusterCount = mGridSizeX * mGridSizeY;
+
+	mClusterGrid.resize(getClusterCount() * 2);
+	mLightIndices.clear();
+	for (unsigned int z = 0; z < mGridSizeZ; ++z)
+	{
+		SliceLists& slice = mSlices[z];
+
+		unsigned int base = (unsigned int)mLightIndices.size();
+		unsigned int* pGrid = &mClusterGrid[z * sliceClusterCount * 2];
+		for (unsigned int i = 0; i < sliceClusterCount; ++i)
+		{
+			unsigned int count = slice.counts[i];
+
+			// the scatter left the offsets at the end of every list
+			pGrid[i * 2 + 0] = count > 0 ? base + slice.offsets[i] - count : 0;
+			pGrid[i * 2 + 1] = count;
+
+			mStats.maxClusterLightCount = std::max(mStats.maxClusterLightCount, count);
+		}
+
+		mLightIndices.insert(mLightIndices.end(), slice.indices.begin(), slice.indices.end());
+	}
+
+	mStats.lightCount = lightCount;
+	for (unsigned int i = 0; i < lightCount; ++i)
+	{
+		if (mCulledLights[i].minZ <= mCulledLights[i].maxZ)
+			++mStats.visibleLightCount;
+	}
+	mStats.indexCount = (unsigned int)mLightIndices.size();
+	mStats.assignTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - assignTime).count();
+
+	++mVersion;
+}
+
+void LightCuller::clear()
+{
+	mLights.clear();
+	mCulledLights.clear();
+	mLightData.clear();
+	mLightIndices.clear();
+	mClusterGrid.assign(getClusterCount() * 2, 0);
+
+	memset(&mStats, 0, sizeof(LightCullerStats));
+
+	++mVersion;
+}
+
+unsigned int LightCuller::getClusterCount() const
+{
+	return mGridSizeX * mGridSizeY * mGridSizeZ;
+}
+
+unsigned int LightCuller::getClusterIndex(unsigned int x, unsigned int y, unsigned int z) const
+{
+	return (z * mGridSizeY + y) * mGridSizeX + x;
+}
+
+int LightCuller::findCluster(const core::vector3d& viewPosition) const
+{
+	float depth = -viewPosition.z;
+	if (mBounds.empty() || depth < mNearDistance || depth > mFarDistance)
+		return -1;
+
+	core::vector4d clip(viewPosition.x, viewPosition.y, viewPosition.z, 1.0f);
+	mProjection.transformVector(clip);
+	if (clip.w <= 0.0f)
+		return -1;
+
+	float ndcX = clip.x / clip.w;
+	float ndcY = clip.y / clip.w;
+	if (ndcX < -1.0f || ndcX > 1.0f || ndcY < -1.0f || ndcY > 1.0f)
+		return -1;
+
+	unsigned int x = std::min((unsigned int)((ndcX * 0.5f + 0.5f) * mGridSizeX), mGridSizeX - 1);
+	unsigned int y = std::min((unsigned int)((ndcY * 0.5f + 0.5f) * mGridSizeY), mGridSizeY - 1);
+
+	return (int)getClusterIndex(x, y, getSlice(depth));
+}
+
+const unsigned int* LightCuller::getClusterLights(unsigned int cluster, unsigned int& count) const
+{
+	count = 0;
+	if (cluster * 2 + 1 >= mClusterGrid.size())
+		return nullptr;
+
+	count = mClusterGrid[cluster * 2 + 1];
+	if (count == 0)
+		return nullptr;
+
+	return &mLightIndices[mClusterGrid[cluster * 2]];
+}
+
+const std::vector<unsigned int>& LightCuller::getClusterGrid() const
+{
+	return mClusterGrid;
+}
+
+const std::vector<unsigned int>& LightCuller::getLightIndices() const
+{
+	return mLightIndices;
+}
+
+const std::vector<float>& LightCuller::getLightData() const
+{
+	return mLightData;
+}
+
+Light* LightCuller::getLight(unsigned int index) const
+{
+	if (index >= mLights.size())
+		return nullptr;
+
+	return mLights[index];
+}
+
+unsigned int LightCuller::getLightCount() const
+{
+	return (unsigned int)mLights.size();
+}
+
+core::vector4d LightCuller::getGridParameters() const
+{
+	return core::vector4d((float)mGridSizeX, (float)mGridSizeY, (float)mGridSizeZ, (float)mLights.size());
+}
+
+core::vector4d LightCuller::getDepthParameters() const
+{
+	return core::vector4d(mNearDistance, mFarDistance, mDepthScale, mDepthBias);
+}
+
+unsigned int LightCuller::getVersion() const
+{
+	return mVersion;
+}
+
+const LightCullerStats& LightCuller::getStats() const
+{
+	return mStats;
+}
+
+void LightCuller::updateBounds(const core::matrix4& projection, float nearDistance, float farDistance)
+{
+	if (!mBoundsDirty && projection == mProjection && nearDistance == mNearDistance && farDistance == mFarDistance)
+		return;
+
+	mProjection = projection;
+	mNearDistance = nearDistance;
+	mFarDistance = farDistance;
+	mBoundsDirty = false;
+
+	// slice = floor(log(depth / near) / log(far / near) * z)
+	float logRange = logf(mFarDistance / mNearDistance);
+	mDepthScale = (float)mGridSizeZ / logRange;
+	mDepthBias = -(float)mGridSizeZ * logf(mNearDistance) / logRange;
+
+	// Every tile corner is a line of view space points: one on the near plane and one halfway in the depth range,
+	// points at any view depth lie on it for both perspective and orthographic projections
+	core::matrix4 inverseProjection = mProjection.getInverse();
+
+	unsigned int cornerCountX = mGridSizeX + 1;
+	unsigned int cornerCountY = mGridSizeY + 1;
+
+	std::vector<core::vector3d> cornerStarts(cornerCountX * cornerCountY);
+	std::vector<core::vector3d> cornerSteps(cornerCountX * cornerCountY);
+	for (unsigned int y = 0; y < cornerCountY; ++y)
+	{
+		for (unsigned int x = 0; x < cornerCountX; ++x)
+		{
+			float ndcX = (float)x / (float)mGridSizeX * 2.0f - 1.0f;
+			float ndcY = (float)y / (float)mGridSizeY * 2.0f - 1.0f;
+
+			core::vector4d a(ndcX, ndcY, -1.0f, 1.0f);
+			core::vector4d b(ndcX, ndcY, 0.0f, 1.0f);
+			inverseProjection.transformVector(a);
+			inverseProjection.transformVector(b);
+
+			core::vector3d start(a.x / a.w, a.y / a.w, a.z / a.w);
+			core::vector3d end(b.x / b.w, b.y / b.w, b.z / b.w);
+
+			// the point at view depth d is start + step * (d + start.z)
+			core::vector3d step = end - start;
+			float length = -step.z;
+			if (fabs(length) > core::EPSILON)
+				step = step / length;
+
+			cornerStarts[y * cornerCountX + x] = start;
+			cornerSteps[y * cornerCountX + x] = step;
+		}
+	}
+
+	mBounds.resize(getClusterCount());
+	for (unsigned int z = 0; z < mGridSizeZ; ++z)
+	{
+		float sliceNear = mNearDistance * powf(mFarDistance / mNearDistance, (float)z / (float)mGridSizeZ);
+		float sliceFar = mNearDistance * powf(mFarDistance / mNearDistance, (float)(z + 1) / (float)mGridSizeZ);
+
+		for (unsigned int y = 0; y < mGridSizeY; ++y)
+		{
+			for (unsigned int x = 0; x < mGridSizeX; ++x)
+			{
+				ClusterBounds& bounds = mBounds[getClusterIndex(x, y, z)];
+				bounds.minimum = core::vector3d(core::FLOAT_MAX, core::FLOAT_MAX, core::FLOAT_MAX);
+				bounds.maximum = core::vector3d(-core::FLOAT_MAX, -core::FLOAT_MAX, -core::FLOAT_MAX);
+
+				for (unsigned int corner = 0; corner < 8; ++corner)
+				{
+					unsigned int index = (y + ((corner >> 1) & 1)) * cornerCountX + x + (corner & 1);
+					float depth = (corner & 4) != 0 ? sliceFar : sliceNear;
+
+					core::vector3d point = cornerStarts[index] + cornerSteps[index] * (depth + cornerStarts[index].z);
+					point.z = -depth;
+
+					bounds.minimum.x = std::min(bounds.minimum.x, point.x);
+					bounds.minimum.y = std::min(bounds.minimum.y, point.y);
+					bounds.minimum.z = std::min(bounds.minimum.z, point.z);
+					bounds.maximum.x = std::max(bounds.maximum.x, point.x);
+					bounds.maximum.y = std::max(bounds.maximum.y, point.y);
+					bounds.maximum.z = std::max(bounds.maximum.z, point.z);
+				}
+
+				bounds.center = (bounds.minimum + bounds.maximum) * 0.5f;
+				bounds.radius = (bounds.maximum - bounds.center).getLength();
+			}
+		}
+	}
+}
+
+unsigned int LightCuller::getSlice(float depth) const
+{
+	if (depth <= mNearDistance)
+		return 0;
+
+	float slice = floorf(logf(depth) * mDepthScale + mDepthBias);
+	if (slice < 0.0f)
+		return 0;
+
+	return std::min((unsigned int)slice, mGridSizeZ - 1);
+}
+
+void LightCuller::cullLight(unsigned int index)
+{
+	const float* pData = &mLightData[index * LIGHT_CULLER_LIGHT_TEXELS * 4];
+	CulledLight& light = mCulledLights[index];
+
+	light.range = pData[3];
+	light.directional = light.range <= 0.0f;
+	light.cosOuter = pData[11];
+	light.sinOuter = sqrtf(std::max(1.0f - light.cosOuter * light.cosOuter, 0.0f));
+
+	// cones wider than a half space are culled as point lights
+	light.cone = !light.directional && light.cosOuter > 0.0f;
+
+	// row major, the translation is in the last column
+	const float* v = mView.get();
+	light.position.x = v[0] * pData[0] + v[1] * pData[1] + v[2] * pData[2] + v[3];
+	light.position.y = v[4] * pData[0] + v[5] * pData[1] + v[6] * pData[2] + v[7];
+	light.position.z = v[8] * pData[0] + v[9] * pData[1] + v[10] * pData[2] + v[11];
+
+	// the view matrix has no scale, its inverse transpose is itself
+	light.direction.x = v[0] * pData[8] + v[1] * pData[9] + v[2] * pData[10];
+	light.direction.y = v[4] * pData[8] + v[5] * pData[9] + v[6] * pData[10];
+	light.direction.z = v[8] * pData[8] + v[9] * pData[9] + v[10] * pData[10];
+
+	light.minX = 0;
+	light.maxX = mGridSizeX - 1;
+	light.minY = 0;
+	light.maxY = mGridSizeY - 1;
+	light.minZ = 0;
+	light.maxZ = mGridSizeZ - 1;
+
+	if (light.directional)
+		return;
+
+	// empty range
+	light.minZ = 1;
+	light.maxZ = 0;
+
+	float depth = -light.position.z;
+	float nearest = depth - light.range;
+	float farthest = depth + light.range;
+	if (farthest < mNearDistance || nearest > mFarDistance)
+		return;
+
+	// the corners of the box around the sphere project to a rectangle around it when they are all in front of the camera
+	if (nearest > mNearDistance)
+	{
+		// the clip position of a corner is the clip position of the center plus the columns scaled by +-range
+		const float* p = mProjection.get();
+		float center[4];
+		float column[3][4];
+		for (unsigned int row = 0; row < 4; ++row)
+		{
+			center[row] = p[row * 4 + 0] * light.position.x + p[row * 4 + 1] * light.position.y + p[row * 4 + 2] * light.position.z + p[row * 4 + 3];
+			column[0][row] = p[row * 4 + 0] * light.range;
+			column[1][row] = p[row * 4 + 1] * light.range;
+			column[2][row] = p[row * 4 + 2] * light.range;
+		}
+
+		float minX = core::FLOAT_MAX;
+		float minY = core::FLOAT_MAX;
+		float maxX = -core::FLOAT_MAX;
+		float maxY = -core::FLOAT_MAX;
+		for (unsigned int corner = 0; corner < 8; ++corner)
+		{
+			float clip[4];
+			for (unsigned int row = 0; row < 4; ++row)
+			{
+				clip[row] = center[row] +
+					((corner & 1) != 0 ? column[0][row] : -column[0][row]) +
+					((corner & 2) != 0 ? column[1][row] : -column[1][row]) +
+					((corner & 4) != 0 ? column[2][row] : -column[2][row]);
+			}
+
+			float inverseW = 1.0f / clip[3];
+			minX = std::min(minX, clip[0] * inverseW);
+			minY = std::min(minY, clip[1] * inverseW);
+			maxX = std::max(maxX, clip[0] * inverseW);
+			maxY = std::max(maxY, clip[1] * inverseW);
+		}
+
+		if (maxX < -1.0f || minX > 1.0f || maxY < -1.0f || minY > 1.0f)
+			return;
+
+		light.minX = (unsigned int)std::max((minX * 0.5f + 0.5f) * mGridSizeX, 0.0f);
+		light.maxX = std::min((unsigned int)std::max((maxX * 0.5f + 0.5f) * mGridSizeX, 0.0f), mGridSizeX - 1);
+		light.minY = (unsigned int)std::max((minY * 0.5f + 0.5f) * mGridSizeY, 0.0f);
+		light.maxY = std::min((unsigned int)std::max((maxY * 0.5f + 0.5f) * mGridSizeY, 0.0f), mGridSizeY - 1);
+	}
+
+	light.minZ = getSlice(nearest);
+	light.maxZ = getSlice(farthest);
+}
+
+void LightCuller::cullLights(unsigned int begin, unsigned int end, void* data)
+{
+	LightCuller* pCuller = static_cast<LightCuller*>(data);
+
+	for (unsigned int i = begin; i < end; ++i)
+		pCuller->cullLight(i);
+}
+
+void LightCuller::binSlice(unsigned int slice)
+{
+	SliceLists& lists = mSlices[slice];
+
+	unsigned int sliceClusterCount = mGridSizeX * mGridSizeY;
+	const ClusterBounds* pBounds = &mBounds[slice * sliceClusterCount];
+
+	lists.counts.assign(sliceClusterCount, 0);
+	lists.offsets.resize(sliceClusterCount);
+	lists.pairs.clear();
+
+	for (unsigned int l = 0; l < lists.lights.size(); ++l)
+	{
+		unsigned int i = lists.lights[l];
+		const CulledLight& light = mCulledLights[i];
+
+		for (unsigned int y = light.minY; y <= light.maxY; ++y)
+		{
+			for (unsigned int x = light.minX; x <= light.maxX; ++x)
+			{
+				unsigned int cluster = y * mGridSizeX + x;
+				if (!isLightInCluster(light, pBounds[cluster]))
+					continue;
+
+				lists.pairs.push_back(cluster);
+				lists.pairs.push_back(i);
+				++lists.counts[cluster];
+			}
+		}
+	}
+
+	unsigned int offset = 0;
+	for (unsigned int i = 0; i < sliceClusterCount; ++i)
+	{
+		lists.offsets[i] = offset;
+		offset += lists.counts[i];
+	}
+
+	// the pairs are in light order, so are the lists
+	lists.indices.resize(offset);
+	for (unsigned int i = 0; i < lists.pairs.size(); i += 2)
+		lists.indices[lists.offsets[lists.pairs[i]]++] = lists.pairs[i + 1];
+}
+
+void LightCuller::binSlices(unsigned int begin, unsigned int end, void* data)
+{
+	LightCuller* pCuller = static_cast<LightCuller*>(data);
+
+	for (unsigned int i = begin; i < end; ++i)
+		pCuller->binSlice(i);
+}
+
+bool LightCuller::isLightInCluster(const CulledLight& light, const ClusterBounds& bounds) const
+{
+	if (light.directional)
+		return true;
+
+	// sphere against box
+	const float* pPosition = &light.position.x;
+	const float* pMinimum = &bounds.minimum.x;
+	const float* pMaximum = &bounds.maximum.x;
+
+	float distance = 0.0f;
+	for (unsigned int i = 0; i < 3; ++i)
+	{
+		float outside = 0.0f;
+		if (pPosition[i] < pMinimum[i])
+			outside = pMinimum[i] - pPosition[i];
+		else if (pPosition[i] > pMaximum[i])
+			outside = pPosition[i] - pMaximum[i];
+
+		distance += outside * outside;
+	}
+
+	if (distance > light.range * light.range)
+		return false;
+
+	if (!light.cone)
+		return true;
+
+	// cone against the bounding sphere of the cluster
+	float vx = bounds.center.x - light.position.x;
+	float vy = bounds.center.y - light.position.y;
+	float vz = bounds.center.z - light.position.z;
+
+	float lengthSquared = vx * vx + vy * vy + vz * vz;
+	float along = vx * light.direction.x + vy * light.direction.y + vz * light.direction.z;
+	float across = sqrtf(std::max(lengthSquared - along * along, 0.0f));
+	float coneDistance = light.cosOuter * across - along * light.sinOuter;
+
+	if (coneDistance > bounds.radius)
+		return false;
+	if (along > bounds.radius + light.range)
+		return false;
+	if (along < -bounds.radius)
+		return false;
+
+	return true;
+}
+
+} // end namespace render
\ No newline at end of file
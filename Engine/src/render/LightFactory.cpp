@@ -31,14 +31,15 @@ THE SOFTWARE.
 namespace render
 {
 
-LightFactory::LightFactory(): game::ComponentFactory()
+LightFactory::LightFactory(): game::PooledComponentFactory<Light>()
 {
 	mName = "Light";
+	mThreadSafe = true;
 }
 
 game::Component* LightFactory::createComponent()
 {
-	Light* pLight = new Light();
+	Light* pLight = mPool.create();
 
 	if (RenderManager::getInstance() != nullptr)
 		RenderManager::getInstance()->addLight(pLight);
@@ -54,7 +55,7 @@ void LightFactory::destroyComponent(game::Component* component)
 		RenderManager::getInstance()->removeLight(pLight);
 
 	assert(pLight != nullptr);
-	SAFE_DELETE(pLight);
+	mPool.destroy(pLight);
 }
 
 } // end namespace game
\ No newline at end of file
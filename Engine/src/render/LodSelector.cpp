@@ -0,0 +1,278 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <render/LodSelector.h>
+#include <render/Camera.h>
+#include <render/CameraDefines.h>
+#include <render/Model.h>
+#include <render/MeshData.h>
+#include <render/IndexBuffer.h>
+#include <core/Matrix4.h>
+#include <core/Sphere3d.h>
+
+#include <string.h>
+
+namespace render
+{
+
+//! Default largest error a detail level may show, in pixels.
+static const float LOD_DEFAULT_ERROR_THRESHOLD = 1.0f;
+
+//! Default fraction of the error threshold the levels switch around.
+static const float LOD_DEFAULT_HYSTERESIS = 0.25f;
+
+static unsigned int getTriangleCount(IndexBuffer* buffer)
+{
+	return (buffer != nullptr) ? buffer->getNumIndexes() / 3 : 0;
+}
+
+LodSelector::LodSelector()
+{
+	mEnabled = true;
+
+	mErrorThreshold = LOD_DEFAULT_ERROR_THRESHOLD;
+	mHysteresis = LOD_DEFAULT_HYSTERESIS;
+	mSmallObjectThreshold = 0.0f;
+
+	mPixelScale = 0.0f;
+	mPerspective = true;
+	mNearDistance = 0.0f;
+
+	memset(&mStats, 0, sizeof(LodStats));
+
+	mCurrentView = nullptr;
+}
+
+LodSelector::~LodSelector()
+{
+	removeAllViews();
+}
+
+void LodSelector::setEnabled(bool enabled)
+{
+	mEnabled = enabled;
+}
+
+bool LodSelector::isEnabled() const
+{
+	return mEnabled;
+}
+
+void LodSelector::setErrorThreshold(float pixels)
+{
+	if (pixels > 0.0f)
+		mErrorThreshold = pixels;
+}
+
+float LodSelector::getErrorThreshold() const
+{
+	return mErrorThreshold;
+}
+
+void LodSelector::setHysteresis(float hysteresis)
+{
+	if (hysteresis < 0.0f) hysteresis = 0.0f;
+	if (hysteresis > 0.9f) hysteresis = 0.9f;
+
+	mHysteresis = hysteresis;
+}
+
+float LodSelector::getHysteresis() const
+{
+	return mHysteresis;
+}
+
+void LodSelector::setSmallObjectThreshold(float pixels)
+{
+	mSmallObjectThreshold = (pixels > 0.0f) ? pixels : 0.0f;
+}
+
+float LodSelector::getSmallObjectThreshold() const
+{
+	return mSmallObjectThreshold;
+}
+
+void LodSelector::beginView(Camera* camera, unsigned int viewportHeight)
+{
+	mPixelScale = 0.0f;
+	mCurrentView = nullptr;
+	if (camera == nullptr)
+		return;
+
+	for (unsigned int i = 0; i < mViews.size(); ++i)
+	{
+		if (mViews[i]->camera == camera)
+		{
+			mCurrentView = mViews[i];
+			break;
+		}
+	}
+
+	if (mCurrentView == nullptr)
+	{
+		mCurrentView = new LodView();
+		mCurrentView->camera = camera;
+		mViews.push_back(mCurrentView);
+	}
+
+	// Only the models of the last view are kept, the others start over from the level they were last drawn with
+	mCurrentView->lastLods.swap(mCurrentView->lods);
+	mCurrentView->lods.clear();
+
+	// The projection scales the view space height to the [-1, 1] range of the viewport
+	const core::matrix4& projection = camera->getProjectionMatrix();
+	mPixelScale = projection[5] * (float)viewportHeight * 0.5f;
+	if (mPixelScale < 0.0f)
+		mPixelScale = -mPixelScale;
+
+	mPerspective = (camera->getProjectionType() == PROJECTION_TYPE_PERSPECTIVE);
+	mNearDistance = camera->getNearClipDistance();
+}
+
+void LodSelector::removeView(Camera* camera)
+{
+	for (unsigned int i = 0; i < mViews.size(); ++i)
+	{
+		if (mViews[i]->camera != camera)
+			continue;
+
+		if (mCurrentView == mViews[i])
+			mCurrentView = nullptr;
+
+		SAFE_DELETE(mViews[i]);
+		mViews.erase(mViews.begin() + i);
+
+		return;
+	}
+}
+
+void LodSelector::removeAllViews()
+{
+	for (unsigned int i = 0; i < mViews.size(); ++i)
+	{
+		SAFE_DELETE(mViews[i]);
+	}
+
+	mViews.clear();
+	mCurrentView = nullptr;
+}
+
+bool LodSelector::selectLod(Model* model, float distance)
+{
+	if (model == nullptr)
+		return false;
+
+	++mStats.testedCount;
+
+	MeshData* pMeshData = model->getMeshData();
+
+	// Pixels per world unit at the depth of the model, the ones reaching the camera get the scale of the near plane
+	float pixelScale = mPixelScale;
+	if (mPerspective)
+		pixelScale /= (distance > mNearDistance && distance > 0.0f) ? distance : ((mNearDistance > 0.0f) ? mNearDistance : 1.0f);
+
+	float radius = model->getBoundingSphere().Radius;
+	if (mSmallObjectThreshold > 0.0f && mPixelScale > 0.0f && radius * 2.0f * pixelScale < mSmallObjectThreshold)
+	{
+		++mStats.smallCulledCount;
+		return false;
+	}
+
+	// The level of the model in the last view of the camera, the hysteresis works from it
+	unsigned int lastLod = model->getLod();
+	if (mCurrentView != nullptr)
+	{
+		hashmap<unsigned int, unsigned int>::const_iterator i = mCurrentView->lastLods.find(model->getID());
+		if (i != mCurrentView->lastLods.end())
+			lastLod = i->second;
+	}
+
+	unsigned int lod = 0;
+	unsigned int lodCount = (pMeshData != nullptr) ? pMeshData->getLodCount() : 1;
+	if (mEnabled && lodCount > 1 && mPixelScale > 0.0f && pMeshData->getBoundingSphereRadius() > 0.0f)
+	{
+		// The errors are in mesh units, the world bounds include the scale of the model
+		float errorScale = radius / pMeshData->getBoundingSphereRadius() * pixelScale;
+
+		lod = lastLod;
+		if (lod >= lodCount)
+			lod = lodCount - 1;
+
+		if (pMeshData->getLodError(lod) * errorScale > mErrorThreshold * (1.0f + mHysteresis))
+		{
+			// Finer, the coarsest level under the threshold
+			while (lod > 0)
+			{
+				--lod;
+				if (pMeshData->getLodError(lod) * errorScale <= mErrorThreshold)
+					break;
+			}
+		}
+		else
+		{
+			// Coarser, only once the error is well under the threshold
+			for (unsigned int i = lodCount - 1; i > lod; --i)
+			{
+				if (pMeshData->getLodError(i) * errorScale <= mErrorThreshold * (1.0f - mHysteresis))
+				{
+					lod = i;
+					break;
+				}
+			}
+		}
+	}
+
+	if (lod != lastLod)
+		++mStats.switchCount;
+
+	// The model is drawn with the level of the view being rendered
+	model->setLod(lod);
+
+	if (mCurrentView != nullptr)
+		mCurrentView->lods[model->getID()] = lod;
+
+	++mStats.levelCounts[lod];
+
+	if (pMeshData != nullptr)
+	{
+		mStats.triangleCount += getTriangleCount(pMeshData->getIndexBuffer(lod));
+		mStats.fullTriangleCount += getTriangleCount(pMeshData->getIndexBuffer(0));
+	}
+
+	return true;
+}
+
+void LodSelector::resetStats()
+{
+	memset(&mStats, 0, sizeof(LodStats));
+}
+
+const LodStats& LodSelector::getStats() const
+{
+	return mStats;
+}
+
+} // end namespace render
\ No newline at end of file
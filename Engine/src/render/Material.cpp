@@ -46,8 +46,15 @@ Material::Material(const std::string& name, resource::Serializer* serializer): r
 	mFragmentShader = nullptr;
 	mGeometryShader = nullptr;
 
+	mTransparent = false;
+	mInstanced = false;
+
 	mVertexParameters.reserve(VERTEX_BUFFER_TYPE_COUNT);
 	mVertexParameters.resize(VERTEX_BUFFER_TYPE_COUNT, nullptr);
+
+	mParameterBlocks = false;
+
+	invalidateParameterProgram();
 }
 
 Material::~Material()
@@ -190,6 +197,21 @@ Shader* Material::getGeometryShader()
 	return mGeometryShader;
 }
 
+void Material::setTransparent(bool transparent)
+{
+	mTransparent = transparent;
+}
+
+bool Material::isTransparent() const
+{
+	return mTransparent;
+}
+
+bool Material::isInstanced() const
+{
+	return mInstanced;
+}
+
 std::vector<ShaderVertexParameter*>& Material::getVertexParameters()
 {
 	return mVertexParameters;
@@ -205,6 +227,61 @@ std::list<ShaderAutoParameter*>& Material::getAutoParameters()
 	return mAutoParameters;
 }
 
+const std::vector<ShaderParameterInstruction>& Material::getParameterProgram()
+{
+	if (mParameterProgramDirty)
+		compileParameterProgram();
+
+	return mParameterProgram;
+}
+
+void Material::getParameterProgramRange(ShaderParameterFrequency frequency, unsigned int& first, unsigned int& last)
+{
+	if (mParameterProgramDirty)
+		compileParameterProgram();
+
+	first = mParameterProgramOffsets[frequency];
+	last = mParameterProgramOffsets[frequency + 1];
+}
+
+unsigned int Material::getParameterVersion(ShaderParameterFrequency frequency) const
+{
+	return mParameterVersions[frequency];
+}
+
+void Material::setParameterVersion(ShaderParameterFrequency frequency, unsigned int version)
+{
+	mParameterVersions[frequency] = version;
+}
+
+unsigned int Material::getParameterBlockSize(ShaderParameterFrequency frequency)
+{
+	if (mParameterProgramDirty)
+		compileParameterProgram();
+
+	return mParameterBlockSizes[frequency];
+}
+
+void Material::setParameterBlocks(bool parameterBlocks)
+{
+	mParameterBlocks = parameterBlocks;
+}
+
+bool Material::hasParameterBlocks() const
+{
+	return mParameterBlocks;
+}
+
+unsigned int Material::getParameterBlockOffset(ShaderParameterFrequency frequency) const
+{
+	return mParameterBlockOffsets[frequency];
+}
+
+void Material::setParameterBlockOffset(ShaderParameterFrequency frequency, unsigned int offset)
+{
+	mParameterBlockOffsets[frequency] = offset;
+}
+
 void Material::addVertexParameter(const std::string& name, VertexBufferType type)
 {
 	ShaderVertexParameter* pVertexParam = mVertexParameters[(std::size_t)type];
@@ -283,6 +360,11 @@ void Material::addAutoParameter(const std::string& name, ShaderAutoParameterType
 		}
 
 		autoParam->mAutoParameterType = type;
+
+		if (type == SHADER_AUTO_PARAMETER_TYPE_INSTANCE_WORLD_MATRIX)
+			mInstanced = true;
+
+		invalidateParameterProgram();
 	}
 }
 
@@ -389,6 +471,8 @@ void Material::unloadImpl()
 	mVertexShader = nullptr;
 	mFragmentShader = nullptr;
 	mGeometryShader = nullptr;
+
+	mTransparent = false;
 }
 
 ShaderParameter* Material::createParameter(const std::string& name, ShaderParameterType type)
@@ -463,6 +547,124 @@ void Material::removeAllParameters()
 	mParameters.clear();
 	mTextureParameters.clear();
 	mAutoParameters.clear();
+
+	mInstanced = false;
+
+	invalidateParameterProgram();
+}
+
+void Material::invalidateParameterProgram()
+{
+	mParameterProgramDirty = true;
+
+	// The render state data versions start at 1, so every value is set again
+	for (unsigned int i = 0; i < SHADER_PARAMETER_FREQUENCY_COUNT; ++i)
+	{
+		mParameterVersions[i] = 0;
+		mParameterBlockOffsets[i] = (unsigned int)-1;
+	}
+}
+
+void Material::compileParameterProgram()
+{
+	mParameterProgram.clear();
+
+	for (unsigned int i = 0; i <= SHADER_PARAMETER_FREQUENCY_COUNT; ++i)
+		mParameterProgramOffsets[i] = 0;
+
+	// Counting sort by frequency, the instructions of a frequency keep the declaration order
+	std::list<ShaderAutoParameter*>::const_iterator i;
+	for (i = mAutoParameters.begin(); i != mAutoParameters.end(); ++i)
+	{
+		ShaderAutoParameter* pAutoParameter = (*i);
+		if (pAutoParameter == nullptr || pAutoParameter->mParameter == nullptr)
+			continue;
+
+		// The instance matrix is an attribute read from the instance data
+		if (pAutoParameter->mAutoParameterType == SHADER_AUTO_PARAMETER_TYPE_INSTANCE_WORLD_MATRIX)
+			continue;
+
+		++mParameterProgramOffsets[getFrequency(pAutoParameter->mAutoParameterType) + 1];
+	}
+
+	for (unsigned int f = 0; f < SHADER_PARAMETER_FREQUENCY_COUNT; ++f)
+		mParameterProgramOffsets[f + 1] += mParameterProgramOffsets[f];
+
+	mParameterProgram.resize(mParameterProgramOffsets[SHADER_PARAMETER_FREQUENCY_COUNT]);
+
+	unsigned int next[SHADER_PARAMETER_FREQUENCY_COUNT];
+	for (unsigned int f = 0; f < SHADER_PARAMETER_FREQUENCY_COUNT; ++f)
+		next[f] = mParameterProgramOffsets[f];
+
+	for (i = mAutoParameters.begin(); i != mAutoParameters.end(); ++i)
+	{
+		ShaderAutoParameter* pAutoParameter = (*i);
+		if (pAutoParameter == nullptr || pAutoParameter->mParameter == nullptr)
+			continue;
+
+		if (pAutoParameter->mAutoParameterType == SHADER_AUTO_PARAMETER_TYPE_INSTANCE_WORLD_MATRIX)
+			continue;
+
+		ShaderParameterInstruction& instruction = mParameterProgram[next[getFrequency(pAutoParameter->mAutoParameterType)]++];
+		instruction.mParameter = pAutoParameter->mParameter;
+		instruction.mSource = pAutoParameter->mAutoParameterType;
+		instruction.mParameterType = pAutoParameter->mParameter->mParameterType;
+		instruction.mLocation = getParameterLocationImpl(pAutoParameter->mParameter);
+	}
+
+	// std140 layout of the uniform blocks: scalars are aligned to 4 bytes, two component vectors to 8,
+	// the others and the matrix columns to 16. Samplers can not be block members.
+	for (unsigned int f = 0; f < SHADER_PARAMETER_FREQUENCY_COUNT; ++f)
+	{
+		unsigned int blockSize = 0;
+
+		for (unsigned int j = mParameterProgramOffsets[f]; j < mParameterProgramOffsets[f + 1]; ++j)
+		{
+			ShaderParameterInstruction& instruction = mParameterProgram[j];
+
+			unsigned int alignment = 0;
+			unsigned int size = 0;
+			switch (instruction.mParameterType)
+			{
+			case SHADER_PARAMETER_TYPE_FLOAT:
+				alignment = 4;
+				size = 4;
+				break;
+			case SHADER_PARAMETER_TYPE_FLOAT2:
+				alignment = 8;
+				size = 8;
+				break;
+			case SHADER_PARAMETER_TYPE_FLOAT3:
+				alignment = 16;
+				size = 12;
+				break;
+			case SHADER_PARAMETER_TYPE_FLOAT4:
+				alignment = 16;
+				size = 16;
+				break;
+			case SHADER_PARAMETER_TYPE_MATRIX4:
+				alignment = 16;
+				size = 64;
+				break;
+			default:
+				continue;
+			}
+
+			blockSize = ((blockSize + alignment - 1) / alignment) * alignment;
+			instruction.mBlockOffset = blockSize;
+			blockSize += size;
+		}
+
+		// The block size is rounded up to the alignment of a vec4
+		mParameterBlockSizes[f] = ((blockSize + 15) / 16) * 16;
+	}
+
+	mParameterProgramDirty = false;
+}
+
+unsigned int Material::getParameterLocationImpl(ShaderParameter* parameter)
+{
+	return (unsigned int)-1;
 }
 
 void Material::setParameterImpl(ShaderParameter* parameter, const Color& col) {}
@@ -499,6 +701,7 @@ ShaderParameterType Material::getType(ShaderAutoParameterType type)
 	case SHADER_AUTO_PARAMETER_TYPE_INVERSE_WORLDVIEWPROJ_MATRIX:
 	case SHADER_AUTO_PARAMETER_TYPE_TRANSPOSE_WORLDVIEWPROJ_MATRIX:
 	case SHADER_AUTO_PARAMETER_TYPE_INVERSE_TRANSPOSE_WORLDVIEWPROJ_MATRIX:
+	case SHADER_AUTO_PARAMETER_TYPE_INSTANCE_WORLD_MATRIX:
 		return SHADER_PARAMETER_TYPE_MATRIX4;
 	
 	case SHADER_AUTO_PARAMETER_TYPE_LIGHT_COUNT:
@@ -522,12 +725,62 @@ ShaderParameterType Material::getType(ShaderAutoParameterType type)
 	case SHADER_AUTO_PARAMETER_TYPE_CAMERA_POSITION:
 	case SHADER_AUTO_PARAMETER_TYPE_CAMERA_POSITION_OBJECT_SPACE:
 		return SHADER_PARAMETER_TYPE_FLOAT3;
+
+	case SHADER_AUTO_PARAMETER_TYPE_CLUSTER_GRID_SIZE:
+	case SHADER_AUTO_PARAMETER_TYPE_CLUSTER_DEPTH_PARAMETERS:
+		return SHADER_PARAMETER_TYPE_FLOAT4;
+	case SHADER_AUTO_PARAMETER_TYPE_CLUSTER_LIGHT_GRID:
+	case SHADER_AUTO_PARAMETER_TYPE_CLUSTER_LIGHT_INDICES:
+	case SHADER_AUTO_PARAMETER_TYPE_CLUSTER_LIGHT_DATA:
+		return SHADER_PARAMETER_TYPE_SAMPLERBUFFER;
 	
 	default:
 		return SHADER_PARAMETER_TYPE_UNKNOWN;
 	}
 }
 
+ShaderParameterFrequency Material::getFrequency(ShaderAutoParameterType type)
+{
+	switch(type)
+	{
+	case SHADER_AUTO_PARAMETER_TYPE_VIEW_MATRIX:
+	case SHADER_AUTO_PARAMETER_TYPE_INVERSE_VIEW_MATRIX:
+	case SHADER_AUTO_PARAMETER_TYPE_TRANSPOSE_VIEW_MATRIX:
+	case SHADER_AUTO_PARAMETER_TYPE_INVERSE_TRANSPOSE_VIEW_MATRIX:
+	case SHADER_AUTO_PARAMETER_TYPE_PROJECTION_MATRIX:
+	case SHADER_AUTO_PARAMETER_TYPE_INVERSE_PROJECTION_MATRIX:
+	case SHADER_AUTO_PARAMETER_TYPE_TRANSPOSE_PROJECTION_MATRIX:
+	case SHADER_AUTO_PARAMETER_TYPE_INVERSE_TRANSPOSE_PROJECTION_MATRIX:
+	case SHADER_AUTO_PARAMETER_TYPE_VIEWPROJ_MATRIX:
+	case SHADER_AUTO_PARAMETER_TYPE_INVERSE_VIEWPROJ_MATRIX:
+	case SHADER_AUTO_PARAMETER_TYPE_TRANSPOSE_VIEWPROJ_MATRIX:
+	case SHADER_AUTO_PARAMETER_TYPE_INVERSE_TRANSPOSE_VIEWPROJ_MATRIX:
+	case SHADER_AUTO_PARAMETER_TYPE_LIGHT_POSITION_VIEW_SPACE:
+	case SHADER_AUTO_PARAMETER_TYPE_LIGHT_DIRECTION_VIEW_SPACE:
+	case SHADER_AUTO_PARAMETER_TYPE_CAMERA_POSITION:
+	case SHADER_AUTO_PARAMETER_TYPE_CLUSTER_GRID_SIZE:
+	case SHADER_AUTO_PARAMETER_TYPE_CLUSTER_DEPTH_PARAMETERS:
+		return SHADER_PARAMETER_FREQUENCY_CAMERA;
+
+	case SHADER_AUTO_PARAMETER_TYPE_LIGHT_COUNT:
+	case SHADER_AUTO_PARAMETER_TYPE_LIGHT_POSITION:
+	case SHADER_AUTO_PARAMETER_TYPE_LIGHT_DIRECTION:
+	case SHADER_AUTO_PARAMETER_TYPE_AMBIENT_LIGHT_COLOUR:
+	case SHADER_AUTO_PARAMETER_TYPE_LIGHT_DIFFUSE_COLOUR:
+	case SHADER_AUTO_PARAMETER_TYPE_LIGHT_SPECULAR_COLOUR:
+	case SHADER_AUTO_PARAMETER_TYPE_LIGHT_ATTENUATION:
+	case SHADER_AUTO_PARAMETER_TYPE_LIGHT_POWER_SCALE:
+		return SHADER_PARAMETER_FREQUENCY_FRAME;
+
+	// The cluster buffer textures are bound to units all the programs share, so they are bound again with every draw
+	case SHADER_AUTO_PARAMETER_TYPE_CLUSTER_LIGHT_GRID:
+	case SHADER_AUTO_PARAMETER_TYPE_CLUSTER_LIGHT_INDICES:
+	case SHADER_AUTO_PARAMETER_TYPE_CLUSTER_LIGHT_DATA:
+	default:
+		return SHADER_PARAMETER_FREQUENCY_OBJECT;
+	}
+}
+
 ShaderParameterType Material::getType(TextureType type)
 {
 	switch(type)
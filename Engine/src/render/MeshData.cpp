@@ -77,6 +77,48 @@ void MeshData::setIndexBuffer(IndexBuffer* buffer)
 	mIndexBuffer = buffer;
 }
 
+void MeshData::addLod(IndexBuffer* buffer, float error)
+{
+	if (buffer == nullptr || mLodIndexBuffers.size() + 1 >= MESH_LOD_MAX_LEVELS)
+		return;
+
+	mLodIndexBuffers.push_back(buffer);
+	mLodErrors.push_back(error);
+}
+
+unsigned int MeshData::getLodCount() const
+{
+	return mLodIndexBuffers.size() + 1;
+}
+
+IndexBuffer* MeshData::getIndexBuffer(unsigned int lod)
+{
+	if (lod == 0 || mLodIndexBuffers.empty())
+		return mIndexBuffer;
+
+	if (lod > mLodIndexBuffers.size())
+		lod = mLodIndexBuffers.size();
+
+	return mLodIndexBuffers[lod - 1];
+}
+
+float MeshData::getLodError(unsigned int lod) const
+{
+	if (lod == 0 || mLodErrors.empty())
+		return 0.0f;
+
+	if (lod > mLodErrors.size())
+		lod = mLodErrors.size();
+
+	return mLodErrors[lod - 1];
+}
+
+void MeshData::removeLods()
+{
+	mLodIndexBuffers.clear();
+	mLodErrors.clear();
+}
+
 void MeshData::setMaterial(const std::string& filename)
 {
 	if (resource::ResourceManager::getInstance() != nullptr)
@@ -108,6 +150,36 @@ float MeshData::getBoundingSphereRadius()
 	return mBoundRadius;
 }
 
+void MeshData::setOccluderGeometry(const float* positions, unsigned int numVertices, unsigned int stride, const unsigned int* indices, unsigned int numIndexes)
+{
+	mOccluderPositions.clear();
+	mOccluderIndices.clear();
+
+	if (positions == nullptr || indices == nullptr || numVertices == 0 || numIndexes < 3)
+		return;
+
+	const unsigned char* pPosition = reinterpret_cast<const unsigned char*>(positions);
+
+	mOccluderPositions.resize(numVertices);
+	for (unsigned int i = 0; i < numVertices; ++i)
+	{
+		const float* pValues = reinterpret_cast<const float*>(pPosition + i * stride);
+		mOccluderPositions[i] = core::vector4d(pValues[0], pValues[1], pValues[2], 1.0f);
+	}
+
+	mOccluderIndices.assign(indices, indices + numIndexes - numIndexes % 3);
+}
+
+const std::vector<core::vector4d>& MeshData::getOccluderPositions() const
+{
+	return mOccluderPositions;
+}
+
+const std::vector<unsigned int>& MeshData::getOccluderIndices() const
+{
+	return mOccluderIndices;
+}
+
 void MeshData::unloadImpl()
 {
 	mMaterial = nullptr;
@@ -117,8 +189,13 @@ void MeshData::unloadImpl()
 	mVertexBuffers.clear();
 	mIndexBuffer = nullptr;
 
+	removeLods();
+
 	mAABB = core::aabox3d();
 	mBoundRadius = 0.0f;
+
+	mOccluderPositions.clear();
+	mOccluderIndices.clear();
 }
 
 } //namespace render
@@ -0,0 +1,601 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <render/MeshOptimizer.h>
+
+#include <algorithm>
+#include <string.h>
+#include <math.h>
+
+namespace render
+{
+
+//! Size of the LRU cache Forsyth's scores model.
+static const unsigned int FORSYTH_CACHE_SIZE = 32;
+static const float FORSYTH_CACHE_DECAY_POWER = 1.5f;
+static const float FORSYTH_LAST_TRIANGLE_SCORE = 0.75f;
+static const float FORSYTH_VALENCE_BOOST_SCALE = 2.0f;
+static const float FORSYTH_VALENCE_BOOST_POWER = 0.5f;
+
+static const unsigned int MESH_OPTIMIZER_INVALID_INDEX = 0xffffffff;
+
+//! Score of a vertex in Forsyth's algorithm, the triangles of the best scored vertices are drawn first.
+//! \param cachePosition: Position of the vertex in the cache, -1 if it is not in the cache.
+//! \param valence: Number of triangles of the vertex not drawn yet.
+static float getForsythScore(int cachePosition, unsigned int valence)
+{
+	if (valence == 0)
+		return -1.0f;
+
+	float score = 0.0f;
+	if (cachePosition >= 0)
+	{
+		// The vertices of the last triangle get a fixed score so it is not drawn again right away
+		if (cachePosition < 3)
+			score = FORSYTH_LAST_TRIANGLE_SCORE;
+		else
+			score = powf(1.0f - (float)(cachePosition - 3) / (float)(FORSYTH_CACHE_SIZE - 3), FORSYTH_CACHE_DECAY_POWER);
+	}
+
+	// The vertices with few triangles left are finished first so they do not need to be transformed again later
+	score += FORSYTH_VALENCE_BOOST_SCALE * powf((float)valence, -FORSYTH_VALENCE_BOOST_POWER);
+
+	return score;
+}
+
+MeshOptimizer::MeshOptimizer()
+{
+	memset(&mStats, 0, sizeof(MeshOptimizerStats));
+}
+
+MeshOptimizer::~MeshOptimizer() {}
+
+void MeshOptimizer::addStream(std::vector<float>& values, unsigned int numComponents)
+{
+	if (numComponents == 0)
+		return;
+
+	Stream stream;
+	stream.values = &values;
+	stream.numComponents = numComponents;
+
+	mStreams.push_back(stream);
+}
+
+void MeshOptimizer::clearStreams()
+{
+	mStreams.clear();
+}
+
+unsigned int MeshOptimizer::optimize(std::vector<unsigned int>& indices, unsigned int numVertices)
+{
+	memset(&mStats, 0, sizeof(MeshOptimizerStats));
+	mStats.vertexCount = numVertices;
+	mStats.weldedVertexCount = numVertices;
+	mStats.finalVertexCount = numVertices;
+
+	unsigned int numIndexes = indices.size() - indices.size() % 3;
+	if (mStreams.empty() || numIndexes == 0)
+		return numVertices;
+
+	for (unsigned int i = 0; i < mStreams.size(); ++i)
+	{
+		if (mStreams[i].values->size() < numVertices * mStreams[i].numComponents)
+			return numVertices;
+	}
+
+	for (unsigned int i = 0; i < numIndexes; ++i)
+	{
+		if (indices[i] >= numVertices)
+			return numVertices;
+	}
+
+	mStats.before = analyzeVertexCache(&indices[0], numIndexes, numVertices);
+
+	numVertices = weldVertices(indices, numVertices);
+	mStats.weldedVertexCount = numVertices;
+
+	optimizeVertexCache(&indices[0], numIndexes, numVertices);
+
+	const Stream& positions = mStreams[0];
+	if (positions.numComponents >= 3)
+		mStats.clusterCount = optimizeOverdraw(&indices[0], numIndexes, &(*positions.values)[0], positions.numComponents * sizeof(float), numVertices, MESH_OVERDRAW_THRESHOLD);
+
+	std::vector<unsigned int> remap;
+	unsigned int usedCount = optimizeVertexFetch(&indices[0], numIndexes, numVertices, remap);
+	for (unsigned int i = 0; i < mStreams.size(); ++i)
+		remapStream(*mStreams[i].values, mStreams[i].numComponents, remap, usedCount);
+
+	numVertices = usedCount;
+	mStats.finalVertexCount = numVertices;
+	mStats.after = analyzeVertexCache(&indices[0], numIndexes, numVertices);
+
+	return numVertices;
+}
+
+const MeshOptimizerStats& MeshOptimizer::getStats() const
+{
+	return mStats;
+}
+
+unsigned int MeshOptimizer::weldVertices(std::vector<unsigned int>& indices, unsigned int numVertices)
+{
+	if (mStreams.empty() || numVertices == 0)
+		return numVertices;
+
+	std::vector<unsigned int> order(numVertices);
+	for (unsigned int i = 0; i < numVertices; ++i)
+		order[i] = i;
+
+	const MeshOptimizer* pOptimizer = this;
+	std::sort(order.begin(), order.end(), [pOptimizer](unsigned int a, unsigned int b) -> bool
+	{
+		return pOptimizer->isVertexLess(a, b);
+	});
+
+	// Every vertex points to the first one of its equals, the sort keeps them ascending
+	std::vector<unsigned int> first(numVertices);
+	for (unsigned int i = 0; i < numVertices; ++i)
+	{
+		unsigned int vertex = order[i];
+		if (i > 0 && isVertexEqual(order[i - 1], vertex))
+			first[vertex] = first[order[i - 1]];
+		else
+			first[vertex] = vertex;
+	}
+
+	std::vector<unsigned int> remap(numVertices);
+	unsigned int vertexCount = 0;
+	for (unsigned int i = 0; i < numVertices; ++i)
+	{
+		if (first[i] == i)
+			remap[i] = vertexCount++;
+		else
+			remap[i] = remap[first[i]];
+	}
+
+	if (vertexCount == numVertices)
+		return numVertices;
+
+	for (unsigned int i = 0; i < indices.size(); ++i)
+		indices[i] = remap[indices[i]];
+
+	for (unsigned int i = 0; i < mStreams.size(); ++i)
+		remapStream(*mStreams[i].values, mStreams[i].numComponents, remap, vertexCount);
+
+	return vertexCount;
+}
+
+void MeshOptimizer::optimizeVertexCache(unsigned int* indices, unsigned int numIndexes, unsigned int numVertices)
+{
+	unsigned int triangleCount = numIndexes / 3;
+	if (indices == nullptr || triangleCount < 2 || numVertices == 0)
+		return;
+
+	// Triangles of every vertex, the ones drawn are moved past the live count
+	std::vector<unsigned int> offsets(numVertices + 1, 0);
+	for (unsigned int i = 0; i < triangleCount * 3; ++i)
+		++offsets[indices[i] + 1];
+	for (unsigned int i = 0; i < numVertices; ++i)
+		offsets[i + 1] += offsets[i];
+
+	std::vector<unsigned int> vertexTriangles(triangleCount * 3);
+	std::vector<unsigned int> liveCounts(numVertices, 0);
+	for (unsigned int i = 0; i < triangleCount * 3; ++i)
+	{
+		unsigned int vertex = indices[i];
+		vertexTriangles[offsets[vertex] + liveCounts[vertex]++] = i / 3;
+	}
+
+	std::vector<int> cachePositions(numVertices, -1);
+	std::vector<float> vertexScores(numVertices);
+	for (unsigned int i = 0; i < numVertices; ++i)
+		vertexScores[i] = getForsythScore(-1, liveCounts[i]);
+
+	std::vector<float> triangleScores(triangleCount);
+	std::vector<unsigned char> emitted(triangleCount, 0);
+	unsigned int bestTriangle = 0;
+	for (unsigned int i = 0; i < triangleCount; ++i)
+	{
+		triangleScores[i] = vertexScores[indices[i * 3]] + vertexScores[indices[i * 3 + 1]] + vertexScores[indices[i * 3 + 2]];
+		if (triangleScores[i] > triangleScores[bestTriangle])
+			bestTriangle = i;
+	}
+
+	std::vector<unsigned int> result(triangleCount * 3);
+	std::vector<unsigned int> cache;
+	std::vector<unsigned int> newCache;
+	cache.reserve(FORSYTH_CACHE_SIZE + 3);
+	newCache.reserve(FORSYTH_CACHE_SIZE + 3);
+
+	unsigned int cursor = 0;
+	for (unsigned int emitCount = 0; emitCount < triangleCount; ++emitCount)
+	{
+		// Nothing left around the cache, the next triangle in the input order starts a new region
+		if (bestTriangle == MESH_OPTIMIZER_INVALID_INDEX)
+		{
+			while (emitted[cursor] != 0)
+				++cursor;
+			bestTriangle = cursor;
+		}
+
+		const unsigned int* pTriangle = &indices[bestTriangle * 3];
+		result[emitCount * 3 + 0] = pTriangle[0];
+		result[emitCount * 3 + 1] = pTriangle[1];
+		result[emitCount * 3 + 2] = pTriangle[2];
+		emitted[bestTriangle] = 1;
+
+		// The drawn triangle leaves the live triangles of its vertices
+		for (unsigned int k = 0; k < 3; ++k)
+		{
+			unsigned int vertex = pTriangle[k];
+			unsigned int* pTriangles = &vertexTriangles[offsets[vertex]];
+			for (unsigned int j = 0; j < liveCounts[vertex]; ++j)
+			{
+				if (pTriangles[j] == bestTriangle)
+				{
+					pTriangles[j] = pTriangles[liveCounts[vertex] - 1];
+					pTriangles[liveCounts[vertex] - 1] = bestTriangle;
+					--liveCounts[vertex];
+					break;
+				}
+			}
+		}
+
+		// Its vertices move to the front of the cache
+		newCache.clear();
+		newCache.push_back(pTriangle[0]);
+		newCache.push_back(pTriangle[1]);
+		newCache.push_back(pTriangle[2]);
+		for (unsigned int j = 0; j < cache.size(); ++j)
+		{
+			unsigned int vertex = cache[j];
+			if (vertex != pTriangle[0] && vertex != pTriangle[1] && vertex != pTriangle[2])
+				newCache.push_back(vertex);
+		}
+
+		// Rescore the vertices whose cache position or valence changed, the evicted ones included
+		bestTriangle = MESH_OPTIMIZER_INVALID_INDEX;
+		float bestScore = -1.0f;
+		for (unsigned int j = 0; j < newCache.size(); ++j)
+		{
+			unsigned int vertex = newCache[j];
+			int position = (j < FORSYTH_CACHE_SIZE) ? (int)j : -1;
+			cachePositions[vertex] = position;
+
+			float score = getForsythScore(position, liveCounts[vertex]);
+			float delta = score - vertexScores[vertex];
+			vertexScores[vertex] = score;
+
+			const unsigned int* pTriangles = &vertexTriangles[offsets[vertex]];
+			for (unsigned int t = 0; t < liveCounts[vertex]; ++t)
+				triangleScores[pTriangles[t]] += delta;
+		}
+
+		// The next triangle is the best one around the cache
+		for (unsigned int j = 0; j < newCache.size() && j < FORSYTH_CACHE_SIZE; ++j)
+		{
+			unsigned int vertex = newCache[j];
+			const unsigned int* pTriangles = &vertexTriangles[offsets[vertex]];
+			for (unsigned int t = 0; t < liveCounts[vertex]; ++t)
+			{
+				if (triangleScores[pTriangles[t]] > bestScore)
+				{
+					bestScore = triangleScores[pTriangles[t]];
+					bestTriangle = pTriangles[t];
+				}
+			}
+		}
+
+		if (newCache.size() > FORSYTH_CACHE_SIZE)
+			newCache.resize(FORSYTH_CACHE_SIZE);
+
+		cache.swap(newCache);
+	}
+
+	memcpy(indices, &result[0], triangleCount * 3 * sizeof(unsigned int));
+}
+
+unsigned int MeshOptimizer::optimizeOverdraw(unsigned int* indices, unsigned int numIndexes, const float* positions, unsigned int stride, unsigned int numVertices, float threshold)
+{
+	unsigned int triangleCount = numIndexes / 3;
+	if (indices == nullptr || positions == nullptr || triangleCount < 2 || numVertices == 0)
+		return 0;
+
+	const unsigned char* pPositions = (const unsigned char*)positions;
+
+	// A cluster starts where the cache order misses all three vertices, moving it costs no extra transforms
+	std::vector<unsigned int> hardStarts;
+	std::vector<unsigned int> triangleMisses(triangleCount);
+	std::vector<unsigned int> timestamps(numVertices, 0);
+	unsigned int timestamp = MESH_VERTEX_CACHE_SIZE + 1;
+	for (unsigned int i = 0; i < triangleCount; ++i)
+	{
+		unsigned int misses = 0;
+		for (unsigned int k = 0; k < 3; ++k)
+		{
+			unsigned int vertex = indices[i * 3 + k];
+			if (timestamp - timestamps[vertex] > MESH_VERTEX_CACHE_SIZE)
+			{
+				timestamps[vertex] = timestamp++;
+				++misses;
+			}
+		}
+
+		triangleMisses[i] = misses;
+		if (i == 0 || misses == 3)
+			hardStarts.push_back(i);
+	}
+
+	hardStarts.push_back(triangleCount);
+
+	// The hard clusters are split further wherever restarting from a cold cache keeps the cache miss ratio
+	// of the part under the threshold times the ratio of the whole cluster
+	std::vector<unsigned int> clusterStarts;
+	for (unsigned int c = 0; c + 1 < hardStarts.size(); ++c)
+	{
+		unsigned int start = hardStarts[c];
+		unsigned int end = hardStarts[c + 1];
+
+		unsigned int clusterMisses = 0;
+		for (unsigned int i = start; i < end; ++i)
+			clusterMisses += triangleMisses[i];
+
+		float clusterThreshold = threshold * (float)clusterMisses / (float)(end - start);
+
+		clusterStarts.push_back(start);
+
+		timestamp += MESH_VERTEX_CACHE_SIZE + 1;
+		unsigned int partMisses = 0;
+		unsigned int partSize = 0;
+		for (unsigned int i = start; i < end; ++i)
+		{
+			for (unsigned int k = 0; k < 3; ++k)
+			{
+				unsigned int vertex = indices[i * 3 + k];
+				if (timestamp - timestamps[vertex] > MESH_VERTEX_CACHE_SIZE)
+				{
+					timestamps[vertex] = timestamp++;
+					++partMisses;
+				}
+			}
+
+			++partSize;
+			if (i + 1 < end && (float)partMisses <= clusterThreshold * (float)partSize)
+			{
+				clusterStarts.push_back(i + 1);
+
+				timestamp += MESH_VERTEX_CACHE_SIZE + 1;
+				partMisses = 0;
+				partSize = 0;
+			}
+		}
+
+		// The rest of the cluster did not reach the ratio, it stays with the part before it
+		if (partSize > 0 && clusterStarts.back() != start)
+			clusterStarts.pop_back();
+	}
+
+	unsigned int clusterCount = clusterStarts.size();
+	if (clusterCount < 2)
+		return 0;
+
+	clusterStarts.push_back(triangleCount);
+
+	// Area weighted centroids and normals of the clusters and of the mesh
+	std::vector<float> clusterData(clusterCount * 6, 0.0f);
+	float meshCentroid[3] = {0.0f, 0.0f, 0.0f};
+	float meshArea = 0.0f;
+
+	for (unsigned int c = 0; c < clusterCount; ++c)
+	{
+		float* pCluster = &clusterData[c * 6];
+		float clusterArea = 0.0f;
+
+		for (unsigned int i = clusterStarts[c]; i < clusterStarts[c + 1]; ++i)
+		{
+			const float* p0 = (const float*)(pPositions + indices[i * 3 + 0] * stride);
+			const float* p1 = (const float*)(pPositions + indices[i * 3 + 1] * stride);
+			const float* p2 = (const float*)(pPositions + indices[i * 3 + 2] * stride);
+
+			float e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+			float e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+			float normal[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+			float area = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+			for (unsigned int k = 0; k < 3; ++k)
+			{
+				float center = (p0[k] + p1[k] + p2[k]) / 3.0f;
+				pCluster[k] += center * area;
+				pCluster[3 + k] += normal[k];
+				meshCentroid[k] += center * area;
+			}
+
+			clusterArea += area;
+		}
+
+		if (clusterArea > 0.0f)
+		{
+			for (unsigned int k = 0; k < 3; ++k)
+				pCluster[k] /= clusterArea;
+		}
+
+		meshArea += clusterArea;
+	}
+
+	if (meshArea > 0.0f)
+	{
+		for (unsigned int k = 0; k < 3; ++k)
+			meshCentroid[k] /= meshArea;
+	}
+
+	// The clusters facing away from the center are the ones most likely to be in front, they are drawn first
+	std::vector<float> clusterKeys(clusterCount);
+	for (unsigned int c = 0; c < clusterCount; ++c)
+	{
+		const float* pCluster = &clusterData[c * 6];
+		float length = sqrtf(pCluster[3] * pCluster[3] + pCluster[4] * pCluster[4] + pCluster[5] * pCluster[5]);
+
+		float key = 0.0f;
+		if (length > 0.0f)
+		{
+			for (unsigned int k = 0; k < 3; ++k)
+				key += (pCluster[k] - meshCentroid[k]) * pCluster[3 + k];
+			key /= length;
+		}
+
+		clusterKeys[c] = key;
+	}
+
+	std::vector<unsigned int> clusterOrder(clusterCount);
+	for (unsigned int c = 0; c < clusterCount; ++c)
+		clusterOrder[c] = c;
+
+	const std::vector<float>& keys = clusterKeys;
+	std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&keys](unsigned int a, unsigned int b) -> bool
+	{
+		return keys[a] > keys[b];
+	});
+
+	std::vector<unsigned int> result;
+	result.reserve(triangleCount * 3);
+	for (unsigned int c = 0; c < clusterCount; ++c)
+	{
+		unsigned int cluster = clusterOrder[c];
+		result.insert(result.end(), indices + clusterStarts[cluster] * 3, indices + clusterStarts[cluster + 1] * 3);
+	}
+
+	VertexCacheStats before = analyzeVertexCache(indices, triangleCount * 3, numVertices);
+	VertexCacheStats after = analyzeVertexCache(&result[0], triangleCount * 3, numVertices);
+	if (after.acmr > before.acmr * threshold)
+		return 0;
+
+	memcpy(indices, &result[0], triangleCount * 3 * sizeof(unsigned int));
+
+	return clusterCount;
+}
+
+unsigned int MeshOptimizer::optimizeVertexFetch(unsigned int* indices, unsigned int numIndexes, unsigned int numVertices, std::vector<unsigned int>& remap)
+{
+	remap.assign(numVertices, MESH_OPTIMIZER_INVALID_INDEX);
+
+	unsigned int vertexCount = 0;
+	for (unsigned int i = 0; i < numIndexes; ++i)
+	{
+		unsigned int vertex = indices[i];
+		if (remap[vertex] == MESH_OPTIMIZER_INVALID_INDEX)
+			remap[vertex] = vertexCount++;
+
+		indices[i] = remap[vertex];
+	}
+
+	return vertexCount;
+}
+
+void MeshOptimizer::remapStream(std::vector<float>& values, unsigned int numComponents, const std::vector<unsigned int>& remap, unsigned int vertexCount)
+{
+	std::vector<float> result(vertexCount * numComponents, 0.0f);
+
+	for (unsigned int i = 0; i < remap.size(); ++i)
+	{
+		if (remap[i] == MESH_OPTIMIZER_INVALID_INDEX || (i + 1) * numComponents > values.size())
+			continue;
+
+		memcpy(&result[remap[i] * numComponents], &values[i * numComponents], numComponents * sizeof(float));
+	}
+
+	values.swap(result);
+}
+
+VertexCacheStats MeshOptimizer::analyzeVertexCache(const unsigned int* indices, unsigned int numIndexes, unsigned int numVertices, unsigned int cacheSize)
+{
+	VertexCacheStats stats;
+	memset(&stats, 0, sizeof(VertexCacheStats));
+
+	stats.triangleCount = numIndexes / 3;
+	if (indices == nullptr || stats.triangleCount == 0 || numVertices == 0)
+		return stats;
+
+	// A vertex is still in the FIFO if fewer than cacheSize vertices were transformed since it was
+	std::vector<unsigned int> timestamps(numVertices, 0);
+	unsigned int timestamp = cacheSize + 1;
+	for (unsigned int i = 0; i < stats.triangleCount * 3; ++i)
+	{
+		unsigned int vertex = indices[i];
+		if (vertex >= numVertices)
+			continue;
+
+		if (timestamps[vertex] == 0)
+			++stats.vertexCount;
+
+		if (timestamp - timestamps[vertex] > cacheSize)
+		{
+			timestamps[vertex] = timestamp++;
+			++stats.transformCount;
+		}
+	}
+
+	stats.acmr = (float)stats.transformCount / (float)stats.triangleCount;
+	stats.atvr = (stats.vertexCount > 0) ? (float)stats.transformCount / (float)stats.vertexCount : 0.0f;
+
+	return stats;
+}
+
+bool MeshOptimizer::isVertexLess(unsigned int a, unsigned int b) const
+{
+	for (unsigned int i = 0; i < mStreams.size(); ++i)
+	{
+		const float* pA = &(*mStreams[i].values)[a * mStreams[i].numComponents];
+		const float* pB = &(*mStreams[i].values)[b * mStreams[i].numComponents];
+
+		for (unsigned int k = 0; k < mStreams[i].numComponents; ++k)
+		{
+			if (pA[k] != pB[k])
+				return pA[k] < pB[k];
+		}
+	}
+
+	return a < b;
+}
+
+bool MeshOptimizer::isVertexEqual(unsigned int a, unsigned int b) const
+{
+	for (unsigned int i = 0; i < mStreams.size(); ++i)
+	{
+		const float* pA = &(*mStreams[i].values)[a * mStreams[i].numComponents];
+		const float* pB = &(*mStreams[i].values)[b * mStreams[i].numComponents];
+
+		for (unsigned int k = 0; k < mStreams[i].numComponents; ++k)
+		{
+			if (pA[k] != pB[k])
+				return false;
+		}
+	}
+
+	return true;
+}
+
+} // end namespace render
\ No newline at end of file
@@ -0,0 +1,578 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <render/MeshSimplifier.h>
+
+#include <algorithm>
+#include <math.h>
+
+namespace render
+{
+
+//! Weight of the planes along the open borders against the triangle planes.
+static const double MESH_SIMPLIFIER_BORDER_WEIGHT = 10.0;
+
+//! Smallest cosine between a triangle normal before and after a collapse.
+static const float MESH_SIMPLIFIER_FLIP_THRESHOLD = 1e-2f;
+
+static inline unsigned long long makeEdgeKey(unsigned int a, unsigned int b)
+{
+	return ((unsigned long long)a << 32) | (unsigned long long)b;
+}
+
+static inline bool hasEdge(const std::vector<unsigned long long>& edges, unsigned int a, unsigned int b)
+{
+	return std::binary_search(edges.begin(), edges.end(), makeEdgeKey(a, b));
+}
+
+static inline void cross(const float* a, const float* b, const float* c, float* result)
+{
+	float e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+	float e2[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+
+	result[0] = e1[1] * e2[2] - e1[2] * e2[1];
+	result[1] = e1[2] * e2[0] - e1[0] * e2[2];
+	result[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+MeshSimplifier::MeshSimplifier()
+{
+	mNumVertices = 0;
+	mScale = 1.0f;
+}
+
+MeshSimplifier::~MeshSimplifier() {}
+
+void MeshSimplifier::setVertices(const float* positions, unsigned int numVertices, unsigned int stride)
+{
+	mAttributes.clear();
+	mPositions.clear();
+	mNumVertices = 0;
+	mScale = 1.0f;
+
+	if (positions == nullptr || numVertices == 0)
+		return;
+
+	mNumVertices = numVertices;
+	mPositions.resize(numVertices * 3);
+
+	const unsigned char* pSource = (const unsigned char*)positions;
+	float minimum[3] = {0.0f, 0.0f, 0.0f};
+	float maximum[3] = {0.0f, 0.0f, 0.0f};
+	for (unsigned int i = 0; i < numVertices; ++i)
+	{
+		const float* pPosition = (const float*)(pSource + i * stride);
+		for (unsigned int k = 0; k < 3; ++k)
+		{
+			mPositions[i * 3 + k] = pPosition[k];
+
+			if (i == 0 || pPosition[k] < minimum[k])
+				minimum[k] = pPosition[k];
+			if (i == 0 || pPosition[k] > maximum[k])
+				maximum[k] = pPosition[k];
+		}
+	}
+
+	// The errors are measured in a unit box so the thresholds do not depend on the size of the mesh
+	mScale = std::max(maximum[0] - minimum[0], std::max(maximum[1] - minimum[1], maximum[2] - minimum[2]));
+	if (mScale <= 0.0f)
+		mScale = 1.0f;
+
+	float invScale = 1.0f / mScale;
+	for (unsigned int i = 0; i < numVertices; ++i)
+	{
+		for (unsigned int k = 0; k < 3; ++k)
+			mPositions[i * 3 + k] = (mPositions[i * 3 + k] - minimum[k]) * invScale;
+	}
+}
+
+void MeshSimplifier::addAttribute(const float* values, unsigned int numComponents, unsigned int stride, float weight)
+{
+	if (values == nullptr || numComponents == 0 || weight <= 0.0f)
+		return;
+
+	Attribute attribute;
+	attribute.values = (const unsigned char*)values;
+	attribute.numComponents = numComponents;
+	attribute.stride = stride;
+	attribute.weight = weight;
+
+	mAttributes.push_back(attribute);
+}
+
+float MeshSimplifier::simplify(const unsigned int* indices, unsigned int numIndexes, unsigned int targetIndexCount, float maxError, std::vector<unsigned int>& result)
+{
+	numIndexes -= numIndexes % 3;
+	result.assign(indices, indices + numIndexes);
+
+	if (numIndexes <= targetIndexCount || !prepare(indices, numIndexes))
+		return 0.0f;
+
+	double error = collapseEdges(result, targetIndexCount, (double)maxError * (double)maxError);
+
+	return (float)sqrt(error);
+}
+
+unsigned int MeshSimplifier::buildLodChain(const unsigned int* indices, unsigned int numIndexes, unsigned int maxLevels, std::vector<std::vector<unsigned int> >& levels, std::vector<float>& errors)
+{
+	levels.clear();
+	errors.clear();
+
+	numIndexes -= numIndexes % 3;
+	if (!prepare(indices, numIndexes))
+		return 0;
+
+	// One simplification runs through all the levels, the quadrics keep measuring the error against the full mesh
+	std::vector<unsigned int> simplified(indices, indices + numIndexes);
+	double error = 0.0;
+
+	for (unsigned int level = 0; level < maxLevels; ++level)
+	{
+		unsigned int currentCount = simplified.size();
+		unsigned int targetCount = (currentCount / 6) * 3;
+		if (targetCount / 3 < MESH_LOD_MIN_TRIANGLES)
+			break;
+
+		error = std::max(error, collapseEdges(simplified, targetCount, 1.0));
+		if (simplified.size() * 4 > currentCount * 3)
+			break;
+
+		levels.push_back(simplified);
+		errors.push_back((float)sqrt(error) * mScale);
+	}
+
+	return levels.size();
+}
+
+float MeshSimplifier::getScale() const
+{
+	return mScale;
+}
+
+void MeshSimplifier::addPlane(Quadric& q, double a, double b, double c, double d, double weight)
+{
+	q.a00 += weight * a * a;
+	q.a01 += weight * a * b;
+	q.a02 += weight * a * c;
+	q.a11 += weight * b * b;
+	q.a12 += weight * b * c;
+	q.a22 += weight * c * c;
+	q.b0 += weight * a * d;
+	q.b1 += weight * b * d;
+	q.b2 += weight * c * d;
+	q.c += weight * d * d;
+	q.weight += weight;
+}
+
+void MeshSimplifier::addQuadric(Quadric& q, const Quadric& other)
+{
+	q.a00 += other.a00;
+	q.a01 += other.a01;
+	q.a02 += other.a02;
+	q.a11 += other.a11;
+	q.a12 += other.a12;
+	q.a22 += other.a22;
+	q.b0 += other.b0;
+	q.b1 += other.b1;
+	q.b2 += other.b2;
+	q.c += other.c;
+	q.weight += other.weight;
+}
+
+double MeshSimplifier::getQuadricError(const Quadric& q, const float* p)
+{
+	double x = p[0];
+	double y = p[1];
+	double z = p[2];
+
+	double error = q.a00 * x * x + q.a11 * y * y + q.a22 * z * z +
+		2.0 * (q.a01 * x * y + q.a02 * x * z + q.a12 * y * z) +
+		2.0 * (q.b0 * x + q.b1 * y + q.b2 * z) + q.c;
+
+	// Mean squared distance to the planes
+	if (q.weight > 0.0)
+		error /= q.weight;
+
+	return (error > 0.0) ? error : 0.0;
+}
+
+const float* MeshSimplifier::getPosition(unsigned int vertex) const
+{
+	return &mPositions[vertex * 3];
+}
+
+float MeshSimplifier::getAttributeError(unsigned int vertex, unsigned int target) const
+{
+	float error = 0.0f;
+
+	for (unsigned int i = 0; i < mAttributes.size(); ++i)
+	{
+		const Attribute& attribute = mAttributes[i];
+		const float* pVertex = (const float*)(attribute.values + vertex * attribute.stride);
+		const float* pTarget = (const float*)(attribute.values + target * attribute.stride);
+
+		float distance = 0.0f;
+		for (unsigned int k = 0; k < attribute.numComponents; ++k)
+			distance += (pVertex[k] - pTarget[k]) * (pVertex[k] - pTarget[k]);
+
+		error += attribute.weight * distance;
+	}
+
+	return error;
+}
+
+double MeshSimplifier::collapseEdges(std::vector<unsigned int>& indices, unsigned int targetIndexCount, double maxErrorSquared)
+{
+	double resultError = 0.0;
+
+	std::vector<unsigned int> remap(mNumVertices);
+	std::vector<unsigned char> touched(mNumVertices);
+	std::vector<Collapse> collapses;
+
+	while (indices.size() > targetIndexCount)
+	{
+		unsigned int triangleCount = indices.size() / 3;
+
+		// Triangles around every vertex of the current mesh
+		mVertexTriangleOffsets.assign(mNumVertices + 1, 0);
+		for (unsigned int i = 0; i < indices.size(); ++i)
+			++mVertexTriangleOffsets[indices[i] + 1];
+		for (unsigned int i = 0; i < mNumVertices; ++i)
+			mVertexTriangleOffsets[i + 1] += mVertexTriangleOffsets[i];
+
+		mVertexTriangles.resize(indices.size());
+		std::vector<unsigned int> fill(mVertexTriangleOffsets.begin(), mVertexTriangleOffsets.end() - 1);
+		for (unsigned int i = 0; i < indices.size(); ++i)
+			mVertexTriangles[fill[indices[i]]++] = i / 3;
+
+		// Every direction of every edge that may collapse, with its cost
+		collapses.clear();
+		for (unsigned int i = 0; i < indices.size(); i += 3)
+		{
+			for (unsigned int e = 0; e < 3; ++e)
+			{
+				unsigned int a = indices[i + e];
+				unsigned int b = indices[i + (e + 1) % 3];
+
+				for (unsigned int d = 0; d < 2; ++d)
+				{
+					unsigned int vertex = (d == 0) ? a : b;
+					unsigned int target = (d == 0) ? b : a;
+
+					if (vertex == target || mVertexKinds[vertex] == VERTEX_KIND_LOCKED)
+						continue;
+
+					// Border vertices only slide along their border
+					if (mVertexKinds[vertex] == VERTEX_KIND_BORDER &&
+						(mVertexKinds[target] != VERTEX_KIND_BORDER ||
+						(!hasEdge(mBorderEdges, vertex, target) && !hasEdge(mBorderEdges, target, vertex))))
+						continue;
+
+					Quadric q = mQuadrics[vertex];
+					addQuadric(q, mQuadrics[target]);
+
+					Collapse collapse;
+					collapse.vertex = vertex;
+					collapse.target = target;
+					collapse.error = (float)getQuadricError(q, getPosition(target)) + getAttributeError(vertex, target);
+
+					collapses.push_back(collapse);
+				}
+			}
+		}
+
+		if (collapses.empty())
+			break;
+
+		std::sort(collapses.begin(), collapses.end());
+
+		// Every collapse removes about two triangles, only the cheapest candidates for the goal are taken
+		// in one pass so the expensive ones are measured again on the simplified mesh
+		unsigned int triangleGoal = triangleCount - targetIndexCount / 3;
+		double passError = collapses[std::min((unsigned int)collapses.size() - 1, triangleGoal)].error;
+		passError = std::min(passError, maxErrorSquared);
+
+		for (unsigned int i = 0; i < mNumVertices; ++i)
+			remap[i] = i;
+		touched.assign(mNumVertices, 0);
+
+		unsigned int removedCount = 0;
+		unsigned int collapseCount = 0;
+		for (unsigned int i = 0; i < collapses.size() && removedCount < triangleGoal; ++i)
+		{
+			const Collapse& collapse = collapses[i];
+			if (collapse.error > passError)
+				break;
+
+			if (touched[collapse.vertex] != 0 || touched[collapse.target] != 0)
+				continue;
+
+			if (!checkFlip(collapse.vertex, collapse.target, indices))
+				continue;
+
+			remap[collapse.vertex] = collapse.target;
+			addQuadric(mQuadrics[collapse.target], mQuadrics[collapse.vertex]);
+
+			// The triangles around the vertex are locked for the pass so the flip checks stay valid
+			for (unsigned int j = mVertexTriangleOffsets[collapse.vertex]; j < mVertexTriangleOffsets[collapse.vertex + 1]; ++j)
+			{
+				const unsigned int* pTriangle = &indices[mVertexTriangles[j] * 3];
+				if (pTriangle[0] == collapse.target || pTriangle[1] == collapse.target || pTriangle[2] == collapse.target)
+					++removedCount;
+
+				touched[pTriangle[0]] = 1;
+				touched[pTriangle[1]] = 1;
+				touched[pTriangle[2]] = 1;
+			}
+
+			touched[collapse.target] = 1;
+
+			resultError = std::max(resultError, (double)collapse.error);
+			++collapseCount;
+		}
+
+		if (collapseCount == 0)
+			break;
+
+		unsigned int writeIndex = 0;
+		for (unsigned int i = 0; i < indices.size(); i += 3)
+		{
+			unsigned int a = remap[indices[i + 0]];
+			unsigned int b = remap[indices[i + 1]];
+			unsigned int c = remap[indices[i + 2]];
+
+			if (a == b || b == c || c == a)
+				continue;
+
+			indices[writeIndex + 0] = a;
+			indices[writeIndex + 1] = b;
+			indices[writeIndex + 2] = c;
+			writeIndex += 3;
+		}
+
+		indices.resize(writeIndex);
+	}
+
+	return resultError;
+}
+
+bool MeshSimplifier::prepare(const unsigned int* indices, unsigned int numIndexes)
+{
+	if (mNumVertices == 0 || indices == nullptr || numIndexes == 0)
+		return false;
+
+	for (unsigned int i = 0; i < numIndexes; ++i)
+	{
+		if (indices[i] >= mNumVertices)
+			return false;
+	}
+
+	// Vertices sharing a position, the first one of every position stands for the others
+	std::vector<unsigned int> order(mNumVertices);
+	for (unsigned int i = 0; i < mNumVertices; ++i)
+		order[i] = i;
+
+	const std::vector<float>& positions = mPositions;
+	std::sort(order.begin(), order.end(), [&positions](unsigned int a, unsigned int b) -> bool
+	{
+		for (unsigned int k = 0; k < 3; ++k)
+		{
+			if (positions[a * 3 + k] != positions[b * 3 + k])
+				return positions[a * 3 + k] < positions[b * 3 + k];
+		}
+		return a < b;
+	});
+
+	mPositionRemap.resize(mNumVertices);
+	std::vector<unsigned int> wedgeCounts(mNumVertices, 0);
+	for (unsigned int i = 0; i < mNumVertices; ++i)
+	{
+		unsigned int vertex = order[i];
+		unsigned int first = vertex;
+		if (i > 0)
+		{
+			unsigned int previous = order[i - 1];
+			if (positions[previous * 3 + 0] == positions[vertex * 3 + 0] &&
+				positions[previous * 3 + 1] == positions[vertex * 3 + 1] &&
+				positions[previous * 3 + 2] == positions[vertex * 3 + 2])
+				first = mPositionRemap[previous];
+		}
+
+		mPositionRemap[vertex] = first;
+		++wedgeCounts[first];
+	}
+
+	// Directed edges between positions, the ones without their opposite are open borders
+	std::vector<unsigned long long> edges;
+	edges.reserve(numIndexes);
+	for (unsigned int i = 0; i < numIndexes; i += 3)
+	{
+		for (unsigned int e = 0; e < 3; ++e)
+		{
+			unsigned int a = mPositionRemap[indices[i + e]];
+			unsigned int b = mPositionRemap[indices[i + (e + 1) % 3]];
+			if (a != b)
+				edges.push_back(makeEdgeKey(a, b));
+		}
+	}
+
+	std::sort(edges.begin(), edges.end());
+
+	std::vector<unsigned int> openOut(mNumVertices, 0);
+	std::vector<unsigned int> openIn(mNumVertices, 0);
+	std::vector<unsigned char> complex(mNumVertices, 0);
+
+	mBorderEdges.clear();
+	for (unsigned int i = 0; i < edges.size(); ++i)
+	{
+		unsigned int a = (unsigned int)(edges[i] >> 32);
+		unsigned int b = (unsigned int)(edges[i] & 0xffffffff);
+
+		// An edge used twice in the same direction is not manifold
+		if ((i > 0 && edges[i - 1] == edges[i]) || (i + 1 < edges.size() && edges[i + 1] == edges[i]))
+		{
+			complex[a] = 1;
+			complex[b] = 1;
+			continue;
+		}
+
+		if (!hasEdge(edges, b, a))
+		{
+			++openOut[a];
+			++openIn[b];
+			mBorderEdges.push_back(edges[i]);
+		}
+	}
+
+	mVertexKinds.resize(mNumVertices);
+	for (unsigned int i = 0; i < mNumVertices; ++i)
+	{
+		unsigned int position = mPositionRemap[i];
+
+		if (complex[position] != 0 || wedgeCounts[position] > 1)
+			mVertexKinds[i] = VERTEX_KIND_LOCKED;
+		else if (openOut[position] == 0 && openIn[position] == 0)
+			mVertexKinds[i] = VERTEX_KIND_MANIFOLD;
+		else if (openOut[position] == 1 && openIn[position] == 1)
+			mVertexKinds[i] = VERTEX_KIND_BORDER;
+		else
+			mVertexKinds[i] = VERTEX_KIND_LOCKED;
+	}
+
+	// Area weighted triangle planes and the planes perpendicular to the open borders
+	Quadric zero;
+	zero.a00 = zero.a01 = zero.a02 = zero.a11 = zero.a12 = zero.a22 = 0.0;
+	zero.b0 = zero.b1 = zero.b2 = zero.c = zero.weight = 0.0;
+	mQuadrics.assign(mNumVertices, zero);
+
+	for (unsigned int i = 0; i < numIndexes; i += 3)
+	{
+		const float* p[3] = {getPosition(indices[i]), getPosition(indices[i + 1]), getPosition(indices[i + 2])};
+
+		float normal[3];
+		cross(p[0], p[1], p[2], normal);
+
+		double length = sqrt((double)normal[0] * normal[0] + (double)normal[1] * normal[1] + (double)normal[2] * normal[2]);
+		if (length <= 0.0)
+			continue;
+
+		double a = normal[0] / length;
+		double b = normal[1] / length;
+		double c = normal[2] / length;
+		double d = -(a * p[0][0] + b * p[0][1] + c * p[0][2]);
+
+		for (unsigned int k = 0; k < 3; ++k)
+			addPlane(mQuadrics[indices[i + k]], a, b, c, d, length * 0.5);
+
+		for (unsigned int e = 0; e < 3; ++e)
+		{
+			unsigned int v0 = indices[i + e];
+			unsigned int v1 = indices[i + (e + 1) % 3];
+			if (!hasEdge(mBorderEdges, mPositionRemap[v0], mPositionRemap[v1]))
+				continue;
+
+			const float* p0 = getPosition(v0);
+			const float* p1 = getPosition(v1);
+			double edge[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+			double edgeLengthSquared = edge[0] * edge[0] + edge[1] * edge[1] + edge[2] * edge[2];
+
+			double ba = edge[1] * c - edge[2] * b;
+			double bb = edge[2] * a - edge[0] * c;
+			double bc = edge[0] * b - edge[1] * a;
+			double borderLength = sqrt(ba * ba + bb * bb + bc * bc);
+			if (borderLength <= 0.0)
+				continue;
+
+			ba /= borderLength;
+			bb /= borderLength;
+			bc /= borderLength;
+			double bd = -(ba * p0[0] + bb * p0[1] + bc * p0[2]);
+
+			addPlane(mQuadrics[v0], ba, bb, bc, bd, edgeLengthSquared * MESH_SIMPLIFIER_BORDER_WEIGHT);
+			addPlane(mQuadrics[v1], ba, bb, bc, bd, edgeLengthSquared * MESH_SIMPLIFIER_BORDER_WEIGHT);
+		}
+	}
+
+	return true;
+}
+
+bool MeshSimplifier::checkFlip(unsigned int vertex, unsigned int target, const std::vector<unsigned int>& indices) const
+{
+	const float* pTarget = getPosition(target);
+
+	for (unsigned int i = mVertexTriangleOffsets[vertex]; i < mVertexTriangleOffsets[vertex + 1]; ++i)
+	{
+		const unsigned int* pTriangle = &indices[mVertexTriangles[i] * 3];
+
+		// The triangles of the collapsed edge are removed
+		if (pTriangle[0] == target || pTriangle[1] == target || pTriangle[2] == target)
+			continue;
+
+		const float* p[3];
+		const float* q[3];
+		for (unsigned int k = 0; k < 3; ++k)
+		{
+			p[k] = getPosition(pTriangle[k]);
+			q[k] = (pTriangle[k] == vertex) ? pTarget : p[k];
+		}
+
+		float before[3];
+		float after[3];
+		cross(p[0], p[1], p[2], before);
+		cross(q[0], q[1], q[2], after);
+
+		float dot = before[0] * after[0] + before[1] * after[1] + before[2] * after[2];
+		float lengths = sqrtf((before[0] * before[0] + before[1] * before[1] + before[2] * before[2]) *
+			(after[0] * after[0] + after[1] * after[1] + after[2] * after[2]));
+
+		if (dot <= MESH_SIMPLIFIER_FLIP_THRESHOLD * lengths)
+			return false;
+	}
+
+	return true;
+}
+
+} // end namespace render
\ No newline at end of file
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include <game/ComponentDefines.h>
 #include <game/MessageDefines.h>
 #include <render/RenderDefines.h>
+#include <render/RenderManager.h>
 #include <resource/ResourceEvent.h>
 #include <resource/ResourceManager.h>
 #include <core/Utils.h>
@@ -42,6 +43,7 @@ namespace render
 Model::Model(): game::Component()
 {
 	mType = game::COMPONENT_TYPE_MODEL;
+	mMessageMask = MESSAGE_MASK(game::MESSAGE_TRANSFORM_NEEDS_UPDATE);
 
 	// Init matrix
 	mWorldMatrix = core::matrix4::IDENTITY;
@@ -55,6 +57,12 @@ Model::Model(): game::Component()
 	mVisibleBoundingBox = false;
 	mVisibleBoundingSphere = false;
 
+	mOccluder = false;
+
+	mStatic = false;
+
+	mLod = 0;
+
 	mWorldMatrix = core::matrix4::IDENTITY;
 
 	mRenderOperationType = ROT_TRIANGLE_LIST;
@@ -176,6 +184,36 @@ void Model::setVisibleBoundingSphere(bool visible)
 	mVisibleBoundingSphere = visible;
 }
 
+void Model::setOccluder(bool occluder)
+{
+	mOccluder = occluder;
+}
+
+bool Model::isOccluder() const
+{
+	return mOccluder;
+}
+
+void Model::setStatic(bool isStatic)
+{
+	mStatic = isStatic;
+}
+
+bool Model::isStatic() const
+{
+	return mStatic;
+}
+
+void Model::setLod(unsigned int lod)
+{
+	mLod = lod;
+}
+
+unsigned int Model::getLod() const
+{
+	return mLod;
+}
+
 const core::matrix4& Model::getWorldMatrix()
 {
 	return mWorldMatrix;
@@ -209,7 +247,7 @@ IndexBuffer* Model::getIndexBuffer()
 	if (mMeshData == nullptr)
 		return nullptr;
 
-	return mMeshData->getIndexBuffer();
+	return mMeshData->getIndexBuffer(mLod);
 }
 
 void Model::resourceLoaded(const resource::ResourceEvent& evt)
@@ -229,6 +267,9 @@ void Model::resourceLoaded(const resource::ResourceEvent& evt)
 			}
 
 			mRenderOperationType = mMeshData->getRenderOperationType();
+
+			// the bounds come from the mesh data
+			mModelNeedsUpdate = true;
 		
 			initialize();
 		}
@@ -256,7 +297,7 @@ void Model::updateImpl(float elapsedTime)
 	{
 		if (mGameObject != nullptr)
 		{
-			game::Transform* pTransform = static_cast<game::Transform*>(mGameObject->getComponent(game::COMPONENT_TYPE_TRANSFORM));
+			game::Transform* pTransform = mGameObject->getTransform();
 			if (pTransform != nullptr)
 			{
 				core::vector3d position = pTransform->getAbsolutePosition();
@@ -279,6 +320,9 @@ void Model::updateImpl(float elapsedTime)
 
 					mBoundingSphere.Center = position;
 
+					// the visibility tree is updated serially
+					requestCommit();
+
 #ifdef _DEBUG
 					//std::cout<<"Center: "<<mBoundingSphere.Center<<std::endl;
 					//std::cout<<"Radius: "<<mBoundingSphere.Radius<<std::endl;
@@ -291,6 +335,12 @@ void Model::updateImpl(float elapsedTime)
 	}
 }
 
+void Model::commitImpl()
+{
+	if (RenderManager::getInstance() != nullptr)
+		RenderManager::getInstance()->updateModel(this);
+}
+
 void Model::onMessageImpl(unsigned int messageID)
 {
 	if (messageID == game::MESSAGE_TRANSFORM_NEEDS_UPDATE)
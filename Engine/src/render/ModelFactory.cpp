@@ -31,14 +31,15 @@ THE SOFTWARE.
 namespace render
 {
 
-ModelFactory::ModelFactory(): game::ComponentFactory()
+ModelFactory::ModelFactory(): game::PooledComponentFactory<Model>()
 {
 	mName = "Model";
+	mThreadSafe = true;
 }
 
 game::Component* ModelFactory::createComponent()
 {
-	Model* pModel = new Model();
+	Model* pModel = mPool.create();
 
 	if (RenderManager::getInstance() != nullptr)
 		RenderManager::getInstance()->addModel(pModel);
@@ -54,7 +55,7 @@ void ModelFactory::destroyComponent(game::Component* component)
 		RenderManager::getInstance()->removeModel(pModel);
 
 	assert(pModel != nullptr);
-	SAFE_DELETE(pModel);
+	mPool.destroy(pModel);
 }
 
 } // end namespace game
\ No newline at end of file
@@ -0,0 +1,573 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <render/OcclusionCuller.h>
+#include <render/Model.h>
+#include <core/Aabox3d.h>
+#include <core/JobSystem.h>
+#include <core/Profiler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <math.h>
+#include <string.h>
+
+namespace render
+{
+
+//! Width and height of the tiles the depth buffer is rasterized in, one job per tile.
+static const unsigned int OCCLUSION_TILE_SIZE = 32;
+
+//! Pyramid levels a tile reduces on its own, OCCLUSION_TILE_SIZE is 1 << OCCLUSION_TILE_LEVELS.
+static const unsigned int OCCLUSION_TILE_LEVELS = 5;
+
+//! Default size of the depth buffer.
+static const unsigned int OCCLUSION_DEFAULT_WIDTH = 320;
+static const unsigned int OCCLUSION_DEFAULT_HEIGHT = 192;
+
+//! Triangles are clipped where the clip space w drops below this value, closer points would project too far.
+static const float OCCLUSION_NEAR_W = 0.001f;
+
+//! Models tested per job.
+static const unsigned int OCCLUSION_TEST_GRAIN_SIZE = 256;
+
+//! Depth of the pixels no occluder covers.
+static const float OCCLUSION_CLEAR_DEPTH = std::numeric_limits<float>::max();
+
+struct OcclusionTest
+{
+	const OcclusionCuller* culler;
+	Model* const* models;
+	unsigned char* visible;
+};
+
+OcclusionCuller::OcclusionCuller()
+{
+	mEnabled = true;
+
+	mWidth = 0;
+	mHeight = 0;
+	mTileCountX = 0;
+	mTileCountY = 0;
+
+	memset(&mStats, 0, sizeof(OcclusionStats));
+
+	setResolution(OCCLUSION_DEFAULT_WIDTH, OCCLUSION_DEFAULT_HEIGHT);
+}
+
+OcclusionCuller::~OcclusionCuller() {}
+
+void OcclusionCuller::setEnabled(bool enabled)
+{
+	mEnabled = enabled;
+}
+
+bool OcclusionCuller::isEnabled() const
+{
+	return mEnabled;
+}
+
+void OcclusionCuller::setResolution(unsigned int width, unsigned int height)
+{
+	mTileCountX = std::max((width + OCCLUSION_TILE_SIZE - 1) / OCCLUSION_TILE_SIZE, 1u);
+	mTileCountY = std::max((height + OCCLUSION_TILE_SIZE - 1) / OCCLUSION_TILE_SIZE, 1u);
+
+	mWidth = mTileCountX * OCCLUSION_TILE_SIZE;
+	mHeight = mTileCountY * OCCLUSION_TILE_SIZE;
+
+	mLevels.clear();
+
+	unsigned int levelWidth = mWidth;
+	unsigned int levelHeight = mHeight;
+	while (true)
+	{
+		mLevels.push_back(DepthLevel());
+
+		DepthLevel& level = mLevels.back();
+		level.width = levelWidth;
+		level.height = levelHeight;
+		level.farthest.assign(levelWidth * levelHeight, OCCLUSION_CLEAR_DEPTH);
+		if (mLevels.size() > 1)
+			level.nearest.assign(levelWidth * levelHeight, OCCLUSION_CLEAR_DEPTH);
+
+		if (levelWidth == 1 && levelHeight == 1)
+			break;
+
+		levelWidth = (levelWidth + 1) / 2;
+		levelHeight = (levelHeight + 1) / 2;
+	}
+
+	mTriangles.clear();
+	mTileBins.clear();
+	mTileBins.resize(mTileCountX * mTileCountY);
+}
+
+unsigned int OcclusionCuller::getWidth() const
+{
+	return mWidth;
+}
+
+unsigned int OcclusionCuller::getHeight() const
+{
+	return mHeight;
+}
+
+void OcclusionCuller::beginFrame(const core::matrix4& viewProjection)
+{
+	mViewProjection = viewProjection;
+
+	mTriangles.clear();
+	for (unsigned int i = 0; i < mTileBins.size(); ++i)
+		mTileBins[i].clear();
+
+	memset(&mStats, 0, sizeof(OcclusionStats));
+}
+
+void OcclusionCuller::addOccluder(const core::matrix4& world, const core::vector4d* positions, unsigned int numVertices, const unsigned int* indices, unsigned int numIndexes)
+{
+	if (positions == nullptr || indices == nullptr || numVertices == 0)
+		return;
+
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	core::matrix4 worldViewProjection = mViewProjection * world;
+
+	mClipPositions.resize(numVertices);
+	worldViewProjection.transformVectors(positions, &mClipPositions[0], numVertices);
+
+	for (unsigned int i = 0; i + 2 < numIndexes; i += 3)
+	{
+		unsigned int a = indices[i];
+		unsigned int b = indices[i + 1];
+		unsigned int c = indices[i + 2];
+
+		if (a < numVertices && b < numVertices && c < numVertices)
+			addClipTriangle(mClipPositions[a], mClipPositions[b], mClipPositions[c]);
+	}
+
+	++mStats.occluderCount;
+
+	std::chrono::duration<float, std::milli> time = std::chrono::steady_clock::now() - startTime;
+	mStats.rasterizeTime += time.count();
+}
+
+void OcclusionCuller::rasterizeOccluders()
+{
+	if (mTriangles.empty())
+		return;
+
+	PROFILE_SCOPE("OcclusionCuller::rasterizeOccluders");
+
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	unsigned int tileCount = mTileCountX * mTileCountY;
+
+	core::JobSystem* pJobSystem = core::JobSystem::getInstance();
+	if (pJobSystem != nullptr && pJobSystem->getWorkerCount() > 0 && tileCount > 1)
+		pJobSystem->parallelFor(tileCount, &OcclusionCuller::rasterizeTiles, this, 1);
+	else
+		rasterizeTiles(0, tileCount, this);
+
+	buildUpperLevels();
+
+	std::chrono::duration<float, std::milli> time = std::chrono::steady_clock::now() - startTime;
+	mStats.rasterizeTime += time.count();
+}
+
+bool OcclusionCuller::isVisible(const core::aabox3d& box) const
+{
+	if (mTriangles.empty())
+		return true;
+
+	const core::vector3d& minEdge = box.MinEdge;
+	const core::vector3d& maxEdge = box.MaxEdge;
+	const float* m = mViewProjection.get();
+
+	float minX = std::numeric_limits<float>::max();
+	float minY = std::numeric_limits<float>::max();
+	float maxX = -std::numeric_limits<float>::max();
+	float maxY = -std::numeric_limits<float>::max();
+	float nearest = std::numeric_limits<float>::max();
+
+	for (unsigned int i = 0; i < 8; ++i)
+	{
+		float x = (i & 1) ? maxEdge.x : minEdge.x;
+		float y = (i & 2) ? maxEdge.y : minEdge.y;
+		float z = (i & 4) ? maxEdge.z : minEdge.z;
+
+		core::vector4d clip(m[ 0] * x + m[ 1] * y + m[ 2] * z + m[ 3],
+							m[ 4] * x + m[ 5] * y + m[ 6] * z + m[ 7],
+							m[ 8] * x + m[ 9] * y + m[10] * z + m[11],
+							m[12] * x + m[13] * y + m[14] * z + m[15]);
+
+		// a box reaching behind the near plane cannot be bounded on screen
+		if (!(clip.w > OCCLUSION_NEAR_W))
+			return true;
+
+		float screen[3];
+		projectToScreen(clip, screen);
+
+		minX = std::min(minX, screen[0]);
+		minY = std::min(minY, screen[1]);
+		maxX = std::max(maxX, screen[0]);
+		maxY = std::max(maxY, screen[1]);
+		nearest = std::min(nearest, screen[2]);
+	}
+
+	// nothing to test against outside of the depth buffer
+	if (!(maxX >= 0.0f && maxY >= 0.0f && minX < (float)mWidth && minY < (float)mHeight))
+		return true;
+
+	// every pixel the screen rectangle touches
+	unsigned int x0 = minX > 0.0f ? (unsigned int)minX : 0;
+	unsigned int y0 = minY > 0.0f ? (unsigned int)minY : 0;
+	unsigned int x1 = maxX < (float)(mWidth - 1) ? (unsigned int)maxX : mWidth - 1;
+	unsigned int y1 = maxY < (float)(mHeight - 1) ? (unsigned int)maxY : mHeight - 1;
+
+	// start at the finest level where the rectangle covers at most 2 x 2 texels
+	unsigned int level = 0;
+	while (level + 1 < mLevels.size() && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1))
+		++level;
+
+	return isRectVisible(level, x0, y0, x1, y1, nearest);
+}
+
+void OcclusionCuller::cullModels(std::vector<Model*>& models)
+{
+	unsigned int count = (unsigned int)models.size();
+	mStats.testedCount += count;
+
+	if (count == 0 || mTriangles.empty())
+		return;
+
+	PROFILE_SCOPE("OcclusionCuller::cullModels");
+
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	mModelVisible.resize(count);
+
+	OcclusionTest test;
+	test.culler = this;
+	test.models = &models[0];
+	test.visible = &mModelVisible[0];
+
+	core::JobSystem* pJobSystem = core::JobSystem::getInstance();
+	if (pJobSystem != nullptr && pJobSystem->getWorkerCount() > 0 && count > OCCLUSION_TEST_GRAIN_SIZE)
+		pJobSystem->parallelFor(count, &OcclusionCuller::testModels, &test, OCCLUSION_TEST_GRAIN_SIZE);
+	else
+		testModels(0, count, &test);
+
+	unsigned int visibleCount = 0;
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		if (mModelVisible[i] != 0)
+			models[visibleCount++] = models[i];
+	}
+
+	models.resize(visibleCount);
+	mStats.culledCount += count - visibleCount;
+
+	std::chrono::duration<float, std::milli> time = std::chrono::steady_clock::now() - startTime;
+	mStats.testTime += time.count();
+}
+
+const OcclusionStats& OcclusionCuller::getStats() const
+{
+	return mStats;
+}
+
+float OcclusionCuller::getCulledPercentage() const
+{
+	if (mStats.testedCount == 0)
+		return 0.0f;
+
+	return 100.0f * (float)mStats.culledCount / (float)mStats.testedCount;
+}
+
+void OcclusionCuller::addClipTriangle(const core::vector4d& a, const core::vector4d& b, const core::vector4d& c)
+{
+	const core::vector4d* vertices[3] = {&a, &b, &c};
+
+	unsigned int insideCount = 0;
+	for (unsigned int i = 0; i < 3; ++i)
+	{
+		if (vertices[i]->w > OCCLUSION_NEAR_W)
+			++insideCount;
+	}
+
+	if (insideCount == 0)
+		return;
+
+	// Sutherland-Hodgman against the near plane, the triangle becomes a triangle or a quad
+	core::vector4d clipped[4];
+	unsigned int clippedCount = 0;
+
+	if (insideCount == 3)
+	{
+		clipped[0] = a;
+		clipped[1] = b;
+		clipped[2] = c;
+		clippedCount = 3;
+	}
+	else
+	{
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			const core::vector4d& p = *vertices[i];
+			const core::vector4d& q = *vertices[(i + 1) % 3];
+
+			bool pInside = p.w > OCCLUSION_NEAR_W;
+			bool qInside = q.w > OCCLUSION_NEAR_W;
+
+			if (pInside)
+				clipped[clippedCount++] = p;
+
+			if (pInside != qInside)
+			{
+				float t = (OCCLUSION_NEAR_W - p.w) / (q.w - p.w);
+				clipped[clippedCount++] = core::vector4d(p.x + (q.x - p.x) * t, p.y + (q.y - p.y) * t, p.z + (q.z - p.z) * t, OCCLUSION_NEAR_W);
+			}
+		}
+	}
+
+	float screen[4][3];
+	for (unsigned int i = 0; i < clippedCount; ++i)
+		projectToScreen(clipped[i], screen[i]);
+
+	for (unsigned int i = 1; i + 1 < clippedCount; ++i)
+		addScreenTriangle(screen[0], screen[i], screen[i + 1]);
+}
+
+void OcclusionCuller::addScreenTriangle(const float* a, const float* b, const float* c)
+{
+	// degenerate, or too large to be set up
+	float area = (b[0] - a[0]) * (c[1] - a[1]) - (c[0] - a[0]) * (b[1] - a[1]);
+	if (!(fabsf(area) > 0.0f && fabsf(area) <= std::numeric_limits<float>::max()))
+		return;
+
+	// pixels whose center is inside the bounds of the triangle
+	float left = ceilf(std::min(a[0], std::min(b[0], c[0])) - 0.5f);
+	float top = ceilf(std::min(a[1], std::min(b[1], c[1])) - 0.5f);
+	float right = floorf(std::max(a[0], std::max(b[0], c[0])) - 0.5f);
+	float bottom = floorf(std::max(a[1], std::max(b[1], c[1])) - 0.5f);
+
+	if (right < 0.0f || bottom < 0.0f || left >= (float)mWidth || top >= (float)mHeight || left > right || top > bottom)
+		return;
+
+	ScreenTriangle triangle;
+	triangle.minX = left > 0.0f ? (unsigned int)left : 0;
+	triangle.minY = top > 0.0f ? (unsigned int)top : 0;
+	triangle.maxX = right < (float)(mWidth - 1) ? (unsigned int)right + 1 : mWidth;
+	triangle.maxY = bottom < (float)(mHeight - 1) ? (unsigned int)bottom + 1 : mHeight;
+
+	const float* vertices[3] = {a, b, c};
+	float invArea = 1.0f / area;
+	float sign = (area > 0.0f) ? 1.0f : -1.0f;
+
+	float depthA = 0.0f;
+	float depthB = 0.0f;
+	float depthC = 0.0f;
+
+	for (unsigned int i = 0; i < 3; ++i)
+	{
+		const float* p = vertices[(i + 1) % 3];
+		const float* q = vertices[(i + 2) % 3];
+
+		// edge opposite to vertex i, equal to area at the vertex, so that its barycentric weight is edge / area
+		float edgeA = p[1] - q[1];
+		float edgeB = q[0] - p[0];
+		float edgeC = p[0] * q[1] - q[0] * p[1];
+
+		float weight = vertices[i][2] * invArea;
+		depthA += edgeA * weight;
+		depthB += edgeB * weight;
+		depthC += edgeC * weight;
+
+		// pixel (x, y) samples its center (x + 0.5, y + 0.5)
+		triangle.setup.edgeA[i] = edgeA * sign;
+		triangle.setup.edgeB[i] = edgeB * sign;
+		triangle.setup.edgeC[i] = (edgeC + 0.5f * edgeA + 0.5f * edgeB) * sign;
+	}
+
+	triangle.setup.depthA = depthA;
+	triangle.setup.depthB = depthB;
+	triangle.setup.depthC = depthC + 0.5f * depthA + 0.5f * depthB;
+
+	unsigned int index = (unsigned int)mTriangles.size();
+	mTriangles.push_back(triangle);
+
+	unsigned int tileMaxX = (triangle.maxX - 1) / OCCLUSION_TILE_SIZE;
+	unsigned int tileMaxY = (triangle.maxY - 1) / OCCLUSION_TILE_SIZE;
+	for (unsigned int y = triangle.minY / OCCLUSION_TILE_SIZE; y <= tileMaxY; ++y)
+	{
+		for (unsigned int x = triangle.minX / OCCLUSION_TILE_SIZE; x <= tileMaxX; ++x)
+			mTileBins[y * mTileCountX + x].push_back(index);
+	}
+
+	++mStats.triangleCount;
+}
+
+void OcclusionCuller::projectToScreen(const core::vector4d& clip, float* screen) const
+{
+	float invW = 1.0f / clip.w;
+
+	screen[0] = (clip.x * invW * 0.5f + 0.5f) * (float)mWidth;
+	screen[1] = (0.5f - clip.y * invW * 0.5f) * (float)mHeight;
+	screen[2] = clip.z * invW;
+}
+
+void OcclusionCuller::rasterizeTiles(unsigned int begin, unsigned int end, void* data)
+{
+	OcclusionCuller* pCuller = static_cast<OcclusionCuller*>(data);
+
+	for (unsigned int i = begin; i < end; ++i)
+		pCuller->rasterizeTile(i);
+}
+
+void OcclusionCuller::rasterizeTile(unsigned int tile)
+{
+	unsigned int tileX = tile % mTileCountX;
+	unsigned int tileY = tile / mTileCountX;
+
+	unsigned int minX = tileX * OCCLUSION_TILE_SIZE;
+	unsigned int minY = tileY * OCCLUSION_TILE_SIZE;
+	unsigned int maxX = minX + OCCLUSION_TILE_SIZE;
+	unsigned int maxY = minY + OCCLUSION_TILE_SIZE;
+
+	std::vector<float>& depth = mLevels[0].farthest;
+	for (unsigned int y = minY; y < maxY; ++y)
+		std::fill(depth.begin() + y * mWidth + minX, depth.begin() + y * mWidth + maxX, OCCLUSION_CLEAR_DEPTH);
+
+	const core::MathKernels& kernels = core::getMathKernels();
+
+	const std::vector<unsigned int>& bin = mTileBins[tile];
+	for (unsigned int i = 0; i < bin.size(); ++i)
+	{
+		const ScreenTriangle& triangle = mTriangles[bin[i]];
+
+		kernels.rasterizeDepth(triangle.setup, &depth[0], mWidth,
+			std::max(triangle.minX, minX), std::max(triangle.minY, minY), std::min(triangle.maxX, maxX), std::min(triangle.maxY, maxY));
+	}
+
+	// the levels that still fit in the tile are reduced here, the tiles do not share texels
+	for (unsigned int level = 1; level <= OCCLUSION_TILE_LEVELS && level < mLevels.size(); ++level)
+	{
+		const DepthLevel& fine = mLevels[level - 1];
+		DepthLevel& coarse = mLevels[level];
+
+		const float* fineNearest = (level == 1) ? &fine.farthest[0] : &fine.nearest[0];
+		const float* fineFarthest = &fine.farthest[0];
+
+		unsigned int size = OCCLUSION_TILE_SIZE >> level;
+		for (unsigned int y = tileY * size; y < (tileY + 1) * size; ++y)
+		{
+			for (unsigned int x = tileX * size; x < (tileX + 1) * size; ++x)
+			{
+				unsigned int i0 = 2 * y * fine.width + 2 * x;
+				unsigned int i1 = i0 + fine.width;
+
+				coarse.nearest[y * coarse.width + x] = std::min(std::min(fineNearest[i0], fineNearest[i0 + 1]), std::min(fineNearest[i1], fineNearest[i1 + 1]));
+				coarse.farthest[y * coarse.width + x] = std::max(std::max(fineFarthest[i0], fineFarthest[i0 + 1]), std::max(fineFarthest[i1], fineFarthest[i1 + 1]));
+			}
+		}
+	}
+}
+
+void OcclusionCuller::buildUpperLevels()
+{
+	for (unsigned int level = OCCLUSION_TILE_LEVELS + 1; level < mLevels.size(); ++level)
+	{
+		const DepthLevel& fine = mLevels[level - 1];
+		DepthLevel& coarse = mLevels[level];
+
+		for (unsigned int y = 0; y < coarse.height; ++y)
+		{
+			unsigned int y0 = 2 * y;
+			unsigned int y1 = std::min(y0 + 1, fine.height - 1);
+
+			for (unsigned int x = 0; x < coarse.width; ++x)
+			{
+				unsigned int x0 = 2 * x;
+				unsigned int x1 = std::min(x0 + 1, fine.width - 1);
+
+				unsigned int i00 = y0 * fine.width + x0;
+				unsigned int i01 = y0 * fine.width + x1;
+				unsigned int i10 = y1 * fine.width + x0;
+				unsigned int i11 = y1 * fine.width + x1;
+
+				coarse.nearest[y * coarse.width + x] = std::min(std::min(fine.nearest[i00], fine.nearest[i01]), std::min(fine.nearest[i10], fine.nearest[i11]));
+				coarse.farthest[y * coarse.width + x] = std::max(std::max(fine.farthest[i00], fine.farthest[i01]), std::max(fine.farthest[i10], fine.farthest[i11]));
+			}
+		}
+	}
+}
+
+void OcclusionCuller::testModels(unsigned int begin, unsigned int end, void* data)
+{
+	OcclusionTest* pTest = static_cast<OcclusionTest*>(data);
+
+	for (unsigned int i = begin; i < end; ++i)
+	{
+		Model* pModel = pTest->models[i];
+
+		bool visible = (pModel == nullptr || pModel->isOccluder() || pTest->culler->isVisible(pModel->getBoundingBox()));
+		pTest->visible[i] = visible ? 1 : 0;
+	}
+}
+
+bool OcclusionCuller::isRectVisible(unsigned int level, unsigned int minX, unsigned int minY, unsigned int maxX, unsigned int maxY, float depth) const
+{
+	const DepthLevel& texels = mLevels[level];
+
+	for (unsigned int y = minY >> level; y <= (maxY >> level); ++y)
+	{
+		for (unsigned int x = minX >> level; x <= (maxX >> level); ++x)
+		{
+			unsigned int i = y * texels.width + x;
+
+			// every occluder depth in the texel is in front of the box
+			if (depth >= texels.farthest[i])
+				continue;
+
+			if (level == 0 || depth < texels.nearest[i])
+				return true;
+
+			// the texel is partly in front of the box, its pixels inside the rectangle decide
+			unsigned int childMinX = std::max(minX, x << level);
+			unsigned int childMinY = std::max(minY, y << level);
+			unsigned int childMaxX = std::min(maxX, ((x + 1) << level) - 1);
+			unsigned int childMaxY = std::min(maxY, ((y + 1) << level) - 1);
+
+			if (isRectVisible(level - 1, childMinX, childMinY, childMaxX, childMaxY, depth))
+				return true;
+		}
+	}
+
+	return false;
+}
+
+} // end namespace render
\ No newline at end of file
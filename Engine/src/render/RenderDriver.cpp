@@ -26,12 +26,166 @@ THE SOFTWARE.
 
 #include <render/RenderDriver.h>
 #include <render/Shader.h>
+#include <render/RenderQueue.h>
 
 namespace render
 {
 
-RenderDriver::RenderDriver(const std::string& name): core::SystemDriver(name) {}
+RenderDriver::RenderDriver(const std::string& name): core::SystemDriver(name)
+{
+	// The drivers set it up again with the offset alignment of their api
+	mUniformBuffer.initialize(64 * 1024);
+
+	mPackedCommands = nullptr;
+
+	for (unsigned int i = 0; i < SHADER_PARAMETER_FREQUENCY_COUNT; ++i)
+		mParameterBlockOffsets[i] = UNIFORM_RING_BUFFER_INVALID_OFFSET;
+}
 
 RenderDriver::~RenderDriver() {}
 
+RenderStateCache& RenderDriver::getStateCache()
+{
+	return mStateCache;
+}
+
+UniformRingBuffer& RenderDriver::getUniformBuffer()
+{
+	return mUniformBuffer;
+}
+
+void RenderDriver::renderCommands(RenderStateData& renderStateData, const RenderQueue& renderQueue)
+{
+	const RenderCommand* pCommands = renderQueue.getCommands();
+	const RenderBatch* pBatches = renderQueue.getBatches();
+	unsigned int count = renderQueue.getBatchCount();
+
+	packParameterBlocks(renderStateData, renderQueue);
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		const RenderBatch& batch = pBatches[i];
+
+		if (batch.instanced)
+		{
+			renderInstances(renderStateData, pCommands + batch.firstCommand, batch.commandCount, renderQueue.getInstanceData() + batch.instanceDataOffset);
+			continue;
+		}
+
+		for (unsigned int j = batch.firstCommand; j < batch.firstCommand + batch.commandCount; ++j)
+		{
+			setCurrentCommand(renderStateData, pCommands + j);
+
+			render(renderStateData);
+		}
+	}
+
+	// The queue is filled again for the next viewport
+	mPackedCommands = nullptr;
+	mCommandBlockOffsets.clear();
+}
+
+void RenderDriver::renderInstances(RenderStateData& renderStateData, const RenderCommand* commands, unsigned int count, const float* instanceData)
+{
+	if (commands == nullptr)
+		return;
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		setCurrentCommand(renderStateData, commands + i);
+
+		render(renderStateData);
+	}
+}
+
+void RenderDriver::packParameterBlocks(RenderStateData& renderStateData, const RenderQueue& renderQueue)
+{
+	const RenderCommand* pCommands = renderQueue.getCommands();
+	const RenderBatch* pBatches = renderQueue.getBatches();
+	unsigned int count = renderQueue.getBatchCount();
+
+	mPackedCommands = pCommands;
+	mCommandBlockOffsets.assign(renderQueue.getCommandCount() * SHADER_PARAMETER_FREQUENCY_COUNT, UNIFORM_RING_BUFFER_INVALID_OFFSET);
+
+	// The frame and camera values don't change while the queue is rendered, the object block of every command and
+	// the other ones at every material switch are the most that can be written
+	unsigned int size = 0;
+	Material* pLastMaterial = nullptr;
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		Material* pMaterial = pCommands[pBatches[i].firstCommand].material;
+		if (pMaterial == nullptr || !pMaterial->hasParameterBlocks())
+			continue;
+
+		size += pBatches[i].commandCount * mUniformBuffer.getAlignedSize(pMaterial->getParameterBlockSize(SHADER_PARAMETER_FREQUENCY_OBJECT));
+
+		if (pMaterial != pLastMaterial)
+		{
+			size += mUniformBuffer.getAlignedSize(pMaterial->getParameterBlockSize(SHADER_PARAMETER_FREQUENCY_FRAME));
+			size += mUniformBuffer.getAlignedSize(pMaterial->getParameterBlockSize(SHADER_PARAMETER_FREQUENCY_CAMERA));
+
+			pLastMaterial = pMaterial;
+		}
+	}
+
+	if (size == 0)
+		return;
+
+	// The blocks the materials had written before are lost with the old storage
+	if (mUniformBuffer.reserve(size))
+		renderStateData.invalidate(SHADER_PARAMETER_FREQUENCY_FRAME);
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		const RenderBatch& batch = pBatches[i];
+
+		Material* pMaterial = pCommands[batch.firstCommand].material;
+		if (pMaterial == nullptr || !pMaterial->hasParameterBlocks())
+			continue;
+
+		renderStateData.setCurrentMaterial(pMaterial);
+
+		// Every instance has its own object block, the drivers drawing a batch one command at a time read them all
+		for (unsigned int j = batch.firstCommand; j < batch.firstCommand + batch.commandCount; ++j)
+		{
+			renderStateData.setCurrentModel(pCommands[j].model);
+
+			unsigned int* pOffsets = &mCommandBlockOffsets[j * SHADER_PARAMETER_FREQUENCY_COUNT];
+			for (unsigned int frequency = 0; frequency < SHADER_PARAMETER_FREQUENCY_COUNT; ++frequency)
+			{
+				unsigned int version = renderStateData.getVersion((ShaderParameterFrequency)frequency);
+				if (pMaterial->getParameterVersion((ShaderParameterFrequency)frequency) != version)
+				{
+					pMaterial->setParameterBlockOffset((ShaderParameterFrequency)frequency, mUniformBuffer.writeParameterBlock(pMaterial, (ShaderParameterFrequency)frequency, renderStateData));
+					pMaterial->setParameterVersion((ShaderParameterFrequency)frequency, version);
+				}
+
+				pOffsets[frequency] = pMaterial->getParameterBlockOffset((ShaderParameterFrequency)frequency);
+			}
+		}
+	}
+
+	uploadUniformBuffer();
+}
+
+void RenderDriver::uploadUniformBuffer()
+{
+	unsigned int offset = 0;
+	unsigned int size = 0;
+	while (mUniformBuffer.takePendingRange(offset, size)) {}
+}
+
+void RenderDriver::setCurrentCommand(RenderStateData& renderStateData, const RenderCommand* command)
+{
+	renderStateData.setCurrentMaterial(command->material);
+	renderStateData.setCurrentModel(command->model);
+
+	std::size_t index = mCommandBlockOffsets.size();
+	if (mPackedCommands != nullptr && command >= mPackedCommands)
+		index = (std::size_t)(command - mPackedCommands) * SHADER_PARAMETER_FREQUENCY_COUNT;
+
+	for (unsigned int i = 0; i < SHADER_PARAMETER_FREQUENCY_COUNT; ++i)
+		mParameterBlockOffsets[i] = (index < mCommandBlockOffsets.size()) ? mCommandBlockOffsets[index + i] : UNIFORM_RING_BUFFER_INVALID_OFFSET;
+}
+
 } // end namespace render
@@ -26,6 +26,7 @@ THE SOFTWARE.
 
 #include <core/Log.h>
 #include <core/Utils.h>
+#include <core/Profiler.h>
 #include <core/LogDefines.h>
 #include <render/RenderManager.h>
 #include <render/RenderDriver.h>
@@ -192,7 +193,7 @@ void RenderManager::addLight(Light *light)
 	if (light == nullptr)
 		return;
 
-	mLights[light->getID()] = light;
+	light->setSystemHandle(mLights.insert(light));
 }
 
 void RenderManager::removeLight(Light *light)
@@ -200,19 +201,24 @@ void RenderManager::removeLight(Light *light)
 	if (light == nullptr)
 		return;
 
-	removeLight(light->getID());
+	removeLight(light->getSystemHandle());
 }
 
-void RenderManager::removeLight(const unsigned int& id)
+void RenderManager::removeLight(const core::Handle& handle)
 {
-	std::map<unsigned int, Light*>::iterator i = mLights.find(id);
-	if (i != mLights.end())
-		mLights.erase(i);
+	mLights.remove(handle);
 }
 
 void RenderManager::removeAllLights()
 {
 	mLights.clear();
+
+	mLightCuller.clear();
+}
+
+LightCuller& RenderManager::getLightCuller()
+{
+	return mLightCuller;
 }
 
 void RenderManager::addCamera(Camera* camera)
@@ -220,7 +226,7 @@ void RenderManager::addCamera(Camera* camera)
 	if (camera == nullptr)
 		return;
 
-	mCameras[camera->getID()] = camera;
+	camera->setSystemHandle(mCameras.insert(camera));
 }
 
 void RenderManager::removeCamera(Camera* camera)
@@ -228,18 +234,22 @@ void RenderManager::removeCamera(Camera* camera)
 	if (camera == nullptr)
 		return;
 
-	removeCamera(camera->getID());
+	removeCamera(camera->getSystemHandle());
 }
 
-void RenderManager::removeCamera(const unsigned int& id)
+void RenderManager::removeCamera(const core::Handle& handle)
 {
-	std::map<unsigned int, Camera*>::iterator i = mCameras.find(id);
-	if (i != mCameras.end())
-		mCameras.erase(i);
+	Camera** ppCamera = mCameras.get(handle);
+	if (ppCamera != nullptr)
+		mLodSelector.removeView(*ppCamera);
+
+	mCameras.remove(handle);
 }
 
 void RenderManager::removeAllCameras()
 {
+	mLodSelector.removeAllViews();
+
 	mCameras.clear();
 }
 
@@ -248,7 +258,13 @@ void RenderManager::addModel(Model* model)
 	if (model == nullptr)
 		return;
 
-	mModels[model->getID()] = model;
+	core::Handle handle = mModels.insert(model);
+	model->setSystemHandle(handle);
+
+	if (mModelLeaves.size() <= handle.index)
+		mModelLeaves.resize(handle.index + 1, VisibilityTree::NULL_NODE);
+
+	mModelLeaves[handle.index] = mVisibilityTree.insert(model, model->getBoundingBox());
 }
 
 void RenderManager::removeModel(Model* model)
@@ -256,19 +272,71 @@ void RenderManager::removeModel(Model* model)
 	if (model == nullptr)
 		return;
 
-	removeModel(model->getID());
+	removeModel(model->getSystemHandle());
 }
 
-void RenderManager::removeModel(const unsigned int& id)
+void RenderManager::removeModel(const core::Handle& handle)
 {
-	std::map<unsigned int, Model*>::iterator i = mModels.find(id);
-	if (i != mModels.end())
-		mModels.erase(i);
+	if (mModels.get(handle) == nullptr)
+		return;
+
+	mVisibilityTree.remove(mModelLeaves[handle.index]);
+	mModelLeaves[handle.index] = VisibilityTree::NULL_NODE;
+
+	mModels.remove(handle);
 }
 
 void RenderManager::removeAllModels()
 {
 	mModels.clear();
+
+	mVisibilityTree.clear();
+	mModelLeaves.clear();
+}
+
+void RenderManager::updateModel(Model* model)
+{
+	if (model == nullptr)
+		return;
+
+	const core::Handle& handle = model->getSystemHandle();
+	if (mModels.get(handle) == nullptr)
+		return;
+
+	mVisibilityTree.move(mModelLeaves[handle.index], model->getBoundingBox());
+}
+
+OcclusionCuller& RenderManager::getOcclusionCuller()
+{
+	return mOcclusionCuller;
+}
+
+unsigned int RenderManager::buildStaticBatches()
+{
+	// the chunks are added to the models while they are built
+	std::vector<Model*> models = mModels.getValues();
+
+	return mStaticBatcher.build(models);
+}
+
+void RenderManager::clearStaticBatches()
+{
+	mStaticBatcher.clear();
+}
+
+StaticBatcher& RenderManager::getStaticBatcher()
+{
+	return mStaticBatcher;
+}
+
+LodSelector& RenderManager::getLodSelector()
+{
+	return mLodSelector;
+}
+
+RenderStateData& RenderManager::getRenderStateData()
+{
+	return mRenderStateData;
 }
 
 void RenderManager::addUpdatedViewport(Viewport* viewport)
@@ -395,7 +463,7 @@ void RenderManager::removeVertexBuffer(VertexBuffer* buf)
 
 			if (mRenderDriver != nullptr)
 			{
-				mRenderDriver->removeVertexBuffer((*i));
+				mRenderDriver->removeVertexBuffer(buf);
 			}
 			return;
 		}
@@ -441,7 +509,7 @@ void RenderManager::removeIndexBuffer(IndexBuffer* buf)
 
 			if (mRenderDriver != nullptr)
 			{
-				mRenderDriver->removeIndexBuffer((*i));
+				mRenderDriver->removeIndexBuffer(buf);
 			}
 			return;
 		}
@@ -466,11 +534,14 @@ void RenderManager::initializeImpl()
 	if (resource::ResourceManager::getInstance() != nullptr)
 		mDefaultMaterial = static_cast<Material*>(resource::ResourceManager::getInstance()->createResource(resource::RESOURCE_TYPE_RENDER_MATERIAL, "materials/DefaultMaterial.xml"));
 
-	mModelMaterialPairs.reserve(1024);
+	mRenderQueue.reserve(1024);
 }
 
 void RenderManager::uninitializeImpl()
 {
+	// Give the merged models back before their buffers go
+	clearStaticBatches();
+
 	// Remove all Lights
 	removeAllLights();
 
@@ -492,8 +563,8 @@ void RenderManager::uninitializeImpl()
 	//! Removes all Index Buffers.
 	removeAllIndexBuffers();
 
-	// Remove ModelMaterialPairs
-	mModelMaterialPairs.clear();
+	// Remove the queued draws
+	mRenderQueue.clear();
 
 	mMainWindow = nullptr;
 	mFrustum = nullptr;
@@ -513,6 +584,20 @@ void RenderManager::updateImpl(float elapsedTime)
 {	
 	fireFrameStarted();
 
+	// State change counters are kept per frame
+	if (mRenderDriver != nullptr)
+	{
+		mRenderDriver->getStateCache().resetCounters();
+
+		// The uniform blocks written frames ago are no longer read
+		mRenderDriver->getUniformBuffer().beginFrame();
+	}
+
+	// The lights may have moved since the last frame
+	mRenderStateData.beginFrame();
+
+	mLodSelector.resetStats();
+
 	// Update all render elements
 
 	// Update RenderWindows
@@ -523,7 +608,10 @@ void RenderManager::updateImpl(float elapsedTime)
 
 		if(window != nullptr && window->isActive())
 		{
-			window->update(elapsedTime);
+			{
+				PROFILE_SCOPE("RenderWindow::update");
+				window->update(elapsedTime);
+			}
 
 			//Go through the viewports of this RenderTarget
 			std::list<Viewport*>::const_iterator k;
@@ -656,6 +744,8 @@ void RenderManager::render(Camera* camera, Viewport* viewport)
 	if (viewport == nullptr)
 		return;
 
+	PROFILE_SCOPE("RenderManager::render");
+
 	setCurrentViewport(viewport);
 
 	mRenderStateData.setCurrentViewport(viewport);
@@ -674,11 +764,20 @@ void RenderManager::render(Camera* camera, Viewport* viewport)
 
 	mRenderStateData.setCurrentCamera(camera);
 
-	std::map<unsigned int, Light*>::const_iterator i = mLights.begin();
-	if (i != mLights.end())
+	if (!mLights.empty())
 	{
-		mRenderStateData.setCurrentLight(i->second);
-	}	
+		mRenderStateData.setCurrentLight(mLights[0]);
+	}
+
+	if (mLightCuller.isEnabled())
+	{
+		mLightCuller.assignLights(camera, mLights.getValues());
+		mRenderStateData.setLightCuller(&mLightCuller);
+	}
+	else
+	{
+		mRenderStateData.setLightCuller(nullptr);
+	}
 
 	renderVisibleModels();
 	
@@ -688,6 +787,7 @@ void RenderManager::render(Camera* camera, Viewport* viewport)
 
 	// Notify viewport of rendered faces
 	viewport->notifyRenderedFaces(getFaceCount());
+	viewport->notifyRenderedModels(mRenderQueue.getCommandCount(), mRenderQueue.getBatchCount());
 
 #ifdef _DEBUG
 	//std::cout<<"Vertex Count: "<<getVertexCount()<<std::endl;
@@ -728,6 +828,7 @@ void RenderManager::setCurrentViewport(Viewport* viewport)
 
 		if (mRenderDriver != nullptr)
 		{
+			PROFILE_SCOPE("RenderDriver::setViewport");
 			mRenderDriver->setViewport(viewport);
 		}
 	}
@@ -741,6 +842,8 @@ void RenderManager::beginFrame(Viewport* viewport)
 		return;
 	}
 	
+	PROFILE_SCOPE("RenderDriver::beginFrame");
+
 	// Clear the viewport if required
 	mRenderDriver->beginFrame(viewport);
 }
@@ -750,69 +853,119 @@ void RenderManager::findVisibleModels(Camera* camera)
 	if (camera == nullptr)
 		return;
 
-	mModelMaterialPairs.clear();
+	PROFILE_SCOPE("RenderManager::findVisibleModels");
+
+	mRenderQueue.clear();
 
 	mFrustum = camera->getFrustum();
 	if (mFrustum == nullptr)
 		return;
 
-	// Go through all the models
-	std::map<unsigned int, Model*>::const_iterator i;
-	for (i = mModels.begin(); i != mModels.end(); ++i)
+	const core::matrix4& viewMatrix = camera->getViewMatrix();
+	float nearDistance = camera->getNearClipDistance();
+	float depthRange = camera->getFarClipDistance() - nearDistance;
+
+	// refit the bounds the models moved since the last frame
+	mVisibilityTree.update();
+
+	mVisibleModels.clear();
+	mVisibilityTree.findVisibleModels(*mFrustum, mVisibleModels);
+
+	cullOccludedModels(camera);
+
+	mLodSelector.beginView(camera, (unsigned int)mLastViewportHeight);
+
+	// Go through the models in the frustum
+	for (unsigned int i = 0; i < mVisibleModels.size(); ++i)
 	{
-		Model* pModel = i->second;
-		if (pModel != nullptr)
+		Model* pModel = mVisibleModels[i];
+		if (pModel != nullptr && pModel->getGameObject() != nullptr && pModel->getGameObject()->getTransform() != nullptr)
 		{
-			if (mFrustum->isVisible(pModel->getBoundingSphere()) && mFrustum->isVisible(pModel->getBoundingBox()))
-			{
-				Material* pMaterial = pModel->getMaterial();
-
-				ModelMaterialPair newPair;
-				newPair.model = pModel;
-				newPair.materialID = pMaterial != nullptr ? pMaterial->getID() : mDefaultMaterial->getID();
-				mModelMaterialPairs.push_back(newPair);
-			}
+			Material* pMaterial = pModel->getMaterial() != nullptr ? pModel->getMaterial() : mDefaultMaterial;
+			if (pMaterial == nullptr)
+				continue;
+
+			// View space depth of the bounding sphere center, the camera looks down -z
+			const core::vector3d& center = pModel->getBoundingSphere().Center;
+			float distance = -(viewMatrix[8] * center.x + viewMatrix[9] * center.y + viewMatrix[10] * center.z + viewMatrix[11]);
+
+			float depth = 0.0f;
+			if (depthRange > 0.0f)
+				depth = (distance - nearDistance) / depthRange;
+			else if (distance > nearDistance)
+				depth = 1.0f - nearDistance / distance;// infinite far plane
+
+			// The models too small on screen are dropped, the others get the detail level their size needs
+			if (!mLodSelector.selectLod(pModel, distance))
+				continue;
+
+			// The ids are remapped to the dense indices of the view, so they fit the key fields.
+			// A program is told apart by the ids of its shaders, 21 bits each
+			unsigned long long programID = 0;
+			if (pMaterial->getVertexShader() != nullptr) programID |= (unsigned long long)pMaterial->getVertexShader()->getID() << 42;
+			if (pMaterial->getFragmentShader() != nullptr) programID |= (unsigned long long)pMaterial->getFragmentShader()->getID() << 21;
+			if (pMaterial->getGeometryShader() != nullptr) programID |= (unsigned long long)pMaterial->getGeometryShader()->getID();
+
+			unsigned long long meshID = pModel->getMeshData() != nullptr ? (unsigned long long)pModel->getMeshData()->getID() * MESH_LOD_MAX_LEVELS + pModel->getLod() + 1 : 0;
+
+			unsigned int programIndex = mRenderQueue.getStateIndex(RENDER_QUEUE_STATE_PROGRAM, programID);
+			unsigned int materialIndex = mRenderQueue.getStateIndex(RENDER_QUEUE_STATE_MATERIAL, pMaterial->getID());
+			unsigned int meshIndex = mRenderQueue.getStateIndex(RENDER_QUEUE_STATE_MESH, meshID);
+
+			unsigned long long sortKey = RenderQueue::buildSortKey(0, pMaterial->isTransparent(), programIndex, materialIndex, meshIndex, depth);
+			mRenderQueue.addCommand(sortKey, pModel, pMaterial);
 		}
 	}
 
-	std::sort(mModelMaterialPairs.begin(), mModelMaterialPairs.end());
+	mRenderQueue.sort();
+	mRenderQueue.buildBatches();
 }
 
-void RenderManager::renderVisibleModels()
+void RenderManager::cullOccludedModels(Camera* camera)
 {
-	// Go through all the model material pairs	
-	for (unsigned int i = 0; i < mModelMaterialPairs.size(); ++i)
+	if (camera == nullptr || !mOcclusionCuller.isEnabled())
+		return;
+
+	PROFILE_SCOPE("RenderManager::cullOccludedModels");
+
+	mOcclusionCuller.beginFrame(camera->getProjectionMatrix() * camera->getViewMatrix());
+
+	// only the occluders in the frustum can hide anything
+	for (unsigned int i = 0; i < mVisibleModels.size(); ++i)
 	{
-		renderSingleModel(mModelMaterialPairs[i].model);
+		Model* pModel = mVisibleModels[i];
+		if (pModel == nullptr || !pModel->isOccluder() || pModel->getMeshData() == nullptr)
+			continue;
+
+		const std::vector<core::vector4d>& positions = pModel->getMeshData()->getOccluderPositions();
+		const std::vector<unsigned int>& indices = pModel->getMeshData()->getOccluderIndices();
+		if (positions.empty() || indices.empty())
+			continue;
+
+		mOcclusionCuller.addOccluder(pModel->getWorldMatrix(), &positions[0], (unsigned int)positions.size(), &indices[0], (unsigned int)indices.size());
 	}
+
+	mOcclusionCuller.rasterizeOccluders();
+	mOcclusionCuller.cullModels(mVisibleModels);
 }
 
-void RenderManager::renderSingleModel(Model* model)
+void RenderManager::renderVisibleModels()
 {
-	if (model == nullptr)
-		return;
+	const RenderCommand* pCommands = mRenderQueue.getCommands();
+	unsigned int count = mRenderQueue.getCommandCount();
 
-	if (model->getGameObject() != nullptr)
+	for (unsigned int i = 0; i < count; ++i)
 	{
-		game::Transform* pTransform = static_cast<game::Transform*>(model->getGameObject()->getComponent(game::COMPONENT_TYPE_TRANSFORM));
-		if (pTransform != nullptr)
-		{
-			if (model->getMaterial() != nullptr)
-				mRenderStateData.setCurrentMaterial(model->getMaterial());
-			else
-				mRenderStateData.setCurrentMaterial(mDefaultMaterial);
-
-			mRenderStateData.setCurrentModel(model);
-
-			addGeometryCount(model);
-
-			mRenderDriver->render(mRenderStateData);
-		}
+		addGeometryCount(pCommands[i].model);
 	}
+
+	PROFILE_SCOPE("RenderDriver::renderCommands");
+	mRenderDriver->renderCommands(mRenderStateData, mRenderQueue);
 }
 
 void RenderManager::endFrame()
 {
+	PROFILE_SCOPE("RenderDriver::endFrame");
 	mRenderDriver->endFrame();
 }
 
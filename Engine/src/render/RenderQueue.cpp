@@ -0,0 +1,302 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <render/RenderQueue.h>
+#include <render/Model.h>
+#include <render/Material.h>
+
+#include <cassert>
+#include <cstring>
+
+namespace render
+{
+
+static const unsigned int RADIX_BITS = 8;
+static const unsigned int RADIX_SIZE = 1 << RADIX_BITS;
+static const unsigned int RADIX_PASSES = 64 / RADIX_BITS;
+
+static const unsigned int LAYER_BITS = 4;
+static const unsigned int PROGRAM_BITS = 11;
+static const unsigned int MATERIAL_BITS = 16;
+static const unsigned int MESH_BITS = 16;
+static const unsigned int DEPTH_BITS = 16;
+
+static const unsigned int INVALID_STATE_INDEX = 0xFFFFFFFF;
+
+RenderCommand::RenderCommand()
+{
+	sortKey = 0;
+	model = nullptr;
+	material = nullptr;
+}
+
+RenderBatch::RenderBatch()
+{
+	firstCommand = 0;
+	commandCount = 0;
+	instanceDataOffset = 0;
+	instanced = false;
+}
+
+RenderQueue::RenderQueue()
+{
+	for (unsigned int i = 0; i < RENDER_QUEUE_STATE_COUNT; ++i)
+	{
+		mLastStateIds[i] = 0;
+		mLastStateIndices[i] = INVALID_STATE_INDEX;
+	}
+}
+
+RenderQueue::~RenderQueue()
+{
+	mCommands.clear();
+	mSortBuffer.clear();
+	mBatches.clear();
+	mInstanceData.clear();
+}
+
+void RenderQueue::clear()
+{
+	mCommands.clear();
+	mBatches.clear();
+	mInstanceData.clear();
+
+	for (unsigned int i = 0; i < RENDER_QUEUE_STATE_COUNT; ++i)
+	{
+		mStateIndices[i].clear();
+		mLastStateIndices[i] = INVALID_STATE_INDEX;
+	}
+}
+
+void RenderQueue::reserve(unsigned int count)
+{
+	mCommands.reserve(count);
+	mSortBuffer.reserve(count);
+}
+
+void RenderQueue::addCommand(unsigned long long sortKey, Model* model, Material* material)
+{
+	RenderCommand command;
+	command.sortKey = sortKey;
+	command.model = model;
+	command.material = material;
+
+	mCommands.push_back(command);
+}
+
+void RenderQueue::sort()
+{
+	unsigned int count = (unsigned int)mCommands.size();
+	if (count < 2)
+		return;
+
+	// Histograms for all the passes are built in one go over the keys
+	unsigned int histograms[RADIX_PASSES][RADIX_SIZE];
+	memset(histograms, 0, sizeof(histograms));
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		unsigned long long key = mCommands[i].sortKey;
+		for (unsigned int pass = 0; pass < RADIX_PASSES; ++pass)
+		{
+			histograms[pass][(key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)]++;
+		}
+	}
+
+	mSortBuffer.resize(count);
+
+	RenderCommand* pSource = &mCommands[0];
+	RenderCommand* pDestination = &mSortBuffer[0];
+
+	for (unsigned int pass = 0; pass < RADIX_PASSES; ++pass)
+	{
+		unsigned int* histogram = histograms[pass];
+		unsigned int shift = pass * RADIX_BITS;
+
+		// A pass where every key has the same digit would only copy the commands
+		if (histogram[(pSource[0].sortKey >> shift) & (RADIX_SIZE - 1)] == count)
+			continue;
+
+		unsigned int offset = 0;
+		for (unsigned int i = 0; i < RADIX_SIZE; ++i)
+		{
+			unsigned int digitCount = histogram[i];
+			histogram[i] = offset;
+			offset += digitCount;
+		}
+
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			unsigned int digit = (unsigned int)((pSource[i].sortKey >> shift) & (RADIX_SIZE - 1));
+			pDestination[histogram[digit]++] = pSource[i];
+		}
+
+		RenderCommand* pTemp = pSource;
+		pSource = pDestination;
+		pDestination = pTemp;
+	}
+
+	if (pSource != &mCommands[0])
+		mCommands.swap(mSortBuffer);
+}
+
+void RenderQueue::buildBatches()
+{
+	mBatches.clear();
+	mInstanceData.clear();
+
+	unsigned int count = (unsigned int)mCommands.size();
+	unsigned int i = 0;
+	while (i < count)
+	{
+		const RenderCommand& command = mCommands[i];
+
+		RenderBatch batch;
+		batch.firstCommand = i;
+		batch.commandCount = 1;
+
+		// The sort key keeps the commands of a material, mesh and detail level together, the run ends at the first other one
+		if (command.material != nullptr && command.material->isInstanced() && command.model != nullptr && command.model->getMeshData() != nullptr)
+		{
+			while (i + batch.commandCount < count)
+			{
+				const RenderCommand& next = mCommands[i + batch.commandCount];
+				if (next.material != command.material || next.model == nullptr || next.model->getMeshData() != command.model->getMeshData() ||
+					next.model->getIndexBuffer() != command.model->getIndexBuffer())
+					break;
+
+				++batch.commandCount;
+			}
+
+			batch.instanced = true;
+			batch.instanceDataOffset = (unsigned int)mInstanceData.size();
+
+			mInstanceData.resize(mInstanceData.size() + batch.commandCount * RENDER_INSTANCE_DATA_SIZE);
+
+			float* pData = &mInstanceData[batch.instanceDataOffset];
+			for (unsigned int j = 0; j < batch.commandCount; ++j)
+			{
+				const float* m = mCommands[i + j].model->getWorldMatrix().get();
+
+				// transposed, the matrices are row major
+				for (unsigned int column = 0; column < 4; ++column)
+				{
+					for (unsigned int row = 0; row < 4; ++row)
+						pData[column * 4 + row] = m[row * 4 + column];
+				}
+
+				pData += RENDER_INSTANCE_DATA_SIZE;
+			}
+		}
+
+		mBatches.push_back(batch);
+		i += batch.commandCount;
+	}
+}
+
+const RenderCommand* RenderQueue::getCommands() const
+{
+	return mCommands.empty() ? nullptr : &mCommands[0];
+}
+
+unsigned int RenderQueue::getCommandCount() const
+{
+	return (unsigned int)mCommands.size();
+}
+
+const RenderBatch* RenderQueue::getBatches() const
+{
+	return mBatches.empty() ? nullptr : &mBatches[0];
+}
+
+unsigned int RenderQueue::getBatchCount() const
+{
+	return (unsigned int)mBatches.size();
+}
+
+const float* RenderQueue::getInstanceData() const
+{
+	return mInstanceData.empty() ? nullptr : &mInstanceData[0];
+}
+
+unsigned int RenderQueue::getStateIndex(RenderQueueState state, unsigned long long id)
+{
+	if (mLastStateIndices[state] != INVALID_STATE_INDEX && mLastStateIds[state] == id)
+		return mLastStateIndices[state];
+
+	hashmap<unsigned long long, unsigned int>& stateIndices = mStateIndices[state];
+
+	unsigned int index = 0;
+	hashmap<unsigned long long, unsigned int>::const_iterator i = stateIndices.find(id);
+	if (i != stateIndices.end())
+	{
+		index = i->second;
+	}
+	else
+	{
+		index = (unsigned int)stateIndices.size();
+		stateIndices[id] = index;
+	}
+
+	mLastStateIds[state] = id;
+	mLastStateIndices[state] = index;
+
+	return index;
+}
+
+unsigned long long RenderQueue::buildSortKey(unsigned int layer, bool transparent, unsigned int program, unsigned int material, unsigned int mesh, float depth)
+{
+	// Larger values would take the key of other states
+	assert(program < (1 << PROGRAM_BITS) && material < (1 << MATERIAL_BITS) && mesh < (1 << MESH_BITS));
+
+	if (depth < 0.0f) depth = 0.0f;
+	if (depth > 1.0f) depth = 1.0f;
+
+	unsigned long long quantizedDepth = (unsigned long long)(depth * (float)((1 << DEPTH_BITS) - 1));
+
+	unsigned long long key = (unsigned long long)(layer & ((1 << LAYER_BITS) - 1));
+	key = (key << 1) | (transparent ? 1 : 0);
+
+	if (transparent)
+	{
+		// Far draws first
+		key = (key << DEPTH_BITS) | (((1 << DEPTH_BITS) - 1) - quantizedDepth);
+		key = (key << PROGRAM_BITS) | (program & ((1 << PROGRAM_BITS) - 1));
+		key = (key << MATERIAL_BITS) | (material & ((1 << MATERIAL_BITS) - 1));
+		key = (key << MESH_BITS) | (mesh & ((1 << MESH_BITS) - 1));
+	}
+	else
+	{
+		key = (key << PROGRAM_BITS) | (program & ((1 << PROGRAM_BITS) - 1));
+		key = (key << MATERIAL_BITS) | (material & ((1 << MATERIAL_BITS) - 1));
+		key = (key << MESH_BITS) | (mesh & ((1 << MESH_BITS) - 1));
+		key = (key << DEPTH_BITS) | quantizedDepth;
+	}
+
+	return key;
+}
+
+} // end namespace render
\ No newline at end of file
@@ -0,0 +1,341 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <render/RenderStateCache.h>
+
+#include <cstring>
+
+namespace render
+{
+
+static unsigned long long getUniformKey(unsigned int program, unsigned int location)
+{
+	return ((unsigned long long)program << 32) | (unsigned long long)location;
+}
+
+RenderStateCache::RenderStateCache()
+{
+	reset();
+	resetCounters();
+}
+
+RenderStateCache::~RenderStateCache()
+{
+	mUniforms.clear();
+	mUniformData.clear();
+}
+
+void RenderStateCache::reset()
+{
+	mProgram = RENDER_STATE_UNKNOWN;
+
+	mActiveTextureUnit = RENDER_STATE_UNKNOWN;
+	for (unsigned int i = 0; i < RENDER_STATE_MAX_TEXTURE_UNITS; ++i)
+	{
+		mTextureTargets[i] = RENDER_STATE_UNKNOWN;
+		mTextures[i] = RENDER_STATE_UNKNOWN;
+	}
+
+	mVertexBuffer = RENDER_STATE_UNKNOWN;
+	mIndexBuffer = RENDER_STATE_UNKNOWN;
+
+	for (unsigned int i = 0; i < RENDER_STATE_MAX_VERTEX_ATTRIBUTES; ++i)
+	{
+		mVertexAttributeEnabled[i] = RENDER_STATE_UNKNOWN;
+
+		mVertexAttributeFormats[i].buffer = RENDER_STATE_UNKNOWN;
+		mVertexAttributeFormats[i].size = 0;
+		mVertexAttributeFormats[i].type = 0;
+		mVertexAttributeFormats[i].stride = 0;
+		mVertexAttributeFormats[i].offset = 0;
+		mVertexAttributeFormats[i].divisor = 0;
+	}
+
+	for (unsigned int i = 0; i < RENDER_STATE_MAX_UNIFORM_BLOCKS; ++i)
+	{
+		mUniformBlocks[i].buffer = RENDER_STATE_UNKNOWN;
+		mUniformBlocks[i].offset = 0;
+		mUniformBlocks[i].size = 0;
+	}
+
+	mBlendEnabled = RENDER_STATE_UNKNOWN;
+	mDepthWriteEnabled = RENDER_STATE_UNKNOWN;
+
+	mUniforms.clear();
+	mUniformData.clear();
+}
+
+void RenderStateCache::resetCounters()
+{
+	for (unsigned int i = 0; i < RENDER_STATE_TYPE_COUNT; ++i)
+	{
+		mIssuedCounts[i] = 0;
+		mSkippedCounts[i] = 0;
+	}
+}
+
+unsigned int RenderStateCache::getIssuedCount(RenderStateType type) const
+{
+	if (type >= RENDER_STATE_TYPE_COUNT)
+		return 0;
+
+	return mIssuedCounts[type];
+}
+
+unsigned int RenderStateCache::getSkippedCount(RenderStateType type) const
+{
+	if (type >= RENDER_STATE_TYPE_COUNT)
+		return 0;
+
+	return mSkippedCounts[type];
+}
+
+unsigned int RenderStateCache::getIssuedCount() const
+{
+	unsigned int count = 0;
+	for (unsigned int i = 0; i < RENDER_STATE_TYPE_COUNT; ++i)
+		count += mIssuedCounts[i];
+
+	return count;
+}
+
+unsigned int RenderStateCache::getSkippedCount() const
+{
+	unsigned int count = 0;
+	for (unsigned int i = 0; i < RENDER_STATE_TYPE_COUNT; ++i)
+		count += mSkippedCounts[i];
+
+	return count;
+}
+
+bool RenderStateCache::setProgram(unsigned int program)
+{
+	bool changed = (mProgram != program);
+	mProgram = program;
+
+	return countChange(RENDER_STATE_TYPE_PROGRAM, changed);
+}
+
+unsigned int RenderStateCache::getProgram() const
+{
+	return mProgram;
+}
+
+void RenderStateCache::removeProgram(unsigned int program)
+{
+	if (mProgram == program)
+		mProgram = RENDER_STATE_UNKNOWN;
+
+	hashmap<unsigned long long, UniformValue>::iterator i = mUniforms.begin();
+	while (i != mUniforms.end())
+	{
+		if ((unsigned int)(i->first >> 32) == program)
+			i = mUniforms.erase(i);
+		else
+			++i;
+	}
+}
+
+bool RenderStateCache::setActiveTextureUnit(unsigned int unit)
+{
+	bool changed = (mActiveTextureUnit != unit);
+	mActiveTextureUnit = unit;
+
+	return countChange(RENDER_STATE_TYPE_TEXTURE, changed);
+}
+
+bool RenderStateCache::setTexture(unsigned int unit, unsigned int target, unsigned int texture)
+{
+	if (unit >= RENDER_STATE_MAX_TEXTURE_UNITS)
+		return countChange(RENDER_STATE_TYPE_TEXTURE, true);
+
+	bool changed = (mTextureTargets[unit] != target || mTextures[unit] != texture);
+	mTextureTargets[unit] = target;
+	mTextures[unit] = texture;
+
+	return countChange(RENDER_STATE_TYPE_TEXTURE, changed);
+}
+
+void RenderStateCache::removeTexture(unsigned int texture)
+{
+	for (unsigned int i = 0; i < RENDER_STATE_MAX_TEXTURE_UNITS; ++i)
+	{
+		if (mTextures[i] == texture)
+			mTextures[i] = RENDER_STATE_UNKNOWN;
+	}
+}
+
+bool RenderStateCache::setVertexBuffer(unsigned int buffer)
+{
+	bool changed = (mVertexBuffer != buffer);
+	mVertexBuffer = buffer;
+
+	return countChange(RENDER_STATE_TYPE_BUFFER, changed);
+}
+
+bool RenderStateCache::setIndexBuffer(unsigned int buffer)
+{
+	bool changed = (mIndexBuffer != buffer);
+	mIndexBuffer = buffer;
+
+	return countChange(RENDER_STATE_TYPE_BUFFER, changed);
+}
+
+void RenderStateCache::removeBuffer(unsigned int buffer)
+{
+	if (mVertexBuffer == buffer)
+		mVertexBuffer = RENDER_STATE_UNKNOWN;
+
+	if (mIndexBuffer == buffer)
+		mIndexBuffer = RENDER_STATE_UNKNOWN;
+
+	for (unsigned int i = 0; i < RENDER_STATE_MAX_VERTEX_ATTRIBUTES; ++i)
+	{
+		if (mVertexAttributeFormats[i].buffer == buffer)
+			mVertexAttributeFormats[i].buffer = RENDER_STATE_UNKNOWN;
+	}
+
+	for (unsigned int i = 0; i < RENDER_STATE_MAX_UNIFORM_BLOCKS; ++i)
+	{
+		if (mUniformBlocks[i].buffer == buffer)
+			mUniformBlocks[i].buffer = RENDER_STATE_UNKNOWN;
+	}
+}
+
+bool RenderStateCache::setVertexAttributeEnabled(unsigned int index, bool enabled)
+{
+	if (index >= RENDER_STATE_MAX_VERTEX_ATTRIBUTES)
+		return countChange(RENDER_STATE_TYPE_VERTEX_ATTRIBUTE, true);
+
+	unsigned int value = enabled ? 1 : 0;
+	bool changed = (mVertexAttributeEnabled[index] != value);
+	mVertexAttributeEnabled[index] = value;
+
+	return countChange(RENDER_STATE_TYPE_VERTEX_ATTRIBUTE, changed);
+}
+
+bool RenderStateCache::isVertexAttributeEnabled(unsigned int index) const
+{
+	if (index >= RENDER_STATE_MAX_VERTEX_ATTRIBUTES)
+		return false;
+
+	// An unknown state may be enabled
+	return (mVertexAttributeEnabled[index] != 0);
+}
+
+bool RenderStateCache::setVertexAttributeFormat(unsigned int index, unsigned int buffer, unsigned int size, unsigned int type, unsigned int stride, unsigned int offset, unsigned int divisor)
+{
+	if (index >= RENDER_STATE_MAX_VERTEX_ATTRIBUTES)
+		return countChange(RENDER_STATE_TYPE_VERTEX_ATTRIBUTE, true);
+
+	VertexAttributeFormat& format = mVertexAttributeFormats[index];
+	bool changed = (format.buffer != buffer || format.size != size || format.type != type || format.stride != stride || format.offset != offset || format.divisor != divisor);
+
+	format.buffer = buffer;
+	format.size = size;
+	format.type = type;
+	format.stride = stride;
+	format.offset = offset;
+	format.divisor = divisor;
+
+	return countChange(RENDER_STATE_TYPE_VERTEX_ATTRIBUTE, changed);
+}
+
+bool RenderStateCache::setUniform(unsigned int location, const void* data, unsigned int size)
+{
+	// Without a known program the value can't be attributed to it
+	if (mProgram == RENDER_STATE_UNKNOWN || data == nullptr || size == 0)
+		return countChange(RENDER_STATE_TYPE_UNIFORM, true);
+
+	unsigned long long key = getUniformKey(mProgram, location);
+
+	hashmap<unsigned long long, UniformValue>::iterator i = mUniforms.find(key);
+	if (i != mUniforms.end() && i->second.size == size)
+	{
+		unsigned char* pValue = &mUniformData[i->second.offset];
+		if (memcmp(pValue, data, size) == 0)
+			return countChange(RENDER_STATE_TYPE_UNIFORM, false);
+
+		memcpy(pValue, data, size);
+		return countChange(RENDER_STATE_TYPE_UNIFORM, true);
+	}
+
+	UniformValue value;
+	value.offset = (unsigned int)mUniformData.size();
+	value.size = size;
+
+	mUniformData.resize(mUniformData.size() + size);
+	memcpy(&mUniformData[value.offset], data, size);
+
+	mUniforms[key] = value;
+
+	return countChange(RENDER_STATE_TYPE_UNIFORM, true);
+}
+
+bool RenderStateCache::setUniformBlock(unsigned int binding, unsigned int buffer, unsigned int offset, unsigned int size)
+{
+	if (binding >= RENDER_STATE_MAX_UNIFORM_BLOCKS)
+		return countChange(RENDER_STATE_TYPE_UNIFORM_BLOCK, true);
+
+	UniformBlockRange& range = mUniformBlocks[binding];
+	bool changed = (range.buffer != buffer || range.offset != offset || range.size != size);
+
+	range.buffer = buffer;
+	range.offset = offset;
+	range.size = size;
+
+	return countChange(RENDER_STATE_TYPE_UNIFORM_BLOCK, changed);
+}
+
+bool RenderStateCache::setBlendEnabled(bool enabled)
+{
+	unsigned int value = enabled ? 1 : 0;
+	bool changed = (mBlendEnabled != value);
+	mBlendEnabled = value;
+
+	return countChange(RENDER_STATE_TYPE_BLEND, changed);
+}
+
+bool RenderStateCache::setDepthWriteEnabled(bool enabled)
+{
+	unsigned int value = enabled ? 1 : 0;
+	bool changed = (mDepthWriteEnabled != value);
+	mDepthWriteEnabled = value;
+
+	return countChange(RENDER_STATE_TYPE_DEPTH_WRITE, changed);
+}
+
+bool RenderStateCache::countChange(RenderStateType type, bool changed)
+{
+	if (changed)
+		mIssuedCounts[type]++;
+	else
+		mSkippedCounts[type]++;
+
+	return changed;
+}
+
+} // end namespace render
\ No newline at end of file
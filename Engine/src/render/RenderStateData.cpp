@@ -28,10 +28,13 @@ THE SOFTWARE.
 #include <render/Light.h>
 #include <render/Camera.h>
 #include <render/Model.h>
+#include <render/LightCuller.h>
 #include <game/GameObject.h>
 #include <game/ComponentDefines.h>
 #include <game/Transform.h>
 
+#include <string.h>
+
 namespace render
 {
 
@@ -42,10 +45,13 @@ RenderStateData::RenderStateData()
 	mInverseTransposeWorldMatrix = core::matrix4::IDENTITY;
 	mViewMatrix = core::matrix4::IDENTITY;
 	mInverseViewMatrix = core::matrix4::IDENTITY;
+	mInverseProjectionMatrix = core::matrix4::IDENTITY;
 	mProjectionMatrix = core::matrix4::IDENTITY;
 	mViewProjMatrix = core::matrix4::IDENTITY;
 	mWorldViewMatrix = core::matrix4::IDENTITY;
 	mInverseWorldViewMatrix = core::matrix4::IDENTITY;
+	mInverseViewProjMatrix = core::matrix4::IDENTITY;
+	mInverseWorldViewProjMatrix = core::matrix4::IDENTITY;
 	mInverseTransposeWorldViewMatrix = core::matrix4::IDENTITY;
 	mWorldViewProjMatrix = core::matrix4::IDENTITY;
 
@@ -70,8 +76,11 @@ RenderStateData::RenderStateData()
 
 	mInverseWorldMatrixDirty = true;
 	mInverseViewMatrixDirty = true;
+	mInverseProjMatrixDirty = true;
 
 	mInverseWorldViewMatrixDirty = true;
+	mInverseViewProjMatrixDirty = true;
+	mInverseWorldViewProjMatrixDirty = true;
 
 	mInverseTransposeWorldMatrixDirty = true;
 	mInverseTransposeWorldViewMatrixDirty = true;
@@ -79,12 +88,226 @@ RenderStateData::RenderStateData()
 	mCameraPositionDirty = true;
 	mCameraPositionObjectSpaceDirty = true;
 
+	mCurrentMaterial = nullptr;
 	mCurrentModel = nullptr;
 	mCurrentCamera = nullptr;
 	mCurrentLight = nullptr;
 	mCurrentViewport = nullptr;
+	mLightCuller = nullptr;
 
 	mAmbientLightColor = Color::Black;
+
+	// The materials start at version 0, so their first draw sets all the values
+	for (unsigned int i = 0; i < SHADER_PARAMETER_FREQUENCY_COUNT; ++i)
+		mVersions[i] = 1;
+
+	memset(&mStats, 0, sizeof(RenderStateDataStats));
+}
+
+void RenderStateData::beginFrame()
+{
+	invalidate(SHADER_PARAMETER_FREQUENCY_FRAME);
+
+	memset(&mStats, 0, sizeof(RenderStateDataStats));
+}
+
+unsigned int RenderStateData::getVersion(ShaderParameterFrequency frequency) const
+{
+	return mVersions[frequency];
+}
+
+bool RenderStateData::getParameterValue(ShaderAutoParameterType source, float* values)
+{
+	++mStats.parameterCount;
+
+	const float* pValues = nullptr;
+	unsigned int count = 0;
+	core::matrix4 m;
+	core::vector4d v;
+
+	switch (source)
+	{
+	case SHADER_AUTO_PARAMETER_TYPE_WORLD_MATRIX:
+		pValues = getWorldMatrix().get();
+		count = 16;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_INVERSE_WORLD_MATRIX:
+		pValues = getInverseWorldMatrix().get();
+		count = 16;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_TRANSPOSE_WORLD_MATRIX:
+		m = getTransposedWorldMatrix();
+		count = 16;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_INVERSE_TRANSPOSE_WORLD_MATRIX:
+		pValues = getInverseTransposedWorldMatrix().get();
+		count = 16;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_VIEW_MATRIX:
+		pValues = getViewMatrix().get();
+		count = 16;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_INVERSE_VIEW_MATRIX:
+		pValues = getInverseViewMatrix().get();
+		count = 16;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_TRANSPOSE_VIEW_MATRIX:
+		m = getTransposedViewMatrix();
+		count = 16;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_INVERSE_TRANSPOSE_VIEW_MATRIX:
+		m = getInverseTransposedViewMatrix();
+		count = 16;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_PROJECTION_MATRIX:
+		pValues = getProjectionMatrix().get();
+		count = 16;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_INVERSE_PROJECTION_MATRIX:
+		pValues = getInverseProjectionMatrix().get();
+		count = 16;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_TRANSPOSE_PROJECTION_MATRIX:
+		m = getTransposedProjectionMatrix();
+		count = 16;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_INVERSE_TRANSPOSE_PROJECTION_MATRIX:
+		m = getInverseTransposedProjectionMatrix();
+		count = 16;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_VIEWPROJ_MATRIX:
+		pValues = getViewProjectionMatrix().get();
+		count = 16;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_INVERSE_VIEWPROJ_MATRIX:
+		pValues = getInverseViewProjectionMatrix().get();
+		count = 16;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_TRANSPOSE_VIEWPROJ_MATRIX:
+		m = getTransposedViewProjectionMatrix();
+		count = 16;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_INVERSE_TRANSPOSE_VIEWPROJ_MATRIX:
+		m = getInverseTransposedViewProjectionMatrix();
+		count = 16;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_WORLDVIEW_MATRIX:
+		pValues = getWorldViewMatrix().get();
+		count = 16;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_INVERSE_WORLDVIEW_MATRIX:
+		pValues = getInverseWorldViewMatrix().get();
+		count = 16;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_TRANSPOSE_WORLDVIEW_MATRIX:
+		m = getTransposedWorldViewMatrix();
+		count = 16;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_INVERSE_TRANSPOSE_WORLDVIEW_MATRIX:
+		pValues = getInverseTransposedWorldViewMatrix().get();
+		count = 16;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_WORLDVIEWPROJ_MATRIX:
+		pValues = getWorldViewProjMatrix().get();
+		count = 16;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_INVERSE_WORLDVIEWPROJ_MATRIX:
+		pValues = getInverseWorldViewProjMatrix().get();
+		count = 16;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_TRANSPOSE_WORLDVIEWPROJ_MATRIX:
+		m = getTransposedWorldViewProjMatrix();
+		count = 16;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_INVERSE_TRANSPOSE_WORLDVIEWPROJ_MATRIX:
+		m = getInverseTransposedWorldViewProjMatrix();
+		count = 16;
+		break;
+
+	case SHADER_AUTO_PARAMETER_TYPE_LIGHT_POSITION:
+		pValues = &getCurrentLightPosition().x;
+		count = 3;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_LIGHT_POSITION_OBJECT_SPACE:
+		pValues = &getCurrentLightPositionObjectSpace().x;
+		count = 3;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_LIGHT_POSITION_VIEW_SPACE:
+		pValues = &getCurrentLightPositionViewSpace().x;
+		count = 3;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_LIGHT_DIRECTION:
+		pValues = &getCurrentLightDirection().x;
+		count = 3;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_LIGHT_DIRECTION_OBJECT_SPACE:
+		pValues = &getCurrentLightDirectionObjectSpace().x;
+		count = 3;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_LIGHT_DIRECTION_VIEW_SPACE:
+		pValues = &getCurrentLightDirectionViewSpace().x;
+		count = 3;
+		break;
+
+	case SHADER_AUTO_PARAMETER_TYPE_AMBIENT_LIGHT_COLOUR:
+		pValues = &getAmbientLightColour().r;
+		count = 4;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_LIGHT_DIFFUSE_COLOUR:
+		pValues = &getCurrentLightDiffuseColour().r;
+		count = 4;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_LIGHT_SPECULAR_COLOUR:
+		pValues = &getCurrentLightSpecularColour().r;
+		count = 4;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_LIGHT_ATTENUATION:
+		v = getCurrentLightAttenuation();
+		values[0] = v.x;
+		values[1] = v.y;
+		values[2] = v.z;
+		values[3] = v.w;
+		return true;
+	case SHADER_AUTO_PARAMETER_TYPE_LIGHT_POWER_SCALE:
+		values[0] = getCurrentLightPowerScale();
+		return true;
+
+	case SHADER_AUTO_PARAMETER_TYPE_CAMERA_POSITION:
+		pValues = &getCameraPosition().x;
+		count = 3;
+		break;
+	case SHADER_AUTO_PARAMETER_TYPE_CAMERA_POSITION_OBJECT_SPACE:
+		pValues = &getCameraPositionObjectSpace().x;
+		count = 3;
+		break;
+
+	case SHADER_AUTO_PARAMETER_TYPE_CLUSTER_GRID_SIZE:
+	case SHADER_AUTO_PARAMETER_TYPE_CLUSTER_DEPTH_PARAMETERS:
+		if (mLightCuller == nullptr)
+			return false;
+
+		v = (source == SHADER_AUTO_PARAMETER_TYPE_CLUSTER_GRID_SIZE) ? mLightCuller->getGridParameters() : mLightCuller->getDepthParameters();
+		values[0] = v.x;
+		values[1] = v.y;
+		values[2] = v.z;
+		values[3] = v.w;
+		return true;
+
+	default:
+		return false;
+	}
+
+	if (pValues == nullptr)
+		pValues = m.get();
+
+	memcpy(values, pValues, count * sizeof(float));
+
+	return true;
+}
+
+const RenderStateDataStats& RenderStateData::getStats() const
+{
+	return mStats;
 }
 
 void RenderStateData::setWorldMatrix(const core::matrix4& m)
@@ -101,22 +324,24 @@ void RenderStateData::setCurrentMaterial(Material* material)
 void RenderStateData::setCurrentModel(Model* model)
 {
 	mCurrentModel = model;
-	
+
+	// The camera values stay valid for all the models of a view
 	mWorldMatrixDirty = true;
-	mViewMatrixDirty = true;
-	mProjMatrixDirty = true;
 
 	mWorldViewMatrixDirty = true;
-	mViewProjMatrixDirty = true;
 	mWorldViewProjMatrixDirty = true;
 
 	mInverseWorldMatrixDirty = true;
-	mInverseViewMatrixDirty = true;
 
 	mInverseWorldViewMatrixDirty = true;
+	mInverseWorldViewProjMatrixDirty = true;
 
 	mInverseTransposeWorldMatrixDirty = true;
 	mInverseTransposeWorldViewMatrixDirty = true;
+
+	mCameraPositionObjectSpaceDirty = true;
+
+	invalidate(SHADER_PARAMETER_FREQUENCY_OBJECT);
 }
 
 void RenderStateData::setCurrentCamera(Camera* cam)
@@ -134,10 +359,15 @@ void RenderStateData::setCurrentCamera(Camera* cam)
 	mWorldViewProjMatrixDirty = true;
 
 	mInverseViewMatrixDirty = true;
+	mInverseProjMatrixDirty = true;
 	
 	mInverseWorldViewMatrixDirty = true;
+	mInverseViewProjMatrixDirty = true;
+	mInverseWorldViewProjMatrixDirty = true;
 	
 	mInverseTransposeWorldViewMatrixDirty = true;
+
+	invalidate(SHADER_PARAMETER_FREQUENCY_CAMERA);
 }
 
 void RenderStateData::setCurrentViewport(Viewport* viewport)
@@ -147,7 +377,27 @@ void RenderStateData::setCurrentViewport(Viewport* viewport)
 
 void RenderStateData::setCurrentLight(Light* light)
 {
+	if (mCurrentLight == light)
+		return;
+
 	mCurrentLight = light;
+
+	invalidate(SHADER_PARAMETER_FREQUENCY_FRAME);
+}
+
+void RenderStateData::setLightCuller(LightCuller* lightCuller)
+{
+	if (mLightCuller == lightCuller)
+		return;
+
+	mLightCuller = lightCuller;
+
+	invalidate(SHADER_PARAMETER_FREQUENCY_CAMERA);
+}
+
+LightCuller* RenderStateData::getLightCuller() const
+{
+	return mLightCuller;
 }
 
 Material* RenderStateData::getCurrentMaterial() const
@@ -166,7 +416,7 @@ const core::vector3d& RenderStateData::getCameraPosition()
 	{
 		if (mCurrentCamera != nullptr && mCurrentCamera->getGameObject() != nullptr)
 		{
-			game::Transform* pTransform = static_cast<game::Transform*>(mCurrentCamera->getGameObject()->getComponent(game::COMPONENT_TYPE_TRANSFORM));
+			game::Transform* pTransform = mCurrentCamera->getGameObject()->getTransform();
 			if (pTransform != nullptr)
 			{
 				mCameraPosition = pTransform->getAbsolutePosition();
@@ -184,7 +434,7 @@ const core::vector3d& RenderStateData::getCameraPositionObjectSpace()
 	{
 		if (mCurrentCamera != nullptr && mCurrentCamera->getGameObject() != nullptr)
 		{
-			game::Transform* pTransform = static_cast<game::Transform*>(mCurrentCamera->getGameObject()->getComponent(game::COMPONENT_TYPE_TRANSFORM));
+			game::Transform* pTransform = mCurrentCamera->getGameObject()->getTransform();
 			if (pTransform != nullptr)
 			{
 				mCameraPositionObjectSpace = pTransform->getAbsolutePosition();
@@ -201,7 +451,7 @@ const core::vector3d& RenderStateData::getCurrentLightPosition()
 {
 	if (mCurrentLight != nullptr && mCurrentLight->getGameObject() != nullptr)
 	{
-		game::Transform* pTransform = static_cast<game::Transform*>(mCurrentLight->getGameObject()->getComponent(game::COMPONENT_TYPE_TRANSFORM));
+		game::Transform* pTransform = mCurrentLight->getGameObject()->getTransform();
 		if (pTransform != nullptr)
 		{
 			mLightPosition = pTransform->getAbsolutePosition();
@@ -217,7 +467,8 @@ const core::vector3d& RenderStateData::getCurrentLightPositionObjectSpace()
 
 	if (mCurrentLight && mCurrentLight->getLightType() == LIGHT_TYPE_DIRECTIONAL)
 	{
-		core::matrix4 m = getInverseTransposedWorldMatrix().getInverse();
+		// The inverse of the inverse transposed world matrix
+		core::matrix4 m = getTransposedWorldMatrix();
 			
 		m.transformVector(mLightPositionObjectSpace);
 		mLightPositionObjectSpace.normalize();
@@ -241,12 +492,9 @@ const core::vector3d& RenderStateData::getCurrentLightPositionViewSpace()
 
 const core::vector3d& RenderStateData::getCurrentLightDirection()
 {
-	if (mCurrentLight != nullptr)
-		
-
 	if (mCurrentLight != nullptr && mCurrentLight->getGameObject() != nullptr)
 	{
-		game::Transform* pTransform = static_cast<game::Transform*>(mCurrentLight->getGameObject()->getComponent(game::COMPONENT_TYPE_TRANSFORM));
+		game::Transform* pTransform = mCurrentLight->getGameObject()->getTransform();
 		if (pTransform != nullptr)
 		{
 			mLightDirection = pTransform->getAbsoluteOrientation() * core::vector3d::NEGATIVE_UNIT_Z;
@@ -278,7 +526,12 @@ const core::vector3d& RenderStateData::getCurrentLightDirectionViewSpace()
 
 void RenderStateData::setAmbientLightColor(const Color& ambient)
 {
+	if (mAmbientLightColor == ambient)
+		return;
+
 	mAmbientLightColor = ambient;
+
+	invalidate(SHADER_PARAMETER_FREQUENCY_FRAME);
 }
 
 const Color& RenderStateData::getAmbientLightColour() const
@@ -306,7 +559,6 @@ core::vector4d RenderStateData::getCurrentLightAttenuation() const
 
 	if (mCurrentLight)
 	{
-		core::vector4d lightAttenuation;
 		lightAttenuation.x = mCurrentLight->getAttenuationRange();
 		lightAttenuation.y = mCurrentLight->getAttenuationConstant();
 		lightAttenuation.z = mCurrentLight->getAttenuationLinear();
@@ -316,6 +568,13 @@ core::vector4d RenderStateData::getCurrentLightAttenuation() const
 	return lightAttenuation;
 }
 
+float RenderStateData::getCurrentLightPowerScale() const
+{
+	if (mCurrentLight) return mCurrentLight->getPowerScale();
+
+	return 1.0f;
+}
+
 const core::matrix4& RenderStateData::getWorldMatrix()
 {
 	if (mWorldMatrixDirty)
@@ -371,10 +630,10 @@ const core::matrix4& RenderStateData::getWorldViewMatrix()
 
 const core::matrix4& RenderStateData::getViewProjectionMatrix()
 {
-	if (mProjMatrixDirty)
+	if (mViewProjMatrixDirty)
 	{
 		mViewProjMatrix = getProjectionMatrix() * getViewMatrix();
-		mProjMatrixDirty = false;
+		mViewProjMatrixDirty = false;
 	}
 	
 	return mViewProjMatrix;
@@ -395,7 +654,7 @@ const core::matrix4& RenderStateData::getInverseWorldMatrix()
 {
 	if (mInverseWorldMatrixDirty)
 	{
-		mInverseWorldMatrix = getWorldMatrix().getInverse();
+		mInverseWorldMatrix = getInverse(getWorldMatrix());
 		mInverseWorldMatrixDirty = false;
 	}
 
@@ -406,35 +665,50 @@ const core::matrix4& RenderStateData::getInverseViewMatrix()
 {
 	if (mInverseViewMatrixDirty)
 	{
-		mInverseViewMatrix = getViewMatrix().getInverse();
+		mInverseViewMatrix = getInverse(getViewMatrix());
 		mInverseViewMatrixDirty = false;
 	}
 	return mInverseViewMatrix;
 }
 
-core::matrix4 RenderStateData::getInverseProjectionMatrix()
+const core::matrix4& RenderStateData::getInverseProjectionMatrix()
 {
-	return getProjectionMatrix().getInverse();
+	if (mInverseProjMatrixDirty)
+	{
+		mInverseProjectionMatrix = getInverse(getProjectionMatrix());
+		mInverseProjMatrixDirty = false;
+	}
+	return mInverseProjectionMatrix;
 }
 
 const core::matrix4& RenderStateData::getInverseWorldViewMatrix()
 {
 	if (mInverseWorldViewMatrixDirty)
 	{
-		mInverseWorldViewMatrix = getWorldViewMatrix().getInverse();
+		mInverseWorldViewMatrix = getInverse(getWorldViewMatrix());
 		mInverseWorldViewMatrixDirty = false;
 	}
 	return mInverseWorldViewMatrix;
 }
 
-core::matrix4 RenderStateData::getInverseViewProjectionMatrix()
+const core::matrix4& RenderStateData::getInverseViewProjectionMatrix()
 {
-	return getViewProjectionMatrix().getInverse();
+	if (mInverseViewProjMatrixDirty)
+	{
+		mInverseViewProjMatrix = getInverse(getViewProjectionMatrix());
+		mInverseViewProjMatrixDirty = false;
+	}
+	return mInverseViewProjMatrix;
 }
 
-core::matrix4 RenderStateData::getInverseWorldViewProjMatrix()
+const core::matrix4& RenderStateData::getInverseWorldViewProjMatrix()
 {
-	return getWorldViewProjMatrix().getInverse();
+	if (mInverseWorldViewProjMatrixDirty)
+	{
+		mInverseWorldViewProjMatrix = getInverse(getWorldViewProjMatrix());
+		mInverseWorldViewProjMatrixDirty = false;
+	}
+	return mInverseWorldViewProjMatrix;
 }
 
 core::matrix4 RenderStateData::getTransposedWorldMatrix()
@@ -509,4 +783,18 @@ core::matrix4 RenderStateData::getInverseTransposedWorldViewProjMatrix()
 	return getInverseWorldViewProjMatrix().getTransposed();
 }
 
+void RenderStateData::invalidate(ShaderParameterFrequency frequency)
+{
+	// The values of a frequency can be read from the ones before it, like the object space light position
+	for (unsigned int i = frequency; i < SHADER_PARAMETER_FREQUENCY_COUNT; ++i)
+		++mVersions[i];
+}
+
+core::matrix4 RenderStateData::getInverse(const core::matrix4& m)
+{
+	++mStats.matrixInversionCount;
+
+	return m.getInverse();
+}
+
 } // end namespace render
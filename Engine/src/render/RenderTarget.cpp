@@ -147,6 +147,16 @@ int RenderTarget::getTriangleCount() const
 	return mStats.triangleCount;
 }
 
+int RenderTarget::getModelCount() const
+{
+	return mStats.modelCount;
+}
+
+int RenderTarget::getDrawCallCount() const
+{
+	return mStats.drawCallCount;
+}
+
 void RenderTarget::resetStatistics()
 {
 	mStats.avgFPS = 0.0;
@@ -154,6 +164,8 @@ void RenderTarget::resetStatistics()
 	mStats.lastFPS = 0.0;
 	mStats.worstFPS = 999.0;
 	mStats.triangleCount = 0;
+	mStats.modelCount = 0;
+	mStats.drawCallCount = 0;
 
 	mFrameCount = 0;
 	mLastElapsedTime = 0;
@@ -203,6 +215,8 @@ void RenderTarget::updateImpl(float elapsedTime)
 	firePreUpdate();
 
 	mStats.triangleCount = 0;
+	mStats.modelCount = 0;
+	mStats.drawCallCount = 0;
 	// Go through viewports in Z-order
 	// Tell each to refresh
 	std::list<Viewport*>::const_iterator i;
@@ -214,7 +228,11 @@ void RenderTarget::updateImpl(float elapsedTime)
 			pViewport->update(elapsedTime);
 
 			if (pViewport->isVisible())
+			{
 				mStats.triangleCount += pViewport->getNumRenderedFaces();
+				mStats.modelCount += pViewport->getNumRenderedModels();
+				mStats.drawCallCount += pViewport->getNumDrawCalls();
+			}
 		}
 	}
 
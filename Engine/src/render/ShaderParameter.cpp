@@ -52,4 +52,13 @@ ShaderAutoParameter::ShaderAutoParameter()
 	mAutoParameterType = SHADER_AUTO_PARAMETER_TYPE_NONE;
 }
 
+ShaderParameterInstruction::ShaderParameterInstruction()
+{
+	mParameter = nullptr;
+	mSource = SHADER_AUTO_PARAMETER_TYPE_NONE;
+	mParameterType = SHADER_PARAMETER_TYPE_UNKNOWN;
+	mLocation = (unsigned int)-1;
+	mBlockOffset = (unsigned int)-1;
+}
+
 } // end namespace render
@@ -0,0 +1,705 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <render/StaticBatcher.h>
+#include <render/Model.h>
+#include <render/MeshData.h>
+#include <render/Material.h>
+#include <render/VertexBuffer.h>
+#include <render/IndexBuffer.h>
+#include <render/IndexBufferDefines.h>
+#include <render/RenderDefines.h>
+#include <render/RenderManager.h>
+#include <game/GameObject.h>
+#include <game/GameManager.h>
+#include <game/Transform.h>
+#include <game/ComponentDefines.h>
+#include <physics/BodyData.h>
+#include <physics/Body.h>
+#include <resource/Buffer.h>
+#include <core/Aabox3d.h>
+#include <core/Vector4d.h>
+#include <core/Matrix4.h>
+#include <core/Simd.h>
+#include <core/Log.h>
+#include <core/LogDefines.h>
+#include <core/Utils.h>
+#include <core/Profiler.h>
+
+#include <set>
+#include <chrono>
+#include <math.h>
+#include <string.h>
+
+namespace render
+{
+
+//! Default size of the grid cells the chunks are split by, in world units.
+static const float STATIC_BATCH_DEFAULT_CHUNK_SIZE = 64.0f;
+
+//! What the models merged into one chunk have in common.
+struct StaticBatchKey
+{
+	Material* material;
+
+	//! Element type of every vertex stream, -1 for the missing ones.
+	int elementTypes[VERTEX_BUFFER_TYPE_COUNT];
+
+	int cell[3];
+
+	bool operator<(const StaticBatchKey& other) const
+	{
+		if (material != other.material)
+			return material < other.material;
+
+		for (unsigned int i = 0; i < VERTEX_BUFFER_TYPE_COUNT; ++i)
+		{
+			if (elementTypes[i] != other.elementTypes[i])
+				return elementTypes[i] < other.elementTypes[i];
+		}
+
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			if (cell[i] != other.cell[i])
+				return cell[i] < other.cell[i];
+		}
+
+		return false;
+	}
+};
+
+//! Geometry of a source mesh read back from its buffers.
+struct StaticBatchGeometry
+{
+	StaticBatchGeometry()
+	{
+		numVertices = 0;
+		valid = false;
+	}
+
+	std::vector<unsigned char> streams[VERTEX_BUFFER_TYPE_COUNT];
+	std::vector<unsigned int> indices;
+	unsigned int numVertices;
+	bool valid;
+};
+
+static bool readGeometry(MeshData* meshData, StaticBatchGeometry& geometry)
+{
+	VertexBuffer* pPositions = meshData->getVertexBuffer(VERTEX_BUFFER_TYPE_POSITION);
+	IndexBuffer* pIndexBuffer = meshData->getIndexBuffer();
+	if (pPositions == nullptr || pIndexBuffer == nullptr || pPositions->getNumVertices() == 0 || pIndexBuffer->getNumIndexes() < 3)
+		return false;
+
+	geometry.numVertices = pPositions->getNumVertices();
+
+	for (unsigned int i = 0; i < VERTEX_BUFFER_TYPE_COUNT; ++i)
+	{
+		VertexBuffer* pVertexBuffer = meshData->getVertexBuffer((VertexBufferType)i);
+		if (pVertexBuffer == nullptr)
+			continue;
+
+		if (pVertexBuffer->getNumVertices() < geometry.numVertices || pVertexBuffer->getVertexSize() == 0)
+			return false;
+
+		geometry.streams[i].resize(geometry.numVertices * pVertexBuffer->getVertexSize());
+		pVertexBuffer->readData(0, (unsigned int)geometry.streams[i].size(), &geometry.streams[i][0]);
+	}
+
+	unsigned int numIndexes = pIndexBuffer->getNumIndexes();
+	geometry.indices.resize(numIndexes);
+
+	if (pIndexBuffer->getType() == IT_16BIT)
+	{
+		std::vector<unsigned short> shortIndices(numIndexes);
+		pIndexBuffer->readData(0, numIndexes * sizeof(unsigned short), &shortIndices[0]);
+
+		for (unsigned int i = 0; i < numIndexes; ++i)
+			geometry.indices[i] = shortIndices[i];
+	}
+	else
+	{
+		pIndexBuffer->readData(0, numIndexes * sizeof(unsigned int), &geometry.indices[0]);
+	}
+
+	for (unsigned int i = 0; i < numIndexes; ++i)
+	{
+		if (geometry.indices[i] >= geometry.numVertices)
+			return false;
+	}
+
+	return true;
+}
+
+//! Transforms directions by the 3x3 part of a matrix and normalizes them.
+//! \param stride: Distance between two directions in floats.
+static void transformDirections(const core::matrix4& m, float* data, unsigned int count, unsigned int stride)
+{
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		float* v = data + i * stride;
+
+		core::vector3d direction(m[0] * v[0] + m[1] * v[1] + m[2] * v[2],
+								m[4] * v[0] + m[5] * v[1] + m[6] * v[2],
+								m[8] * v[0] + m[9] * v[1] + m[10] * v[2]);
+		direction.normalize();
+
+		v[0] = direction.x;
+		v[1] = direction.y;
+		v[2] = direction.z;
+	}
+}
+
+static float getDeterminant3x3(const core::matrix4& m)
+{
+	return m[0] * (m[5] * m[10] - m[6] * m[9]) - m[1] * (m[4] * m[10] - m[6] * m[8]) + m[2] * (m[4] * m[9] - m[5] * m[8]);
+}
+
+static unsigned int getBufferSize(MeshData* meshData)
+{
+	unsigned int size = 0;
+
+	for (unsigned int i = 0; i < VERTEX_BUFFER_TYPE_COUNT; ++i)
+	{
+		VertexBuffer* pVertexBuffer = meshData->getVertexBuffer((VertexBufferType)i);
+		if (pVertexBuffer != nullptr)
+			size += pVertexBuffer->getSizeInBytes();
+	}
+
+	if (meshData->getIndexBuffer() != nullptr)
+		size += meshData->getIndexBuffer()->getSizeInBytes();
+
+	return size;
+}
+
+static void removeBuffers(MeshData* meshData)
+{
+	RenderManager* pRenderManager = RenderManager::getInstance();
+	if (meshData == nullptr || pRenderManager == nullptr)
+		return;
+
+	for (unsigned int i = 0; i < VERTEX_BUFFER_TYPE_COUNT; ++i)
+	{
+		VertexBuffer* pVertexBuffer = meshData->getVertexBuffer((VertexBufferType)i);
+		if (pVertexBuffer != nullptr)
+		{
+			pRenderManager->removeVertexBuffer(pVertexBuffer);
+			meshData->setVertexBuffer((VertexBufferType)i, nullptr);
+		}
+	}
+
+	if (meshData->getIndexBuffer() != nullptr)
+	{
+		pRenderManager->removeIndexBuffer(meshData->getIndexBuffer());
+		meshData->setIndexBuffer(nullptr);
+	}
+}
+
+StaticBatcher::StaticBatcher()
+{
+	mChunkSize = STATIC_BATCH_DEFAULT_CHUNK_SIZE;
+
+	memset(&mStats, 0, sizeof(StaticBatchStats));
+}
+
+StaticBatcher::~StaticBatcher()
+{
+	clear();
+}
+
+void StaticBatcher::setChunkSize(float size)
+{
+	if (size > 0.0f)
+		mChunkSize = size;
+}
+
+float StaticBatcher::getChunkSize() const
+{
+	return mChunkSize;
+}
+
+bool StaticBatcher::isStaticModel(Model* model)
+{
+	if (model == nullptr || model->getGameObject() == nullptr)
+		return false;
+
+	MeshData* pMeshData = model->getMeshData();
+	if (pMeshData == nullptr || pMeshData->getState() != resource::RESOURCE_STATE_LOADED || pMeshData->getRenderOperationType() != ROT_TRIANGLE_LIST)
+		return false;
+
+	if (model->isStatic())
+		return true;
+
+	physics::Body* pBody = static_cast<physics::Body*>(model->getGameObject()->getComponent(game::COMPONENT_TYPE_BODY));
+
+	return (pBody != nullptr && pBody->getBodyType() == physics::BT_STATIC);
+}
+
+unsigned int StaticBatcher::build(const std::vector<Model*>& models)
+{
+	if (game::GameManager::getInstance() == nullptr || RenderManager::getInstance() == nullptr)
+		return 0;
+
+	PROFILE_SCOPE("StaticBatcher::build");
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	memset(&mStats, 0, sizeof(StaticBatchStats));
+
+	// the chunks of an earlier build are static too
+	std::set<MeshData*> chunkMeshes;
+	for (unsigned int i = 0; i < mChunks.size(); ++i)
+		chunkMeshes.insert(mChunks[i].meshData);
+
+	std::map<StaticBatchKey, std::vector<Model*> > groups;
+	for (unsigned int i = 0; i < models.size(); ++i)
+	{
+		Model* pModel = models[i];
+		if (!isStaticModel(pModel))
+			continue;
+
+		if (mSourceChunks.find(pModel->getGameObject()->getHandle()) != mSourceChunks.end() || chunkMeshes.find(pModel->getMeshData()) != chunkMeshes.end())
+			continue;
+
+		StaticBatchKey key;
+		key.material = pModel->getMaterial();
+
+		for (unsigned int j = 0; j < VERTEX_BUFFER_TYPE_COUNT; ++j)
+		{
+			VertexBuffer* pVertexBuffer = pModel->getMeshData()->getVertexBuffer((VertexBufferType)j);
+			key.elementTypes[j] = (pVertexBuffer != nullptr) ? (int)pVertexBuffer->getVertexElementType() : -1;
+		}
+
+		core::vector3d center = pModel->getBoundingBox().getCenter();
+		key.cell[0] = (int)floorf(center.x / mChunkSize);
+		key.cell[1] = (int)floorf(center.y / mChunkSize);
+		key.cell[2] = (int)floorf(center.z / mChunkSize);
+
+		groups[key].push_back(pModel);
+	}
+
+	unsigned int firstChunk = (unsigned int)mChunks.size();
+
+	std::map<StaticBatchKey, std::vector<Model*> >::const_iterator i;
+	for (i = groups.begin(); i != groups.end(); ++i)
+	{
+		// a lone model would only cost memory
+		if (i->second.size() < 2)
+			continue;
+
+		buildChunk(i->second, (unsigned int)mChunks.size());
+	}
+
+	std::set<MeshData*> sourceMeshes;
+	for (unsigned int chunk = firstChunk; chunk < mChunks.size(); ++chunk)
+	{
+		const std::vector<StaticBatchSource>& sources = mChunks[chunk].sources;
+		for (unsigned int j = 0; j < sources.size(); ++j)
+		{
+			Model* pModel = static_cast<Model*>(game::GameManager::getInstance()->getComponent(sources[j].model));
+			if (pModel != nullptr && pModel->getMeshData() != nullptr)
+				sourceMeshes.insert(pModel->getMeshData());
+		}
+
+		mStats.modelCount += (unsigned int)sources.size();
+		mStats.chunkBufferSize += getBufferSize(mChunks[chunk].meshData);
+	}
+
+	std::set<MeshData*>::const_iterator mesh;
+	for (mesh = sourceMeshes.begin(); mesh != sourceMeshes.end(); ++mesh)
+		mStats.sourceBufferSize += getBufferSize(*mesh);
+
+	mStats.chunkCount = (unsigned int)mChunks.size() - firstChunk;
+	mStats.buildTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	if (core::Log::getInstance() != nullptr && mStats.chunkCount > 0)
+	{
+		std::string msg = "Merged " + core::intToString(mStats.modelCount) + " static models into " + core::intToString(mStats.chunkCount) + " chunks, " +
+			core::intToString(mStats.sourceBufferSize) + " bytes of source buffers, " + core::intToString(mStats.chunkBufferSize) + " bytes of chunk buffers.";
+		core::Log::getInstance()->logMessage("StaticBatcher", msg, core::LOG_LEVEL_INFORMATION);
+	}
+
+	return mStats.modelCount;
+}
+
+void StaticBatcher::clear()
+{
+	game::GameManager* pGameManager = game::GameManager::getInstance();
+	RenderManager* pRenderManager = RenderManager::getInstance();
+
+	for (unsigned int i = 0; i < mChunks.size(); ++i)
+	{
+		Chunk& chunk = mChunks[i];
+
+		// the chunk model lets go of the mesh data before it is deleted
+		if (pGameManager != nullptr)
+		{
+			pGameManager->removeGameObject(chunk.gameObject);
+
+			for (unsigned int j = 0; j < chunk.sources.size(); ++j)
+			{
+				Model* pModel = static_cast<Model*>(pGameManager->getComponent(chunk.sources[j].model));
+				if (pModel != nullptr && pRenderManager != nullptr)
+					pRenderManager->addModel(pModel);
+			}
+		}
+
+		removeBuffers(chunk.meshData);
+		SAFE_DELETE(chunk.meshData);
+	}
+
+	mChunks.clear();
+	mSourceChunks.clear();
+}
+
+unsigned int StaticBatcher::getChunkCount() const
+{
+	return (unsigned int)mChunks.size();
+}
+
+game::GameObject* StaticBatcher::getChunkGameObject(unsigned int chunk) const
+{
+	if (chunk >= mChunks.size() || game::GameManager::getInstance() == nullptr)
+		return nullptr;
+
+	return game::GameManager::getInstance()->getGameObject(mChunks[chunk].gameObject);
+}
+
+const std::vector<StaticBatchSource>& StaticBatcher::getChunkSources(unsigned int chunk) const
+{
+	static const std::vector<StaticBatchSource> empty;
+
+	if (chunk >= mChunks.size())
+		return empty;
+
+	return mChunks[chunk].sources;
+}
+
+int StaticBatcher::findChunk(game::GameObject* gameObject) const
+{
+	if (gameObject == nullptr)
+		return -1;
+
+	std::map<core::Handle, unsigned int>::const_iterator i = mSourceChunks.find(gameObject->getHandle());
+	if (i == mSourceChunks.end())
+		return -1;
+
+	return (int)i->second;
+}
+
+game::GameObject* StaticBatcher::findSourceGameObject(unsigned int chunk, unsigned int triangle) const
+{
+	if (chunk >= mChunks.size() || game::GameManager::getInstance() == nullptr)
+		return nullptr;
+
+	const std::vector<StaticBatchSource>& sources = mChunks[chunk].sources;
+	unsigned int index = triangle * 3;
+
+	// the sources are in index order
+	unsigned int low = 0;
+	unsigned int high = (unsigned int)sources.size();
+	while (low < high)
+	{
+		unsigned int middle = (low + high) / 2;
+		if (sources[middle].firstIndex + sources[middle].indexCount <= index)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	if (low == sources.size() || index < sources[low].firstIndex)
+		return nullptr;
+
+	return game::GameManager::getInstance()->getGameObject(sources[low].gameObject);
+}
+
+const StaticBatchStats& StaticBatcher::getStats() const
+{
+	return mStats;
+}
+
+bool StaticBatcher::buildChunk(const std::vector<Model*>& models, unsigned int index)
+{
+	RenderManager* pRenderManager = RenderManager::getInstance();
+	game::GameManager* pGameManager = game::GameManager::getInstance();
+
+	// read every mesh once, the models failing to read keep rendering on their own
+	std::map<MeshData*, StaticBatchGeometry> geometries;
+	std::vector<Model*> sources;
+	unsigned int numVertices = 0;
+	unsigned int numIndexes = 0;
+
+	for (unsigned int i = 0; i < models.size(); ++i)
+	{
+		MeshData* pMeshData = models[i]->getMeshData();
+
+		std::map<MeshData*, StaticBatchGeometry>::iterator geometry = geometries.find(pMeshData);
+		if (geometry == geometries.end())
+		{
+			geometry = geometries.insert(std::make_pair(pMeshData, StaticBatchGeometry())).first;
+			geometry->second.valid = readGeometry(pMeshData, geometry->second);
+		}
+
+		if (!geometry->second.valid)
+			continue;
+
+		sources.push_back(models[i]);
+		numVertices += geometry->second.numVertices;
+		numIndexes += (unsigned int)geometry->second.indices.size();
+	}
+
+	if (sources.size() < 2)
+		return false;
+
+	MeshData* pFirstMeshData = sources[0]->getMeshData();
+
+	unsigned int vertexSizes[VERTEX_BUFFER_TYPE_COUNT];
+	VertexElementType elementTypes[VERTEX_BUFFER_TYPE_COUNT];
+	std::vector<unsigned char> streams[VERTEX_BUFFER_TYPE_COUNT];
+
+	for (unsigned int i = 0; i < VERTEX_BUFFER_TYPE_COUNT; ++i)
+	{
+		VertexBuffer* pVertexBuffer = pFirstMeshData->getVertexBuffer((VertexBufferType)i);
+
+		vertexSizes[i] = (pVertexBuffer != nullptr) ? pVertexBuffer->getVertexSize() : 0;
+		elementTypes[i] = (pVertexBuffer != nullptr) ? pVertexBuffer->getVertexElementType() : VERTEX_ELEMENT_TYPE_FLOAT3;
+
+		streams[i].resize(numVertices * vertexSizes[i]);
+	}
+
+	// the geometry is kept relative to the center of the chunk
+	core::aabox3d bounds = sources[0]->getBoundingBox();
+	for (unsigned int i = 1; i < sources.size(); ++i)
+		bounds.addInternalBox(sources[i]->getBoundingBox());
+
+	core::vector3d origin = bounds.getCenter();
+
+	Chunk chunk;
+	chunk.meshData = nullptr;
+	chunk.sources.resize(sources.size());
+
+	std::vector<unsigned int> indices;
+	indices.reserve(numIndexes);
+
+	std::vector<core::vector4d> occluderPositions;
+	std::vector<unsigned int> occluderIndices;
+
+	unsigned int baseVertex = 0;
+	for (unsigned int i = 0; i < sources.size(); ++i)
+	{
+		Model* pModel = sources[i];
+		const StaticBatchGeometry& geometry = geometries[pModel->getMeshData()];
+
+		core::matrix4 world = pModel->getWorldMatrix();
+		world[3] -= origin.x;
+		world[7] -= origin.y;
+		world[11] -= origin.z;
+
+		// normals go through the inverse transpose to stay perpendicular under non uniform scale
+		core::matrix4 normalMatrix = world.getInverse().getTransposed();
+
+		for (unsigned int j = 0; j < VERTEX_BUFFER_TYPE_COUNT; ++j)
+		{
+			if (vertexSizes[j] == 0)
+				continue;
+
+			unsigned char* pDest = &streams[j][baseVertex * vertexSizes[j]];
+			memcpy(pDest, &geometry.streams[j][0], geometry.numVertices * vertexSizes[j]);
+
+			if (elementTypes[j] != VERTEX_ELEMENT_TYPE_FLOAT3 && elementTypes[j] != VERTEX_ELEMENT_TYPE_FLOAT4)
+				continue;
+
+			float* pData = reinterpret_cast<float*>(pDest);
+			unsigned int stride = vertexSizes[j] / sizeof(float);
+
+			switch (j)
+			{
+			case VERTEX_BUFFER_TYPE_POSITION:
+				core::getMathKernels().transformPoints(world.get(), pData, pData, geometry.numVertices, stride);
+				break;
+			case VERTEX_BUFFER_TYPE_NORMAL:
+				transformDirections(normalMatrix, pData, geometry.numVertices, stride);
+				break;
+			case VERTEX_BUFFER_TYPE_TANGENT:
+			case VERTEX_BUFFER_TYPE_BINORMAL:
+				transformDirections(world, pData, geometry.numVertices, stride);
+				break;
+			}
+		}
+
+		// a mirroring matrix turns the triangles inside out
+		bool flip = (getDeterminant3x3(world) < 0.0f);
+
+		StaticBatchSource& source = chunk.sources[i];
+		source.gameObject = pModel->getGameObject()->getHandle();
+		source.model = pModel->getHandle();
+		source.firstIndex = (unsigned int)indices.size();
+
+		unsigned int count = (unsigned int)geometry.indices.size();
+		count -= count % 3;
+		for (unsigned int j = 0; j < count; j += 3)
+		{
+			indices.push_back(baseVertex + geometry.indices[j]);
+			indices.push_back(baseVertex + geometry.indices[flip ? j + 2 : j + 1]);
+			indices.push_back(baseVertex + geometry.indices[flip ? j + 1 : j + 2]);
+		}
+
+		source.indexCount = (unsigned int)indices.size() - source.firstIndex;
+
+		if (pModel->isOccluder())
+		{
+			const std::vector<core::vector4d>& positions = pModel->getMeshData()->getOccluderPositions();
+			const std::vector<unsigned int>& occluders = pModel->getMeshData()->getOccluderIndices();
+
+			unsigned int baseOccluder = (unsigned int)occluderPositions.size();
+			for (unsigned int j = 0; j < positions.size(); ++j)
+			{
+				core::vector4d position;
+				world.transformVector(positions[j], position);
+				occluderPositions.push_back(position);
+			}
+
+			for (unsigned int j = 0; j + 2 < occluders.size(); j += 3)
+			{
+				occluderIndices.push_back(baseOccluder + occluders[j]);
+				occluderIndices.push_back(baseOccluder + occluders[flip ? j + 2 : j + 1]);
+				occluderIndices.push_back(baseOccluder + occluders[flip ? j + 1 : j + 2]);
+			}
+		}
+
+		baseVertex += geometry.numVertices;
+	}
+
+	// local bounds of the merged geometry
+	const float* pPositions = reinterpret_cast<const float*>(&streams[VERTEX_BUFFER_TYPE_POSITION][0]);
+	unsigned int positionStride = vertexSizes[VERTEX_BUFFER_TYPE_POSITION] / sizeof(float);
+
+	core::aabox3d localBounds(pPositions[0], pPositions[1], pPositions[2], pPositions[0], pPositions[1], pPositions[2]);
+	float maxSquaredRadius = 0.0f;
+	for (unsigned int i = 0; i < numVertices; ++i)
+	{
+		const float* p = pPositions + i * positionStride;
+		core::vector3d position(p[0], p[1], p[2]);
+
+		localBounds.addInternalPoint(position);
+
+		if (position.getLengthSQ() > maxSquaredRadius)
+			maxSquaredRadius = position.getLengthSQ();
+	}
+
+	MeshData* pMeshData = new MeshData("StaticBatch" + core::intToString(index), nullptr);
+	pMeshData->setBoundingBox(localBounds);
+	pMeshData->setBoundingSphereRadius(sqrtf(maxSquaredRadius));
+
+	bool created = true;
+	for (unsigned int i = 0; i < VERTEX_BUFFER_TYPE_COUNT && created; ++i)
+	{
+		if (vertexSizes[i] == 0)
+			continue;
+
+		VertexBuffer* pVertexBuffer = pRenderManager->createVertexBuffer((VertexBufferType)i, elementTypes[i], numVertices, resource::BU_STATIC_WRITE_ONLY);
+		if (pVertexBuffer == nullptr)
+		{
+			created = false;
+			break;
+		}
+
+		pMeshData->setVertexBuffer((VertexBufferType)i, pVertexBuffer);
+
+		void* pData = pVertexBuffer->lock(resource::BL_DISCARD);
+		if (pData == nullptr)
+		{
+			created = false;
+			break;
+		}
+
+		memcpy(pData, &streams[i][0], streams[i].size());
+		pVertexBuffer->unlock();
+	}
+
+	if (created)
+	{
+		IndexBuffer* pIndexBuffer = pRenderManager->createIndexBuffer(IT_32BIT, (unsigned int)indices.size(), resource::BU_STATIC_WRITE_ONLY);
+		if (pIndexBuffer != nullptr)
+		{
+			pMeshData->setIndexBuffer(pIndexBuffer);
+
+			void* pData = pIndexBuffer->lock(resource::BL_DISCARD);
+			if (pData != nullptr)
+			{
+				memcpy(pData, &indices[0], indices.size() * sizeof(unsigned int));
+				pIndexBuffer->unlock();
+			}
+			else
+				created = false;
+		}
+		else
+			created = false;
+	}
+
+	if (!created)
+	{
+		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("StaticBatcher", "Unable to create the buffers of a static batch chunk.", core::LOG_LEVEL_ERROR);
+
+		removeBuffers(pMeshData);
+		SAFE_DELETE(pMeshData);
+		return false;
+	}
+
+	if (!occluderIndices.empty())
+		pMeshData->setOccluderGeometry(&occluderPositions[0].x, (unsigned int)occluderPositions.size(), sizeof(core::vector4d), &occluderIndices[0], (unsigned int)occluderIndices.size());
+
+	game::GameObject* pGameObject = pGameManager->createGameObject("StaticBatch" + core::intToString(index));
+	game::Transform* pTransform = static_cast<game::Transform*>(pGameManager->createComponent(game::COMPONENT_TYPE_TRANSFORM));
+	Model* pModel = static_cast<Model*>(pGameManager->createComponent(game::COMPONENT_TYPE_MODEL));
+	pGameObject->attachComponent(pTransform);
+	pGameObject->attachComponent(pModel);
+
+	pTransform->setPosition(origin);
+
+	pModel->setMeshData(pMeshData);
+	pModel->setMaterial(sources[0]->getMaterial());
+	pModel->setStatic(true);
+	pModel->setOccluder(!occluderIndices.empty());
+
+	chunk.gameObject = pGameObject->getHandle();
+	chunk.meshData = pMeshData;
+
+	// the sources stay in the scene for editing, only their draws are replaced
+	for (unsigned int i = 0; i < sources.size(); ++i)
+	{
+		pRenderManager->removeModel(sources[i]);
+		mSourceChunks[chunk.sources[i].gameObject] = index;
+	}
+
+	mStats.vertexCount += numVertices;
+	mStats.indexCount += (unsigned int)indices.size();
+
+	mChunks.push_back(chunk);
+
+	return true;
+}
+
+} // end namespace render
\ No newline at end of file
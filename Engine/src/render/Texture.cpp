@@ -28,6 +28,8 @@ THE SOFTWARE.
 #include <render/Texture.h>
 #include <resource/PixelFormat.h>
 
+#include <string.h>
+
 namespace render
 {
 
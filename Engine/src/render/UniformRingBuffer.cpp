@@ -0,0 +1,350 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <render/UniformRingBuffer.h>
+#include <render/Material.h>
+#include <render/ShaderParameter.h>
+#include <render/RenderStateData.h>
+
+#include <cstring>
+
+namespace render
+{
+
+UniformRingBuffer::UniformRingBuffer()
+{
+	mAlignment = 1;
+	mHead = 0;
+	mTail = 0;
+	mUsedSize = 0;
+	mFrameIndex = 0;
+	mPendingOffset = UNIFORM_RING_BUFFER_INVALID_OFFSET;
+	mPendingWrapOffset = UNIFORM_RING_BUFFER_INVALID_OFFSET;
+
+	memset(&mStats, 0, sizeof(UniformRingBufferStats));
+}
+
+UniformRingBuffer::~UniformRingBuffer() {}
+
+void UniformRingBuffer::initialize(unsigned int size, unsigned int alignment, unsigned int frameCount)
+{
+	mAlignment = (alignment > 0) ? alignment : 1;
+
+	mData.clear();
+	mData.resize(getAlignedSize(size), 0);
+
+	mHead = 0;
+	mTail = 0;
+	mUsedSize = 0;
+
+	mFrameSizes.clear();
+	mFrameSizes.resize((frameCount > 0) ? frameCount : 1, 0);
+	mFrameIndex = 0;
+
+	mPendingOffset = UNIFORM_RING_BUFFER_INVALID_OFFSET;
+	mPendingWrapOffset = UNIFORM_RING_BUFFER_INVALID_OFFSET;
+
+	memset(&mStats, 0, sizeof(UniformRingBufferStats));
+}
+
+void UniformRingBuffer::beginFrame()
+{
+	memset(&mStats, 0, sizeof(UniformRingBufferStats));
+
+	if (mFrameSizes.empty() || mData.empty())
+		return;
+
+	// The frames are kept in the order they were written, the oldest one starts at the tail
+	mFrameIndex = (mFrameIndex + 1) % (unsigned int)mFrameSizes.size();
+
+	unsigned int retiredSize = mFrameSizes[mFrameIndex];
+	mFrameSizes[mFrameIndex] = 0;
+
+	mTail = (mTail + retiredSize) % (unsigned int)mData.size();
+	mUsedSize -= retiredSize;
+}
+
+bool UniformRingBuffer::reserve(unsigned int size)
+{
+	unsigned int capacity = (unsigned int)mData.size();
+	unsigned int offset = getAlignedSize(mHead);
+
+	if (mUsedSize == 0)
+	{
+		if (size <= capacity)
+			return false;
+	}
+	else if (mUsedSize < capacity)
+	{
+		if (mHead >= mTail)
+		{
+			if (offset + size <= capacity)
+				return false;
+
+			// The allocations start over at the beginning right away, so they don't wrap in the middle
+			if (size <= mTail)
+			{
+				if (mPendingOffset != UNIFORM_RING_BUFFER_INVALID_OFFSET)
+					mPendingWrapOffset = mHead;
+
+				mUsedSize += capacity - mHead;
+				mFrameSizes[mFrameIndex] += capacity - mHead;
+				mHead = 0;
+
+				return false;
+			}
+		}
+		else if (offset + size <= mTail)
+		{
+			return false;
+		}
+	}
+
+	// The frames still kept are dropped with the old storage, the next ones as large as this one fit without growing again
+	unsigned int frameCount = mFrameSizes.empty() ? 1 : (unsigned int)mFrameSizes.size();
+	unsigned int frameSize = mFrameSizes.empty() ? size : mFrameSizes[mFrameIndex] + size;
+	unsigned int newCapacity = (capacity > 0) ? capacity * 2 : mAlignment;
+	while (newCapacity < frameSize * frameCount)
+		newCapacity *= 2;
+
+	mData.clear();
+	mData.resize(getAlignedSize(newCapacity), 0);
+
+	mHead = 0;
+	mTail = 0;
+	mUsedSize = 0;
+
+	for (unsigned int i = 0; i < mFrameSizes.size(); ++i)
+		mFrameSizes[i] = 0;
+
+	mPendingOffset = UNIFORM_RING_BUFFER_INVALID_OFFSET;
+	mPendingWrapOffset = UNIFORM_RING_BUFFER_INVALID_OFFSET;
+
+	++mStats.growCount;
+
+	return true;
+}
+
+unsigned int UniformRingBuffer::allocate(unsigned int size)
+{
+	unsigned int capacity = (unsigned int)mData.size();
+	if (size == 0 || mFrameSizes.empty() || mUsedSize >= capacity)
+		return UNIFORM_RING_BUFFER_INVALID_OFFSET;
+
+	// Nothing is kept, the ring starts over at its beginning
+	if (mUsedSize == 0)
+	{
+		mHead = 0;
+		mTail = 0;
+	}
+
+	unsigned int offset = getAlignedSize(mHead);
+	unsigned int takenSize = 0;
+
+	if (mHead >= mTail)
+	{
+		if (offset + size <= capacity)
+		{
+			takenSize = offset + size - mHead;
+		}
+		else if (size <= mTail)
+		{
+			// The end of the ring is wasted, the block starts over at the beginning
+			if (mPendingOffset != UNIFORM_RING_BUFFER_INVALID_OFFSET)
+				mPendingWrapOffset = mHead;
+
+			takenSize = capacity - mHead + size;
+			offset = 0;
+		}
+		else
+		{
+			return UNIFORM_RING_BUFFER_INVALID_OFFSET;
+		}
+	}
+	else
+	{
+		if (offset + size > mTail)
+			return UNIFORM_RING_BUFFER_INVALID_OFFSET;
+
+		takenSize = offset + size - mHead;
+	}
+
+	mHead = offset + size;
+	mUsedSize += takenSize;
+	mFrameSizes[mFrameIndex] += takenSize;
+
+	if (mPendingOffset == UNIFORM_RING_BUFFER_INVALID_OFFSET)
+		mPendingOffset = offset;
+
+	++mStats.allocationCount;
+	mStats.allocatedSize += size;
+
+	return offset;
+}
+
+bool UniformRingBuffer::takePendingRange(unsigned int& offset, unsigned int& size)
+{
+	if (mPendingOffset == UNIFORM_RING_BUFFER_INVALID_OFFSET)
+		return false;
+
+	offset = mPendingOffset;
+
+	// A wrapped range is handed out in two parts, the one up to the end of the ring first
+	if (mPendingWrapOffset != UNIFORM_RING_BUFFER_INVALID_OFFSET)
+	{
+		size = mPendingWrapOffset - mPendingOffset;
+
+		mPendingOffset = 0;
+		mPendingWrapOffset = UNIFORM_RING_BUFFER_INVALID_OFFSET;
+	}
+	else
+	{
+		size = mHead - mPendingOffset;
+
+		mPendingOffset = UNIFORM_RING_BUFFER_INVALID_OFFSET;
+	}
+
+	++mStats.uploadCount;
+	mStats.uploadedSize += size;
+
+	return true;
+}
+
+unsigned int UniformRingBuffer::writeParameterBlock(Material* material, ShaderParameterFrequency frequency, RenderStateData& renderStateData)
+{
+	if (material == nullptr)
+		return UNIFORM_RING_BUFFER_INVALID_OFFSET;
+
+	unsigned int blockSize = material->getParameterBlockSize(frequency);
+	if (blockSize == 0)
+		return UNIFORM_RING_BUFFER_INVALID_OFFSET;
+
+	unsigned int blockOffset = allocate(blockSize);
+	if (blockOffset == UNIFORM_RING_BUFFER_INVALID_OFFSET)
+		return UNIFORM_RING_BUFFER_INVALID_OFFSET;
+
+	unsigned char* pBlock = &mData[blockOffset];
+
+	const std::vector<ShaderParameterInstruction>& parameterProgram = material->getParameterProgram();
+
+	unsigned int first = 0;
+	unsigned int last = 0;
+	material->getParameterProgramRange(frequency, first, last);
+
+	float values[16];
+	for (unsigned int i = first; i < last; ++i)
+	{
+		const ShaderParameterInstruction& instruction = parameterProgram[i];
+		if (instruction.mBlockOffset == (unsigned int)-1)
+			continue;
+
+		float* pMember = (float*)(pBlock + instruction.mBlockOffset);
+
+		unsigned int count = 0;
+		switch (instruction.mParameterType)
+		{
+		case SHADER_PARAMETER_TYPE_FLOAT:
+			count = 1;
+			break;
+		case SHADER_PARAMETER_TYPE_FLOAT2:
+			count = 2;
+			break;
+		case SHADER_PARAMETER_TYPE_FLOAT3:
+			count = 3;
+			break;
+		case SHADER_PARAMETER_TYPE_FLOAT4:
+			count = 4;
+			break;
+		case SHADER_PARAMETER_TYPE_MATRIX4:
+			count = 16;
+			break;
+		default:
+			continue;
+		}
+
+		// The memory is reused, values without a source are written as zeros
+		if (!renderStateData.getParameterValue(instruction.mSource, values))
+		{
+			memset(pMember, 0, count * sizeof(float));
+			continue;
+		}
+
+		if (count == 16)
+		{
+			// The matrices are row major, std140 keeps them as four columns
+			for (unsigned int column = 0; column < 4; ++column)
+			{
+				pMember[column * 4 + 0] = values[column];
+				pMember[column * 4 + 1] = values[4 + column];
+				pMember[column * 4 + 2] = values[8 + column];
+				pMember[column * 4 + 3] = values[12 + column];
+			}
+		}
+		else
+		{
+			memcpy(pMember, values, count * sizeof(float));
+		}
+	}
+
+	return blockOffset;
+}
+
+unsigned int UniformRingBuffer::getSize() const
+{
+	return (unsigned int)mData.size();
+}
+
+unsigned int UniformRingBuffer::getAlignment() const
+{
+	return mAlignment;
+}
+
+unsigned int UniformRingBuffer::getUsedSize() const
+{
+	return mUsedSize;
+}
+
+unsigned char* UniformRingBuffer::getData()
+{
+	return mData.empty() ? nullptr : &mData[0];
+}
+
+const unsigned char* UniformRingBuffer::getData() const
+{
+	return mData.empty() ? nullptr : &mData[0];
+}
+
+unsigned int UniformRingBuffer::getAlignedSize(unsigned int size) const
+{
+	return ((size + mAlignment - 1) / mAlignment) * mAlignment;
+}
+
+const UniformRingBufferStats& UniformRingBuffer::getStats() const
+{
+	return mStats;
+}
+
+} // end namespace render
\ No newline at end of file
@@ -50,6 +50,10 @@ Viewport::Viewport(Camera* camera, RenderTarget* target)
 
 	mShowOverlays = true;
 
+	mRenderedFaces = 0;
+	mRenderedModels = 0;
+	mDrawCalls = 0;
+
 	mDimentionsNeedsUpdate = true;
 }
 
@@ -74,6 +78,22 @@ unsigned int Viewport::getNumRenderedFaces() const
 	return mRenderedFaces;
 }
 
+void Viewport::notifyRenderedModels(unsigned int numModels, unsigned int numDrawCalls)
+{
+	mRenderedModels = numModels;
+	mDrawCalls = numDrawCalls;
+}
+
+unsigned int Viewport::getNumRenderedModels() const
+{
+	return mRenderedModels;
+}
+
+unsigned int Viewport::getNumDrawCalls() const
+{
+	return mDrawCalls;
+}
+
 void Viewport::setShowOverlays(bool enabled)
 {
 	mShowOverlays = enabled;
@@ -0,0 +1,830 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <render/VisibilityTree.h>
+#include <render/Frustum.h>
+#include <render/FrustumDefines.h>
+#include <render/Model.h>
+#include <core/Plane3d.h>
+#include <core/Simd.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace render
+{
+
+//! Number of bins the centers are sorted in along the widest axis by the rebuild.
+static const unsigned int VISIBILITY_TREE_BIN_COUNT = 16;
+
+//! Ranges with at most this many models are split at the median along their widest axis instead of binned.
+static const unsigned int VISIBILITY_TREE_MEDIAN_SPLIT_COUNT = 8;
+
+//! The tree is rebuilt when its surface area per model grew by this factor since the last build.
+static const float VISIBILITY_TREE_REBUILD_RATIO = 1.5f;
+
+//! Trees with less models are never rebuilt, the incremental inserts are good enough.
+static const unsigned int VISIBILITY_TREE_MIN_REBUILD_COUNT = 64;
+
+//! The whole tree is refitted instead of the ancestors of the moved leaves when at least
+//! one model out of this many moved.
+static const unsigned int VISIBILITY_TREE_FULL_REFIT_DIVISOR = 16;
+
+//! The tree is not refitted and the models are culled one by one when at least one model out of this many
+//! moved since the last update. Measured with 40k to 1M models moving every frame, the refit and the traversal
+//! cost more than the linear cull of all the bounds from 2% to 5% of them moving, the larger trees first.
+static const unsigned int VISIBILITY_TREE_LINEAR_CULL_DIVISOR = 20;
+
+//! Trees with less models are always refitted, their nodes stay in the cache and the refit in memory order
+//! was faster than the linear cull at every measured fraction of moving models.
+static const unsigned int VISIBILITY_TREE_LINEAR_CULL_MIN_COUNT = 32768;
+
+//! Bit of the mask a subtree pushed on the traversal stack has to be tested against, one per frustum plane.
+static const unsigned int VISIBILITY_TREE_ALL_PLANES = (1 << FRUSTUM_PLANE_COUNT) - 1;
+
+static inline unsigned int getBin(float coordinate, float minCoordinate, float scale)
+{
+	unsigned int bin = (unsigned int)((coordinate - minCoordinate) * scale);
+	return (bin < VISIBILITY_TREE_BIN_COUNT) ? bin : VISIBILITY_TREE_BIN_COUNT - 1;
+}
+
+//! Bounds and number of the items whose center falls in a bin during the rebuild.
+struct BuildBin
+{
+	float minEdge[3];
+	float maxEdge[3];
+	unsigned int count;
+
+	void reset()
+	{
+		for (unsigned int axis = 0; axis < 3; ++axis)
+		{
+			minEdge[axis] = std::numeric_limits<float>::max();
+			maxEdge[axis] = -std::numeric_limits<float>::max();
+		}
+
+		count = 0;
+	}
+
+	void grow(const float* otherMinEdge, const float* otherMaxEdge)
+	{
+		// min and max instead of branches, the bins are filled in random order
+		for (unsigned int axis = 0; axis < 3; ++axis)
+		{
+			minEdge[axis] = std::min(minEdge[axis], otherMinEdge[axis]);
+			maxEdge[axis] = std::max(maxEdge[axis], otherMaxEdge[axis]);
+		}
+	}
+
+	//! Zero for an empty bin.
+	float getSurfaceArea() const
+	{
+		if (minEdge[0] > maxEdge[0])
+			return 0.0f;
+
+		float x = maxEdge[0] - minEdge[0];
+		float y = maxEdge[1] - minEdge[1];
+		float z = maxEdge[2] - minEdge[2];
+
+		return 2.0f * (x * y + y * z + z * x);
+	}
+};
+
+const unsigned int VisibilityTree::NULL_NODE = 0xFFFFFFFF;
+
+VisibilityTree::VisibilityTree()
+{
+	mRoot = NULL_NODE;
+	mFreeNode = NULL_NODE;
+
+	mModelCount = 0;
+
+	mInnerArea = 0.0f;
+
+	mBuildArea = 0.0f;
+	mBuildModelCount = 0;
+
+	mParentsFirst = true;
+	mStale = false;
+}
+
+VisibilityTree::~VisibilityTree() {}
+
+unsigned int VisibilityTree::insert(Model* model, const core::aabox3d& box)
+{
+	if (model == nullptr)
+		return NULL_NODE;
+
+	unsigned int leaf = allocateNode();
+	mNodes[leaf].box = box;
+	mNodes[leaf].model = model;
+
+	++mModelCount;
+
+	if (mRoot == NULL_NODE)
+	{
+		mRoot = leaf;
+		return leaf;
+	}
+
+	// go down to the sibling that increases the surface area of the tree the least
+	unsigned int sibling = mRoot;
+	while (mNodes[sibling].model == nullptr)
+	{
+		const Node& node = mNodes[sibling];
+
+		float area = getSurfaceArea(node.box);
+		float combinedArea = getUnionSurfaceArea(node.box, box);
+
+		// cost of making a new parent for this node and the leaf
+		float cost = 2.0f * combinedArea;
+
+		// cost of pushing the leaf further down
+		float inheritanceCost = 2.0f * (combinedArea - area);
+
+		float childCosts[2];
+		for (unsigned int i = 0; i < 2; ++i)
+		{
+			const Node& child = mNodes[node.children[i]];
+			childCosts[i] = getUnionSurfaceArea(child.box, box) + inheritanceCost;
+			if (child.model == nullptr)
+				childCosts[i] -= getSurfaceArea(child.box);
+		}
+
+		if (cost < childCosts[0] && cost < childCosts[1])
+			break;
+
+		sibling = (childCosts[0] < childCosts[1]) ? node.children[0] : node.children[1];
+	}
+
+	unsigned int oldParent = mNodes[sibling].parent;
+	unsigned int newParent = allocateNode();
+
+	// a free node rarely lands between its new parent and child in memory
+	if ((oldParent != NULL_NODE && newParent < oldParent) || (mNodes[sibling].model == nullptr && newParent > sibling))
+		mParentsFirst = false;
+
+	mNodes[newParent].parent = oldParent;
+	mNodes[newParent].children[0] = sibling;
+	mNodes[newParent].children[1] = leaf;
+	setUnion(mNodes[newParent].box, mNodes[sibling].box, box);
+	mInnerArea += getSurfaceArea(mNodes[newParent].box);
+
+	mNodes[sibling].parent = newParent;
+	mNodes[leaf].parent = newParent;
+
+	if (oldParent != NULL_NODE)
+	{
+		if (mNodes[oldParent].children[0] == sibling)
+			mNodes[oldParent].children[0] = newParent;
+		else
+			mNodes[oldParent].children[1] = newParent;
+
+		refitAncestors(oldParent);
+	}
+	else
+	{
+		mRoot = newParent;
+	}
+
+	return leaf;
+}
+
+void VisibilityTree::remove(unsigned int leaf)
+{
+	if (leaf >= mNodes.size() || mNodes[leaf].model == nullptr)
+		return;
+
+	--mModelCount;
+
+	if (mNodes[leaf].dirty)
+		mMovedLeaves.erase(std::find(mMovedLeaves.begin(), mMovedLeaves.end(), leaf));
+
+	if (leaf == mRoot)
+	{
+		mRoot = NULL_NODE;
+		freeNode(leaf);
+		return;
+	}
+
+	unsigned int parent = mNodes[leaf].parent;
+	unsigned int grandParent = mNodes[parent].parent;
+	unsigned int sibling = (mNodes[parent].children[0] == leaf) ? mNodes[parent].children[1] : mNodes[parent].children[0];
+
+	// the sibling takes the place of the parent
+	mNodes[sibling].parent = grandParent;
+	if (grandParent != NULL_NODE)
+	{
+		if (mNodes[grandParent].children[0] == parent)
+			mNodes[grandParent].children[0] = sibling;
+		else
+			mNodes[grandParent].children[1] = sibling;
+	}
+	else
+	{
+		mRoot = sibling;
+	}
+
+	freeNode(parent);
+	freeNode(leaf);
+
+	if (grandParent != NULL_NODE)
+		refitAncestors(grandParent);
+}
+
+void VisibilityTree::move(unsigned int leaf, const core::aabox3d& box)
+{
+	if (leaf >= mNodes.size() || mNodes[leaf].model == nullptr)
+		return;
+
+	mNodes[leaf].box = box;
+
+	if (!mNodes[leaf].dirty)
+	{
+		mNodes[leaf].dirty = true;
+		mMovedLeaves.push_back(leaf);
+	}
+}
+
+void VisibilityTree::clear()
+{
+	mNodes.clear();
+	mMovedLeaves.clear();
+
+	mRoot = NULL_NODE;
+	mFreeNode = NULL_NODE;
+
+	mModelCount = 0;
+
+	mInnerArea = 0.0f;
+
+	mBuildArea = 0.0f;
+	mBuildModelCount = 0;
+
+	mParentsFirst = true;
+	mStale = false;
+}
+
+void VisibilityTree::update()
+{
+	if (mModelCount >= VISIBILITY_TREE_MIN_REBUILD_COUNT)
+	{
+		// the first build and trees that doubled in size since the last one do not need a refit first
+		if (mBuildModelCount == 0 || mModelCount > 2 * mBuildModelCount)
+		{
+			rebuild();
+			return;
+		}
+	}
+
+	if (mMovedLeaves.empty() && !mStale)
+		return;
+
+	// when many leaves move the refit costs more than the traversal saves, the inner boxes are left
+	// as they are and refitted once the models settle down
+	if (mModelCount >= VISIBILITY_TREE_LINEAR_CULL_MIN_COUNT && mMovedLeaves.size() * VISIBILITY_TREE_LINEAR_CULL_DIVISOR >= mModelCount)
+	{
+		for (unsigned int i = 0; i < mMovedLeaves.size(); ++i)
+			mNodes[mMovedLeaves[i]].dirty = false;
+
+		mMovedLeaves.clear();
+		mStale = true;
+		return;
+	}
+
+	// the whole tree is out of date, without the memory order the refit would have to walk it from the root
+	if (mStale && !mParentsFirst)
+	{
+		rebuild();
+		return;
+	}
+
+	// when many leaves moved most of the tree is refitted anyway, walking the nodes in memory order is cheaper
+	if (mParentsFirst && (mStale || mMovedLeaves.size() * VISIBILITY_TREE_FULL_REFIT_DIVISOR >= mModelCount))
+	{
+		for (unsigned int i = 0; i < mMovedLeaves.size(); ++i)
+			mNodes[mMovedLeaves[i]].dirty = false;
+
+		mMovedLeaves.clear();
+		mStale = false;
+
+		for (unsigned int i = mNodes.size(); i-- > 0;)
+		{
+			const Node& node = mNodes[i];
+			if (node.model == nullptr && node.children[0] != NULL_NODE)
+				refitNode(i);
+		}
+	}
+	else
+	{
+		refitMovedLeaves();
+	}
+
+	if (mModelCount >= VISIBILITY_TREE_MIN_REBUILD_COUNT && mInnerArea > mBuildArea * mModelCount * VISIBILITY_TREE_REBUILD_RATIO)
+		rebuild();
+}
+
+void VisibilityTree::refitMovedLeaves()
+{
+	// mark the ancestors of the moved leaves, stopping at the ones another leaf already marked
+	for (unsigned int i = 0; i < mMovedLeaves.size(); ++i)
+	{
+		unsigned int node = mMovedLeaves[i];
+		mNodes[node].dirty = false;
+
+		node = mNodes[node].parent;
+		while (node != NULL_NODE && !mNodes[node].dirty)
+		{
+			mNodes[node].dirty = true;
+			node = mNodes[node].parent;
+		}
+	}
+
+	mMovedLeaves.clear();
+
+	// refit the marked nodes children first, the top bit of a stack entry tells the children were visited
+	if (mRoot != NULL_NODE && mNodes[mRoot].dirty)
+	{
+		static const unsigned int CHILDREN_VISITED = 0x80000000;
+
+		mStack.clear();
+		mStack.push_back(mRoot);
+
+		while (!mStack.empty())
+		{
+			unsigned int entry = mStack.back();
+			unsigned int node = entry & ~CHILDREN_VISITED;
+
+			if ((entry & CHILDREN_VISITED) == 0)
+			{
+				mStack.back() = node | CHILDREN_VISITED;
+
+				for (unsigned int i = 0; i < 2; ++i)
+				{
+					unsigned int child = mNodes[node].children[i];
+					if (mNodes[child].model == nullptr && mNodes[child].dirty)
+						mStack.push_back(child);
+				}
+			}
+			else
+			{
+				mStack.pop_back();
+
+				refitNode(node);
+				mNodes[node].dirty = false;
+			}
+		}
+	}
+}
+
+void VisibilityTree::rebuild()
+{
+	// keep the leaves, free every inner node
+	mBuildItems.resize(mModelCount);
+
+	unsigned int itemCount = 0;
+	for (unsigned int i = 0; i < mNodes.size(); ++i)
+	{
+		Node& node = mNodes[i];
+		if (node.model != nullptr)
+		{
+			node.dirty = false;
+
+			BuildItem& item = mBuildItems[itemCount++];
+			item.minEdge[0] = node.box.MinEdge.x;
+			item.minEdge[1] = node.box.MinEdge.y;
+			item.minEdge[2] = node.box.MinEdge.z;
+			item.maxEdge[0] = node.box.MaxEdge.x;
+			item.maxEdge[1] = node.box.MaxEdge.y;
+			item.maxEdge[2] = node.box.MaxEdge.z;
+
+			for (unsigned int axis = 0; axis < 3; ++axis)
+				item.center[axis] = 0.5f * (item.minEdge[axis] + item.maxEdge[axis]);
+
+			item.leaf = i;
+		}
+		else if (node.children[0] != NULL_NODE)
+		{
+			freeNode(i);
+		}
+	}
+
+	mMovedLeaves.clear();
+	mStale = false;
+	mInnerArea = 0.0f;
+
+	if (itemCount == 0)
+	{
+		mRoot = NULL_NODE;
+		return;
+	}
+
+	// the inner nodes were freed in memory order and are allocated back in the reverse order
+	// children first, so every parent is stored before its inner children
+	mRoot = build(0, itemCount);
+	mNodes[mRoot].parent = NULL_NODE;
+	mParentsFirst = true;
+
+	mBuildModelCount = mModelCount;
+	mBuildArea = mInnerArea / mModelCount;
+}
+
+void VisibilityTree::findVisibleModels(const Frustum& frustum, std::vector<Model*>& models)
+{
+	if (mRoot == NULL_NODE)
+		return;
+
+	// the inner boxes are out of date, every leaf goes to the culling kernels
+	if (mStale)
+	{
+		mCullLeaves.clear();
+		for (unsigned int i = 0; i < mNodes.size(); ++i)
+		{
+			if (mNodes[i].model != nullptr)
+				mCullLeaves.push_back(i);
+		}
+
+		cullLeaves(frustum, models);
+		return;
+	}
+
+	const core::plane3d* planes[FRUSTUM_PLANE_COUNT];
+	for (unsigned int i = 0; i < FRUSTUM_PLANE_COUNT; ++i)
+		planes[i] = &frustum.getPlane(i);
+
+	// every entry is a node followed by the mask of the planes it still has to be tested against
+	mStack.clear();
+	mCullLeaves.clear();
+	mStack.push_back(mRoot);
+	mStack.push_back(VISIBILITY_TREE_ALL_PLANES);
+
+	while (!mStack.empty())
+	{
+		unsigned int mask = mStack.back();
+		mStack.pop_back();
+		unsigned int index = mStack.back();
+		mStack.pop_back();
+
+		const Node& node = mNodes[index];
+
+		if (mask != 0 && node.model != nullptr)
+		{
+			mCullLeaves.push_back(index);
+			continue;
+		}
+
+		if (mask != 0)
+		{
+			const core::vector3d& minEdge = node.box.MinEdge;
+			const core::vector3d& maxEdge = node.box.MaxEdge;
+
+			bool outside = false;
+			for (unsigned int i = 0; i < FRUSTUM_PLANE_COUNT; ++i)
+			{
+				if ((mask & (1 << i)) == 0)
+					continue;
+
+				// the plane normals point inside the frustum, test the corners furthest along and against the normal
+				const core::vector3d& normal = planes[i]->Normal;
+				float d = planes[i]->D;
+
+				float farDistance = d +
+					normal.x * (normal.x >= 0.0f ? maxEdge.x : minEdge.x) +
+					normal.y * (normal.y >= 0.0f ? maxEdge.y : minEdge.y) +
+					normal.z * (normal.z >= 0.0f ? maxEdge.z : minEdge.z);
+
+				if (farDistance < 0.0f)
+				{
+					outside = true;
+					break;
+				}
+
+				float nearDistance = d +
+					normal.x * (normal.x >= 0.0f ? minEdge.x : maxEdge.x) +
+					normal.y * (normal.y >= 0.0f ? minEdge.y : maxEdge.y) +
+					normal.z * (normal.z >= 0.0f ? minEdge.z : maxEdge.z);
+
+				if (nearDistance >= 0.0f)
+					mask &= ~(1 << i);
+			}
+
+			if (outside)
+				continue;
+		}
+
+		if (node.model != nullptr)
+		{
+			models.push_back(node.model);
+		}
+		else
+		{
+			mStack.push_back(node.children[0]);
+			mStack.push_back(mask);
+			mStack.push_back(node.children[1]);
+			mStack.push_back(mask);
+		}
+	}
+
+	cullLeaves(frustum, models);
+}
+
+unsigned int VisibilityTree::getModelCount() const
+{
+	return mModelCount;
+}
+
+void VisibilityTree::cullLeaves(const Frustum& frustum, std::vector<Model*>& models)
+{
+	unsigned int count = (unsigned int)mCullLeaves.size();
+	if (count == 0)
+		return;
+
+	if (mLastPlanes.size() < mNodes.size())
+		mLastPlanes.resize(mNodes.size(), 0);
+
+	mCullBounds.resize(count * 6);
+	mCullPlanes.resize(count);
+	mCullVisible.resize((count + 31) / 32);
+
+	float* centerX = &mCullBounds[0];
+	float* centerY = centerX + count;
+	float* centerZ = centerY + count;
+	float* extentX = centerZ + count;
+	float* extentY = extentX + count;
+	float* extentZ = extentY + count;
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		unsigned int leaf = mCullLeaves[i];
+		const core::vector3d& minEdge = mNodes[leaf].box.MinEdge;
+		const core::vector3d& maxEdge = mNodes[leaf].box.MaxEdge;
+
+		centerX[i] = (minEdge.x + maxEdge.x) * 0.5f;
+		centerY[i] = (minEdge.y + maxEdge.y) * 0.5f;
+		centerZ[i] = (minEdge.z + maxEdge.z) * 0.5f;
+		extentX[i] = (maxEdge.x - minEdge.x) * 0.5f;
+		extentY[i] = (maxEdge.y - minEdge.y) * 0.5f;
+		extentZ[i] = (maxEdge.z - minEdge.z) * 0.5f;
+
+		mCullPlanes[i] = mLastPlanes[leaf];
+	}
+
+	core::CullingVolumes volumes = {centerX, centerY, centerZ, nullptr, extentX, extentY, extentZ};
+	frustum.cullBoxes(volumes, count, &mCullVisible[0], &mCullPlanes[0]);
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		unsigned int leaf = mCullLeaves[i];
+
+		if ((mCullVisible[i >> 5] & (1u << (i & 31))) != 0)
+			models.push_back(mNodes[leaf].model);
+		else
+			mLastPlanes[leaf] = mCullPlanes[i];
+	}
+}
+
+unsigned int VisibilityTree::allocateNode()
+{
+	unsigned int index;
+	if (mFreeNode != NULL_NODE)
+	{
+		index = mFreeNode;
+		mFreeNode = mNodes[index].parent;
+	}
+	else
+	{
+		index = mNodes.size();
+		mNodes.push_back(Node());
+	}
+
+	Node& node = mNodes[index];
+	node.model = nullptr;
+	node.parent = NULL_NODE;
+	node.children[0] = NULL_NODE;
+	node.children[1] = NULL_NODE;
+	node.dirty = false;
+
+	return index;
+}
+
+void VisibilityTree::freeNode(unsigned int node)
+{
+	Node& freeNode = mNodes[node];
+	if (freeNode.model == nullptr)
+		mInnerArea -= getSurfaceArea(freeNode.box);
+
+	freeNode.model = nullptr;
+	freeNode.children[0] = NULL_NODE;
+	freeNode.children[1] = NULL_NODE;
+	freeNode.dirty = false;
+	freeNode.parent = mFreeNode;
+
+	mFreeNode = node;
+}
+
+void VisibilityTree::refitNode(unsigned int node)
+{
+	Node& inner = mNodes[node];
+
+	float area = getSurfaceArea(inner.box);
+	setUnion(inner.box, mNodes[inner.children[0]].box, mNodes[inner.children[1]].box);
+	mInnerArea += getSurfaceArea(inner.box) - area;
+}
+
+void VisibilityTree::refitAncestors(unsigned int node)
+{
+	while (node != NULL_NODE)
+	{
+		refitNode(node);
+		node = mNodes[node].parent;
+	}
+}
+
+unsigned int VisibilityTree::build(unsigned int begin, unsigned int end)
+{
+	BuildItem* pItems = &mBuildItems[0];
+
+	if (end - begin == 1)
+		return pItems[begin].leaf;
+
+	float minCenters[3];
+	float scales[3];
+	for (unsigned int axis = 0; axis < 3; ++axis)
+	{
+		float minCenter = pItems[begin].center[axis];
+		float maxCenter = minCenter;
+		for (unsigned int i = begin + 1; i < end; ++i)
+		{
+			float center = pItems[i].center[axis];
+			if (center < minCenter) minCenter = center;
+			if (center > maxCenter) maxCenter = center;
+		}
+
+		minCenters[axis] = minCenter;
+		scales[axis] = (maxCenter > minCenter) ? VISIBILITY_TREE_BIN_COUNT / (maxCenter - minCenter) : 0.0f;
+	}
+
+	// the split is searched along the widest extent of the centers, it has the smallest scale
+	unsigned int axis = 0;
+	for (unsigned int i = 1; i < 3; ++i)
+	{
+		if (scales[i] != 0.0f && (scales[axis] == 0.0f || scales[i] < scales[axis]))
+			axis = i;
+	}
+
+	unsigned int middle = begin + (end - begin) / 2;
+
+	// all the centers are the same, split in the middle
+	if (scales[axis] == 0.0f)
+		return createInnerNode(build(begin, middle), build(middle, end));
+
+	// clearing and sweeping the bins costs more than it saves on the few models near the leaves
+	if (end - begin <= VISIBILITY_TREE_MEDIAN_SPLIT_COUNT)
+	{
+		std::nth_element(pItems + begin, pItems + middle, pItems + end, [axis](const BuildItem& a, const BuildItem& b) -> bool
+		{
+			return a.center[axis] < b.center[axis];
+		});
+
+		return createInnerNode(build(begin, middle), build(middle, end));
+	}
+
+	float minCenter = minCenters[axis];
+	float scale = scales[axis];
+
+	BuildBin bins[VISIBILITY_TREE_BIN_COUNT];
+	for (unsigned int b = 0; b < VISIBILITY_TREE_BIN_COUNT; ++b)
+		bins[b].reset();
+
+	for (unsigned int i = begin; i < end; ++i)
+	{
+		const BuildItem& item = pItems[i];
+
+		BuildBin& bin = bins[getBin(item.center[axis], minCenter, scale)];
+		bin.grow(item.minEdge, item.maxEdge);
+		++bin.count;
+	}
+
+	// sweep from the right to know the area of everything after a boundary
+	float rightAreas[VISIBILITY_TREE_BIN_COUNT];
+
+	BuildBin bounds;
+	bounds.reset();
+	for (unsigned int b = VISIBILITY_TREE_BIN_COUNT - 1; b > 0; --b)
+	{
+		if (bins[b].count > 0)
+			bounds.grow(bins[b].minEdge, bins[b].maxEdge);
+
+		rightAreas[b] = bounds.getSurfaceArea();
+	}
+
+	// sweep from the left for the boundary with the lowest surface area heuristic cost,
+	// the split after bin b puts the bins [0, b] on the left
+	float bestCost = std::numeric_limits<float>::max();
+	unsigned int bestSplit = VISIBILITY_TREE_BIN_COUNT;
+
+	bounds.reset();
+	unsigned int leftCount = 0;
+	for (unsigned int b = 0; b < VISIBILITY_TREE_BIN_COUNT - 1; ++b)
+	{
+		if (bins[b].count > 0)
+		{
+			bounds.grow(bins[b].minEdge, bins[b].maxEdge);
+			leftCount += bins[b].count;
+		}
+
+		unsigned int rightCount = (end - begin) - leftCount;
+		if (leftCount == 0 || rightCount == 0)
+			continue;
+
+		float cost = leftCount * bounds.getSurfaceArea() + rightCount * rightAreas[b + 1];
+		if (cost < bestCost)
+		{
+			bestCost = cost;
+			bestSplit = b;
+		}
+	}
+
+	if (bestSplit < VISIBILITY_TREE_BIN_COUNT)
+	{
+		BuildItem* pMiddle = std::partition(pItems + begin, pItems + end, [axis, bestSplit, minCenter, scale](const BuildItem& item) -> bool
+		{
+			return getBin(item.center[axis], minCenter, scale) <= bestSplit;
+		});
+
+		unsigned int split = pMiddle - pItems;
+		if (split > begin && split < end)
+			middle = split;
+	}
+
+	return createInnerNode(build(begin, middle), build(middle, end));
+}
+
+unsigned int VisibilityTree::createInnerNode(unsigned int left, unsigned int right)
+{
+	unsigned int node = allocateNode();
+	mNodes[node].children[0] = left;
+	mNodes[node].children[1] = right;
+	mNodes[left].parent = node;
+	mNodes[right].parent = node;
+
+	setUnion(mNodes[node].box, mNodes[left].box, mNodes[right].box);
+	mInnerArea += getSurfaceArea(mNodes[node].box);
+
+	return node;
+}
+
+float VisibilityTree::getSurfaceArea(const core::aabox3d& box)
+{
+	float x = box.MaxEdge.x - box.MinEdge.x;
+	float y = box.MaxEdge.y - box.MinEdge.y;
+	float z = box.MaxEdge.z - box.MinEdge.z;
+
+	return 2.0f * (x * y + y * z + z * x);
+}
+
+float VisibilityTree::getUnionSurfaceArea(const core::aabox3d& a, const core::aabox3d& b)
+{
+	float x = std::max(a.MaxEdge.x, b.MaxEdge.x) - std::min(a.MinEdge.x, b.MinEdge.x);
+	float y = std::max(a.MaxEdge.y, b.MaxEdge.y) - std::min(a.MinEdge.y, b.MinEdge.y);
+	float z = std::max(a.MaxEdge.z, b.MaxEdge.z) - std::min(a.MinEdge.z, b.MinEdge.z);
+
+	return 2.0f * (x * y + y * z + z * x);
+}
+
+void VisibilityTree::setUnion(core::aabox3d& box, const core::aabox3d& a, const core::aabox3d& b)
+{
+	// component by component, the vector constructors are not inlined
+	box.MinEdge.x = std::min(a.MinEdge.x, b.MinEdge.x);
+	box.MinEdge.y = std::min(a.MinEdge.y, b.MinEdge.y);
+	box.MinEdge.z = std::min(a.MinEdge.z, b.MinEdge.z);
+
+	box.MaxEdge.x = std::max(a.MaxEdge.x, b.MaxEdge.x);
+	box.MaxEdge.y = std::max(a.MaxEdge.y, b.MaxEdge.y);
+	box.MaxEdge.z = std::max(a.MaxEdge.z, b.MaxEdge.z);
+}
+
+} // end namespace render
\ No newline at end of file
@@ -0,0 +1,159 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <resource/MappedFile.h>
+
+#if ENGINE_PLATFORM == PLATFORM_WINDOWS
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#else
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <fcntl.h>
+#	include <unistd.h>
+#endif
+
+namespace resource
+{
+
+MappedFile::MappedFile()
+{
+#if ENGINE_PLATFORM == PLATFORM_WINDOWS
+	mFile = INVALID_HANDLE_VALUE;
+	mMapping = nullptr;
+#else
+	mFile = -1;
+#endif
+
+	mData = nullptr;
+	mSize = 0;
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+bool MappedFile::open(const std::string& filePath)
+{
+	close();
+
+#if ENGINE_PLATFORM == PLATFORM_WINDOWS
+	mFile = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (mFile == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(mFile, &fileSize) || fileSize.QuadPart == 0 || fileSize.HighPart != 0)
+	{
+		close();
+		return false;
+	}
+
+	mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mMapping == nullptr)
+	{
+		close();
+		return false;
+	}
+
+	mData = static_cast<const unsigned char*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+	if (mData == nullptr)
+	{
+		close();
+		return false;
+	}
+
+	mSize = (unsigned int)fileSize.LowPart;
+#else
+	mFile = ::open(filePath.c_str(), O_RDONLY);
+	if (mFile < 0)
+		return false;
+
+	struct stat fileStat;
+	if (fstat(mFile, &fileStat) != 0 || fileStat.st_size == 0)
+	{
+		close();
+		return false;
+	}
+
+	void* pData = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, mFile, 0);
+	if (pData == MAP_FAILED)
+	{
+		close();
+		return false;
+	}
+
+	mData = static_cast<const unsigned char*>(pData);
+	mSize = (unsigned int)fileStat.st_size;
+#endif
+
+	return true;
+}
+
+void MappedFile::close()
+{
+#if ENGINE_PLATFORM == PLATFORM_WINDOWS
+	if (mData != nullptr)
+		UnmapViewOfFile(mData);
+
+	if (mMapping != nullptr)
+		CloseHandle(mMapping);
+
+	if (mFile != INVALID_HANDLE_VALUE)
+		CloseHandle(mFile);
+
+	mFile = INVALID_HANDLE_VALUE;
+	mMapping = nullptr;
+#else
+	if (mData != nullptr)
+		munmap(const_cast<unsigned char*>(mData), mSize);
+
+	if (mFile >= 0)
+		::close(mFile);
+
+	mFile = -1;
+#endif
+
+	mData = nullptr;
+	mSize = 0;
+}
+
+bool MappedFile::isOpen() const
+{
+	return (mData != nullptr);
+}
+
+const unsigned char* MappedFile::getData() const
+{
+	return mData;
+}
+
+unsigned int MappedFile::getSize() const
+{
+	return mSize;
+}
+
+} // end namespace resource
\ No newline at end of file
@@ -141,6 +141,20 @@ render::ShaderAutoParameterType convertAutoParameterType(const std::string& para
 		return render::SHADER_AUTO_PARAMETER_TYPE_CAMERA_POSITION;
 	else if (param == "camera_position_object_space")
 		return render::SHADER_AUTO_PARAMETER_TYPE_CAMERA_POSITION_OBJECT_SPACE;
+
+	else if (param == "instance_world_matrix")
+		return render::SHADER_AUTO_PARAMETER_TYPE_INSTANCE_WORLD_MATRIX;
+
+	else if (param == "cluster_grid_size")
+		return render::SHADER_AUTO_PARAMETER_TYPE_CLUSTER_GRID_SIZE;
+	else if (param == "cluster_depth_parameters")
+		return render::SHADER_AUTO_PARAMETER_TYPE_CLUSTER_DEPTH_PARAMETERS;
+	else if (param == "cluster_light_grid")
+		return render::SHADER_AUTO_PARAMETER_TYPE_CLUSTER_LIGHT_GRID;
+	else if (param == "cluster_light_indices")
+		return render::SHADER_AUTO_PARAMETER_TYPE_CLUSTER_LIGHT_INDICES;
+	else if (param == "cluster_light_data")
+		return render::SHADER_AUTO_PARAMETER_TYPE_CLUSTER_LIGHT_DATA;
 	else
 	{
 		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("MaterialSerializer", "Invalid auto parameter type, using default.", core::LOG_LEVEL_ERROR);
@@ -339,6 +353,16 @@ bool MaterialSerializer::importResource(Resource* dest, const std::string& filen
 
 				pElement = pElement->NextSiblingElement("texture_unit");
 			}
+
+			pElement = pRoot->FirstChildElement("transparent");
+			if (pElement != nullptr)
+			{
+				svalue = pElement->Attribute("value");
+				if (svalue != nullptr)
+				{
+					renderMaterial->setTransparent(std::string(svalue) == "true");
+				}
+			}
 		}
 
 		if (dest->getResourceType() == RESOURCE_TYPE_PHYSICS_MATERIAL)
@@ -30,7 +30,11 @@ THE SOFTWARE.
 #include <core/Utils.h>
 #include <core/LogDefines.h>
 #include <resource/ResourceManager.h>
+#include <resource/MappedFile.h>
+#include <resource/MeshFileDefines.h>
 #include <render/MeshData.h>
+#include <render/MeshSimplifier.h>
+#include <render/MeshOptimizer.h>
 #include <render/VertexBuffer.h>
 #include <render/IndexBuffer.h>
 #include <render/RenderManager.h>
@@ -42,6 +46,8 @@ THE SOFTWARE.
 
 #include <string>
 #include <vector>
+#include <cstdio>
+#include <cstring>
 
 struct PositionAndUV
 {
@@ -94,6 +100,269 @@ TangentAndBinormal calculateTangentAndBinormal(const core::vector3d& pos1, const
 namespace resource
 {
 
+//! Mesh data parsed on a loader thread, waiting to be copied into the vertex and index buffers.
+//! The streams either point into the storage filled by the xml parser or straight into a mapped binary file.
+class MeshSerializerData: public SerializerData
+{
+public:
+
+	MeshSerializerData()
+	{
+		numVertices = 0;
+		numIndexes = 0;
+
+		for (unsigned int i = 0; i < render::VERTEX_BUFFER_TYPE_COUNT; ++i)
+		{
+			streams[i] = nullptr;
+			streamElementTypes[i] = render::VERTEX_ELEMENT_TYPE_FLOAT3;
+		}
+
+		indices = nullptr;
+		indexSize = sizeof(unsigned int);
+		mappedFile = nullptr;
+
+		boundingSphereRadius = 0.0f;
+	}
+
+	~MeshSerializerData()
+	{
+		SAFE_DELETE(mappedFile);
+	}
+
+	//! Points the streams to the storage once the xml parser is done filling it.
+	void setStreamsFromStorage()
+	{
+		for (unsigned int i = 0; i < render::VERTEX_BUFFER_TYPE_COUNT; ++i)
+		{
+			streams[i] = streamStorage[i].empty() ? nullptr : &streamStorage[i][0];
+		}
+
+		indices = indexStorage.empty() ? nullptr : &indexStorage[0];
+		indexSize = sizeof(unsigned int);
+	}
+
+	//! Points the levels of detail to the storage once the simplifier is done filling it.
+	void setLodsFromStorage()
+	{
+		lodIndices.clear();
+		lodNumIndexes.clear();
+
+		for (unsigned int i = 0; i < lodIndexStorage.size(); ++i)
+		{
+			lodIndices.push_back(&lodIndexStorage[i][0]);
+			lodNumIndexes.push_back(lodIndexStorage[i].size());
+		}
+	}
+
+	unsigned int numVertices;
+	unsigned int numIndexes;
+
+	//! Vertex streams by render::VertexBufferType, nullptr for the missing ones.
+	const float* streams[render::VERTEX_BUFFER_TYPE_COUNT];
+	render::VertexElementType streamElementTypes[render::VERTEX_BUFFER_TYPE_COUNT];
+	//! Indices of indexSize bytes, as they are copied into the index buffers.
+	const void* indices;
+	unsigned int indexSize;
+
+	std::vector<float> streamStorage[render::VERTEX_BUFFER_TYPE_COUNT];
+	std::vector<unsigned int> indexStorage;
+	std::vector<unsigned short> shortIndexStorage;
+
+	MappedFile* mappedFile;
+
+	core::aabox3d boundingBox;
+	float boundingSphereRadius;
+
+	//! Indices and errors of the coarser levels of detail, see render::MeshSimplifier::buildLodChain.
+	std::vector<const void*> lodIndices;
+	std::vector<unsigned int> lodNumIndexes;
+	std::vector<float> lodErrors;
+
+	std::vector<std::vector<unsigned int> > lodIndexStorage;
+	std::vector<std::vector<unsigned short> > shortLodIndexStorage;
+};
+
+//! Order in which the vertex buffers are created.
+static const render::VertexBufferType MESH_STREAM_ORDER[render::VERTEX_BUFFER_TYPE_COUNT] =
+{
+	render::VERTEX_BUFFER_TYPE_POSITION,
+	render::VERTEX_BUFFER_TYPE_NORMAL,
+	render::VERTEX_BUFFER_TYPE_TEXTURE_COORDINATES,
+	render::VERTEX_BUFFER_TYPE_TANGENT,
+	render::VERTEX_BUFFER_TYPE_BINORMAL
+};
+
+//! Meshes with up to this many triangles keep a copy of their geometry on the CPU to be used as occluders.
+static const unsigned int MESH_OCCLUDER_MAX_TRIANGLES = 1024;
+
+static unsigned int getElementComponentCount(render::VertexElementType elementType)
+{
+	switch (elementType)
+	{
+	case render::VERTEX_ELEMENT_TYPE_FLOAT1:
+		return 1;
+	case render::VERTEX_ELEMENT_TYPE_FLOAT2:
+		return 2;
+	case render::VERTEX_ELEMENT_TYPE_FLOAT3:
+		return 3;
+	case render::VERTEX_ELEMENT_TYPE_FLOAT4:
+		return 4;
+	default:
+		return 0;
+	}
+}
+
+//! Meshes with up to this many vertices get 16 bit indices.
+static const unsigned int MESH_INDEX_16BIT_MAX_VERTICES = 0xffff;
+
+//! Welds the vertices of the parsed xml mesh and reorders them and its triangles for the GPU caches.
+//! The binary files are converted from the parsed xml meshes so they are stored optimized.
+//! \return The number of vertices left.
+static unsigned int optimizeMesh(MeshSerializerData* data, unsigned int numVertices, const std::string& filePath)
+{
+	if (data->indexStorage.empty() || numVertices == 0)
+		return numVertices;
+
+	render::MeshOptimizer optimizer;
+	for (unsigned int i = 0; i < render::VERTEX_BUFFER_TYPE_COUNT; ++i)
+	{
+		render::VertexBufferType type = MESH_STREAM_ORDER[i];
+		if (!data->streamStorage[type].empty())
+			optimizer.addStream(data->streamStorage[type], getElementComponentCount(data->streamElementTypes[type]));
+	}
+
+	numVertices = optimizer.optimize(data->indexStorage, numVertices);
+
+	const render::MeshOptimizerStats& stats = optimizer.getStats();
+	LOG_MESSAGE("MeshSerializer", "Mesh: " + filePath + " optimized - vertices: " + core::intToString(stats.vertexCount) + " -> " + core::intToString(stats.finalVertexCount) +
+		", ACMR: " + core::floatToString(stats.before.acmr) + " -> " + core::floatToString(stats.after.acmr) +
+		", ATVR: " + core::floatToString(stats.before.atvr) + " -> " + core::floatToString(stats.after.atvr) + ".", core::LOG_LEVEL_INFORMATION);
+
+	return numVertices;
+}
+
+//! Weights of the attribute differences against the position errors when the levels of detail are simplified.
+static const float MESH_LOD_NORMAL_WEIGHT = 1e-3f;
+static const float MESH_LOD_TEXTURE_COORDINATES_WEIGHT = 1e-2f;
+
+//! Simplifies the triangles of the parsed xml mesh into its levels of detail.
+//! The binary files are converted with their levels so they are only read back.
+static void buildLods(MeshSerializerData* data)
+{
+	const float* pPositions = data->streams[render::VERTEX_BUFFER_TYPE_POSITION];
+	unsigned int positionComponents = getElementComponentCount(data->streamElementTypes[render::VERTEX_BUFFER_TYPE_POSITION]);
+	if (pPositions == nullptr || positionComponents < 3 || data->indexStorage.empty() || data->numIndexes / 3 < render::MESH_LOD_MIN_TRIANGLES * 2)
+		return;
+
+	render::MeshSimplifier simplifier;
+	simplifier.setVertices(pPositions, data->numVertices, positionComponents * sizeof(float));
+
+	const float* pNormals = data->streams[render::VERTEX_BUFFER_TYPE_NORMAL];
+	if (pNormals != nullptr)
+	{
+		unsigned int components = getElementComponentCount(data->streamElementTypes[render::VERTEX_BUFFER_TYPE_NORMAL]);
+		simplifier.addAttribute(pNormals, components, components * sizeof(float), MESH_LOD_NORMAL_WEIGHT);
+	}
+
+	const float* pTexcoords = data->streams[render::VERTEX_BUFFER_TYPE_TEXTURE_COORDINATES];
+	if (pTexcoords != nullptr)
+	{
+		unsigned int components = getElementComponentCount(data->streamElementTypes[render::VERTEX_BUFFER_TYPE_TEXTURE_COORDINATES]);
+		simplifier.addAttribute(pTexcoords, components, components * sizeof(float), MESH_LOD_TEXTURE_COORDINATES_WEIGHT);
+	}
+
+	simplifier.buildLodChain(&data->indexStorage[0], data->numIndexes, render::MESH_LOD_MAX_LEVELS - 1, data->lodIndexStorage, data->lodErrors);
+
+	// The levels share the vertex order of the full mesh, only their triangles are reordered
+	for (unsigned int i = 0; i < data->lodIndexStorage.size(); ++i)
+		render::MeshOptimizer::optimizeVertexCache(&data->lodIndexStorage[i][0], data->lodIndexStorage[i].size(), data->numVertices);
+
+	data->setLodsFromStorage();
+}
+
+//! Narrows the indices of the parsed xml mesh and its levels of detail to 16 bits if the vertices allow it.
+//! It runs with the parse so the index buffers, like the binary files converted from this data, are filled with a copy.
+static void packIndices(MeshSerializerData* data)
+{
+	if (data->indexStorage.empty() || data->numVertices > MESH_INDEX_16BIT_MAX_VERTICES)
+		return;
+
+	data->shortIndexStorage.assign(data->indexStorage.begin(), data->indexStorage.end());
+	data->indices = &data->shortIndexStorage[0];
+	data->indexSize = sizeof(unsigned short);
+
+	data->shortLodIndexStorage.resize(data->lodIndexStorage.size());
+	for (unsigned int i = 0; i < data->lodIndexStorage.size(); ++i)
+	{
+		data->shortLodIndexStorage[i].assign(data->lodIndexStorage[i].begin(), data->lodIndexStorage[i].end());
+		data->lodIndices[i] = &data->shortLodIndexStorage[i][0];
+	}
+}
+
+//! Returns true if every index addresses one of the vertices.
+static bool checkIndices(const void* indices, unsigned int indexSize, unsigned int numIndexes, unsigned int numVertices)
+{
+	if (indexSize == sizeof(unsigned short))
+	{
+		const unsigned short* pShort = (const unsigned short*)indices;
+		for (unsigned int i = 0; i < numIndexes; ++i)
+		{
+			if (pShort[i] >= numVertices)
+				return false;
+		}
+	}
+	else
+	{
+		const unsigned int* pInt = (const unsigned int*)indices;
+		for (unsigned int i = 0; i < numIndexes; ++i)
+		{
+			if (pInt[i] >= numVertices)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+static render::IndexBuffer* createIndexBuffer(const void* indices, unsigned int indexSize, unsigned int numIndexes)
+{
+	render::IndexType indexType = (indexSize == sizeof(unsigned short)) ? render::IT_16BIT : render::IT_32BIT;
+
+	render::IndexBuffer* pIndexBuffer = render::RenderManager::getInstance()->createIndexBuffer(indexType, numIndexes, resource::BU_STATIC_WRITE_ONLY);
+	if (pIndexBuffer == nullptr)
+		return nullptr;
+
+	void* pIdx = pIndexBuffer->lock(resource::BL_DISCARD);
+	if (pIdx == nullptr)
+	{
+		render::RenderManager::getInstance()->removeIndexBuffer(pIndexBuffer);
+		return nullptr;
+	}
+
+	memcpy(pIdx, indices, numIndexes * indexSize);
+
+	pIndexBuffer->unlock();
+
+	return pIndexBuffer;
+}
+
+static unsigned int alignFileOffset(unsigned int offset)
+{
+	return (offset + MESH_FILE_ALIGNMENT - 1) & ~(MESH_FILE_ALIGNMENT - 1);
+}
+
+static bool isBinaryMeshFile(const std::string& filename)
+{
+	std::string extension = MESH_FILE_EXTENSION;
+	if (filename.size() < extension.size())
+		return false;
+
+	std::string fileExtension = filename.substr(filename.size() - extension.size());
+	core::stringToLower(fileExtension);
+
+	return (fileExtension == extension);
+}
+
 MeshSerializer::MeshSerializer()
 {
 	// Version number
@@ -103,33 +372,75 @@ MeshSerializer::MeshSerializer()
 MeshSerializer::~MeshSerializer() {}
 
 bool MeshSerializer::importResource(Resource* dest, const std::string& filename)
+{
+	SerializerData* pData = parseResource(dest, filename);
+	if (pData == nullptr)
+		return false;
+
+	bool result = finalizeResource(dest, pData);
+
+	SAFE_DELETE(pData);
+
+	return result;
+}
+
+bool MeshSerializer::exportResource(Resource* source, const std::string& filename)
+{
+	return true;
+}
+
+bool MeshSerializer::canParseAsync() const
+{
+	return true;
+}
+
+SerializerData* MeshSerializer::parseResource(Resource* dest, const std::string& filename)
 {
 	assert(dest != nullptr);
 	if (dest == nullptr)
-		return false;
+		return nullptr;
 
 	if (dest->getResourceType() != RESOURCE_TYPE_MESH_DATA)
 	{
 		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("MeshSerializer", "Unable to load mesh - invalid resource pointer.", core::LOG_LEVEL_ERROR);
-		return false;
+		return nullptr;
 	}
 
-	render::MeshData* resource = static_cast<render::MeshData*>(dest);
-	assert(resource != nullptr);
-	if (resource == nullptr)
-		return false;
-
 	if (resource::ResourceManager::getInstance() == nullptr)
 	{
 		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("MeshSerializer", "Unable to load mesh - resources data path not set.", core::LOG_LEVEL_ERROR);
-		return false;
+		return nullptr;
 	}
 
 	std::string filePath = resource::ResourceManager::getInstance()->getDataPath() + "/" + filename;
 
+	if (isBinaryMeshFile(filename))
+		return parseBinaryFile(filePath);
+
+	MeshSerializerData* pData = static_cast<MeshSerializerData*>(parseXmlFile(filePath));
+	if (pData != nullptr)
+	{
+		buildLods(pData);
+		packIndices(pData);
+	}
+
+	return pData;
+}
+
+SerializerData* MeshSerializer::parseXmlFile(const std::string& filePath)
+{
 	tinyxml2::XMLDocument doc;
 	if (doc.LoadFile(filePath.c_str()) != tinyxml2::XML_SUCCESS)
-		return false;
+		return nullptr;
+
+	MeshSerializerData* pData = new MeshSerializerData();
+	std::vector<float>& positions = pData->streamStorage[render::VERTEX_BUFFER_TYPE_POSITION];
+	std::vector<float>& normals = pData->streamStorage[render::VERTEX_BUFFER_TYPE_NORMAL];
+	std::vector<float>& texcoords = pData->streamStorage[render::VERTEX_BUFFER_TYPE_TEXTURE_COORDINATES];
+	std::vector<float>& tangents = pData->streamStorage[render::VERTEX_BUFFER_TYPE_TANGENT];
+	std::vector<float>& binormals = pData->streamStorage[render::VERTEX_BUFFER_TYPE_BINORMAL];
+
+	pData->streamElementTypes[render::VERTEX_BUFFER_TYPE_TEXTURE_COORDINATES] = render::VERTEX_ELEMENT_TYPE_FLOAT2;
 
 	tinyxml2::XMLElement* pRoot = doc.FirstChildElement("mesh");
 	if (pRoot != nullptr)
@@ -144,7 +455,6 @@ bool MeshSerializer::importResource(Resource* dest, const std::string& filename)
 		unsigned int numVertices = 0;
 		unsigned int numIndexes = 0;
 		std::vector<PositionAndUV> vertexArray;
-		std::vector<unsigned int> indexArray;
 		pElement = pRoot->FirstChildElement("vertexbuffer");
 		if (pElement != nullptr)
 		{
@@ -152,7 +462,10 @@ bool MeshSerializer::importResource(Resource* dest, const std::string& filename)
 			if (svalue != nullptr)
 			{
 				if (std::string(svalue) != "true")
-					return false;
+				{
+					SAFE_DELETE(pData);
+					return nullptr;
+				}
 			}
 
 			if (pElement->QueryIntAttribute("count", &ivalue) == tinyxml2::XML_SUCCESS)
@@ -163,29 +476,10 @@ bool MeshSerializer::importResource(Resource* dest, const std::string& filename)
 			vertexArray.reserve(numVertices);
 			vertexArray.resize(numVertices, PositionAndUV());
 
-			render::VertexBuffer* pPositionVertexBuffer = nullptr;
-			render::VertexBuffer* pNormalVertexBuffer = nullptr;
-			render::VertexBuffer* pTexcoordVertexBuffer = nullptr;
-			float *pPositionFloat = nullptr;
-			float *pNormalFloat = nullptr;
-			float *pTexcoordFloat = nullptr;
-
-			pPositionVertexBuffer = render::RenderManager::getInstance()->createVertexBuffer(render::VERTEX_BUFFER_TYPE_POSITION, render::VERTEX_ELEMENT_TYPE_FLOAT3, numVertices, resource::BU_STATIC_WRITE_ONLY);
-			pPositionFloat = (float*)(pPositionVertexBuffer->lock(resource::BL_DISCARD));
-			if (pPositionFloat == nullptr)
-				return false;
+			positions.resize(numVertices * 3, 0.0f);
+			normals.resize(numVertices * 3, 0.0f);
+			texcoords.resize(numVertices * 2, 0.0f);
 
-			pNormalVertexBuffer = render::RenderManager::getInstance()->createVertexBuffer(render::VERTEX_BUFFER_TYPE_NORMAL, render::VERTEX_ELEMENT_TYPE_FLOAT3, numVertices, resource::BU_STATIC_WRITE_ONLY);
-			pNormalFloat = (float*)(pNormalVertexBuffer->lock(resource::BL_DISCARD));
-			if (pNormalFloat == nullptr)
-				return false;
-
-			pTexcoordVertexBuffer = render::RenderManager::getInstance()->createVertexBuffer(render::VERTEX_BUFFER_TYPE_TEXTURE_COORDINATES, render::VERTEX_ELEMENT_TYPE_FLOAT2, numVertices, resource::BU_STATIC_WRITE_ONLY);
-			pTexcoordFloat = (float*)(pTexcoordVertexBuffer->lock(resource::BL_DISCARD));
-			if (pTexcoordFloat == nullptr)
-				return false;
-
-			core::aabox3d localBox;
 			core::vector3d min = core::vector3d::ORIGIN_3D;
 			core::vector3d max = core::vector3d::ORIGIN_3D;
 			float maxSquaredRadius = -1.0f;
@@ -211,7 +505,8 @@ bool MeshSerializer::importResource(Resource* dest, const std::string& filename)
 						std::string msg =  "Unable to load mesh - position data not set at index:" + core::intToString(i) + ".";
 						core::Log::getInstance()->logMessage("MeshSerializer", msg, core::LOG_LEVEL_ERROR);
 					}
-					return false;
+					SAFE_DELETE(pData);
+					return nullptr;
 				}
 				
 				x = 0.0f;
@@ -233,9 +528,9 @@ bool MeshSerializer::importResource(Resource* dest, const std::string& filename)
 					z = (float)dvalue;
 				}
 
-				pPositionFloat[i * 3 + 0] = x;
-				pPositionFloat[i * 3 + 1] = y;
-				pPositionFloat[i * 3 + 2] = z;
+				positions[i * 3 + 0] = x;
+				positions[i * 3 + 1] = y;
+				positions[i * 3 + 2] = z;
 
 				core::vector3d vec(x, y, z);
 
@@ -264,7 +559,8 @@ bool MeshSerializer::importResource(Resource* dest, const std::string& filename)
 						std::string msg =  "Unable to load mesh - normal data not set at index:" + core::intToString(i) + ".";
 						core::Log::getInstance()->logMessage("MeshSerializer", msg, core::LOG_LEVEL_ERROR);
 					}
-					return false;
+					SAFE_DELETE(pData);
+					return nullptr;
 				}
 
 				x = 0.0f;
@@ -286,9 +582,9 @@ bool MeshSerializer::importResource(Resource* dest, const std::string& filename)
 					z = (float)dvalue;
 				}
 
-				pNormalFloat[i * 3 + 0] = x;
-				pNormalFloat[i * 3 + 1] = y;
-				pNormalFloat[i * 3 + 2] = z;
+				normals[i * 3 + 0] = x;
+				normals[i * 3 + 1] = y;
+				normals[i * 3 + 2] = z;
 				///Normal///
 
 				///Texcoord///
@@ -300,7 +596,8 @@ bool MeshSerializer::importResource(Resource* dest, const std::string& filename)
 						std::string msg =  "Unable to load mesh - texcoord data not set at index:" + core::intToString(i) + ".";
 						core::Log::getInstance()->logMessage("MeshSerializer", msg, core::LOG_LEVEL_ERROR);
 					}
-					return false;
+					SAFE_DELETE(pData);
+					return nullptr;
 				}
 
 				u = 0.0f;
@@ -316,8 +613,8 @@ bool MeshSerializer::importResource(Resource* dest, const std::string& filename)
 					v = (float)dvalue;
 				}
 
-				pTexcoordFloat[i * 2 + 0] = u;
-				pTexcoordFloat[i * 2 + 1] = v;
+				texcoords[i * 2 + 0] = u;
+				texcoords[i * 2 + 1] = v;
 
 				vertexArray[i].uv = core::vector2d(u, v);
 				///Texcoord///
@@ -327,22 +624,11 @@ bool MeshSerializer::importResource(Resource* dest, const std::string& filename)
 				pSubElement = pSubElement->NextSiblingElement("vertex");
 			}
 
-			localBox.MinEdge = min;
-			localBox.MaxEdge = max;
-
-			resource->setBoundingBox(localBox);
+			pData->boundingBox.MinEdge = min;
+			pData->boundingBox.MaxEdge = max;
 
 			// Pad out the sphere a little too
-			resource->setBoundingSphereRadius(core::sqrt(maxSquaredRadius) * 1.25f);
-
-			pPositionVertexBuffer->unlock();
-			resource->setVertexBuffer(render::VERTEX_BUFFER_TYPE_POSITION, pPositionVertexBuffer);
-
-			pNormalVertexBuffer->unlock();
-			resource->setVertexBuffer(render::VERTEX_BUFFER_TYPE_NORMAL, pNormalVertexBuffer);
-
-			pTexcoordVertexBuffer->unlock();
-			resource->setVertexBuffer(render::VERTEX_BUFFER_TYPE_TEXTURE_COORDINATES, pTexcoordVertexBuffer);
+			pData->boundingSphereRadius = core::sqrt(maxSquaredRadius) * 1.25f;
 		}
 	
 		pElement = pRoot->FirstChildElement("indexbuffer");
@@ -353,15 +639,7 @@ bool MeshSerializer::importResource(Resource* dest, const std::string& filename)
 				numIndexes = (unsigned int)ivalue;
 			}
 
-			indexArray.reserve(numIndexes);
-			indexArray.resize(numIndexes,0);
-
-			render::IndexBuffer* pIndexBuffer = render::RenderManager::getInstance()->createIndexBuffer(render::IT_32BIT, numIndexes, resource::BU_STATIC_WRITE_ONLY);
-			resource->setIndexBuffer(pIndexBuffer);
-
-			unsigned int* pIdx = (unsigned int*)(pIndexBuffer->lock(resource::BL_DISCARD));
-			if (pIdx == nullptr)
-				return false;
+			pData->indexStorage.resize(numIndexes, 0);
 
 			unsigned int i = 0;
 			pSubElement = pElement->FirstChildElement("index");
@@ -376,13 +654,10 @@ bool MeshSerializer::importResource(Resource* dest, const std::string& filename)
 					index = (unsigned int)ivalue;
 				}
 
-				indexArray[i] = index;
-				pIdx[i++] = index;
+				pData->indexStorage[i++] = index;
 
 				pSubElement = pSubElement->NextSiblingElement("index");
 			}
-
-			pIndexBuffer->unlock();
 		}
 
 		///Tangents and Binormals///
@@ -390,72 +665,366 @@ bool MeshSerializer::importResource(Resource* dest, const std::string& filename)
 		tangentArray.reserve(numVertices);
 		tangentArray.resize(numVertices, TangentAndBinormal());
 
-		for (unsigned int i = 0; i < numIndexes; i+=3)
+		for (unsigned int i = 0; i + 2 < numIndexes; i+=3)
 		{
-			unsigned int index = indexArray[i];
-			core::vector3d pos1 = vertexArray[index + 0].position;
-			core::vector3d pos2 = vertexArray[index + 1].position;
-			core::vector3d pos3 = vertexArray[index + 2].position;
+			unsigned int index0 = pData->indexStorage[i + 0];
+			unsigned int index1 = pData->indexStorage[i + 1];
+			unsigned int index2 = pData->indexStorage[i + 2];
+			if (index0 >= numVertices || index1 >= numVertices || index2 >= numVertices)
+				continue;
 
-			core::vector2d uv1 = vertexArray[index + 0].uv;
-			core::vector2d uv2 = vertexArray[index + 1].uv;
-			core::vector2d uv3 = vertexArray[index + 2].uv;
+			core::vector3d pos1 = vertexArray[index0].position;
+			core::vector3d pos2 = vertexArray[index1].position;
+			core::vector3d pos3 = vertexArray[index2].position;
+
+			core::vector2d uv1 = vertexArray[index0].uv;
+			core::vector2d uv2 = vertexArray[index1].uv;
+			core::vector2d uv3 = vertexArray[index2].uv;
 
 			TangentAndBinormal tangentAndBinormal = calculateTangentAndBinormal(pos1, pos2, pos3, uv1, uv2, uv3);
 
-			tangentArray[index + 0].tangent += tangentAndBinormal.tangent;
-			tangentArray[index + 0].binormal += tangentAndBinormal.binormal;
+			tangentArray[index0].tangent += tangentAndBinormal.tangent;
+			tangentArray[index0].binormal += tangentAndBinormal.binormal;
 
-			tangentArray[index + 1].tangent += tangentAndBinormal.tangent;
-			tangentArray[index + 1].binormal += tangentAndBinormal.binormal;
+			tangentArray[index1].tangent += tangentAndBinormal.tangent;
+			tangentArray[index1].binormal += tangentAndBinormal.binormal;
 
-			tangentArray[index + 2].tangent += tangentAndBinormal.tangent;
-			tangentArray[index + 2].binormal += tangentAndBinormal.binormal;
+			tangentArray[index2].tangent += tangentAndBinormal.tangent;
+			tangentArray[index2].binormal += tangentAndBinormal.binormal;
 		}
 
-		render::VertexBuffer* pTangentVertexBuffer = nullptr;
-		render::VertexBuffer* pBinormalVertexBuffer = nullptr;
-		float *pTangentFloat = nullptr;
-		float *pBinormalFloat = nullptr;
-
-		pTangentVertexBuffer = render::RenderManager::getInstance()->createVertexBuffer(render::VERTEX_BUFFER_TYPE_TANGENT, render::VERTEX_ELEMENT_TYPE_FLOAT3, numVertices, resource::BU_STATIC_WRITE_ONLY);
-		pTangentFloat = (float*)(pTangentVertexBuffer->lock(resource::BL_DISCARD));
-		if (pTangentFloat == nullptr)
-			return false;
-
-		pBinormalVertexBuffer = render::RenderManager::getInstance()->createVertexBuffer(render::VERTEX_BUFFER_TYPE_BINORMAL, render::VERTEX_ELEMENT_TYPE_FLOAT3, numVertices, resource::BU_STATIC_WRITE_ONLY);
-		pBinormalFloat = (float*)(pBinormalVertexBuffer->lock(resource::BL_DISCARD));
-		if (pBinormalFloat == nullptr)
-			return false;
+		tangents.resize(numVertices * 3, 0.0f);
+		binormals.resize(numVertices * 3, 0.0f);
 
 		for (unsigned int i = 0; i < numVertices; ++i)
 		{
 			tangentArray[i].tangent.normalize();
 			tangentArray[i].binormal.normalize();
 
-			pTangentFloat[i * 3 + 0] = tangentArray[i].tangent.x;
-			pTangentFloat[i * 3 + 1] = tangentArray[i].tangent.y;
-			pTangentFloat[i * 3 + 2] = tangentArray[i].tangent.z;
+			tangents[i * 3 + 0] = tangentArray[i].tangent.x;
+			tangents[i * 3 + 1] = tangentArray[i].tangent.y;
+			tangents[i * 3 + 2] = tangentArray[i].tangent.z;
 
-			pBinormalFloat[i * 3 + 0] = tangentArray[i].binormal.x;
-			pBinormalFloat[i * 3 + 1] = tangentArray[i].binormal.y;
-			pBinormalFloat[i * 3 + 2] = tangentArray[i].binormal.z;
+			binormals[i * 3 + 0] = tangentArray[i].binormal.x;
+			binormals[i * 3 + 1] = tangentArray[i].binormal.y;
+			binormals[i * 3 + 2] = tangentArray[i].binormal.z;
 		}
+		///Tangents and Binormals///
 
-		pTangentVertexBuffer->unlock();
-		resource->setVertexBuffer(render::VERTEX_BUFFER_TYPE_TANGENT, pTangentVertexBuffer);
+		numVertices = optimizeMesh(pData, numVertices, filePath);
 
-		pBinormalVertexBuffer->unlock();
-		resource->setVertexBuffer(render::VERTEX_BUFFER_TYPE_BINORMAL, pBinormalVertexBuffer);
-		///Tangents and Binormals///
+		pData->numVertices = numVertices;
+		pData->numIndexes = numIndexes;
+		pData->setStreamsFromStorage();
+	}
+
+	return pData;
+}
+
+SerializerData* MeshSerializer::parseBinaryFile(const std::string& filePath)
+{
+	MappedFile* pFile = new MappedFile();
+	if (!pFile->open(filePath))
+	{
+		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("MeshSerializer", "Unable to load mesh - could not map file: " + filePath + ".", core::LOG_LEVEL_ERROR);
+		SAFE_DELETE(pFile);
+		return nullptr;
+	}
+
+	const unsigned char* pBytes = (const unsigned char*)pFile->getData();
+	std::size_t fileSize = pFile->getSize();
+
+	const MeshFileHeader* pHeader = (const MeshFileHeader*)pBytes;
+	bool valid = fileSize >= sizeof(MeshFileHeader) &&
+		pHeader->magic == MESH_FILE_MAGIC &&
+		pHeader->version == MESH_FILE_VERSION &&
+		pHeader->headerSize == sizeof(MeshFileHeader) &&
+		pHeader->numStreams <= MESH_FILE_MAX_STREAMS &&
+		pHeader->numLods <= MESH_FILE_MAX_LODS &&
+		(pHeader->indexSize == sizeof(unsigned int) || (pHeader->indexSize == sizeof(unsigned short) && pHeader->numVertices <= MESH_INDEX_16BIT_MAX_VERTICES));
+
+	// the sizes are computed in 64 bits so that a crafted count can not wrap around and pass
+	if (valid && pHeader->numIndexes > 0)
+	{
+		unsigned long long indexBytes = (unsigned long long)pHeader->numIndexes * pHeader->indexSize;
+		valid = (pHeader->indexOffset % MESH_FILE_ALIGNMENT == 0) && pHeader->indexOffset <= fileSize && indexBytes <= fileSize - pHeader->indexOffset &&
+			checkIndices(pBytes + pHeader->indexOffset, pHeader->indexSize, pHeader->numIndexes, pHeader->numVertices);
+	}
+
+	for (unsigned int i = 0; valid && i < pHeader->numStreams; ++i)
+	{
+		const MeshFileStream& stream = pHeader->streams[i];
+		unsigned long long streamBytes = (unsigned long long)pHeader->numVertices * getElementComponentCount((render::VertexElementType)stream.vertexElementType) * sizeof(float);
+
+		valid = stream.vertexBufferType < render::VERTEX_BUFFER_TYPE_COUNT &&
+			streamBytes > 0 &&
+			stream.size == streamBytes &&
+			(stream.offset % MESH_FILE_ALIGNMENT == 0) &&
+			stream.offset <= fileSize && stream.size <= fileSize - stream.offset;
+	}
+
+	for (unsigned int i = 0; valid && i < pHeader->numLods; ++i)
+	{
+		const MeshFileLod& lod = pHeader->lods[i];
+		unsigned long long lodBytes = (unsigned long long)lod.numIndexes * pHeader->indexSize;
+
+		valid = lod.numIndexes > 0 &&
+			(lod.offset % MESH_FILE_ALIGNMENT == 0) &&
+			lod.offset <= fileSize && lodBytes <= fileSize - lod.offset &&
+			checkIndices(pBytes + lod.offset, pHeader->indexSize, lod.numIndexes, pHeader->numVertices);
+	}
+
+	if (!valid)
+	{
+		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("MeshSerializer", "Unable to load mesh - invalid binary mesh file: " + filePath + ".", core::LOG_LEVEL_ERROR);
+		SAFE_DELETE(pFile);
+		return nullptr;
+	}
+
+	MeshSerializerData* pData = new MeshSerializerData();
+	pData->numVertices = pHeader->numVertices;
+	pData->numIndexes = pHeader->numIndexes;
+
+	for (unsigned int i = 0; i < pHeader->numStreams; ++i)
+	{
+		const MeshFileStream& stream = pHeader->streams[i];
+		if (stream.size == 0)
+			continue;
+
+		pData->streams[stream.vertexBufferType] = (const float*)(pBytes + stream.offset);
+		pData->streamElementTypes[stream.vertexBufferType] = (render::VertexElementType)stream.vertexElementType;
+	}
+
+	if (pHeader->numIndexes > 0)
+		pData->indices = pBytes + pHeader->indexOffset;
+	pData->indexSize = pHeader->indexSize;
+
+	for (unsigned int i = 0; i < pHeader->numLods; ++i)
+	{
+		pData->lodIndices.push_back(pBytes + pHeader->lods[i].offset);
+		pData->lodNumIndexes.push_back(pHeader->lods[i].numIndexes);
+		pData->lodErrors.push_back(pHeader->lods[i].error);
+	}
+
+	pData->boundingBox.MinEdge = core::vector3d(pHeader->boundingBoxMin[0], pHeader->boundingBoxMin[1], pHeader->boundingBoxMin[2]);
+	pData->boundingBox.MaxEdge = core::vector3d(pHeader->boundingBoxMax[0], pHeader->boundingBoxMax[1], pHeader->boundingBoxMax[2]);
+	pData->boundingSphereRadius = pHeader->boundingSphereRadius;
+
+	// The streams point into the mapping so it has to stay open until the buffers are filled
+	pData->mappedFile = pFile;
+
+	return pData;
+}
+
+bool MeshSerializer::convertMesh(const std::string& sourcePath, const std::string& destinationPath)
+{
+	MeshSerializerData* pData = static_cast<MeshSerializerData*>(parseXmlFile(sourcePath));
+	if (pData == nullptr)
+	{
+		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("MeshSerializer", "Unable to convert mesh - could not parse: " + sourcePath + ".", core::LOG_LEVEL_ERROR);
+		return false;
+	}
+
+	buildLods(pData);
+	packIndices(pData);
+
+	MeshFileHeader header;
+	memset(&header, 0, sizeof(MeshFileHeader));
+
+	header.magic = MESH_FILE_MAGIC;
+	header.version = MESH_FILE_VERSION;
+	header.headerSize = sizeof(MeshFileHeader);
+	header.numVertices = pData->numVertices;
+	header.numIndexes = pData->numIndexes;
+	header.indexSize = pData->indexSize;
+
+	header.boundingBoxMin[0] = pData->boundingBox.MinEdge.x;
+	header.boundingBoxMin[1] = pData->boundingBox.MinEdge.y;
+	header.boundingBoxMin[2] = pData->boundingBox.MinEdge.z;
+	header.boundingBoxMax[0] = pData->boundingBox.MaxEdge.x;
+	header.boundingBoxMax[1] = pData->boundingBox.MaxEdge.y;
+	header.boundingBoxMax[2] = pData->boundingBox.MaxEdge.z;
+	header.boundingSphereRadius = pData->boundingSphereRadius;
+
+	unsigned int offset = alignFileOffset(sizeof(MeshFileHeader));
+	for (unsigned int i = 0; i < render::VERTEX_BUFFER_TYPE_COUNT; ++i)
+	{
+		render::VertexBufferType type = MESH_STREAM_ORDER[i];
+		if (pData->streams[type] == nullptr || header.numStreams >= MESH_FILE_MAX_STREAMS)
+			continue;
+
+		MeshFileStream& stream = header.streams[header.numStreams++];
+		stream.vertexBufferType = type;
+		stream.vertexElementType = pData->streamElementTypes[type];
+		stream.offset = offset;
+		stream.size = pData->numVertices * getElementComponentCount(pData->streamElementTypes[type]) * sizeof(float);
+
+		offset = alignFileOffset(offset + stream.size);
+	}
+
+	header.indexOffset = offset;
+	offset = alignFileOffset(offset + pData->numIndexes * header.indexSize);
+
+	for (unsigned int i = 0; i < pData->lodIndices.size() && header.numLods < MESH_FILE_MAX_LODS; ++i)
+	{
+		MeshFileLod& lod = header.lods[header.numLods++];
+		lod.numIndexes = pData->lodNumIndexes[i];
+		lod.offset = offset;
+		lod.error = pData->lodErrors[i];
+
+		offset = alignFileOffset(offset + lod.numIndexes * header.indexSize);
+	}
+
+	FILE* pFile = fopen(destinationPath.c_str(), "wb");
+	if (pFile == nullptr)
+	{
+		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("MeshSerializer", "Unable to convert mesh - could not open: " + destinationPath + ".", core::LOG_LEVEL_ERROR);
+		SAFE_DELETE(pData);
+		return false;
+	}
+
+	static const unsigned char padding[MESH_FILE_ALIGNMENT] = {0};
+
+	bool result = (fwrite(&header, sizeof(MeshFileHeader), 1, pFile) == 1);
+	unsigned int written = sizeof(MeshFileHeader);
+
+	for (unsigned int i = 0; result && i < header.numStreams; ++i)
+	{
+		const MeshFileStream& stream = header.streams[i];
+
+		if (stream.offset > written)
+			result = (fwrite(padding, 1, stream.offset - written, pFile) == stream.offset - written);
+
+		if (result && stream.size > 0)
+			result = (fwrite(pData->streams[stream.vertexBufferType], 1, stream.size, pFile) == stream.size);
+
+		written = stream.offset + stream.size;
+	}
+
+	if (result && header.indexOffset > written)
+		result = (fwrite(padding, 1, header.indexOffset - written, pFile) == header.indexOffset - written);
+
+	if (result && header.numIndexes > 0)
+		result = (fwrite(pData->indices, header.indexSize, header.numIndexes, pFile) == header.numIndexes);
+
+	written = header.indexOffset + header.numIndexes * header.indexSize;
+
+	for (unsigned int i = 0; result && i < header.numLods; ++i)
+	{
+		const MeshFileLod& lod = header.lods[i];
+
+		if (lod.offset > written)
+			result = (fwrite(padding, 1, lod.offset - written, pFile) == lod.offset - written);
+
+		if (result)
+			result = (fwrite(pData->lodIndices[i], header.indexSize, lod.numIndexes, pFile) == lod.numIndexes);
+
+		written = lod.offset + lod.numIndexes * header.indexSize;
+	}
+
+	fclose(pFile);
+	SAFE_DELETE(pData);
+
+	if (!result)
+	{
+		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("MeshSerializer", "Unable to convert mesh - could not write: " + destinationPath + ".", core::LOG_LEVEL_ERROR);
+		return false;
 	}
 
 	return true;
 }
 
-bool MeshSerializer::exportResource(Resource* source, const std::string& filename)
+bool MeshSerializer::finalizeResource(Resource* dest, SerializerData* data)
 {
+	assert(dest != nullptr);
+	if (dest == nullptr || data == nullptr)
+		return false;
+
+	render::MeshData* resource = static_cast<render::MeshData*>(dest);
+	MeshSerializerData* pData = static_cast<MeshSerializerData*>(data);
+
+	if (render::RenderManager::getInstance() == nullptr)
+	{
+		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("MeshSerializer", "Unable to load mesh - render manager not created.", core::LOG_LEVEL_ERROR);
+		return false;
+	}
+
+	unsigned int numVertices = pData->numVertices;
+
+	if (pData->streams[render::VERTEX_BUFFER_TYPE_POSITION] != nullptr)
+	{
+		resource->setBoundingBox(pData->boundingBox);
+		resource->setBoundingSphereRadius(pData->boundingSphereRadius);
+	}
+
+	for (unsigned int i = 0; i < render::VERTEX_BUFFER_TYPE_COUNT; ++i)
+	{
+		render::VertexBufferType type = MESH_STREAM_ORDER[i];
+		if (pData->streams[type] == nullptr)
+			continue;
+
+		unsigned int count = numVertices * getElementComponentCount(pData->streamElementTypes[type]);
+		if (!createVertexBuffer(resource, type, pData->streamElementTypes[type], numVertices, pData->streams[type], count))
+			return false;
+	}
+
+	if (pData->indices != nullptr)
+	{
+		render::IndexBuffer* pIndexBuffer = createIndexBuffer(pData->indices, pData->indexSize, pData->numIndexes);
+		if (pIndexBuffer == nullptr)
+			return false;
+
+		resource->setIndexBuffer(pIndexBuffer);
+
+		for (unsigned int i = 0; i < pData->lodIndices.size(); ++i)
+		{
+			pIndexBuffer = createIndexBuffer(pData->lodIndices[i], pData->indexSize, pData->lodNumIndexes[i]);
+			if (pIndexBuffer == nullptr)
+				return false;
+
+			resource->addLod(pIndexBuffer, pData->lodErrors[i]);
+		}
+	}
+
+	const float* pPositions = pData->streams[render::VERTEX_BUFFER_TYPE_POSITION];
+	unsigned int positionComponents = getElementComponentCount(pData->streamElementTypes[render::VERTEX_BUFFER_TYPE_POSITION]);
+	if (pPositions != nullptr && positionComponents >= 3 && pData->indices != nullptr && pData->numIndexes / 3 <= MESH_OCCLUDER_MAX_TRIANGLES)
+	{
+		if (pData->indexSize == sizeof(unsigned short))
+		{
+			const unsigned short* pShort = (const unsigned short*)pData->indices;
+			std::vector<unsigned int> indices(pShort, pShort + pData->numIndexes);
+			resource->setOccluderGeometry(pPositions, numVertices, positionComponents * sizeof(float), &indices[0], pData->numIndexes);
+		}
+		else
+		{
+			resource->setOccluderGeometry(pPositions, numVertices, positionComponents * sizeof(float), (const unsigned int*)pData->indices, pData->numIndexes);
+		}
+	}
+
+	return true;
+}
+
+bool MeshSerializer::createVertexBuffer(render::MeshData* meshData, render::VertexBufferType type, render::VertexElementType elementType, unsigned int numVertices, const float* data, unsigned int count)
+{
+	render::VertexBuffer* pVertexBuffer = render::RenderManager::getInstance()->createVertexBuffer(type, elementType, numVertices, resource::BU_STATIC_WRITE_ONLY);
+	if (pVertexBuffer == nullptr)
+		return false;
+
+	float* pFloat = (float*)(pVertexBuffer->lock(resource::BL_DISCARD));
+	if (pFloat == nullptr)
+	{
+		render::RenderManager::getInstance()->removeVertexBuffer(pVertexBuffer);
+		return false;
+	}
+
+	if (data != nullptr && count > 0)
+		memcpy(pFloat, data, count * sizeof(float));
+
+	pVertexBuffer->unlock();
+	meshData->setVertexBuffer(type, pVertexBuffer);
+
 	return true;
 }
 
-}// end namespace resource
+}// end namespace resource
\ No newline at end of file
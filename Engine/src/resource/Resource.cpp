@@ -25,6 +25,7 @@ THE SOFTWARE.
 */
 
 #include <core/Utils.h>
+#include <core/Profiler.h>
 #include <resource/Resource.h>
 #include <resource/Serializer.h>
 #include <resource/ResourceEvent.h>
@@ -47,6 +48,7 @@ Resource::Resource(const std::string& filename, Serializer* serializer)
 	mFilename = filename;
 
 	mSerializer = serializer;
+	mSerializerData = nullptr;
 
 	mState = RESOURCE_STATE_UNLOADED;
 	mSize = 0;
@@ -57,6 +59,7 @@ Resource::Resource(const std::string& filename, Serializer* serializer)
 Resource::~Resource()
 {
 	SAFE_DELETE(mResourceEvent);
+	SAFE_DELETE(mSerializerData);
 }
 
 const unsigned int& Resource::getID() const
@@ -64,6 +67,16 @@ const unsigned int& Resource::getID() const
 	return mID;
 }
 
+const core::Handle& Resource::getHandle() const
+{
+	return mHandle;
+}
+
+void Resource::setHandle(const core::Handle& handle)
+{
+	mHandle = handle;
+}
+
 const ResourceType& Resource::getResourceType() const
 { 
 	return mResourceType;
@@ -84,6 +97,19 @@ unsigned int Resource::getSize()
 	return mSize;
 }
 
+bool Resource::parse()
+{
+	if (mSerializer == nullptr || !mSerializer->canParseAsync())
+		return true;
+
+	SAFE_DELETE(mSerializerData);
+
+	PROFILE_SCOPE("Serializer::parseResource");
+	mSerializerData = mSerializer->parseResource(this, mFilename);
+
+	return (mSerializerData != nullptr);
+}
+
 bool Resource::load()
 {
 	if (mState == RESOURCE_STATE_LOADED) return true;
@@ -106,6 +132,9 @@ bool Resource::load()
 
 void Resource::unload()
 {
+	// the data of a parse that was never finalized
+	SAFE_DELETE(mSerializerData);
+
 	if (mState == RESOURCE_STATE_UNLOADED)
 		return;
 
@@ -196,6 +225,15 @@ bool Resource::loadImpl()
 {
 	if (mSerializer != nullptr)
 	{
+		if (mSerializerData != nullptr)
+		{
+			PROFILE_SCOPE("Serializer::finalizeResource");
+			bool result = mSerializer->finalizeResource(this, mSerializerData);
+			SAFE_DELETE(mSerializerData);
+			return result;
+		}
+
+		PROFILE_SCOPE("Serializer::importResource");
 		return mSerializer->importResource(this, mFilename);
 	}
 
@@ -25,6 +25,7 @@ THE SOFTWARE.
 */
 
 #include <core/Log.h>
+#include <core/Profiler.h>
 #include <resource/ResourceManager.h>
 #include <resource/Serializer.h>
 #include <resource/Resource.h>
@@ -40,11 +41,16 @@ THE SOFTWARE.
 #include <platform/PlatformManager.h>
 #include <engine/EngineSettings.h>
 
+#include <chrono>
+
 template<> resource::ResourceManager* core::Singleton<resource::ResourceManager>::m_Singleton = nullptr;
 
 namespace resource
 {
 
+static const unsigned int DEFAULT_LOADER_THREAD_COUNT = 2;
+static const float DEFAULT_FINALIZE_TIME_BUDGET = 4.0f;
+
 ResourceManager::ResourceManager(): core::System("ResourceManager")
 {
 	mLoadResources.resize(RESOURCE_TYPE_COUNT);
@@ -74,10 +80,17 @@ ResourceManager::ResourceManager(): core::System("ResourceManager")
 
 	mTotalLoadSize = 0;
 	mLoadedSize = 0;	
+
+	mLoaderThreadCount = DEFAULT_LOADER_THREAD_COUNT;
+	mLoaderRunning = false;
+
+	mFinalizeTimeBudget = DEFAULT_FINALIZE_TIME_BUDGET;
 }
 
 ResourceManager::~ResourceManager()
 {
+	stopLoaderThreads();
+
 	for (unsigned int i = RESOURCE_TYPE_UNDEFINED; i < RESOURCE_TYPE_COUNT; ++i)
 	{
 		SAFE_DELETE(mSerializers[i]);
@@ -111,12 +124,11 @@ Resource* ResourceManager::createResource(const ResourceType& type, const std::s
 		if (newResource == nullptr)
 			return nullptr;
 
-		mResources[newResource->getID()] = newResource;
+		newResource->setHandle(mResources.insert(newResource));
 		mLoadResources[(unsigned int)(type)].push_back(newResource);
 		mResourcesByFilename[filename] = newResource;
 
-		std::string message = "Resource: " + newResource->getFilename() + " id: " + core::intToString(newResource->getID()) + " created.";
-		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("ResourceManager", message);
+		LOG_MESSAGE("ResourceManager", "Resource: " + newResource->getFilename() + " id: " + core::intToString(newResource->getID()) + " created.", core::LOG_LEVEL_INFORMATION);
 
 		return newResource;
 	}
@@ -124,44 +136,111 @@ Resource* ResourceManager::createResource(const ResourceType& type, const std::s
 	return nullptr;
 }
 
+Resource* ResourceManager::getResource(const core::Handle& handle)
+{
+	Resource** ppResource = mResources.get(handle);
+	if (ppResource == nullptr)
+		return nullptr;
+
+	return *ppResource;
+}
+
 void ResourceManager::loadResources()
 {
-	mTotalLoadSize = 0;
+	loadResourcesAsync();
+
+	waitForLoads();
+}
+
+void ResourceManager::loadResourcesAsync()
+{
+	std::vector<Resource*> resources;
 	for (unsigned int i = RESOURCE_TYPE_UNDEFINED; i < RESOURCE_TYPE_COUNT; ++i)
 	{
 		std::list<Resource*>::iterator j;
 		for (j = mLoadResources[i].begin(); j != mLoadResources[i].end(); ++j)
 		{
-			Resource* resource = (*j);
-
-			assert(resource != nullptr);
-			if (resource == nullptr)
+			assert((*j) != nullptr);
+			if ((*j) == nullptr)
 				continue;
 
-			resource->updateSize();
+			resources.push_back(*j);
+		}
+
+		mLoadResources[i].clear();
+	}
+
+	queueLoads(resources);
+}
+
+bool ResourceManager::loadResourceAsync(Resource* resource)
+{
+	assert(resource != nullptr);
+	if (resource == nullptr)
+		return false;
+
+	if (resource->getState() == RESOURCE_STATE_LOADED)
+		return true;
 
-			mTotalLoadSize += resource->getSize();
+	std::list<Resource*>& loadResources = mLoadResources[(unsigned int)(resource->getResourceType())];
+	std::list<Resource*>::iterator i;
+	for (i = loadResources.begin(); i != loadResources.end(); ++i)
+	{
+		if ((*i) == resource)
+		{
+			loadResources.erase(i);
+			break;
 		}
 	}
-	mLoadedSize = 0;
 
-	fireLoadStarted();
-	
-	for (unsigned int i = RESOURCE_TYPE_UNDEFINED; i < RESOURCE_TYPE_COUNT; ++i)
+	std::vector<Resource*> resources;
+	resources.push_back(resource);
+
+	queueLoads(resources);
+
+	return true;
+}
+
+bool ResourceManager::isLoadPending(Resource* resource) const
+{
+	return (mPendingResources.find(resource) != mPendingResources.end());
+}
+
+unsigned int ResourceManager::getPendingLoadCount() const
+{
+	return (unsigned int)mPendingResources.size();
+}
+
+void ResourceManager::waitForLoads()
+{
+	Resource* resource = nullptr;
+	while (!mPendingResources.empty())
 	{
-		std::list<Resource*>::iterator j;
-		for (j = mLoadResources[i].begin(); j != mLoadResources[i].end(); ++j)
-			loadResource(*j);
-		
-		mLoadResources[i].clear();
-	}	
-	
-	fireLoadEnded();
+		if (!popParsedResource(resource, true))
+			break;
 
-	mTotalLoadSize = 0;
-	mLoadedSize = 0;
-	
-	if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("ResourceManager", "Resources loaded.");
+		finalizeLoad(resource);
+	}
+}
+
+void ResourceManager::setLoaderThreadCount(unsigned int count)
+{
+	mLoaderThreadCount = count;
+}
+
+unsigned int ResourceManager::getLoaderThreadCount() const
+{
+	return mLoaderThreadCount;
+}
+
+void ResourceManager::setFinalizeTimeBudget(float milliseconds)
+{
+	mFinalizeTimeBudget = milliseconds;
+}
+
+float ResourceManager::getFinalizeTimeBudget() const
+{
+	return mFinalizeTimeBudget;
 }
 
 void ResourceManager::unloadResources()
@@ -171,9 +250,8 @@ void ResourceManager::unloadResources()
 	
 	fireLoadStarted();
 
-	std::map<unsigned int, Resource*>::iterator i;
-	for (i = mResources.begin(); i != mResources.end(); ++i)
-		unloadResource(i->second);
+	for (unsigned int i = 0; i < mResources.size(); ++i)
+		unloadResource(mResources[i]);
 
 	fireLoadEnded();
 
@@ -189,6 +267,9 @@ bool ResourceManager::loadResource(Resource* resource)
 	if (resource == nullptr)
 		return false;
 
+	// a loader thread must not parse into the resource while it changes here
+	cancelLoad(resource);
+
 	if (!resource->load())
 		return false;
 
@@ -199,8 +280,7 @@ bool ResourceManager::loadResource(Resource* resource)
 
 	fireLoadUpdate();
 
-	std::string message = "Resource: " + resource->getFilename() + " id: " + core::intToString(resource->getID()) + " loaded.";
-	if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("ResourceManager", message);
+	LOG_MESSAGE("ResourceManager", "Resource: " + resource->getFilename() + " id: " + core::intToString(resource->getID()) + " loaded.", core::LOG_LEVEL_INFORMATION);
 
 	return true;
 }
@@ -211,6 +291,9 @@ void ResourceManager::unloadResource(Resource* resource)
 	if (resource == nullptr)
 		return;
 
+	// a loader thread must not parse into the resource while it changes here
+	cancelLoad(resource);
+
 	resource->unload();
 
 	// Update memory usage
@@ -220,8 +303,7 @@ void ResourceManager::unloadResource(Resource* resource)
 
 	fireLoadUpdate();
 
-	std::string message = "Resource: " + resource->getFilename() + " id: " + core::intToString(resource->getID()) + " unloaded.";
-	if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("ResourceManager", message);
+	LOG_MESSAGE("ResourceManager", "Resource: " + resource->getFilename() + " id: " + core::intToString(resource->getID()) + " unloaded.", core::LOG_LEVEL_INFORMATION);
 }
 
 bool ResourceManager::reloadResource(Resource* resource)
@@ -230,13 +312,15 @@ bool ResourceManager::reloadResource(Resource* resource)
 	if (resource == nullptr)
 		return false;
 
+	// a loader thread must not parse into the resource while it changes here
+	cancelLoad(resource);
+
 	if (!resource->reload())
 		return false;
 
 	fireLoadUpdate();
 
-	std::string message = "Resource: " + resource->getFilename() + " id: " + core::intToString(resource->getID()) + " reloaded.";
-	if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("ResourceManager", message);
+	LOG_MESSAGE("ResourceManager", "Resource: " + resource->getFilename() + " id: " + core::intToString(resource->getID()) + " reloaded.", core::LOG_LEVEL_INFORMATION);
 
 	return true;
 }
@@ -260,8 +344,7 @@ bool ResourceManager::saveResource(Resource* resource, const std::string& filena
 	if (!resource->save(filename))
 		return false;
 
-	std::string message = "Resource: " + resource->getFilename() + " id: " + core::intToString(resource->getID()) + " saved.";
-	if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("ResourceManager", message);
+	LOG_MESSAGE("ResourceManager", "Resource: " + resource->getFilename() + " id: " + core::intToString(resource->getID()) + " saved.", core::LOG_LEVEL_INFORMATION);
 
 	return true;
 }
@@ -271,22 +354,19 @@ void ResourceManager::removeResource(Resource *resource)
 	if (resource == nullptr)
 		return;
 
-	removeResource(resource->getID());
+	removeResource(resource->getHandle());
 }
 
-void ResourceManager::removeResource(const unsigned int& id)
+void ResourceManager::removeResource(const core::Handle& handle)
 {
-	std::map<unsigned int, Resource*>::iterator i = mResources.find(id);
-	if (i != mResources.end())
+	Resource* resource = getResource(handle);
+	if (resource != nullptr)
 	{
-		Resource* resource = i->second;
-
-		assert(resource != nullptr);
-		if (resource == nullptr)
-			return;
+		// Wait for a running asynchronous load to leave the loader threads
+		cancelLoad(resource);
 
 		// Remove entry in map
-		mResources.erase(i);
+		mResources.remove(handle);
 
 		std::map<std::string, Resource*>::iterator j = mResourcesByFilename.find(resource->getFilename());
 		if (j != mResourcesByFilename.end())
@@ -299,7 +379,7 @@ void ResourceManager::removeResource(const unsigned int& id)
 			std::list<Resource*>::iterator k;
 			for (k = mLoadResources[(unsigned int)(resource->getResourceType())].begin(); k != mLoadResources[(unsigned int)(resource->getResourceType())].end(); ++k)
 			{
-				if ((*k)->getID() == id)
+				if ((*k) == resource)
 				{
 					mLoadResources[(unsigned int)(resource->getResourceType())].erase(k);
 					break;
@@ -320,10 +400,14 @@ void ResourceManager::removeResource(const unsigned int& id)
 
 void ResourceManager::removeAllResources()
 {
-	std::map<unsigned int, Resource*>::iterator i;
-	for (i = mResources.begin(); i != mResources.end(); ++i)
+	std::set<Resource*> pendingResources = mPendingResources;
+	std::set<Resource*>::iterator j;
+	for (j = pendingResources.begin(); j != pendingResources.end(); ++j)
+		cancelLoad(*j);
+
+	for (unsigned int i = 0; i < mResources.size(); ++i)
 	{
-		Resource* resource = i->second;
+		Resource* resource = mResources[i];
 
 		assert(resource != nullptr);
 		if (resource == nullptr)
@@ -429,10 +513,14 @@ void ResourceManager::initializeImpl()
 {
 	if (engine::EngineSettings::getInstance() != nullptr)
 		mDataPath =  engine::EngineSettings::getInstance()->getDataPath();
+
+	startLoaderThreads();
 }
 
 void ResourceManager::uninitializeImpl()
 {
+	stopLoaderThreads();
+
 	// Remove all Resources
 	removeAllResources();
 
@@ -455,15 +543,232 @@ void ResourceManager::stopImpl()
 
 void ResourceManager::updateImpl(float elapsedTime)
 {
-	std::map<unsigned int, Resource*>::iterator i;
-	for (i = mResources.begin(); i != mResources.end(); ++i)
+	// resources created since the last update are loaded in the background
+	loadResourcesAsync();
+
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	Resource* resource = nullptr;
+	while (popParsedResource(resource, false))
 	{
-		Resource* resource = i->second;
+		finalizeLoad(resource);
+
+		std::chrono::duration<float, std::milli> finalizeTime = std::chrono::steady_clock::now() - startTime;
+		if (finalizeTime.count() >= mFinalizeTimeBudget)
+			break;
+	}
+
+	for (unsigned int i = 0; i < mResources.size(); ++i)
+	{
+		Resource* resource = mResources[i];
 		if (resource != nullptr)
 			resource->checkAlreadyLoaded();
 	}
 }
 
+void ResourceManager::startLoaderThreads()
+{
+	if (mLoaderRunning)
+		return;
+
+	mLoaderRunning = true;
+
+	for (unsigned int i = 0; i < mLoaderThreadCount; ++i)
+		mLoaderThreads.push_back(new std::thread(&ResourceManager::loaderLoop, this));
+
+	if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("ResourceManager", "Started " + core::intToString(mLoaderThreadCount) + " loader threads.");
+}
+
+void ResourceManager::stopLoaderThreads()
+{
+	{
+		std::lock_guard<std::mutex> lock(mLoadMutex);
+		if (!mLoaderRunning)
+			return;
+
+		mLoaderRunning = false;
+
+		// the resources not parsed yet stay pending and are finalized by a synchronous import
+		mFinalizeQueue.insert(mFinalizeQueue.end(), mParseQueue.begin(), mParseQueue.end());
+		mParseQueue.clear();
+	}
+	mParseCondition.notify_all();
+
+	std::vector<std::thread*>::iterator i;
+	for (i = mLoaderThreads.begin(); i != mLoaderThreads.end(); ++i)
+	{
+		(*i)->join();
+		SAFE_DELETE(*i);
+	}
+	mLoaderThreads.clear();
+}
+
+void ResourceManager::loaderLoop()
+{
+	PROFILE_THREAD_NAME("Resource Loader");
+
+	while (true)
+	{
+		Resource* resource = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(mLoadMutex);
+			while (mLoaderRunning && mParseQueue.empty())
+				mParseCondition.wait(lock);
+
+			if (!mLoaderRunning)
+				return;
+
+			resource = mParseQueue.front();
+			mParseQueue.pop_front();
+			mParsingResources.insert(resource);
+		}
+
+		// a failed parse is finalized anyway, the synchronous import then reports the error
+		resource->parse();
+
+		{
+			std::lock_guard<std::mutex> lock(mLoadMutex);
+			mParsingResources.erase(resource);
+			mFinalizeQueue.push_back(resource);
+		}
+		mParsedCondition.notify_all();
+	}
+}
+
+void ResourceManager::queueLoads(const std::vector<Resource*>& resources)
+{
+	if (resources.empty())
+		return;
+
+	bool loadStarted = mPendingResources.empty();
+	if (loadStarted)
+	{
+		mTotalLoadSize = 0;
+		mLoadedSize = 0;
+	}
+
+	std::vector<Resource*> queuedResources;
+	std::vector<Resource*>::const_iterator i;
+	for (i = resources.begin(); i != resources.end(); ++i)
+	{
+		Resource* resource = (*i);
+		if (resource->getState() == RESOURCE_STATE_LOADED || isLoadPending(resource))
+			continue;
+
+		resource->updateSize();
+		mTotalLoadSize += resource->getSize();
+
+		mPendingResources.insert(resource);
+		queuedResources.push_back(resource);
+	}
+
+	if (queuedResources.empty())
+		return;
+
+	if (loadStarted)
+		fireLoadStarted();
+	else
+		fireLoadUpdate();
+
+	bool parseOnCallingThread = mLoaderThreads.empty();
+	if (parseOnCallingThread)
+	{
+		for (i = queuedResources.begin(); i != queuedResources.end(); ++i)
+			(*i)->parse();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mLoadMutex);
+		if (parseOnCallingThread)
+			mFinalizeQueue.insert(mFinalizeQueue.end(), queuedResources.begin(), queuedResources.end());
+		else
+			mParseQueue.insert(mParseQueue.end(), queuedResources.begin(), queuedResources.end());
+	}
+
+	if (!parseOnCallingThread)
+		mParseCondition.notify_all();
+}
+
+bool ResourceManager::popParsedResource(Resource*& resource, bool wait)
+{
+	std::unique_lock<std::mutex> lock(mLoadMutex);
+
+	if (wait)
+	{
+		while (mFinalizeQueue.empty() && (!mParseQueue.empty() || !mParsingResources.empty()))
+			mParsedCondition.wait(lock);
+	}
+
+	if (mFinalizeQueue.empty())
+		return false;
+
+	resource = mFinalizeQueue.front();
+	mFinalizeQueue.pop_front();
+
+	return true;
+}
+
+void ResourceManager::finalizeLoad(Resource* resource)
+{
+	mPendingResources.erase(resource);
+
+	// the synchronous calls cancel the pending load, this is only a safety net
+	if (resource->getState() != RESOURCE_STATE_LOADED)
+		loadResource(resource);
+
+	if (mPendingResources.empty())
+	{
+		fireLoadEnded();
+
+		mTotalLoadSize = 0;
+		mLoadedSize = 0;
+
+		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("ResourceManager", "Resources loaded.");
+	}
+}
+
+void ResourceManager::cancelLoad(Resource* resource)
+{
+	if (!isLoadPending(resource))
+		return;
+
+	{
+		std::unique_lock<std::mutex> lock(mLoadMutex);
+
+		std::deque<Resource*>::iterator i;
+		for (i = mParseQueue.begin(); i != mParseQueue.end(); ++i)
+		{
+			if ((*i) == resource)
+			{
+				mParseQueue.erase(i);
+				break;
+			}
+		}
+
+		while (mParsingResources.find(resource) != mParsingResources.end())
+			mParsedCondition.wait(lock);
+
+		for (i = mFinalizeQueue.begin(); i != mFinalizeQueue.end(); ++i)
+		{
+			if ((*i) == resource)
+			{
+				mFinalizeQueue.erase(i);
+				break;
+			}
+		}
+	}
+
+	mPendingResources.erase(resource);
+
+	if (mPendingResources.empty())
+	{
+		fireLoadEnded();
+
+		mTotalLoadSize = 0;
+		mLoadedSize = 0;
+	}
+}
+
 ResourceManager* ResourceManager::getInstance()
 {
 	return core::Singleton<ResourceManager>::getInstance();
@@ -522,6 +522,16 @@ void SceneSerializer::importGameObjects(tinyxml2::XMLElement* rootElement, game:
 									pModel->setMaterial(svalue);
 								}
 							}
+
+							pComponentSubElement = pSubElement->FirstChildElement("static");
+							if (pComponentSubElement != nullptr)
+							{
+								svalue = pComponentSubElement->Attribute("value");
+								if (svalue != nullptr)
+								{
+									pModel->setStatic((std::string(svalue) == "true") ? true : false);
+								}
+							}
 						}
 						break;
 					case game::COMPONENT_TYPE_BODY:
@@ -36,6 +36,8 @@ THE SOFTWARE.
 namespace resource
 {
 
+SerializerData::~SerializerData() {}
+
 Serializer::Serializer()
 {
 	// Version number
@@ -44,6 +46,21 @@ Serializer::Serializer()
 
 Serializer::~Serializer() {}
 
+bool Serializer::canParseAsync() const
+{
+	return false;
+}
+
+SerializerData* Serializer::parseResource(Resource* dest, const std::string& filename)
+{
+	return nullptr;
+}
+
+bool Serializer::finalizeResource(Resource* dest, SerializerData* data)
+{
+	return false;
+}
+
 core::vector3d parseVector3d(std::string& params)
 {
 #ifdef _DEBUG
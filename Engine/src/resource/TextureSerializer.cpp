@@ -33,11 +33,32 @@ THE SOFTWARE.
 #include <render/Texture.h>
 #include <render/Color.h>
 
+#if !defined(ENGINE_NO_FREEIMAGE)
 #include <FreeImage.h>
+#endif
+
+#include <vector>
 
 namespace resource
 {
 
+//! Decoded image waiting to be handed to the texture.
+class TextureSerializerData: public SerializerData
+{
+public:
+
+	TextureSerializerData(): width(0), height(0), depth(1), pixelSize(0), pixelFormat(PF_UNKNOWN) {}
+
+	std::vector<unsigned char> buffer;
+
+	unsigned int width;
+	unsigned int height;
+	unsigned int depth;
+	unsigned int pixelSize;
+	PixelFormat pixelFormat;
+};
+
+#if !defined(ENGINE_NO_FREEIMAGE)
 /**
 FreeImage error handler
 @param fif Format / Plugin responsible for the error 
@@ -53,42 +74,75 @@ void FreeImageErrorHandler(FREE_IMAGE_FORMAT fif, const char *message)
 	printf(message);
 	printf(" ***\n");
 }
+#endif
 
 TextureSerializer::TextureSerializer()
 {
 	// Version number
 	mVersion = "[TextureSerializer_v1.00]";
+#if !defined(ENGINE_NO_FREEIMAGE)
 	FreeImage_Initialise(false);
 
 	// initialize your own FreeImage error handler
 	FreeImage_SetOutputMessage(FreeImageErrorHandler);
+#endif
 }
 
 TextureSerializer::~TextureSerializer()
 {
+#if !defined(ENGINE_NO_FREEIMAGE)
 	FreeImage_DeInitialise();
+#endif
 }
 
 bool TextureSerializer::importResource(Resource* dest, const std::string& filename)
+{
+	SerializerData* pData = parseResource(dest, filename);
+	if (pData == nullptr)
+		return false;
+
+	bool result = finalizeResource(dest, pData);
+
+	SAFE_DELETE(pData);
+
+	return result;
+}
+
+bool TextureSerializer::exportResource(Resource* source, const std::string& filename)
+{
+	return true;
+}
+
+bool TextureSerializer::canParseAsync() const
+{
+	return true;
+}
+
+SerializerData* TextureSerializer::parseResource(Resource* dest, const std::string& filename)
 {
 	assert(dest != nullptr);
 	if (dest == nullptr)
-		return false;
+		return nullptr;
 
 	if (dest->getResourceType() != RESOURCE_TYPE_TEXTURE)
 	{
 		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("TextureSerializer", "Unable to load texture - invalid resource pointer.", core::LOG_LEVEL_ERROR);
-		return false;
+		return nullptr;
 	}
 
 	if (resource::ResourceManager::getInstance() == nullptr)
 	{
 		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("TextureSerializer", "Unable to load texture - resources data path not set.", core::LOG_LEVEL_ERROR);
-		return false;
+		return nullptr;
 	}
 
 	std::string filePath = resource::ResourceManager::getInstance()->getDataPath() + "/" + filename;
 
+#if defined(ENGINE_NO_FREEIMAGE)
+	// Built without an image library, the textures keep no image
+	if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("TextureSerializer", "Unable to decode image: " + filePath + " - built without FreeImage.", core::LOG_LEVEL_ERROR);
+	return nullptr;
+#else
 	FREE_IMAGE_FORMAT fi_format = FreeImage_GetFileType(filePath.c_str());
 	FIBITMAP *fi_bitmap = FreeImage_Load(fi_format, filePath.c_str());
 
@@ -98,14 +152,9 @@ bool TextureSerializer::importResource(Resource* dest, const std::string& filena
 	if (!fi_bitmap)
 	{
 		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("TextureSerializer", "Error decoding image.", core::LOG_LEVEL_ERROR);
-		return false;
+		return nullptr;
 	}
 
-	render::Texture* tex = static_cast<render::Texture*>(dest);
-	assert(tex != nullptr);
-	if (tex == nullptr)
-		return false;
-
 	unsigned int width = FreeImage_GetWidth(fi_bitmap);
 	unsigned int height = FreeImage_GetHeight(fi_bitmap);
 	unsigned int bytes = FreeImage_GetBPP(fi_bitmap);
@@ -204,10 +253,11 @@ bool TextureSerializer::importResource(Resource* dest, const std::string& filena
 	unsigned int dstPitch = width * PixelUtil::getNumElemBytes(pixelFormat);
 	unsigned int size = dstPitch * height;
 
-	unsigned char *pBuffer = new unsigned char[size];
+	TextureSerializerData* pData = new TextureSerializerData();
+	pData->buffer.resize(size);
 
 	unsigned char* pSrc;
-	unsigned char* pDst = pBuffer;
+	unsigned char* pDst = &pData->buffer[0];
 	for (size_t y = 0; y < height; ++y)
 	{
 		pSrc = pSrcData + (height - y - 1) * srcPitch;
@@ -217,26 +267,39 @@ bool TextureSerializer::importResource(Resource* dest, const std::string& filena
 
 	FreeImage_Unload(fi_bitmap);
 
-	tex->setBuffer(pBuffer, size);
+	pData->width = width;
+	pData->height = height;
+	pData->depth = depth;
+	pData->pixelSize = bytes;
+	pData->pixelFormat = pixelFormat;
+
+	return pData;
+#endif
+}
+
+bool TextureSerializer::finalizeResource(Resource* dest, SerializerData* data)
+{
+	assert(dest != nullptr);
+	if (dest == nullptr || data == nullptr)
+		return false;
+
+	render::Texture* tex = static_cast<render::Texture*>(dest);
+	TextureSerializerData* pData = static_cast<TextureSerializerData*>(data);
 
-	SAFE_DELETE_ARRAY(pBuffer);
+	if (!pData->buffer.empty())
+		tex->setBuffer(&pData->buffer[0], (unsigned int)pData->buffer.size());
 
-	tex->setWidth(width);
-	tex->setHeight(height);
-	tex->setDepth(depth);
+	tex->setWidth(pData->width);
+	tex->setHeight(pData->height);
+	tex->setDepth(pData->depth);
 	tex->setNumMipMaps(0);
 	tex->setFlags(0);
 
-	tex->setPixelSize(bytes);
-	tex->setPixelFormat(pixelFormat);
-
-	tex->hasAlpha(PixelUtil::hasAlpha(pixelFormat));
+	tex->setPixelSize(pData->pixelSize);
+	tex->setPixelFormat(pData->pixelFormat);
 
-	return true;
-}
+	tex->hasAlpha(PixelUtil::hasAlpha(pData->pixelFormat));
 
-bool TextureSerializer::exportResource(Resource* source, const std::string& filename)
-{
 	return true;
 }
 
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include <game/GameObject.h>
 #include <game/Transform.h>
 #include <game/ComponentDefines.h>
+#include <game/MessageDefines.h>
 
 namespace sound
 {
@@ -36,6 +37,7 @@ namespace sound
 Listener::Listener(): game::Component()
 {
 	mType = game::COMPONENT_TYPE_LISTENER;
+	mMessageMask = MESSAGE_MASK_NONE;
 
 	mLastPosition = core::vector3d::ORIGIN_3D;
 	mVelocity = core::vector3d::ORIGIN_3D;
@@ -55,7 +57,7 @@ void Listener::updateImpl(float elapsedTime)
 
 	if (mGameObject != nullptr)
 	{
-		game::Transform* pTransform = static_cast<game::Transform*>(mGameObject->getComponent(game::COMPONENT_TYPE_TRANSFORM));
+		game::Transform* pTransform = mGameObject->getTransform();
 		if (pTransform != nullptr)
 		{
 			core::vector3d delta = pTransform->getAbsolutePosition() - mLastPosition;
@@ -31,14 +31,14 @@ THE SOFTWARE.
 namespace sound
 {
 
-ListenerFactory::ListenerFactory(): game::ComponentFactory()
+ListenerFactory::ListenerFactory(): game::PooledComponentFactory<Listener>()
 {
 	mName = "Listener";
 }
 
 game::Component* ListenerFactory::createComponent()
 {
-	Listener* pListener = new Listener();
+	Listener* pListener = mPool.create();
 
 	if (SoundManager::getInstance() != nullptr)
 		SoundManager::getInstance()->addListener(pListener);
@@ -54,7 +54,7 @@ void ListenerFactory::destroyComponent(game::Component* component)
 		SoundManager::getInstance()->removeListener(pListener);
 
 	assert(pListener != nullptr);
-	SAFE_DELETE(pListener);
+	mPool.destroy(pListener);
 }
 
 } // end namespace game
\ No newline at end of file
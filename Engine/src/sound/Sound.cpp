@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include <game/GameObject.h>
 #include <game/Transform.h>
 #include <game/ComponentDefines.h>
+#include <game/MessageDefines.h>
 #include <resource/ResourceEvent.h>
 #include <resource/ResourceManager.h>
 #include <core/Vector3d.h>
@@ -40,6 +41,7 @@ namespace sound
 Sound::Sound(): game::Component()
 {
 	mType = game::COMPONENT_TYPE_SOUND;
+	mMessageMask = MESSAGE_MASK_NONE;
 
 	mSoundData = nullptr;
 
@@ -289,7 +291,7 @@ void Sound::updateImpl(float elapsedTime)
 
 	if (mGameObject != nullptr)
 	{
-		game::Transform* pTransform = static_cast<game::Transform*>(mGameObject->getComponent(game::COMPONENT_TYPE_TRANSFORM));
+		game::Transform* pTransform = mGameObject->getTransform();
 		if (pTransform != nullptr)
 		{
 			core::vector3d delta = pTransform->getAbsolutePosition() - mLastPosition;
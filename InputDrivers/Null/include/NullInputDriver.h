@@ -0,0 +1,124 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _NULL_INPUT_DRIVER_H_
+#define _NULL_INPUT_DRIVER_H_
+
+#include <NullInputConfig.h>
+#include <NullInputDefines.h>
+#include <core/Singleton.h>
+#include <input/InputDriver.h>
+#include <input/KeyboardDefines.h>
+#include <input/MouseDefines.h>
+
+#include <list>
+
+namespace input
+{
+
+class NullKeyboard;
+class NullMouse;
+class NullCursor;
+
+//! An input event waiting in the script of the null input driver.
+struct NULLINPUT_PUBLIC_EXPORT NullInputEvent
+{
+	NullInputEvent();
+
+	NullInputEventType type;
+	float time;
+	KeyCode key;
+	MouseButton button;
+	int axisX;
+	int axisY;
+};
+
+//! Input driver without input hardware.
+//!
+//! Input comes from a script of queued events instead of the operating system.
+//! Each event is delivered to the keyboard and mouse devices once the driver time
+//! reaches it, so automated runs see the same event flow as interactive ones.
+class NULLINPUT_PUBLIC_EXPORT NullInputDriver: public InputDriver, public core::Singleton<NullInputDriver>
+{
+public:
+
+	NullInputDriver();
+	~NullInputDriver();
+
+	int numJoySticks();
+	int numMice();
+	int numKeyboards();
+
+	InputDevice* createInputDevice(InputType type, bool buffered);
+
+	void removeInputDevice(InputDevice* device);
+
+	//! Queues a key press, delivered after delay seconds.
+	void queueKeyPressed(KeyCode key, float delay = 0.0f);
+
+	//! Queues a key release, delivered after delay seconds.
+	void queueKeyReleased(KeyCode key, float delay = 0.0f);
+
+	//! Queues a mouse button press, delivered after delay seconds.
+	void queueMousePressed(MouseButton button, float delay = 0.0f);
+
+	//! Queues a mouse button release, delivered after delay seconds.
+	void queueMouseReleased(MouseButton button, float delay = 0.0f);
+
+	//! Queues a relative mouse move, delivered after delay seconds.
+	void queueMouseMoved(int axisX, int axisY, float delay = 0.0f);
+
+	//! Removes all the events that were not delivered yet.
+	void clearQueuedEvents();
+
+	//! Returns the number of events that were not delivered yet.
+	unsigned int getQueuedEventCount() const;
+
+	//! Returns the time in seconds the driver was updated for.
+	float getTime() const;
+
+	static NullInputDriver* getInstance();
+
+protected:
+
+	void initializeImpl();
+	void uninitializeImpl();
+	void updateImpl(float elapsedTime);
+
+	void queueEvent(const NullInputEvent& evt, float delay);
+	void sendEvent(const NullInputEvent& evt);
+
+	NullKeyboard* mNullKeyboard;
+	NullMouse* mNullMouse;
+
+	// Kept sorted by time, events with the same time stay in the order they were queued
+	std::list<NullInputEvent> mEvents;
+	float mTime;
+};
+
+} // end namespace input
+
+#endif
\ No newline at end of file
@@ -0,0 +1,63 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _NULL_KEYBOARD_H_
+#define _NULL_KEYBOARD_H_
+
+#include <NullInputConfig.h>
+#include <input/Keyboard.h>
+#include <input/KeyboardDefines.h>
+
+#include <bitset>
+
+namespace input
+{
+
+class NULLINPUT_PUBLIC_EXPORT NullKeyboard: public Keyboard
+{
+public:
+
+	//! Constructor
+	NullKeyboard(bool buffered);
+
+	//! Destructor
+	~NullKeyboard();
+
+	void sendKeyDown(KeyCode key);
+	void sendKeyUp(KeyCode key);
+
+protected:
+
+	void initializeImpl();
+	void uninitializeImpl();
+	void updateImpl(float elapsedTime);
+
+	std::bitset<KEY_MODIFIER_COUNT> mModifiers;
+};
+
+} // end namespace input
+
+#endif
\ No newline at end of file
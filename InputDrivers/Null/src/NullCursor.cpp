@@ -0,0 +1,78 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <NullCursor.h>
+
+namespace input
+{
+
+NullCursor::NullCursor()
+{
+	mVisible = true;
+	mMotion = core::position2d::ORIGIN_2D;
+}
+
+NullCursor::~NullCursor() {}
+
+void NullCursor::setVisible(bool set)
+{
+	mVisible = set;
+}
+
+bool NullCursor::isVisible() const
+{
+	return mVisible && !mAutoCenter;
+}
+
+void NullCursor::setPosition(const core::position2d& pos)
+{
+	setPosition(pos.x, pos.y);
+}
+
+void NullCursor::setPosition(int x, int y)
+{
+	// Warping the cursor is not a motion
+	mAbsolutePosition.x = x;
+	mAbsolutePosition.y = y;
+}
+
+void NullCursor::move(int axisX, int axisY)
+{
+	mMotion.x += axisX;
+	mMotion.y += axisY;
+
+	mAbsolutePosition.x += axisX;
+	mAbsolutePosition.y += axisY;
+}
+
+void NullCursor::updateImpl(float elapsedTime)
+{
+	// The relative position is the motion since the last update
+	mPosition = mMotion;
+	mMotion = core::position2d::ORIGIN_2D;
+}
+
+} // end namespace input
\ No newline at end of file
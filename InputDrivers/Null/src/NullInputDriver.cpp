@@ -0,0 +1,278 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <core/Position2d.h>
+#include <engine/EngineSettings.h>
+#include <NullInputDriver.h>
+#include <NullCursor.h>
+#include <NullMouse.h>
+#include <NullKeyboard.h>
+
+template<> input::NullInputDriver* core::Singleton<input::NullInputDriver>::m_Singleton = nullptr;
+
+namespace input
+{
+
+NullInputEvent::NullInputEvent()
+{
+	type = NULL_INPUT_EVENT_KEY_PRESSED;
+	time = 0.0f;
+	key = KEY_UNKNOWN;
+	button = MOUSE_BUTTON_UNKNOWN;
+	axisX = 0;
+	axisY = 0;
+}
+
+NullInputDriver::NullInputDriver(): InputDriver("Null InputDriver")
+{
+	mCursor = new NullCursor();
+
+	mNullKeyboard = nullptr;
+	mNullMouse = nullptr;
+
+	mTime = 0.0f;
+}
+
+NullInputDriver::~NullInputDriver() {}
+
+int NullInputDriver::numJoySticks()
+{
+	return 0;
+}
+
+int NullInputDriver::numMice()
+{
+	return 1;
+}
+
+int NullInputDriver::numKeyboards()
+{
+	return 1;
+}
+
+InputDevice* NullInputDriver::createInputDevice(InputType type, bool buffered)
+{
+	InputDevice* device = nullptr;
+	switch (type)
+	{
+		case INPUT_TYPE_KEYBOARD:
+			mNullKeyboard = new NullKeyboard(buffered);
+			device = mNullKeyboard;
+			break;
+		case INPUT_TYPE_MOUSE:
+			mNullMouse = new NullMouse(buffered);
+			device = mNullMouse;
+			break;
+		default:
+			device = nullptr;
+	}
+
+	if (device != nullptr)
+		device->initialize();
+
+	return device;
+}
+
+void NullInputDriver::removeInputDevice(InputDevice* device)
+{
+	assert(device);
+
+	if (device == mNullKeyboard)
+		mNullKeyboard = nullptr;
+	if (device == mNullMouse)
+		mNullMouse = nullptr;
+
+	SAFE_DELETE(device);
+}
+
+void NullInputDriver::queueKeyPressed(KeyCode key, float delay)
+{
+	NullInputEvent evt;
+	evt.type = NULL_INPUT_EVENT_KEY_PRESSED;
+	evt.key = key;
+
+	queueEvent(evt, delay);
+}
+
+void NullInputDriver::queueKeyReleased(KeyCode key, float delay)
+{
+	NullInputEvent evt;
+	evt.type = NULL_INPUT_EVENT_KEY_RELEASED;
+	evt.key = key;
+
+	queueEvent(evt, delay);
+}
+
+void NullInputDriver::queueMousePressed(MouseButton button, float delay)
+{
+	NullInputEvent evt;
+	evt.type = NULL_INPUT_EVENT_MOUSE_PRESSED;
+	evt.button = button;
+
+	queueEvent(evt, delay);
+}
+
+void NullInputDriver::queueMouseReleased(MouseButton button, float delay)
+{
+	NullInputEvent evt;
+	evt.type = NULL_INPUT_EVENT_MOUSE_RELEASED;
+	evt.button = button;
+
+	queueEvent(evt, delay);
+}
+
+void NullInputDriver::queueMouseMoved(int axisX, int axisY, float delay)
+{
+	NullInputEvent evt;
+	evt.type = NULL_INPUT_EVENT_MOUSE_MOVED;
+	evt.axisX = axisX;
+	evt.axisY = axisY;
+
+	queueEvent(evt, delay);
+}
+
+void NullInputDriver::clearQueuedEvents()
+{
+	mEvents.clear();
+}
+
+unsigned int NullInputDriver::getQueuedEventCount() const
+{
+	return (unsigned int)mEvents.size();
+}
+
+float NullInputDriver::getTime() const
+{
+	return mTime;
+}
+
+void NullInputDriver::initializeImpl()
+{
+	mTime = 0.0f;
+
+	// There is no window, the center comes from the configured resolution
+	if (engine::EngineSettings::getInstance() != nullptr)
+	{
+		mCursorCenter.x = (int)(engine::EngineSettings::getInstance()->getWidth() / 2);
+		mCursorCenter.y = (int)(engine::EngineSettings::getInstance()->getHeight() / 2);
+	}
+
+	if (mCursor != nullptr)
+		mCursor->setPosition(mCursorCenter);
+}
+
+void NullInputDriver::uninitializeImpl()
+{
+	SAFE_DELETE(mCursor);
+
+	mEvents.clear();
+}
+
+void NullInputDriver::updateImpl(float elapsedTime)
+{
+	mTime += elapsedTime;
+
+	if (mCursor != nullptr && mCursor->isAutoCenter())
+		mCursor->setPosition(mCursorCenter);
+
+	// Deliver everything that is due, events queued while delivering wait for the next update
+	std::list<NullInputEvent> dueEvents;
+	std::list<NullInputEvent>::iterator i = mEvents.begin();
+	while (i != mEvents.end() && i->time <= mTime)
+		++i;
+	dueEvents.splice(dueEvents.end(), mEvents, mEvents.begin(), i);
+
+	std::list<NullInputEvent>::const_iterator j;
+	for (j = dueEvents.begin(); j != dueEvents.end(); ++j)
+		sendEvent(*j);
+}
+
+void NullInputDriver::queueEvent(const NullInputEvent& evt, float delay)
+{
+	NullInputEvent newEvent = evt;
+	newEvent.time = mTime + (delay > 0.0f ? delay : 0.0f);
+
+	// Insert after the last event that is not later, scripts are mostly queued in order
+	std::list<NullInputEvent>::iterator i = mEvents.end();
+	while (i != mEvents.begin())
+	{
+		std::list<NullInputEvent>::iterator previous = i;
+		--previous;
+		if (previous->time <= newEvent.time)
+			break;
+		i = previous;
+	}
+
+	mEvents.insert(i, newEvent);
+}
+
+void NullInputDriver::sendEvent(const NullInputEvent& evt)
+{
+	switch (evt.type)
+	{
+		case NULL_INPUT_EVENT_KEY_PRESSED:
+		{
+			if (mNullKeyboard != nullptr)
+				mNullKeyboard->sendKeyDown(evt.key);
+		}
+		break;
+		case NULL_INPUT_EVENT_KEY_RELEASED:
+		{
+			if (mNullKeyboard != nullptr)
+				mNullKeyboard->sendKeyUp(evt.key);
+		}
+		break;
+		case NULL_INPUT_EVENT_MOUSE_PRESSED:
+		{
+			if (mNullMouse != nullptr)
+				mNullMouse->sendButtonDown(evt.button);
+		}
+		break;
+		case NULL_INPUT_EVENT_MOUSE_RELEASED:
+		{
+			if (mNullMouse != nullptr)
+				mNullMouse->sendButtonUp(evt.button);
+		}
+		break;
+		case NULL_INPUT_EVENT_MOUSE_MOVED:
+		{
+			NullCursor* pCursor = static_cast<NullCursor*>(mCursor);
+			if (pCursor != nullptr)
+				pCursor->move(evt.axisX, evt.axisY);
+
+			if (mNullMouse != nullptr)
+				mNullMouse->sendMove(evt.axisX, evt.axisY);
+		}
+		break;
+	}
+}
+
+NullInputDriver* NullInputDriver::getInstance()
+{
+	return core::Singleton<NullInputDriver>::getInstance();
+}
+
+} // end namespace input
\ No newline at end of file
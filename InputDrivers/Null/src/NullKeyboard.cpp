@@ -0,0 +1,89 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <input/KeyEvent.h>
+#include <input/KeyEventReceiver.h>
+#include <NullKeyboard.h>
+
+namespace input
+{
+
+NullKeyboard::NullKeyboard(bool buffered): Keyboard()
+{
+	mBuffered = buffered;
+	mVendor = "Null Keyboard";
+}
+
+NullKeyboard::~NullKeyboard() {}
+
+void NullKeyboard::sendKeyDown(KeyCode key)
+{
+	//Turn on modifier
+	if (key == KEY_LCONTROL || key == KEY_RCONTROL)
+		mModifiers.set(KEY_MODIFIER_CTRL);
+	else if (key == KEY_LSHIFT || key == KEY_RSHIFT)
+		mModifiers.set(KEY_MODIFIER_SHIFT);
+	else if (key == KEY_LMENU || key == KEY_RMENU)
+		mModifiers.set(KEY_MODIFIER_ALT);
+
+	mEvent->set(key, mModifiers, 0, this);
+
+	std::list<input::KeyEventReceiver*>::const_iterator j;
+	for (j = mKeyEventReceivers.begin(); j != mKeyEventReceivers.end(); ++j)
+	{
+		(*j)->keyPressed(*mEvent);
+	}
+}
+
+void NullKeyboard::sendKeyUp(KeyCode key)
+{
+	//Turn off modifier
+	if (key == KEY_LCONTROL || key == KEY_RCONTROL)
+		mModifiers.reset(KEY_MODIFIER_CTRL);
+	else if (key == KEY_LSHIFT || key == KEY_RSHIFT)
+		mModifiers.reset(KEY_MODIFIER_SHIFT);
+	else if (key == KEY_LMENU || key == KEY_RMENU)
+		mModifiers.reset(KEY_MODIFIER_ALT);
+
+	mEvent->set(key, mModifiers, 0, this);
+
+	std::list<input::KeyEventReceiver*>::const_iterator j;
+	for (j = mKeyEventReceivers.begin(); j != mKeyEventReceivers.end(); ++j)
+	{
+		(*j)->keyReleased(*mEvent);
+	}
+}
+
+void NullKeyboard::initializeImpl()
+{
+	mModifiers.reset();
+}
+
+void NullKeyboard::uninitializeImpl() {}
+
+void NullKeyboard::updateImpl(float elapsedTime) {}
+
+} // end namespace input
\ No newline at end of file
@@ -0,0 +1,77 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <EngineConfig.h>
+#include <core/Log.h>
+#include <resource/MeshSerializer.h>
+#include <resource/MeshFileDefines.h>
+
+#include <iostream>
+#include <string>
+
+//! Converts .xml meshes to the binary .kgmesh format loaded by the MeshSerializer.
+//! Usage: MeshConverter input.xml [output.kgmesh]
+//! When no output is given the input extension is replaced with .kgmesh.
+int main(int argc, char** argv)
+{
+	if (argc < 2 || argc > 3)
+	{
+		std::cout<<"Usage: MeshConverter input.xml [output"<<resource::MESH_FILE_EXTENSION<<"]"<<std::endl;
+		return 1;
+	}
+
+	std::string sourcePath = argv[1];
+	std::string destinationPath;
+
+	if (argc == 3)
+	{
+		destinationPath = argv[2];
+	}
+	else
+	{
+		std::string::size_type dot = sourcePath.find_last_of('.');
+		std::string::size_type slash = sourcePath.find_last_of("/\\");
+		if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+			destinationPath = sourcePath + resource::MESH_FILE_EXTENSION;
+		else
+			destinationPath = sourcePath.substr(0, dot) + resource::MESH_FILE_EXTENSION;
+	}
+
+	core::Log* pLog = new core::Log();
+	resource::MeshSerializer* pMeshSerializer = new resource::MeshSerializer();
+
+	bool result = pMeshSerializer->convertMesh(sourcePath, destinationPath);
+
+	if (result)
+		std::cout<<sourcePath<<" -> "<<destinationPath<<std::endl;
+	else
+		std::cerr<<"Unable to convert "<<sourcePath<<", see engine.log for details."<<std::endl;
+
+	SAFE_DELETE(pMeshSerializer);
+	SAFE_DELETE(pLog);
+
+	return result ? 0 : 1;
+}
\ No newline at end of file
@@ -29,11 +29,13 @@ THE SOFTWARE.
 
 #include <BulletConfig.h>
 #include <physics/BodyFactory.h>
+#include <game/PooledComponentFactory.h>
+#include <BulletBody.h>
 
 namespace physics
 {
 
-class BULLET_PUBLIC_EXPORT BulletBodyFactory: public BodyFactory
+class BULLET_PUBLIC_EXPORT BulletBodyFactory: public game::PooledComponentFactory<BulletBody, BodyFactory>
 {
 public:
 
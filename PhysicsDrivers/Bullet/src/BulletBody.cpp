@@ -48,6 +48,8 @@ BulletBody::BulletBody(): Body()
 	mMotionState = nullptr;
 
 	mBodyNeedsUpdate = true;
+
+	mMessageMask = MESSAGE_MASK(game::MESSAGE_TRANSFORM_NEEDS_UPDATE);
 }
 
 BulletBody::~BulletBody() {}
@@ -202,7 +204,7 @@ void BulletBody::initializeImpl()
 	
 	if (mGameObject != nullptr)
 	{
-		game::Transform* pTransform = static_cast<game::Transform*>(mGameObject->getComponent(game::COMPONENT_TYPE_TRANSFORM));
+		game::Transform* pTransform = mGameObject->getTransform();
 		if (pTransform != nullptr)
 		{
 			core::vector3d position = pTransform->getAbsolutePosition();
@@ -340,7 +342,7 @@ void BulletBody::updateImpl(float elapsedTime)
 
 		if (mGameObject != nullptr)
 		{
-			game::Transform* pTransform = static_cast<game::Transform*>(mGameObject->getComponent(game::COMPONENT_TYPE_TRANSFORM));
+			game::Transform* pTransform = mGameObject->getTransform();
 			if (pTransform != nullptr)
 			{
 				pTransform->setPosition(globalPos.getX(), globalPos.getY(), globalPos.getZ());
@@ -358,7 +360,7 @@ void BulletBody::updateImpl(float elapsedTime)
 		
 		if (mGameObject != nullptr)
 		{
-			game::Transform* pTransform = static_cast<game::Transform*>(mGameObject->getComponent(game::COMPONENT_TYPE_TRANSFORM));
+			game::Transform* pTransform = mGameObject->getTransform();
 			if (pTransform != nullptr)
 			{
 				core::vector3d position = pTransform->getAbsolutePosition();
@@ -34,7 +34,7 @@ namespace physics
 
 game::Component* BulletBodyFactory::createComponent()
 {
-	BulletBody* pBody = new BulletBody();
+	BulletBody* pBody = mPool.create();
 
 	if (PhysicsManager::getInstance() != nullptr)
 		PhysicsManager::getInstance()->addBody(pBody);
@@ -50,7 +50,7 @@ void BulletBodyFactory::destroyComponent(game::Component* component)
 		PhysicsManager::getInstance()->removeBody(pBody);
 
 	assert(pBody != nullptr);
-	SAFE_DELETE(pBody);
+	mPool.destroy(pBody);
 }
 
 } // end namespace physics
@@ -60,6 +60,9 @@ public:
 
 	GLhandleARB getGLHandle() const;
 
+	//! Gets the location of the instance_world_matrix attribute, its columns take this and the next three locations.
+	GLuint getInstanceAttributeLocation() const;
+
 protected:
 
 	bool loadImpl();
@@ -69,6 +72,13 @@ protected:
 	ShaderVertexParameter* createVertexParameterImpl();
 	ShaderParameter* createParameterImpl();
 
+	unsigned int getParameterLocationImpl(ShaderParameter* parameter);
+
+	//! Binds the FrameParameters, CameraParameters and ObjectParameters uniform blocks of the program to the
+	//! binding points of their frequencies, the auto parameters are then read from the uniform ring buffer.
+	//! The member offsets have to match the std140 layout of the parameter program, in declaration order.
+	void setupParameterBlocks();
+
 	void setParameterImpl(ShaderParameter* parameter, const Color& col);
 	void setParameterImpl(ShaderParameter* parameter, const core::vector2d& vec);
 	void setParameterImpl(ShaderParameter* parameter, const core::vector3d& vec);
@@ -78,6 +88,8 @@ protected:
 	static GLenum getGLType(ShaderParameterType type);
 
 	GLhandleARB mGLHandle;
+
+	GLuint mInstanceAttributeLocation;
 };
 
 } //namespace render
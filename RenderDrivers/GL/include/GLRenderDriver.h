@@ -41,6 +41,9 @@ class Serializer;
 namespace render
 {
 
+class Model;
+class LightCuller;
+struct ShaderParameterInstruction;
 class VertexBuffer;
 class IndexBuffer;
 enum VertexBufferType;
@@ -68,6 +71,9 @@ public:
 
 	void render(RenderStateData& renderStateData);
 
+	//! Draws the instances with one glDrawElementsInstanced, their data is streamed into a buffer the instance_world_matrix attribute reads.
+	void renderInstances(RenderStateData& renderStateData, const RenderCommand* commands, unsigned int count, const float* instanceData);
+
 	void endFrame();
 
 	void setViewport(Viewport* viewport);
@@ -78,6 +84,20 @@ public:
 	static GLenum getGLType(VertexElementType type);
 	static GLenum getGLType(RenderOperationType type);
 
+	//! State changes routed through the state cache, so the GL calls are only issued when the state differs.
+	static void bindProgram(GLuint program);
+	static void bindBuffer(GLenum target, GLuint buffer);
+	static void bindTexture(unsigned int unit, GLenum target, GLuint texture);
+	static bool isUniformChanged(GLuint location, const void* data, unsigned int size);
+
+	//! Deletes GL objects and makes the state cache forget them.
+	static void deleteProgram(GLuint program);
+	static void deleteBuffer(GLuint buffer);
+	static void deleteTexture(GLuint texture);
+
+	//! Makes the state cache forget the uniform values of a program that was linked again.
+	static void notifyProgramLinked(GLuint program);
+
 	static GLRenderDriver* getInstance();
 
 protected:
@@ -85,6 +105,42 @@ protected:
 	void initializeImpl();
 	void uninitializeImpl();
 	void updateImpl(float elapsedTime);
+
+	//! Binds the material, its parameters and the vertex buffers of the current model.
+	//! \param instanceAttributes: Mask of the attributes the instance data is read by, they are left enabled.
+	//! \return The model to draw, nullptr if it can't be drawn.
+	Model* setupDraw(RenderStateData& renderStateData, unsigned int instanceAttributes);
+
+	//! Uploads the light lists into the cluster buffers when the light culler rebuilt them.
+	//! \return false if there are no light lists or buffer textures are not supported.
+	bool updateLightClusters(LightCuller* lightCuller);
+
+	//! Sets the value of a parameter program instruction in the current program.
+	//! \param textureUnit: First texture unit after the material textures.
+	void setAutoParameter(RenderStateData& renderStateData, const ShaderParameterInstruction& instruction, unsigned int textureUnit);
+
+	//! Uploads the written uniform blocks with one glBufferSubData per range, the storage is specified again when the ring grew.
+	void uploadUniformBuffer();
+
+	//! Buffer the instance data is streamed into.
+	GLuint mInstanceBuffer;
+
+	bool mInstancingSupported;
+
+	//! Buffers and buffer textures of the cluster grid, the light indices and the light data.
+	GLuint mClusterBuffers[3];
+	GLuint mClusterTextures[3];
+
+	//! Version of the light lists in the cluster buffers.
+	unsigned int mClusterVersion;
+
+	bool mTextureBuffersSupported;
+
+	//! Buffer the uniform blocks are read from and the size of its storage.
+	GLuint mUniformBufferId;
+	unsigned int mUniformBufferSize;
+
+	bool mUniformBlocksSupported;
 };
 
 } // end namespace render
@@ -43,7 +43,7 @@ GLIndexBuffer::GLIndexBuffer(IndexType idxType, unsigned int numIndexes, resourc
 		return;
 	}
 
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
+	GLRenderDriver::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
 
 	// Initialize buffer and set usage
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, mSizeInBytes, nullptr, GLRenderDriver::getGLUsage(usage));
@@ -51,18 +51,18 @@ GLIndexBuffer::GLIndexBuffer(IndexType idxType, unsigned int numIndexes, resourc
 
 GLIndexBuffer::~GLIndexBuffer() 
 {
-	glDeleteBuffers(1, &mBufferId);
+	GLRenderDriver::deleteBuffer(mBufferId);
 }
 
 void GLIndexBuffer::readData(unsigned int offset, unsigned int length, void* pDest)
 {
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
+	GLRenderDriver::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
 	glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset, length, pDest);
 }
 
 void GLIndexBuffer::writeData(unsigned int offset, unsigned int length, const void* pSource, bool discardWholeBuffer)
 {
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
+	GLRenderDriver::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
 
 	if (offset == 0 && length == mSizeInBytes)
 	{
@@ -95,7 +95,7 @@ void* GLIndexBuffer::lockImpl(unsigned int offset, unsigned int length, resource
 		return nullptr;
 	}
 
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
+	GLRenderDriver::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
 
 	if(options == resource::BL_DISCARD)
 	{
@@ -138,7 +138,7 @@ void* GLIndexBuffer::lockImpl(unsigned int offset, unsigned int length, resource
 
 void GLIndexBuffer::unlockImpl()
 {
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
+	GLRenderDriver::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
 
 	if(!glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER))
 	{
@@ -24,8 +24,11 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 
+#include <core/Log.h>
+#include <core/LogDefines.h>
 #include <GLMaterial.h>
 #include <GLShader.h>
+#include <GLRenderDriver.h>
 #include <render/Shader.h>
 #include <resource/ResourceEvent.h>
 
@@ -47,6 +50,7 @@ GLShaderVertexParameter::GLShaderVertexParameter(): ShaderVertexParameter()
 GLMaterial::GLMaterial(const std::string& name, resource::Serializer* serializer): Material(name, serializer)
 {
 	mGLHandle = 0;
+	mInstanceAttributeLocation = (GLuint)-1;
 }
 
 GLMaterial::~GLMaterial() {}
@@ -89,6 +93,7 @@ void GLMaterial::resourceLoaded(const resource::ResourceEvent& evt)
 
 			GLint linked;
 			glLinkProgram(mGLHandle);
+			GLRenderDriver::notifyProgramLinked((GLuint)mGLHandle);
 
 			glGetProgramiv(mGLHandle, GL_LINK_STATUS, &linked);
 
@@ -142,6 +147,23 @@ void GLMaterial::resourceLoaded(const resource::ResourceEvent& evt)
 					
 					pGLShaderParameter->ParameterID = glGetUniformLocation(mGLHandle, pi->first.c_str());
 				}
+
+				// The instance matrix is an attribute, not a uniform
+				mInstanceAttributeLocation = (GLuint)-1;
+				std::list<ShaderAutoParameter*>::const_iterator ai;
+				for (ai = mAutoParameters.begin(); ai != mAutoParameters.end(); ++ai)
+				{
+					ShaderAutoParameter* pAutoParameter = (*ai);
+					if (pAutoParameter == nullptr || pAutoParameter->mParameter == nullptr || pAutoParameter->mAutoParameterType != SHADER_AUTO_PARAMETER_TYPE_INSTANCE_WORLD_MATRIX)
+						continue;
+
+					mInstanceAttributeLocation = (GLuint)glGetAttribLocation(mGLHandle, pAutoParameter->mParameter->mName.c_str());
+				}
+
+				// The auto parameters are compiled again with the new locations
+				invalidateParameterProgram();
+
+				setupParameterBlocks();
 				//////////////////////////////////
 			}
 		}
@@ -155,6 +177,11 @@ GLhandleARB GLMaterial::getGLHandle() const
 	return mGLHandle;
 }
 
+GLuint GLMaterial::getInstanceAttributeLocation() const
+{
+	return mInstanceAttributeLocation;
+}
+
 bool GLMaterial::loadImpl()
 {
 	if (!Material::loadImpl()) return false;
@@ -166,7 +193,87 @@ bool GLMaterial::loadImpl()
 
 void GLMaterial::unloadImpl()
 {
-	glDeleteProgram(mGLHandle);
+	GLRenderDriver::deleteProgram((GLuint)mGLHandle);
+}
+
+void GLMaterial::setupParameterBlocks()
+{
+	setParameterBlocks(false);
+
+	if (GLEW_VERSION_3_1 != GL_TRUE)
+		return;
+
+	static const char* blockNames[SHADER_PARAMETER_FREQUENCY_COUNT] = {"FrameParameters", "CameraParameters", "ObjectParameters"};
+
+	GLuint blockIndices[SHADER_PARAMETER_FREQUENCY_COUNT];
+	bool blocks = false;
+	for (unsigned int frequency = 0; frequency < SHADER_PARAMETER_FREQUENCY_COUNT; ++frequency)
+	{
+		blockIndices[frequency] = glGetUniformBlockIndex(mGLHandle, blockNames[frequency]);
+		if (blockIndices[frequency] != GL_INVALID_INDEX)
+			blocks = true;
+	}
+
+	// The program sets its auto parameters one by one
+	if (!blocks)
+		return;
+
+	const std::vector<ShaderParameterInstruction>& parameterProgram = getParameterProgram();
+	for (unsigned int frequency = 0; frequency < SHADER_PARAMETER_FREQUENCY_COUNT; ++frequency)
+	{
+		unsigned int blockSize = getParameterBlockSize((ShaderParameterFrequency)frequency);
+		if (blockSize == 0)
+			continue;
+
+		bool valid = (blockIndices[frequency] != GL_INVALID_INDEX);
+		if (valid)
+		{
+			GLint dataSize = 0;
+			glGetActiveUniformBlockiv(mGLHandle, blockIndices[frequency], GL_UNIFORM_BLOCK_DATA_SIZE, &dataSize);
+			valid = ((unsigned int)dataSize == blockSize);
+		}
+
+		unsigned int first = 0;
+		unsigned int last = 0;
+		getParameterProgramRange((ShaderParameterFrequency)frequency, first, last);
+
+		for (unsigned int i = first; i < last && valid; ++i)
+		{
+			const ShaderParameterInstruction& instruction = parameterProgram[i];
+			if (instruction.mBlockOffset == (unsigned int)-1 || instruction.mParameter == nullptr)
+				continue;
+
+			const GLchar* pName = instruction.mParameter->mName.c_str();
+			GLuint index = GL_INVALID_INDEX;
+			glGetUniformIndices(mGLHandle, 1, &pName, &index);
+			if (index == GL_INVALID_INDEX)
+			{
+				valid = false;
+				continue;
+			}
+
+			GLint blockIndex = -1;
+			GLint offset = -1;
+			glGetActiveUniformsiv(mGLHandle, 1, &index, GL_UNIFORM_BLOCK_INDEX, &blockIndex);
+			glGetActiveUniformsiv(mGLHandle, 1, &index, GL_UNIFORM_OFFSET, &offset);
+
+			valid = ((GLuint)blockIndex == blockIndices[frequency] && (unsigned int)offset == instruction.mBlockOffset);
+		}
+
+		if (!valid)
+		{
+			if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("GLMaterial", std::string("The ") + blockNames[frequency] + " uniform block of " + mFilename + " does not match the std140 layout of its auto parameters", core::LOG_LEVEL_ERROR);
+			return;
+		}
+	}
+
+	for (unsigned int frequency = 0; frequency < SHADER_PARAMETER_FREQUENCY_COUNT; ++frequency)
+	{
+		if (blockIndices[frequency] != GL_INVALID_INDEX)
+			glUniformBlockBinding(mGLHandle, blockIndices[frequency], frequency);
+	}
+
+	setParameterBlocks(true);
 }
 
 ShaderVertexParameter* GLMaterial::createVertexParameterImpl()
@@ -179,12 +286,23 @@ ShaderParameter* GLMaterial::createParameterImpl()
 	return new GLShaderParameter();
 }
 
+unsigned int GLMaterial::getParameterLocationImpl(ShaderParameter* parameter)
+{
+	GLShaderParameter* glParam = static_cast<GLShaderParameter*>(parameter);
+	if (glParam == nullptr)
+		return (unsigned int)-1;
+
+	return glParam->ParameterID;
+}
+
 void GLMaterial::setParameterImpl(ShaderParameter* parameter, const Color& col)
 {
 	GLShaderParameter* glParam = static_cast<GLShaderParameter*>(parameter);
 	if (glParam != nullptr)
 	{
-		glUniform4f(glParam->ParameterID, col.r, col.g, col.b, col.a);
+		float values[4] = {col.r, col.g, col.b, col.a};
+		if (GLRenderDriver::isUniformChanged(glParam->ParameterID, values, sizeof(values)))
+			glUniform4fv(glParam->ParameterID, 1, values);
 	}
 }
 
@@ -193,7 +311,9 @@ void GLMaterial::setParameterImpl(ShaderParameter* parameter, const core::vector
 	GLShaderParameter* glParam = static_cast<GLShaderParameter*>(parameter);
 	if (glParam != nullptr)
 	{
-		glUniform2f(glParam->ParameterID, vec.x, vec.y);
+		float values[2] = {vec.x, vec.y};
+		if (GLRenderDriver::isUniformChanged(glParam->ParameterID, values, sizeof(values)))
+			glUniform2fv(glParam->ParameterID, 1, values);
 	}
 }
 
@@ -202,7 +322,9 @@ void GLMaterial::setParameterImpl(ShaderParameter* parameter, const core::vector
 	GLShaderParameter* glParam = static_cast<GLShaderParameter*>(parameter);
 	if (glParam != nullptr)
 	{
-		glUniform3f(glParam->ParameterID, vec.x, vec.y, vec.z);
+		float values[3] = {vec.x, vec.y, vec.z};
+		if (GLRenderDriver::isUniformChanged(glParam->ParameterID, values, sizeof(values)))
+			glUniform3fv(glParam->ParameterID, 1, values);
 	}
 }
 
@@ -211,7 +333,9 @@ void GLMaterial::setParameterImpl(ShaderParameter* parameter, const core::vector
 	GLShaderParameter* glParam = static_cast<GLShaderParameter*>(parameter);
 	if (glParam != nullptr)
 	{
-		glUniform4f(glParam->ParameterID, vec.x, vec.y, vec.z, vec.w);
+		float values[4] = {vec.x, vec.y, vec.z, vec.w};
+		if (GLRenderDriver::isUniformChanged(glParam->ParameterID, values, sizeof(values)))
+			glUniform4fv(glParam->ParameterID, 1, values);
 	}
 }
 
@@ -220,7 +344,8 @@ void GLMaterial::setParameterImpl(ShaderParameter* parameter, const core::matrix
 	GLShaderParameter* glParam = static_cast<GLShaderParameter*>(parameter);
 	if (glParam != nullptr)
 	{
-		glUniformMatrix4fv(glParam->ParameterID, 1, GL_TRUE/*GL_FALSE*/, m.get());
+		if (GLRenderDriver::isUniformChanged(glParam->ParameterID, m.get(), 16 * sizeof(float)))
+			glUniformMatrix4fv(glParam->ParameterID, 1, GL_TRUE/*GL_FALSE*/, m.get());
 	}
 }
 
@@ -256,6 +381,8 @@ GLenum GLMaterial::getGLType(ShaderParameterType type)
 		return GL_SAMPLER_2D;
 	case SHADER_PARAMETER_TYPE_SAMPLER3D:
 		return GL_SAMPLER_3D;
+	case SHADER_PARAMETER_TYPE_SAMPLERBUFFER:
+		return GL_SAMPLER_BUFFER;
 	default:
 		return 0;
 	}
@@ -36,6 +36,8 @@ THE SOFTWARE.
 #include <render/Shader.h>
 #include <render/VertexBuffer.h>
 #include <render/IndexBuffer.h>
+#include <render/RenderQueue.h>
+#include <render/LightCuller.h>
 #include <resource/Resource.h>
 #include <resource/ResourceManager.h>
 #include <game/GameObject.h>
@@ -57,7 +59,24 @@ template<> render::GLRenderDriver* core::Singleton<render::GLRenderDriver>::m_Si
 namespace render
 {
 
-GLRenderDriver::GLRenderDriver(): RenderDriver("OpenGL RenderDriver") {}
+GLRenderDriver::GLRenderDriver(): RenderDriver("OpenGL RenderDriver")
+{
+	mInstanceBuffer = 0;
+	mInstancingSupported = false;
+
+	for (unsigned int i = 0; i < 3; ++i)
+	{
+		mClusterBuffers[i] = 0;
+		mClusterTextures[i] = 0;
+	}
+
+	mClusterVersion = 0;
+	mTextureBuffersSupported = false;
+
+	mUniformBufferId = 0;
+	mUniformBufferSize = 0;
+	mUniformBlocksSupported = false;
+}
 
 GLRenderDriver::~GLRenderDriver() {}
 
@@ -121,35 +140,154 @@ void GLRenderDriver::beginFrame(Viewport* vp)
 		glClearColor(col.r, col.g, col.b, col.a);
 
 		glClearDepth(1.0f);									// Depth Buffer Setup
+		if (mStateCache.setDepthWriteEnabled(true))			// The last transparent draw may have turned depth writes off
+			glDepthMask(GL_TRUE);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);	// Clear Screen And Depth Buffer
 	}
 }
 
 void GLRenderDriver::render(RenderStateData& renderStateData)
 {
-	if (renderStateData.getCurrentMaterial() == nullptr)
+	Model* pModel = setupDraw(renderStateData, 0);
+	if (pModel == nullptr)
 		return;
 
-	GLMaterial* pGLMaterial = static_cast<GLMaterial*>(renderStateData.getCurrentMaterial());
+	bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ((GLIndexBuffer*)(pModel->getIndexBuffer()))->getGLBufferId());
+
+	GLenum primType = getGLType(pModel->getRenderOperationType());
+	GLenum indexType = (pModel->getIndexBuffer()->getType() == IT_16BIT) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+	
+	glDrawElements(primType, pModel->getIndexBuffer()->getNumIndexes(), indexType, (void*)0);
+}
+
+void GLRenderDriver::renderInstances(RenderStateData& renderStateData, const RenderCommand* commands, unsigned int count, const float* instanceData)
+{
+	if (commands == nullptr || count == 0 || instanceData == nullptr)
+		return;
+
+	GLMaterial* pGLMaterial = static_cast<GLMaterial*>(commands[0].material);
 	if (pGLMaterial == nullptr)
 		return;
 
-	Model* pModel = renderStateData.getCurrentModel();
+	// The matrix takes four consecutive attributes, one per column
+	GLuint location = pGLMaterial->getInstanceAttributeLocation();
+	if (location > RENDER_STATE_MAX_VERTEX_ATTRIBUTES - 4)
+	{
+		RenderDriver::renderInstances(renderStateData, commands, count, instanceData);
+		return;
+	}
+
+	// Without divisors every instance is drawn on its own with the matrix set as constant attributes
+	if (!mInstancingSupported)
+	{
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			setCurrentCommand(renderStateData, commands + i);
+
+			Model* pModel = setupDraw(renderStateData, 0xF << location);
+			if (pModel == nullptr)
+				continue;
+
+			for (GLuint column = 0; column < 4; ++column)
+			{
+				GLuint index = location + column;
+
+				if (mStateCache.setVertexAttributeEnabled(index, false))
+					glDisableVertexAttribArray(index);
+
+				glVertexAttrib4fv(index, instanceData + i * RENDER_INSTANCE_DATA_SIZE + column * 4);
+			}
 
+			bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ((GLIndexBuffer*)(pModel->getIndexBuffer()))->getGLBufferId());
+
+			GLenum primType = getGLType(pModel->getRenderOperationType());
+			GLenum indexType = (pModel->getIndexBuffer()->getType() == IT_16BIT) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+			glDrawElements(primType, pModel->getIndexBuffer()->getNumIndexes(), indexType, (void*)0);
+		}
+
+		return;
+	}
+
+	setCurrentCommand(renderStateData, commands);
+
+	Model* pModel = setupDraw(renderStateData, 0xF << location);
 	if (pModel == nullptr)
 		return;
 
+	if (mInstanceBuffer == 0)
+		glGenBuffers(1, &mInstanceBuffer);
+
+	bindBuffer(GL_ARRAY_BUFFER, mInstanceBuffer);
+
+	// New storage for every batch, the draws before may still read the old one
+	glBufferData(GL_ARRAY_BUFFER, count * RENDER_INSTANCE_DATA_SIZE * sizeof(float), instanceData, GL_STREAM_DRAW);
+
+	GLsizei stride = RENDER_INSTANCE_DATA_SIZE * sizeof(float);
+	for (GLuint column = 0; column < 4; ++column)
+	{
+		GLuint index = location + column;
+		unsigned int offset = column * 4 * sizeof(float);
+
+		if (mStateCache.setVertexAttributeFormat(index, mInstanceBuffer, 4, GL_FLOAT, stride, offset, 1))
+		{
+			glVertexAttribPointer(index, 4, GL_FLOAT, GL_FALSE, stride, (void*)(std::size_t)offset);
+			glVertexAttribDivisor(index, 1);
+		}
+
+		if (mStateCache.setVertexAttributeEnabled(index, true))
+			glEnableVertexAttribArray(index);
+	}
+
+	bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ((GLIndexBuffer*)(pModel->getIndexBuffer()))->getGLBufferId());
+
+	GLenum primType = getGLType(pModel->getRenderOperationType());
+	GLenum indexType = (pModel->getIndexBuffer()->getType() == IT_16BIT) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+	glDrawElementsInstanced(primType, pModel->getIndexBuffer()->getNumIndexes(), indexType, (void*)0, (GLsizei)count);
+}
+
+Model* GLRenderDriver::setupDraw(RenderStateData& renderStateData, unsigned int instanceAttributes)
+{
+	if (renderStateData.getCurrentMaterial() == nullptr)
+		return nullptr;
+
+	GLMaterial* pGLMaterial = static_cast<GLMaterial*>(renderStateData.getCurrentMaterial());
+	if (pGLMaterial == nullptr)
+		return nullptr;
+
+	Model* pModel = renderStateData.getCurrentModel();
+
+	if (pModel == nullptr)
+		return nullptr;
+
 	if (pModel->getVertexBuffer(VERTEX_BUFFER_TYPE_POSITION) == nullptr || pModel->getIndexBuffer() == nullptr)
-		return;
+		return nullptr;
+
+	bindProgram((GLuint)pGLMaterial->getGLHandle());
+
+	bool transparent = pGLMaterial->isTransparent();
+	if (mStateCache.setBlendEnabled(transparent))
+	{
+		if (transparent)
+		{
+			glEnable(GL_BLEND);
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		}
+		else
+		{
+			glDisable(GL_BLEND);
+		}
+	}
 
-	glUseProgram(pGLMaterial->getGLHandle());
+	if (mStateCache.setDepthWriteEnabled(!transparent))
+		glDepthMask(transparent ? GL_FALSE : GL_TRUE);
 
 	GLShaderParameter* pGLShaderParameter = nullptr;
 	GLShaderVertexParameter* pGLShaderVertexParameter = nullptr;
 
 	/////////////Textures/////////////
-	std::vector<ShaderTextureParameter*> shaderTextureParameters = pGLMaterial->getTextureParameters();
-	std::list<ShaderTextureParameter*>::const_iterator ti;
+	const std::vector<ShaderTextureParameter*>& shaderTextureParameters = pGLMaterial->getTextureParameters();
 	for (unsigned int i = 0; i < shaderTextureParameters.size(); ++i)
 	{
 		ShaderTextureParameter* pTextureParameter = shaderTextureParameters[i];
@@ -161,143 +299,64 @@ void GLRenderDriver::render(RenderStateData& renderStateData)
 		if (glTexture == nullptr || pGLShaderParameter == nullptr)
 			continue;
 		
-		glActiveTexture(GL_TEXTURE0 + i);
-		glBindTexture(GL_TEXTURE_2D, glTexture->getGLID());
-		glUniform1i(pGLShaderParameter->ParameterID, i);
+		bindTexture(i, GL_TEXTURE_2D, glTexture->getGLID());
+
+		GLint textureUnit = (GLint)i;
+		if (isUniformChanged(pGLShaderParameter->ParameterID, &textureUnit, sizeof(GLint)))
+			glUniform1i(pGLShaderParameter->ParameterID, textureUnit);
 	}
 	//////////////////////////////////
 
+	// The cluster buffer textures take the units after the material textures
+	unsigned int textureUnit = (unsigned int)shaderTextureParameters.size();
+
 	//////////AutoParameters//////////
-	std::list<ShaderAutoParameter*> shaderAutoParameters = pGLMaterial->getAutoParameters();
-	std::list<ShaderAutoParameter*>::const_iterator ai;
-	for (ai = shaderAutoParameters.begin(); ai != shaderAutoParameters.end(); ++ai)
+	const std::vector<ShaderParameterInstruction>& parameterProgram = pGLMaterial->getParameterProgram();
+	if (pGLMaterial->hasParameterBlocks())
 	{
-		ShaderAutoParameter* pAutoParameter = (*ai);
-		if (pAutoParameter == nullptr)
-			continue;
-		
-		pGLShaderParameter = static_cast<GLShaderParameter*>(pAutoParameter->mParameter);
-		if (pGLShaderParameter == nullptr)
-			continue;
+		// The blocks were packed and uploaded before the first draw, only their ranges are bound
+		for (unsigned int frequency = 0; frequency < SHADER_PARAMETER_FREQUENCY_COUNT; ++frequency)
+		{
+			unsigned int size = pGLMaterial->getParameterBlockSize((ShaderParameterFrequency)frequency);
+			unsigned int offset = mParameterBlockOffsets[frequency];
+			if (size == 0 || offset == UNIFORM_RING_BUFFER_INVALID_OFFSET)
+				continue;
+
+			if (mStateCache.setUniformBlock(frequency, mUniformBufferId, offset, size))
+				glBindBufferRange(GL_UNIFORM_BUFFER, frequency, mUniformBufferId, offset, size);
+		}
 
-		switch (pAutoParameter->mAutoParameterType)
+		// Samplers can't be block members, they are set one by one
+		for (unsigned int i = 0; i < parameterProgram.size(); ++i)
 		{
-		case SHADER_AUTO_PARAMETER_TYPE_WORLD_MATRIX:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getWorldMatrix());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_INVERSE_WORLD_MATRIX:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getInverseWorldMatrix());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_TRANSPOSE_WORLD_MATRIX:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getTransposedWorldMatrix());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_INVERSE_TRANSPOSE_WORLD_MATRIX:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getInverseTransposedWorldMatrix());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_VIEW_MATRIX:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getViewMatrix());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_INVERSE_VIEW_MATRIX:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getInverseViewMatrix());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_TRANSPOSE_VIEW_MATRIX:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getTransposedViewMatrix());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_INVERSE_TRANSPOSE_VIEW_MATRIX:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getInverseTransposedViewMatrix());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_PROJECTION_MATRIX:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getProjectionMatrix());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_INVERSE_PROJECTION_MATRIX:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getInverseProjectionMatrix());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_TRANSPOSE_PROJECTION_MATRIX:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getTransposedProjectionMatrix());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_INVERSE_TRANSPOSE_PROJECTION_MATRIX:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getInverseTransposedProjectionMatrix());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_VIEWPROJ_MATRIX:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getViewProjectionMatrix());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_INVERSE_VIEWPROJ_MATRIX:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getInverseViewProjectionMatrix());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_TRANSPOSE_VIEWPROJ_MATRIX:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getTransposedViewProjectionMatrix());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_INVERSE_TRANSPOSE_VIEWPROJ_MATRIX:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getInverseTransposedViewProjectionMatrix());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_WORLDVIEW_MATRIX:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getWorldViewMatrix());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_INVERSE_WORLDVIEW_MATRIX:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getInverseWorldViewMatrix());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_TRANSPOSE_WORLDVIEW_MATRIX:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getTransposedWorldViewMatrix());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_INVERSE_TRANSPOSE_WORLDVIEW_MATRIX:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getInverseTransposedWorldViewMatrix());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_WORLDVIEWPROJ_MATRIX:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getWorldViewProjMatrix());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_INVERSE_WORLDVIEWPROJ_MATRIX:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getInverseWorldViewProjMatrix());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_TRANSPOSE_WORLDVIEWPROJ_MATRIX:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getTransposedWorldViewProjMatrix());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_INVERSE_TRANSPOSE_WORLDVIEWPROJ_MATRIX:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getInverseTransposedWorldViewProjMatrix());
-			break;
+			if (parameterProgram[i].mBlockOffset == (unsigned int)-1)
+				setAutoParameter(renderStateData, parameterProgram[i], textureUnit);
+		}
+	}
+	else
+	{
+		// The program keeps its values, only the frequencies that changed since it last had them set are walked
+		for (unsigned int frequency = 0; frequency < SHADER_PARAMETER_FREQUENCY_COUNT; ++frequency)
+		{
+			unsigned int version = renderStateData.getVersion((ShaderParameterFrequency)frequency);
+			if (pGLMaterial->getParameterVersion((ShaderParameterFrequency)frequency) == version)
+				continue;
 
-		case SHADER_AUTO_PARAMETER_TYPE_LIGHT_POSITION:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getCurrentLightPosition());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_LIGHT_POSITION_OBJECT_SPACE:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getCurrentLightPositionObjectSpace());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_LIGHT_POSITION_VIEW_SPACE:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getCurrentLightPositionViewSpace());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_LIGHT_DIRECTION:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getCurrentLightDirection());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_LIGHT_DIRECTION_OBJECT_SPACE:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getCurrentLightDirectionObjectSpace());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_LIGHT_DIRECTION_VIEW_SPACE:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getCurrentLightDirectionViewSpace());
-			break;
-		
-		case SHADER_AUTO_PARAMETER_TYPE_AMBIENT_LIGHT_COLOUR:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getAmbientLightColour());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_LIGHT_DIFFUSE_COLOUR:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getCurrentLightDiffuseColour());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_LIGHT_SPECULAR_COLOUR:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getCurrentLightSpecularColour());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_LIGHT_ATTENUATION:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getCurrentLightAttenuation());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_CAMERA_POSITION:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getCameraPosition());
-			break;
-		case SHADER_AUTO_PARAMETER_TYPE_CAMERA_POSITION_OBJECT_SPACE:
-			pGLMaterial->setParameter(pGLShaderParameter, renderStateData.getCameraPositionObjectSpace());
-			break;
+			pGLMaterial->setParameterVersion((ShaderParameterFrequency)frequency, version);
+
+			unsigned int first = 0;
+			unsigned int last = 0;
+			pGLMaterial->getParameterProgramRange((ShaderParameterFrequency)frequency, first, last);
+
+			for (unsigned int i = first; i < last; ++i)
+				setAutoParameter(renderStateData, parameterProgram[i], textureUnit);
 		}
 	}
 	//////////////////////////////////
 
 	/////////////Buffers//////////////
-	std::vector<ShaderVertexParameter*> vertexParameters = pGLMaterial->getVertexParameters();
+	unsigned int usedAttributes = instanceAttributes;
+	const std::vector<ShaderVertexParameter*>& vertexParameters = pGLMaterial->getVertexParameters();
 	for (std::size_t vertexType = VERTEX_BUFFER_TYPE_POSITION; vertexType != VERTEX_BUFFER_TYPE_COUNT; ++vertexType)
 	{
 		if (vertexParameters[vertexType] == nullptr)
@@ -305,16 +364,19 @@ void GLRenderDriver::render(RenderStateData& renderStateData)
 		
 		pGLShaderVertexParameter = static_cast<GLShaderVertexParameter*>(vertexParameters[vertexType]);
 
-		if (pGLShaderParameter == nullptr)
+		if (pGLShaderVertexParameter == nullptr)
 			continue;
 
 		VertexBuffer* pVertexBuffer = pModel->getVertexBuffer((VertexBufferType)vertexType);
 		if (pVertexBuffer == nullptr)
 			continue;
 
-		glBindBuffer(GL_ARRAY_BUFFER, ((const GLVertexBuffer*)(pVertexBuffer))->getGLBufferId());
-
+		// Inactive attributes have no location
 		GLuint index = pGLShaderVertexParameter->ParameterID;
+		if (index >= RENDER_STATE_MAX_VERTEX_ATTRIBUTES)
+			continue;
+
+		GLuint bufferId = ((const GLVertexBuffer*)(pVertexBuffer))->getGLBufferId();
 		GLenum type = getGLType(pVertexBuffer->getVertexElementType());
 		GLint size = 0;
 		switch (pVertexBuffer->getVertexElementType())
@@ -350,34 +412,169 @@ void GLRenderDriver::render(RenderStateData& renderStateData)
 
 		GLsizei stride = (GLsizei)(pVertexBuffer->getVertexSize());
 
-		glVertexAttribPointer(
-							index,			// The attribute we want to configure
-							size,			// size
-							type,			// type
-							GL_FALSE,		// normalized?
-							stride,			// stride
-							(void*)0		// array buffer offset
-							);
-		glEnableVertexAttribArray(index);
+		if (mStateCache.setVertexAttributeFormat(index, bufferId, size, type, stride))
+		{
+			bindBuffer(GL_ARRAY_BUFFER, bufferId);
+
+			// The attribute may have read instance data before
+			if (mInstancingSupported)
+				glVertexAttribDivisor(index, 0);
+
+			glVertexAttribPointer(
+								index,			// The attribute we want to configure
+								size,			// size
+								type,			// type
+								GL_FALSE,		// normalized?
+								stride,			// stride
+								(void*)0		// array buffer offset
+								);
+		}
+
+		if (mStateCache.setVertexAttributeEnabled(index, true))
+			glEnableVertexAttribArray(index);
+
+		usedAttributes |= (1 << index);
 	}
 
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ((GLIndexBuffer*)(pModel->getIndexBuffer()))->getGLBufferId());
+	// The attributes stay enabled between draws, only the ones this draw doesn't use are turned off
+	for (unsigned int i = 0; i < RENDER_STATE_MAX_VERTEX_ATTRIBUTES; ++i)
+	{
+		if ((usedAttributes & (1 << i)) == 0 && mStateCache.isVertexAttributeEnabled(i))
+		{
+			if (mStateCache.setVertexAttributeEnabled(i, false))
+				glDisableVertexAttribArray(i);
+		}
+	}
 
-	GLenum primType = getGLType(pModel->getRenderOperationType());
-	GLenum indexType = (pModel->getIndexBuffer()->getType() == IT_16BIT) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
-	
-	glDrawElements(primType, pModel->getIndexBuffer()->getNumIndexes(), indexType, (void*)0);
 	//////////////////////////////////
 
-	for (unsigned int i = 0; i < vertexParameters.size(); ++i)
+	return pModel;
+}
+
+void GLRenderDriver::setAutoParameter(RenderStateData& renderStateData, const ShaderParameterInstruction& instruction, unsigned int textureUnit)
+{
+	GLint location = (GLint)instruction.mLocation;
+	float values[16];
+
+	switch (instruction.mParameterType)
 	{
-		pGLShaderVertexParameter = static_cast<GLShaderVertexParameter*>(vertexParameters[i]);
+	case SHADER_PARAMETER_TYPE_FLOAT:
+		if (renderStateData.getParameterValue(instruction.mSource, values) && isUniformChanged(location, values, sizeof(float)))
+			glUniform1fv(location, 1, values);
+		break;
+	case SHADER_PARAMETER_TYPE_FLOAT3:
+		if (renderStateData.getParameterValue(instruction.mSource, values) && isUniformChanged(location, values, 3 * sizeof(float)))
+			glUniform3fv(location, 1, values);
+		break;
+	case SHADER_PARAMETER_TYPE_FLOAT4:
+		if (renderStateData.getParameterValue(instruction.mSource, values) && isUniformChanged(location, values, 4 * sizeof(float)))
+			glUniform4fv(location, 1, values);
+		break;
+	case SHADER_PARAMETER_TYPE_MATRIX4:
+		if (renderStateData.getParameterValue(instruction.mSource, values) && isUniformChanged(location, values, 16 * sizeof(float)))
+			glUniformMatrix4fv(location, 1, GL_TRUE/*GL_FALSE*/, values);
+		break;
+	case SHADER_PARAMETER_TYPE_SAMPLERBUFFER:
+		if (updateLightClusters(renderStateData.getLightCuller()))
+		{
+			// The grid, the indices and the light data take the units after the material textures in this order
+			unsigned int buffer = instruction.mSource - SHADER_AUTO_PARAMETER_TYPE_CLUSTER_LIGHT_GRID;
+			bindTexture(textureUnit + buffer, GL_TEXTURE_BUFFER, mClusterTextures[buffer]);
 
-		if (pGLShaderVertexParameter == nullptr)
-			continue;
+			GLint unit = (GLint)(textureUnit + buffer);
+			if (isUniformChanged(location, &unit, sizeof(GLint)))
+				glUniform1i(location, unit);
+		}
+		break;
+	}
+}
+
+void GLRenderDriver::uploadUniformBuffer()
+{
+	if (!mUniformBlocksSupported)
+	{
+		RenderDriver::uploadUniformBuffer();
+		return;
+	}
+
+	if (mUniformBufferId == 0)
+		glGenBuffers(1, &mUniformBufferId);
+
+	glBindBuffer(GL_UNIFORM_BUFFER, mUniformBufferId);
 
-		glDisableVertexAttribArray(pGLShaderVertexParameter->ParameterID);
+	// The blocks written before the ring grew were dropped with its old storage
+	if (mUniformBufferSize != mUniformBuffer.getSize())
+	{
+		mUniformBufferSize = mUniformBuffer.getSize();
+		glBufferData(GL_UNIFORM_BUFFER, mUniformBufferSize, nullptr, GL_STREAM_DRAW);
 	}
+
+	unsigned int offset = 0;
+	unsigned int size = 0;
+	while (mUniformBuffer.takePendingRange(offset, size))
+		glBufferSubData(GL_UNIFORM_BUFFER, offset, size, mUniformBuffer.getData() + offset);
+}
+
+bool GLRenderDriver::updateLightClusters(LightCuller* lightCuller)
+{
+	if (lightCuller == nullptr || !mTextureBuffersSupported)
+		return false;
+
+	// The buffers are attached to their textures once, only their data is replaced afterwards
+	static const GLenum formats[3] = {GL_RG32UI, GL_R32UI, GL_RGBA32F};
+	if (mClusterTextures[0] == 0)
+	{
+		glGenBuffers(3, mClusterBuffers);
+		glGenTextures(3, mClusterTextures);
+
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			glBindBuffer(GL_TEXTURE_BUFFER, mClusterBuffers[i]);
+			glBufferData(GL_TEXTURE_BUFFER, sizeof(float) * 4, nullptr, GL_STREAM_DRAW);
+
+			bindTexture(0, GL_TEXTURE_BUFFER, mClusterTextures[i]);
+			glTexBuffer(GL_TEXTURE_BUFFER, formats[i], mClusterBuffers[i]);
+		}
+
+		mClusterVersion = lightCuller->getVersion() - 1;
+	}
+
+	if (mClusterVersion == lightCuller->getVersion())
+		return true;
+
+	mClusterVersion = lightCuller->getVersion();
+
+	const void* data[3] = {nullptr, nullptr, nullptr};
+	GLsizeiptr sizes[3] = {0, 0, 0};
+
+	if (!lightCuller->getClusterGrid().empty())
+	{
+		data[0] = &lightCuller->getClusterGrid()[0];
+		sizes[0] = lightCuller->getClusterGrid().size() * sizeof(unsigned int);
+	}
+
+	if (!lightCuller->getLightIndices().empty())
+	{
+		data[1] = &lightCuller->getLightIndices()[0];
+		sizes[1] = lightCuller->getLightIndices().size() * sizeof(unsigned int);
+	}
+
+	if (!lightCuller->getLightData().empty())
+	{
+		data[2] = &lightCuller->getLightData()[0];
+		sizes[2] = lightCuller->getLightData().size() * sizeof(float);
+	}
+
+	for (unsigned int i = 0; i < 3; ++i)
+	{
+		// a buffer texture can't be empty, the lists are never read then
+		glBindBuffer(GL_TEXTURE_BUFFER, mClusterBuffers[i]);
+		glBufferData(GL_TEXTURE_BUFFER, sizes[i] > 0 ? sizes[i] : sizeof(float) * 4, data[i], GL_STREAM_DRAW);
+	}
+
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+	return true;
 }
 
 void GLRenderDriver::endFrame()
@@ -432,6 +629,22 @@ void GLRenderDriver::initializeImpl()
 		return;
 	}*/
 
+	// Nothing is known about the new context
+	mStateCache.reset();
+
+	mInstancingSupported = (GLEW_VERSION_3_3 == GL_TRUE);
+	mTextureBuffersSupported = (GLEW_VERSION_3_1 == GL_TRUE);
+	mUniformBlocksSupported = (GLEW_VERSION_3_1 == GL_TRUE);
+
+	// The blocks are bound by offset, the offsets have to be aligned as the implementation requires
+	if (mUniformBlocksSupported)
+	{
+		GLint alignment = 256;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+		mUniformBuffer.initialize(64 * 1024, (unsigned int)alignment);
+	}
+
 	glClearDepth(1.0f);
 	glColor4f(1.0f,1.0f,1.0f,1.0f);						// Set Color to initial value
 
@@ -440,15 +653,49 @@ void GLRenderDriver::initializeImpl()
 	// Accept fragment if it closer to the camera than the former one
 	glDepthFunc(GL_LESS);
 
+	mStateCache.setDepthWriteEnabled(true);
 	glDepthMask(GL_TRUE);
 
 	// Cull triangles which normal is not towards the camera
 	glEnable(GL_CULL_FACE);
 
+	mStateCache.setBlendEnabled(false);
 	glDisable(GL_BLEND);								// Turn Blending Off
 }
 
-void GLRenderDriver::uninitializeImpl() {}
+void GLRenderDriver::uninitializeImpl()
+{
+	if (mInstanceBuffer != 0)
+	{
+		deleteBuffer(mInstanceBuffer);
+		mInstanceBuffer = 0;
+	}
+
+	for (unsigned int i = 0; i < 3; ++i)
+	{
+		if (mClusterTextures[i] != 0)
+		{
+			deleteTexture(mClusterTextures[i]);
+			mClusterTextures[i] = 0;
+		}
+
+		if (mClusterBuffers[i] != 0)
+		{
+			deleteBuffer(mClusterBuffers[i]);
+			mClusterBuffers[i] = 0;
+		}
+	}
+
+	mClusterVersion = 0;
+
+	if (mUniformBufferId != 0)
+	{
+		deleteBuffer(mUniformBufferId);
+		mUniformBufferId = 0;
+	}
+
+	mUniformBufferSize = 0;
+}
 
 void GLRenderDriver::updateImpl(float elapsedTime) {}
 
@@ -526,6 +773,83 @@ GLenum GLRenderDriver::getGLType(RenderOperationType type)
 	}
 }
 
+void GLRenderDriver::bindProgram(GLuint program)
+{
+	GLRenderDriver* pDriver = getInstance();
+	if (pDriver == nullptr || pDriver->mStateCache.setProgram(program))
+		glUseProgram(program);
+}
+
+void GLRenderDriver::bindBuffer(GLenum target, GLuint buffer)
+{
+	GLRenderDriver* pDriver = getInstance();
+	if (pDriver != nullptr)
+	{
+		if (target == GL_ARRAY_BUFFER && !pDriver->mStateCache.setVertexBuffer(buffer))
+			return;
+
+		if (target == GL_ELEMENT_ARRAY_BUFFER && !pDriver->mStateCache.setIndexBuffer(buffer))
+			return;
+	}
+
+	glBindBuffer(target, buffer);
+}
+
+void GLRenderDriver::bindTexture(unsigned int unit, GLenum target, GLuint texture)
+{
+	GLRenderDriver* pDriver = getInstance();
+	if (pDriver != nullptr && !pDriver->mStateCache.setTexture(unit, target, texture))
+		return;
+
+	if (pDriver == nullptr || pDriver->mStateCache.setActiveTextureUnit(unit))
+		glActiveTexture(GL_TEXTURE0 + unit);
+
+	glBindTexture(target, texture);
+}
+
+bool GLRenderDriver::isUniformChanged(GLuint location, const void* data, unsigned int size)
+{
+	GLRenderDriver* pDriver = getInstance();
+	if (pDriver == nullptr)
+		return true;
+
+	return pDriver->mStateCache.setUniform(location, data, size);
+}
+
+void GLRenderDriver::deleteProgram(GLuint program)
+{
+	GLRenderDriver* pDriver = getInstance();
+	if (pDriver != nullptr)
+		pDriver->mStateCache.removeProgram(program);
+
+	glDeleteProgram(program);
+}
+
+void GLRenderDriver::deleteBuffer(GLuint buffer)
+{
+	GLRenderDriver* pDriver = getInstance();
+	if (pDriver != nullptr)
+		pDriver->mStateCache.removeBuffer(buffer);
+
+	glDeleteBuffers(1, &buffer);
+}
+
+void GLRenderDriver::deleteTexture(GLuint texture)
+{
+	GLRenderDriver* pDriver = getInstance();
+	if (pDriver != nullptr)
+		pDriver->mStateCache.removeTexture(texture);
+
+	glDeleteTextures(1, &texture);
+}
+
+void GLRenderDriver::notifyProgramLinked(GLuint program)
+{
+	GLRenderDriver* pDriver = getInstance();
+	if (pDriver != nullptr)
+		pDriver->mStateCache.removeProgram(program);
+}
+
 GLRenderDriver* GLRenderDriver::getInstance()
 {
 	return core::Singleton<GLRenderDriver>::getInstance();
@@ -27,6 +27,7 @@ THE SOFTWARE.
 #include <resource/PixelFormat.h>
 #include <GLTexture.h>
 #include <GLPixelFormat.h>
+#include <GLRenderDriver.h>
 
 namespace render
 {
@@ -55,9 +56,8 @@ bool GLTexture::loadImpl()
 		// Create the GL texture
 		glGenTextures(1, &mTextureID);
 
-		glActiveTexture(GL_TEXTURE15);
 		// Set texture type
-		glBindTexture(getGLTextureType(), mTextureID);
+		GLRenderDriver::bindTexture(15, getGLTextureType(), mTextureID);
 
 		// This needs to be set otherwise the texture doesn't get rendered
 		glTexParameteri(getGLTextureType(), GL_TEXTURE_MAX_LEVEL, mNumMipmaps);
@@ -125,7 +125,7 @@ bool GLTexture::loadImpl()
 			}
 		}
 
-		glBindTexture(getGLTextureType(), 0);
+		GLRenderDriver::bindTexture(15, getGLTextureType(), 0);
 	}
 
 	return true;
@@ -135,7 +135,7 @@ void GLTexture::unloadImpl()
 {
 	if (mTextureType == TEX_TYPE_2D)
 	{
-		glDeleteTextures(1, &mTextureID);
+		GLRenderDriver::deleteTexture(mTextureID);
 
 		mTextureType = TEX_TYPE_2D;
 	}
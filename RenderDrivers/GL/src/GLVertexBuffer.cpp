@@ -43,7 +43,7 @@ GLVertexBuffer::GLVertexBuffer(VertexBufferType vertexBufferType, VertexElementT
 		return;
 	}
 
-	glBindBuffer(GL_ARRAY_BUFFER, mBufferId);
+	GLRenderDriver::bindBuffer(GL_ARRAY_BUFFER, mBufferId);
 
 	// Initialize mapped buffer and set usage
 	glBufferData(GL_ARRAY_BUFFER, mSizeInBytes, nullptr, GLRenderDriver::getGLUsage(usage));
@@ -51,18 +51,18 @@ GLVertexBuffer::GLVertexBuffer(VertexBufferType vertexBufferType, VertexElementT
 
 GLVertexBuffer::~GLVertexBuffer() 
 {
-	glDeleteBuffers(1, &mBufferId);
+	GLRenderDriver::deleteBuffer(mBufferId);
 }
 
 void GLVertexBuffer::readData(unsigned int offset, unsigned int length, void* pDest)
 {
-	glBindBuffer(GL_ARRAY_BUFFER, mBufferId);
+	GLRenderDriver::bindBuffer(GL_ARRAY_BUFFER, mBufferId);
 	glGetBufferSubData(GL_ARRAY_BUFFER, offset, length, pDest);
 }
 
 void GLVertexBuffer::writeData(unsigned int offset, unsigned int length, const void* pSource, bool discardWholeBuffer)
 {
-	glBindBuffer(GL_ARRAY_BUFFER, mBufferId);
+	GLRenderDriver::bindBuffer(GL_ARRAY_BUFFER, mBufferId);
 
 	if (offset == 0 && length == mSizeInBytes)
 	{
@@ -95,7 +95,7 @@ void* GLVertexBuffer::lockImpl(unsigned int offset, unsigned int length, resourc
 		return nullptr;
 	}
 
-	glBindBuffer(GL_ARRAY_BUFFER, mBufferId);
+	GLRenderDriver::bindBuffer(GL_ARRAY_BUFFER, mBufferId);
 
 	if(options == resource::BL_DISCARD)
 	{
@@ -138,7 +138,7 @@ void* GLVertexBuffer::lockImpl(unsigned int offset, unsigned int length, resourc
 
 void GLVertexBuffer::unlockImpl()
 {
-	glBindBuffer(GL_ARRAY_BUFFER, mBufferId);
+	GLRenderDriver::bindBuffer(GL_ARRAY_BUFFER, mBufferId);
 
 	if(!glUnmapBuffer(GL_ARRAY_BUFFER))
 	{
@@ -0,0 +1,128 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _NULL_RENDER_DRIVER_H_
+#define _NULL_RENDER_DRIVER_H_
+
+#include <NullRenderConfig.h>
+#include <render/RenderDefines.h>
+#include <render/RenderDriver.h>
+#include <core/Singleton.h>
+#include <render/VertexBufferDefines.h>
+#include <render/IndexBufferDefines.h>
+
+#include <vector>
+
+namespace render
+{
+
+class Model;
+class Material;
+class Viewport;
+class VertexBuffer;
+class IndexBuffer;
+
+//! A draw call recorded by the null render driver.
+struct NULLRENDER_PUBLIC_EXPORT NullDrawCall
+{
+	NullDrawCall();
+
+	Viewport* viewport;
+	Material* material;
+	Model* model;
+	RenderOperationType renderOperationType;
+	unsigned int numVertices;
+	unsigned int numIndexes;
+	bool transparent;
+
+	//! Number of models drawn by the call, more than one for instanced draws.
+	unsigned int instanceCount;
+};
+
+//! Render driver that draws nothing.
+//!
+//! Buffers are backed by host memory and every draw is recorded instead of being
+//! sent to a graphics API, so complete frames can run without a window or a GPU
+//! (servers, automated tests, CPU side profiling).
+class NULLRENDER_PUBLIC_EXPORT NullRenderDriver: public RenderDriver, public core::Singleton<NullRenderDriver>
+{
+public:
+	NullRenderDriver();
+	~NullRenderDriver();
+
+	RenderWindow* createRenderWindow(int width, int height, int colorDepth, bool fullScreen, int left = 0, int top = 0, bool depthBuffer = true, void* windowId = nullptr);
+
+	VertexBuffer* createVertexBuffer(VertexBufferType vertexBufferType, VertexElementType vertexElementType, unsigned int numVertices, resource::BufferUsage usage);
+	void removeVertexBuffer(VertexBuffer* buf);
+
+	IndexBuffer* createIndexBuffer(IndexType idxType, unsigned int numIndexes, resource::BufferUsage usage);
+	void removeIndexBuffer(IndexBuffer* buf);
+
+	void beginFrame(Viewport* vp);
+
+	void render(RenderStateData& renderStateData);
+
+	//! Records one draw call for all the instances.
+	void renderInstances(RenderStateData& renderStateData, const RenderCommand* commands, unsigned int count, const float* instanceData);
+
+	void endFrame();
+
+	void setViewport(Viewport* viewport);
+
+	//! Returns the draw calls recorded since the start of the current frame.
+	const std::vector<NullDrawCall>& getDrawCalls() const;
+
+	//! Returns the number of frames the driver was updated for.
+	unsigned int getFrameCount() const;
+
+	//! Returns the number of viewports rendered in the current frame.
+	unsigned int getViewportCount() const;
+
+	//! Returns a new id for a buffer or a program, so the state cache can tell them apart.
+	static unsigned int createObjectId();
+
+	static NullRenderDriver* getInstance();
+
+protected:
+
+	void initializeImpl();
+	void uninitializeImpl();
+	void updateImpl(float elapsedTime);
+
+	std::vector<NullDrawCall> mDrawCalls;
+	Viewport* mCurrentViewport;
+	unsigned int mFrameCount;
+	unsigned int mViewportCount;
+
+	//! Id standing for the buffer the uniform blocks are bound from.
+	unsigned int mUniformBufferId;
+
+	static unsigned int mObjectIdCounter;
+};
+
+} // end namespace render
+
+#endif // _NULL_RENDER_DRIVER_H_
\ No newline at end of file
@@ -0,0 +1,109 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <core/Log.h>
+#include <core/LogDefines.h>
+#include <NullIndexBuffer.h>
+#include <NullRenderDriver.h>
+
+#include <cstring>
+
+namespace render
+{
+
+NullIndexBuffer::NullIndexBuffer(IndexType idxType, unsigned int numIndexes, resource::BufferUsage usage)
+: IndexBuffer(idxType, numIndexes, usage)
+{
+	mData = new unsigned char[mSizeInBytes];
+	memset(mData, 0, mSizeInBytes);
+
+	mBufferId = NullRenderDriver::createObjectId();
+}
+
+NullIndexBuffer::~NullIndexBuffer()
+{
+	SAFE_DELETE_ARRAY(mData);
+}
+
+void NullIndexBuffer::readData(unsigned int offset, unsigned int length, void* pDest)
+{
+	if (offset + length > mSizeInBytes)
+	{
+		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("NullIndexBuffer", "Invalid attempt to read past the end of the index buffer", core::LOG_LEVEL_ERROR);
+		return;
+	}
+
+	memcpy(pDest, mData + offset, length);
+}
+
+void NullIndexBuffer::writeData(unsigned int offset, unsigned int length, const void* pSource, bool discardWholeBuffer)
+{
+	if (offset + length > mSizeInBytes)
+	{
+		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("NullIndexBuffer", "Invalid attempt to write past the end of the index buffer", core::LOG_LEVEL_ERROR);
+		return;
+	}
+
+	memcpy(mData + offset, pSource, length);
+}
+
+unsigned int NullIndexBuffer::getBufferId() const
+{
+	return mBufferId;
+}
+
+const unsigned char* NullIndexBuffer::getData() const
+{
+	return mData;
+}
+
+void* NullIndexBuffer::lockImpl(unsigned int offset, unsigned int length, resource::BufferLocking options)
+{
+	if(mIsLocked)
+	{
+		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("NullIndexBuffer", "Invalid attempt to lock a index buffer that has already been locked", core::LOG_LEVEL_ERROR);
+		return nullptr;
+	}
+
+	if(options == resource::BL_READ_ONLY && (mUsage & resource::BU_WRITE_ONLY))
+	{
+		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("NullIndexBuffer", "Invalid attempt to lock a write-only index buffer as read-only", core::LOG_LEVEL_ERROR);
+		return nullptr;
+	}
+
+	if (offset + length > mSizeInBytes)
+	{
+		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("NullIndexBuffer", "Invalid attempt to lock past the end of the index buffer", core::LOG_LEVEL_ERROR);
+		return nullptr;
+	}
+
+	// The memory is handed out directly, there is no copy to upload on unlock
+	return static_cast<void*>(mData + offset);
+}
+
+void NullIndexBuffer::unlockImpl() {}
+
+}// end namespace render
\ No newline at end of file
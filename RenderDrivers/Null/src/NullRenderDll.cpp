@@ -0,0 +1,80 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <NullRenderConfig.h>
+#include <render/RenderManager.h>
+#include <resource/ResourceDefines.h>
+#include <resource/ResourceFactory.h>
+#include <resource/ResourceManager.h>
+#include <NullRenderDriver.h>
+#include <NullTextureFactory.h>
+#include <NullShaderFactory.h>
+#include <NullMaterialFactory.h>
+
+namespace render
+{
+
+RenderDriver* nullRenderDriver = nullptr;
+resource::ResourceFactory* nullTextureFactory = nullptr;
+resource::ResourceFactory* nullShaderFactory = nullptr;
+resource::ResourceFactory* nullMaterialFactory = nullptr;
+
+extern "C" void NULLRENDER_PUBLIC_EXPORT loadPlugin() throw()
+{
+	nullRenderDriver = new NullRenderDriver();
+	if (RenderManager::getInstance() != nullptr)
+		RenderManager::getInstance()->setSystemDriver(nullRenderDriver);
+
+	nullTextureFactory = new NullTextureFactory();
+	nullShaderFactory = new NullShaderFactory();
+	nullMaterialFactory = new NullMaterialFactory();
+	if (resource::ResourceManager::getInstance() != nullptr)
+	{
+		resource::ResourceManager::getInstance()->registerResourceFactory(resource::RESOURCE_TYPE_TEXTURE, nullTextureFactory);
+		resource::ResourceManager::getInstance()->registerResourceFactory(resource::RESOURCE_TYPE_SHADER, nullShaderFactory);
+		resource::ResourceManager::getInstance()->registerResourceFactory(resource::RESOURCE_TYPE_RENDER_MATERIAL, nullMaterialFactory);
+	}
+}
+
+extern "C" void NULLRENDER_PUBLIC_EXPORT unloadPlugin()
+{
+	if (RenderManager::getInstance() != nullptr)
+		RenderManager::getInstance()->removeSystemDriver();
+
+	if (resource::ResourceManager::getInstance() != nullptr)
+	{
+		resource::ResourceManager::getInstance()->removeResourceFactory(resource::RESOURCE_TYPE_TEXTURE);
+		resource::ResourceManager::getInstance()->removeResourceFactory(resource::RESOURCE_TYPE_SHADER);
+		resource::ResourceManager::getInstance()->removeResourceFactory(resource::RESOURCE_TYPE_RENDER_MATERIAL);
+	}
+
+	SAFE_DELETE(nullTextureFactory);
+	SAFE_DELETE(nullShaderFactory);
+	SAFE_DELETE(nullMaterialFactory);
+	SAFE_DELETE(nullRenderDriver);
+}
+
+} // end namespace render
\ No newline at end of file
@@ -0,0 +1,313 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <render/RenderDefines.h>
+#include <render/Model.h>
+#include <render/Viewport.h>
+#include <render/VertexBuffer.h>
+#include <render/IndexBuffer.h>
+#include <render/RenderQueue.h>
+#include <render/ShaderParameter.h>
+#include <NullRenderDriver.h>
+#include <NullRenderWindow.h>
+#include <NullVertexBuffer.h>
+#include <NullIndexBuffer.h>
+#include <NullMaterial.h>
+
+template<> render::NullRenderDriver* core::Singleton<render::NullRenderDriver>::m_Singleton = nullptr;
+
+namespace render
+{
+
+unsigned int NullRenderDriver::mObjectIdCounter = 0;
+
+NullDrawCall::NullDrawCall()
+{
+	viewport = nullptr;
+	material = nullptr;
+	model = nullptr;
+	renderOperationType = ROT_TRIANGLE_LIST;
+	numVertices = 0;
+	numIndexes = 0;
+	transparent = false;
+	instanceCount = 1;
+}
+
+NullRenderDriver::NullRenderDriver(): RenderDriver("Null RenderDriver")
+{
+	mCurrentViewport = nullptr;
+	mFrameCount = 0;
+	mViewportCount = 0;
+	mUniformBufferId = 0;
+}
+
+NullRenderDriver::~NullRenderDriver() {}
+
+RenderWindow* NullRenderDriver::createRenderWindow(int width, int height, int colorDepth, bool fullScreen, int left, int top, bool depthBuffer, void* windowId)
+{
+	RenderWindow* pRenderWindow = new NullRenderWindow();
+
+	pRenderWindow->create(width, height, colorDepth, fullScreen, left, top, depthBuffer, windowId);
+
+	return pRenderWindow;
+}
+
+VertexBuffer* NullRenderDriver::createVertexBuffer(VertexBufferType vertexBufferType, VertexElementType vertexElementType, unsigned int numVertices, resource::BufferUsage usage)
+{
+	VertexBuffer* buf = new NullVertexBuffer(vertexBufferType, vertexElementType, numVertices, usage);
+
+	return buf;
+}
+
+void NullRenderDriver::removeVertexBuffer(VertexBuffer* buf)
+{
+	NullVertexBuffer* pNullBuffer = static_cast<NullVertexBuffer*>(buf);
+
+	assert(pNullBuffer);
+	mStateCache.removeBuffer(pNullBuffer->getBufferId());
+	SAFE_DELETE(pNullBuffer);
+}
+
+IndexBuffer* NullRenderDriver::createIndexBuffer(IndexType idxType, unsigned int numIndexes, resource::BufferUsage usage)
+{
+	IndexBuffer* buf = new NullIndexBuffer(idxType, numIndexes, usage);
+
+	return buf;
+}
+
+void NullRenderDriver::removeIndexBuffer(IndexBuffer* buf)
+{
+	NullIndexBuffer* pNullBuffer = static_cast<NullIndexBuffer*>(buf);
+
+	assert(pNullBuffer);
+	mStateCache.removeBuffer(pNullBuffer->getBufferId());
+	SAFE_DELETE(pNullBuffer);
+}
+
+void NullRenderDriver::beginFrame(Viewport* vp)
+{
+	mCurrentViewport = vp;
+	++mViewportCount;
+
+	// Same as a real clear, depth writes have to be on
+	if (vp != nullptr && vp->getClearEveryFrame())
+		mStateCache.setDepthWriteEnabled(true);
+}
+
+void NullRenderDriver::render(RenderStateData& renderStateData)
+{
+	Material* pMaterial = renderStateData.getCurrentMaterial();
+	if (pMaterial == nullptr)
+		return;
+
+	Model* pModel = renderStateData.getCurrentModel();
+	if (pModel == nullptr)
+		return;
+
+	VertexBuffer* pPositionBuffer = pModel->getVertexBuffer(VERTEX_BUFFER_TYPE_POSITION);
+	IndexBuffer* pIndexBuffer = pModel->getIndexBuffer();
+	if (pPositionBuffer == nullptr || pIndexBuffer == nullptr)
+		return;
+
+	// Walk the same state changes a real driver would make, so the state cache counters stay meaningful
+	NullMaterial* pNullMaterial = static_cast<NullMaterial*>(pMaterial);
+	mStateCache.setProgram(pNullMaterial->getProgramId());
+
+	bool transparent = pMaterial->isTransparent();
+	mStateCache.setBlendEnabled(transparent);
+	mStateCache.setDepthWriteEnabled(!transparent);
+
+	const std::vector<ShaderParameterInstruction>& parameterProgram = pMaterial->getParameterProgram();
+	if (pMaterial->hasParameterBlocks())
+	{
+		// The blocks were packed before the first draw, only their ranges are bound
+		for (unsigned int frequency = 0; frequency < SHADER_PARAMETER_FREQUENCY_COUNT; ++frequency)
+		{
+			unsigned int size = pMaterial->getParameterBlockSize((ShaderParameterFrequency)frequency);
+			if (size > 0 && mParameterBlockOffsets[frequency] != UNIFORM_RING_BUFFER_INVALID_OFFSET)
+				mStateCache.setUniformBlock(frequency, mUniformBufferId, mParameterBlockOffsets[frequency], size);
+		}
+	}
+	else
+	{
+		// The program keeps its values, only the frequencies that changed since it last had them set are walked
+		for (unsigned int frequency = 0; frequency < SHADER_PARAMETER_FREQUENCY_COUNT; ++frequency)
+		{
+			unsigned int version = renderStateData.getVersion((ShaderParameterFrequency)frequency);
+			if (pMaterial->getParameterVersion((ShaderParameterFrequency)frequency) == version)
+				continue;
+
+			pMaterial->setParameterVersion((ShaderParameterFrequency)frequency, version);
+
+			unsigned int first = 0;
+			unsigned int last = 0;
+			pMaterial->getParameterProgramRange((ShaderParameterFrequency)frequency, first, last);
+
+			for (unsigned int i = first; i < last; ++i)
+			{
+				unsigned int size = 0;
+				switch (parameterProgram[i].mParameterType)
+				{
+				case SHADER_PARAMETER_TYPE_FLOAT:
+					size = 1;
+					break;
+				case SHADER_PARAMETER_TYPE_FLOAT3:
+					size = 3;
+					break;
+				case SHADER_PARAMETER_TYPE_FLOAT4:
+					size = 4;
+					break;
+				case SHADER_PARAMETER_TYPE_MATRIX4:
+					size = 16;
+					break;
+				default:
+					continue;
+				}
+
+				// The parameters have no locations here, the instruction index stands for one
+				float values[16];
+				if (renderStateData.getParameterValue(parameterProgram[i].mSource, values))
+					mStateCache.setUniform(i, values, size * sizeof(float));
+			}
+		}
+	}
+
+	unsigned int usedAttributes = 0;
+	std::vector<ShaderVertexParameter*>& vertexParameters = pMaterial->getVertexParameters();
+	for (std::size_t vertexType = VERTEX_BUFFER_TYPE_POSITION; vertexType != VERTEX_BUFFER_TYPE_COUNT; ++vertexType)
+	{
+		if (vertexType >= vertexParameters.size() || vertexParameters[vertexType] == nullptr)
+			continue;
+
+		NullVertexBuffer* pVertexBuffer = static_cast<NullVertexBuffer*>(pModel->getVertexBuffer((VertexBufferType)vertexType));
+		if (pVertexBuffer == nullptr)
+			continue;
+
+		unsigned int index = (unsigned int)vertexType;
+		if (mStateCache.setVertexAttributeFormat(index, pVertexBuffer->getBufferId(), 0, (unsigned int)pVertexBuffer->getVertexElementType(), pVertexBuffer->getVertexSize()))
+			mStateCache.setVertexBuffer(pVertexBuffer->getBufferId());
+
+		mStateCache.setVertexAttributeEnabled(index, true);
+
+		usedAttributes |= (1 << index);
+	}
+
+	for (unsigned int i = 0; i < RENDER_STATE_MAX_VERTEX_ATTRIBUTES; ++i)
+	{
+		if ((usedAttributes & (1 << i)) == 0 && mStateCache.isVertexAttributeEnabled(i))
+			mStateCache.setVertexAttributeEnabled(i, false);
+	}
+
+	mStateCache.setIndexBuffer(static_cast<NullIndexBuffer*>(pIndexBuffer)->getBufferId());
+
+	NullDrawCall drawCall;
+	drawCall.viewport = mCurrentViewport;
+	drawCall.material = pMaterial;
+	drawCall.model = pModel;
+	drawCall.renderOperationType = pModel->getRenderOperationType();
+	drawCall.numVertices = pPositionBuffer->getNumVertices();
+	drawCall.numIndexes = pIndexBuffer->getNumIndexes();
+	drawCall.transparent = transparent;
+
+	mDrawCalls.push_back(drawCall);
+}
+
+void NullRenderDriver::renderInstances(RenderStateData& renderStateData, const RenderCommand* commands, unsigned int count, const float* instanceData)
+{
+	if (commands == nullptr || count == 0)
+		return;
+
+	// The instances share the mesh data and material of the first command
+	setCurrentCommand(renderStateData, commands);
+
+	std::size_t drawCallCount = mDrawCalls.size();
+
+	render(renderStateData);
+
+	if (mDrawCalls.size() > drawCallCount)
+		mDrawCalls.back().instanceCount = count;
+}
+
+void NullRenderDriver::endFrame()
+{
+	mCurrentViewport = nullptr;
+}
+
+void NullRenderDriver::setViewport(Viewport* viewport) {}
+
+const std::vector<NullDrawCall>& NullRenderDriver::getDrawCalls() const
+{
+	return mDrawCalls;
+}
+
+unsigned int NullRenderDriver::getFrameCount() const
+{
+	return mFrameCount;
+}
+
+unsigned int NullRenderDriver::getViewportCount() const
+{
+	return mViewportCount;
+}
+
+unsigned int NullRenderDriver::createObjectId()
+{
+	// 0 is the unbound object, like in GL
+	return ++mObjectIdCounter;
+}
+
+void NullRenderDriver::initializeImpl()
+{
+	mStateCache.reset();
+	mStateCache.setDepthWriteEnabled(true);
+	mStateCache.setBlendEnabled(false);
+
+	mDrawCalls.clear();
+	mFrameCount = 0;
+	mViewportCount = 0;
+
+	mUniformBufferId = createObjectId();
+}
+
+void NullRenderDriver::uninitializeImpl()
+{
+	mDrawCalls.clear();
+}
+
+void NullRenderDriver::updateImpl(float elapsedTime)
+{
+	// The driver is updated before the render manager draws, so this starts a new frame
+	mDrawCalls.clear();
+	mViewportCount = 0;
+	++mFrameCount;
+}
+
+NullRenderDriver* NullRenderDriver::getInstance()
+{
+	return core::Singleton<NullRenderDriver>::getInstance();
+}
+
+} // end namespace render
\ No newline at end of file
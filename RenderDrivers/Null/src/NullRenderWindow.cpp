@@ -0,0 +1,108 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <render/Viewport.h>
+#include <NullRenderWindow.h>
+
+namespace render
+{
+
+NullRenderWindow::NullRenderWindow(): RenderWindow()
+{
+	mIsFullScreen = false;
+	mIsDepthBuffered = true;
+	mActive = false;
+}
+
+NullRenderWindow::~NullRenderWindow() {}
+
+void NullRenderWindow::create(unsigned int width, unsigned int height, unsigned int colorDepth, bool fullScreen, unsigned int left, unsigned int top, bool depthBuffer, void* windowId)
+{
+	mWidth = width;
+	mHeight = height;
+	mColorDepth = colorDepth;
+	mIsFullScreen = fullScreen;
+	mIsDepthBuffered = depthBuffer;
+
+	if (mIsFullScreen)
+	{
+		mLeft = 0;
+		mTop = 0;
+	}
+	else
+	{
+		mLeft = left;
+		mTop = top;
+	}
+
+	// Nothing is shown, the window is always ready to be rendered to
+	mActive = true;
+}
+
+void NullRenderWindow::setFullscreen(bool fullScreen, unsigned int width, unsigned int height)
+{
+	mIsFullScreen = fullScreen;
+
+	resize(width, height);
+}
+
+void NullRenderWindow::reposition(int top, int left)
+{
+	mTop = top;
+	mLeft = left;
+}
+
+void NullRenderWindow::resize(unsigned int width, unsigned int height)
+{
+	if (width == mWidth && height == mHeight)
+		return;
+
+	mWidth = width;
+	mHeight = height;
+
+	// Notify viewports of resize
+	std::list<Viewport*>::const_iterator i;
+	for (i = mViewports.begin(); i != mViewports.end(); ++i)
+	{
+		Viewport* pViewport = (*i);
+		if (pViewport != nullptr)
+		{
+			pViewport->setDimenionsChanged();
+		}
+	}
+}
+
+void NullRenderWindow::setCaption(const std::string& text)
+{
+	mCaption = text;
+}
+
+const std::string& NullRenderWindow::getCaption() const
+{
+	return mCaption;
+}
+
+} // end namespace render
\ No newline at end of file
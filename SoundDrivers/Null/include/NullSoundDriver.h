@@ -0,0 +1,84 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _NULL_SOUND_DRIVER_H_
+#define _NULL_SOUND_DRIVER_H_
+
+#include <NullSoundConfig.h>
+#include <core/Singleton.h>
+#include <core/Vector3d.h>
+#include <sound/SoundDriver.h>
+
+namespace sound
+{
+
+//! Sound driver without an audio device.
+//!
+//! The listener and the global settings are only stored, so sound components
+//! can run their full logic on machines without audio hardware.
+class NULLSOUND_PUBLIC_EXPORT NullSoundDriver: public SoundDriver, public core::Singleton<NullSoundDriver>
+{
+public:
+
+	// Default constructor / destructor
+	NullSoundDriver();
+	~NullSoundDriver();
+
+	void updateListener(Listener* listener);
+
+	void setDopplerFactor(float dopplerFactor);
+	
+	void setSoundSpeed(float soundSpeed);
+
+	//! Returns the listener position of the last listener update.
+	const core::vector3d& getListenerPosition() const;
+
+	//! Returns the listener velocity of the last listener update.
+	const core::vector3d& getListenerVelocity() const;
+
+	float getDopplerFactor() const;
+
+	float getSoundSpeed() const;
+
+	static NullSoundDriver* getInstance();
+
+protected:
+
+	virtual void initializeImpl();
+	virtual void uninitializeImpl();
+	virtual void startImpl();
+	virtual void stopImpl();
+	virtual void updateImpl(float elapsedTime);
+
+	core::vector3d mListenerPosition;
+	core::vector3d mListenerVelocity;
+	float mDopplerFactor;
+	float mSoundSpeed;
+};
+
+} // end namespace sound
+
+#endif
\ No newline at end of file
@@ -0,0 +1,134 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <NullSound.h>
+#include <NullSoundData.h>
+
+#include <cmath>
+
+namespace sound
+{
+
+NullSound::NullSound(): Sound()
+{
+	mPlaying = false;
+	mPaused = false;
+	mPlayPosition = 0.0f;
+}
+
+NullSound::~NullSound()
+{
+	stop();
+}
+
+void NullSound::play()
+{
+	Sound::play();
+
+	if (isPlaying())
+		return;
+
+	mPlaying = true;
+	mPaused = false;
+}
+
+void NullSound::pause()
+{
+	Sound::pause();
+
+	if (!isPlaying())
+		return;
+
+	mPlaying = false;
+	mPaused = true;
+}
+
+void NullSound::stop()
+{
+	Sound::stop();
+
+	mPlaying = false;
+	mPaused = false;
+	mPlayPosition = 0.0f;
+}
+
+bool NullSound::isPlaying() const
+{
+	return mPlaying;
+}
+
+bool NullSound::isPaused() const
+{
+	return mPaused;
+}
+
+bool NullSound::isStopped() const
+{
+	return !mPlaying && !mPaused;
+}
+
+float NullSound::getPlayPosition() const
+{
+	return mPlayPosition;
+}
+
+void NullSound::updateImpl(float elapsedTime)
+{
+	Sound::updateImpl(elapsedTime);
+
+	if (!mPlaying)
+		return;
+
+	// The pitch changes the playback rate, as it does on a real voice
+	mPlayPosition += elapsedTime * mPitch;
+
+	float duration = 0.0f;
+	if (mSoundData != nullptr)
+		duration = static_cast<NullSoundData*>(mSoundData)->getDuration();
+
+	// Unknown lengths play until stopped
+	if (duration <= 0.0f || mPlayPosition < duration)
+		return;
+
+	if (mLoop)
+	{
+		mPlayPosition = fmod(mPlayPosition, duration);
+	}
+	else
+	{
+		mPlaying = false;
+		mPlayPosition = 0.0f;
+	}
+}
+
+void NullSound::setSoundDataImpl(SoundData* soundData)
+{
+	mPlaying = false;
+	mPaused = false;
+	mPlayPosition = 0.0f;
+}
+
+} // end namespace sound
\ No newline at end of file
@@ -0,0 +1,155 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <core/Log.h>
+#include <core/LogDefines.h>
+#include <resource/ResourceManager.h>
+#include <NullSoundData.h>
+
+#include <cstdio>
+#include <cstring>
+
+namespace sound
+{
+
+NullSoundData::NullSoundData(const std::string& filename, resource::Serializer* serializer): SoundData(filename, serializer)
+{
+	mDuration = 0.0f;
+}
+
+NullSoundData::~NullSoundData() {}
+
+float NullSoundData::getDuration() const
+{
+	return mDuration;
+}
+
+bool NullSoundData::loadImpl()
+{
+	std::string extention;
+
+	// Get extension.
+	size_t pos = mFilename.find_last_of('.');
+	if (pos == std::string::npos)
+	{
+		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("NullSoundData", "Unable to load sound - invalid extension.", core::LOG_LEVEL_ERROR);
+		return false;
+	}
+
+	if (resource::ResourceManager::getInstance() == nullptr)
+	{
+		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("NullSoundData", "Unable to load sound - resources data path not set.", core::LOG_LEVEL_ERROR);
+		return false;
+	}
+
+	extention = mFilename.substr(pos + 1, mFilename.size() - pos);
+
+	if (extention != "wav" && extention != "ogg")
+	{
+		std::string message = "Unable to load sound - ";
+		message += extention;
+		message += " unsupported extension.";
+
+		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("NullSoundData", message, core::LOG_LEVEL_ERROR);
+		return false;
+	}
+
+	std::string filePath = resource::ResourceManager::getInstance()->getDataPath() + "/" + mFilename;
+
+	FILE* pFile = fopen(filePath.c_str(), "rb");
+	if (pFile == nullptr)
+	{
+		std::string message = "Unable to load sound - ";
+		message += mFilename;
+		message += " not found.";
+
+		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("NullSoundData", message, core::LOG_LEVEL_ERROR);
+		return false;
+	}
+
+	// Ogg files would have to be decoded to know their length, they play until stopped
+	mDuration = 0.0f;
+	if (extention == "wav" && !readWavDuration(pFile))
+	{
+		if (core::Log::getInstance() != nullptr) core::Log::getInstance()->logMessage("NullSoundData", "Unable to read the wav header of " + mFilename, core::LOG_LEVEL_WARNING);
+	}
+
+	fclose(pFile);
+
+	return true;
+}
+
+void NullSoundData::unloadImpl()
+{
+	SoundData::unloadImpl();
+
+	mDuration = 0.0f;
+}
+
+bool NullSoundData::readWavDuration(FILE* pFile)
+{
+	unsigned char header[12];
+	if (fread(header, 1, 12, pFile) != 12)
+		return false;
+
+	if (memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0)
+		return false;
+
+	unsigned int byteRate = 0;
+
+	// Walk the chunks until the data chunk, the format chunk comes before it
+	unsigned char chunk[8];
+	while (fread(chunk, 1, 8, pFile) == 8)
+	{
+		unsigned int chunkSize = chunk[4] | (chunk[5] << 8) | (chunk[6] << 16) | (chunk[7] << 24);
+
+		if (memcmp(chunk, "fmt ", 4) == 0)
+		{
+			unsigned char format[16];
+			if (chunkSize < 16 || fread(format, 1, 16, pFile) != 16)
+				return false;
+
+			byteRate = format[8] | (format[9] << 8) | (format[10] << 16) | (format[11] << 24);
+			chunkSize -= 16;
+		}
+		else if (memcmp(chunk, "data", 4) == 0)
+		{
+			if (byteRate == 0)
+				return false;
+
+			mDuration = (float)chunkSize / (float)byteRate;
+			return true;
+		}
+
+		// Chunks are word aligned
+		if (fseek(pFile, (long)(chunkSize + (chunkSize & 1)), SEEK_CUR) != 0)
+			return false;
+	}
+
+	return false;
+}
+
+} // end namespace sound
\ No newline at end of file
@@ -0,0 +1,76 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <NullSoundConfig.h>
+#include <core/SystemDriver.h>
+#include <sound/SoundManager.h>
+#include <resource/ResourceDefines.h>
+#include <resource/ResourceFactory.h>
+#include <resource/ResourceManager.h>
+#include <NullSoundDriver.h>
+#include <NullSoundFactory.h>
+#include <NullSoundDataFactory.h>
+
+namespace sound
+{
+
+SoundDriver* nullSoundDriver = nullptr;
+SoundFactory* nullSoundFactory = nullptr;
+resource::ResourceFactory* nullSoundDataFactory = nullptr;
+
+extern "C" void NULLSOUND_PUBLIC_EXPORT loadPlugin() throw()
+{	
+	nullSoundDriver = new NullSoundDriver();
+	nullSoundFactory = new NullSoundFactory();
+	if (SoundManager::getInstance() != nullptr)
+	{
+		SoundManager::getInstance()->setSystemDriver((core::SystemDriver*)nullSoundDriver);
+		SoundManager::getInstance()->setDefaultSoundFactory(nullSoundFactory);
+	}
+
+	nullSoundDataFactory = new NullSoundDataFactory();
+	if (resource::ResourceManager::getInstance() != nullptr)
+		resource::ResourceManager::getInstance()->registerResourceFactory(resource::RESOURCE_TYPE_SOUND_DATA, nullSoundDataFactory);
+}
+
+extern "C" void NULLSOUND_PUBLIC_EXPORT unloadPlugin()
+{
+	if (SoundManager::getInstance() != nullptr)
+	{
+		SoundManager::getInstance()->removeSystemDriver();
+		SoundManager::getInstance()->removeDefaultSoundFactory();
+	}
+
+	if (resource::ResourceManager::getInstance() != nullptr)
+		resource::ResourceManager::getInstance()->removeResourceFactory(resource::RESOURCE_TYPE_SOUND_DATA);
+
+	SAFE_DELETE(nullSoundFactory);
+	SAFE_DELETE(nullSoundDataFactory);
+
+	SAFE_DELETE(nullSoundDriver);
+}
+
+} // end namespace sound
\ No newline at end of file
@@ -0,0 +1,115 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <sound/Listener.h>
+#include <game/GameObject.h>
+#include <game/Transform.h>
+#include <game/ComponentDefines.h>
+#include <NullSoundDriver.h>
+
+template<> sound::NullSoundDriver* core::Singleton<sound::NullSoundDriver>::m_Singleton = nullptr;
+
+namespace sound
+{
+
+NullSoundDriver::NullSoundDriver(): SoundDriver("Null SoundDriver")
+{
+	mListenerPosition = core::vector3d::ORIGIN_3D;
+	mListenerVelocity = core::vector3d::ORIGIN_3D;
+	mDopplerFactor = 1.0f;
+	mSoundSpeed = 343.0f;
+}
+
+NullSoundDriver::~NullSoundDriver() {}
+
+void NullSoundDriver::updateListener(Listener* listener)
+{
+	if (listener == nullptr)
+		return;
+
+	if (listener->getGameObject() != nullptr)
+	{
+		game::Transform* pTransform = listener->getGameObject()->getTransform();
+		if (pTransform != nullptr)
+		{
+			mListenerPosition = pTransform->getAbsolutePosition();
+			mListenerVelocity = listener->getVelocity();
+		}
+	}
+}
+
+void NullSoundDriver::setDopplerFactor(float dopplerFactor)
+{
+	mDopplerFactor = dopplerFactor;
+}
+
+void NullSoundDriver::setSoundSpeed(float soundSpeed)
+{
+	mSoundSpeed = soundSpeed;
+}
+
+const core::vector3d& NullSoundDriver::getListenerPosition() const
+{
+	return mListenerPosition;
+}
+
+const core::vector3d& NullSoundDriver::getListenerVelocity() const
+{
+	return mListenerVelocity;
+}
+
+float NullSoundDriver::getDopplerFactor() const
+{
+	return mDopplerFactor;
+}
+
+float NullSoundDriver::getSoundSpeed() const
+{
+	return mSoundSpeed;
+}
+
+void NullSoundDriver::initializeImpl()
+{
+	mListenerPosition = core::vector3d::ORIGIN_3D;
+	mListenerVelocity = core::vector3d::ORIGIN_3D;
+	mDopplerFactor = 1.0f;
+	mSoundSpeed = 343.0f;
+}
+
+void NullSoundDriver::uninitializeImpl() {}
+
+void NullSoundDriver::startImpl() {}
+
+void NullSoundDriver::stopImpl() {}
+
+void NullSoundDriver::updateImpl(float elapsedTime) {}
+
+NullSoundDriver* NullSoundDriver::getInstance()
+{
+	return core::Singleton<NullSoundDriver>::getInstance();
+}
+
+} // end namespace sound
\ No newline at end of file
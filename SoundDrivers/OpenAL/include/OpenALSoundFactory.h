@@ -29,6 +29,8 @@ THE SOFTWARE.
 
 #include <OpenALConfig.h>
 #include <sound/SoundFactory.h>
+#include <game/PooledComponentFactory.h>
+#include <OpenALSound.h>
 
 namespace game
 {
@@ -38,7 +40,7 @@ class Component;
 namespace sound
 {
 
-class OPENAL_PUBLIC_EXPORT OpenALSoundFactory: public SoundFactory
+class OPENAL_PUBLIC_EXPORT OpenALSoundFactory: public game::PooledComponentFactory<OpenALSound, SoundFactory>
 {
 public:
 
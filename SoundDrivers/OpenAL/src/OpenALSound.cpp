@@ -42,6 +42,7 @@ OpenALSound::OpenALSound(): Sound()
 	alGetError(); // Clear Error Code
 
 	mSourceNeedsUpdate = true;
+	mMessageMask = MESSAGE_MASK(game::MESSAGE_TRANSFORM_NEEDS_UPDATE);
 
 	// Generate a Source to playback the Buffer
 	alGenSources(1, &mSourceId);
@@ -240,7 +241,7 @@ void OpenALSound::updateImpl(float elapsedTime)
 	{
 		if (mGameObject != nullptr)
 		{
-			game::Transform* pTransform = static_cast<game::Transform*>(mGameObject->getComponent(game::COMPONENT_TYPE_TRANSFORM));
+			game::Transform* pTransform = mGameObject->getTransform();
 			if (pTransform != nullptr)
 			{
 				core::vector3d position = pTransform->getAbsolutePosition();
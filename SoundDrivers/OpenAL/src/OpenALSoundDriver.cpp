@@ -56,7 +56,7 @@ void OpenALSoundDriver::updateListener(Listener* listener)
 
 	if (listener->getGameObject() != nullptr)
 	{
-		game::Transform* pTransform = static_cast<game::Transform*>(listener->getGameObject()->getComponent(game::COMPONENT_TYPE_TRANSFORM));
+		game::Transform* pTransform = listener->getGameObject()->getTransform();
 		if (pTransform != nullptr)
 		{
 			core::vector3d position = pTransform->getAbsolutePosition();
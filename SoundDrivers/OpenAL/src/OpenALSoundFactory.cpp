@@ -33,7 +33,7 @@ namespace sound
 
 game::Component* OpenALSoundFactory::createComponent()
 {
-	OpenALSound* pSound = new OpenALSound();
+	OpenALSound* pSound = mPool.create();
 	
 	if (SoundManager::getInstance() != nullptr)
 		SoundManager::getInstance()->addSound(pSound);
@@ -49,7 +49,7 @@ void OpenALSoundFactory::destroyComponent(game::Component* component)
 		SoundManager::getInstance()->removeSound(pSound);
 
 	assert(pSound != nullptr);
-	SAFE_DELETE(pSound);
+	mPool.destroy(pSound);
 }
 
 } // end namespace sound
@@ -0,0 +1,296 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <Test.h>
+#include <core/Simd.h>
+#include <core/Matrix4.h>
+#include <core/Aabox3d.h>
+#include <core/Sphere3d.h>
+#include <render/Frustum.h>
+#include <render/CameraDefines.h>
+#include <render/FrustumDefines.h>
+#include <platform/PlatformManager.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+//! Not a multiple of the 8 volumes of an AVX group so that the tails are tested too.
+const unsigned int CULL_VOLUME_COUNT = 20003;
+const unsigned int CULL_VIEW_COUNT = 8;
+
+float getRandom(float minValue, float maxValue)
+{
+	return minValue + (maxValue - minValue) * (rand() / (float)RAND_MAX);
+}
+
+//! Random volumes around the camera, part of them inside, part outside and part across the planes.
+struct CullScene
+{
+	std::vector<core::aabox3d> boxes;
+	std::vector<core::sphere3d> spheres;
+
+	std::vector<float> centerX;
+	std::vector<float> centerY;
+	std::vector<float> centerZ;
+	std::vector<float> radius;
+	std::vector<float> extentX;
+	std::vector<float> extentY;
+	std::vector<float> extentZ;
+
+	core::CullingVolumes sphereVolumes;
+	core::CullingVolumes boxVolumes;
+};
+
+void createCullScene(CullScene& scene, unsigned int count)
+{
+	scene.boxes.resize(count);
+	scene.spheres.resize(count);
+	scene.centerX.resize(count);
+	scene.centerY.resize(count);
+	scene.centerZ.resize(count);
+	scene.radius.resize(count);
+	scene.extentX.resize(count);
+	scene.extentY.resize(count);
+	scene.extentZ.resize(count);
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		core::vector3d center(getRandom(-300.0f, 300.0f), getRandom(-300.0f, 300.0f), getRandom(-300.0f, 300.0f));
+		core::vector3d size(getRandom(0.0f, 40.0f), getRandom(0.0f, 40.0f), getRandom(0.0f, 40.0f));
+
+		scene.boxes[i] = core::aabox3d(center - size * 0.5f, center + size * 0.5f);
+		scene.spheres[i] = core::sphere3d(center, getRandom(0.0f, 30.0f));
+
+		// the boxes go to the kernels the way Frustum::isVisible sees them
+		core::vector3d boxCenter = scene.boxes[i].getCenter();
+		core::vector3d boxExtent = scene.boxes[i].getExtent() * 0.5f;
+
+		scene.centerX[i] = boxCenter.x;
+		scene.centerY[i] = boxCenter.y;
+		scene.centerZ[i] = boxCenter.z;
+		scene.extentX[i] = boxExtent.x;
+		scene.extentY[i] = boxExtent.y;
+		scene.extentZ[i] = boxExtent.z;
+		scene.radius[i] = scene.spheres[i].Radius;
+	}
+
+	// the spheres share the centers of the boxes
+	for (unsigned int i = 0; i < count; ++i)
+		scene.spheres[i].Center = core::vector3d(scene.centerX[i], scene.centerY[i], scene.centerZ[i]);
+
+	core::CullingVolumes volumes = {&scene.centerX[0], &scene.centerY[0], &scene.centerZ[0], &scene.radius[0], &scene.extentX[0], &scene.extentY[0], &scene.extentZ[0]};
+	scene.sphereVolumes = volumes;
+	scene.boxVolumes = volumes;
+}
+
+void buildFrustum(render::Frustum& frustum, unsigned int view)
+{
+	float angle = view * 0.8f;
+
+	core::matrix4 projection;
+	core::matrix4 viewMatrix;
+	projection.buildProjectionMatrixPerspectiveFov(1.0f, 1.333f, 1.0f, 400.0f);
+	viewMatrix.buildViewMatrix(core::vector3d(0, 0, 0), core::vector3d(sinf(angle), 0.3f * cosf(angle * 1.7f), -cosf(angle)), core::vector3d(0, 1, 0));
+
+	frustum.buildViewFrustum(projection, viewMatrix, render::PROJECTION_TYPE_PERSPECTIVE, 1.0f, 1.333f, 1.0f, 400.0f);
+}
+
+void packPlanes(const render::Frustum& frustum, float* planes)
+{
+	for (unsigned int i = 0; i < render::FRUSTUM_PLANE_COUNT; ++i)
+	{
+		const core::plane3d& plane = frustum.getPlane(i);
+		planes[i * 4 + 0] = plane.Normal.x;
+		planes[i * 4 + 1] = plane.Normal.y;
+		planes[i * 4 + 2] = plane.Normal.z;
+		planes[i * 4 + 3] = plane.D;
+	}
+}
+
+bool isVolumeVisible(const std::vector<unsigned int>& visible, unsigned int i)
+{
+	return (visible[i >> 5] & (1u << (i & 31))) != 0;
+}
+
+//! Culls the scene with the kernels of a level, with and without the plane kept from the last call,
+//! and compares every verdict with Frustum::isVisible.
+bool checkCullLevel(core::SimdLevel level, CullScene& scene)
+{
+	const core::MathKernels& kernels = core::getMathKernels(level);
+
+	unsigned int count = scene.boxes.size();
+	std::vector<unsigned int> visibleSpheres((count + 31) / 32);
+	std::vector<unsigned int> visibleBoxes((count + 31) / 32);
+	std::vector<unsigned char> sphereLastPlanes(count, 0);
+	std::vector<unsigned char> boxLastPlanes(count, 0);
+
+	unsigned int visibleCount = 0;
+
+	for (unsigned int view = 0; view < CULL_VIEW_COUNT; ++view)
+	{
+		render::Frustum frustum;
+		buildFrustum(frustum, view);
+
+		float planes[render::FRUSTUM_PLANE_COUNT * 4];
+		packPlanes(frustum, planes);
+
+		for (unsigned int pass = 0; pass < 2; ++pass)
+		{
+			kernels.cullSpheres(planes, scene.sphereVolumes, count, &visibleSpheres[0], (pass == 0) ? nullptr : &sphereLastPlanes[0]);
+			kernels.cullBoxes(planes, scene.boxVolumes, count, &visibleBoxes[0], (pass == 0) ? nullptr : &boxLastPlanes[0]);
+
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				CHECK(isVolumeVisible(visibleSpheres, i) == frustum.isVisible(scene.spheres[i]));
+				CHECK(isVolumeVisible(visibleBoxes, i) == frustum.isVisible(scene.boxes[i]));
+
+				if (isVolumeVisible(visibleBoxes, i))
+					++visibleCount;
+			}
+		}
+	}
+
+	// some of the volumes have to be on each side
+	CHECK(visibleCount > 0);
+	CHECK(visibleCount < count * CULL_VIEW_COUNT * 2);
+
+	return true;
+}
+
+} // end namespace
+
+//! The scalar, SSE2 and AVX2 level cull kernels give the verdicts of Frustum::isVisible, levels the CPU lacks are skipped.
+TEST_CASE(FrustumCullKernelsMatchScalar)
+{
+	srand(5);
+
+	CullScene scene;
+	createCullScene(scene, CULL_VOLUME_COUNT);
+
+	platform::PlatformManager* pPlatformManager = new platform::PlatformManager();
+
+	bool result = checkCullLevel(core::SIMD_LEVEL_NONE, scene);
+	if (result && pPlatformManager->checkCPUFeature(platform::CPU_FEATURE_SSE2))
+		result = checkCullLevel(core::SIMD_LEVEL_SSE2, scene);
+	if (result && pPlatformManager->checkCPUFeature(platform::CPU_FEATURE_AVX2))
+		result = checkCullLevel(core::SIMD_LEVEL_AVX2, scene);
+
+	delete pPlatformManager;
+
+	return result;
+}
+
+//! Reports the volumes culled per microsecond by Frustum::isVisible and by the kernels of every level.
+TEST_CASE(FrustumCullThroughput)
+{
+	const unsigned int VOLUME_COUNT = 100000;
+	const unsigned int RUN_COUNT = 20;
+
+	srand(6);
+
+	CullScene scene;
+	createCullScene(scene, VOLUME_COUNT);
+
+	render::Frustum frustum;
+	buildFrustum(frustum, 0);
+
+	float planes[render::FRUSTUM_PLANE_COUNT * 4];
+	packPlanes(frustum, planes);
+
+	std::vector<unsigned int> visible((VOLUME_COUNT + 31) / 32);
+	std::vector<unsigned char> lastPlanes(VOLUME_COUNT, 0);
+
+	unsigned int isVisibleCount = 0;
+	double bestIsVisible = 0.0;
+	for (unsigned int run = 0; run < RUN_COUNT; ++run)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		unsigned int visibleCount = 0;
+		for (unsigned int i = 0; i < VOLUME_COUNT; ++i)
+		{
+			if (frustum.isVisible(scene.boxes[i]))
+				++visibleCount;
+		}
+		double time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+		if (run == 0 || time < bestIsVisible) bestIsVisible = time;
+		isVisibleCount = visibleCount;
+	}
+
+	std::cout<<"Frustum cull of "<<VOLUME_COUNT<<" boxes: isVisible "<<VOLUME_COUNT / bestIsVisible<<" per us"<<std::endl;
+
+	platform::PlatformManager* pPlatformManager = new platform::PlatformManager();
+
+	const char* levelNames[core::SIMD_LEVEL_COUNT] = {"scalar", "SSE2", "AVX2"};
+	const platform::CpuFeature levelFeatures[core::SIMD_LEVEL_COUNT] = {platform::CPU_FEATURE_FPU, platform::CPU_FEATURE_SSE2, platform::CPU_FEATURE_AVX2};
+
+	for (unsigned int level = 0; level < core::SIMD_LEVEL_COUNT; ++level)
+	{
+		if (level != core::SIMD_LEVEL_NONE && !pPlatformManager->checkCPUFeature(levelFeatures[level]))
+			continue;
+
+		const core::MathKernels& kernels = core::getMathKernels((core::SimdLevel)level);
+
+		double bestBoxes = 0.0;
+		double bestSpheres = 0.0;
+		for (unsigned int run = 0; run < RUN_COUNT; ++run)
+		{
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			kernels.cullBoxes(planes, scene.boxVolumes, VOLUME_COUNT, &visible[0], &lastPlanes[0]);
+			double boxes = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+			start = std::chrono::steady_clock::now();
+			kernels.cullSpheres(planes, scene.sphereVolumes, VOLUME_COUNT, &visible[0], &lastPlanes[0]);
+			double spheres = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+			if (run == 0 || boxes < bestBoxes) bestBoxes = boxes;
+			if (run == 0 || spheres < bestSpheres) bestSpheres = spheres;
+		}
+
+		// the boxes culled last keep the verdicts of isVisible
+		kernels.cullBoxes(planes, scene.boxVolumes, VOLUME_COUNT, &visible[0], nullptr);
+		unsigned int visibleCount = 0;
+		for (unsigned int i = 0; i < VOLUME_COUNT; ++i)
+		{
+			if (isVolumeVisible(visible, i))
+				++visibleCount;
+		}
+		CHECK(visibleCount == isVisibleCount);
+
+		std::cout<<"Frustum cull of "<<VOLUME_COUNT<<" volumes: "<<levelNames[level]<<" boxes "<<VOLUME_COUNT / bestBoxes<<" per us ("<<bestIsVisible / bestBoxes<<"x), spheres "
+			<<VOLUME_COUNT / bestSpheres<<" per us"<<std::endl;
+	}
+
+	delete pPlatformManager;
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,280 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <Test.h>
+#include <Engine.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+//! Enough objects for the pools of the transforms and the models to span several chunks.
+const unsigned int SCENE_OBJECT_COUNT = 3000;
+
+struct TestScene
+{
+	engine::EngineManager* engineManager;
+	std::vector<game::Transform*> transforms;
+	std::vector<render::Model*> models;
+};
+
+//! Starts the engine on the null drivers with the given number of workers and fills it with models,
+//! four of every five objects are children of the fifth one.
+bool createScene(TestScene& scene, int workerThreads)
+{
+	scene.engineManager = new engine::EngineManager();
+
+	engine::EngineSettings* pSettings = engine::EngineSettings::getInstance();
+	pSettings->setDataPath(test::getMediaPath());
+	pSettings->setWidth(320);
+	pSettings->setHeight(240);
+	pSettings->setWorkerThreads(workerThreads);
+
+	// the options saved by the previous test would override the settings above
+	remove((pSettings->getWorkPath() + "/EngineTests.xml").c_str());
+	scene.engineManager->setOptionsFile(pSettings->getWorkPath() + "/EngineTests.xml");
+	engine::PluginManager::getInstance()->setPluginsFile(pSettings->getWorkPath() + "/PluginsHeadless.xml");
+
+	scene.engineManager->initialize();
+
+	resource::ResourceManager* pResourceManager = resource::ResourceManager::getInstance();
+	render::MeshData* pMeshData = static_cast<render::MeshData*>(pResourceManager->createResource(resource::RESOURCE_TYPE_MESH_DATA, "meshes/Cube1m.xml"));
+	render::Material* pMaterial = static_cast<render::Material*>(pResourceManager->createResource(resource::RESOURCE_TYPE_RENDER_MATERIAL, "materials/ShaderDefault.xml"));
+	if (pMeshData == nullptr || pMaterial == nullptr)
+		return false;
+
+	game::GameManager* pGameManager = game::GameManager::getInstance();
+
+	game::GameObject* pParent = nullptr;
+	for (unsigned int i = 0; i < SCENE_OBJECT_COUNT; ++i)
+	{
+		game::GameObject* pGameObject = pGameManager->createGameObject();
+		game::Transform* pTransform = static_cast<game::Transform*>(pGameManager->createComponent(game::COMPONENT_TYPE_TRANSFORM));
+		render::Model* pModel = static_cast<render::Model*>(pGameManager->createComponent(game::COMPONENT_TYPE_MODEL));
+		pGameObject->attachComponent(pTransform);
+		pGameObject->attachComponent(pModel);
+		pModel->setMeshData(pMeshData);
+		pModel->setMaterial(pMaterial);
+
+		if (i % 5 == 0)
+			pParent = pGameObject;
+		else
+			pGameObject->setParent(pParent);
+
+		scene.transforms.push_back(pTransform);
+		scene.models.push_back(pModel);
+	}
+
+	scene.engineManager->start();
+
+	return pMeshData->getState() == resource::RESOURCE_STATE_LOADED;
+}
+
+void destroyScene(TestScene& scene)
+{
+	scene.engineManager->stop();
+	scene.engineManager->uninitialize();
+
+	SAFE_DELETE(scene.engineManager);
+
+	scene.transforms.clear();
+	scene.models.clear();
+}
+
+//! Moves a third of the objects, the same ones for the same frame whatever the worker count.
+void moveScene(TestScene& scene, unsigned int frame)
+{
+	for (unsigned int i = frame % 3; i < scene.transforms.size(); i += 3)
+	{
+		float angle = i * 0.1f + frame * 0.05f;
+		scene.transforms[i]->setPosition(10.0f * sinf(angle), 0.5f * i, 10.0f * cosf(angle));
+		scene.transforms[i]->setOrientation(core::quaternion(0.0f, sinf(angle * 0.5f), 0.0f, cosf(angle * 0.5f)));
+	}
+}
+
+void appendValues(std::vector<float>& state, const float* values, unsigned int count)
+{
+	state.insert(state.end(), values, values + count);
+}
+
+//! Runs frames of the whole engine and returns the absolute transforms and the model bounds they end with.
+bool runScene(int workerThreads, unsigned int frameCount, std::vector<float>& state)
+{
+	TestScene scene;
+	if (!createScene(scene, workerThreads))
+		return false;
+
+	for (unsigned int frame = 0; frame < frameCount; ++frame)
+	{
+		moveScene(scene, frame);
+		scene.engineManager->update(0.016f);
+	}
+
+	for (unsigned int i = 0; i < scene.transforms.size(); ++i)
+	{
+		appendValues(state, &scene.transforms[i]->getAbsolutePosition().x, 3);
+		appendValues(state, &scene.transforms[i]->getAbsoluteOrientation().x, 4);
+		appendValues(state, &scene.transforms[i]->getAbsoluteScale().x, 3);
+
+		render::Model* pModel = scene.models[i];
+		appendValues(state, pModel->getWorldMatrix().get(), 16);
+		appendValues(state, &pModel->getBoundingBox().MinEdge.x, 3);
+		appendValues(state, &pModel->getBoundingBox().MaxEdge.x, 3);
+		appendValues(state, &pModel->getBoundingSphere().Center.x, 3);
+		appendValues(state, &pModel->getBoundingSphere().Radius, 1);
+	}
+
+	destroyScene(scene);
+
+	return true;
+}
+
+bool hasChild(game::GameObject* parent, game::GameObject* child)
+{
+	const std::vector<game::GameObject*>& children = parent->getChildren();
+	return std::find(children.begin(), children.end(), child) != children.end() && child->getParent() == parent;
+}
+
+unsigned int getMaxWorkerCount()
+{
+	unsigned int workers = std::thread::hardware_concurrency();
+	return (workers > 4) ? workers - 1 : 3;
+}
+
+} // end namespace
+
+//! The thread-safe component types updated on the workers end in the same state as the serial update.
+TEST_CASE(GameManagerParallelUpdateIsDeterministic)
+{
+	const unsigned int FRAME_COUNT = 10;
+
+	std::vector<float> serialState;
+	CHECK(runScene(0, FRAME_COUNT, serialState));
+
+	std::vector<float> parallelState;
+	CHECK(runScene((int)getMaxWorkerCount(), FRAME_COUNT, parallelState));
+
+	CHECK(serialState.size() == SCENE_OBJECT_COUNT * 36);
+	CHECK(serialState.size() == parallelState.size());
+	CHECK(memcmp(&serialState[0], &parallelState[0], serialState.size() * sizeof(float)) == 0);
+
+	return true;
+}
+
+//! Children stay listed once through reparenting and removal, whatever took the place of the ones removed.
+TEST_CASE(GameManagerReparentsChildren)
+{
+	game::GameObject parent;
+	game::GameObject otherParent;
+
+	game::GameObject* pChildren[4];
+	for (unsigned int i = 0; i < 4; ++i)
+	{
+		pChildren[i] = new game::GameObject();
+		parent.addChild(pChildren[i]);
+	}
+
+	CHECK(parent.getChildren().size() == 4);
+
+	parent.removeChild(pChildren[0]);
+	CHECK(pChildren[0]->getParent() == nullptr);
+	CHECK(parent.removeChild(pChildren[1]->getID()) == pChildren[1]);
+	CHECK(pChildren[1]->getParent() == nullptr);
+	CHECK(parent.removeChild(pChildren[1]->getID()) == nullptr);
+
+	pChildren[2]->setParent(&otherParent);
+	pChildren[0]->setParent(&parent);
+
+	// a game object that isn't a child is left where it is
+	parent.removeChild(pChildren[2]);
+
+	CHECK(parent.getChildren().size() == 2);
+	CHECK(hasChild(&parent, pChildren[0]));
+	CHECK(hasChild(&parent, pChildren[3]));
+	CHECK(otherParent.getChildren().size() == 1);
+	CHECK(hasChild(&otherParent, pChildren[2]));
+
+	delete pChildren[3];
+	CHECK(parent.getChildren().size() == 1);
+	CHECK(hasChild(&parent, pChildren[0]));
+
+	parent.removeAllChildren();
+	CHECK(parent.getChildren().empty());
+	CHECK(pChildren[0]->getParent() == nullptr);
+
+	delete pChildren[0];
+	delete pChildren[1];
+	delete pChildren[2];
+	CHECK(otherParent.getChildren().empty());
+
+	return true;
+}
+
+//! Reports the time of the game update, hierarchy, component update and commit, for 0 to N workers.
+TEST_CASE(GameManagerUpdateScaling)
+{
+	const unsigned int FRAME_COUNT = 30;
+
+	double serialTime = 0.0;
+
+	unsigned int maxWorkers = getMaxWorkerCount();
+	for (unsigned int workers = 0; workers <= maxWorkers; ++workers)
+	{
+		TestScene scene;
+		CHECK(createScene(scene, (int)workers));
+
+		game::GameManager* pGameManager = game::GameManager::getInstance();
+
+		double bestTime = 0.0;
+		for (unsigned int frame = 0; frame < FRAME_COUNT; ++frame)
+		{
+			moveScene(scene, frame);
+
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			pGameManager->update(0.016f);
+			double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			if (frame == 0 || time < bestTime) bestTime = time;
+		}
+
+		if (workers == 0)
+			serialTime = bestTime;
+
+		std::cout<<"Game update of "<<SCENE_OBJECT_COUNT<<" models with "<<workers<<" workers: "<<bestTime<<" ms, "<<serialTime / bestTime<<"x"<<std::endl;
+
+		destroyScene(scene);
+	}
+
+	return true;
+}
\ No newline at end of file
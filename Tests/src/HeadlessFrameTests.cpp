@@ -0,0 +1,104 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <Test.h>
+#include <Engine.h>
+
+#include <stdio.h>
+#include <string>
+
+//! Runs complete frames through the null render, sound and input drivers.
+TEST_CASE(HeadlessFrameRendersModels)
+{
+	engine::EngineManager* pEngineManager = new engine::EngineManager();
+
+	engine::EngineSettings* pSettings = engine::EngineSettings::getInstance();
+	pSettings->setDataPath(test::getMediaPath());
+	pSettings->setWidth(320);
+	pSettings->setHeight(240);
+
+	// the options saved by the previous test would override the settings above
+	remove((pSettings->getWorkPath() + "/EngineTests.xml").c_str());
+	pEngineManager->setOptionsFile(pSettings->getWorkPath() + "/EngineTests.xml");
+	engine::PluginManager::getInstance()->setPluginsFile(pSettings->getWorkPath() + "/PluginsHeadless.xml");
+
+	pEngineManager->initialize();
+
+	render::RenderManager* pRenderManager = render::RenderManager::getInstance();
+	render::RenderDriver* pRenderDriver = static_cast<render::RenderDriver*>(pRenderManager->getSystemDriver());
+	CHECK(pRenderDriver != nullptr);
+	CHECK(pRenderManager->getMainWindow() != nullptr);
+
+	resource::ResourceManager* pResourceManager = resource::ResourceManager::getInstance();
+	render::MeshData* pMeshData = static_cast<render::MeshData*>(pResourceManager->createResource(resource::RESOURCE_TYPE_MESH_DATA, "meshes/Cube1m.xml"));
+	render::Material* pMaterial = static_cast<render::Material*>(pResourceManager->createResource(resource::RESOURCE_TYPE_RENDER_MATERIAL, "materials/ShaderDefault.xml"));
+	CHECK(pMeshData != nullptr);
+	CHECK(pMaterial != nullptr);
+
+	game::GameManager* pGameManager = game::GameManager::getInstance();
+
+	game::GameObject* pGameObject = pGameManager->createGameObject();
+	game::Transform* pTransform = static_cast<game::Transform*>(pGameManager->createComponent(game::COMPONENT_TYPE_TRANSFORM));
+	render::Camera* pCamera = static_cast<render::Camera*>(pGameManager->createComponent(game::COMPONENT_TYPE_CAMERA));
+	pGameObject->attachComponent(pTransform);
+	pGameObject->attachComponent(pCamera);
+	pTransform->setPosition(0, 0, 10 * ENGINE_UNIT_M);
+
+	pRenderManager->getMainWindow()->createViewport(pCamera);
+
+	const unsigned int MODEL_COUNT = 4;
+	for (unsigned int i = 0; i < MODEL_COUNT; ++i)
+	{
+		pGameObject = pGameManager->createGameObject();
+		pTransform = static_cast<game::Transform*>(pGameManager->createComponent(game::COMPONENT_TYPE_TRANSFORM));
+		render::Model* pModel = static_cast<render::Model*>(pGameManager->createComponent(game::COMPONENT_TYPE_MODEL));
+		pGameObject->attachComponent(pTransform);
+		pGameObject->attachComponent(pModel);
+		pTransform->setPosition((i * 2.0f - MODEL_COUNT) * ENGINE_UNIT_M, 0, 0);
+		pModel->setMeshData(pMeshData);
+		pModel->setMaterial(pMaterial);
+	}
+
+	pEngineManager->start();
+
+	CHECK(pMeshData->getState() == resource::RESOURCE_STATE_LOADED);
+
+	const unsigned int FRAME_COUNT = 10;
+	for (unsigned int i = 0; i < FRAME_COUNT; ++i)
+		pEngineManager->update(0);
+
+	// the counters hold the last frame, the models share their buffers and their program
+	const render::RenderStateCache& stateCache = pRenderDriver->getStateCache();
+	CHECK(stateCache.getIssuedCount() > 0);
+	CHECK(stateCache.getSkippedCount() > 0);
+
+	pEngineManager->stop();
+	pEngineManager->uninitialize();
+
+	SAFE_DELETE(pEngineManager);
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <Test.h>
+#include <render/LodSelector.h>
+#include <render/Camera.h>
+#include <render/IndexBuffer.h>
+#include <render/MeshData.h>
+#include <render/Model.h>
+
+namespace
+{
+
+//! Index buffer only giving the detail levels their triangle counts.
+class TestIndexBuffer: public render::IndexBuffer
+{
+public:
+
+	TestIndexBuffer(unsigned int numIndexes): render::IndexBuffer(render::IT_16BIT, numIndexes, resource::BU_STATIC) {}
+
+	void readData(unsigned int offset, unsigned int length, void* pDest) {}
+	void writeData(unsigned int offset, unsigned int length, const void* pSource, bool discardWholeBuffer = false) {}
+
+protected:
+
+	void* lockImpl(unsigned int offset, unsigned int length, resource::BufferLocking options)
+	{
+		return nullptr;
+	}
+
+	void unlockImpl() {}
+};
+
+//! Camera with its projection built without a render pass.
+class TestCamera: public render::Camera
+{
+public:
+
+	TestCamera()
+	{
+		updateProjection();
+	}
+};
+
+//! Model with a unit bounding sphere, placed without a transform component.
+class TestModel: public render::Model
+{
+public:
+
+	TestModel(render::MeshData* meshData)
+	{
+		mMeshData = meshData;
+		mBoundingSphere.Radius = 1.0f;
+	}
+
+	~TestModel()
+	{
+		// the mesh data never had the model as receiver
+		mMeshData = nullptr;
+	}
+};
+
+} // end namespace
+
+TEST_CASE(LodSelectorKeepsLevelsPerCamera)
+{
+	TestIndexBuffer fullBuffer(3000);
+	TestIndexBuffer halfBuffer(1500);
+	TestIndexBuffer fifthBuffer(600);
+	TestIndexBuffer twentiethBuffer(150);
+
+	render::MeshData meshData("LodSelectorMesh", nullptr);
+	meshData.setBoundingSphereRadius(1.0f);
+	meshData.setIndexBuffer(&fullBuffer);
+	meshData.addLod(&halfBuffer, 0.01f);
+	meshData.addLod(&fifthBuffer, 0.1f);
+	meshData.addLod(&twentiethBuffer, 1.0f);
+
+	TestModel model(&meshData);
+	TestCamera nearCamera;
+	TestCamera farCamera;
+
+	render::LodSelector selector;
+
+	// The model is close to one camera and far from the other, every frame renders both views
+	unsigned int nearLod = 0;
+	unsigned int farLod = 0;
+	for (unsigned int frame = 0; frame < 20; ++frame)
+	{
+		selector.resetStats();
+
+		selector.beginView(&nearCamera, 600);
+		CHECK(selector.selectLod(&model, 5.0f));
+		nearLod = model.getLod();
+
+		selector.beginView(&farCamera, 600);
+		CHECK(selector.selectLod(&model, 200.0f));
+		farLod = model.getLod();
+
+		// Once both views have their level none of them switches again
+		if (frame > 0)
+			CHECK(selector.getStats().switchCount == 0);
+	}
+
+	CHECK(nearLod == 0);
+	CHECK(farLod > nearLod);
+
+	// A camera dropped starts over from the level the model was last drawn with
+	selector.removeView(&nearCamera);
+	selector.resetStats();
+	selector.beginView(&nearCamera, 600);
+	CHECK(selector.selectLod(&model, 5.0f));
+	CHECK(model.getLod() == 0);
+	CHECK(selector.getStats().switchCount == 1);
+
+	return true;
+}
\ No newline at end of file
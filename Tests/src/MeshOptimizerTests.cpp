@@ -0,0 +1,357 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <Test.h>
+#include <render/MeshOptimizer.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+//! Vertex streams and triangles of a test mesh, laid out like the streams of the MeshSerializer.
+struct TestMesh
+{
+	std::vector<float> positions;
+	std::vector<float> normals;
+	std::vector<float> texcoords;
+	std::vector<unsigned int> indices;
+
+	unsigned int getVertexCount() const
+	{
+		return positions.size() / 3;
+	}
+
+	void addVertex(float x, float y, float z, float nx, float ny, float nz, float u, float v)
+	{
+		positions.push_back(x);
+		positions.push_back(y);
+		positions.push_back(z);
+		normals.push_back(nx);
+		normals.push_back(ny);
+		normals.push_back(nz);
+		texcoords.push_back(u);
+		texcoords.push_back(v);
+	}
+};
+
+static void createGrid(TestMesh& mesh, unsigned int size)
+{
+	for (unsigned int y = 0; y <= size; ++y)
+	{
+		for (unsigned int x = 0; x <= size; ++x)
+			mesh.addVertex((float)x, 0.0f, (float)y, 0.0f, 1.0f, 0.0f, (float)x / size, (float)y / size);
+	}
+
+	for (unsigned int y = 0; y < size; ++y)
+	{
+		for (unsigned int x = 0; x < size; ++x)
+		{
+			unsigned int i = y * (size + 1) + x;
+			unsigned int triangles[6] = {i, i + size + 1, i + 1, i + 1, i + size + 1, i + size + 2};
+			mesh.indices.insert(mesh.indices.end(), triangles, triangles + 6);
+		}
+	}
+}
+
+static void createSphere(TestMesh& mesh, unsigned int rings)
+{
+	const float PI = 3.14159265f;
+
+	for (unsigned int ring = 0; ring <= rings; ++ring)
+	{
+		for (unsigned int segment = 0; segment <= rings; ++segment)
+		{
+			float theta = PI * ring / rings;
+			float phi = 2.0f * PI * segment / rings;
+			float x = sinf(theta) * cosf(phi);
+			float y = cosf(theta);
+			float z = sinf(theta) * sinf(phi);
+			mesh.addVertex(x, y, z, x, y, z, (float)segment / rings, (float)ring / rings);
+		}
+	}
+
+	for (unsigned int ring = 0; ring < rings; ++ring)
+	{
+		for (unsigned int segment = 0; segment < rings; ++segment)
+		{
+			unsigned int i = ring * (rings + 1) + segment;
+			unsigned int triangles[6] = {i, i + 1, i + rings + 1, i + 1, i + rings + 2, i + rings + 1};
+			mesh.indices.insert(mesh.indices.end(), triangles, triangles + 6);
+		}
+	}
+}
+
+//! Gives every corner its own vertex, like the exporters that write one vertex per face corner.
+static void unweld(TestMesh& mesh)
+{
+	TestMesh unwelded;
+	for (unsigned int i = 0; i < mesh.indices.size(); ++i)
+	{
+		unsigned int v = mesh.indices[i];
+		unwelded.addVertex(mesh.positions[v * 3], mesh.positions[v * 3 + 1], mesh.positions[v * 3 + 2],
+			mesh.normals[v * 3], mesh.normals[v * 3 + 1], mesh.normals[v * 3 + 2],
+			mesh.texcoords[v * 2], mesh.texcoords[v * 2 + 1]);
+		unwelded.indices.push_back(i);
+	}
+
+	mesh = unwelded;
+}
+
+static void shuffleTriangles(TestMesh& mesh, unsigned int seed)
+{
+	srand(seed);
+
+	unsigned int triangleCount = mesh.indices.size() / 3;
+	for (unsigned int i = triangleCount - 1; i > 0; --i)
+	{
+		unsigned int j = rand() % (i + 1);
+		for (unsigned int k = 0; k < 3; ++k)
+			std::swap(mesh.indices[i * 3 + k], mesh.indices[j * 3 + k]);
+	}
+}
+
+static float readAttribute(const char* line, const char* name)
+{
+	std::string pattern = std::string(" ") + name + "=\"";
+	const char* value = strstr(line, pattern.c_str());
+	return (value != nullptr) ? (float)atof(value + pattern.size()) : 0.0f;
+}
+
+//! Reads the vertices and indices of an xml mesh of the media, one element per line like the exporter writes them.
+static bool loadMesh(const std::string& filePath, TestMesh& mesh)
+{
+	FILE* pFile = fopen(filePath.c_str(), "r");
+	if (pFile == nullptr)
+		return false;
+
+	char line[1024];
+	while (fgets(line, sizeof(line), pFile) != nullptr)
+	{
+		if (strstr(line, "<position") != nullptr)
+		{
+			mesh.positions.push_back(readAttribute(line, "x"));
+			mesh.positions.push_back(readAttribute(line, "y"));
+			mesh.positions.push_back(readAttribute(line, "z"));
+		}
+		else if (strstr(line, "<normal") != nullptr)
+		{
+			mesh.normals.push_back(readAttribute(line, "x"));
+			mesh.normals.push_back(readAttribute(line, "y"));
+			mesh.normals.push_back(readAttribute(line, "z"));
+		}
+		else if (strstr(line, "<texcoord") != nullptr)
+		{
+			mesh.texcoords.push_back(readAttribute(line, "u"));
+			mesh.texcoords.push_back(readAttribute(line, "v"));
+		}
+		else
+		{
+			const char* index = line;
+			while ((index = strstr(index, "<index value=\"")) != nullptr)
+			{
+				index += strlen("<index value=\"");
+				mesh.indices.push_back((unsigned int)atoi(index));
+			}
+		}
+	}
+
+	fclose(pFile);
+
+	unsigned int vertexCount = mesh.getVertexCount();
+	return vertexCount > 0 && mesh.normals.size() == vertexCount * 3 && mesh.texcoords.size() == vertexCount * 2 && !mesh.indices.empty();
+}
+
+typedef std::vector<float> TriangleKey;
+
+//! Sorted list of the triangles by the values of their corners, starting from the smallest corner so the winding is kept.
+static std::vector<TriangleKey> getTriangles(const TestMesh& mesh)
+{
+	std::vector<TriangleKey> triangles;
+	for (unsigned int i = 0; i + 2 < mesh.indices.size(); i += 3)
+	{
+		TriangleKey corners[3];
+		for (unsigned int k = 0; k < 3; ++k)
+		{
+			unsigned int v = mesh.indices[i + k];
+			corners[k].insert(corners[k].end(), &mesh.positions[v * 3], &mesh.positions[v * 3] + 3);
+			corners[k].insert(corners[k].end(), &mesh.normals[v * 3], &mesh.normals[v * 3] + 3);
+			corners[k].insert(corners[k].end(), &mesh.texcoords[v * 2], &mesh.texcoords[v * 2] + 2);
+		}
+
+		unsigned int first = 0;
+		for (unsigned int k = 1; k < 3; ++k)
+		{
+			if (corners[k] < corners[first])
+				first = k;
+		}
+
+		TriangleKey triangle;
+		for (unsigned int k = 0; k < 3; ++k)
+			triangle.insert(triangle.end(), corners[(first + k) % 3].begin(), corners[(first + k) % 3].end());
+
+		triangles.push_back(triangle);
+	}
+
+	std::sort(triangles.begin(), triangles.end());
+
+	return triangles;
+}
+
+//! Optimizes a mesh and checks it draws the same triangles with no more vertex transforms than before.
+//! \param improves: The input order leaves room, the cache miss ratio has to go down.
+static bool checkOptimizedMesh(const std::string& name, TestMesh& mesh, bool improves)
+{
+	std::vector<TriangleKey> trianglesBefore = getTriangles(mesh);
+	render::VertexCacheStats before = render::MeshOptimizer::analyzeVertexCache(&mesh.indices[0], mesh.indices.size(), mesh.getVertexCount());
+
+	render::MeshOptimizer optimizer;
+	optimizer.addStream(mesh.positions, 3);
+	optimizer.addStream(mesh.normals, 3);
+	optimizer.addStream(mesh.texcoords, 2);
+	unsigned int vertexCount = optimizer.optimize(mesh.indices, mesh.getVertexCount());
+
+	render::VertexCacheStats after = render::MeshOptimizer::analyzeVertexCache(&mesh.indices[0], mesh.indices.size(), vertexCount);
+
+	CHECK(vertexCount == mesh.getVertexCount());
+	CHECK(mesh.normals.size() == vertexCount * 3 && mesh.texcoords.size() == vertexCount * 2);
+	CHECK(getTriangles(mesh) == trianglesBefore);
+
+	// the welding removes vertices and not transforms, the ratios are compared over the vertices left
+	float atvrBefore = (float)before.transformCount / after.vertexCount;
+
+	std::cout<<name<<": ACMR "<<before.acmr<<" -> "<<after.acmr<<", ATVR "<<atvrBefore<<" -> "<<after.atvr
+		<<", vertices "<<before.vertexCount<<" -> "<<after.vertexCount<<std::endl;
+
+	CHECK(after.transformCount <= before.transformCount);
+	CHECK(after.acmr <= before.acmr);
+	CHECK(after.atvr <= atvrBefore);
+	if (improves)
+	{
+		CHECK(after.acmr < before.acmr);
+		CHECK(after.atvr < atvrBefore);
+	}
+
+	// the vertices are stored in the order the triangles first use them
+	unsigned int nextVertex = 0;
+	for (unsigned int i = 0; i < mesh.indices.size(); ++i)
+	{
+		CHECK(mesh.indices[i] <= nextVertex);
+		if (mesh.indices[i] == nextVertex)
+			++nextVertex;
+	}
+	CHECK(nextVertex == vertexCount);
+
+	return true;
+}
+
+//! The simulated cache is a FIFO, a hit does not move the vertex to the front.
+TEST_CASE(MeshOptimizerCacheSimulator)
+{
+	unsigned int separate[] = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+	render::VertexCacheStats stats = render::MeshOptimizer::analyzeVertexCache(separate, 9, 9);
+	CHECK(stats.transformCount == 9);
+	CHECK(fabsf(stats.acmr - 3.0f) < 1e-6f);
+	CHECK(fabsf(stats.atvr - 1.0f) < 1e-6f);
+
+	unsigned int shared[] = {0, 1, 2, 0, 2, 1, 2, 1, 0, 1, 0, 2};
+	stats = render::MeshOptimizer::analyzeVertexCache(shared, 12, 3);
+	CHECK(stats.transformCount == 3);
+	CHECK(fabsf(stats.acmr - 0.75f) < 1e-6f);
+
+	// 18 misses push 0 out of a 16 entries cache, 5 is still in
+	std::vector<unsigned int> evicted;
+	for (unsigned int i = 0; i < 18; ++i)
+		evicted.push_back(i);
+	evicted.push_back(5);
+	evicted.push_back(0);
+	evicted.push_back(17);
+	stats = render::MeshOptimizer::analyzeVertexCache(&evicted[0], evicted.size(), 18, 16);
+	CHECK(stats.transformCount == 19);
+
+	// the hit on 0 does not refresh it, 16 pushes it out
+	std::vector<unsigned int> fifo;
+	for (unsigned int i = 0; i < 16; ++i)
+		fifo.push_back(i);
+	fifo.push_back(0);
+	fifo.push_back(16);
+	fifo.push_back(0);
+	fifo.push_back(1);
+	fifo.push_back(2);
+	stats = render::MeshOptimizer::analyzeVertexCache(&fifo[0], fifo.size(), 17, 16);
+	CHECK(stats.transformCount == 20);
+
+	return true;
+}
+
+TEST_CASE(MeshOptimizerGeneratedMeshes)
+{
+	TestMesh grid;
+	createGrid(grid, 100);
+	CHECK(checkOptimizedMesh("grid", grid, true));
+
+	TestMesh shuffledGrid;
+	createGrid(shuffledGrid, 100);
+	shuffleTriangles(shuffledGrid, 1);
+	CHECK(checkOptimizedMesh("shuffled grid", shuffledGrid, true));
+
+	TestMesh unweldedGrid;
+	createGrid(unweldedGrid, 100);
+	unweld(unweldedGrid);
+	shuffleTriangles(unweldedGrid, 2);
+	CHECK(checkOptimizedMesh("unwelded shuffled grid", unweldedGrid, true));
+
+	TestMesh sphere;
+	createSphere(sphere, 64);
+	CHECK(checkOptimizedMesh("sphere", sphere, true));
+
+	TestMesh shuffledSphere;
+	createSphere(shuffledSphere, 200);
+	shuffleTriangles(shuffledSphere, 3);
+	CHECK(checkOptimizedMesh("shuffled sphere", shuffledSphere, true));
+
+	return true;
+}
+
+//! The media meshes are small and mostly flat shaded, they only must not get worse.
+TEST_CASE(MeshOptimizerMediaMeshes)
+{
+	const char* MESHES[] = {"Cube1m.xml", "Plane1m.xml", "Plane10m.xml", "Plane100m.xml", "Sphere1m.xml"};
+	const unsigned int MESH_COUNT = sizeof(MESHES) / sizeof(MESHES[0]);
+
+	for (unsigned int i = 0; i < MESH_COUNT; ++i)
+	{
+		TestMesh mesh;
+		CHECK(loadMesh(test::getMediaPath() + "/meshes/" + MESHES[i], mesh));
+		CHECK(checkOptimizedMesh(MESHES[i], mesh, false));
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,302 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <Test.h>
+#include <Engine.h>
+#include <resource/MeshSerializer.h>
+#include <resource/MeshFileDefines.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+//! Writes a smooth height field grid as an xml mesh, the media meshes are too small or have hard normals everywhere.
+static bool writeGridMesh(const std::string& filePath, unsigned int size)
+{
+	FILE* pFile = fopen(filePath.c_str(), "w");
+	if (pFile == nullptr)
+		return false;
+
+	fprintf(pFile, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<mesh>\n");
+	fprintf(pFile, "\t<vertexbuffer count=\"%u\">\n", (size + 1) * (size + 1));
+	for (unsigned int y = 0; y <= size; ++y)
+	{
+		for (unsigned int x = 0; x <= size; ++x)
+		{
+			float u = (float)x / size;
+			float v = (float)y / size;
+			float height = 0.1f * sinf(u * 6.0f) * cosf(v * 4.0f);
+
+			fprintf(pFile, "\t\t<vertex>\n");
+			fprintf(pFile, "\t\t\t<position x=\"%f\" y=\"%f\" z=\"%f\"/>\n", u, height, v);
+			fprintf(pFile, "\t\t\t<normal x=\"0.0\" y=\"1.0\" z=\"0.0\"/>\n");
+			fprintf(pFile, "\t\t\t<texcoord u=\"%f\" v=\"%f\"/>\n", u, v);
+			fprintf(pFile, "\t\t</vertex>\n");
+		}
+	}
+	fprintf(pFile, "\t</vertexbuffer>\n");
+
+	fprintf(pFile, "\t<indexbuffer count=\"%u\">\n", size * size * 6);
+	for (unsigned int y = 0; y < size; ++y)
+	{
+		for (unsigned int x = 0; x < size; ++x)
+		{
+			unsigned int i = y * (size + 1) + x;
+			fprintf(pFile, "\t\t<index value=\"%u\"/><index value=\"%u\"/><index value=\"%u\"/>\n", i, i + size + 1, i + 1);
+			fprintf(pFile, "\t\t<index value=\"%u\"/><index value=\"%u\"/><index value=\"%u\"/>\n", i + 1, i + size + 1, i + size + 2);
+		}
+	}
+	fprintf(pFile, "\t</indexbuffer>\n</mesh>");
+
+	fclose(pFile);
+
+	return true;
+}
+
+static bool readFile(const std::string& filePath, std::vector<unsigned char>& bytes)
+{
+	FILE* pFile = fopen(filePath.c_str(), "rb");
+	if (pFile == nullptr)
+		return false;
+
+	fseek(pFile, 0, SEEK_END);
+	bytes.resize(ftell(pFile));
+	fseek(pFile, 0, SEEK_SET);
+	bool result = fread(&bytes[0], 1, bytes.size(), pFile) == bytes.size();
+	fclose(pFile);
+
+	return result;
+}
+
+static bool writeFile(const std::string& filePath, const std::vector<unsigned char>& bytes)
+{
+	FILE* pFile = fopen(filePath.c_str(), "wb");
+	if (pFile == nullptr)
+		return false;
+
+	bool result = fwrite(&bytes[0], 1, bytes.size(), pFile) == bytes.size();
+	fclose(pFile);
+
+	return result;
+}
+
+//! Creates the engine on the null drivers with the resources read from the work path.
+static engine::EngineManager* createEngine()
+{
+	engine::EngineManager* pEngineManager = new engine::EngineManager();
+
+	engine::EngineSettings* pSettings = engine::EngineSettings::getInstance();
+	std::string workPath = pSettings->getWorkPath();
+
+	pSettings->setDataPath(workPath);
+	pSettings->setWidth(320);
+	pSettings->setHeight(240);
+
+	// the options saved by the previous test would override the settings above
+	remove((workPath + "/EngineTests.xml").c_str());
+	pEngineManager->setOptionsFile(workPath + "/EngineTests.xml");
+	engine::PluginManager::getInstance()->setPluginsFile(workPath + "/PluginsHeadless.xml");
+
+	pEngineManager->initialize();
+
+	return pEngineManager;
+}
+
+//! The converted binary mesh carries the levels of detail simplified from the xml one.
+TEST_CASE(MeshSerializerStoresLods)
+{
+	engine::EngineManager* pEngineManager = createEngine();
+	std::string workPath = engine::EngineSettings::getInstance()->getWorkPath();
+
+	// the generated files are written next to the executable, not into the media
+	CHECK(writeGridMesh(workPath + "/Grid.xml", 32));
+
+	resource::MeshSerializer serializer;
+	CHECK(serializer.convertMesh(workPath + "/Grid.xml", workPath + "/Grid" + resource::MESH_FILE_EXTENSION));
+
+	FILE* pFile = fopen((workPath + "/Grid" + resource::MESH_FILE_EXTENSION).c_str(), "rb");
+	CHECK(pFile != nullptr);
+	resource::MeshFileHeader header;
+	size_t read = fread(&header, sizeof(resource::MeshFileHeader), 1, pFile);
+	fclose(pFile);
+	CHECK(read == 1);
+	CHECK(header.version == resource::MESH_FILE_VERSION);
+	CHECK(header.numLods > 0);
+	CHECK(header.indexSize == sizeof(unsigned short));
+
+	resource::ResourceManager* pResourceManager = resource::ResourceManager::getInstance();
+	render::MeshData* pXmlMesh = static_cast<render::MeshData*>(pResourceManager->createResource(resource::RESOURCE_TYPE_MESH_DATA, "Grid.xml"));
+	render::MeshData* pBinaryMesh = static_cast<render::MeshData*>(pResourceManager->createResource(resource::RESOURCE_TYPE_MESH_DATA, std::string("Grid") + resource::MESH_FILE_EXTENSION));
+	CHECK(pXmlMesh != nullptr);
+	CHECK(pBinaryMesh != nullptr);
+
+	pEngineManager->start();
+
+	CHECK(pXmlMesh->getState() == resource::RESOURCE_STATE_LOADED);
+	CHECK(pBinaryMesh->getState() == resource::RESOURCE_STATE_LOADED);
+
+	CHECK(pBinaryMesh->getLodCount() == header.numLods + 1);
+	CHECK(pBinaryMesh->getLodCount() == pXmlMesh->getLodCount());
+	for (unsigned int i = 0; i < pXmlMesh->getLodCount(); ++i)
+	{
+		CHECK(pBinaryMesh->getLodError(i) == pXmlMesh->getLodError(i));
+		CHECK(pBinaryMesh->getIndexBuffer(i)->getNumIndexes() == pXmlMesh->getIndexBuffer(i)->getNumIndexes());
+	}
+
+	pEngineManager->stop();
+	pEngineManager->uninitialize();
+
+	SAFE_DELETE(pEngineManager);
+
+	remove((workPath + "/Grid.xml").c_str());
+	remove((workPath + "/Grid" + resource::MESH_FILE_EXTENSION).c_str());
+
+	return true;
+}
+
+//! Files whose sizes wrap around in 32 bits or whose indices address missing vertices are not loaded.
+TEST_CASE(MeshSerializerRejectsInvalidFiles)
+{
+	engine::EngineManager* pEngineManager = createEngine();
+	std::string workPath = engine::EngineSettings::getInstance()->getWorkPath();
+
+	CHECK(writeGridMesh(workPath + "/Grid.xml", 32));
+
+	resource::MeshSerializer serializer;
+	CHECK(serializer.convertMesh(workPath + "/Grid.xml", workPath + "/Grid" + resource::MESH_FILE_EXTENSION));
+
+	std::vector<unsigned char> bytes;
+	CHECK(readFile(workPath + "/Grid" + resource::MESH_FILE_EXTENSION, bytes));
+
+	resource::MeshFileHeader header;
+	memcpy(&header, &bytes[0], sizeof(resource::MeshFileHeader));
+	CHECK(header.numLods > 0);
+	CHECK(header.indexSize == sizeof(unsigned short));
+
+	std::vector<std::vector<unsigned char> > files;
+
+	// 0x40000001 vertices of 3 floats are 12 bytes once wrapped around in 32 bits
+	std::vector<unsigned char> wrapped = bytes;
+	resource::MeshFileHeader wrappedHeader = header;
+	wrappedHeader.numVertices = 0x40000001;
+	wrappedHeader.numIndexes = 0;
+	wrappedHeader.indexSize = sizeof(unsigned int);
+	wrappedHeader.numLods = 0;
+	for (unsigned int i = 0; i < wrappedHeader.numStreams; ++i)
+		wrappedHeader.streams[i].size = (unsigned int)(wrappedHeader.numVertices * (wrappedHeader.streams[i].size / header.numVertices));
+	memcpy(&wrapped[0], &wrappedHeader, sizeof(resource::MeshFileHeader));
+	files.push_back(wrapped);
+
+	std::vector<unsigned char> badIndex = bytes;
+	unsigned short index = (unsigned short)header.numVertices;
+	memcpy(&badIndex[header.indexOffset], &index, sizeof(index));
+	files.push_back(badIndex);
+
+	std::vector<unsigned char> badLodIndex = bytes;
+	memcpy(&badLodIndex[header.lods[header.numLods - 1].offset], &index, sizeof(index));
+	files.push_back(badLodIndex);
+
+	pEngineManager->start();
+
+	resource::ResourceManager* pResourceManager = resource::ResourceManager::getInstance();
+
+	render::MeshData* pMesh = static_cast<render::MeshData*>(pResourceManager->createResource(resource::RESOURCE_TYPE_MESH_DATA, std::string("Grid") + resource::MESH_FILE_EXTENSION));
+	CHECK(pResourceManager->loadResource(pMesh));
+
+	for (unsigned int i = 0; i < files.size(); ++i)
+	{
+		std::string filename = "Invalid" + core::intToString(i) + resource::MESH_FILE_EXTENSION;
+		CHECK(writeFile(workPath + "/" + filename, files[i]));
+
+		pMesh = static_cast<render::MeshData*>(pResourceManager->createResource(resource::RESOURCE_TYPE_MESH_DATA, filename));
+		CHECK(pMesh != nullptr);
+		CHECK(!pResourceManager->loadResource(pMesh));
+		CHECK(pMesh->getState() != resource::RESOURCE_STATE_LOADED);
+
+		remove((workPath + "/" + filename).c_str());
+	}
+
+	pEngineManager->stop();
+	pEngineManager->uninitialize();
+
+	SAFE_DELETE(pEngineManager);
+
+	remove((workPath + "/Grid.xml").c_str());
+	remove((workPath + "/Grid" + resource::MESH_FILE_EXTENSION).c_str());
+
+	return true;
+}
+
+//! Loads the same mesh from xml and from the converted binary file and reports the times.
+TEST_CASE(MeshSerializerLoadTime)
+{
+	engine::EngineManager* pEngineManager = createEngine();
+	std::string workPath = engine::EngineSettings::getInstance()->getWorkPath();
+
+	const unsigned int GRID_SIZE = 128;
+
+	CHECK(writeGridMesh(workPath + "/Grid.xml", GRID_SIZE));
+
+	resource::MeshSerializer serializer;
+	CHECK(serializer.convertMesh(workPath + "/Grid.xml", workPath + "/Grid" + resource::MESH_FILE_EXTENSION));
+
+	pEngineManager->start();
+
+	resource::ResourceManager* pResourceManager = resource::ResourceManager::getInstance();
+	render::MeshData* pXmlMesh = static_cast<render::MeshData*>(pResourceManager->createResource(resource::RESOURCE_TYPE_MESH_DATA, "Grid.xml"));
+	render::MeshData* pBinaryMesh = static_cast<render::MeshData*>(pResourceManager->createResource(resource::RESOURCE_TYPE_MESH_DATA, std::string("Grid") + resource::MESH_FILE_EXTENSION));
+	CHECK(pXmlMesh != nullptr);
+	CHECK(pBinaryMesh != nullptr);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	CHECK(pResourceManager->loadResource(pXmlMesh));
+	double xmlTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	CHECK(pResourceManager->loadResource(pBinaryMesh));
+	double binaryTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	CHECK(pBinaryMesh->getIndexBuffer()->getNumIndexes() == pXmlMesh->getIndexBuffer()->getNumIndexes());
+	CHECK(pBinaryMesh->getLodCount() == pXmlMesh->getLodCount());
+
+	std::cout<<"Mesh load time of a "<<GRID_SIZE * GRID_SIZE * 2<<" triangle grid: xml "<<xmlTime<<" ms, binary "<<binaryTime<<" ms, "<<xmlTime / binaryTime<<"x"<<std::endl;
+
+	CHECK(binaryTime < xmlTime);
+
+	pEngineManager->stop();
+	pEngineManager->uninitialize();
+
+	SAFE_DELETE(pEngineManager);
+
+	remove((workPath + "/Grid.xml").c_str());
+	remove((workPath + "/Grid" + resource::MESH_FILE_EXTENSION).c_str());
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <Test.h>
+#include <core/Profiler.h>
+
+#include <chrono>
+#include <iostream>
+
+//! Zones per frame and frame time of the profiler overhead budget, 1% of the frame.
+static const unsigned int PROFILER_BUDGET_ZONE_COUNT = 10000;
+static const double PROFILER_BUDGET_FRAME_MILLISECONDS = 16.6;
+static const double PROFILER_BUDGET_FRACTION = 0.01;
+
+static volatile unsigned int gProfilerTestCounter = 0;
+
+#if ENGINE_COMPILER == COMPILER_MSVC
+#	define PROFILER_TEST_NOINLINE __declspec(noinline)
+#else
+#	define PROFILER_TEST_NOINLINE __attribute__((noinline))
+#endif
+
+static PROFILER_TEST_NOINLINE void profiledWork()
+{
+	PROFILE_SCOPE("ProfilerTestZone");
+	gProfilerTestCounter = gProfilerTestCounter + 1;
+}
+
+static PROFILER_TEST_NOINLINE void unprofiledWork()
+{
+	gProfilerTestCounter = gProfilerTestCounter + 1;
+}
+
+//! Measures the cost of a zone with a frame of 10000 of them and checks it against the budget.
+//! A zone reads the counter twice, which costs a few nanoseconds on hardware but 20 ns or more in a virtual machine,
+//! so the budget is checked for the work of the profiler and the measured cost of the two reads is added to it.
+TEST_CASE(ProfilerZoneOverhead)
+{
+	core::Profiler* pProfiler = new core::Profiler();
+
+	const unsigned int FRAME_COUNT = 100;
+
+	double bestProfiled = 0.0;
+	double bestUnprofiled = 0.0;
+	double bestTicks = 0.0;
+
+	for (unsigned int frame = 0; frame < FRAME_COUNT; ++frame)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < PROFILER_BUDGET_ZONE_COUNT; ++i)
+			profiledWork();
+		double profiled = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+		pProfiler->endFrame();
+
+		start = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < PROFILER_BUDGET_ZONE_COUNT; ++i)
+			unprofiledWork();
+		double unprofiled = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+		unsigned long long tickSum = 0;
+		start = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < PROFILER_BUDGET_ZONE_COUNT; ++i)
+			tickSum += core::Profiler::getTicks();
+		double ticks = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+		gProfilerTestCounter = gProfilerTestCounter + (unsigned int)tickSum;
+
+		if (frame == 0 || profiled < bestProfiled) bestProfiled = profiled;
+		if (frame == 0 || unprofiled < bestUnprofiled) bestUnprofiled = unprofiled;
+		if (frame == 0 || ticks < bestTicks) bestTicks = ticks;
+	}
+
+	core::ProfileZoneStats stats;
+	CHECK(pProfiler->getZoneStats("ProfilerTestZone", stats));
+	CHECK(stats.calls == PROFILER_BUDGET_ZONE_COUNT);
+	CHECK(pProfiler->getDroppedZoneCount() == 0);
+
+	double frameNanoseconds = PROFILER_BUDGET_FRAME_MILLISECONDS * 1000000.0;
+	double zoneNanoseconds = (bestProfiled - bestUnprofiled) / PROFILER_BUDGET_ZONE_COUNT;
+	double tickNanoseconds = bestTicks / PROFILER_BUDGET_ZONE_COUNT;
+	double frameFraction = zoneNanoseconds * PROFILER_BUDGET_ZONE_COUNT / frameNanoseconds;
+	double counterFraction = 2.0 * tickNanoseconds * PROFILER_BUDGET_ZONE_COUNT / frameNanoseconds;
+
+	std::cout<<"Profiler zone overhead: "<<zoneNanoseconds<<" ns, "<<frameFraction * 100.0<<"% of a "<<PROFILER_BUDGET_FRAME_MILLISECONDS<<" ms frame with "
+		<<PROFILER_BUDGET_ZONE_COUNT<<" zones, "<<counterFraction * 100.0<<"% of it reading the counter at "<<tickNanoseconds<<" ns"<<std::endl;
+
+	CHECK(frameFraction <= PROFILER_BUDGET_FRACTION + counterFraction);
+
+	SAFE_DELETE(pProfiler);
+
+	return true;
+}
\ No newline at end of file
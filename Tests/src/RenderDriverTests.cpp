@@ -0,0 +1,232 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <Test.h>
+#include <core/Matrix4.h>
+#include <render/RenderDriver.h>
+#include <render/RenderQueue.h>
+#include <render/Material.h>
+#include <render/MeshData.h>
+#include <render/Model.h>
+#include <render/ShaderParameter.h>
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+
+//! Material reading the world matrix from its object block, instanced when it declares the instance matrix too.
+class TestMaterial: public render::Material
+{
+public:
+
+	TestMaterial(bool instanced): render::Material("TestMaterial", nullptr)
+	{
+		addAutoParameter("worldMatrix", render::SHADER_AUTO_PARAMETER_TYPE_WORLD_MATRIX);
+		if (instanced)
+			addAutoParameter("instanceWorldMatrix", render::SHADER_AUTO_PARAMETER_TYPE_INSTANCE_WORLD_MATRIX);
+
+		setParameterBlocks(true);
+	}
+
+protected:
+
+	render::ShaderParameter* createParameterImpl()
+	{
+		return new render::ShaderParameter();
+	}
+};
+
+//! Model placed without a transform component.
+class TestModel: public render::Model
+{
+public:
+
+	TestModel(render::MeshData* meshData, const core::matrix4& worldMatrix)
+	{
+		mMeshData = meshData;
+		mWorldMatrix = worldMatrix;
+	}
+
+	~TestModel()
+	{
+		// the mesh data never had the model as receiver
+		mMeshData = nullptr;
+	}
+};
+
+struct RecordedDraw
+{
+	render::Model* model;
+	float objectBlock[16];
+};
+
+//! Records the model of every draw and the object block it reads, it keeps the default renderInstances.
+class RecordingRenderDriver: public render::RenderDriver
+{
+public:
+
+	RecordingRenderDriver(): render::RenderDriver("RecordingRenderDriver") {}
+
+	render::RenderWindow* createRenderWindow(int width, int height, int colorDepth, bool fullScreen, int left, int top, bool depthBuffer, void* windowId)
+	{
+		return nullptr;
+	}
+
+	render::VertexBuffer* createVertexBuffer(render::VertexBufferType vertexBufferType, render::VertexElementType vertexElementType, unsigned int numVertices, resource::BufferUsage usage)
+	{
+		return nullptr;
+	}
+
+	void removeVertexBuffer(render::VertexBuffer* buf) {}
+
+	render::IndexBuffer* createIndexBuffer(render::IndexType idxType, unsigned int numIndexes, resource::BufferUsage usage)
+	{
+		return nullptr;
+	}
+
+	void removeIndexBuffer(render::IndexBuffer* buf) {}
+
+	void beginFrame(render::Viewport* vp)
+	{
+		mUniformBuffer.beginFrame();
+	}
+
+	void render(render::RenderStateData& renderStateData)
+	{
+		RecordedDraw draw;
+		draw.model = renderStateData.getCurrentModel();
+		memset(draw.objectBlock, 0, sizeof(draw.objectBlock));
+
+		unsigned int offset = mParameterBlockOffsets[render::SHADER_PARAMETER_FREQUENCY_OBJECT];
+		if (offset != render::UNIFORM_RING_BUFFER_INVALID_OFFSET)
+			memcpy(draw.objectBlock, mUniformBuffer.getData() + offset, sizeof(draw.objectBlock));
+
+		mDraws.push_back(draw);
+	}
+
+	void endFrame() {}
+
+	void setViewport(render::Viewport* vp) {}
+
+	std::vector<RecordedDraw> mDraws;
+};
+
+//! The world matrix as std140 keeps it in the object block, four columns.
+bool isObjectBlockOf(const float* block, const core::matrix4& worldMatrix)
+{
+	const float* m = worldMatrix.get();
+	for (unsigned int column = 0; column < 4; ++column)
+	{
+		for (unsigned int row = 0; row < 4; ++row)
+		{
+			if (block[column * 4 + row] != m[row * 4 + column])
+				return false;
+		}
+	}
+
+	return true;
+}
+
+} // end namespace
+
+//! The default renderInstances draws every instance of a batch with its own object block.
+TEST_CASE(RenderDriverFallbackInstancesKeepTheirParameters)
+{
+	const unsigned int MESH_COUNT = 2;
+	const unsigned int MODEL_COUNT = 7;
+
+	render::MeshData* pMeshData[MESH_COUNT] = {new render::MeshData("MeshA", nullptr), new render::MeshData("MeshB", nullptr)};
+	TestMaterial* pInstancedMaterial = new TestMaterial(true);
+	TestMaterial* pMaterial = new TestMaterial(false);
+	CHECK(pInstancedMaterial->isInstanced());
+	CHECK(!pMaterial->isInstanced());
+
+	std::vector<TestModel*> models;
+	render::RenderQueue renderQueue;
+	for (unsigned int i = 0; i < MODEL_COUNT; ++i)
+	{
+		core::matrix4 worldMatrix = core::matrix4::IDENTITY;
+		worldMatrix.setTranslation(core::vector3d(i * 1.0f, i * 2.0f, i * -3.0f));
+
+		// the first models share a mesh, the next ones the other, the last one is not instanced
+		TestModel* pModel = new TestModel(pMeshData[(i < 4) ? 0 : 1], worldMatrix);
+		models.push_back(pModel);
+
+		renderQueue.addCommand(i, pModel, (i < MODEL_COUNT - 1) ? pInstancedMaterial : pMaterial);
+	}
+
+	renderQueue.sort();
+	renderQueue.buildBatches();
+	CHECK(renderQueue.getBatchCount() == 3);
+
+	RecordingRenderDriver renderDriver;
+	render::RenderStateData renderStateData;
+
+	for (unsigned int frame = 0; frame < 2; ++frame)
+	{
+		renderDriver.beginFrame(nullptr);
+		renderDriver.mDraws.clear();
+
+		renderDriver.renderCommands(renderStateData, renderQueue);
+
+		renderDriver.endFrame();
+
+		// one draw per command, each reads the world matrix of its own model
+		CHECK(renderDriver.mDraws.size() == MODEL_COUNT);
+		for (unsigned int i = 0; i < renderDriver.mDraws.size(); ++i)
+		{
+			const RecordedDraw& draw = renderDriver.mDraws[i];
+			CHECK(draw.model == renderQueue.getCommands()[i].model);
+			CHECK(isObjectBlockOf(draw.objectBlock, draw.model->getWorldMatrix()));
+		}
+
+		// the instance data keeps the matrices of the batches too
+		const render::RenderBatch* pBatches = renderQueue.getBatches();
+		for (unsigned int i = 0; i < renderQueue.getBatchCount(); ++i)
+		{
+			if (!pBatches[i].instanced)
+				continue;
+
+			for (unsigned int j = 0; j < pBatches[i].commandCount; ++j)
+			{
+				const float* pInstanceData = renderQueue.getInstanceData() + pBatches[i].instanceDataOffset + j * render::RENDER_INSTANCE_DATA_SIZE;
+				CHECK(isObjectBlockOf(pInstanceData, renderQueue.getCommands()[pBatches[i].firstCommand + j].model->getWorldMatrix()));
+			}
+		}
+	}
+
+	for (unsigned int i = 0; i < models.size(); ++i)
+		delete models[i];
+
+	delete pMaterial;
+	delete pInstancedMaterial;
+	delete pMeshData[0];
+	delete pMeshData[1];
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,214 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <Test.h>
+#include <render/RenderQueue.h>
+
+#include <stdlib.h>
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+const unsigned int MESH_LOD_LEVELS = 5;
+
+float getRandom(float minValue, float maxValue)
+{
+	return minValue + (maxValue - minValue) * (rand() / (float)RAND_MAX);
+}
+
+//! Fields of a sort key, see RenderQueue.
+struct SortKeyFields
+{
+	bool transparent;
+	unsigned int program;
+	unsigned int material;
+	unsigned int mesh;
+	unsigned int depth;
+};
+
+SortKeyFields getSortKeyFields(unsigned long long key)
+{
+	SortKeyFields fields;
+	fields.transparent = ((key >> 59) & 1) != 0;
+
+	if (fields.transparent)
+	{
+		fields.depth = (unsigned int)((key >> 43) & 0xFFFF);
+		fields.program = (unsigned int)((key >> 32) & 0x7FF);
+		fields.material = (unsigned int)((key >> 16) & 0xFFFF);
+		fields.mesh = (unsigned int)(key & 0xFFFF);
+	}
+	else
+	{
+		fields.program = (unsigned int)((key >> 48) & 0x7FF);
+		fields.material = (unsigned int)((key >> 32) & 0xFFFF);
+		fields.mesh = (unsigned int)((key >> 16) & 0xFFFF);
+		fields.depth = (unsigned int)(key & 0xFFFF);
+	}
+
+	return fields;
+}
+
+//! Fills the queue with draws of random states, the ids are past the bits the key holds for them.
+void fillQueue(render::RenderQueue& renderQueue, unsigned int count, unsigned int programCount, unsigned int materialCount, unsigned int meshCount, unsigned int transparentPercent)
+{
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		unsigned long long programID = 3000 + rand() % programCount;
+		unsigned long long materialID = 70000 + rand() % materialCount;
+		unsigned long long meshID = (9000 + rand() % meshCount) * MESH_LOD_LEVELS + rand() % MESH_LOD_LEVELS;
+		bool transparent = (unsigned int)(rand() % 100) < transparentPercent;
+
+		unsigned int programIndex = renderQueue.getStateIndex(render::RENDER_QUEUE_STATE_PROGRAM, programID);
+		unsigned int materialIndex = renderQueue.getStateIndex(render::RENDER_QUEUE_STATE_MATERIAL, materialID);
+		unsigned int meshIndex = renderQueue.getStateIndex(render::RENDER_QUEUE_STATE_MESH, meshID);
+
+		renderQueue.addCommand(render::RenderQueue::buildSortKey(0, transparent, programIndex, materialIndex, meshIndex, getRandom(0.0f, 1.0f)), nullptr, nullptr);
+	}
+}
+
+} // end namespace
+
+//! The state ids get dense indices per view, the same id always the same one, and they start over with clear.
+TEST_CASE(RenderQueueRemapsStateIds)
+{
+	render::RenderQueue renderQueue;
+
+	// ids that took the same key fields when they were masked to 16 bits
+	CHECK(renderQueue.getStateIndex(render::RENDER_QUEUE_STATE_MATERIAL, 5) == 0);
+	CHECK(renderQueue.getStateIndex(render::RENDER_QUEUE_STATE_MATERIAL, 5 + 65536) == 1);
+	CHECK(renderQueue.getStateIndex(render::RENDER_QUEUE_STATE_MATERIAL, 5) == 0);
+	CHECK(renderQueue.getStateIndex(render::RENDER_QUEUE_STATE_MATERIAL, 5 + 65536) == 1);
+
+	// a mesh past 8191 with its detail levels
+	CHECK(renderQueue.getStateIndex(render::RENDER_QUEUE_STATE_MESH, 8192 * MESH_LOD_LEVELS) == 0);
+	CHECK(renderQueue.getStateIndex(render::RENDER_QUEUE_STATE_MESH, 8192 * MESH_LOD_LEVELS + 1) == 1);
+	CHECK(renderQueue.getStateIndex(render::RENDER_QUEUE_STATE_MESH, 0) == 2);
+
+	// every kind of state has its own indices
+	CHECK(renderQueue.getStateIndex(render::RENDER_QUEUE_STATE_PROGRAM, 5 + 65536) == 0);
+
+	renderQueue.clear();
+	CHECK(renderQueue.getStateIndex(render::RENDER_QUEUE_STATE_MATERIAL, 5 + 65536) == 0);
+	CHECK(renderQueue.getStateIndex(render::RENDER_QUEUE_STATE_MESH, 0) == 0);
+
+	return true;
+}
+
+//! Sorted draws of states with large ids are grouped by program and material, front to back inside them,
+//! and the transparent ones come last, back to front.
+TEST_CASE(RenderQueueGroupsStatesWithLargeIds)
+{
+	srand(21);
+
+	render::RenderQueue renderQueue;
+	fillQueue(renderQueue, 20000, 12, 300, 2000, 10);
+
+	renderQueue.sort();
+
+	const render::RenderCommand* pCommands = renderQueue.getCommands();
+	unsigned int count = renderQueue.getCommandCount();
+	CHECK(count == 20000);
+
+	std::set<std::pair<unsigned int, unsigned int> > finishedStates;
+	SortKeyFields last = getSortKeyFields(pCommands[0].sortKey);
+	for (unsigned int i = 1; i < count; ++i)
+	{
+		SortKeyFields fields = getSortKeyFields(pCommands[i].sortKey);
+		CHECK(!last.transparent || fields.transparent);
+
+		if (fields.transparent)
+		{
+			// the key holds the inverted depth
+			if (last.transparent)
+				CHECK(fields.depth >= last.depth);
+		}
+		else if (fields.program == last.program && fields.material == last.material)
+		{
+			CHECK(fields.mesh >= last.mesh);
+			if (fields.mesh == last.mesh)
+				CHECK(fields.depth >= last.depth);
+		}
+		else
+		{
+			// a program and material run is never met again
+			CHECK(finishedStates.insert(std::make_pair(last.program, last.material)).second);
+			CHECK(finishedStates.find(std::make_pair(fields.program, fields.material)) == finishedStates.end());
+		}
+
+		last = fields;
+	}
+
+	return true;
+}
+
+//! Reports the time to fill, sort and batch a queue of 50000 draws.
+TEST_CASE(RenderQueueBuildAndSortBenchmark)
+{
+	const unsigned int COMMAND_COUNT = 50000;
+	const unsigned int RUN_COUNT = 10;
+
+	render::RenderQueue renderQueue;
+	renderQueue.reserve(COMMAND_COUNT);
+
+	double bestFill = 0.0;
+	double bestSort = 0.0;
+	double bestBatches = 0.0;
+	for (unsigned int run = 0; run < RUN_COUNT; ++run)
+	{
+		srand(22);
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		renderQueue.clear();
+		fillQueue(renderQueue, COMMAND_COUNT, 32, 500, 4000, 10);
+		std::chrono::steady_clock::time_point filled = std::chrono::steady_clock::now();
+		renderQueue.sort();
+		std::chrono::steady_clock::time_point sorted = std::chrono::steady_clock::now();
+		renderQueue.buildBatches();
+		std::chrono::steady_clock::time_point batched = std::chrono::steady_clock::now();
+
+		double fill = std::chrono::duration<double, std::micro>(filled - start).count();
+		double sort = std::chrono::duration<double, std::micro>(sorted - filled).count();
+		double batches = std::chrono::duration<double, std::micro>(batched - sorted).count();
+
+		if (run == 0 || fill < bestFill) bestFill = fill;
+		if (run == 0 || sort < bestSort) bestSort = sort;
+		if (run == 0 || batches < bestBatches) bestBatches = batches;
+
+		for (unsigned int i = 1; i < renderQueue.getCommandCount(); ++i)
+			CHECK(renderQueue.getCommands()[i - 1].sortKey <= renderQueue.getCommands()[i].sortKey);
+		CHECK(renderQueue.getBatchCount() == COMMAND_COUNT);
+	}
+
+	std::cout<<"Render queue of "<<COMMAND_COUNT<<" draws: fill "<<bestFill<<" us, radix sort "<<bestSort<<" us, batches "<<bestBatches<<" us"<<std::endl;
+
+	return true;
+}
\ No newline at end of file
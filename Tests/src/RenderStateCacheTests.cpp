@@ -0,0 +1,142 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <Test.h>
+#include <render/RenderStateCache.h>
+
+//! A state is issued the first time and when it changes, repeating it is skipped.
+TEST_CASE(RenderStateCacheSkipsRepeatedStates)
+{
+	render::RenderStateCache cache;
+
+	CHECK(cache.setProgram(1));
+	CHECK(!cache.setProgram(1));
+	CHECK(cache.setProgram(2));
+	CHECK(cache.getIssuedCount(render::RENDER_STATE_TYPE_PROGRAM) == 2);
+	CHECK(cache.getSkippedCount(render::RENDER_STATE_TYPE_PROGRAM) == 1);
+
+	CHECK(cache.setVertexBuffer(10));
+	CHECK(!cache.setVertexBuffer(10));
+	CHECK(cache.setIndexBuffer(11));
+	CHECK(!cache.setIndexBuffer(11));
+	CHECK(cache.getIssuedCount(render::RENDER_STATE_TYPE_BUFFER) == 2);
+	CHECK(cache.getSkippedCount(render::RENDER_STATE_TYPE_BUFFER) == 2);
+
+	CHECK(cache.setTexture(0, 1, 20));
+	CHECK(!cache.setTexture(0, 1, 20));
+	CHECK(cache.setTexture(1, 1, 20));
+
+	CHECK(cache.setVertexAttributeEnabled(0, true));
+	CHECK(!cache.setVertexAttributeEnabled(0, true));
+	CHECK(cache.setVertexAttributeFormat(0, 10, 3, 0x1406, 12));
+	CHECK(!cache.setVertexAttributeFormat(0, 10, 3, 0x1406, 12));
+	CHECK(cache.setVertexAttributeFormat(0, 10, 3, 0x1406, 12, 0, 1));
+
+	CHECK(cache.setUniformBlock(0, 30, 0, 256));
+	CHECK(!cache.setUniformBlock(0, 30, 0, 256));
+	CHECK(cache.setUniformBlock(0, 30, 256, 256));
+
+	CHECK(cache.setBlendEnabled(true));
+	CHECK(!cache.setBlendEnabled(true));
+	CHECK(cache.setDepthWriteEnabled(false));
+	CHECK(!cache.setDepthWriteEnabled(false));
+
+	CHECK(cache.getIssuedCount() == 2 + 2 + 2 + 3 + 2 + 1 + 1);
+	CHECK(cache.getSkippedCount() == 1 + 2 + 1 + 2 + 1 + 1 + 1);
+
+	cache.resetCounters();
+	CHECK(cache.getIssuedCount() == 0);
+	CHECK(cache.getSkippedCount() == 0);
+
+	// the counters reset, the state is kept
+	CHECK(!cache.setProgram(2));
+	CHECK(cache.getSkippedCount(render::RENDER_STATE_TYPE_PROGRAM) == 1);
+
+	// after a reset nothing is known any more
+	cache.reset();
+	CHECK(cache.setProgram(2));
+	CHECK(cache.setVertexBuffer(10));
+	CHECK(cache.setBlendEnabled(true));
+
+	return true;
+}
+
+//! Uniform values are compared per program and forgotten with it.
+TEST_CASE(RenderStateCacheTracksUniformsPerProgram)
+{
+	render::RenderStateCache cache;
+
+	float color[4] = {1.0f, 0.5f, 0.25f, 1.0f};
+	float otherColor[4] = {0.0f, 0.5f, 0.25f, 1.0f};
+
+	// no program is known, the value can't be compared
+	CHECK(cache.setUniform(0, color, sizeof(color)));
+	CHECK(cache.setUniform(0, color, sizeof(color)));
+
+	cache.setProgram(1);
+	CHECK(cache.setUniform(0, color, sizeof(color)));
+	CHECK(!cache.setUniform(0, color, sizeof(color)));
+	CHECK(cache.setUniform(0, otherColor, sizeof(otherColor)));
+	CHECK(!cache.setUniform(0, otherColor, sizeof(otherColor)));
+
+	// the same location of another program has its own value
+	cache.setProgram(2);
+	CHECK(cache.setUniform(0, otherColor, sizeof(otherColor)));
+
+	cache.setProgram(1);
+	CHECK(!cache.setUniform(0, otherColor, sizeof(otherColor)));
+
+	CHECK(cache.getIssuedCount(render::RENDER_STATE_TYPE_UNIFORM) == 5);
+	CHECK(cache.getSkippedCount(render::RENDER_STATE_TYPE_UNIFORM) == 3);
+
+	// a program linked again starts with no values
+	cache.removeProgram(1);
+	CHECK(cache.setProgram(1));
+	CHECK(cache.setUniform(0, otherColor, sizeof(otherColor)));
+
+	return true;
+}
+
+//! Deleted objects are forgotten, a new object with the same name is bound again.
+TEST_CASE(RenderStateCacheForgetsDeletedObjects)
+{
+	render::RenderStateCache cache;
+
+	cache.setVertexBuffer(10);
+	cache.setVertexAttributeFormat(0, 10, 3, 0x1406, 12);
+	cache.setUniformBlock(0, 10, 0, 256);
+	cache.setTexture(0, 1, 20);
+
+	cache.removeBuffer(10);
+	cache.removeTexture(20);
+
+	CHECK(cache.setVertexBuffer(10));
+	CHECK(cache.setVertexAttributeFormat(0, 10, 3, 0x1406, 12));
+	CHECK(cache.setUniformBlock(0, 10, 0, 256));
+	CHECK(cache.setTexture(0, 1, 20));
+
+	return true;
+}
\ No newline at end of file
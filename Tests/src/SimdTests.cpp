@@ -0,0 +1,223 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <Test.h>
+#include <core/Simd.h>
+#include <platform/PlatformManager.h>
+
+#include <string.h>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+const unsigned int MATRIX_COUNT = 257;
+
+//! Deterministic values in [-8, 8) with a full mantissa so that the rounding of every product shows.
+float nextValue(unsigned int& state)
+{
+	state = state * 1664525u + 1013904223u;
+	return (float)(state >> 8) / (float)(1u << 24) * 16.0f - 8.0f;
+}
+
+void fillValues(std::vector<float>& values, unsigned int seed)
+{
+	for (unsigned int i = 0; i < values.size(); ++i)
+		values[i] = nextValue(seed);
+}
+
+bool sameBits(const std::vector<float>& a, const std::vector<float>& b)
+{
+	return a.size() == b.size() && memcmp(&a[0], &b[0], a.size() * sizeof(float)) == 0;
+}
+
+//! Runs the matrix kernels of a level on the same input as the scalar ones and compares the bits.
+bool checkLevel(core::SimdLevel level)
+{
+	const core::MathKernels& scalar = core::getMathKernels(core::SIMD_LEVEL_NONE);
+	const core::MathKernels& kernels = core::getMathKernels(level);
+
+	std::vector<float> a(16);
+	std::vector<float> matrices(MATRIX_COUNT * 16);
+	fillValues(a, 1);
+	fillValues(matrices, 2);
+
+	std::vector<float> expected(16);
+	std::vector<float> result(16);
+
+	scalar.multiply(&a[0], &matrices[0], &expected[0]);
+	kernels.multiply(&a[0], &matrices[0], &result[0]);
+	CHECK(sameBits(expected, result));
+
+	// out may alias an operand
+	result = a;
+	kernels.multiply(&result[0], &matrices[0], &result[0]);
+	CHECK(sameBits(expected, result));
+
+	scalar.transpose(&a[0], &expected[0]);
+	kernels.transpose(&a[0], &result[0]);
+	CHECK(sameBits(expected, result));
+
+	// the inverse is computed with another method, it only has to match to float rounding
+	scalar.inverse(&a[0], &expected[0]);
+	CHECK(kernels.inverse(&a[0], &result[0]));
+	for (unsigned int i = 0; i < 16; ++i)
+	{
+		float difference = expected[i] - result[i];
+		float magnitude = (expected[i] < 0.0f) ? -expected[i] : expected[i];
+		CHECK(difference * difference <= 1e-8f * (1.0f + magnitude * magnitude));
+	}
+
+	// the odd count leaves a tail the vector loops don't cover
+	std::vector<float> expectedBatch(MATRIX_COUNT * 16);
+	std::vector<float> resultBatch(MATRIX_COUNT * 16);
+	for (int left = 0; left < 2; ++left)
+	{
+		scalar.multiplyBatch(&a[0], &matrices[0], &expectedBatch[0], MATRIX_COUNT, left != 0);
+		kernels.multiplyBatch(&a[0], &matrices[0], &resultBatch[0], MATRIX_COUNT, left != 0);
+		CHECK(sameBits(expectedBatch, resultBatch));
+	}
+
+	std::vector<float> vectors(MATRIX_COUNT * 4);
+	fillValues(vectors, 3);
+	std::vector<float> expectedVectors(MATRIX_COUNT * 4);
+	std::vector<float> resultVectors(MATRIX_COUNT * 4);
+
+	scalar.transformVectors(&a[0], &vectors[0], &expectedVectors[0], MATRIX_COUNT);
+	kernels.transformVectors(&a[0], &vectors[0], &resultVectors[0], MATRIX_COUNT);
+	CHECK(sameBits(expectedVectors, resultVectors));
+
+	// points packed 3 floats apart as in vector3d arrays
+	std::vector<float> expectedPoints(MATRIX_COUNT * 3);
+	std::vector<float> resultPoints(MATRIX_COUNT * 3);
+	scalar.transformPoints(&a[0], &vectors[0], &expectedPoints[0], MATRIX_COUNT, 3);
+	kernels.transformPoints(&a[0], &vectors[0], &resultPoints[0], MATRIX_COUNT, 3);
+	CHECK(sameBits(expectedPoints, resultPoints));
+
+	return true;
+}
+
+//! Matrix and point counts of the throughput runs, the data stays in the L2 cache.
+const unsigned int BENCHMARK_MATRIX_COUNT = 4096;
+const unsigned int BENCHMARK_POINT_COUNT = 16384;
+const unsigned int BENCHMARK_RUN_COUNT = 20;
+
+//! Nanoseconds per matrix or point of the kernels of a level, the best of several runs.
+struct KernelTimes
+{
+	double multiply;
+	double multiplyBatch;
+	double transformPoints;
+};
+
+double getNanoseconds(std::chrono::steady_clock::time_point start, unsigned int count)
+{
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+KernelTimes timeLevel(core::SimdLevel level)
+{
+	const core::MathKernels& kernels = core::getMathKernels(level);
+
+	std::vector<float> a(16);
+	std::vector<float> matrices(BENCHMARK_MATRIX_COUNT * 16);
+	std::vector<float> results(BENCHMARK_MATRIX_COUNT * 16);
+	std::vector<float> points(BENCHMARK_POINT_COUNT * 3);
+	std::vector<float> transformedPoints(BENCHMARK_POINT_COUNT * 3);
+	fillValues(a, 1);
+	fillValues(matrices, 2);
+	fillValues(points, 3);
+
+	KernelTimes times;
+	for (unsigned int run = 0; run < BENCHMARK_RUN_COUNT; ++run)
+	{
+		// one call per matrix, as the math classes make them
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < BENCHMARK_MATRIX_COUNT; ++i)
+			kernels.multiply(&a[0], &matrices[i * 16], &results[i * 16]);
+		double multiply = getNanoseconds(start, BENCHMARK_MATRIX_COUNT);
+
+		start = std::chrono::steady_clock::now();
+		kernels.multiplyBatch(&a[0], &matrices[0], &results[0], BENCHMARK_MATRIX_COUNT, true);
+		double multiplyBatch = getNanoseconds(start, BENCHMARK_MATRIX_COUNT);
+
+		// packed 3 floats apart as in vector3d arrays
+		start = std::chrono::steady_clock::now();
+		kernels.transformPoints(&a[0], &points[0], &transformedPoints[0], BENCHMARK_POINT_COUNT, 3);
+		double transformPoints = getNanoseconds(start, BENCHMARK_POINT_COUNT);
+
+		if (run == 0 || multiply < times.multiply) times.multiply = multiply;
+		if (run == 0 || multiplyBatch < times.multiplyBatch) times.multiplyBatch = multiplyBatch;
+		if (run == 0 || transformPoints < times.transformPoints) times.transformPoints = transformPoints;
+	}
+
+	return times;
+}
+
+void printTimes(const char* name, const KernelTimes& times, const KernelTimes& scalarTimes)
+{
+	std::cout<<"Matrix kernels "<<name<<": multiply "<<times.multiply<<" ns ("<<scalarTimes.multiply / times.multiply<<"x), multiplyBatch "
+		<<times.multiplyBatch<<" ns ("<<scalarTimes.multiplyBatch / times.multiplyBatch<<"x), transformPoints "
+		<<times.transformPoints<<" ns ("<<scalarTimes.transformPoints / times.transformPoints<<"x)"<<std::endl;
+}
+
+} // end namespace
+
+//! The SSE2 and AVX2 level matrix kernels give the same bits as the scalar ones, levels the CPU lacks are skipped.
+TEST_CASE(SimdMatrixKernelsAreBitExact)
+{
+	platform::PlatformManager* pPlatformManager = new platform::PlatformManager();
+
+	bool result = true;
+	if (pPlatformManager->checkCPUFeature(platform::CPU_FEATURE_SSE2))
+		result = checkLevel(core::SIMD_LEVEL_SSE2);
+	if (result && pPlatformManager->checkCPUFeature(platform::CPU_FEATURE_AVX2))
+		result = checkLevel(core::SIMD_LEVEL_AVX2);
+
+	delete pPlatformManager;
+
+	return result;
+}
+
+//! Reports the time per matrix or point of the scalar, SSE2 and AVX2 level kernels, levels the CPU lacks are skipped.
+TEST_CASE(SimdMatrixKernelsThroughput)
+{
+	platform::PlatformManager* pPlatformManager = new platform::PlatformManager();
+
+	KernelTimes scalarTimes = timeLevel(core::SIMD_LEVEL_NONE);
+	printTimes("scalar", scalarTimes, scalarTimes);
+
+	if (pPlatformManager->checkCPUFeature(platform::CPU_FEATURE_SSE2))
+		printTimes("SSE2", timeLevel(core::SIMD_LEVEL_SSE2), scalarTimes);
+	if (pPlatformManager->checkCPUFeature(platform::CPU_FEATURE_AVX2))
+		printTimes("AVX2", timeLevel(core::SIMD_LEVEL_AVX2), scalarTimes);
+
+	delete pPlatformManager;
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,163 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <Test.h>
+#include <core/System.h>
+#include <core/SystemScheduler.h>
+#include <core/JobSystem.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+//! Spends a fixed amount of work per update and records when and where it ran.
+class TestSystem: public core::System
+{
+public:
+
+	TestSystem(const std::string& name, unsigned int work, std::atomic<unsigned int>& clock)
+		: core::System(name), mWork(work), mClock(clock), mUpdates(0), mFirst(0), mLast(0), mThread(0), mSum(0.0f)
+	{
+	}
+
+	unsigned int mWork;
+	std::atomic<unsigned int>& mClock;
+
+	unsigned int mUpdates;
+	unsigned int mFirst;
+	unsigned int mLast;
+	unsigned int mThread;
+	float mSum;
+
+protected:
+
+	void updateImpl(float elapsedTime)
+	{
+		mFirst = mClock.fetch_add(1);
+		mThread = (core::JobSystem::getInstance() != nullptr) ? core::JobSystem::getInstance()->getThreadIndex() : 0;
+
+		float sum = mSum;
+		for (unsigned int i = 0; i < mWork; ++i)
+			sum = sum * 0.999f + (float)i;
+		mSum = sum;
+
+		mUpdates++;
+		mLast = mClock.fetch_add(1);
+	}
+};
+
+} // end namespace
+
+//! Runs the update graph of the engine, game followed by render on the main thread and physics and sound on workers,
+//! checks the order and the threads and reports the frame time for 0 to N workers.
+TEST_CASE(SystemSchedulerWorkerScaling)
+{
+	const unsigned int FRAME_COUNT = 50;
+	const unsigned int SYSTEM_WORK = 200000;
+
+	unsigned int maxWorkers = std::thread::hardware_concurrency();
+	if (maxWorkers < 4)
+		maxWorkers = 4;
+	maxWorkers -= 1;
+
+	core::JobSystem* pJobSystem = new core::JobSystem();
+
+	double serialTime = 0.0;
+
+	for (unsigned int workers = 0; workers <= maxWorkers; ++workers)
+	{
+		pJobSystem->start(workers);
+
+		std::atomic<unsigned int> clock(0);
+		TestSystem input("Input", SYSTEM_WORK / 4, clock);
+		TestSystem game("Game", SYSTEM_WORK, clock);
+		TestSystem render("Render", SYSTEM_WORK, clock);
+		TestSystem physics("Physics", SYSTEM_WORK, clock);
+		TestSystem sound("Sound", SYSTEM_WORK / 4, clock);
+
+		game.addDependency(&input);
+		render.addDependency(&game);
+		physics.addDependency(&game);
+		sound.addDependency(&game);
+		physics.setMainThreadUpdate(false);
+		sound.setMainThreadUpdate(false);
+
+		TestSystem* systems[] = {&input, &game, &render, &physics, &sound};
+		const unsigned int systemCount = sizeof(systems) / sizeof(systems[0]);
+
+		core::SystemScheduler scheduler;
+		for (unsigned int i = 0; i < systemCount; ++i)
+		{
+			systems[i]->initialize();
+			systems[i]->start();
+			scheduler.addSystem(systems[i]);
+		}
+
+		double bestFrame = 0.0;
+		for (unsigned int frame = 0; frame < FRAME_COUNT; ++frame)
+		{
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			scheduler.update(0.016f);
+			double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			if (frame == 0 || time < bestFrame) bestFrame = time;
+
+			// every system once, after its dependencies
+			for (unsigned int i = 0; i < systemCount; ++i)
+				CHECK(systems[i]->mUpdates == frame + 1);
+
+			CHECK(input.mLast < game.mFirst);
+			CHECK(game.mLast < render.mFirst);
+			CHECK(game.mLast < physics.mFirst);
+			CHECK(game.mLast < sound.mFirst);
+
+			CHECK(game.mThread == 0);
+			CHECK(render.mThread == 0);
+		}
+
+		if (workers == 0)
+			serialTime = bestFrame;
+
+		std::cout<<"System scheduler with "<<workers<<" workers: "<<bestFrame<<" ms per frame, "<<serialTime / bestFrame<<"x"<<std::endl;
+
+		for (unsigned int i = 0; i < systemCount; ++i)
+		{
+			systems[i]->stop();
+			systems[i]->uninitialize();
+		}
+
+		pJobSystem->stop();
+	}
+
+	SAFE_DELETE(pJobSystem);
+
+	return true;
+}
\ No newline at end of file
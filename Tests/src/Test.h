@@ -0,0 +1,63 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _TEST_H_
+#define _TEST_H_
+
+#include <EngineConfig.h>
+
+#include <string>
+
+namespace test
+{
+
+typedef bool (*TestFunction)();
+
+//! Adds a test to the list the runner picks from, TEST_CASE declares one.
+class TestRegistrar
+{
+public:
+	TestRegistrar(const char* name, TestFunction function);
+};
+
+//! Reports a failed check, returns the condition.
+bool check(bool condition, const char* expression, const char* file, int line);
+
+//! Returns the path of the media directory the tests load resources from.
+const std::string& getMediaPath();
+
+} // end namespace test
+
+//! Defines a test, the runner calls it by name and it fails when it returns false.
+#define TEST_CASE(name) \
+	static bool name(); \
+	static test::TestRegistrar name##Registrar(#name, name); \
+	static bool name()
+
+//! Fails the current test when the condition is false.
+#define CHECK(condition) if (!test::check((condition), #condition, __FILE__, __LINE__)) return false
+
+#endif
\ No newline at end of file
@@ -0,0 +1,113 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <Test.h>
+
+#include <iostream>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#if !defined(ENGINE_TESTS_MEDIA_PATH)
+// The tests run from bin/$(Configuration) on Windows
+#	define ENGINE_TESTS_MEDIA_PATH "../../media"
+#endif
+
+namespace test
+{
+
+struct TestEntry
+{
+	const char* name;
+	TestFunction function;
+};
+
+static std::vector<TestEntry>& getTests()
+{
+	static std::vector<TestEntry> tests;
+	return tests;
+}
+
+TestRegistrar::TestRegistrar(const char* name, TestFunction function)
+{
+	TestEntry entry;
+	entry.name = name;
+	entry.function = function;
+	getTests().push_back(entry);
+}
+
+bool check(bool condition, const char* expression, const char* file, int line)
+{
+	if (!condition)
+		std::cerr<<file<<"("<<line<<"): check failed: "<<expression<<std::endl;
+
+	return condition;
+}
+
+const std::string& getMediaPath()
+{
+	static std::string mediaPath = ENGINE_TESTS_MEDIA_PATH;
+	return mediaPath;
+}
+
+} // end namespace test
+
+//! Runs the engine tests.
+//! Usage: EngineTests [prefix...]
+//! Only the tests whose name starts with one of the prefixes are run, all of them when none is given.
+int main(int argc, char** argv)
+{
+	unsigned int runCount = 0;
+	unsigned int failCount = 0;
+
+	const std::vector<test::TestEntry>& tests = test::getTests();
+	for (unsigned int i = 0; i < tests.size(); ++i)
+	{
+		std::string name = tests[i].name;
+
+		bool selected = (argc < 2);
+		for (int j = 1; j < argc && !selected; ++j)
+			selected = (name.compare(0, strlen(argv[j]), argv[j]) == 0);
+
+		if (!selected)
+			continue;
+
+		std::cout<<"[ RUN    ] "<<name<<std::endl;
+		bool result = tests[i].function();
+		std::cout<<(result ? "[     OK ] " : "[ FAILED ] ")<<name<<std::endl;
+
+		++runCount;
+		if (!result)
+			++failCount;
+	}
+
+	std::cout<<runCount<<" tests run, "<<failCount<<" failed."<<std::endl;
+
+	if (runCount == 0)
+		return 1;
+
+	return (failCount == 0) ? 0 : 1;
+}
\ No newline at end of file
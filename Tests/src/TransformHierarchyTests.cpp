@@ -0,0 +1,269 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <Test.h>
+#include <game/TransformHierarchy.h>
+#include <game/Transform.h>
+#include <game/GameObject.h>
+#include <core/Vector3d.h>
+#include <core/Quaternion.h>
+
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+//! Game objects with a transform each, outside of the game manager so the hierarchy is updated on its own.
+struct TransformForest
+{
+	game::TransformHierarchy* hierarchy;
+	std::vector<game::GameObject*> gameObjects;
+	std::vector<game::Transform*> transforms;
+	//! Index of the parent of every object, -1 for the roots, the parents come first.
+	std::vector<int> parents;
+};
+
+float getRandom(float minValue, float maxValue)
+{
+	return minValue + (maxValue - minValue) * (rand() / (float)RAND_MAX);
+}
+
+void moveTransform(game::Transform* transform)
+{
+	float angle = getRandom(-3.0f, 3.0f);
+	transform->setPosition(getRandom(-10.0f, 10.0f), getRandom(-10.0f, 10.0f), getRandom(-10.0f, 10.0f));
+	transform->setOrientation(core::quaternion(0.0f, sinf(angle * 0.5f), 0.0f, cosf(angle * 0.5f)));
+	transform->setScale(getRandom(0.5f, 2.0f), getRandom(0.5f, 2.0f), getRandom(0.5f, 2.0f));
+}
+
+void createForest(TransformForest& forest, const std::vector<int>& parents)
+{
+	forest.hierarchy = new game::TransformHierarchy();
+	forest.parents = parents;
+
+	for (unsigned int i = 0; i < parents.size(); ++i)
+	{
+		game::GameObject* pGameObject = new game::GameObject();
+		game::Transform* pTransform = new game::Transform();
+		pGameObject->attachComponent(pTransform);
+
+		if (parents[i] >= 0)
+			pGameObject->setParent(forest.gameObjects[parents[i]]);
+
+		moveTransform(pTransform);
+
+		forest.gameObjects.push_back(pGameObject);
+		forest.transforms.push_back(pTransform);
+	}
+}
+
+void destroyForest(TransformForest& forest)
+{
+	for (unsigned int i = 0; i < forest.gameObjects.size(); ++i)
+		delete forest.gameObjects[i];
+
+	for (unsigned int i = 0; i < forest.transforms.size(); ++i)
+		delete forest.transforms[i];
+
+	SAFE_DELETE(forest.hierarchy);
+
+	forest.gameObjects.clear();
+	forest.transforms.clear();
+	forest.parents.clear();
+}
+
+bool isClose(const core::vector3d& a, const core::vector3d& b)
+{
+	return fabsf(a.x - b.x) <= 1e-3f * (1.0f + fabsf(b.x)) && fabsf(a.y - b.y) <= 1e-3f * (1.0f + fabsf(b.y)) && fabsf(a.z - b.z) <= 1e-3f * (1.0f + fabsf(b.z));
+}
+
+bool isClose(const core::quaternion& a, const core::quaternion& b)
+{
+	return fabsf(a.x - b.x) <= 1e-4f && fabsf(a.y - b.y) <= 1e-4f && fabsf(a.z - b.z) <= 1e-4f && fabsf(a.w - b.w) <= 1e-4f;
+}
+
+//! Computes the absolute transforms of the whole forest from scratch and compares them with the hierarchy.
+bool checkForest(TransformForest& forest)
+{
+	unsigned int count = forest.transforms.size();
+	std::vector<core::vector3d> positions(count);
+	std::vector<core::quaternion> orientations(count);
+	std::vector<core::vector3d> scales(count);
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		game::Transform* pTransform = forest.transforms[i];
+		const core::vector3d& position = pTransform->getPosition();
+		const core::quaternion& orientation = pTransform->getOrientation();
+		const core::vector3d& scale = pTransform->getScale();
+
+		int parent = forest.parents[i];
+		if (parent < 0)
+		{
+			positions[i] = position;
+			orientations[i] = orientation;
+			scales[i] = scale;
+		}
+		else
+		{
+			orientations[i] = orientations[parent] * orientation;
+			scales[i] = core::vector3d(scales[parent].x * scale.x, scales[parent].y * scale.y, scales[parent].z * scale.z);
+
+			core::vector3d scaledPosition(scales[parent].x * position.x, scales[parent].y * position.y, scales[parent].z * position.z);
+			positions[i] = orientations[parent] * scaledPosition + positions[parent];
+		}
+
+		CHECK(isClose(pTransform->getAbsolutePosition(), positions[i]));
+		CHECK(isClose(pTransform->getAbsoluteOrientation(), orientations[i]));
+		CHECK(isClose(pTransform->getAbsoluteScale(), scales[i]));
+	}
+
+	return true;
+}
+
+//! Times the update after the given transforms moved, the best of several runs in microseconds.
+double timeUpdate(TransformForest& forest, const std::vector<unsigned int>& moved)
+{
+	const unsigned int RUN_COUNT = 10;
+
+	double best = 0.0;
+	for (unsigned int run = 0; run < RUN_COUNT; ++run)
+	{
+		for (unsigned int i = 0; i < moved.size(); ++i)
+			moveTransform(forest.transforms[moved[i]]);
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		forest.hierarchy->update();
+		double time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+		if (run == 0 || time < best)
+			best = time;
+	}
+
+	return best;
+}
+
+} // end namespace
+
+//! Moving random transforms and parents updates exactly the moved subtrees, checked against a full recompute.
+TEST_CASE(TransformHierarchyUpdatesDirtySubtrees)
+{
+	const unsigned int TRANSFORM_COUNT = 20000;
+	const unsigned int ROUND_COUNT = 20;
+
+	srand(11);
+
+	// a quarter of the transforms are roots, the others hang below a random earlier one
+	std::vector<int> parents(TRANSFORM_COUNT, -1);
+	for (unsigned int i = 1; i < TRANSFORM_COUNT; ++i)
+	{
+		if (rand() % 4 != 0)
+			parents[i] = rand() % i;
+	}
+
+	TransformForest forest;
+	createForest(forest, parents);
+
+	forest.hierarchy->update();
+	CHECK(forest.hierarchy->getLevelCount() > 3);
+	CHECK(checkForest(forest));
+
+	for (unsigned int round = 0; round < ROUND_COUNT; ++round)
+	{
+		unsigned int movedCount = 1 + rand() % 100;
+		for (unsigned int i = 0; i < movedCount; ++i)
+			moveTransform(forest.transforms[rand() % TRANSFORM_COUNT]);
+
+		// some rounds change the hierarchy, the levels are sorted again
+		if (round % 5 == 4)
+		{
+			unsigned int child = 1 + rand() % (TRANSFORM_COUNT - 1);
+			forest.parents[child] = rand() % child;
+			forest.gameObjects[child]->setParent(forest.gameObjects[forest.parents[child]]);
+		}
+
+		forest.hierarchy->update();
+		CHECK(checkForest(forest));
+	}
+
+	// nothing moved, nothing changes
+	forest.hierarchy->update();
+	CHECK(checkForest(forest));
+
+	destroyForest(forest);
+
+	return true;
+}
+
+//! Reports the update time of 100000 transforms for moves from a single leaf to all the roots.
+TEST_CASE(TransformHierarchyUpdateBenchmark)
+{
+	const unsigned int TRANSFORM_COUNT = 100000;
+	const unsigned int ROOT_COUNT = 1000;
+
+	srand(12);
+
+	// every transform past the roots is the child of the one at a quarter of its index, five levels
+	std::vector<int> parents(TRANSFORM_COUNT, -1);
+	for (unsigned int i = ROOT_COUNT; i < TRANSFORM_COUNT; ++i)
+		parents[i] = i / 4;
+
+	TransformForest forest;
+	createForest(forest, parents);
+
+	forest.hierarchy->update();
+	CHECK(forest.hierarchy->getLevelCount() == 5);
+
+	std::vector<unsigned int> roots;
+	for (unsigned int i = 0; i < ROOT_COUNT; ++i)
+		roots.push_back(i);
+
+	std::vector<unsigned int> leaf(1, TRANSFORM_COUNT - 1);
+	std::vector<unsigned int> subtree(1, 300);
+
+	std::vector<unsigned int> scattered;
+	for (unsigned int i = 0; i < TRANSFORM_COUNT / 100; ++i)
+		scattered.push_back(rand() % TRANSFORM_COUNT);
+
+	double rootsTime = timeUpdate(forest, roots);
+	double leafTime = timeUpdate(forest, leaf);
+	double subtreeTime = timeUpdate(forest, subtree);
+	double scatteredTime = timeUpdate(forest, scattered);
+	double cleanTime = timeUpdate(forest, std::vector<unsigned int>());
+
+	CHECK(checkForest(forest));
+
+	std::cout<<"Transform hierarchy update of "<<TRANSFORM_COUNT<<" transforms: all roots moved "<<rootsTime<<" us, one leaf "<<leafTime<<" us, one subtree "
+		<<subtreeTime<<" us, 1% scattered "<<scatteredTime<<" us, none "<<cleanTime<<" us"<<std::endl;
+
+	destroyForest(forest);
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,268 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <Test.h>
+#include <core/Matrix4.h>
+#include <render/UniformRingBuffer.h>
+#include <render/RenderStateData.h>
+#include <render/Material.h>
+#include <render/Model.h>
+#include <render/ShaderParameter.h>
+
+#include <vector>
+
+namespace
+{
+
+//! Material whose parameters are only laid out in blocks, no driver program is behind it.
+class BlockMaterial: public render::Material
+{
+public:
+
+	BlockMaterial(): render::Material("BlockMaterial", nullptr)
+	{
+		setParameterBlocks(true);
+	}
+
+protected:
+
+	render::ShaderParameter* createParameterImpl()
+	{
+		return new render::ShaderParameter();
+	}
+};
+
+//! Model placed without a transform component.
+class BlockModel: public render::Model
+{
+public:
+
+	BlockModel(const core::matrix4& worldMatrix)
+	{
+		mWorldMatrix = worldMatrix;
+	}
+};
+
+unsigned int getBlockOffset(render::Material& material, render::ShaderAutoParameterType source)
+{
+	const std::vector<render::ShaderParameterInstruction>& parameterProgram = material.getParameterProgram();
+	for (unsigned int i = 0; i < parameterProgram.size(); ++i)
+	{
+		if (parameterProgram[i].mSource == source)
+			return parameterProgram[i].mBlockOffset;
+	}
+
+	return (unsigned int)-2;
+}
+
+} // end namespace
+
+//! A scalar fills the padding after a vec3, a vec3 or vec4 after a scalar starts at the next 16 bytes.
+TEST_CASE(UniformRingBufferStd140PadsVectors)
+{
+	BlockMaterial packed;
+	packed.addAutoParameter("lightPosition", render::SHADER_AUTO_PARAMETER_TYPE_LIGHT_POSITION);
+	packed.addAutoParameter("lightPowerScale", render::SHADER_AUTO_PARAMETER_TYPE_LIGHT_POWER_SCALE);
+	packed.addAutoParameter("lightDirection", render::SHADER_AUTO_PARAMETER_TYPE_LIGHT_DIRECTION);
+	packed.addAutoParameter("lightDiffuse", render::SHADER_AUTO_PARAMETER_TYPE_LIGHT_DIFFUSE_COLOUR);
+
+	CHECK(getBlockOffset(packed, render::SHADER_AUTO_PARAMETER_TYPE_LIGHT_POSITION) == 0);
+	CHECK(getBlockOffset(packed, render::SHADER_AUTO_PARAMETER_TYPE_LIGHT_POWER_SCALE) == 12);
+	CHECK(getBlockOffset(packed, render::SHADER_AUTO_PARAMETER_TYPE_LIGHT_DIRECTION) == 16);
+	CHECK(getBlockOffset(packed, render::SHADER_AUTO_PARAMETER_TYPE_LIGHT_DIFFUSE_COLOUR) == 32);
+	CHECK(packed.getParameterBlockSize(render::SHADER_PARAMETER_FREQUENCY_FRAME) == 48);
+
+	BlockMaterial padded;
+	padded.addAutoParameter("lightPowerScale", render::SHADER_AUTO_PARAMETER_TYPE_LIGHT_POWER_SCALE);
+	padded.addAutoParameter("lightPosition", render::SHADER_AUTO_PARAMETER_TYPE_LIGHT_POSITION);
+	padded.addAutoParameter("lightSpecular", render::SHADER_AUTO_PARAMETER_TYPE_LIGHT_SPECULAR_COLOUR);
+
+	CHECK(getBlockOffset(padded, render::SHADER_AUTO_PARAMETER_TYPE_LIGHT_POWER_SCALE) == 0);
+	CHECK(getBlockOffset(padded, render::SHADER_AUTO_PARAMETER_TYPE_LIGHT_POSITION) == 16);
+	CHECK(getBlockOffset(padded, render::SHADER_AUTO_PARAMETER_TYPE_LIGHT_SPECULAR_COLOUR) == 32);
+	CHECK(padded.getParameterBlockSize(render::SHADER_PARAMETER_FREQUENCY_FRAME) == 48);
+
+	// the block is rounded up to a vec4, the frequencies without parameters have no block
+	BlockMaterial single;
+	single.addAutoParameter("lightPowerScale", render::SHADER_AUTO_PARAMETER_TYPE_LIGHT_POWER_SCALE);
+
+	CHECK(single.getParameterBlockSize(render::SHADER_PARAMETER_FREQUENCY_FRAME) == 16);
+	CHECK(single.getParameterBlockSize(render::SHADER_PARAMETER_FREQUENCY_CAMERA) == 0);
+	CHECK(single.getParameterBlockSize(render::SHADER_PARAMETER_FREQUENCY_OBJECT) == 0);
+
+	// the samplers are not block members
+	BlockMaterial sampler;
+	sampler.addAutoParameter("clusterLightGrid", render::SHADER_AUTO_PARAMETER_TYPE_CLUSTER_LIGHT_GRID);
+	sampler.addAutoParameter("worldMatrix", render::SHADER_AUTO_PARAMETER_TYPE_WORLD_MATRIX);
+
+	CHECK(getBlockOffset(sampler, render::SHADER_AUTO_PARAMETER_TYPE_CLUSTER_LIGHT_GRID) == (unsigned int)-1);
+	CHECK(getBlockOffset(sampler, render::SHADER_AUTO_PARAMETER_TYPE_WORLD_MATRIX) == 0);
+	CHECK(sampler.getParameterBlockSize(render::SHADER_PARAMETER_FREQUENCY_OBJECT) == 64);
+
+	return true;
+}
+
+//! A matrix is an array of four vec4 columns, aligned to 16 bytes and written column by column.
+TEST_CASE(UniformRingBufferStd140WritesMatrixColumns)
+{
+	BlockMaterial camera;
+	camera.addAutoParameter("cameraPosition", render::SHADER_AUTO_PARAMETER_TYPE_CAMERA_POSITION);
+	camera.addAutoParameter("viewMatrix", render::SHADER_AUTO_PARAMETER_TYPE_VIEW_MATRIX);
+	camera.addAutoParameter("projectionMatrix", render::SHADER_AUTO_PARAMETER_TYPE_PROJECTION_MATRIX);
+
+	CHECK(getBlockOffset(camera, render::SHADER_AUTO_PARAMETER_TYPE_CAMERA_POSITION) == 0);
+	CHECK(getBlockOffset(camera, render::SHADER_AUTO_PARAMETER_TYPE_VIEW_MATRIX) == 16);
+	CHECK(getBlockOffset(camera, render::SHADER_AUTO_PARAMETER_TYPE_PROJECTION_MATRIX) == 80);
+	CHECK(camera.getParameterBlockSize(render::SHADER_PARAMETER_FREQUENCY_CAMERA) == 144);
+
+	BlockMaterial object;
+	object.addAutoParameter("worldMatrix", render::SHADER_AUTO_PARAMETER_TYPE_WORLD_MATRIX);
+	object.addAutoParameter("transposeWorldMatrix", render::SHADER_AUTO_PARAMETER_TYPE_TRANSPOSE_WORLD_MATRIX);
+
+	CHECK(getBlockOffset(object, render::SHADER_AUTO_PARAMETER_TYPE_WORLD_MATRIX) == 0);
+	CHECK(getBlockOffset(object, render::SHADER_AUTO_PARAMETER_TYPE_TRANSPOSE_WORLD_MATRIX) == 64);
+	CHECK(object.getParameterBlockSize(render::SHADER_PARAMETER_FREQUENCY_OBJECT) == 128);
+
+	core::matrix4 worldMatrix = core::matrix4::IDENTITY;
+	worldMatrix.setTranslation(core::vector3d(1.0f, 2.0f, 3.0f));
+	worldMatrix.setScale(core::vector3d(4.0f, 5.0f, 6.0f));
+	BlockModel model(worldMatrix);
+
+	render::RenderStateData renderStateData;
+	renderStateData.setCurrentModel(&model);
+
+	render::UniformRingBuffer uniformBuffer;
+	uniformBuffer.initialize(1024, 256);
+
+	unsigned int offset = uniformBuffer.writeParameterBlock(&object, render::SHADER_PARAMETER_FREQUENCY_OBJECT, renderStateData);
+	CHECK(offset == 0);
+
+	// the rows of the row major matrix are the columns of the block, the transposed one keeps the rows
+	const float* pBlock = (const float*)(uniformBuffer.getData() + offset);
+	const float* m = worldMatrix.get();
+	for (unsigned int column = 0; column < 4; ++column)
+	{
+		for (unsigned int row = 0; row < 4; ++row)
+		{
+			CHECK(pBlock[column * 4 + row] == m[row * 4 + column]);
+			CHECK(pBlock[16 + column * 4 + row] == m[column * 4 + row]);
+		}
+	}
+
+	return true;
+}
+
+//! The blocks are aligned, the ring wraps around its end and the blocks of the kept frames are not reused.
+TEST_CASE(UniformRingBufferWrapsAroundKeptFrames)
+{
+	render::UniformRingBuffer uniformBuffer;
+	uniformBuffer.initialize(256, 16, 2);
+
+	unsigned int offset = 0;
+	unsigned int size = 0;
+
+	// frame 0
+	CHECK(uniformBuffer.allocate(100) == 0);
+	CHECK(uniformBuffer.allocate(20) == 112);
+	CHECK(uniformBuffer.getUsedSize() == 132);
+	CHECK(uniformBuffer.takePendingRange(offset, size));
+	CHECK(offset == 0 && size == 132);
+	CHECK(!uniformBuffer.takePendingRange(offset, size));
+
+	// frame 1, the blocks of frame 0 may still be read
+	uniformBuffer.beginFrame();
+	CHECK(uniformBuffer.allocate(60) == 144);
+	CHECK(uniformBuffer.allocate(64) == render::UNIFORM_RING_BUFFER_INVALID_OFFSET);
+	CHECK(uniformBuffer.takePendingRange(offset, size));
+	CHECK(offset == 144 && size == 60);
+
+	// frame 2, frame 0 is retired and its memory is reused once the ring wraps
+	uniformBuffer.beginFrame();
+	CHECK(uniformBuffer.getUsedSize() == 204 - 132);
+	CHECK(uniformBuffer.allocate(32) == 208);
+	CHECK(uniformBuffer.allocate(64) == 0);
+
+	// the range wrapped, it is handed out in two parts
+	CHECK(uniformBuffer.takePendingRange(offset, size));
+	CHECK(offset == 208 && size == 32);
+	CHECK(uniformBuffer.takePendingRange(offset, size));
+	CHECK(offset == 0 && size == 64);
+	CHECK(!uniformBuffer.takePendingRange(offset, size));
+
+	// the block of frame 1 is still kept
+	CHECK(uniformBuffer.allocate(96) == render::UNIFORM_RING_BUFFER_INVALID_OFFSET);
+	CHECK(uniformBuffer.allocate(64) == 64);
+
+	CHECK(uniformBuffer.getStats().allocationCount == 3);
+	CHECK(uniformBuffer.getStats().uploadCount == 2);
+	CHECK(uniformBuffer.getStats().growCount == 0);
+
+	return true;
+}
+
+//! Reserving wraps the ring ahead of the allocations so they stay contiguous, or grows it when they do not fit.
+TEST_CASE(UniformRingBufferReservesContiguousRanges)
+{
+	render::UniformRingBuffer uniformBuffer;
+	uniformBuffer.initialize(256, 16, 2);
+
+	CHECK(!uniformBuffer.reserve(256));
+
+	CHECK(uniformBuffer.allocate(128) == 0);
+	uniformBuffer.beginFrame();
+	CHECK(uniformBuffer.allocate(48) == 128);
+	uniformBuffer.beginFrame();
+
+	// the 96 bytes don't fit after the head, they fit at the beginning freed by frame 0
+	CHECK(!uniformBuffer.reserve(96));
+	CHECK(uniformBuffer.allocate(40) == 0);
+	CHECK(uniformBuffer.allocate(40) == 48);
+	CHECK(uniformBuffer.getStats().growCount == 0);
+
+	// the storage is reallocated and the kept frames are dropped with it
+	CHECK(uniformBuffer.reserve(200));
+	CHECK(uniformBuffer.getStats().growCount == 1);
+	CHECK(uniformBuffer.getSize() >= 2 * 200);
+	CHECK(uniformBuffer.getUsedSize() == 0);
+	CHECK(uniformBuffer.allocate(200) == 0);
+
+	unsigned int offset = 0;
+	unsigned int size = 0;
+	CHECK(uniformBuffer.takePendingRange(offset, size));
+	CHECK(offset == 0 && size == 200);
+
+	// the block offsets keep the alignment
+	render::UniformRingBuffer alignedBuffer;
+	alignedBuffer.initialize(4096, 256, 3);
+	for (unsigned int i = 0; i < 8; ++i)
+	{
+		offset = alignedBuffer.allocate(64 + i * 20);
+		CHECK(offset != render::UNIFORM_RING_BUFFER_INVALID_OFFSET);
+		CHECK(offset % 256 == 0);
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+/*
+-----------------------------------------------------------------------------
+KG game engine (http://katoun.github.com/kg_engine) is made available under the MIT License.
+
+Copyright (c) 2006-2013 Catalin Alexandru Nastase
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <Test.h>
+#include <render/VisibilityTree.h>
+#include <render/Frustum.h>
+#include <render/CameraDefines.h>
+#include <render/FrustumDefines.h>
+#include <core/Matrix4.h>
+
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+
+static float getRandom(float minValue, float maxValue)
+{
+	return minValue + (maxValue - minValue) * (rand() / (float)RAND_MAX);
+}
+
+static bool isBoxVisible(const render::Frustum& frustum, const core::aabox3d& box)
+{
+	for (unsigned int i = 0; i < render::FRUSTUM_PLANE_COUNT; ++i)
+	{
+		const core::plane3d& plane = frustum.getPlane(i);
+		core::vector3d corner(plane.Normal.x >= 0.0f ? box.MaxEdge.x : box.MinEdge.x,
+			plane.Normal.y >= 0.0f ? box.MaxEdge.y : box.MinEdge.y,
+			plane.Normal.z >= 0.0f ? box.MaxEdge.z : box.MinEdge.z);
+
+		if (plane.getDistanceTo(corner) < 0.0f)
+			return false;
+	}
+
+	return true;
+}
+
+//! The visible models match a brute force cull while the fraction of moving models switches
+//! the tree between the refits and the linear cull.
+TEST_CASE(VisibilityTreeMatchesBruteForce)
+{
+	core::matrix4 projection;
+	core::matrix4 view;
+	projection.buildProjectionMatrixPerspectiveFov(1.0f, 1.333f, 1.0f, 400.0f);
+	view.buildViewMatrix(core::vector3d(0, 0, 0), core::vector3d(0.3f, 0, -1), core::vector3d(0, 1, 0));
+
+	render::Frustum frustum;
+	frustum.buildViewFrustum(projection, view, render::PROJECTION_TYPE_PERSPECTIVE, 1.0f, 1.333f, 1.0f, 400.0f);
+
+	const unsigned int MODEL_COUNT = 50000;
+	const float WORLD_SIZE = 800.0f;
+
+	srand(3);
+
+	std::vector<core::aabox3d> boxes(MODEL_COUNT);
+	std::vector<core::vector3d> velocities(MODEL_COUNT);
+	std::vector<unsigned int> leaves(MODEL_COUNT);
+
+	render::VisibilityTree tree;
+	for (unsigned int i = 0; i < MODEL_COUNT; ++i)
+	{
+		core::vector3d position(getRandom(-WORLD_SIZE, WORLD_SIZE), getRandom(-50.0f, 50.0f), getRandom(-WORLD_SIZE, WORLD_SIZE));
+		float size = getRandom(0.5f, 3.0f);
+		boxes[i] = core::aabox3d(position - core::vector3d(size, size, size), position + core::vector3d(size, size, size));
+		velocities[i] = core::vector3d(getRandom(-30.0f, 30.0f), getRandom(-2.0f, 2.0f), getRandom(-30.0f, 30.0f));
+
+		// the models are only compared, they are never dereferenced
+		leaves[i] = tree.insert((render::Model*)(size_t)(i + 1), boxes[i]);
+	}
+
+	const float MOVING_FRACTIONS[] = {0.1f, 0.1f, 0.01f, 0.0f, 0.2f, 0.0f, 0.0f, 0.06f, 0.03f, 0.5f, 0.001f};
+	const unsigned int FRAME_COUNT = sizeof(MOVING_FRACTIONS) / sizeof(MOVING_FRACTIONS[0]);
+
+	std::vector<render::Model*> visibleModels;
+	std::vector<size_t> expected;
+	std::vector<size_t> found;
+
+	for (unsigned int frame = 0; frame < FRAME_COUNT; ++frame)
+	{
+		unsigned int movingCount = (unsigned int)(MODEL_COUNT * MOVING_FRACTIONS[frame]);
+		for (unsigned int i = 0; i < movingCount; ++i)
+		{
+			unsigned int model = rand() % MODEL_COUNT;
+			boxes[model].MinEdge += velocities[model];
+			boxes[model].MaxEdge += velocities[model];
+			tree.move(leaves[model], boxes[model]);
+		}
+
+		tree.update();
+
+		visibleModels.clear();
+		tree.findVisibleModels(frustum, visibleModels);
+
+		expected.clear();
+		for (unsigned int i = 0; i < MODEL_COUNT; ++i)
+		{
+			if (isBoxVisible(frustum, boxes[i]))
+				expected.push_back(i + 1);
+		}
+
+		found.clear();
+		for (unsigned int i = 0; i < visibleModels.size(); ++i)
+			found.push_back((size_t)visibleModels[i]);
+		std::sort(found.begin(), found.end());
+
+		CHECK(!expected.empty());
+		CHECK(found == expected);
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -458,8 +458,11 @@ static bool getCPUIDSupport() {
 
     bool hasCPUID = false;
     if (setjmp(check_jmpbuf) == 0) {
-        asm("movl $0, %eax\n"
-            "cpuid\n");
+        asm volatile("movl $0, %%eax\n"
+            "cpuid\n"
+            :
+            :
+            : "%eax", "%ebx", "%ecx", "%edx");
         hasCPUID = true;
     }
 
@@ -488,14 +491,14 @@ static bool getSSEFPSupport() {
 
 
 static void classicalTimingLoop(u32 loopLength) {
-    asm("mov $0x80000000, %%eax\n"
-        "timingLoop:\n"
+    asm volatile("mov $0x80000000, %%eax\n"
+        "1:\n"
         "bsf %%eax, %%ecx\n"
         "dec %%ebx\n"
-        "jnz timingLoop\n"
+        "jnz 1b\n"
+        : "+b" (loopLength)
         :
-        : "b" (loopLength)
-        : "%eax", "%ecx");
+        : "%eax", "%ecx", "cc");
 }
 
 
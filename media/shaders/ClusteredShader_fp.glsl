@@ -0,0 +1,77 @@
+#version 140
+
+uniform sampler2D diffuseMap;
+
+uniform vec4 ambientLight;
+
+// Vector4(x, y, z, lights)
+uniform vec4 clusterGridSize;
+// Vector4(near, far, scale, bias)
+uniform vec4 clusterDepth;
+
+// offset and count of the lights of every cluster
+uniform usamplerBuffer clusterLightGrid;
+uniform usamplerBuffer clusterLightIndices;
+// four texels per light, see LightCuller::getLightData
+uniform samplerBuffer clusterLightData;
+
+in vec3 worldPosition;
+in vec3 worldNormal;
+in vec2 texCoords;
+in float viewDepth;
+in vec4 clipPosition;
+
+out vec4 fragColor;
+
+void main()
+{
+	vec4 diffuse = texture(diffuseMap, texCoords);
+	vec3 normal = normalize(worldNormal);
+
+	// find the cluster of the fragment
+	vec2 ndc = clipPosition.xy / clipPosition.w;
+	ivec3 gridSize = ivec3(clusterGridSize.xyz);
+	ivec2 tile = clamp(ivec2((ndc * 0.5 + 0.5) * vec2(gridSize.xy)), ivec2(0), gridSize.xy - 1);
+	int slice = clamp(int(floor(log(max(viewDepth, clusterDepth.x)) * clusterDepth.z + clusterDepth.w)), 0, gridSize.z - 1);
+	int cluster = (slice * gridSize.y + tile.y) * gridSize.x + tile.x;
+
+	uvec2 lights = texelFetch(clusterLightGrid, cluster).xy;
+
+	vec3 color = ambientLight.rgb;
+	for (uint i = 0u; i < lights.y; ++i)
+	{
+		int light = int(texelFetch(clusterLightIndices, int(lights.x + i)).x) * 4;
+
+		vec4 positionRange = texelFetch(clusterLightData, light);
+		vec4 colorInner = texelFetch(clusterLightData, light + 1);
+		vec4 directionOuter = texelFetch(clusterLightData, light + 2);
+		vec4 attenuation = texelFetch(clusterLightData, light + 3);
+
+		vec3 lightVector = -directionOuter.xyz;
+		float intensity = 1.0;
+
+		// directional lights have no range
+		if (positionRange.w > 0.0)
+		{
+			lightVector = positionRange.xyz - worldPosition;
+			float lightDistance = length(lightVector);
+			if (lightDistance > positionRange.w)
+				continue;
+
+			lightVector /= lightDistance;
+			intensity = 1.0 / (attenuation.x + attenuation.y * lightDistance + attenuation.z * lightDistance * lightDistance);
+
+			// spotlights
+			if (directionOuter.w > -1.0)
+			{
+				float cosAngle = dot(-lightVector, directionOuter.xyz);
+				float spot = clamp((cosAngle - directionOuter.w) / max(colorInner.w - directionOuter.w, 0.0001), 0.0, 1.0);
+				intensity *= pow(spot, attenuation.w);
+			}
+		}
+
+		color += colorInner.rgb * max(dot(normal, lightVector), 0.0) * intensity;
+	}
+
+	fragColor = vec4(diffuse.rgb * color, diffuse.a);
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#version 140
+
+in vec3 position;
+in vec3 normal;
+in vec2 texCoords0;
+
+uniform mat4 worldMatrix;
+uniform mat4 inverseTransposeWorldMatrix;
+uniform mat4 viewMatrix;
+uniform mat4 viewProjMatrix;
+
+out vec3 worldPosition;
+out vec3 worldNormal;
+out vec2 texCoords;
+out float viewDepth;
+out vec4 clipPosition;
+
+void main()
+{
+	vec4 worldPos = worldMatrix * vec4(position, 1.0);
+
+	worldPosition = worldPos.xyz;
+	worldNormal = (inverseTransposeWorldMatrix * vec4(normal, 0.0)).xyz;
+	texCoords = texCoords0;
+
+	// the camera looks down -z
+	viewDepth = -(viewMatrix * worldPos).z;
+
+	clipPosition = viewProjMatrix * worldPos;
+	gl_Position = clipPosition;
+}
\ No newline at end of file
@@ -0,0 +1,14 @@
+attribute vec3 position;
+attribute vec3 normal;
+attribute vec2 texCoords0;
+attribute mat4 instanceWorldMatrix;
+
+uniform mat4 viewProjMatrix;
+
+varying vec2 texCoords;
+
+void main()
+{
+	texCoords = texCoords0;
+	gl_Position = viewProjMatrix * instanceWorldMatrix * vec4(position, 1.0);
+}